@@ -195,6 +195,11 @@ LDFLAGS_NO_UNDEF = -Wl,--no-undefined
 CFLAGS_BASE      = $(CFLAGS_MINIMUM) $(CFLAGS_EXTRA) $(CFLAGS_DISABLE_WARNINGS)
 LDFLAGS_BASE     =  $(LDFLAGS_MINIMUM) $(LDFLAGS_RPATH) $(LDFLAGS_EXTRA)
 LDFLAGS_SHARED   = -shared
+# Set TRACING=1 to compile in timeline trace instrumentation, otherwise
+# it compiles to nothing (see src/libs/core/utils/trace.h)
+ifeq ($(TRACING),1)
+  CFLAGS_BASE += -DFAWKES_TRACING
+endif
 ifeq ($(OS),FreeBSD)
   DEFAULT_INCLUDES += -I/usr/local/include
   LDFLAGS_BASE     += -L/usr/local/lib -lpthread
@@ -69,6 +69,7 @@ ifneq ($(INTERFACES_all),)
 	$(eval INTERFACES_HDRS             += $(IFACESRCDIR)/$I.h)		\
 	$(eval INTERFACES_LIBS             += $(IFACEDIR)/lib$I.so)		\
 	$(eval INTERFACES_TOUCH            += $(SRCDIR)/$(OBJDIR)/$I.touch)	\
+	$(eval INTERFACES_FFI              += $(LUALIBDIR)/interfaces/ffi/$I.lua) \
 	$(eval INTERFACES_OBJS             += $I.o)				\
 	$(eval LIBS_all                    += $$(IFACEDIR)/lib$I.so)		\
 	$(eval LIBS_build                  += $$(IFACEDIR)/lib$I.so)		\
@@ -107,13 +108,21 @@ $(INTERFACES_TOLUA): $(SRCDIR)/%.tolua: $(SRCDIR)/$(OBJDIR)/%.touch
 $(INTERFACES_TOUCH): $(SRCDIR)/$(OBJDIR)/%.touch: $(SRCDIR)/%.xml
 	$(SILENTSYMB) echo -e "$(INDENT_PRINT)[IFC] $(PARENTDIR)$(TBOLDGRAY)$*.cpp$(TNORMAL)"
 	$(SILENT)mkdir -p $(SRCDIR)
-	$(SILENT)$(BINDIR)/ffifacegen -d $(SRCDIR) $<
+	$(SILENT)mkdir -p $(@D)
+	$(SILENT)$(BINDIR)/ffifacegen -d $(SRCDIR) $(if $(filter 1,$(HAVE_LUAJIT)),-l $(@D)) $<
 	$(SILENT)if [ "$(SRCDIR)" != "$(IFACESRCDIR)" ]; then \
 		mv -f $(SRCDIR)/$*.h $(IFACESRCDIR)/$*.h; \
 	fi
-	$(SILENT) mkdir -p $(@D)
 	$(SILENT) touch $@
 
+  ifeq ($(HAVE_LUAJIT),1)
+all: $(INTERFACES_FFI)
+
+$(INTERFACES_FFI): $(LUALIBDIR)/interfaces/ffi/%.lua: $(SRCDIR)/$(OBJDIR)/%.touch
+	$(SILENT) mkdir -p $(@D)
+	$(SILENT) cp -f $(SRCDIR)/$(OBJDIR)/$*_ffi.lua $@
+  endif
+
 .SECONDARY: $(INTERFACES_SRCS) $(INTERFACES_HDRS) $(TOLUA_SRCS) $(TOLUA_ALL)
 
 .PHONY: error_ifacegen
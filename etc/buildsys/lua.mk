@@ -21,7 +21,11 @@ ifndef __buildsys_lua_mk_
 __buildsys_lua_mk_ := 1
 
 # List of acceptable Lua versions
-LUA_VERSIONS= 5.2 5.1
+ifeq ($(LUAJIT),1)
+  LUA_VERSIONS= 5.1
+else
+  LUA_VERSIONS= 5.2 5.1
+endif
 $(foreach V,$(LUA_VERSIONS),$(if $(HAVE_LUA),,$(eval include $(BUILDSYSDIR)/lua_check.mk)))
 
 ifeq ($(HAVE_LUA),1)
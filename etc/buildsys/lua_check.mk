@@ -25,15 +25,27 @@ endif
 ifneq ($(PKGCONFIG),)
   __LUA_TRY_P := lua-$V lua$V lua
 
-  LUA_PACKAGE := $(firstword $(foreach P,$(__LUA_TRY_P),$(if $(shell $(PKGCONFIG) --atleast-version $V $P; echo $${?/1/}),$P )))
+  # Set LUAJIT=1 to build against LuaJIT, which implements the Lua 5.1 API
+  LUA_PACKAGE :=
+  ifeq ($(LUAJIT)$V,15.1)
+    LUA_PACKAGE := $(if $(shell $(PKGCONFIG) --exists luajit; echo $${?/1/}),luajit,)
+  endif
+  ifeq ($(LUA_PACKAGE),)
+    LUA_PACKAGE := $(firstword $(foreach P,$(__LUA_TRY_P),$(if $(shell $(PKGCONFIG) --atleast-version $V $P; echo $${?/1/}),$P )))
+  endif
   HAVE_LUA := $(if $(LUA_PACKAGE),1,)
 endif
 
 ifeq ($(HAVE_LUA),1)
-  LUA_VERSION_SPLITTED := $(call split,.,$(shell $(PKGCONFIG) --modversion '$(LUA_PACKAGE)'))
-  LUA_VERSION_MAJOR := $(word 1,$(LUA_VERSION_SPLITTED))
-  LUA_VERSION_MINOR := $(word 2,$(LUA_VERSION_SPLITTED))
-  LUA_VERSION := $(LUA_VERSION_MAJOR).$(LUA_VERSION_MINOR)
+  ifeq ($(LUA_PACKAGE),luajit)
+    HAVE_LUAJIT := 1
+    LUA_VERSION := 5.1
+  else
+    LUA_VERSION_SPLITTED := $(call split,.,$(shell $(PKGCONFIG) --modversion '$(LUA_PACKAGE)'))
+    LUA_VERSION_MAJOR := $(word 1,$(LUA_VERSION_SPLITTED))
+    LUA_VERSION_MINOR := $(word 2,$(LUA_VERSION_SPLITTED))
+    LUA_VERSION := $(LUA_VERSION_MAJOR).$(LUA_VERSION_MINOR)
+  endif
 
   ifeq ($(LUA_VERSION),$V)
     ifneq ($(wildcard $(SYSROOT)/usr/include/tolua++.h),)
@@ -135,4 +147,7 @@ ifeq ($(HAVE_LUA),1)
   CFLAGS_LUA := $(shell $(PKGCONFIG) --cflags '$(LUA_PACKAGE)') \
 	        -DHAVE_LUA -DLUADIR=\"$(EXEC_LUADIR)\" -DLUALIBDIR=\"$(EXEC_LUALIBDIR)\"
   LDFLAGS_LUA := $(shell $(PKGCONFIG) --libs '$(LUA_PACKAGE)')
+  ifeq ($(HAVE_LUAJIT),1)
+    CFLAGS_LUA += -DHAVE_LUAJIT
+  endif
 endif
@@ -0,0 +1,72 @@
+
+/***************************************************************************
+ *  task_pool.cpp - Fawkes TaskPoolAspect initializer/finalizer
+ *
+ *  Created: Mon Oct 19 00:53:27 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/inifins/task_pool.h>
+#include <aspect/task_pool.h>
+
+namespace fawkes {
+
+/** @class TaskPoolAspectIniFin <aspect/inifins/task_pool.h>
+ * Initializer/finalizer for the TaskPoolAspect.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param task_pool task pool to pass to threads
+ */
+TaskPoolAspectIniFin::TaskPoolAspectIniFin(TaskPool *task_pool) : AspectIniFin("TaskPoolAspect")
+{
+	task_pool_ = task_pool;
+}
+
+void
+TaskPoolAspectIniFin::init(Thread *thread)
+{
+	TaskPoolAspect *task_pool_thread;
+	task_pool_thread = dynamic_cast<TaskPoolAspect *>(thread);
+	if (task_pool_thread == NULL) {
+		throw CannotInitializeThreadException("Thread '%s' claims to have the "
+		                                      "TaskPoolAspect, but RTTI says it "
+		                                      "has not. ",
+		                                      thread->name());
+	}
+
+	task_pool_thread->init_TaskPoolAspect(task_pool_);
+}
+
+void
+TaskPoolAspectIniFin::finalize(Thread *thread)
+{
+	TaskPoolAspect *task_pool_thread;
+	task_pool_thread = dynamic_cast<TaskPoolAspect *>(thread);
+	if (task_pool_thread == NULL) {
+		throw CannotFinalizeThreadException("Thread '%s' claims to have the "
+		                                    "TaskPoolAspect, but RTTI says it "
+		                                    "has not. ",
+		                                    thread->name());
+	}
+
+	task_pool_thread->finalize_TaskPoolAspect();
+}
+
+} // end namespace fawkes
@@ -21,6 +21,7 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <aspect/aspect_provider.h>
 #include <aspect/inifins/aspect_provider.h>
 #include <aspect/inifins/blackboard.h>
 #include <aspect/inifins/blocked_timing.h>
@@ -34,11 +35,14 @@
 #include <aspect/inifins/plugin_director.h>
 #include <aspect/inifins/syncpoint.h>
 #include <aspect/inifins/syncpoint_manager.h>
+#include <aspect/inifins/task_pool.h>
 #include <aspect/inifins/thread_producer.h>
 #include <aspect/inifins/time_source.h>
 #include <aspect/inifins/vision.h>
 #include <aspect/inifins/vision_master.h>
 #include <aspect/manager.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #ifdef HAVE_WEBVIEW
 #	include <aspect/inifins/webview.h>
 #endif
@@ -57,10 +61,19 @@ namespace fawkes {
  * It manages the initializers/finalizers and thus the aspects which are
  * currently available in the system. It assures that these are not removed
  * before the last thread with an aspect is gone.
+ * All methods are thread-safe, threads can be initialized and finalized
+ * concurrently, e.g. when plugins are initialized in parallel. Aspect
+ * initializers/finalizers are called one at a time.
  * @author Tim Niemueller
  */
 
 /** Constructor. */
+AspectManager::AspectManager()
+{
+	mutex_ = new Mutex(Mutex::RECURSIVE);
+}
+
+/** Destructor. */
 AspectManager::~AspectManager()
 {
 	std::map<std::string, AspectIniFin *>::iterator i;
@@ -68,6 +81,7 @@ AspectManager::~AspectManager()
 		delete i->second;
 	}
 	default_inifins_.clear();
+	delete mutex_;
 }
 
 /** Register initializer/finalizer.
@@ -76,6 +90,7 @@ AspectManager::~AspectManager()
 void
 AspectManager::register_inifin(AspectIniFin *inifin)
 {
+	MutexLocker lock(mutex_);
 	if (inifins_.find(inifin->get_aspect_name()) != inifins_.end()) {
 		throw Exception("An initializer for %s has already been registered", inifin->get_aspect_name());
 	}
@@ -88,6 +103,7 @@ AspectManager::register_inifin(AspectIniFin *inifin)
 void
 AspectManager::unregister_inifin(AspectIniFin *inifin)
 {
+	MutexLocker lock(mutex_);
 	if (inifins_.find(inifin->get_aspect_name()) == inifins_.end()) {
 		throw Exception("An initializer for %s has not been registered", inifin->get_aspect_name());
 	}
@@ -108,12 +124,14 @@ AspectManager::unregister_inifin(AspectIniFin *inifin)
 bool
 AspectManager::has_threads_for_aspect(const char *aspect_name)
 {
+	MutexLocker lock(mutex_);
 	return (threads_.find(aspect_name) != threads_.end()) && (!threads_[aspect_name].empty());
 }
 
 void
 AspectManager::init(Thread *thread)
 {
+	MutexLocker lock(mutex_);
 	Aspect *aspected_thread = dynamic_cast<Aspect *>(thread);
 	if (aspected_thread != NULL) { // thread has aspects to initialize
 		const std::list<const char *> &aspects = aspected_thread->get_aspects();
@@ -157,6 +175,7 @@ AspectManager::init(Thread *thread)
 void
 AspectManager::finalize(Thread *thread)
 {
+	MutexLocker lock(mutex_);
 	Aspect *aspected_thread = dynamic_cast<Aspect *>(thread);
 	if (aspected_thread != NULL) { // thread has aspects to finalize
 		const std::list<const char *> &aspects = aspected_thread->get_aspects();
@@ -183,6 +202,7 @@ AspectManager::finalize(Thread *thread)
 bool
 AspectManager::prepare_finalize(Thread *thread)
 {
+	MutexLocker lock(mutex_);
 	Aspect *aspected_thread = dynamic_cast<Aspect *>(thread);
 	if (aspected_thread != NULL) { // thread has aspects to finalize
 		const std::list<const char *> &aspects = aspected_thread->get_aspects();
@@ -204,6 +224,32 @@ AspectManager::prepare_finalize(Thread *thread)
 	return true;
 }
 
+/** Determine initialization dependencies of a thread.
+ * A thread requires all of its aspects and provides the aspects of all
+ * initializers registered through its AspectProviderAspect.
+ * @param thread thread to get dependencies for
+ * @param required upon return contains the names of the thread's aspects
+ * @param provided upon return contains the names of the aspects provided
+ * by the thread
+ */
+void
+AspectManager::init_dependencies(Thread                 *thread,
+                                 std::list<std::string> &required,
+                                 std::list<std::string> &provided)
+{
+	Aspect *aspected_thread = dynamic_cast<Aspect *>(thread);
+	if (aspected_thread != NULL) {
+		const std::list<const char *> &aspects = aspected_thread->get_aspects();
+		required.insert(required.end(), aspects.begin(), aspects.end());
+	}
+	AspectProviderAspect *provider_thread = dynamic_cast<AspectProviderAspect *>(thread);
+	if (provider_thread != NULL) {
+		for (AspectIniFin *inifin : provider_thread->aspect_provider_aspects()) {
+			provided.push_back(inifin->get_aspect_name());
+		}
+	}
+}
+
 /** Register default aspect initializer/finalizer.
  * This loads initializer/finalizer of all aspects which are in the
  * Fawkes aspect library.
@@ -222,6 +268,7 @@ AspectManager::prepare_finalize(Thread *thread)
  * @param pmanager plugin manager for PluginDirectorAspect
  * @param tf_listener transformer for TransformAspect
  * @param syncpoint_manager manager for SyncPointManagerAspect
+ * @param task_pool task pool for TaskPoolAspect
  */
 void
 AspectManager::register_default_inifins(BlackBoard            *blackboard,
@@ -238,8 +285,10 @@ AspectManager::register_default_inifins(BlackBoard            *blackboard,
                                         ServiceBrowser        *service_browser,
                                         PluginManager         *pmanager,
                                         tf::Transformer       *tf_listener,
-                                        SyncPointManager      *syncpoint_manager)
+                                        SyncPointManager      *syncpoint_manager,
+                                        TaskPool              *task_pool)
 {
+	MutexLocker lock(mutex_);
 	if (!default_inifins_.empty())
 		return;
 
@@ -261,6 +310,7 @@ AspectManager::register_default_inifins(BlackBoard            *blackboard,
 	VisionAspectIniFin           *vis_aif  = new VisionAspectIniFin(vm_aif);
 	SyncPointManagerAspectIniFin *spm_aif  = new SyncPointManagerAspectIniFin(syncpoint_manager);
 	SyncPointAspectIniFin        *sp_aif   = new SyncPointAspectIniFin(syncpoint_manager);
+	TaskPoolAspectIniFin         *tpl_aif  = new TaskPoolAspectIniFin(task_pool);
 #ifdef HAVE_WEBVIEW
 	WebviewAspectIniFin *web_aif = new WebviewAspectIniFin();
 #endif
@@ -288,6 +338,7 @@ AspectManager::register_default_inifins(BlackBoard            *blackboard,
 	default_inifins_[vis_aif->get_aspect_name()]    = vis_aif;
 	default_inifins_[spm_aif->get_aspect_name()]    = spm_aif;
 	default_inifins_[sp_aif->get_aspect_name()]     = sp_aif;
+	default_inifins_[tpl_aif->get_aspect_name()]    = tpl_aif;
 #ifdef HAVE_WEBVIEW
 	default_inifins_[web_aif->get_aspect_name()] = web_aif;
 #endif
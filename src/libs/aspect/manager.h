@@ -49,6 +49,8 @@ class BlockedTimingExecutor;
 class MainLoopEmployer;
 class AspectIniFin;
 class SyncPointManager;
+class TaskPool;
+class Mutex;
 
 namespace tf {
 class Transformer;
@@ -57,11 +59,15 @@ class Transformer;
 class AspectManager : public ThreadInitializer, public ThreadFinalizer
 {
 public:
+	AspectManager();
 	virtual ~AspectManager();
 
 	virtual void init(Thread *thread);
 	virtual void finalize(Thread *thread);
 	virtual bool prepare_finalize(Thread *thread);
+	virtual void init_dependencies(Thread                 *thread,
+	                               std::list<std::string> &required,
+	                               std::list<std::string> &provided);
 
 	void register_inifin(AspectIniFin *inifin);
 	void unregister_inifin(AspectIniFin *inifin);
@@ -82,9 +88,11 @@ public:
 	                              ServiceBrowser        *service_browser,
 	                              PluginManager         *pmanager,
 	                              tf::Transformer       *tf_listener,
-	                              SyncPointManager      *syncpoint_manager);
+	                              SyncPointManager      *syncpoint_manager,
+	                              TaskPool              *task_pool);
 
 private:
+	Mutex                                     *mutex_;
 	std::map<std::string, AspectIniFin *>      inifins_;
 	std::map<std::string, AspectIniFin *>      default_inifins_;
 	std::map<std::string, std::list<Thread *>> threads_;
@@ -47,7 +47,8 @@ SyncPointAspect::SyncPointAspect(SyncPoint::WakeupType type_in,
   identifier_in_(identifier_in),
   identifier_out_(identifier_out),
   sp_in_(NULL),
-  sp_out_(NULL)
+  sp_out_(NULL),
+  wait_start_usec_(0)
 {
 	add_aspect("SyncPointAspect");
 	has_input_syncpoint_  = (identifier_in != "");
@@ -64,7 +65,8 @@ SyncPointAspect::SyncPointAspect(std::string identifier_out)
   identifier_in_(""),
   identifier_out_(identifier_out),
   sp_in_(NULL),
-  sp_out_(NULL)
+  sp_out_(NULL),
+  wait_start_usec_(0)
 {
 	add_aspect("SyncPointAspect");
 	has_input_syncpoint_  = false;
@@ -79,7 +81,8 @@ SyncPointAspect::~SyncPointAspect()
 /** Init SyncPoint aspect.
  * This initializes the syncpoints and registers the thread as loop listener.
  * Additionally, the thread is registered as emitter for the output syncpoint
- * if an output syncpoint is created.
+ * if an output syncpoint is created. If there is an input syncpoint, loop
+ * statistics of the thread are recorded and registered with the manager.
  * @param thread thread which uses this aspect
  * @param manager SyncPointManager to use
  */
@@ -88,6 +91,10 @@ SyncPointAspect::init_SyncPointAspect(Thread *thread, SyncPointManager *manager)
 {
 	if (has_input_syncpoint_) {
 		sp_in_ = manager->get_syncpoint(thread->name(), identifier_in_);
+
+		uint64_t deadline = manager->get_loop_deadline();
+		loop_stats_ = std::make_shared<SyncPointLoopStatistics>(thread->name(), identifier_in_, deadline);
+		manager->add_loop_statistics(loop_stats_);
 	}
 
 	if (has_output_syncpoint_) {
@@ -109,6 +116,8 @@ void
 SyncPointAspect::finalize_SyncPointAspect(Thread *thread, SyncPointManager *manager)
 {
 	if (has_input_syncpoint_) {
+		manager->remove_loop_statistics(loop_stats_);
+		loop_stats_.reset();
 		manager->release_syncpoint(thread->name(), sp_in_);
 	}
 
@@ -129,7 +138,9 @@ void
 SyncPointAspect::pre_loop(Thread *thread)
 {
 	if (has_input_syncpoint_) {
+		wait_start_usec_ = LatencyHistogram::now_usec();
 		sp_in_->wait(thread->name(), type_in_);
+		loop_stats_->loop_started(wait_start_usec_, sp_in_->get_last_emit_usec());
 	}
 }
 
@@ -139,6 +150,9 @@ SyncPointAspect::pre_loop(Thread *thread)
 void
 SyncPointAspect::post_loop(Thread *thread)
 {
+	if (has_input_syncpoint_) {
+		loop_stats_->loop_finished();
+	}
 	if (has_output_syncpoint_) {
 		sp_out_->emit(thread->name());
 	}
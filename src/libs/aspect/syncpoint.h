@@ -27,6 +27,7 @@
 #include <syncpoint/syncpoint.h>
 #include <syncpoint/syncpoint_manager.h>
 
+#include <memory>
 #include <string>
 
 namespace fawkes {
@@ -54,6 +55,9 @@ private:
 	bool                  has_output_syncpoint_;
 	RefPtr<SyncPoint>     sp_in_;
 	RefPtr<SyncPoint>     sp_out_;
+
+	std::shared_ptr<SyncPointLoopStatistics> loop_stats_;
+	uint64_t                                 wait_start_usec_;
 };
 
 } // end namespace fawkes
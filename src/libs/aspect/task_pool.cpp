@@ -0,0 +1,79 @@
+
+/***************************************************************************
+ *  task_pool.cpp - Task pool aspect for Fawkes
+ *
+ *  Created: Mon Oct 19 00:48:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/task_pool.h>
+
+namespace fawkes {
+
+/** @class TaskPoolAspect <aspect/task_pool.h>
+ * Thread aspect to execute work in parallel on the shared task pool.
+ * Threads that want to parallelize their work should use this aspect
+ * instead of spawning their own threads, so that all plugins share the
+ * cores reserved for the task pool.
+ *
+ * Threads running in a main loop hook should use
+ * TaskPool::PRIORITY_HIGH (the default of TaskPool::parallel_for()) for
+ * work they wait for, and TaskPool::PRIORITY_LOW for background work that
+ * may span multiple loops.
+ *
+ * @ingroup Aspects
+ * @author Tim Niemueller
+ */
+
+/** @var TaskPool * TaskPoolAspect::task_pool
+ * Task pool to execute tasks on.
+ */
+
+/** Constructor. */
+TaskPoolAspect::TaskPoolAspect()
+{
+	add_aspect("TaskPoolAspect");
+	task_pool = NULL;
+}
+
+/** Virtual empty destructor. */
+TaskPoolAspect::~TaskPoolAspect()
+{
+}
+
+/** Init task pool aspect.
+ * It is guaranteed that this is called before Thread::start() is called
+ * (when running regularly inside Fawkes).
+ * @param task_pool task pool to use
+ */
+void
+TaskPoolAspect::init_TaskPoolAspect(TaskPool *task_pool)
+{
+	this->task_pool = task_pool;
+}
+
+/** Finalize task pool aspect.
+ * The thread must no longer submit tasks afterwards.
+ */
+void
+TaskPoolAspect::finalize_TaskPoolAspect()
+{
+	task_pool = NULL;
+}
+
+} // end namespace fawkes
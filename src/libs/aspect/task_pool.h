@@ -0,0 +1,47 @@
+
+/***************************************************************************
+ *  task_pool.h - Task pool aspect for Fawkes
+ *
+ *  Created: Mon Oct 19 00:48:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _ASPECT_TASK_POOL_H_
+#define _ASPECT_TASK_POOL_H_
+
+#include <aspect/aspect.h>
+#include <core/threading/task_pool.h>
+
+namespace fawkes {
+
+class TaskPoolAspect : public virtual Aspect
+{
+public:
+	TaskPoolAspect();
+	virtual ~TaskPoolAspect();
+
+	void init_TaskPoolAspect(TaskPool *task_pool);
+	void finalize_TaskPoolAspect();
+
+protected:
+	TaskPool *task_pool;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -28,6 +28,7 @@
 #include <core/macros.h>
 #include <core/threading/interruptible_barrier.h>
 #include <core/threading/mutex_locker.h>
+#include <core/utils/trace.h>
 #include <core/version.h>
 #include <plugin/loader.h>
 #include <plugin/manager.h>
@@ -38,6 +39,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <unistd.h>
 
 namespace fawkes {
@@ -102,6 +104,7 @@ FawkesMainThread::FawkesMainThread(Configuration    *config,
 		multi_logger_->log_info("FawkesMainApp", "Maximum thread time not set, assuming 30ms.");
 	}
 	max_thread_time_nanosec_ = max_thread_time_usec_ * 1000;
+	syncpoint_manager_->set_loop_deadline(max_thread_time_usec_);
 
 	time_wait_ = NULL;
 	try {
@@ -116,6 +119,28 @@ FawkesMainThread::FawkesMainThread(Configuration    *config,
 
 	desired_loop_time_sec_ = (float)desired_loop_time_usec_ / 1000000.f;
 
+	mainloop_stats_ = std::make_shared<SyncPointLoopStatistics>("FawkesMainThread",
+	                                                            "/mainloop",
+	                                                            desired_loop_time_usec_);
+	mainloop_wait_start_usec_ = 0;
+	syncpoint_manager_->add_loop_statistics(mainloop_stats_);
+
+	tracing_dump_on_overrun_ =
+	  config_->get_bool_or_default("/fawkes/mainapp/tracing/dump_on_overrun", false);
+	tracing_dump_duration_ =
+	  config_->get_float_or_default("/fawkes/mainapp/tracing/dump_duration", 5.);
+	tracing_directory_ =
+	  config_->get_string_or_default("/fawkes/mainapp/tracing/directory", "/tmp");
+	tracing_last_dump_usec_ = 0;
+	if (config_->get_bool_or_default("/fawkes/mainapp/tracing/enable", false)) {
+		TraceRecorder::enable(
+		  config_->get_uint_or_default("/fawkes/mainapp/tracing/buffer_size", 4096));
+	}
+
+	scheduling_report_interval_usec_ =
+	  config_->get_float_or_default("/fawkes/mainapp/scheduling/report_interval", 0.) * 1000000.;
+	scheduling_last_report_usec_ = LatencyHistogram::now_usec();
+
 	try {
 		enable_looptime_warnings_ = config_->get_bool("/fawkes/mainapp/enable_looptime_warnings");
 		if (!enable_looptime_warnings_) {
@@ -178,6 +203,8 @@ FawkesMainThread::destruct()
 	if (default_plugin_)
 		free(default_plugin_);
 
+	syncpoint_manager_->remove_loop_statistics(mainloop_stats_);
+
 	delete time_wait_;
 	delete loop_start_;
 	delete loop_end_;
@@ -186,6 +213,35 @@ FawkesMainThread::destruct()
 	delete mainloop_mutex_;
 }
 
+/** Dump recorded trace to file.
+ * Writes the most recent events to a time-stamped file in the configured
+ * directory, see TraceRecorder.
+ */
+void
+FawkesMainThread::dump_trace()
+{
+	if (!TraceRecorder::enabled()) {
+		multi_logger_->log_warn("FawkesMainThread", "Trace dump requested, but tracing is disabled");
+		return;
+	}
+
+	char      timestr[32];
+	time_t    now = time(NULL);
+	struct tm now_tm;
+	localtime_r(&now, &now_tm);
+	strftime(timestr, sizeof(timestr), "%Y%m%d-%H%M%S", &now_tm);
+	std::string filename = tracing_directory_ + "/fawkes-trace-" + timestr + ".json";
+
+	try {
+		TraceRecorder::dump(filename.c_str(), tracing_dump_duration_);
+		tracing_last_dump_usec_ = TraceRecorder::now_usec();
+		multi_logger_->log_info("FawkesMainThread", "Wrote trace to %s", filename.c_str());
+	} catch (Exception &e) {
+		multi_logger_->log_warn("FawkesMainThread", "Failed to write trace");
+		multi_logger_->log_warn("FawkesMainThread", e);
+	}
+}
+
 /** Start the thread and wait until once() completes.
  * This is useful to assure that all plugins are loaded before assuming that
  * startup is complete.
@@ -321,6 +377,10 @@ FawkesMainThread::loop()
 			time_wait_->mark_start();
 		}
 		loop_start_->stamp_systime();
+		if (mainloop_wait_start_usec_ == 0) {
+			mainloop_wait_start_usec_ = LatencyHistogram::now_usec();
+		}
+		mainloop_stats_->loop_started(mainloop_wait_start_usec_, 0);
 
 		CancelState old_state;
 		set_cancel_state(CANCEL_DISABLED, &old_state);
@@ -398,10 +458,28 @@ FawkesMainThread::loop()
 					                        loop_time);
 				}
 			}
+			if (tracing_dump_on_overrun_ && loop_time > desired_loop_time_sec_
+			    && (TraceRecorder::now_usec() - tracing_last_dump_usec_
+			        > tracing_dump_duration_ * 1000000.)) {
+				TraceRecorder::request_dump();
+			}
 		}
-
+		mainloop_stats_->loop_finished();
 		plugin_manager_->unlock();
 
+		// after the loop statistics, writing the trace is not part of the loop
+		if (TraceRecorder::dump_requested()) {
+			dump_trace();
+		}
+
+		if (scheduling_report_interval_usec_ > 0
+		    && LatencyHistogram::now_usec() - scheduling_last_report_usec_
+		         >= scheduling_report_interval_usec_) {
+			thread_manager_->log_scheduling_statistics();
+			scheduling_last_report_usec_ = LatencyHistogram::now_usec();
+		}
+
+		mainloop_wait_start_usec_ = LatencyHistogram::now_usec();
 		if (time_wait_) {
 			time_wait_->wait_systime();
 		} else {
@@ -440,7 +518,7 @@ FawkesMainThread::logger() const
 /** Constructor.
  * @param fmt Fawkes main thread to run
  * @param register_signals true to register default signal handlers
- * for SIGINT, SIGTERM, and SIGALRM.
+ * for SIGINT, SIGTERM, SIGALRM, and SIGUSR2 (to request a trace dump).
  */
 FawkesMainThread::Runner::Runner(FawkesMainThread *fmt, bool register_signals)
 {
@@ -457,6 +535,7 @@ FawkesMainThread::Runner::Runner(FawkesMainThread *fmt, bool register_signals)
 		SignalManager::register_handler(SIGINT, this);
 		SignalManager::register_handler(SIGTERM, this);
 		SignalManager::register_handler(SIGALRM, this);
+		SignalManager::register_handler(SIGUSR2, this);
 	}
 }
 
@@ -467,6 +546,7 @@ FawkesMainThread::Runner::~Runner()
 		SignalManager::unregister_handler(SIGINT);
 		SignalManager::unregister_handler(SIGTERM);
 		SignalManager::unregister_handler(SIGALRM);
+		SignalManager::unregister_handler(SIGUSR2);
 	}
 	delete init_mutex_;
 }
@@ -510,6 +590,9 @@ FawkesMainThread::Runner::handle_signal(int signum)
 		printf("\nFawkes shutdown and finalization procedure still running.\n"
 		       "Hit Ctrl-C again to force immediate exit.\n\n");
 
+	} else if (signum == SIGUSR2) {
+		TraceRecorder::request_dump();
+
 	} else if ((signum == SIGTERM) || sigint_running_) {
 		// we really need to quit
 		::exit(-2);
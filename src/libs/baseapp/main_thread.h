@@ -34,6 +34,7 @@
 
 #include <getopt.h>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -103,6 +104,7 @@ protected:
 
 private:
 	void destruct();
+	void dump_trace();
 
 	inline void
 	safe_wake(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
@@ -147,6 +149,17 @@ private:
 
 	std::vector<RefPtr<SyncPoint>> syncpoints_start_hook_;
 	std::vector<RefPtr<SyncPoint>> syncpoints_end_hook_;
+
+	std::shared_ptr<SyncPointLoopStatistics> mainloop_stats_;
+	uint64_t                                 mainloop_wait_start_usec_;
+
+	bool        tracing_dump_on_overrun_;
+	float       tracing_dump_duration_;
+	std::string tracing_directory_;
+	uint64_t    tracing_last_dump_usec_;
+
+	uint64_t scheduling_report_interval_usec_;
+	uint64_t scheduling_last_report_usec_;
 };
 
 } // end namespace fawkes
@@ -25,6 +25,8 @@
 #include <baseapp/main_thread.h>
 #include <baseapp/run.h>
 #include <baseapp/thread_manager.h>
+#include <baseapp/thread_scheduling_policy.h>
+#include <core/threading/task_pool.h>
 #include <core/threading/thread.h>
 
 #ifdef HAVE_BLACKBOARD
@@ -66,14 +68,17 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fnmatch.h>
 #include <grp.h>
 #include <pwd.h>
+#include <sched.h>
 #include <signal.h>
 #include <unistd.h>
+#include <vector>
 
 namespace fawkes {
 
@@ -101,6 +106,9 @@ tf::Transformer       *tf_transformer    = NULL;
 tf::TransformListener *tf_listener       = NULL;
 Time                  *start_time        = NULL;
 SyncPointManager      *syncpoint_manager = NULL;
+TaskPool              *task_pool         = NULL;
+
+ThreadSchedulingPolicy *scheduling_policy = NULL;
 #ifdef HAVE_LOGGING_FD_REDIRECT
 LogFileDescriptorToLog *log_fd_redirect_stderr_ = NULL;
 LogFileDescriptorToLog *log_fd_redirect_stdout_ = NULL;
@@ -416,13 +424,53 @@ init(const InitOptions &options, int &retval)
 	aspect_manager = new AspectManager();
 	thread_manager = new ThreadManager(aspect_manager, aspect_manager);
 
+	scheduling_policy = new ThreadSchedulingPolicy(config, logger);
+	thread_manager->set_scheduling_policy(scheduling_policy);
+
 	syncpoint_manager = new SyncPointManager(logger);
 
+	// *** Setup task pool, restricted to the configured CPUs
+	std::vector<unsigned int> tp_cpus =
+	  config->get_uints_or_defaults("/fawkes/mainapp/task_pool/cpus", std::vector<unsigned int>());
+	std::vector<unsigned int> tp_isolated_cpus =
+	  config->get_uints_or_defaults("/fawkes/mainapp/task_pool/isolated_cpus",
+	                                std::vector<unsigned int>());
+	if (tp_cpus.empty()) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		if (sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0) {
+			for (unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+				if (CPU_ISSET(cpu, &cpuset)) {
+					tp_cpus.push_back(cpu);
+				}
+			}
+		}
+	}
+	for (unsigned int cpu : tp_isolated_cpus) {
+		tp_cpus.erase(std::remove(tp_cpus.begin(), tp_cpus.end(), cpu), tp_cpus.end());
+	}
+	if (tp_cpus.empty()) {
+		logger->log_warn("FawkesMainApp", "No CPUs left for task pool, not restricting workers");
+	}
+	unsigned int tp_threads = config->get_uint_or_default("/fawkes/mainapp/task_pool/threads", 0);
+	if (tp_threads == 0) {
+		tp_threads = std::max<size_t>(1, tp_cpus.size());
+	}
+	try {
+		task_pool = new TaskPool(tp_threads, tp_cpus);
+	} catch (Exception &e) {
+		logger->log_warn("FawkesMainApp", "Cannot restrict task pool to CPUs, not restricting workers");
+		logger->log_warn("FawkesMainApp", e);
+		task_pool = new TaskPool(tp_threads);
+	}
+	logger->log_debug("FawkesMainApp", "Task pool with %u workers", task_pool->num_threads());
+
 	plugin_manager = new PluginManager(thread_manager,
 	                                   config,
 	                                   "/fawkes/meta_plugins/",
 	                                   options.plugin_module_flags(),
 	                                   options.init_plugin_cache());
+	plugin_manager->set_thread_initializer(aspect_manager);
 #ifdef HAVE_NETWORK_MANAGER
 	network_manager = new FawkesNetworkManager(thread_manager,
 	                                           enable_ipv4,
@@ -484,7 +532,8 @@ init(const InitOptions &options, int &retval)
 #endif
 	                                         plugin_manager,
 	                                         tf_transformer,
-	                                         syncpoint_manager);
+	                                         syncpoint_manager,
+	                                         task_pool);
 
 	retval = 0;
 	return true;
@@ -535,6 +584,8 @@ cleanup()
 	delete network_manager;
 #endif
 	delete thread_manager;
+	delete scheduling_policy;
+	delete task_pool;
 	delete aspect_manager;
 	delete shm_registry;
 #ifdef HAVE_LOGGING_FD_REDIRECT
@@ -23,6 +23,7 @@
 
 #include <aspect/blocked_timing.h>
 #include <baseapp/thread_manager.h>
+#include <baseapp/thread_scheduling_policy.h>
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
 #include <core/threading/mutex_locker.h>
@@ -139,6 +140,7 @@ ThreadManager::ThreadManager()
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	scheduling_policy_           = NULL;
 }
 
 /** Constructor.
@@ -155,6 +157,7 @@ ThreadManager::ThreadManager(ThreadInitializer *initializer, ThreadFinalizer *fi
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	scheduling_policy_           = NULL;
 	set_inifin(initializer, finalizer);
 }
 
@@ -191,6 +194,41 @@ ThreadManager::set_inifin(ThreadInitializer *initializer, ThreadFinalizer *final
 	finalizer_   = finalizer;
 }
 
+/** Set scheduling policy.
+ * The policy is applied to each thread right after it has been started.
+ * @param policy scheduling policy, NULL to not apply any policy
+ */
+void
+ThreadManager::set_scheduling_policy(ThreadSchedulingPolicy *policy)
+{
+	scheduling_policy_ = policy;
+}
+
+/** Log scheduling statistics of all threads.
+ * Logs the effective scheduling settings, context switches, and CPU
+ * migrations of each thread. Does nothing if no scheduling policy is set.
+ */
+void
+ThreadManager::log_scheduling_statistics()
+{
+	if (!scheduling_policy_)
+		return;
+
+	MutexLocker lock(threads_.mutex());
+	for (auto &h : threads_) {
+		h.second.lock();
+		for (Thread *t : h.second) {
+			scheduling_policy_->log_statistics(t);
+		}
+		h.second.unlock();
+	}
+	untimed_threads_.lock();
+	for (Thread *t : untimed_threads_) {
+		scheduling_policy_->log_statistics(t);
+	}
+	untimed_threads_.unlock();
+}
+
 /** Remove the given thread from internal structures.
  * Thread is removed from the internal structures. If the thread has the
  * BlockedTimingAspect then the hook is added to the changed list.
@@ -278,6 +316,11 @@ ThreadManager::add_maybelocked(ThreadList &tl, bool lock)
 
 	tl.seal();
 	tl.start();
+	if (scheduling_policy_) {
+		for (Thread *t : tl) {
+			scheduling_policy_->apply(t, tl.name());
+		}
+	}
 
 	// All thread initialized, now add threads to internal structure
 	MutexLocker locker(threads_.mutex(), lock);
@@ -349,6 +392,9 @@ ThreadManager::add_maybelocked(Thread *thread, bool lock)
 	}
 
 	thread->start();
+	if (scheduling_policy_) {
+		scheduling_policy_->apply(thread, NULL);
+	}
 	MutexLocker locker(threads_.mutex(), lock);
 	internal_add_thread(thread);
 }
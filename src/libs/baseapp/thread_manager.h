@@ -38,6 +38,7 @@ class Mutex;
 class WaitCondition;
 class ThreadInitializer;
 class ThreadFinalizer;
+class ThreadSchedulingPolicy;
 
 class ThreadManager : public ThreadCollector, public BlockedTimingExecutor
 {
@@ -47,6 +48,8 @@ public:
 	virtual ~ThreadManager();
 
 	void set_inifin(ThreadInitializer *initializer, ThreadFinalizer *finalizer);
+	void set_scheduling_policy(ThreadSchedulingPolicy *policy);
+	void log_scheduling_statistics();
 
 	virtual void
 	add(ThreadList &tl)
@@ -112,8 +115,9 @@ private:
 	};
 
 private:
-	ThreadInitializer *initializer_;
-	ThreadFinalizer   *finalizer_;
+	ThreadInitializer      *initializer_;
+	ThreadFinalizer        *finalizer_;
+	ThreadSchedulingPolicy *scheduling_policy_;
 
 	LockMap<BlockedTimingAspect::WakeupHook, ThreadList>           threads_;
 	LockMap<BlockedTimingAspect::WakeupHook, ThreadList>::iterator tit_;
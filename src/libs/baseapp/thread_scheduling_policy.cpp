@@ -0,0 +1,229 @@
+
+/***************************************************************************
+ *  thread_scheduling_policy.cpp - Config-driven thread scheduling policy
+ *
+ *  Created: Mon Oct 19 01:24:51 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+
+#include <baseapp/thread_scheduling_policy.h>
+#include <config/config.h>
+#include <core/exception.h>
+#include <core/threading/thread.h>
+#include <logging/logger.h>
+
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <fnmatch.h>
+#include <map>
+#include <memory>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+static std::string
+cpus_to_string(const std::vector<unsigned int> &cpus)
+{
+	std::string rv;
+	for (size_t i = 0; i < cpus.size(); ++i) {
+		size_t j = i;
+		while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+			++j;
+		if (!rv.empty())
+			rv += ",";
+		rv += std::to_string(cpus[i]);
+		if (j > i)
+			rv += "-" + std::to_string(cpus[j]);
+		i = j;
+	}
+	return rv.empty() ? "unknown" : rv;
+}
+/// @endcond
+
+/** @class ThreadSchedulingPolicy <baseapp/thread_scheduling_policy.h>
+ * Scheduling policy for threads read from the configuration.
+ * Rules are defined below /fawkes/mainapp/scheduling/rules/, one
+ * sub-tree per rule. A rule may specify the name of a plugin (plugin) and
+ * a shell wildcard pattern (thread) which are matched against each thread
+ * when it is started. Both are optional, a rule without either matches
+ * all threads. The first matching rule in alphabetical order of the rule
+ * names is applied. It may set the CPUs the thread may run on (cpus) and
+ * a real-time priority (priority) with which the thread is scheduled
+ * using SCHED_FIFO, or with the regular policy if the priority is zero.
+ *
+ * Memory locking cannot be applied per thread. If enabled with
+ * /fawkes/mainapp/scheduling/lock_memory, all current and future pages of
+ * the process are locked into memory, which avoids page faults in real-time
+ * threads.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * Reads the rules and locks memory if requested.
+ * @param config configuration to read rules from
+ * @param logger logger to report applied settings and failures
+ */
+ThreadSchedulingPolicy::ThreadSchedulingPolicy(Configuration *config, Logger *logger)
+: logger_(logger)
+{
+	const std::string prefix = "/fawkes/mainapp/scheduling/rules/";
+
+	std::map<std::string, Rule>                   rules;
+	std::unique_ptr<Configuration::ValueIterator> i(config->search(prefix.c_str()));
+	while (i->next()) {
+		std::string            path  = std::string(i->path()).substr(prefix.length());
+		std::string::size_type slash = path.find('/');
+		if (slash == std::string::npos)
+			continue;
+
+		std::string name  = path.substr(0, slash);
+		std::string field = path.substr(slash + 1);
+		Rule       &rule  = rules[name];
+		rule.name         = name;
+		try {
+			if (field == "plugin") {
+				rule.plugin = i->get_string();
+			} else if (field == "thread") {
+				rule.thread = i->get_string();
+			} else if (field == "cpus") {
+				rule.cpus = i->is_list() ? i->get_uints() : std::vector<unsigned int>{i->get_uint()};
+				rule.set_cpus = true;
+			} else if (field == "priority") {
+				rule.priority     = i->get_uint();
+				rule.set_priority = true;
+			} else {
+				logger_->log_warn("ThreadSchedulingPolicy",
+				                  "Ignoring unknown setting %s of rule %s",
+				                  field.c_str(),
+				                  name.c_str());
+			}
+		} catch (Exception &e) {
+			logger_->log_warn("ThreadSchedulingPolicy",
+			                  "Invalid setting %s of rule %s, ignoring",
+			                  field.c_str(),
+			                  name.c_str());
+			logger_->log_warn("ThreadSchedulingPolicy", e);
+		}
+	}
+	for (auto &r : rules) {
+		rules_.push_back(r.second);
+	}
+
+	if (config->get_bool_or_default("/fawkes/mainapp/scheduling/lock_memory", false)) {
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+			logger_->log_info("ThreadSchedulingPolicy", "Locked process memory");
+		} else {
+			logger_->log_warn("ThreadSchedulingPolicy",
+			                  "Failed to lock process memory: %s",
+			                  strerror(errno));
+		}
+	}
+}
+
+const ThreadSchedulingPolicy::Rule *
+ThreadSchedulingPolicy::find_rule(const char *thread, const char *plugin) const
+{
+	for (const Rule &r : rules_) {
+		if (!r.plugin.empty() && (plugin == NULL || r.plugin != plugin))
+			continue;
+		if (!r.thread.empty() && fnmatch(r.thread.c_str(), thread, 0) != 0)
+			continue;
+		return &r;
+	}
+	return NULL;
+}
+
+/** Apply policy to a thread.
+ * Failures to apply a setting, e.g. a real-time priority without the
+ * required privileges, are logged as warnings.
+ * @param thread thread to apply the policy to, must have been started
+ * @param plugin name of the plugin the thread belongs to, NULL if unknown
+ */
+void
+ThreadSchedulingPolicy::apply(Thread *thread, const char *plugin)
+{
+	const Rule *rule = find_rule(thread->name(), plugin);
+	if (!rule)
+		return;
+
+	// the settings refer to the kernel thread, which may not run, yet
+	if (thread->wait_tid() == 0) {
+		logger_->log_warn("ThreadSchedulingPolicy",
+		                  "Cannot apply rule %s to thread %s, not started",
+		                  rule->name.c_str(),
+		                  thread->name());
+		return;
+	}
+
+	if (rule->set_cpus) {
+		try {
+			thread->set_cpu_affinity(rule->cpus);
+		} catch (Exception &e) {
+			logger_->log_warn("ThreadSchedulingPolicy",
+			                  "Cannot restrict thread %s to CPUs %s (rule %s)",
+			                  thread->name(),
+			                  cpus_to_string(rule->cpus).c_str(),
+			                  rule->name.c_str());
+			logger_->log_warn("ThreadSchedulingPolicy", e);
+		}
+	}
+	if (rule->set_priority) {
+		try {
+			thread->set_realtime_priority(rule->priority);
+		} catch (Exception &e) {
+			logger_->log_warn("ThreadSchedulingPolicy",
+			                  "Cannot set priority %u of thread %s (rule %s)",
+			                  rule->priority,
+			                  thread->name(),
+			                  rule->name.c_str());
+			logger_->log_warn("ThreadSchedulingPolicy", e);
+		}
+	}
+
+	logger_->log_info("ThreadSchedulingPolicy",
+	                  "Thread %s (rule %s): CPUs %s, real-time priority %u",
+	                  thread->name(),
+	                  rule->name.c_str(),
+	                  cpus_to_string(thread->cpu_affinity()).c_str(),
+	                  thread->realtime_priority());
+}
+
+/** Log effective scheduling settings and statistics of a thread.
+ * @param thread thread to log statistics of
+ */
+void
+ThreadSchedulingPolicy::log_statistics(Thread *thread)
+{
+	Thread::SchedulingStatistics stats = thread->scheduling_statistics();
+	logger_->log_info("ThreadSchedulingPolicy",
+	                  "Thread %s (TID %i): CPUs %s, real-time priority %u, context switches "
+	                  "%" PRIu64 " voluntary/%" PRIu64 " involuntary, %" PRIu64 " migrations",
+	                  thread->name(),
+	                  (int)thread->tid(),
+	                  cpus_to_string(thread->cpu_affinity()).c_str(),
+	                  thread->realtime_priority(),
+	                  stats.voluntary_context_switches,
+	                  stats.involuntary_context_switches,
+	                  stats.migrations);
+}
+
+} // end namespace fawkes
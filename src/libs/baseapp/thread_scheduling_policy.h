@@ -0,0 +1,66 @@
+
+/***************************************************************************
+ *  thread_scheduling_policy.h - Config-driven thread scheduling policy
+ *
+ *  Created: Mon Oct 19 01:24:51 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_BASEAPP_THREAD_SCHEDULING_POLICY_H_
+#define _LIBS_BASEAPP_THREAD_SCHEDULING_POLICY_H_
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class Configuration;
+class Logger;
+class Thread;
+
+class ThreadSchedulingPolicy
+{
+public:
+	ThreadSchedulingPolicy(Configuration *config, Logger *logger);
+
+	void apply(Thread *thread, const char *plugin);
+	void log_statistics(Thread *thread);
+
+private:
+	struct Rule
+	{
+		std::string               name;
+		std::string               plugin;
+		std::string               thread;
+		std::vector<unsigned int> cpus;
+		bool                      set_cpus     = false;
+		unsigned int              priority     = 0;
+		bool                      set_priority = false;
+	};
+
+	const Rule *find_rule(const char *thread, const char *plugin) const;
+
+private:
+	Logger         *logger_;
+	std::list<Rule> rules_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -29,6 +29,7 @@
 #include <core/threading/mutex_locker.h>
 #include <core/utils/lock_hashmap.h>
 #include <core/utils/lock_hashset.h>
+#include <core/utils/trace.h>
 #include <interface/interface.h>
 #include <logging/liblogger.h>
 
@@ -742,6 +743,7 @@ BlackBoardNotifier::notify_of_data_refresh(const Interface *interface, bool has_
 bool
 BlackBoardNotifier::notify_of_message_received(const Interface *interface, Message *message)
 {
+	FAWKES_TRACE_SCOPE("blackboard.message", interface->uid());
 	bbil_messages_mutex_->lock();
 	bbil_messages_events_ += 1;
 	bbil_messages_mutex_->unlock();
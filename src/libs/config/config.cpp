@@ -23,6 +23,7 @@
 
 #include <config/change_handler.h>
 #include <config/config.h>
+#include <config/snapshot.h>
 
 #include <cstring>
 
@@ -35,9 +36,6 @@ namespace fawkes {
  * configuration options no matter of how the database is implemented.
  * This is mainly done to allow for testing different solutions for ticket #10.
  *
- * @fn Configuration::~Configuration()
- * Virtual empty destructor.
- *
  * @fn void Configuration::load(const char *file_path)
  * Load configuration.
  * Loads configuration data, or opens a file, depending on the implementation. After
@@ -594,6 +592,39 @@ CouldNotOpenConfigException::CouldNotOpenConfigException(const char *format, ...
  *
  */
 
+/** Constructor. */
+Configuration::Configuration()
+{
+	snapshot_manager_ = new ConfigSnapshotManager(this);
+}
+
+/** Virtual destructor. */
+Configuration::~Configuration()
+{
+	delete snapshot_manager_;
+}
+
+/** Get compiled snapshot of configuration.
+ * The snapshot is compiled on first use and replaced whenever values
+ * change. Reading from the returned snapshot requires no locking, the
+ * snapshot stays valid for as long as it is referenced.
+ * @return current snapshot
+ */
+std::shared_ptr<const ConfigSnapshot>
+Configuration::snapshot()
+{
+	return snapshot_manager_->snapshot();
+}
+
+/** Get snapshot manager.
+ * @return snapshot manager of this configuration
+ */
+ConfigSnapshotManager *
+Configuration::snapshot_manager()
+{
+	return snapshot_manager_;
+}
+
 /** Add a configuration change handler.
  * The added handler is called whenever a value changes and the handler
  * desires to get notified for the given component.
@@ -666,12 +697,36 @@ Configuration::find_handlers(const char *path)
 }
 
 /** Notify handlers for given path.
+ * Updates the configuration snapshot and notifies the change handlers.
  * @param path path to notify handlers for
  * @param comment_changed true if the change is about a comment change,
  * false otherwise
  */
 void
 Configuration::notify_handlers(const char *path, bool comment_changed)
+{
+	if (!comment_changed) {
+		snapshot_manager_->update(std::list<std::string>(1, path));
+	}
+	notify_change_handlers(path, comment_changed);
+}
+
+/** Notify handlers for multiple changed paths.
+ * Updates the configuration snapshot once for all paths and then notifies
+ * the change handlers for each path.
+ * @param paths paths of changed values
+ */
+void
+Configuration::notify_handlers(const std::list<std::string> &paths)
+{
+	snapshot_manager_->update(paths);
+	for (const std::string &p : paths) {
+		notify_change_handlers(p.c_str(), false);
+	}
+}
+
+void
+Configuration::notify_change_handlers(const char *path, bool comment_changed)
 {
 	ChangeHandlerList            *h     = find_handlers(path);
 	Configuration::ValueIterator *value = get_value(path);
@@ -29,12 +29,15 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace fawkes {
 
 class ConfigurationChangeHandler;
+class ConfigSnapshot;
+class ConfigSnapshotManager;
 
 class ConfigurationException : public Exception
 {
@@ -67,9 +70,8 @@ public:
 class Configuration
 {
 public:
-	virtual ~Configuration()
-	{
-	}
+	Configuration();
+	virtual ~Configuration();
 
 	class ValueIterator
 	{
@@ -113,6 +115,9 @@ public:
 	virtual void add_change_handler(ConfigurationChangeHandler *h);
 	virtual void rem_change_handler(ConfigurationChangeHandler *h);
 
+	std::shared_ptr<const ConfigSnapshot> snapshot();
+	ConfigSnapshotManager                *snapshot_manager();
+
 	virtual void load(const char *file_path) = 0;
 
 	virtual bool exists(const char *path)    = 0;
@@ -462,6 +467,13 @@ protected:
 
 	ChangeHandlerList *find_handlers(const char *path);
 	void               notify_handlers(const char *path, bool comment_changed = false);
+	void               notify_handlers(const std::list<std::string> &paths);
+
+private:
+	void notify_change_handlers(const char *path, bool comment_changed);
+
+private:
+	ConfigSnapshotManager *snapshot_manager_;
 };
 
 } // end namespace fawkes
@@ -0,0 +1,98 @@
+
+/***************************************************************************
+ *  handle.cpp - Fawkes typed configuration value handle
+ *
+ *  Created: Sun Oct 18 20:58:44 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <config/handle.h>
+
+namespace fawkes {
+
+/** @class ConfigHandleBase <config/handle.h>
+ * Base class for typed configuration value handles.
+ * Registers the handle with the snapshot manager of the configuration,
+ * which keeps the value of the handle up to date. See ConfigHandle for
+ * the typed handle to use.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param config configuration to read value from
+ * @param path path of value
+ */
+ConfigHandleBase::ConfigHandleBase(Configuration *config, const char *path)
+: manager_(config->snapshot_manager()), path_(path)
+{
+}
+
+/** Virtual empty destructor. */
+ConfigHandleBase::~ConfigHandleBase()
+{
+}
+
+/** Get path of value.
+ * @return path of value
+ */
+const std::string &
+ConfigHandleBase::path() const
+{
+	return path_;
+}
+
+/** Register handle with snapshot manager.
+ * Must be called from the constructor of the sub-class, once update() can
+ * be called.
+ * @exception ConfigEntryNotFoundException thrown if the value does not exist
+ * @exception ConfigTypeMismatchException thrown if the value cannot be
+ * converted to the handle's type
+ */
+void
+ConfigHandleBase::register_handle()
+{
+	manager_->add_handle(this);
+}
+
+/** Unregister handle from snapshot manager.
+ * Must be called from the destructor of the sub-class.
+ */
+void
+ConfigHandleBase::unregister_handle()
+{
+	manager_->remove_handle(this);
+}
+
+/** Lock updates.
+ * No updates happen while locked, e.g. to safely modify state accessed
+ * in update().
+ */
+void
+ConfigHandleBase::lock_updates()
+{
+	manager_->lock();
+}
+
+/** Unlock updates. */
+void
+ConfigHandleBase::unlock_updates()
+{
+	manager_->unlock();
+}
+
+} // end namespace fawkes
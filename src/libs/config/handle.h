@@ -0,0 +1,299 @@
+
+/***************************************************************************
+ *  handle.h - Fawkes typed configuration value handle
+ *
+ *  Created: Sun Oct 18 20:58:44 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CONFIG_HANDLE_H_
+#define _CONFIG_HANDLE_H_
+
+#include <config/snapshot.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace fawkes {
+
+class ConfigHandleBase
+{
+	friend ConfigSnapshotManager;
+
+public:
+	virtual ~ConfigHandleBase();
+
+	const std::string &path() const;
+
+protected:
+	ConfigHandleBase(Configuration *config, const char *path);
+
+	void register_handle();
+	void unregister_handle();
+	void lock_updates();
+	void unlock_updates();
+
+	/** Update value.
+	 * Called when the handle is registered and whenever the value changes.
+	 * @param value new value, NULL if the value does not exist (anymore)
+	 * @param initial true when called during registration
+	 * @return true if the handle has a valid value, false if the value
+	 * does not exist or cannot be converted and there is no default value
+	 */
+	virtual bool update(const ConfigSnapshot::Value *value, bool initial) = 0;
+
+	/** Get name of value type.
+	 * @return name of value type as used by the configuration
+	 */
+	virtual const char *type_name() const = 0;
+
+private:
+	ConfigHandleBase(const ConfigHandleBase &) = delete;
+	ConfigHandleBase &operator=(const ConfigHandleBase &) = delete;
+
+private:
+	ConfigSnapshotManager *manager_;
+	std::string            path_;
+};
+
+/// @cond INTERNALS
+template <typename T>
+struct ConfigHandleType;
+template <>
+struct ConfigHandleType<float>
+{
+	static const char *
+	name()
+	{
+		return "float";
+	}
+};
+template <>
+struct ConfigHandleType<unsigned int>
+{
+	static const char *
+	name()
+	{
+		return "unsigned int";
+	}
+};
+template <>
+struct ConfigHandleType<int>
+{
+	static const char *
+	name()
+	{
+		return "int";
+	}
+};
+template <>
+struct ConfigHandleType<bool>
+{
+	static const char *
+	name()
+	{
+		return "bool";
+	}
+};
+template <>
+struct ConfigHandleType<std::string>
+{
+	static const char *
+	name()
+	{
+		return "string";
+	}
+};
+template <typename T>
+struct ConfigHandleType<std::vector<T>>
+{
+	static const char *
+	name()
+	{
+		return ConfigHandleType<T>::name();
+	}
+};
+
+template <typename T, bool Atomic = std::is_trivially_copyable<T>::value>
+class ConfigHandleStorage
+{
+public:
+	ConfigHandleStorage() : value_(T())
+	{
+	}
+	T
+	load() const
+	{
+		return value_.load(std::memory_order_acquire);
+	}
+	void
+	store(const T &value)
+	{
+		value_.store(value, std::memory_order_release);
+	}
+
+private:
+	std::atomic<T> value_;
+};
+
+template <typename T>
+class ConfigHandleStorage<T, false>
+{
+public:
+	ConfigHandleStorage() : value_(std::make_shared<const T>())
+	{
+	}
+	T
+	load() const
+	{
+		return *std::atomic_load(&value_);
+	}
+	void
+	store(const T &value)
+	{
+		std::atomic_store(&value_, std::shared_ptr<const T>(std::make_shared<const T>(value)));
+	}
+
+private:
+	std::shared_ptr<const T> value_;
+};
+/// @endcond
+
+/** @class ConfigHandle <config/handle.h>
+ * Typed handle to a configuration value.
+ * The handle resolves the path once on construction and keeps a copy of
+ * the value, which is updated whenever the value changes in the
+ * configuration. Reading the value therefore is a plain load without any
+ * locking, lookup or conversion and can be done in every loop.
+ *
+ * Supported types are float, unsigned int, int, bool, std::string and
+ * std::vector of these. The conversion rules are the same as for the
+ * corresponding Configuration::get_*() method.
+ *
+ * If a value is erased or changes to a type that cannot be converted, the
+ * handle falls back to the default value, if one was given, or keeps the
+ * last valid value otherwise. Handles must be destroyed before the
+ * configuration they refer to.
+ * @author Tim Niemueller
+ */
+template <typename T>
+class ConfigHandle : public ConfigHandleBase
+{
+public:
+	/** Function called with the new value when the value changed. */
+	typedef std::function<void(const T &)> ChangeCallback;
+
+	/** Constructor.
+	 * @param config configuration to read value from
+	 * @param path path of value
+	 * @exception ConfigEntryNotFoundException thrown if the value does not exist
+	 * @exception ConfigTypeMismatchException thrown if the value cannot be
+	 * converted to the handle's type
+	 */
+	ConfigHandle(Configuration *config, const char *path)
+	: ConfigHandleBase(config, path), has_default_(false)
+	{
+		register_handle();
+	}
+
+	/** Constructor with default value.
+	 * @param config configuration to read value from
+	 * @param path path of value
+	 * @param default_value value to use if the value does not exist or cannot
+	 * be converted to the handle's type
+	 */
+	ConfigHandle(Configuration *config, const char *path, const T &default_value)
+	: ConfigHandleBase(config, path), has_default_(true), default_(default_value)
+	{
+		register_handle();
+	}
+
+	/** Destructor. */
+	virtual ~ConfigHandle()
+	{
+		unregister_handle();
+	}
+
+	/** Get value.
+	 * @return current value
+	 */
+	T
+	get() const
+	{
+		return value_.load();
+	}
+
+	/** Get value.
+	 * @return current value
+	 */
+	operator T() const
+	{
+		return value_.load();
+	}
+
+	/** Set change callback.
+	 * The callback is called after the value has changed, from the thread
+	 * that changed the configuration. It must not create or destroy handles.
+	 * @param callback callback to call, an empty function to disable
+	 */
+	void
+	set_change_callback(const ChangeCallback &callback)
+	{
+		lock_updates();
+		callback_ = callback;
+		unlock_updates();
+	}
+
+protected:
+	virtual bool
+	update(const ConfigSnapshot::Value *value, bool initial)
+	{
+		T v;
+		if (value && value->get(v)) {
+			value_.store(v);
+		} else if (has_default_) {
+			value_.store(default_);
+		} else if (initial) {
+			return false;
+		}
+		if (!initial && callback_) {
+			callback_(value_.load());
+		}
+		return true;
+	}
+
+	virtual const char *
+	type_name() const
+	{
+		return ConfigHandleType<T>::name();
+	}
+
+private:
+	bool                   has_default_;
+	T                      default_;
+	ChangeCallback         callback_;
+	ConfigHandleStorage<T> value_;
+};
+
+} // end namespace fawkes
+
+#endif
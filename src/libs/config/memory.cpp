@@ -284,6 +284,7 @@ MemoryConfiguration::set_float(const char *path, float f)
 {
 	root_->set_value(path, f);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -291,6 +292,7 @@ MemoryConfiguration::set_uint(const char *path, unsigned int uint)
 {
 	root_->set_value(path, uint);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -298,6 +300,7 @@ MemoryConfiguration::set_int(const char *path, int i)
 {
 	root_->set_value(path, i);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -305,6 +308,7 @@ MemoryConfiguration::set_bool(const char *path, bool b)
 {
 	root_->set_value(path, b);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -312,6 +316,7 @@ MemoryConfiguration::set_string(const char *path, const char *s)
 {
 	root_->set_value(path, std::string(s));
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -325,6 +330,7 @@ MemoryConfiguration::set_floats(const char *path, std::vector<float> &f)
 {
 	root_->set_list(path, f);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -332,6 +338,7 @@ MemoryConfiguration::set_uints(const char *path, std::vector<unsigned int> &u)
 {
 	root_->set_list(path, u);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -339,6 +346,7 @@ MemoryConfiguration::set_ints(const char *path, std::vector<int> &i)
 {
 	root_->set_list(path, i);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -346,6 +354,7 @@ MemoryConfiguration::set_bools(const char *path, std::vector<bool> &b)
 {
 	root_->set_list(path, b);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -353,6 +362,7 @@ MemoryConfiguration::set_strings(const char *path, std::vector<std::string> &s)
 {
 	root_->set_list(path, s);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -360,6 +370,7 @@ MemoryConfiguration::set_strings(const char *path, std::vector<const char *> &s)
 {
 	root_->set_list(path, s);
 	root_->set_default(path, false);
+	notify_handlers(path);
 }
 
 void
@@ -376,6 +387,7 @@ void
 MemoryConfiguration::erase(const char *path)
 {
 	root_->erase(path);
+	notify_handlers(path);
 }
 
 void
@@ -383,6 +395,7 @@ MemoryConfiguration::set_default_float(const char *path, float f)
 {
 	root_->set_value(path, f);
 	root_->set_default(path, true);
+	notify_handlers(path);
 }
 
 void
@@ -390,6 +403,7 @@ MemoryConfiguration::set_default_uint(const char *path, unsigned int uint)
 {
 	root_->set_value(path, uint);
 	root_->set_default(path, true);
+	notify_handlers(path);
 }
 
 void
@@ -397,6 +411,7 @@ MemoryConfiguration::set_default_int(const char *path, int i)
 {
 	root_->set_value(path, i);
 	root_->set_default(path, true);
+	notify_handlers(path);
 }
 
 void
@@ -404,6 +419,7 @@ MemoryConfiguration::set_default_bool(const char *path, bool b)
 {
 	root_->set_value(path, b);
 	root_->set_default(path, true);
+	notify_handlers(path);
 }
 
 void
@@ -411,6 +427,7 @@ MemoryConfiguration::set_default_string(const char *path, const char *s)
 {
 	root_->set_value(path, s);
 	root_->set_default(path, true);
+	notify_handlers(path);
 }
 
 void
@@ -433,6 +450,7 @@ void
 MemoryConfiguration::erase_default(const char *path)
 {
 	root_->erase(path);
+	notify_handlers(path);
 }
 
 /** Lock the config.
@@ -0,0 +1,148 @@
+
+/***************************************************************************
+ *  qa_config_snapshot.cpp - QA for compiled configuration snapshots
+ *
+ *  Created: Sun Oct 18 21:37:12 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <config/handle.h>
+#include <config/memory.h>
+#include <utils/time/tracker.h>
+
+#include <cstdio>
+
+using namespace fawkes;
+
+static unsigned int num_errors = 0;
+
+static void
+check(bool condition, const char *what)
+{
+	if (!condition) {
+		printf("FAILED: %s\n", what);
+		++num_errors;
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	MemoryConfiguration *config = new MemoryConfiguration();
+
+	config->set_float("/qa/float", 1.5);
+	config->set_uint("/qa/uint", 42);
+	config->set_string("/qa/string", "foo");
+	std::vector<int> ints = {1, -2, 3};
+	config->set_ints("/qa/ints", ints);
+
+	try {
+		ConfigHandle<float>            f(config, "/qa/float");
+		ConfigHandle<unsigned int>     u(config, "/qa/uint");
+		ConfigHandle<int>              i(config, "/qa/uint");
+		ConfigHandle<std::string>      s(config, "/qa/string");
+		ConfigHandle<std::vector<int>> l(config, "/qa/ints");
+		ConfigHandle<bool>             b(config, "/qa/missing", true);
+
+		check(f == 1.5, "float value");
+		check(u == 42, "uint value");
+		check(i == 42, "uint read as int");
+		check(s.get() == "foo", "string value");
+		check(l.get() == ints, "int list value");
+		check(b, "default value");
+
+		unsigned int num_calls = 0;
+		f.set_change_callback([&num_calls](const float &v) { ++num_calls; });
+
+		unsigned int generation = config->snapshot()->generation();
+		config->set_float("/qa/float", 2.5);
+		check(f == 2.5, "float value after change");
+		check(num_calls == 1, "change callback");
+		check(config->snapshot()->generation() == generation + 1, "snapshot generation");
+
+		config->set_bool("/qa/missing", false);
+		check(!b, "bool value after set");
+		config->erase("/qa/missing");
+		check(b, "default value after erase");
+
+		config->erase("/qa/string");
+		check(s.get() == "foo", "last value kept after erase");
+		check(config->snapshot()->find("/qa/string") == NULL, "erased value removed from snapshot");
+
+		// a change notification may refer to a whole subtree
+		config->set_uint("/qa/tree/a", 1);
+		config->set_uint("/qa/tree/b", 2);
+		config->set_uint("/qa/treetop", 3);
+		std::shared_ptr<const ConfigSnapshot> tree_snap = config->snapshot();
+		config->erase("/qa/tree/a");
+		config->set_uint("/qa/tree/b", 4);
+		ConfigSnapshot tree_update(*tree_snap, config, std::list<std::string>(1, "/qa/tree"));
+		unsigned int   tree_b = 0, treetop = 0;
+		check(tree_update.find("/qa/tree/a") == NULL, "erased value below subtree removed");
+		check(tree_update.get("/qa/tree/b", tree_b) && tree_b == 4, "value below subtree updated");
+		check(tree_update.get("/qa/treetop", treetop) && treetop == 3, "sibling value kept");
+
+		std::shared_ptr<const ConfigSnapshot> snap = config->snapshot();
+		config->set_uint("/qa/uint", 23);
+		unsigned int old_u = 0;
+		check(snap->get("/qa/uint", old_u) && old_u == 42, "old snapshot unchanged");
+		check(u == 23, "uint value after change");
+
+		try {
+			ConfigHandle<float> n(config, "/qa/none");
+			check(false, "missing value without default throws");
+		} catch (ConfigEntryNotFoundException &e) {
+		}
+		try {
+			ConfigHandle<float> n(config, "/qa/ints");
+			check(false, "type mismatch throws");
+		} catch (ConfigTypeMismatchException &e) {
+		}
+
+		TimeTracker  tt;
+		unsigned int ttc_get    = tt.add_class("Configuration::get_float()");
+		unsigned int ttc_handle = tt.add_class("ConfigHandle<float>::get()");
+		float        sum        = 0.;
+		for (unsigned int r = 0; r < 100; ++r) {
+			tt.ping_start(ttc_get);
+			for (unsigned int j = 0; j < 10000; ++j) {
+				sum += config->get_float("/qa/float");
+			}
+			tt.ping_end(ttc_get);
+			tt.ping_start(ttc_handle);
+			for (unsigned int j = 0; j < 10000; ++j) {
+				sum += f.get();
+			}
+			tt.ping_end(ttc_handle);
+		}
+		printf("Time for 10000 reads (sum %f)\n", sum);
+		tt.print_to_stdout();
+	} catch (Exception &e) {
+		e.print_trace();
+		++num_errors;
+	}
+
+	delete config;
+
+	printf("%u errors\n", num_errors);
+	return (num_errors == 0) ? 0 : 1;
+}
+
+/// @endcond
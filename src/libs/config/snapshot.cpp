@@ -0,0 +1,496 @@
+
+/***************************************************************************
+ *  snapshot.cpp - Fawkes compiled configuration snapshot
+ *
+ *  Created: Sun Oct 18 20:41:09 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <config/handle.h>
+#include <config/snapshot.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+
+#include <cstring>
+#include <memory>
+
+namespace fawkes {
+
+/** @class ConfigSnapshot <config/snapshot.h>
+ * Compiled, immutable snapshot of a configuration.
+ * The snapshot contains all values of a configuration, converted once to
+ * all types they can be read as, in a hash map. Looking up a value does
+ * neither lock the configuration nor parse or convert anything. Snapshots
+ * are never modified after construction, a change to the configuration
+ * results in a new snapshot which shares all unchanged values with the
+ * previous one.
+ * @author Tim Niemueller
+ */
+
+/** @class ConfigSnapshot::Value <config/snapshot.h>
+ * Compiled configuration value.
+ * The value is stored in all representations the configuration allows to
+ * read it as, i.e. a value that can be read by Configuration::get_float()
+ * can be read as float from the compiled value.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param v value iterator pointing to the value to compile
+ */
+ConfigSnapshot::Value::Value(const Configuration::ValueIterator *v)
+: type_(v->type()), is_list_(v->is_list()), flags_(0), float_(0.), uint_(0), int_(0), bool_(false)
+{
+	if (is_list_) {
+		try {
+			floats_ = v->get_floats();
+			flags_ |= HAS_FLOAT;
+		} catch (Exception &e) {
+		}
+		try {
+			uints_ = v->get_uints();
+			flags_ |= HAS_UINT;
+		} catch (Exception &e) {
+		}
+		try {
+			ints_ = v->get_ints();
+			flags_ |= HAS_INT;
+		} catch (Exception &e) {
+		}
+		try {
+			bools_ = v->get_bools();
+			flags_ |= HAS_BOOL;
+		} catch (Exception &e) {
+		}
+		try {
+			strings_ = v->get_strings();
+			flags_ |= HAS_STRING;
+		} catch (Exception &e) {
+		}
+	} else {
+		try {
+			float_ = v->get_float();
+			flags_ |= HAS_FLOAT;
+		} catch (Exception &e) {
+		}
+		try {
+			uint_ = v->get_uint();
+			flags_ |= HAS_UINT;
+		} catch (Exception &e) {
+		}
+		try {
+			int_ = v->get_int();
+			flags_ |= HAS_INT;
+		} catch (Exception &e) {
+		}
+		try {
+			bool_ = v->get_bool();
+			flags_ |= HAS_BOOL;
+		} catch (Exception &e) {
+		}
+		try {
+			string_ = v->get_string();
+			flags_ |= HAS_STRING;
+		} catch (Exception &e) {
+		}
+	}
+}
+
+/** Get type of value.
+ * @return type of value as reported by the configuration
+ */
+const std::string &
+ConfigSnapshot::Value::type() const
+{
+	return type_;
+}
+
+/** Check if value is a list.
+ * @return true if value is a list, false otherwise
+ */
+bool
+ConfigSnapshot::Value::is_list() const
+{
+	return is_list_;
+}
+
+/** Get value as float.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as float, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(float &value) const
+{
+	if (is_list_ || !(flags_ & HAS_FLOAT))
+		return false;
+	value = float_;
+	return true;
+}
+
+/** Get value as unsigned int.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as unsigned int, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(unsigned int &value) const
+{
+	if (is_list_ || !(flags_ & HAS_UINT))
+		return false;
+	value = uint_;
+	return true;
+}
+
+/** Get value as int.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as int, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(int &value) const
+{
+	if (is_list_ || !(flags_ & HAS_INT))
+		return false;
+	value = int_;
+	return true;
+}
+
+/** Get value as bool.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as bool, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(bool &value) const
+{
+	if (is_list_ || !(flags_ & HAS_BOOL))
+		return false;
+	value = bool_;
+	return true;
+}
+
+/** Get value as string.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as string, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(std::string &value) const
+{
+	if (is_list_ || !(flags_ & HAS_STRING))
+		return false;
+	value = string_;
+	return true;
+}
+
+/** Get value as list of floats.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as list of floats, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(std::vector<float> &value) const
+{
+	if (!is_list_ || !(flags_ & HAS_FLOAT))
+		return false;
+	value = floats_;
+	return true;
+}
+
+/** Get value as list of unsigned ints.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as list of unsigned ints, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(std::vector<unsigned int> &value) const
+{
+	if (!is_list_ || !(flags_ & HAS_UINT))
+		return false;
+	value = uints_;
+	return true;
+}
+
+/** Get value as list of ints.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as list of ints, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(std::vector<int> &value) const
+{
+	if (!is_list_ || !(flags_ & HAS_INT))
+		return false;
+	value = ints_;
+	return true;
+}
+
+/** Get value as list of bools.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as list of bools, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(std::vector<bool> &value) const
+{
+	if (!is_list_ || !(flags_ & HAS_BOOL))
+		return false;
+	value = bools_;
+	return true;
+}
+
+/** Get value as list of strings.
+ * @param value upon successful return contains the value
+ * @return true if the value could be read as list of strings, false otherwise
+ */
+bool
+ConfigSnapshot::Value::get(std::vector<std::string> &value) const
+{
+	if (!is_list_ || !(flags_ & HAS_STRING))
+		return false;
+	value = strings_;
+	return true;
+}
+
+/** Constructor.
+ * Compiles all values of the given configuration.
+ * @param config configuration to compile
+ */
+ConfigSnapshot::ConfigSnapshot(Configuration *config) : generation_(0)
+{
+	std::unique_ptr<Configuration::ValueIterator> i(config->iterator());
+	while (i->next()) {
+		values_[i->path()] = std::make_shared<const Value>(i.get());
+	}
+}
+
+/** Incremental constructor.
+ * Creates a snapshot which is a copy of the given snapshot with the
+ * given paths re-compiled. Unchanged values are shared with the base
+ * snapshot. Paths which no longer exist in the configuration are removed.
+ * A path may also denote a subtree, e.g. one that has been erased, then all
+ * values below it are re-compiled or removed.
+ * @param base snapshot to base the new snapshot on
+ * @param config configuration to read changed values from
+ * @param paths paths of changed values
+ */
+ConfigSnapshot::ConfigSnapshot(const ConfigSnapshot         &base,
+                               Configuration                *config,
+                               const std::list<std::string> &paths)
+: values_(base.values_), generation_(base.generation_ + 1)
+{
+	for (const std::string &p : paths) {
+		compile(p.c_str(), config);
+	}
+}
+
+void
+ConfigSnapshot::compile(const char *path, Configuration *config)
+{
+	std::string subtree = std::string(path) + "/";
+	for (auto v = values_.begin(); v != values_.end();) {
+		if (v->first == path || v->first.compare(0, subtree.length(), subtree) == 0) {
+			v = values_.erase(v);
+		} else {
+			++v;
+		}
+	}
+
+	std::unique_ptr<Configuration::ValueIterator> i(config->get_value(path));
+	if (i->next()) {
+		values_[path] = std::make_shared<const Value>(i.get());
+	}
+	// search may also return values of siblings sharing the prefix
+	std::unique_ptr<Configuration::ValueIterator> c(config->search(subtree.c_str()));
+	while (c->next()) {
+		if (strncmp(c->path(), subtree.c_str(), subtree.length()) == 0) {
+			values_[c->path()] = std::make_shared<const Value>(c.get());
+		}
+	}
+}
+
+/** Find value.
+ * @param path path of value
+ * @return compiled value or NULL if the value does not exist. The value
+ * is valid as long as the snapshot exists.
+ */
+const ConfigSnapshot::Value *
+ConfigSnapshot::find(const char *path) const
+{
+	return find(std::string(path));
+}
+
+/** Find value.
+ * @param path path of value
+ * @return compiled value or NULL if the value does not exist. The value
+ * is valid as long as the snapshot exists.
+ */
+const ConfigSnapshot::Value *
+ConfigSnapshot::find(const std::string &path) const
+{
+	auto v = values_.find(path);
+	return (v != values_.end()) ? v->second.get() : NULL;
+}
+
+/** Get number of values in snapshot.
+ * @return number of values
+ */
+size_t
+ConfigSnapshot::size() const
+{
+	return values_.size();
+}
+
+/** Get generation of snapshot.
+ * The generation is incremented for every snapshot derived from a
+ * previous one and can be used to quickly detect changes.
+ * @return generation
+ */
+unsigned int
+ConfigSnapshot::generation() const
+{
+	return generation_;
+}
+
+/** @class ConfigSnapshotManager <config/snapshot.h>
+ * Maintains the current snapshot of a configuration.
+ * The manager compiles the snapshot on first use and derives a new
+ * snapshot whenever the configuration notifies about changed values.
+ * Publishing a snapshot is a single atomic pointer swap. Readers which
+ * still hold the previous snapshot keep it alive until they drop it.
+ * The manager also keeps the registered ConfigHandle instances up to date.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param config configuration to manage snapshots for
+ */
+ConfigSnapshotManager::ConfigSnapshotManager(Configuration *config)
+: config_(config), mutex_(new Mutex(Mutex::RECURSIVE))
+{
+}
+
+/** Destructor. */
+ConfigSnapshotManager::~ConfigSnapshotManager()
+{
+	delete mutex_;
+}
+
+/** Get current snapshot.
+ * Compiles the snapshot if this has not happened, yet. Afterwards this is
+ * a lock-free atomic load.
+ * @return current snapshot
+ */
+std::shared_ptr<const ConfigSnapshot>
+ConfigSnapshotManager::snapshot()
+{
+	std::shared_ptr<const ConfigSnapshot> s = std::atomic_load(&snapshot_);
+	if (!s) {
+		MutexLocker lock(mutex_);
+		s = std::atomic_load(&snapshot_);
+		if (!s) {
+			s = std::make_shared<const ConfigSnapshot>(config_);
+			std::atomic_store(&snapshot_, s);
+		}
+	}
+	return s;
+}
+
+/** Update snapshot for changed values.
+ * Re-compiles the given values, publishes the new snapshot and updates
+ * the handles referring to the changed values.
+ * @param paths paths of changed values
+ */
+void
+ConfigSnapshotManager::update(const std::list<std::string> &paths)
+{
+	MutexLocker lock(mutex_);
+	std::shared_ptr<const ConfigSnapshot> s = std::atomic_load(&snapshot_);
+	if (!s)
+		return;
+	publish(std::make_shared<const ConfigSnapshot>(*s, config_, paths), paths);
+}
+
+void
+ConfigSnapshotManager::publish(const std::shared_ptr<const ConfigSnapshot> &snapshot,
+                               const std::list<std::string>               &paths)
+{
+	std::atomic_store(&snapshot_, snapshot);
+	for (const std::string &p : paths) {
+		// handles of the path itself and, if it is a subtree, of all below
+		auto h   = handles_.lower_bound(p);
+		auto end = handles_.lower_bound(p + "0"); // '0' follows '/'
+		for (; h != end; ++h) {
+			if (h->first == p || h->first.compare(0, p.length() + 1, p + "/") == 0) {
+				h->second->update(snapshot->find(h->first), false);
+			}
+		}
+	}
+}
+
+/** Add handle.
+ * The handle is initialized with the current value.
+ * @param handle handle to add
+ * @exception ConfigEntryNotFoundException thrown if the value does not
+ * exist and the handle has no default value
+ * @exception ConfigTypeMismatchException thrown if the value cannot be
+ * converted to the type of the handle and the handle has no default value
+ */
+void
+ConfigSnapshotManager::add_handle(ConfigHandleBase *handle)
+{
+	MutexLocker                           lock(mutex_);
+	std::shared_ptr<const ConfigSnapshot> s = snapshot();
+	const ConfigSnapshot::Value          *v = s->find(handle->path());
+	if (!handle->update(v, true)) {
+		if (v) {
+			throw ConfigTypeMismatchException(handle->path().c_str(),
+			                                  v->type().c_str(),
+			                                  handle->type_name());
+		} else {
+			throw ConfigEntryNotFoundException(handle->path().c_str());
+		}
+	}
+	handles_.insert(std::make_pair(handle->path(), handle));
+}
+
+/** Remove handle.
+ * @param handle handle to remove
+ */
+void
+ConfigSnapshotManager::remove_handle(ConfigHandleBase *handle)
+{
+	MutexLocker lock(mutex_);
+	auto        r = handles_.equal_range(handle->path());
+	for (auto h = r.first; h != r.second; ++h) {
+		if (h->second == handle) {
+			handles_.erase(h);
+			break;
+		}
+	}
+}
+
+/** Lock manager.
+ * While locked, no snapshot is published and no handle updated.
+ */
+void
+ConfigSnapshotManager::lock()
+{
+	mutex_->lock();
+}
+
+/** Unlock manager. */
+void
+ConfigSnapshotManager::unlock()
+{
+	mutex_->unlock();
+}
+
+} // end namespace fawkes
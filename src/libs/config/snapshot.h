@@ -0,0 +1,150 @@
+
+/***************************************************************************
+ *  snapshot.h - Fawkes compiled configuration snapshot
+ *
+ *  Created: Sun Oct 18 20:41:09 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CONFIG_SNAPSHOT_H_
+#define _CONFIG_SNAPSHOT_H_
+
+#include <config/config.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class ConfigHandleBase;
+
+class ConfigSnapshot
+{
+public:
+	class Value
+	{
+	public:
+		Value(const Configuration::ValueIterator *v);
+
+		const std::string &type() const;
+		bool               is_list() const;
+
+		bool get(float &value) const;
+		bool get(unsigned int &value) const;
+		bool get(int &value) const;
+		bool get(bool &value) const;
+		bool get(std::string &value) const;
+		bool get(std::vector<float> &value) const;
+		bool get(std::vector<unsigned int> &value) const;
+		bool get(std::vector<int> &value) const;
+		bool get(std::vector<bool> &value) const;
+		bool get(std::vector<std::string> &value) const;
+
+	private:
+		typedef enum {
+			HAS_FLOAT  = 1 << 0,
+			HAS_UINT   = 1 << 1,
+			HAS_INT    = 1 << 2,
+			HAS_BOOL   = 1 << 3,
+			HAS_STRING = 1 << 4
+		} value_flags_t;
+
+		std::string  type_;
+		bool         is_list_;
+		unsigned int flags_;
+
+		float        float_;
+		unsigned int uint_;
+		int          int_;
+		bool         bool_;
+		std::string  string_;
+
+		std::vector<float>        floats_;
+		std::vector<unsigned int> uints_;
+		std::vector<int>          ints_;
+		std::vector<bool>         bools_;
+		std::vector<std::string>  strings_;
+	};
+
+	ConfigSnapshot(Configuration *config);
+	ConfigSnapshot(const ConfigSnapshot         &base,
+	               Configuration                *config,
+	               const std::list<std::string> &paths);
+
+	const Value *find(const char *path) const;
+	const Value *find(const std::string &path) const;
+	size_t       size() const;
+	unsigned int generation() const;
+
+	/** Get value converted to the requested type.
+	 * @param path path of value
+	 * @param value upon successful return contains the value
+	 * @return true if the value exists and can be converted to the
+	 * requested type, false otherwise
+	 */
+	template <typename T>
+	bool
+	get(const char *path, T &value) const
+	{
+		const Value *v = find(path);
+		return v && v->get(value);
+	}
+
+private:
+	void compile(const char *path, Configuration *config);
+
+private:
+	std::unordered_map<std::string, std::shared_ptr<const Value>> values_;
+	unsigned int                                                   generation_;
+};
+
+class ConfigSnapshotManager
+{
+public:
+	ConfigSnapshotManager(Configuration *config);
+	~ConfigSnapshotManager();
+
+	std::shared_ptr<const ConfigSnapshot> snapshot();
+
+	void update(const std::list<std::string> &paths);
+
+	void add_handle(ConfigHandleBase *handle);
+	void remove_handle(ConfigHandleBase *handle);
+
+	void lock();
+	void unlock();
+
+private:
+	void publish(const std::shared_ptr<const ConfigSnapshot> &snapshot,
+	             const std::list<std::string>               &paths);
+
+private:
+	Configuration                                  *config_;
+	Mutex                                          *mutex_;
+	std::shared_ptr<const ConfigSnapshot>           snapshot_;
+	std::multimap<std::string, ConfigHandleBase *> handles_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -542,10 +542,7 @@ YamlConfiguration::fam_event(const char *filename, unsigned int mask)
 			host_root_ = host_root;
 			host_file_ = host_file;
 
-			std::list<std::string>::iterator c;
-			for (c = changes.begin(); c != changes.end(); ++c) {
-				notify_handlers(c->c_str());
-			}
+			notify_handlers(changes);
 		}
 
 		// includes might have changed to include a new empty file
@@ -1052,6 +1049,7 @@ YamlConfiguration::erase(const char *path)
 	host_root_->erase(path);
 	root_->erase(path);
 	write_host_file();
+	notify_handlers(path, false);
 }
 
 void
@@ -124,7 +124,7 @@ typedef const char *(*PluginDependenciesFunc)();
  */
 #define PLUGIN_DEPENDS(plugin_list)                                                         \
 	extern "C" const char _plugin_dependencies[] __attribute((__section__(".fawkes_plugin"))) \
-	__attribute((__used__)) = info_string;                                                    \
+	__attribute((__used__)) = plugin_list;                                                    \
                                                                                             \
 	extern "C" const char *plugin_depends()                                                   \
 	{                                                                                         \
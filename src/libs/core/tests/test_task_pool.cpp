@@ -0,0 +1,156 @@
+/***************************************************************************
+ *  test_task_pool.cpp - TaskPool Unit Test
+ *
+ *  Created: Mon Oct 19 00:31:44 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/task_pool.h>
+
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace fawkes;
+
+TEST_CASE("Futures return task results", "[task_pool]")
+{
+	TaskPool                      pool(3);
+	std::vector<std::future<int>> futures;
+	for (int i = 0; i < 100; ++i) {
+		futures.push_back(pool.submit([i]() { return i * i; }));
+	}
+	for (int i = 0; i < 100; ++i) {
+		REQUIRE(futures[i].get() == i * i);
+	}
+
+	std::future<int> failing = pool.submit([]() -> int { throw Exception("failed"); });
+	REQUIRE_THROWS_AS(failing.get(), Exception);
+}
+
+TEST_CASE("Parallel for covers the range exactly once", "[task_pool]")
+{
+	unsigned int num_threads = GENERATE(0, 1, 4);
+	TaskPool     pool(num_threads);
+
+	std::vector<std::atomic<int>> visited(10007);
+	for (auto &v : visited)
+		v = 0;
+	pool.parallel_for(0, visited.size(), [&visited](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			visited[i].fetch_add(1);
+	});
+	for (auto &v : visited)
+		REQUIRE(v == 1);
+
+	REQUIRE_THROWS_AS(pool.parallel_for(
+	                    0, 100, [](size_t b, size_t e) { throw Exception("failed"); }, 10),
+	                  Exception);
+}
+
+TEST_CASE("Nested waits do not deadlock", "[task_pool]")
+{
+	TaskPool            pool(2);
+	std::atomic<size_t> sum(0);
+
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < 8; ++i) {
+		futures.push_back(pool.submit([&pool, &sum]() {
+			pool.parallel_for(0, 1000, [&sum](size_t begin, size_t end) {
+				for (size_t j = begin; j < end; ++j)
+					sum.fetch_add(j);
+			});
+		}));
+	}
+	for (auto &f : futures) {
+		pool.wait(f);
+	}
+	REQUIRE(sum == 8 * 999 * 1000 / 2);
+}
+
+TEST_CASE("High priority tasks run before queued normal tasks", "[task_pool]")
+{
+	TaskPool         pool(1);
+	Mutex            mutex;
+	std::vector<int> order;
+	std::atomic<int> global_submitted(0);
+
+	auto record = [&mutex, &order](int v) {
+		MutexLocker lock(&mutex);
+		order.push_back(v);
+	};
+
+	std::future<void> outer = pool.submit([&]() {
+		// queued locally on the only worker, before and after the
+		// high priority task, i.e., not served by LIFO order alone
+		for (int i = 0; i < 10; ++i)
+			pool.execute([&record]() { record(0); });
+		pool.execute([&record]() { record(1); }, TaskPool::PRIORITY_HIGH);
+		for (int i = 0; i < 10; ++i)
+			pool.execute([&record]() { record(0); });
+		while (global_submitted.load() == 0) {
+			std::this_thread::yield();
+		}
+	});
+
+	std::future<void> global = pool.submit([&record]() { record(2); }, TaskPool::PRIORITY_HIGH);
+	global_submitted = 1;
+	outer.get();
+	global.get();
+	while (true) {
+		MutexLocker lock(&mutex);
+		if (order.size() == 22)
+			break;
+		lock.unlock();
+		std::this_thread::yield();
+	}
+
+	REQUIRE(order.size() == 22);
+	REQUIRE(std::set<int>{order[0], order[1]} == std::set<int>{1, 2});
+	for (size_t i = 2; i < order.size(); ++i) {
+		REQUIRE(order[i] == 0);
+	}
+}
+
+TEST_CASE("Task graph respects dependencies", "[task_pool]")
+{
+	TaskPool         pool(3);
+	TaskGraph        graph(&pool);
+	std::atomic<int> order(0);
+	int              a = -1, b = -1, c = -1, d = -1;
+
+	TaskGraph::TaskId ta = graph.add([&]() { a = order++; });
+	TaskGraph::TaskId tb = graph.add([&]() { b = order++; }, {ta});
+	TaskGraph::TaskId tc = graph.add([&]() { c = order++; }, {ta});
+	graph.add([&]() { d = order++; }, {tb, tc});
+	REQUIRE_THROWS_AS(graph.add([]() {}, {42}), Exception);
+
+	for (int run = 0; run < 3; ++run) {
+		order = 0;
+		graph.run();
+		REQUIRE(a == 0);
+		REQUIRE(b > a);
+		REQUIRE(c > a);
+		REQUIRE(d == 3);
+	}
+}
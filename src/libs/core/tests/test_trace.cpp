@@ -0,0 +1,104 @@
+/***************************************************************************
+ *  test_trace.cpp - TraceRecorder Unit Test
+ *
+ *  Created: Sun Oct 18 23:51:09 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#define FAWKES_TRACING
+
+#include <core/utils/trace.h>
+
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace fawkes;
+
+static std::string
+dump_to_string(double last_sec = 0.)
+{
+	char  *buf  = NULL;
+	size_t size = 0;
+	FILE  *f    = open_memstream(&buf, &size);
+	TraceRecorder::dump(f, last_sec);
+	fclose(f);
+	std::string rv(buf, size);
+	free(buf);
+	return rv;
+}
+
+static unsigned int
+count(const std::string &s, const std::string &what)
+{
+	unsigned int n = 0;
+	for (size_t p = s.find(what); p != std::string::npos; p = s.find(what, p + 1)) {
+		++n;
+	}
+	return n;
+}
+
+TEST_CASE("Events are only recorded if enabled", "[trace]")
+{
+	FAWKES_TRACE_INSTANT("test", "disabled");
+	REQUIRE(count(dump_to_string(), "\"disabled\"") == 0);
+}
+
+TEST_CASE("Record and dump events", "[trace]")
+{
+	TraceRecorder::enable(16);
+	FAWKES_TRACE_THREAD_NAME("test \"main\"");
+	{
+		FAWKES_TRACE_SCOPE("test", "scope");
+		FAWKES_TRACE_INSTANT("test", "instant");
+	}
+	std::thread t([]() {
+		FAWKES_TRACE_THREAD_NAME("other");
+		FAWKES_TRACE_BEGIN("test", "other");
+		FAWKES_TRACE_END("test", "other");
+	});
+	t.join();
+
+	std::string d = dump_to_string();
+	REQUIRE(d.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+	REQUIRE(count(d, "\"name\":\"scope\"") == 2);
+	REQUIRE(count(d, "\"name\":\"instant\"") == 1);
+	REQUIRE(count(d, "\"name\":\"other\"") == 3);
+	REQUIRE(count(d, "\"name\":\"test \\\"main\\\"\"") == 1);
+	REQUIRE(count(d, "\"ph\":\"B\"") == 2);
+
+	// ring buffer keeps only the most recent events
+	for (unsigned int i = 0; i < 100; ++i) {
+		FAWKES_TRACE_INSTANT("test", "overflow");
+	}
+	d = dump_to_string();
+	REQUIRE(count(d, "\"name\":\"overflow\"") == 16);
+	REQUIRE(count(d, "\"name\":\"scope\"") == 0);
+
+	TraceRecorder::disable();
+	FAWKES_TRACE_INSTANT("test", "after");
+	REQUIRE(count(dump_to_string(), "\"after\"") == 0);
+}
+
+TEST_CASE("Dump requests", "[trace]")
+{
+	REQUIRE_FALSE(TraceRecorder::dump_requested());
+	TraceRecorder::request_dump();
+	REQUIRE(TraceRecorder::dump_requested());
+	REQUIRE_FALSE(TraceRecorder::dump_requested());
+}
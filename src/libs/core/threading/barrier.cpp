@@ -28,7 +28,13 @@
 #include <unistd.h>
 
 // cf. http://people.redhat.com/drepper/posix-option-groups.html
-#if defined(_POSIX_BARRIERS) && (_POSIX_BARRIERS - 200112L) >= 0
+#if defined(__linux__)
+#	define USE_FUTEX_BARRIERS
+#	undef USE_POSIX_BARRIERS
+#	include <core/threading/futex.h>
+#	include <atomic>
+#	include <cstdint>
+#elif defined(_POSIX_BARRIERS) && (_POSIX_BARRIERS - 200112L) >= 0
 #	define USE_POSIX_BARRIERS
 #else
 #	undef USE_POSIX_BARRIERS
@@ -42,7 +48,18 @@ namespace fawkes {
 class BarrierData
 {
 public:
-#ifdef USE_POSIX_BARRIERS
+#if defined(USE_FUTEX_BARRIERS)
+	/** Number of attempts to see the barrier pass before sleeping. */
+	static const unsigned int SPIN_COUNT = 100;
+
+	BarrierData() : arrived(0), generation(0), num_sleepers(0)
+	{
+	}
+
+	std::atomic<uint32_t> arrived;
+	std::atomic<uint32_t> generation;
+	std::atomic<uint32_t> num_sleepers;
+#elif defined(USE_POSIX_BARRIERS)
 	pthread_barrier_t barrier;
 #else
 	BarrierData() : threads_left(0), mutex(), waitcond(&mutex)
@@ -104,6 +121,10 @@ public:
  * delay may increase on a loaded system). Because of this on systems without
  * real POSIX barriers the performance may be not as good as is expected.
  *
+ * On Linux the barrier is implemented on top of a Futex. Threads reaching
+ * the barrier spin briefly before they sleep, and the last thread only
+ * enters the kernel to wake the others if any of them actually sleeps.
+ *
  * @ingroup Threading
  * @author Tim Niemueller
  */
@@ -118,9 +139,9 @@ Barrier::Barrier(unsigned int count)
 		throw Exception("Barrier count must be at least 1");
 	}
 	barrier_data = new BarrierData();
-#ifdef USE_POSIX_BARRIERS
+#if defined(USE_POSIX_BARRIERS)
 	pthread_barrier_init(&(barrier_data->barrier), NULL, _count);
-#else
+#elif !defined(USE_FUTEX_BARRIERS)
 	barrier_data->threads_left = _count;
 #endif
 }
@@ -138,7 +159,7 @@ Barrier::Barrier()
 Barrier::~Barrier()
 {
 	if (barrier_data) {
-#ifdef USE_POSIX_BARRIERS
+#if defined(USE_POSIX_BARRIERS)
 		pthread_barrier_destroy(&(barrier_data->barrier));
 #endif
 		delete barrier_data;
@@ -152,7 +173,30 @@ Barrier::~Barrier()
 void
 Barrier::wait()
 {
-#ifdef USE_POSIX_BARRIERS
+#if defined(USE_FUTEX_BARRIERS)
+	uint32_t generation = barrier_data->generation.load(std::memory_order_acquire);
+
+	if (barrier_data->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == _count) {
+		barrier_data->arrived.store(0, std::memory_order_relaxed);
+		barrier_data->generation.fetch_add(1);
+		if (barrier_data->num_sleepers.load() > 0) {
+			Futex::wake(barrier_data->generation);
+		}
+		return;
+	}
+
+	for (unsigned int i = 0; i < BarrierData::SPIN_COUNT; ++i) {
+		if (barrier_data->generation.load(std::memory_order_acquire) != generation)
+			return;
+		Futex::cpu_relax();
+	}
+
+	barrier_data->num_sleepers.fetch_add(1);
+	while (barrier_data->generation.load() == generation) {
+		Futex::wait(barrier_data->generation, generation);
+	}
+	barrier_data->num_sleepers.fetch_sub(1, std::memory_order_acq_rel);
+#elif defined(USE_POSIX_BARRIERS)
 	pthread_barrier_wait(&(barrier_data->barrier));
 #else
 	barrier_data->mutex.lock();
@@ -0,0 +1,131 @@
+
+/***************************************************************************
+ *  futex.cpp - Futex based waiting and wake-up
+ *
+ *  Created: Mon Oct 19 01:58:06 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/futex.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#endif
+
+#include <cerrno>
+
+namespace fawkes {
+
+/** @class Futex <core/threading/futex.h>
+ * Futex based waiting and wake-up.
+ * This provides the bare primitive to build light-weight synchronization
+ * tools like Semaphore or Barrier. A thread waits as long as a 32 bit
+ * word has an expected value, and it is woken up by another thread after
+ * it changed the word. Unlike a WaitCondition, neither waking nor
+ * returning from the wait requires to acquire a mutex, and wake() does not
+ * enter the kernel if no thread is waiting.
+ *
+ * On systems other than Linux, waiting is emulated by polling the word
+ * with short sleeps.
+ * @ingroup Threading
+ * @author Tim Niemueller
+ */
+
+/** Wait while word has the expected value.
+ * The call may return spuriously, callers must check their condition in
+ * a loop.
+ * @param word word to wait on
+ * @param expected value of word while waiting is required, returns
+ * immediately if the word has a different value
+ * @param timeout relative timeout, NULL to wait without timeout
+ * @param cancellable true to make the wait a cancellation point for the
+ * calling thread, it must not hold any locks in this case
+ * @return false if the timeout expired, true otherwise
+ */
+bool
+Futex::wait(std::atomic<uint32_t> &word,
+            uint32_t               expected,
+            const struct timespec *timeout,
+            bool                   cancellable)
+{
+	int old_cancel_type;
+	if (cancellable) {
+		pthread_testcancel();
+		pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, &old_cancel_type);
+	}
+
+	bool rv = true;
+#ifdef __linux__
+	if (syscall(SYS_futex,
+	            reinterpret_cast<uint32_t *>(&word),
+	            FUTEX_WAIT_PRIVATE,
+	            expected,
+	            timeout,
+	            NULL,
+	            0)
+	      == -1
+	    && errno == ETIMEDOUT) {
+		rv = false;
+	}
+#else
+	struct timespec slept = {0, 0};
+	while (word.load() == expected) {
+		if (timeout
+		    && (slept.tv_sec > timeout->tv_sec
+		        || (slept.tv_sec == timeout->tv_sec && slept.tv_nsec >= timeout->tv_nsec))) {
+			rv = false;
+			break;
+		}
+		usleep(50);
+		slept.tv_nsec += 50000;
+		if (slept.tv_nsec >= 1000000000) {
+			slept.tv_sec += 1;
+			slept.tv_nsec -= 1000000000;
+		}
+	}
+#endif
+
+	if (cancellable) {
+		pthread_setcanceltype(old_cancel_type, NULL);
+		pthread_testcancel();
+	}
+	return rv;
+}
+
+/** Wake threads waiting on a word.
+ * @param word word the threads are waiting on
+ * @param num_waiters maximum number of threads to wake
+ */
+void
+Futex::wake(std::atomic<uint32_t> &word, int num_waiters)
+{
+#ifdef __linux__
+	syscall(SYS_futex,
+	        reinterpret_cast<uint32_t *>(&word),
+	        FUTEX_WAKE_PRIVATE,
+	        num_waiters,
+	        NULL,
+	        NULL,
+	        0);
+#endif
+}
+
+} // end namespace fawkes
@@ -0,0 +1,57 @@
+
+/***************************************************************************
+ *  futex.h - Futex based waiting and wake-up
+ *
+ *  Created: Mon Oct 19 01:58:06 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_THREADING_FUTEX_H_
+#define _CORE_THREADING_FUTEX_H_
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+namespace fawkes {
+
+class Futex
+{
+public:
+	static bool wait(std::atomic<uint32_t> &word,
+	                 uint32_t               expected,
+	                 const struct timespec *timeout     = NULL,
+	                 bool                   cancellable = false);
+	static void wake(std::atomic<uint32_t> &word, int num_waiters = INT_MAX);
+
+	/** Hint to the CPU that the calling thread is spinning. */
+	static inline void
+	cpu_relax()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__)
+		asm volatile("yield" ::: "memory");
+#endif
+	}
+};
+
+} // end namespace fawkes
+
+#endif
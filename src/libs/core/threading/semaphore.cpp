@@ -0,0 +1,131 @@
+
+/***************************************************************************
+ *  semaphore.cpp - Futex based counting semaphore
+ *
+ *  Created: Mon Oct 19 02:10:44 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/futex.h>
+#include <core/threading/semaphore.h>
+
+#include <pthread.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+static void
+semaphore_cleanup_sleeper(void *arg)
+{
+	static_cast<std::atomic<uint32_t> *>(arg)->fetch_sub(1);
+}
+/// @endcond
+
+/** @class Semaphore <core/threading/semaphore.h>
+ * Futex based counting semaphore for threads of one process.
+ * Each call to post() allows one call to wait() to pass. A waiting thread
+ * first spins for a short while, because in typical wake-up scenarios the
+ * semaphore is posted shortly after, and only then goes to sleep. Posting
+ * only enters the kernel if a thread is actually sleeping, and a woken
+ * thread does not need to acquire any lock to return from wait(), which
+ * avoids the lock hand-off of a WaitCondition.
+ * @ingroup Threading
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param value initial value
+ */
+Semaphore::Semaphore(unsigned int value) : value_(value), num_sleepers_(0)
+{
+}
+
+/** Increment the semaphore.
+ * Wakes one waiting thread, if any.
+ */
+void
+Semaphore::post()
+{
+	value_.fetch_add(1);
+	if (num_sleepers_.load() > 0) {
+		Futex::wake(value_, 1);
+	}
+}
+
+/** Increment the semaphore unless it is already positive.
+ * Multiple calls before a thread waited let only a single wait() pass.
+ */
+void
+Semaphore::post_coalesced()
+{
+	uint32_t expected = 0;
+	value_.compare_exchange_strong(expected, 1);
+	if (num_sleepers_.load() > 0) {
+		Futex::wake(value_, 1);
+	}
+}
+
+/** Try to decrement the semaphore without waiting.
+ * @return true if the semaphore has been decremented, false if it was zero
+ */
+bool
+Semaphore::try_wait()
+{
+	uint32_t v = value_.load();
+	while (v > 0) {
+		if (value_.compare_exchange_weak(v, v - 1)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Decrement the semaphore, waiting until it is positive.
+ * This is a cancellation point.
+ */
+void
+Semaphore::wait()
+{
+	for (unsigned int i = 0; i < SPIN_COUNT; ++i) {
+		if (try_wait())
+			return;
+		Futex::cpu_relax();
+	}
+
+	// The sleeper count is incremented before checking the value again,
+	// so that a concurrent post() either sees the sleeper and wakes it, or
+	// the value is seen here. The futex wait itself only sleeps while the
+	// value is still zero.
+	num_sleepers_.fetch_add(1);
+	pthread_cleanup_push(semaphore_cleanup_sleeper, &num_sleepers_);
+	while (!try_wait()) {
+		Futex::wait(value_, 0, NULL, /* cancellable */ true);
+	}
+	pthread_cleanup_pop(1);
+}
+
+/** Get current value.
+ * @return current value of the semaphore
+ */
+unsigned int
+Semaphore::value() const
+{
+	return value_.load();
+}
+
+} // end namespace fawkes
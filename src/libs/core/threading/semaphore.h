@@ -0,0 +1,54 @@
+
+/***************************************************************************
+ *  semaphore.h - Futex based counting semaphore
+ *
+ *  Created: Mon Oct 19 02:10:44 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_THREADING_SEMAPHORE_H_
+#define _CORE_THREADING_SEMAPHORE_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace fawkes {
+
+class Semaphore
+{
+public:
+	/** Number of attempts to acquire the semaphore before sleeping. */
+	static const unsigned int SPIN_COUNT = 100;
+
+	Semaphore(unsigned int value = 0);
+
+	void post();
+	void post_coalesced();
+	void wait();
+	bool try_wait();
+
+	unsigned int value() const;
+
+private:
+	std::atomic<uint32_t> value_;
+	std::atomic<uint32_t> num_sleepers_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,559 @@
+
+/***************************************************************************
+ *  task_pool.cpp - Work-stealing pool of worker threads
+ *
+ *  Created: Sun Oct 18 23:52:40 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/task_pool.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+namespace {
+
+// pool and index of the worker the calling thread is, if any
+thread_local TaskPool    *tl_pool       = nullptr;
+thread_local unsigned int tl_index      = 0;
+thread_local unsigned int tl_steal_next = 0;
+
+} // namespace
+
+struct TaskPool::LocalQueue
+{
+	Mutex            mutex;
+	std::deque<Task> tasks[NUM_PRIORITIES]; // low priority tasks are always queued globally
+};
+
+class TaskPool::Worker : public Thread
+{
+public:
+	Worker(TaskPool *pool, unsigned int index)
+	: Thread("TaskPoolWorker", Thread::OPMODE_CONTINUOUS), pool_(pool), index_(index)
+	{
+		set_name("TaskPoolWorker-%u", index);
+	}
+
+protected:
+	virtual void
+	run()
+	{
+		pool_->worker_loop(index_);
+	}
+
+private:
+	TaskPool    *pool_;
+	unsigned int index_;
+};
+
+struct TaskGraph::Node
+{
+	TaskPool::Task            task;
+	std::vector<unsigned int> dependants;
+	unsigned int              num_dependencies;
+	std::atomic<unsigned int> num_pending;
+};
+/// @endcond
+
+/** @class TaskPool <core/threading/task_pool.h>
+ * Work-stealing pool of worker threads.
+ * The pool executes short tasks on a fixed number of worker threads, so
+ * that components which want to parallelize their work share the
+ * available cores instead of each spawning their own threads. It is
+ * usually accessed through the TaskPoolAspect.
+ *
+ * Tasks submitted from outside of the pool are queued in one global queue
+ * per priority. Tasks submitted by a task running on a worker are pushed
+ * to the worker's local queue of the respective priority (except for low
+ * priority tasks), which it processes in LIFO order for cache locality.
+ * Workers take tasks strictly by priority: for each priority, first from
+ * their own local queue, then from the global queue, and then they steal
+ * the oldest tasks from other workers' local queues. A high priority task
+ * therefore never waits behind queued normal priority work.
+ *
+ * Threads waiting for tasks, e.g. in parallel_for(), wait(), or
+ * TaskGraph::run(), help executing queued tasks. Therefore, waiting from
+ * within a task does not deadlock the pool, and a thread in a main loop
+ * hook contributes its own time slice instead of idly waiting. Work
+ * required to finish a main loop hook should be run with PRIORITY_HIGH,
+ * background work with PRIORITY_LOW, so that it does not delay the main
+ * loop.
+ *
+ * Workers can be restricted to a set of CPUs, e.g. to keep them off cores
+ * isolated for time critical threads.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * Creates and starts the worker threads.
+ * @param num_threads number of worker threads
+ * @param cpus CPUs the workers may run on, empty to not restrict workers
+ * @exception OutOfBoundsException thrown if a CPU number is invalid
+ * @exception Exception thrown if setting the CPU affinity failed
+ */
+TaskPool::TaskPool(unsigned int num_threads, const std::vector<unsigned int> &cpus)
+: cpus_(cpus), num_pending_(0), num_idle_(0), num_waiting_(0), stop_(false)
+{
+	for (unsigned int cpu : cpus_) {
+		if (cpu >= CPU_SETSIZE) {
+			throw OutOfBoundsException("Invalid CPU for task pool", cpu, 0, CPU_SETSIZE - 1);
+		}
+	}
+
+	queue_mutex_   = new Mutex();
+	idle_mutex_    = new Mutex();
+	idle_cond_     = new WaitCondition(idle_mutex_);
+	finished_cond_ = new WaitCondition(idle_mutex_);
+
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		local_queues_.push_back(new LocalQueue());
+	}
+
+	int err = 0;
+	for (unsigned int i = 0; i < num_threads && err == 0; ++i) {
+		Worker *worker = new Worker(this, i);
+		worker->start();
+		workers_.push_back(worker);
+
+		if (!cpus_.empty()) {
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			for (unsigned int cpu : cpus_) {
+				CPU_SET(cpu, &cpuset);
+			}
+			err = pthread_setaffinity_np(worker->thread_id(), sizeof(cpuset), &cpuset);
+		}
+	}
+
+	if (err != 0) {
+		stop();
+		throw Exception(err, "Failed to set CPU affinity of task pool workers");
+	}
+}
+
+/** Destructor.
+ * Stops the worker threads. Tasks which have not been started are
+ * discarded.
+ */
+TaskPool::~TaskPool()
+{
+	stop();
+}
+
+void
+TaskPool::stop()
+{
+	stop_ = true;
+	idle_mutex_->lock();
+	idle_cond_->wake_all();
+	idle_mutex_->unlock();
+
+	for (Worker *worker : workers_) {
+		worker->join();
+		delete worker;
+	}
+	workers_.clear();
+	for (LocalQueue *queue : local_queues_) {
+		delete queue;
+	}
+	local_queues_.clear();
+
+	delete finished_cond_;
+	delete idle_cond_;
+	delete idle_mutex_;
+	delete queue_mutex_;
+	finished_cond_ = idle_cond_ = NULL;
+	idle_mutex_ = queue_mutex_ = NULL;
+}
+
+/** Get number of worker threads.
+ * @return number of worker threads
+ */
+unsigned int
+TaskPool::num_threads() const
+{
+	return workers_.size();
+}
+
+/** Get CPUs workers run on.
+ * @return CPUs the workers are restricted to, empty if not restricted
+ */
+const std::vector<unsigned int> &
+TaskPool::cpus() const
+{
+	return cpus_;
+}
+
+/** Execute a task.
+ * Exceptions thrown by the task are ignored, use submit() to be notified
+ * about failures.
+ * @param task task to execute
+ * @param priority task priority
+ */
+void
+TaskPool::execute(Task task, Priority priority)
+{
+	if (tl_pool == this && priority != PRIORITY_LOW) {
+		LocalQueue *queue = local_queues_[tl_index];
+		MutexLocker lock(&queue->mutex);
+		queue->tasks[priority].push_back(std::move(task));
+	} else {
+		MutexLocker lock(queue_mutex_);
+		queues_[priority].push_back(std::move(task));
+	}
+	num_pending_.fetch_add(1);
+	notify_idle();
+}
+
+/** Execute a loop in parallel.
+ * The range is split into chunks which are processed by the workers and
+ * the calling thread. The call returns after all chunks have been
+ * processed. If the body threw an exception for any chunk, the first
+ * exception is re-thrown after all chunks finished.
+ * @param begin first index of the range
+ * @param end index after the last index of the range
+ * @param body function called for each chunk
+ * @param grain_size maximum number of indices per chunk, 0 to choose a
+ * size which yields a few chunks per worker
+ * @param priority priority of chunks processed by workers
+ */
+void
+TaskPool::parallel_for(size_t               begin,
+                       size_t               end,
+                       const RangeFunction &body,
+                       size_t               grain_size,
+                       Priority             priority)
+{
+	if (end <= begin)
+		return;
+
+	size_t size = end - begin;
+	if (grain_size == 0) {
+		grain_size = std::max<size_t>(1, size / ((num_threads() + 1) * 4));
+	}
+	size_t num_chunks = (size + grain_size - 1) / grain_size;
+
+	struct State
+	{
+		std::atomic<size_t> next{0};
+		std::atomic<size_t> done{0};
+		Mutex               mutex;
+		std::exception_ptr  exception;
+	};
+	std::shared_ptr<State> state = std::make_shared<State>();
+
+	// helpers may run after all chunks are done and this call returned,
+	// they then do not access the body anymore
+	auto work = [state, &body, begin, end, grain_size, num_chunks]() {
+		size_t chunk;
+		while ((chunk = state->next.fetch_add(1)) < num_chunks) {
+			size_t chunk_begin = begin + chunk * grain_size;
+			size_t chunk_end   = std::min(chunk_begin + grain_size, end);
+			try {
+				body(chunk_begin, chunk_end);
+			} catch (...) {
+				MutexLocker lock(&state->mutex);
+				if (!state->exception)
+					state->exception = std::current_exception();
+			}
+			state->done.fetch_add(1);
+		}
+	};
+
+	size_t num_helpers = std::min<size_t>(num_chunks - 1, num_threads());
+	for (size_t i = 0; i < num_helpers; ++i) {
+		execute(work, priority);
+	}
+	work();
+	wait_until([&state, num_chunks]() { return state->done.load() == num_chunks; });
+
+	if (state->exception) {
+		std::rethrow_exception(state->exception);
+	}
+}
+
+/** Wait until a condition is fulfilled while executing other tasks.
+ * The condition is checked whenever a task finished.
+ * @param done function returning true if the condition is fulfilled
+ */
+void
+TaskPool::wait_until(const std::function<bool()> &done)
+{
+	while (!done()) {
+		if (run_one())
+			continue;
+
+		MutexLocker lock(idle_mutex_);
+		num_waiting_.fetch_add(1);
+		if (!done() && num_pending_.load() <= 0) {
+			// timeout as safety net, waiters are woken when a task finished
+			finished_cond_->reltimed_wait(0, 10000000);
+		}
+		num_waiting_.fetch_sub(1);
+	}
+}
+
+/** Execute one queued task in the calling thread.
+ * @return true if a task has been executed, false if no task was queued
+ */
+bool
+TaskPool::run_one()
+{
+	Task task;
+	if (take_task(task)) {
+		run_task(task);
+		return true;
+	}
+	return false;
+}
+
+bool
+TaskPool::take_task(Task &task)
+{
+	bool        found = false;
+	LocalQueue *own   = (tl_pool == this) ? local_queues_[tl_index] : NULL;
+
+	for (unsigned int p = 0; p < NUM_PRIORITIES && !found; ++p) {
+		if (own) {
+			MutexLocker lock(&own->mutex);
+			if (!own->tasks[p].empty()) {
+				task = std::move(own->tasks[p].back());
+				own->tasks[p].pop_back();
+				found = true;
+			}
+		}
+
+		if (!found) {
+			MutexLocker lock(queue_mutex_);
+			if (!queues_[p].empty()) {
+				task = std::move(queues_[p].front());
+				queues_[p].pop_front();
+				found = true;
+			}
+		}
+
+		const size_t num_queues = local_queues_.size();
+		for (size_t i = 0; i < num_queues && !found; ++i) {
+			LocalQueue *victim = local_queues_[(tl_steal_next + i) % num_queues];
+			if (victim == own)
+				continue;
+			MutexLocker lock(&victim->mutex);
+			if (!victim->tasks[p].empty()) {
+				task = std::move(victim->tasks[p].front());
+				victim->tasks[p].pop_front();
+				found = true;
+				// start with a different victim next time to spread stealing
+				tl_steal_next = (tl_steal_next + i + 1) % num_queues;
+			}
+		}
+	}
+
+	if (found) {
+		num_pending_.fetch_sub(1);
+	}
+	return found;
+}
+
+void
+TaskPool::run_task(Task &task)
+{
+	try {
+		task();
+	} catch (...) {
+		// ignored, submit() stores exceptions in the future
+	}
+	task = nullptr;
+	task_finished();
+}
+
+void
+TaskPool::notify_idle()
+{
+	if (num_idle_.load() > 0 || num_waiting_.load() > 0) {
+		MutexLocker lock(idle_mutex_);
+		idle_cond_->wake_one();
+		finished_cond_->wake_all();
+	}
+}
+
+void
+TaskPool::task_finished()
+{
+	if (num_waiting_.load() > 0) {
+		MutexLocker lock(idle_mutex_);
+		finished_cond_->wake_all();
+	}
+}
+
+void
+TaskPool::worker_loop(unsigned int index)
+{
+	tl_pool       = this;
+	tl_index      = index;
+	tl_steal_next = index + 1;
+
+	while (!stop_) {
+		Task task;
+		if (take_task(task)) {
+			run_task(task);
+			continue;
+		}
+
+		// the idle counter is incremented before checking for pending
+		// tasks, so that a concurrent execute() either sees the idle worker
+		// and wakes it, or the task is seen here
+		MutexLocker lock(idle_mutex_);
+		num_idle_.fetch_add(1);
+		if (!stop_ && num_pending_.load() <= 0) {
+			idle_cond_->wait();
+		}
+		num_idle_.fetch_sub(1);
+	}
+}
+
+/** @class TaskGraph <core/threading/task_pool.h>
+ * Graph of tasks with dependencies.
+ * Tasks are added with the tasks they depend on, which must have been
+ * added before. This guarantees that the graph is acyclic. When the graph
+ * is run, each task is executed on the pool once all of its dependencies
+ * have finished. A graph can be run multiple times, but not
+ * concurrently.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param pool pool to execute tasks on
+ * @param priority priority of the tasks
+ */
+TaskGraph::TaskGraph(TaskPool *pool, TaskPool::Priority priority)
+: pool_(pool), priority_(priority), num_finished_(0)
+{
+	exception_mutex_ = new Mutex();
+}
+
+/** Destructor. */
+TaskGraph::~TaskGraph()
+{
+	for (Node *node : nodes_) {
+		delete node;
+	}
+	delete exception_mutex_;
+}
+
+/** Add a task.
+ * @param task task to execute
+ * @param dependencies tasks which must have finished before this task
+ * is started
+ * @return identifier of the added task
+ * @exception OutOfBoundsException thrown if a dependency has not been
+ * added to the graph
+ */
+TaskGraph::TaskId
+TaskGraph::add(TaskPool::Task task, const std::list<TaskId> &dependencies)
+{
+	TaskId id = nodes_.size();
+	for (TaskId dep : dependencies) {
+		if (dep >= id) {
+			throw OutOfBoundsException("Unknown task graph dependency", dep, 0, id);
+		}
+	}
+
+	Node *node             = new Node();
+	node->task             = std::move(task);
+	node->num_dependencies = dependencies.size();
+	for (TaskId dep : dependencies) {
+		nodes_[dep]->dependants.push_back(id);
+	}
+	nodes_.push_back(node);
+	return id;
+}
+
+/** Run the graph and wait until all tasks finished.
+ * The calling thread helps to execute tasks. If a task throws an
+ * exception, tasks which have not been started yet are skipped and the
+ * exception is re-thrown.
+ */
+void
+TaskGraph::run()
+{
+	num_finished_ = 0;
+	exception_    = nullptr;
+	for (Node *node : nodes_) {
+		node->num_pending = node->num_dependencies;
+	}
+	for (unsigned int i = 0; i < nodes_.size(); ++i) {
+		if (nodes_[i]->num_dependencies == 0)
+			schedule(i);
+	}
+
+	const unsigned int num_nodes = nodes_.size();
+	pool_->wait_until([this, num_nodes]() { return num_finished_.load() == num_nodes; });
+
+	if (exception_) {
+		std::rethrow_exception(exception_);
+	}
+}
+
+void
+TaskGraph::schedule(unsigned int node)
+{
+	pool_->execute(
+	  [this, node]() {
+		  bool failed;
+		  exception_mutex_->lock();
+		  failed = (bool)exception_;
+		  exception_mutex_->unlock();
+
+		  if (!failed) {
+			  try {
+				  nodes_[node]->task();
+			  } catch (...) {
+				  MutexLocker lock(exception_mutex_);
+				  if (!exception_)
+					  exception_ = std::current_exception();
+			  }
+		  }
+		  finished(node);
+	  },
+	  priority_);
+}
+
+void
+TaskGraph::finished(unsigned int node)
+{
+	for (unsigned int d : nodes_[node]->dependants) {
+		if (nodes_[d]->num_pending.fetch_sub(1) == 1)
+			schedule(d);
+	}
+	// must be last, run() may return and the graph be destroyed afterwards
+	num_finished_.fetch_add(1);
+}
+
+} // end namespace fawkes
@@ -0,0 +1,170 @@
+
+/***************************************************************************
+ *  task_pool.h - Work-stealing pool of worker threads
+ *
+ *  Created: Sun Oct 18 23:52:40 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_THREADING_TASK_POOL_H_
+#define _CORE_THREADING_TASK_POOL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class WaitCondition;
+
+class TaskPool
+{
+public:
+	/** Task priority.
+	 * Workers always run the queued task of highest priority first. */
+	typedef enum {
+		PRIORITY_HIGH   = 0, ///< work a main loop hook is waiting for
+		PRIORITY_NORMAL = 1, ///< regular work
+		PRIORITY_LOW    = 2  ///< background work
+	} Priority;
+
+	/** Number of priority levels. */
+	static const unsigned int NUM_PRIORITIES = 3;
+
+	/** Task to execute. */
+	typedef std::function<void()> Task;
+
+	/** Body of a parallel for loop.
+	 * Called with the begin and end (exclusive) of a chunk of the range. */
+	typedef std::function<void(size_t, size_t)> RangeFunction;
+
+	TaskPool(unsigned int num_threads, const std::vector<unsigned int> &cpus = {});
+	~TaskPool();
+
+	unsigned int                     num_threads() const;
+	const std::vector<unsigned int> &cpus() const;
+
+	void execute(Task task, Priority priority = PRIORITY_NORMAL);
+
+	/** Submit a task and get its result as future.
+	 * Exceptions thrown by the task are stored in the future. Do not
+	 * block on the future from within a task, use wait() instead.
+	 * @param f function to execute, called without arguments
+	 * @param priority task priority
+	 * @return future for the result of @p f
+	 */
+	template <typename F>
+	std::future<typename std::invoke_result<F>::type>
+	submit(F &&f, Priority priority = PRIORITY_NORMAL)
+	{
+		typedef typename std::invoke_result<F>::type R;
+		auto           task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+		std::future<R> rv = task->get_future();
+		execute([task]() { (*task)(); }, priority);
+		return rv;
+	}
+
+	/** Wait for a future while executing other tasks.
+	 * Unlike waiting on the future directly, this is safe to call from
+	 * within a task, because the calling thread helps to execute queued
+	 * tasks until the future is ready.
+	 * @param future future to wait for
+	 */
+	template <typename T>
+	void
+	wait(const std::future<T> &future)
+	{
+		wait_until([&future]() {
+			return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		});
+	}
+
+	void parallel_for(size_t               begin,
+	                  size_t               end,
+	                  const RangeFunction &body,
+	                  size_t               grain_size = 0,
+	                  Priority             priority   = PRIORITY_HIGH);
+
+	void wait_until(const std::function<bool()> &done);
+	bool run_one();
+
+private:
+	class Worker;
+	struct LocalQueue;
+
+	bool take_task(Task &task);
+	void run_task(Task &task);
+	void notify_idle();
+	void task_finished();
+	void worker_loop(unsigned int index);
+	void stop();
+
+private:
+	std::vector<unsigned int> cpus_;
+	std::vector<Worker *>     workers_;
+	std::vector<LocalQueue *> local_queues_;
+
+	Mutex            *queue_mutex_;
+	std::deque<Task>  queues_[NUM_PRIORITIES];
+	Mutex            *idle_mutex_;
+	WaitCondition    *idle_cond_;
+	WaitCondition    *finished_cond_;
+	std::atomic<long> num_pending_;
+	std::atomic<long> num_idle_;
+	std::atomic<long> num_waiting_;
+	std::atomic<bool> stop_;
+};
+
+class TaskGraph
+{
+public:
+	/** Identifier of a task in the graph. */
+	typedef unsigned int TaskId;
+
+	TaskGraph(TaskPool *pool, TaskPool::Priority priority = TaskPool::PRIORITY_NORMAL);
+	~TaskGraph();
+
+	TaskId add(TaskPool::Task task, const std::list<TaskId> &dependencies = {});
+	void   run();
+
+private:
+	struct Node;
+	void schedule(unsigned int node);
+	void finished(unsigned int node);
+
+private:
+	TaskPool                 *pool_;
+	TaskPool::Priority        priority_;
+	std::vector<Node *>       nodes_;
+	std::atomic<unsigned int> num_finished_;
+	Mutex                    *exception_mutex_;
+	std::exception_ptr        exception_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -27,12 +27,14 @@
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <core/threading/read_write_lock.h>
+#include <core/threading/semaphore.h>
 #include <core/threading/thread.h>
 #include <core/threading/thread_finalizer.h>
 #include <core/threading/thread_loop_listener.h>
 #include <core/threading/thread_notification_listener.h>
 #include <core/threading/wait_condition.h>
 #include <core/utils/lock_list.h>
+#include <core/utils/trace.h>
 
 #if defined(__gnu_linux__) && !defined(_GNU_SOURCE)
 // to get pthread_setname_np
@@ -44,7 +46,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 namespace fawkes {
@@ -229,6 +235,9 @@ Thread::Thread(const char *name, pthread_t id)
 {
 	__constructor(name, OPMODE_CONTINUOUS);
 	thread_id_ = id;
+	if (pthread_equal(id, pthread_self())) {
+		tid_ = syscall(SYS_gettid);
+	}
 }
 
 /** Initialize.
@@ -250,22 +259,22 @@ Thread::__constructor(const char *name, OpMode op_mode)
 
 	if (op_mode_ == OPMODE_WAITFORWAKEUP) {
 		sleep_mutex_        = new Mutex();
-		sleep_condition_    = new WaitCondition(sleep_mutex_);
+		wakeup_semaphore_   = new Semaphore();
 		waiting_for_wakeup_ = true;
 	} else {
-		sleep_condition_    = NULL;
+		wakeup_semaphore_   = NULL;
 		sleep_mutex_        = NULL;
 		waiting_for_wakeup_ = false;
 	}
 
-	thread_id_       = 0;
-	flags_           = 0;
-	barrier_         = NULL;
-	started_         = false;
-	cancelled_       = false;
-	delete_on_exit_  = false;
-	prepfin_hold_    = false;
-	pending_wakeups_ = 0;
+	thread_id_      = 0;
+	tid_            = 0;
+	flags_          = 0;
+	barrier_        = NULL;
+	started_        = false;
+	cancelled_      = false;
+	delete_on_exit_ = false;
+	prepfin_hold_   = false;
 
 	loop_mutex        = new Mutex();
 	finalize_prepared = false;
@@ -286,7 +295,7 @@ Thread::~Thread()
 	loop_done_waitcond_->wake_all();
 	yield();
 
-	delete sleep_condition_;
+	delete wakeup_semaphore_;
 	delete sleep_mutex_;
 	delete loop_mutex;
 	free(name_);
@@ -524,14 +533,6 @@ Thread::start(bool wait)
 		startup_barrier_->wait();
 }
 
-void
-Thread::lock_sleep_mutex()
-{
-	if (sleep_mutex_) {
-		sleep_mutex_->lock();
-	}
-}
-
 /** Entry point for the thread.
  * This is an utility method that acts as an entry point to the thread.
  * It is called automatically when you start the thread and will call run()
@@ -547,9 +548,8 @@ Thread::entry(void *pthis)
 
 	// Set thread instance as TSD
 	set_tsd_thread_instance(t);
-
-	// lock sleep mutex, needed such that thread waits for initial wakeup
-	t->lock_sleep_mutex();
+	t->tid_ = syscall(SYS_gettid);
+	FAWKES_TRACE_THREAD_NAME(t->name());
 
 	// Notify listeners that this thread started
 	t->notify_of_startup();
@@ -687,14 +687,14 @@ Thread::set_opmode(OpMode op_mode)
 
 	if ((op_mode_ == OPMODE_WAITFORWAKEUP) && (op_mode == OPMODE_CONTINUOUS)) {
 		op_mode_ = OPMODE_CONTINUOUS;
-		delete sleep_condition_;
+		delete wakeup_semaphore_;
 		delete sleep_mutex_;
-		sleep_condition_ = NULL;
-		sleep_mutex_     = NULL;
+		wakeup_semaphore_ = NULL;
+		sleep_mutex_      = NULL;
 	} else if ((op_mode_ == OPMODE_CONTINUOUS) && (op_mode == OPMODE_WAITFORWAKEUP)) {
-		sleep_mutex_     = new Mutex();
-		sleep_condition_ = new WaitCondition(sleep_mutex_);
-		op_mode_         = OPMODE_WAITFORWAKEUP;
+		sleep_mutex_      = new Mutex();
+		wakeup_semaphore_ = new Semaphore();
+		op_mode_          = OPMODE_WAITFORWAKEUP;
 	}
 }
 
@@ -803,6 +803,32 @@ Thread::thread_id() const
 	return thread_id_;
 }
 
+/** Get kernel thread ID.
+ * This is the ID the thread is listed with in /proc and by tools like top.
+ * @return kernel thread ID, 0 if the thread has not been started, yet
+ */
+pid_t
+Thread::tid() const
+{
+	return tid_.load();
+}
+
+/** Wait for the kernel thread ID.
+ * The kernel thread ID is only known once the new thread is running,
+ * which may be after start() returned if it was not asked to wait.
+ * Call this before applying settings which refer to the kernel thread.
+ * @return kernel thread ID, 0 if the thread has not been started
+ */
+pid_t
+Thread::wait_tid() const
+{
+	pid_t tid;
+	while ((tid = tid_.load()) == 0 && started_) {
+		usleep(100);
+	}
+	return tid;
+}
+
 /** Check if thread has been started.
  * @return true if thread has been started, false otherwise
  */
@@ -919,13 +945,7 @@ Thread::run()
 {
 	if (op_mode_ == OPMODE_WAITFORWAKEUP) {
 		// Wait for initial wakeup
-		// sleep_mutex_ has been locked in entry() already!
-		while (pending_wakeups_ == 0) {
-			waiting_for_wakeup_ = true;
-			sleep_condition_->wait();
-		}
-		pending_wakeups_ -= 1;
-		sleep_mutex_->unlock();
+		wait_for_wakeup();
 	}
 
 	forever
@@ -944,7 +964,9 @@ Thread::run()
 			loop_listeners_->unlock();
 
 			loop_mutex->lock();
+			FAWKES_TRACE_BEGIN("thread", name_);
 			loop();
+			FAWKES_TRACE_END("thread", name_);
 			loop_mutex->unlock();
 
 			loop_listeners_->lock();
@@ -963,30 +985,39 @@ Thread::run()
 
 		test_cancel();
 		if (op_mode_ == OPMODE_WAITFORWAKEUP) {
-			if (barrier_) {
-				sleep_mutex_->lock();
-				Barrier *b = barrier_;
-				barrier_   = NULL;
-				sleep_mutex_->unlock();
+			sleep_mutex_->lock();
+			Barrier *b = barrier_;
+			barrier_   = NULL;
+			sleep_mutex_->unlock();
 
+			if (b)
 				b->wait();
 
-				sleep_mutex_->lock();
-			} else {
-				sleep_mutex_->lock();
-			}
-
-			while (pending_wakeups_ == 0) {
-				waiting_for_wakeup_ = true;
-				sleep_condition_->wait();
-			}
-			pending_wakeups_ -= 1;
-			sleep_mutex_->unlock();
+			wait_for_wakeup();
 		}
 		yield();
 	}
 }
 
+/** Wait for the next wakeup.
+ * Blocks on the wakeup semaphore without holding the sleep mutex, so that
+ * returning from the wait does not need to re-acquire it.
+ */
+void
+Thread::wait_for_wakeup()
+{
+	sleep_mutex_->lock();
+	bool pending = wakeup_semaphore_->try_wait();
+	if (!pending) {
+		waiting_for_wakeup_ = true;
+	}
+	sleep_mutex_->unlock();
+
+	if (!pending) {
+		wakeup_semaphore_->wait();
+	}
+}
+
 /** Wake up thread.
  * If the thread is being used in wait for wakeup mode this will wake up the
  * waiting thread.
@@ -1004,14 +1035,10 @@ Thread::wakeup()
 		}
 
 		if (coalesce_wakeups_)
-			pending_wakeups_ = 1;
+			wakeup_semaphore_->post_coalesced();
 		else
-			pending_wakeups_ += 1;
-		if (waiting_for_wakeup_) {
-			// currently waiting
-			waiting_for_wakeup_ = false;
-			sleep_condition_->wake_all();
-		}
+			wakeup_semaphore_->post();
+		waiting_for_wakeup_ = false;
 	}
 }
 
@@ -1038,13 +1065,9 @@ Thread::wakeup(Barrier *barrier)
 		                barrier_);
 	}
 
-	pending_wakeups_ += 1;
 	barrier_ = barrier;
-	if (waiting_for_wakeup_) {
-		// currently waiting
-		waiting_for_wakeup_ = false;
-		sleep_condition_->wake_all();
-	}
+	wakeup_semaphore_->post();
+	waiting_for_wakeup_ = false;
 }
 
 /** Wait for the current loop iteration to finish. */
@@ -1105,8 +1128,7 @@ Thread::set_delete_on_exit(bool del)
 bool
 Thread::wakeup_pending()
 {
-	MutexLocker lock(sleep_mutex_);
-	return (pending_wakeups_ > 0);
+	return (wakeup_semaphore_->value() > 0);
 }
 
 /** Set flag for the thread.
@@ -1154,6 +1176,147 @@ Thread::flagged_bad() const
 	return flags_ & FLAG_BAD;
 }
 
+/** Set CPU affinity.
+ * Restricts the thread to run on the given CPUs only.
+ * @param cpus CPUs the thread may run on, empty to allow all CPUs
+ * @exception Exception thrown if the thread has not been started or the
+ * affinity could not be set, e.g. because a CPU does not exist
+ */
+void
+Thread::set_cpu_affinity(const std::vector<unsigned int> &cpus)
+{
+	if (!started_) {
+		throw Exception("Cannot set CPU affinity of thread %s, not started", name_);
+	}
+
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	if (cpus.empty()) {
+		long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+		for (long i = 0; i < num_cpus && i < CPU_SETSIZE; ++i) {
+			CPU_SET(i, &cpuset);
+		}
+	} else {
+		for (unsigned int cpu : cpus) {
+			if (cpu >= CPU_SETSIZE) {
+				throw OutOfBoundsException("Invalid CPU", cpu, 0, CPU_SETSIZE - 1);
+			}
+			CPU_SET(cpu, &cpuset);
+		}
+	}
+
+	int err = pthread_setaffinity_np(thread_id_, sizeof(cpuset), &cpuset);
+	if (err != 0) {
+		throw Exception(err, "Failed to set CPU affinity of thread %s", name_);
+	}
+}
+
+/** Get CPU affinity.
+ * @return CPUs the thread may run on, empty if it could not be determined
+ */
+std::vector<unsigned int>
+Thread::cpu_affinity() const
+{
+	std::vector<unsigned int> rv;
+	cpu_set_t                 cpuset;
+	CPU_ZERO(&cpuset);
+	if (thread_id_ != 0 && pthread_getaffinity_np(thread_id_, sizeof(cpuset), &cpuset) == 0) {
+		for (unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+			if (CPU_ISSET(cpu, &cpuset)) {
+				rv.push_back(cpu);
+			}
+		}
+	}
+	return rv;
+}
+
+/** Set real-time priority.
+ * With a priority larger than zero the thread is scheduled with the
+ * SCHED_FIFO policy, i.e. it preempts all threads of lower priority and
+ * all regularly scheduled threads. This usually requires the CAP_SYS_NICE
+ * capability or a sufficient RLIMIT_RTPRIO.
+ * @param priority real-time priority in the range 1 to 99, 0 to use the
+ * regular scheduling policy
+ * @exception Exception thrown if the thread has not been started or the
+ * priority could not be set
+ */
+void
+Thread::set_realtime_priority(unsigned int priority)
+{
+	if (!started_) {
+		throw Exception("Cannot set priority of thread %s, not started", name_);
+	}
+
+	int policy = (priority > 0) ? SCHED_FIFO : SCHED_OTHER;
+	if (priority > (unsigned int)sched_get_priority_max(policy)) {
+		throw OutOfBoundsException("Invalid real-time priority",
+		                           priority,
+		                           sched_get_priority_min(policy),
+		                           sched_get_priority_max(policy));
+	}
+
+	struct sched_param param;
+	param.sched_priority = priority;
+	int err              = pthread_setschedparam(thread_id_, policy, &param);
+	if (err != 0) {
+		throw Exception(err, "Failed to set real-time priority of thread %s", name_);
+	}
+}
+
+/** Get real-time priority.
+ * @return real-time priority if the thread is scheduled with a real-time
+ * policy, 0 otherwise
+ */
+unsigned int
+Thread::realtime_priority() const
+{
+	int                policy;
+	struct sched_param param;
+	if (thread_id_ == 0 || pthread_getschedparam(thread_id_, &policy, &param) != 0) {
+		return 0;
+	}
+	return (policy == SCHED_FIFO || policy == SCHED_RR) ? param.sched_priority : 0;
+}
+
+/** Get scheduling statistics.
+ * The statistics are read from /proc. The number of migrations is only
+ * available if the kernel has been built with CONFIG_SCHED_DEBUG.
+ * @return scheduling statistics, counters which are not available are zero
+ */
+Thread::SchedulingStatistics
+Thread::scheduling_statistics() const
+{
+	SchedulingStatistics rv  = {0, 0, 0};
+	pid_t                tid = tid_.load();
+	if (tid == 0)
+		return rv;
+
+	std::string   task_dir = "/proc/self/task/" + std::to_string(tid);
+	std::ifstream status(task_dir + "/status");
+	std::string   line;
+	while (std::getline(status, line)) {
+		std::istringstream iss(line);
+		std::string        key;
+		iss >> key;
+		if (key == "voluntary_ctxt_switches:") {
+			iss >> rv.voluntary_context_switches;
+		} else if (key == "nonvoluntary_ctxt_switches:") {
+			iss >> rv.involuntary_context_switches;
+		}
+	}
+
+	std::ifstream sched(task_dir + "/sched");
+	while (std::getline(sched, line)) {
+		std::istringstream iss(line);
+		std::string        key, colon;
+		iss >> key;
+		if (key == "se.nr_migrations") {
+			iss >> colon >> rv.migrations;
+		}
+	}
+	return rv;
+}
+
 /** Add notification listener.
  * Add a notification listener for this thread.
  * @param notification_listener notification listener to add
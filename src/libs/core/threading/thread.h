@@ -26,8 +26,10 @@
 
 #include <sys/types.h>
 
+#include <atomic>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #define forever while (1)
 
@@ -36,6 +38,7 @@ namespace fawkes {
 class WaitCondition;
 class Mutex;
 class Barrier;
+class Semaphore;
 class ThreadNotificationListener;
 class ThreadLoopListener;
 class ThreadList;
@@ -66,6 +69,14 @@ public:
 		CANCEL_DISABLED /**< thread cannot be cancelled */
 	} CancelState;
 
+	/** Scheduling statistics of a thread as counted by the kernel. */
+	typedef struct
+	{
+		uint64_t voluntary_context_switches;   /**< switches because the thread blocked */
+		uint64_t involuntary_context_switches; /**< switches because the thread was preempted */
+		uint64_t migrations;                   /**< migrations to another CPU */
+	} SchedulingStatistics;
+
 	static const unsigned int FLAG_BAD;
 
 	virtual ~Thread();
@@ -91,6 +102,8 @@ public:
 
 	OpMode    opmode() const;
 	pthread_t thread_id() const;
+	pid_t     tid() const;
+	pid_t     wait_tid() const;
 	bool      started() const;
 	bool      cancelled() const;
 	bool      detached() const;
@@ -107,6 +120,12 @@ public:
 	void unset_flag(uint32_t flag);
 	bool flagged_bad() const;
 
+	void                      set_cpu_affinity(const std::vector<unsigned int> &cpus);
+	std::vector<unsigned int> cpu_affinity() const;
+	void                      set_realtime_priority(unsigned int priority);
+	unsigned int              realtime_priority() const;
+	SchedulingStatistics      scheduling_statistics() const;
+
 	static Thread     *current_thread();
 	static Thread     *current_thread_noexc() noexcept;
 	static pthread_t   current_thread_id();
@@ -159,17 +178,17 @@ private:
 	static void *entry(void *pthis);
 	void         __constructor(const char *name, OpMode op_mode);
 	void         notify_of_startup();
-	void         lock_sleep_mutex();
+	void         wait_for_wakeup();
 
 	static void init_thread_key();
 	static void set_tsd_thread_instance(Thread *t);
 
-	pthread_t thread_id_;
+	pthread_t          thread_id_;
+	std::atomic<pid_t> tid_;
 
 	Barrier       *startup_barrier_;
 	mutable Mutex *sleep_mutex_;
-	WaitCondition *sleep_condition_;
-	unsigned int   pending_wakeups_;
+	Semaphore     *wakeup_semaphore_;
 	Barrier       *barrier_;
 
 	bool           loop_done_;
@@ -79,4 +79,22 @@ ThreadInitializer::~ThreadInitializer()
 {
 }
 
+/** Determine initialization dependencies of a thread.
+ * Initializers can report what a thread requires to be initialized and
+ * what it provides to other threads once initialized. This is used to
+ * order the initialization of threads which are initialized concurrently.
+ * The default implementation reports no dependencies.
+ * @param thread thread to get dependencies for
+ * @param required upon return contains the names of what must have been
+ * provided by other threads before the thread can be initialized
+ * @param provided upon return contains the names of what the thread
+ * provides once it has been initialized
+ */
+void
+ThreadInitializer::init_dependencies(Thread                 *thread,
+                                     std::list<std::string> &required,
+                                     std::list<std::string> &provided)
+{
+}
+
 } // end namespace fawkes
@@ -26,6 +26,9 @@
 
 #include <core/exception.h>
 
+#include <list>
+#include <string>
+
 namespace fawkes {
 
 class Thread;
@@ -44,6 +47,10 @@ public:
 	virtual ~ThreadInitializer();
 
 	virtual void init(Thread *thread) = 0;
+
+	virtual void init_dependencies(Thread                 *thread,
+	                               std::list<std::string> &required,
+	                               std::list<std::string> &provided);
 };
 
 } // end namespace fawkes
@@ -22,7 +22,6 @@
  */
 
 #include <core/exceptions/software.h>
-#include <core/threading/mutex.h>
 #include <core/utils/refcount.h>
 
 #include <unistd.h>
@@ -46,16 +45,32 @@ namespace fawkes {
  */
 
 /** Constructor. */
-RefCount::RefCount()
+RefCount::RefCount() : refc(1)
+{
+}
+
+/** Copy constructor.
+ * The copy is a new instance, its reference count is 1.
+ * @param other instance to copy
+ */
+RefCount::RefCount(const RefCount &other) : refc(1)
 {
-	ref_mutex = new Mutex();
-	refc      = 1;
 }
 
 /** Destructor. */
 RefCount::~RefCount()
 {
-	delete ref_mutex;
+}
+
+/** Assignment operator.
+ * The reference count of this instance is not changed.
+ * @param other instance to assign
+ * @return reference to this instance
+ */
+RefCount &
+RefCount::operator=(const RefCount &other)
+{
+	return *this;
 }
 
 /** Increment reference count.
@@ -66,12 +81,12 @@ RefCount::~RefCount()
 void
 RefCount::ref()
 {
-	ref_mutex->lock();
-	if (refc == 0) {
-		throw DestructionInProgressException("Tried to reference that is currently being deleted");
-	}
-	++refc;
-	ref_mutex->unlock();
+	unsigned int r = refc.load(std::memory_order_relaxed);
+	do {
+		if (r == 0) {
+			throw DestructionInProgressException("Tried to reference that is currently being deleted");
+		}
+	} while (!refc.compare_exchange_weak(r, r + 1, std::memory_order_relaxed));
 }
 
 /** Decrement reference count and conditionally delete this instance.
@@ -94,18 +109,16 @@ RefCount::ref()
 void
 RefCount::unref()
 {
-	ref_mutex->lock();
-	if (refc == 0) {
-		throw DestructionInProgressException("Tried to reference that is currently being deleted");
-	}
-	if (refc > 0)
-		--refc;
-	if (refc == 0) {
+	unsigned int r = refc.load(std::memory_order_relaxed);
+	do {
+		if (r == 0) {
+			throw DestructionInProgressException("Tried to reference that is currently being deleted");
+		}
+	} while (!refc.compare_exchange_weak(r, r - 1, std::memory_order_acq_rel));
+	if (r == 1) {
 		// commit suicide
 		delete this;
-		return;
 	}
-	ref_mutex->unlock();
 }
 
 /** Get reference count for this instance.
@@ -119,7 +132,7 @@ RefCount::unref()
 unsigned int
 RefCount::refcount()
 {
-	return refc;
+	return refc.load(std::memory_order_relaxed);
 }
 
 } // end namespace fawkes
@@ -24,23 +24,25 @@
 #ifndef _CORE_UTILS_REFCOUNT_H_
 #define _CORE_UTILS_REFCOUNT_H_
 
-namespace fawkes {
+#include <atomic>
 
-class Mutex;
+namespace fawkes {
 
 class RefCount
 {
 public:
 	RefCount();
+	RefCount(const RefCount &other);
 	virtual ~RefCount();
 
+	RefCount &operator=(const RefCount &other);
+
 	void         ref();
 	void         unref();
 	unsigned int refcount();
 
 private:
-	unsigned int refc;
-	Mutex       *ref_mutex;
+	std::atomic<unsigned int> refc;
 };
 
 } // end namespace fawkes
@@ -0,0 +1,349 @@
+
+/***************************************************************************
+ *  trace.cpp - Timeline trace recorder
+ *
+ *  Created: Sun Oct 18 23:24:18 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/utils/trace.h>
+#include <sys/syscall.h>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <ctime>
+#include <list>
+#include <unistd.h>
+#include <vector>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+namespace {
+
+struct TraceEvent
+{
+	uint64_t    ts_usec;
+	const char *category;
+	char        phase;
+	char        name[TraceRecorder::MAX_NAME_LENGTH + 1];
+};
+
+// The ring buffer has one more slot than the configured size, because
+// the oldest slot may be overwritten while dumping.
+struct TraceBuffer
+{
+	TraceBuffer(unsigned int size) : events(size + 1), head(0), in_use(true), tid(0)
+	{
+		name[0] = 0;
+	}
+
+	std::vector<TraceEvent> events;
+	std::atomic<uint64_t>   head;
+	std::atomic<bool>       in_use;
+	long                    tid;
+	char                    name[TraceRecorder::MAX_NAME_LENGTH + 1];
+};
+
+struct TraceBufferHolder
+{
+	~TraceBufferHolder()
+	{
+		if (buffer)
+			buffer->in_use.store(false, std::memory_order_release);
+	}
+
+	TraceBuffer *buffer = nullptr;
+	char         name[TraceRecorder::MAX_NAME_LENGTH + 1] = {0};
+};
+
+// Buffers are never freed but re-used for new threads once their thread
+// exited. This keeps recording free of locks after the first event of a
+// thread and allows to dump events of threads which exited recently.
+struct TraceRegistry
+{
+	Mutex                    mutex;
+	std::list<TraceBuffer *> buffers;
+	unsigned int             buffer_size = 4096;
+};
+
+TraceRegistry &
+registry()
+{
+	// intentionally leaked, thread-local holders may access buffers at exit
+	static TraceRegistry *registry = new TraceRegistry();
+	return *registry;
+}
+
+thread_local TraceBufferHolder tl_holder;
+
+TraceBuffer *
+thread_buffer()
+{
+	if (tl_holder.buffer)
+		return tl_holder.buffer;
+
+	TraceRegistry &r = registry();
+	MutexLocker    lock(&r.mutex);
+	TraceBuffer   *buffer = nullptr;
+	for (TraceBuffer *b : r.buffers) {
+		if (!b->in_use.load(std::memory_order_acquire) && b->events.size() == r.buffer_size + 1) {
+			buffer = b;
+			buffer->head.store(0, std::memory_order_relaxed);
+			buffer->in_use.store(true, std::memory_order_relaxed);
+			break;
+		}
+	}
+	if (!buffer) {
+		buffer = new TraceBuffer(r.buffer_size);
+		r.buffers.push_back(buffer);
+	}
+	buffer->tid = syscall(SYS_gettid);
+	strncpy(buffer->name, tl_holder.name, TraceRecorder::MAX_NAME_LENGTH);
+	buffer->name[TraceRecorder::MAX_NAME_LENGTH] = 0;
+	tl_holder.buffer                             = buffer;
+	return buffer;
+}
+
+void
+write_json_string(FILE *f, const char *s)
+{
+	fputc('"', f);
+	for (; *s; ++s) {
+		unsigned char c = *s;
+		if (c == '"' || c == '\\') {
+			fputc('\\', f);
+			fputc(c, f);
+		} else if (c < 0x20) {
+			fprintf(f, "\\u%04x", c);
+		} else {
+			fputc(c, f);
+		}
+	}
+	fputc('"', f);
+}
+
+} // namespace
+/// @endcond
+
+/** @class TraceRecorder <core/utils/trace.h>
+ * Recorder for timeline traces.
+ * The recorder keeps the most recent events of each thread in a ring
+ * buffer per thread. Recording an event does not take any lock (except
+ * once when a thread records its first event) and does not allocate
+ * memory. The recorded events can be dumped in the Chrome trace event
+ * JSON format, which can be viewed in chrome://tracing or the Perfetto
+ * UI, e.g. to find out which thread in which hook caused a main loop
+ * overrun.
+ *
+ * Code is instrumented with the FAWKES_TRACE_SCOPE(), FAWKES_TRACE_BEGIN(),
+ * FAWKES_TRACE_END() and FAWKES_TRACE_INSTANT() macros. They compile to
+ * nothing unless FAWKES_TRACING is defined, e.g. by building with
+ * TRACING=1. If compiled in, events are only recorded after enable() has
+ * been called.
+ *
+ * Dumps are usually triggered in the main thread, which checks
+ * dump_requested(), for example after a SIGUSR2 was received.
+ * @author Tim Niemueller
+ */
+
+std::atomic<bool> TraceRecorder::enabled_(false);
+std::atomic<bool> TraceRecorder::dump_requested_(false);
+
+/** Enable recording.
+ * @param buffer_size number of events kept per thread, applies to
+ * buffers of threads recording their first event after the call
+ */
+void
+TraceRecorder::enable(unsigned int buffer_size)
+{
+	TraceRegistry &r = registry();
+	MutexLocker    lock(&r.mutex);
+	r.buffer_size = buffer_size > 0 ? buffer_size : 1;
+	enabled_.store(true, std::memory_order_relaxed);
+}
+
+/** Disable recording.
+ * Recorded events are kept and can still be dumped.
+ */
+void
+TraceRecorder::disable()
+{
+	enabled_.store(false, std::memory_order_relaxed);
+}
+
+/** Check if recording is enabled.
+ * @return true if recording is enabled
+ */
+bool
+TraceRecorder::enabled()
+{
+	return enabled_.load(std::memory_order_relaxed);
+}
+
+/** Set name of calling thread.
+ * The name is shown for the thread's events in the trace viewer.
+ * @param name name of the thread
+ */
+void
+TraceRecorder::set_thread_name(const char *name)
+{
+	strncpy(tl_holder.name, name, MAX_NAME_LENGTH);
+	tl_holder.name[MAX_NAME_LENGTH] = 0;
+	if (tl_holder.buffer) {
+		strncpy(tl_holder.buffer->name, tl_holder.name, MAX_NAME_LENGTH + 1);
+	}
+}
+
+/** Request a dump.
+ * This only sets a flag and is safe to call from a signal handler. The
+ * actual dump must be done by the code that checks dump_requested().
+ */
+void
+TraceRecorder::request_dump()
+{
+	dump_requested_.store(true, std::memory_order_relaxed);
+}
+
+/** Check and clear dump request.
+ * @return true if a dump has been requested since the last call
+ */
+bool
+TraceRecorder::dump_requested()
+{
+	return dump_requested_.exchange(false, std::memory_order_relaxed);
+}
+
+/** Get current monotonic time.
+ * @return current monotonic time in microseconds as used for timestamps
+ * of events
+ */
+uint64_t
+TraceRecorder::now_usec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+void
+TraceRecorder::record_event(const char *category, const char *name, Phase phase)
+{
+	TraceBuffer *b = thread_buffer();
+	uint64_t     h = b->head.load(std::memory_order_relaxed);
+	TraceEvent  &e = b->events[h % b->events.size()];
+
+	e.ts_usec  = now_usec();
+	e.category = category;
+	e.phase    = phase;
+	strncpy(e.name, name ? name : "", MAX_NAME_LENGTH);
+	e.name[MAX_NAME_LENGTH] = 0;
+	b->head.store(h + 1, std::memory_order_release);
+}
+
+/** Dump recorded events.
+ * Writes the events in the Chrome trace event JSON format. Events which
+ * are overwritten while dumping are omitted.
+ * @param f file to write to
+ * @param last_sec only dump events of the given number of most recent
+ * seconds, 0 to dump all recorded events
+ */
+void
+TraceRecorder::dump(FILE *f, double last_sec)
+{
+	uint64_t now   = now_usec();
+	uint64_t since = 0;
+	if (last_sec > 0. && last_sec * 1000000. < now) {
+		since = now - (uint64_t)(last_sec * 1000000.);
+	}
+	int pid = getpid();
+
+	TraceRegistry &r = registry();
+	MutexLocker    lock(&r.mutex);
+
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	bool first = true;
+	for (TraceBuffer *b : r.buffers) {
+		uint64_t                size  = b->events.size();
+		uint64_t                head  = b->head.load(std::memory_order_acquire);
+		std::vector<TraceEvent> copy  = b->events;
+		uint64_t                head2 = b->head.load(std::memory_order_acquire);
+		uint64_t                start = head > size ? head - size : 0;
+		if (head2 >= size && start <= head2 - size) {
+			// the event at head2 - size may have been written while copying
+			start = head2 - size + 1;
+		}
+		if (start >= head)
+			continue;
+
+		fprintf(f,
+		        "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%ld,\"args\":{\"name\":",
+		        first ? "" : ",",
+		        pid,
+		        b->tid);
+		write_json_string(f, b->name[0] ? b->name : "unnamed");
+		fprintf(f, "}}");
+		first = false;
+
+		for (uint64_t i = start; i < head; ++i) {
+			const TraceEvent &e = copy[i % size];
+			if (e.ts_usec < since)
+				continue;
+			fprintf(f, ",\n{\"ph\":\"%c\",\"cat\":", e.phase);
+			write_json_string(f, e.category ? e.category : "");
+			fprintf(f, ",\"name\":");
+			write_json_string(f, e.name);
+			fprintf(f, ",\"ts\":%" PRIu64 ",\"pid\":%d,\"tid\":%ld", e.ts_usec, pid, b->tid);
+			if (e.phase == PHASE_INSTANT) {
+				fprintf(f, ",\"s\":\"t\"");
+			}
+			fprintf(f, "}");
+		}
+	}
+	fprintf(f, "\n]}\n");
+}
+
+/** Dump recorded events to file.
+ * @param filename name of file to write to
+ * @param last_sec only dump events of the given number of most recent
+ * seconds, 0 to dump all recorded events
+ * @exception CouldNotOpenFileException thrown if the file cannot be opened
+ */
+void
+TraceRecorder::dump(const char *filename, double last_sec)
+{
+	FILE *f = fopen(filename, "w");
+	if (!f) {
+		throw CouldNotOpenFileException(filename, errno, "Cannot write trace");
+	}
+	dump(f, last_sec);
+	fclose(f);
+}
+
+/** @class TraceScope <core/utils/trace.h>
+ * Record the duration of a scope.
+ * Records a begin event on construction and an end event on destruction.
+ * Usually used through the FAWKES_TRACE_SCOPE() macro.
+ * @author Tim Niemueller
+ */
+
+} // end namespace fawkes
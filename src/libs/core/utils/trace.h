@@ -0,0 +1,149 @@
+
+/***************************************************************************
+ *  trace.h - Timeline trace recorder
+ *
+ *  Created: Sun Oct 18 23:24:18 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_UTILS_TRACE_H_
+#define _CORE_UTILS_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+namespace fawkes {
+
+class TraceRecorder
+{
+public:
+	/** Maximum length of an event name, longer names are truncated. */
+	static const unsigned int MAX_NAME_LENGTH = 63;
+
+	/** Trace event phase, values correspond to the Chrome trace format. */
+	typedef enum {
+		PHASE_BEGIN   = 'B', ///< begin of a duration
+		PHASE_END     = 'E', ///< end of a duration
+		PHASE_INSTANT = 'i'  ///< instant event
+	} Phase;
+
+	/** Record an event of the calling thread.
+	 * This is a no-op unless tracing has been enabled.
+	 * @param category category of the event, must be a string literal
+	 * @param name name of the event, copied
+	 * @param phase event phase
+	 */
+	static inline void
+	record(const char *category, const char *name, Phase phase)
+	{
+		if (enabled_.load(std::memory_order_relaxed)) {
+			record_event(category, name, phase);
+		}
+	}
+
+	static void enable(unsigned int buffer_size = 4096);
+	static void disable();
+	static bool enabled();
+
+	static void set_thread_name(const char *name);
+
+	static void request_dump();
+	static bool dump_requested();
+
+	static void dump(FILE *f, double last_sec = 0.);
+	static void dump(const char *filename, double last_sec = 0.);
+
+	static uint64_t now_usec();
+
+private:
+	static void record_event(const char *category, const char *name, Phase phase);
+
+private:
+	static std::atomic<bool> enabled_;
+	static std::atomic<bool> dump_requested_;
+};
+
+class TraceScope
+{
+public:
+	/** Constructor, records the begin event.
+	 * @param category category of the event, must be a string literal
+	 * @param name name of the event
+	 */
+	TraceScope(const char *category, const char *name) : category_(category), name_(name)
+	{
+		TraceRecorder::record(category_, name_, TraceRecorder::PHASE_BEGIN);
+	}
+
+	/** Destructor, records the end event. */
+	~TraceScope()
+	{
+		TraceRecorder::record(category_, name_, TraceRecorder::PHASE_END);
+	}
+
+private:
+	const char *category_;
+	const char *name_;
+};
+
+} // end namespace fawkes
+
+/// @cond INTERNALS
+#define FAWKES_TRACE_CONCAT_(a, b) a##b
+#define FAWKES_TRACE_CONCAT(a, b) FAWKES_TRACE_CONCAT_(a, b)
+/// @endcond
+
+#ifdef FAWKES_TRACING
+/** Record duration of the enclosing scope.
+ * @param category category of the event, must be a string literal
+ * @param name name of the event, must remain valid until the end of scope
+ */
+#	define FAWKES_TRACE_SCOPE(category, name) \
+		fawkes::TraceScope FAWKES_TRACE_CONCAT(fawkes_trace_scope_, __LINE__)(category, name)
+/** Record begin of a duration.
+ * @param category category of the event, must be a string literal
+ * @param name name of the event
+ */
+#	define FAWKES_TRACE_BEGIN(category, name) \
+		fawkes::TraceRecorder::record(category, name, fawkes::TraceRecorder::PHASE_BEGIN)
+/** Record end of a duration.
+ * @param category category of the event, must be a string literal
+ * @param name name of the event
+ */
+#	define FAWKES_TRACE_END(category, name) \
+		fawkes::TraceRecorder::record(category, name, fawkes::TraceRecorder::PHASE_END)
+/** Record an instant event.
+ * @param category category of the event, must be a string literal
+ * @param name name of the event
+ */
+#	define FAWKES_TRACE_INSTANT(category, name) \
+		fawkes::TraceRecorder::record(category, name, fawkes::TraceRecorder::PHASE_INSTANT)
+/** Set name of the calling thread shown in traces.
+ * @param name name of the thread
+ */
+#	define FAWKES_TRACE_THREAD_NAME(name) fawkes::TraceRecorder::set_thread_name(name)
+#else
+#	define FAWKES_TRACE_SCOPE(category, name)
+#	define FAWKES_TRACE_BEGIN(category, name)
+#	define FAWKES_TRACE_END(category, name)
+#	define FAWKES_TRACE_INSTANT(category, name)
+#	define FAWKES_TRACE_THREAD_NAME(name)
+#endif
+
+#endif
@@ -33,6 +33,7 @@
 #include <fvutils/system/camargp.h>
 #include <fvutils/system/filetype.h>
 #include <fvutils/writers/fvraw.h>
+#include <utils/time/time.h>
 #ifdef HAVE_LIBJPEG
 #	include <fvutils/readers/jpeg.h>
 #endif
@@ -55,6 +56,11 @@ namespace firevision {
  * The file loader tries to determine the image format of the given image using
  * the the file type utility. Currently it recognizes JPEG and FvRaw image files.
  *
+ * FvRaw image sequences, for example written by AsyncSeqWriter, are played
+ * back image by image. Use set_image_number() to seek in a sequence or a
+ * directory. If the sequence has an index, capture_time() provides the
+ * time the current image was originally captured.
+ *
  * @author Tim Niemueller
  * @author Daniel Beck
  */
@@ -97,6 +103,9 @@ FileLoader::FileLoader(const char *filename)
 	width = height = 0;
 	file_buffer    = NULL;
 	this->cspace   = CS_UNKNOWN;
+
+	seq_reader       = NULL;
+	seq_capture_time = NULL;
 }
 
 /** Constructor.
@@ -127,6 +136,9 @@ FileLoader::FileLoader(const CameraArgumentParser *cap)
 	this->cspace   = CS_UNKNOWN;
 	opened = started = false;
 
+	seq_reader       = NULL;
+	seq_capture_time = NULL;
+
 	if (cap->has("file")) {
 		this->filename = strdup(cap->get("file").c_str());
 		if (cap->has("width")) {
@@ -174,6 +186,8 @@ FileLoader::FileLoader(colorspace_t cspace,
 	num_files        = 0;
 	cur_file         = 0;
 	file_buffer      = NULL;
+	seq_reader       = NULL;
+	seq_capture_time = NULL;
 }
 
 /** Destructor. */
@@ -186,6 +200,8 @@ FileLoader::~FileLoader()
 	free(dirname);
 	free(extension);
 	free(filename);
+	delete seq_reader;
+	delete seq_capture_time;
 }
 
 void
@@ -202,7 +218,10 @@ FileLoader::open()
 		}
 	}
 
-	read_file();
+	open_sequence();
+	if (!seq_reader) {
+		read_file();
+	}
 	opened = true;
 }
 
@@ -233,7 +252,12 @@ FileLoader::print_info()
 void
 FileLoader::capture()
 {
-	if (0 != num_files) {
+	if (seq_reader) {
+		if (seq_reader->current_frame() >= seq_reader->num_frames()) {
+			seq_reader->seek(0);
+		}
+		seq_reader->read();
+	} else if (0 != num_files) {
 		if (file_buffer) {
 			free(file_buffer);
 		}
@@ -265,7 +289,9 @@ FileLoader::close()
 		free(file_buffer);
 		file_buffer = NULL;
 	}
-	opened = false;
+	delete seq_reader;
+	seq_reader = NULL;
+	opened     = false;
 }
 
 void
@@ -284,9 +310,49 @@ FileLoader::ready()
 	return started;
 }
 
+/** Set image number to retrieve.
+ * For an image sequence this seeks to the given image, when reading a
+ * directory it selects the n-th file in alphabetical order.
+ * @param n image number, starting at 0
+ */
 void
 FileLoader::set_image_number(unsigned int n)
 {
+	if (seq_reader) {
+		seq_reader->seek(n);
+	} else if (num_files > 0) {
+		if (n >= (unsigned int)num_files) {
+			throw OutOfBoundsException("Image number", n, 0, num_files - 1);
+		}
+		cur_file = n;
+	}
+}
+
+/** Get number of images.
+ * @return number of images in the sequence or directory, 1 for a single image
+ */
+unsigned int
+FileLoader::num_images()
+{
+	if (seq_reader) {
+		return seq_reader->num_frames();
+	} else if (dirname) {
+		return num_files;
+	} else {
+		return 1;
+	}
+}
+
+fawkes::Time *
+FileLoader::capture_time()
+{
+	FvRawWriter::FvRawFrameInfo info;
+	if (seq_reader && (seq_reader->current_frame() > 0)
+	    && seq_reader->frame_info(seq_reader->current_frame() - 1, info)) {
+		seq_capture_time->set_time(info.capture_sec, info.capture_usec);
+		return seq_capture_time;
+	}
+	return Camera::capture_time();
 }
 
 unsigned int
@@ -334,6 +400,45 @@ FileLoader::set_pixel_height(unsigned int h)
 	height = h;
 }
 
+/** Open FvRaw image sequence.
+ * Keeps the file open if it contains more than one image and prepares to
+ * read the first image on the next capture.
+ */
+void
+FileLoader::open_sequence()
+{
+	if (!filename || (fv_filetype_file(filename) != "FvRaw")) {
+		return;
+	}
+
+	FvRawReader *reader = new FvRawReader(filename);
+	if (reader->num_frames() <= 1) {
+		delete reader;
+		return;
+	}
+
+	cspace       = reader->colorspace();
+	width        = reader->pixel_width();
+	height       = reader->pixel_height();
+	_buffer_size = colorspace_buffer_size(cspace, width, height);
+	file_buffer  = (unsigned char *)malloc(_buffer_size);
+	reader->set_buffer(file_buffer);
+	try {
+		// make the first image available right away, as for single files
+		reader->read();
+		reader->seek(0);
+	} catch (Exception &e) {
+		delete reader;
+		e.append("FileLoader::open() failed for sequence");
+		throw;
+	}
+
+	seq_reader = reader;
+	if (!seq_capture_time) {
+		seq_capture_time = new fawkes::Time(0, 0);
+	}
+}
+
 void
 FileLoader::read_file()
 {
@@ -30,9 +30,14 @@
 
 #include <dirent.h>
 
+namespace fawkes {
+class Time;
+}
+
 namespace firevision {
 
 class CameraArgumentParser;
+class FvRawReader;
 
 class FileLoader : public Camera
 {
@@ -69,7 +74,10 @@ public:
 	virtual unsigned int pixel_height();
 	virtual colorspace_t colorspace();
 
-	virtual void set_image_number(unsigned int n);
+	virtual void          set_image_number(unsigned int n);
+	virtual fawkes::Time *capture_time();
+
+	unsigned int num_images();
 
 	void set_colorspace(colorspace_t c);
 	void set_pixel_width(unsigned int w);
@@ -77,6 +85,7 @@ public:
 
 private:
 	void read_file();
+	void open_sequence();
 
 	bool            started;
 	bool            opened;
@@ -91,6 +100,8 @@ private:
 	int             num_files;
 	int             cur_file;
 	struct dirent **file_list;
+	FvRawReader    *seq_reader;
+	fawkes::Time   *seq_capture_time;
 };
 
 } // end namespace firevision
@@ -23,11 +23,15 @@
 
 #include <core/exception.h>
 #include <core/exceptions/software.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
 #include <fvcams/cam_exceptions.h>
 #include <fvcams/net.h>
 #include <fvutils/compression/jpeg_decompressor.h>
 #include <fvutils/net/fuse_client.h>
 #include <fvutils/net/fuse_image_content.h>
+#include <fvutils/net/fuse_image_delta.h>
 #include <fvutils/net/fuse_imagelist_content.h>
 #include <fvutils/net/fuse_message.h>
 #include <fvutils/system/camargp.h>
@@ -76,6 +80,7 @@ NetworkCamera::NetworkCamera(const char *host, unsigned short port, bool jpeg)
 	fuse_image_          = NULL;
 	fuse_message_        = NULL;
 	fuse_imageinfo_      = NULL;
+	init_stream();
 
 	fusec_ = new FuseClient(host_, port_, this);
 	if (get_jpeg_) {
@@ -114,6 +119,7 @@ NetworkCamera::NetworkCamera(const char *host, unsigned short port, const char *
 	fuse_image_          = NULL;
 	fuse_message_        = NULL;
 	fuse_imageinfo_      = NULL;
+	init_stream();
 
 	fusec_ = new FuseClient(host_, port_, this);
 	if (get_jpeg_) {
@@ -128,6 +134,10 @@ NetworkCamera::NetworkCamera(const char *host, unsigned short port, const char *
  * - image=ID, image ID of image to retrieve
  * - jpeg=<true|false>, if true JPEGs are recieved and decompressed otherwise
  *   raw images will be transferred (raw is the default)
+ * - stream=MSEC, subscribe to the image and have the server push images at
+ *   most every MSEC milliseconds instead of requesting each image
+ * - delta=<true|false>, if true the server may send difference frames for
+ *   streamed raw images (false is the default)
  * @param cap camera argument parser
  */
 NetworkCamera::NetworkCamera(const CameraArgumentParser *cap)
@@ -153,6 +163,15 @@ NetworkCamera::NetworkCamera(const CameraArgumentParser *cap)
 	}
 
 	get_jpeg_ = (cap->has("jpeg") && (cap->get("jpeg") == "true"));
+	init_stream();
+	if (cap->has("stream")) {
+		int i = atoi(cap->get("stream").c_str());
+		if (i <= 0) {
+			throw IllegalArgumentException("Stream period must be positive");
+		}
+		stream_period_ms_ = i;
+	}
+	stream_delta_ = (cap->has("delta") && (cap->get("delta") == "true"));
 
 	connected_           = false;
 	opened_              = false;
@@ -182,6 +201,24 @@ NetworkCamera::~NetworkCamera()
 	if (decompressed_buffer_ != NULL)
 		free(decompressed_buffer_);
 	delete decompressor_;
+	delete stream_waitcond_;
+	delete stream_mutex_;
+}
+
+/** Initialize streaming state.
+ * Called from all constructors before the FUSE client is created.
+ */
+void
+NetworkCamera::init_stream()
+{
+	stream_period_ms_         = 0;
+	stream_delta_             = false;
+	subscribed_               = false;
+	subscribe_failed_         = false;
+	stream_new_frame_         = false;
+	stream_mutex_             = new Mutex();
+	stream_waitcond_          = new WaitCondition(stream_mutex_);
+	decompressed_buffer_size_ = 0;
 }
 
 void
@@ -203,11 +240,74 @@ NetworkCamera::open()
 		if (!fuse_imageinfo_) {
 			throw Exception("Could not receive image info. Image not available?");
 		}
+
+		if (stream_period_ms_ > 0) {
+			send_subscribe();
+		}
 	}
 
 	opened_ = true;
 }
 
+/** Subscribe to image stream.
+ * Instead of requesting every single image the server is asked to push
+ * images of the configured image ID. Images are then transferred without
+ * waiting for a round trip per image and capture() returns the newest
+ * image that has been received. If called before open() the subscription
+ * is made when the camera is opened.
+ * @param period_ms minimum time between two images in milliseconds, 0 to
+ * cancel an existing subscription
+ * @param delta true to allow the server to send difference frames, only
+ * used if raw images are transferred
+ */
+void
+NetworkCamera::subscribe(unsigned int period_ms, bool delta)
+{
+	stream_mutex_->lock();
+	stream_period_ms_ = period_ms;
+	stream_delta_     = delta;
+	stream_mutex_->unlock();
+
+	if (!opened_ || !image_id_)
+		return;
+
+	if (period_ms > 0) {
+		send_subscribe();
+	} else if (subscribed_) {
+		FUSE_imagedesc_message_t *imagedesc =
+		  (FUSE_imagedesc_message_t *)calloc(1, sizeof(FUSE_imagedesc_message_t));
+		strncpy(imagedesc->image_id, image_id_, IMAGE_ID_MAX_LENGTH - 1);
+		fusec_->enqueue(FUSE_MT_UNSUBSCRIBE, imagedesc, sizeof(FUSE_imagedesc_message_t));
+		stream_mutex_->lock();
+		subscribed_       = false;
+		stream_new_frame_ = false;
+		stream_buffer_.clear();
+		stream_mutex_->unlock();
+	}
+}
+
+/** Send subscription request and wait for reply. */
+void
+NetworkCamera::send_subscribe()
+{
+	FUSE_imagesubscribe_message_t *sm =
+	  (FUSE_imagesubscribe_message_t *)calloc(1, sizeof(FUSE_imagesubscribe_message_t));
+	strncpy(sm->image_id, image_id_, IMAGE_ID_MAX_LENGTH - 1);
+	sm->format            = (get_jpeg_ ? FUSE_IF_JPEG : FUSE_IF_RAW);
+	sm->keyframe_interval = 0; // use server default
+	stream_mutex_->lock();
+	sm->flags     = stream_delta_ ? FUSE_ISF_DELTA : 0;
+	sm->period_ms = htonl(stream_period_ms_);
+	stream_mutex_->unlock();
+
+	subscribe_failed_ = false;
+	fusec_->enqueue_and_wait(FUSE_MT_SUBSCRIBE, sm, sizeof(FUSE_imagesubscribe_message_t));
+
+	if (subscribe_failed_ || !subscribed_) {
+		throw Exception("Subscribing to image %s failed", image_id_);
+	}
+}
+
 void
 NetworkCamera::start()
 {
@@ -238,6 +338,28 @@ NetworkCamera::capture()
 		throw CaptureException("You must specify an image id");
 	}
 
+	if (subscribed_) {
+		MutexLocker lock(stream_mutex_);
+		while (!stream_new_frame_ && connected_) {
+			stream_waitcond_->wait();
+		}
+		if (!connected_) {
+			throw CaptureException("Capture failed, connection died while waiting for image");
+		}
+		if (get_jpeg_) {
+			alloc_decompressed_buffer(
+			  colorspace_buffer_size(YUV422_PLANAR, pixel_width(), pixel_height()));
+			decompressor_->set_compressed_buffer(&stream_buffer_[0], stream_buffer_.size());
+			decompressor_->decompress();
+		} else {
+			alloc_decompressed_buffer(stream_buffer_.size());
+			memcpy(decompressed_buffer_, &stream_buffer_[0], stream_buffer_.size());
+		}
+		capture_time_     = stream_capture_time_;
+		stream_new_frame_ = false;
+		return;
+	}
+
 	FUSE_imagereq_message_t *irm = (FUSE_imagereq_message_t *)malloc(sizeof(FUSE_imagereq_message_t));
 	memset(irm, 0, sizeof(FUSE_imagereq_message_t));
 	strncpy(irm->image_id, image_id_, IMAGE_ID_MAX_LENGTH - 1);
@@ -252,26 +374,68 @@ NetworkCamera::capture()
 	}
 
 	if (get_jpeg_) {
-		if ((fuse_image_->pixel_width() != last_width_)
-		    || (fuse_image_->pixel_height() != last_height_)) {
-			if (decompressed_buffer_ != NULL) {
-				free(decompressed_buffer_);
-			}
-			size_t buffer_size   = colorspace_buffer_size(YUV422_PLANAR,
-                                                  fuse_image_->pixel_width(),
-                                                  fuse_image_->pixel_height());
-			decompressed_buffer_ = (unsigned char *)malloc(buffer_size);
-			decompressor_->set_decompressed_buffer(decompressed_buffer_, buffer_size);
-		}
+		alloc_decompressed_buffer(colorspace_buffer_size(YUV422_PLANAR,
+		                                                 fuse_image_->pixel_width(),
+		                                                 fuse_image_->pixel_height()));
 		decompressor_->set_compressed_buffer(fuse_image_->buffer(), fuse_image_->buffer_size());
 		decompressor_->decompress();
 	}
 }
 
+/** Make sure the decompressed buffer has the given size.
+ * @param size required size in bytes
+ */
+void
+NetworkCamera::alloc_decompressed_buffer(size_t size)
+{
+	if (decompressed_buffer_size_ != size) {
+		if (decompressed_buffer_ != NULL) {
+			free(decompressed_buffer_);
+		}
+		decompressed_buffer_      = (unsigned char *)malloc(size);
+		decompressed_buffer_size_ = size;
+		if (decompressor_) {
+			decompressor_->set_decompressed_buffer(decompressed_buffer_, size);
+		}
+	}
+}
+
+/** Store streamed image.
+ * Called from the FUSE client thread for every image received for a
+ * subscription. Difference frames are applied to the last image, so no
+ * frame may be skipped here even if capture() is called at a lower rate.
+ * @param ic received image content
+ */
+void
+NetworkCamera::stream_image_received(FuseImageContent *ic)
+{
+	MutexLocker lock(stream_mutex_);
+	if (ic->format() == FUSE_IF_DELTA) {
+		size_t size = colorspace_buffer_size((colorspace_t)ic->colorspace(),
+		                                     ic->pixel_width(),
+		                                     ic->pixel_height());
+		if (stream_buffer_.size() != size) {
+			// no matching base image, wait for next full frame
+			return;
+		}
+		try {
+			FuseImageDelta::apply(&stream_buffer_[0], size, ic->buffer(), ic->buffer_size());
+		} catch (Exception &e) {
+			stream_buffer_.clear();
+			return;
+		}
+	} else {
+		stream_buffer_.assign(ic->buffer(), ic->buffer() + ic->buffer_size());
+	}
+	stream_capture_time_ = *ic->capture_time();
+	stream_new_frame_    = true;
+	stream_waitcond_->wake_all();
+}
+
 unsigned char *
 NetworkCamera::buffer()
 {
-	if (get_jpeg_) {
+	if (get_jpeg_ || subscribed_) {
 		return decompressed_buffer_;
 	} else {
 		if (fuse_image_) {
@@ -287,6 +451,8 @@ NetworkCamera::buffer_size()
 {
 	if (get_jpeg_) {
 		return colorspace_buffer_size(YUV422_PLANAR, pixel_width(), pixel_height());
+	} else if (subscribed_) {
+		return decompressed_buffer_size_;
 	} else {
 		if (!fuse_image_) {
 			return 0;
@@ -309,6 +475,7 @@ NetworkCamera::close()
 		free(fuse_imageinfo_);
 		fuse_imageinfo_ = NULL;
 	}
+	subscribed_ = false;
 	if (opened_) {
 		fusec_->disconnect();
 		fusec_->cancel();
@@ -351,7 +518,9 @@ NetworkCamera::pixel_height()
 fawkes::Time *
 NetworkCamera::capture_time()
 {
-	if (fuse_image_) {
+	if (subscribed_) {
+		return &capture_time_;
+	} else if (fuse_image_) {
 		return fuse_image_->capture_time();
 	} else {
 		throw NullPointerException("No valid image exists");
@@ -443,7 +612,10 @@ NetworkCamera::fuse_connection_established() noexcept
 void
 NetworkCamera::fuse_connection_died() noexcept
 {
+	stream_mutex_->lock();
 	connected_ = false;
+	stream_waitcond_->wake_all();
+	stream_mutex_->unlock();
 }
 
 void
@@ -451,6 +623,15 @@ NetworkCamera::fuse_inbound_received(FuseNetworkMessage *m) noexcept
 {
 	switch (m->type()) {
 	case FUSE_MT_IMAGE:
+		if (subscribed_) {
+			try {
+				FuseImageContent *ic = m->msgc<FuseImageContent>();
+				stream_image_received(ic);
+				delete ic;
+			} catch (Exception &e) {
+			}
+			break;
+		}
 		try {
 			fuse_image_ = m->msgc<FuseImageContent>();
 			if (fuse_image_) {
@@ -479,6 +660,16 @@ NetworkCamera::fuse_inbound_received(FuseNetworkMessage *m) noexcept
 		fuse_image_   = NULL;
 		break;
 
+	case FUSE_MT_SUBSCRIBED: {
+		FUSE_imagesubscribe_message_t *sm = m->msg<FUSE_imagesubscribe_message_t>();
+		MutexLocker                    lock(stream_mutex_);
+		stream_period_ms_ = ntohl(sm->period_ms);
+		stream_delta_     = (sm->flags & FUSE_ISF_DELTA);
+		subscribed_       = true;
+	} break;
+
+	case FUSE_MT_SUBSCRIBE_FAILED: subscribe_failed_ = true; break;
+
 	case FUSE_MT_IMAGE_LIST:
 		try {
 			FuseImageListContent *fuse_image_list = m->msgc<FuseImageListContent>();
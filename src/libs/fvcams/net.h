@@ -26,9 +26,16 @@
 
 #include <fvcams/camera.h>
 #include <fvutils/net/fuse_client_handler.h>
+#include <utils/time/time.h>
 
+#include <atomic>
 #include <vector>
 
+namespace fawkes {
+class Mutex;
+class WaitCondition;
+} // namespace fawkes
+
 namespace firevision {
 
 class CameraArgumentParser;
@@ -66,6 +73,8 @@ public:
 	virtual void set_image_id(const char *image_id);
 	virtual void set_image_number(unsigned int n);
 
+	void subscribe(unsigned int period_ms, bool delta = false);
+
 	virtual fawkes::Time *capture_time();
 
 	virtual std::vector<FUSE_imageinfo_t> &image_list();
@@ -77,6 +86,11 @@ public:
 	virtual void fuse_inbound_received(FuseNetworkMessage *m) noexcept;
 
 private:
+	void init_stream();
+	void send_subscribe();
+	void stream_image_received(FuseImageContent *ic);
+	void alloc_decompressed_buffer(size_t size);
+
 	bool started_;
 	bool opened_;
 
@@ -101,6 +115,18 @@ private:
 	FUSE_imageinfo_t *fuse_imageinfo_;
 
 	std::vector<FUSE_imageinfo_t> image_list_;
+
+	unsigned int               stream_period_ms_;
+	bool                       stream_delta_;
+	std::atomic<bool>          subscribed_;
+	std::atomic<bool>          subscribe_failed_;
+	bool                       stream_new_frame_;
+	fawkes::Mutex             *stream_mutex_;
+	fawkes::WaitCondition     *stream_waitcond_;
+	std::vector<unsigned char> stream_buffer_;
+	fawkes::Time               stream_capture_time_;
+	fawkes::Time               capture_time_;
+	size_t                     decompressed_buffer_size_;
 };
 
 } // end namespace firevision
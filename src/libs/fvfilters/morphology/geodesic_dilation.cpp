@@ -107,6 +107,7 @@ FilterGeodesicDilation::apply()
 
 	diff->setBufferA(tmp, src_roi[MARKER]->image_width, src_roi[MARKER]->image_height);
 	diff->setBufferB(dst, dst_roi->image_width, dst_roi->image_height);
+	diff->setROI(src_roi[MARKER]);
 
 	dilate->set_src_buffer(tmp, src_roi[MARKER]);
 
@@ -103,6 +103,7 @@ FilterGeodesicErosion::apply()
 
 	diff->setBufferA(tmp, src_roi[MARKER]->image_width, src_roi[MARKER]->image_height);
 	diff->setBufferB(dst, dst_roi->image_width, dst_roi->image_height);
+	diff->setROI(src_roi[MARKER]);
 
 	erode->set_src_buffer(tmp, src_roi[MARKER]);
 
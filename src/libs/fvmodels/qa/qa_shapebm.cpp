@@ -0,0 +1,153 @@
+
+/***************************************************************************
+ *  qa_shapebm.cpp - QA for benchmarking shape models
+ *
+ *  Created: Sun Oct 18 18:47:10 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <fvcams/fileloader.h>
+#include <fvmodels/shape/ht_lines.h>
+#include <fvmodels/shape/rcd_circle.h>
+#include <fvmodels/shape/rht_circle.h>
+#include <fvmodels/shape/rht_lines.h>
+#include <fvutils/base/roi.h>
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/system/camargp.h>
+#include <utils/system/argparser.h>
+#include <utils/time/tracker.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace fawkes;
+using namespace firevision;
+
+void
+print_usage(const char *program_name)
+{
+	printf("Usage: %s [-n cycles] [-s seed] [-t threads] <camera arguments>\n"
+	       " -n cycles   number of images to process, default 100\n"
+	       " -s seed     seed for randomized models\n"
+	       " -t threads  number of voting threads for the Hough line model\n"
+	       "Images are read with the file loader, for example\n"
+	       "  %s file:file=edges.raw\n"
+	       "  %s file:dir=recording:ext=jpg\n"
+	       "Edge pixels are those with a luminance larger than 230.\n",
+	       program_name,
+	       program_name,
+	       program_name);
+}
+
+int
+main(int argc, char **argv)
+{
+	ArgumentParser argp(argc, argv, "hn:s:t:");
+
+	if (argp.has_arg("h") || (argp.num_items() != 1)) {
+		print_usage(argv[0]);
+		exit(argp.has_arg("h") ? 0 : 1);
+	}
+
+	unsigned int num_cycles = argp.has_arg("n") ? argp.parse_int("n") : 100;
+
+	CameraArgumentParser cap(argp.items()[0]);
+	FileLoader           loader(&cap);
+	loader.open();
+	loader.start();
+
+	RhtCircleModel rht_circle;
+	RcdCircleModel rcd_circle;
+	RhtLinesModel  rht_lines;
+	HtLinesModel   ht_lines;
+
+	if (argp.has_arg("s")) {
+		unsigned int seed = argp.parse_int("s");
+		rht_circle.set_random_seed(seed);
+		rcd_circle.set_random_seed(seed);
+		rht_lines.set_random_seed(seed);
+	}
+	if (argp.has_arg("t")) {
+		ht_lines.set_num_threads(argp.parse_int("t"));
+	}
+
+	TimeTracker  tt;
+	unsigned int ttc_rht_circle = tt.add_class("RhtCircleModel");
+	unsigned int ttc_rcd_circle = tt.add_class("RcdCircleModel");
+	unsigned int ttc_rht_lines  = tt.add_class("RhtLinesModel");
+	unsigned int ttc_ht_lines   = tt.add_class("HtLinesModel");
+
+	unsigned char *buffer = NULL;
+	unsigned int   width = 0, height = 0;
+	unsigned int   num_shapes[4] = {0, 0, 0, 0};
+
+	for (unsigned int i = 0; i < num_cycles; ++i) {
+		loader.capture();
+
+		if (!buffer || (width != loader.pixel_width()) || (height != loader.pixel_height())) {
+			free(buffer);
+			width  = loader.pixel_width();
+			height = loader.pixel_height();
+			buffer = malloc_buffer(YUV422_PLANAR, width, height);
+		}
+		convert(loader.colorspace(), YUV422_PLANAR, loader.buffer(), buffer, width, height);
+		loader.dispose_buffer();
+
+		ROI roi(0, 0, width, height, width, height);
+
+		tt.ping_start(ttc_rht_circle);
+		rht_circle.parseImage(buffer, &roi);
+		tt.ping_end(ttc_rht_circle);
+		num_shapes[0] += rht_circle.getShapeCount();
+
+		tt.ping_start(ttc_rcd_circle);
+		rcd_circle.parseImage(buffer, &roi);
+		tt.ping_end(ttc_rcd_circle);
+		num_shapes[1] += rcd_circle.getShapeCount();
+
+		tt.ping_start(ttc_rht_lines);
+		rht_lines.parseImage(buffer, &roi);
+		tt.ping_end(ttc_rht_lines);
+		num_shapes[2] += rht_lines.getShapeCount();
+
+		tt.ping_start(ttc_ht_lines);
+		ht_lines.parseImage(buffer, &roi);
+		tt.ping_end(ttc_ht_lines);
+		num_shapes[3] += ht_lines.getShapeCount();
+	}
+
+	tt.print_to_stdout();
+	printf("Shapes found in %u images: RHT circles %u, RCD circles %u, "
+	       "RHT lines %u, HT lines %u\n",
+	       num_cycles,
+	       num_shapes[0],
+	       num_shapes[1],
+	       num_shapes[2],
+	       num_shapes[3]);
+
+	loader.stop();
+	loader.close();
+	free(buffer);
+
+	return 0;
+}
+
+/// @endcond
@@ -0,0 +1,327 @@
+
+/***************************************************************************
+ *  ht_flat_accum.cpp - Flat array accumulator for Hough transforms
+ *
+ *  Created: Sun Oct 18 18:03:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <fvmodels/shape/accumulators/ht_flat_accum.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace firevision {
+
+/** @class HtFlatAccumulator <fvmodels/shape/accumulators/ht_flat_accum.h>
+ * Flat array accumulator for Hough transforms.
+ * Drop-in replacement for RhtAccumulator for bounded parameter spaces.
+ * Instead of allocating a tree node per distinct vote, all cells are kept
+ * in a single array with the r parameter varying fastest, followed by x
+ * and then y. Votes with a fixed y and r therefore hit a single contiguous
+ * row, which allows for cache friendly voting with accumulate_row().
+ *
+ * The accumulator remembers which cells have been voted for as long as
+ * these are few, so that resetting it after sparse randomized voting does
+ * not need to clear the whole array. Votes outside of the bounds are
+ * counted, but otherwise ignored.
+ *
+ * The accumulator is not thread-safe. For parallel voting use one
+ * accumulator per thread and merge() them afterwards.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * The accumulator has empty bounds until set_bounds() is called.
+ */
+HtFlatAccumulator::HtFlatAccumulator()
+{
+	x_min_            = 0;
+	y_min_            = 0;
+	r_min_            = 0;
+	x_size_           = 0;
+	y_size_           = 0;
+	r_size_           = 0;
+	size_             = 0;
+	touched_overflow_ = false;
+	max_              = 0;
+	x_max_            = 0;
+	y_max_            = 0;
+	r_max_            = 0;
+	num_votes_        = 0;
+}
+
+/** Destructor. */
+HtFlatAccumulator::~HtFlatAccumulator()
+{
+}
+
+/** Set parameter space bounds.
+ * This resets the accumulator. Memory is only re-allocated if the new
+ * parameter space is larger than any before.
+ * @param x_min minimum x value
+ * @param x_max maximum x value, inclusive
+ * @param y_min minimum y value
+ * @param y_max maximum y value, inclusive
+ * @param r_min minimum r value
+ * @param r_max maximum r value, inclusive
+ */
+void
+HtFlatAccumulator::set_bounds(int x_min, int x_max, int y_min, int y_max, int r_min, int r_max)
+{
+	if ((x_max < x_min) || (y_max < y_min) || (r_max < r_min)) {
+		throw fawkes::Exception("Invalid accumulator bounds");
+	}
+
+	reset();
+
+	x_min_  = x_min;
+	y_min_  = y_min;
+	r_min_  = r_min;
+	x_size_ = x_max - x_min + 1;
+	y_size_ = y_max - y_min + 1;
+	r_size_ = r_max - r_min + 1;
+	size_   = x_size_ * y_size_ * r_size_;
+
+	if (counts_.size() < size_) {
+		counts_.resize(size_, 0);
+	}
+}
+
+/** Reset all votes. */
+void
+HtFlatAccumulator::reset()
+{
+	if (touched_overflow_) {
+		std::fill(counts_.begin(), counts_.begin() + size_, 0);
+	} else {
+		for (unsigned int i : touched_) {
+			counts_[i] = 0;
+		}
+	}
+	touched_.clear();
+	touched_overflow_ = false;
+
+	max_       = 0;
+	num_votes_ = 0;
+}
+
+/** Remember cell that received its first vote.
+ * @param index index of cell
+ */
+void
+HtFlatAccumulator::touch(unsigned int index)
+{
+	if (!touched_overflow_) {
+		// once a considerable part of all cells is in use, clearing the
+		// full array is faster than clearing individual cells
+		if (touched_.size() < std::max(1024u, size_ / 8)) {
+			touched_.push_back(index);
+		} else {
+			touched_overflow_ = true;
+		}
+	}
+}
+
+/** Get parameters of cell.
+ * @param index index of cell
+ * @param x upon return contains x value of cell
+ * @param y upon return contains y value of cell
+ * @param r upon return contains r value of cell
+ */
+void
+HtFlatAccumulator::get_coords(unsigned int index, int &x, int &y, int &r) const
+{
+	r = r_min_ + (int)(index % r_size_);
+	index /= r_size_;
+	x = x_min_ + (int)(index % x_size_);
+	y = y_min_ + (int)(index / x_size_);
+}
+
+/** Accumulate new candidate.
+ * @param x x
+ * @param y y
+ * @param r r
+ * @return number of votes for this cell, 0 if out of bounds
+ */
+int
+HtFlatAccumulator::accumulate(int x, int y, int r)
+{
+	++num_votes_;
+
+	unsigned int xi = x - x_min_, yi = y - y_min_, ri = r - r_min_;
+	if ((xi >= x_size_) || (yi >= y_size_) || (ri >= r_size_)) {
+		return 0;
+	}
+
+	unsigned int index = (yi * x_size_ + xi) * r_size_ + ri;
+	unsigned int count = ++counts_[index];
+	if (count == 1) {
+		touch(index);
+	}
+	if (count > max_) {
+		max_   = count;
+		x_max_ = x;
+		y_max_ = y;
+		r_max_ = r;
+	}
+	return count;
+}
+
+/** Accumulate a row of candidates.
+ * Votes for all given x values with the same y and r. All of these votes
+ * end up in the same contiguous row of the accumulator.
+ * @param x array of x values
+ * @param num_x number of elements in x
+ * @param y y
+ * @param r r
+ */
+void
+HtFlatAccumulator::accumulate_row(const int *x, unsigned int num_x, int y, int r)
+{
+	num_votes_ += num_x;
+
+	unsigned int yi = y - y_min_, ri = r - r_min_;
+	if ((yi >= y_size_) || (ri >= r_size_)) {
+		return;
+	}
+
+	const unsigned int row_start = yi * x_size_ * r_size_ + ri;
+	for (unsigned int i = 0; i < num_x; ++i) {
+		unsigned int xi = x[i] - x_min_;
+		if (xi >= x_size_)
+			continue;
+
+		unsigned int index = row_start + xi * r_size_;
+		unsigned int count = ++counts_[index];
+		if (count == 1) {
+			touch(index);
+		}
+		if (count > max_) {
+			max_   = count;
+			x_max_ = x[i];
+			y_max_ = y;
+			r_max_ = r;
+		}
+	}
+}
+
+/** Merge votes of another accumulator.
+ * Both accumulators must have the same bounds.
+ * @param other accumulator to add votes from
+ */
+void
+HtFlatAccumulator::merge(const HtFlatAccumulator &other)
+{
+	if ((other.x_min_ != x_min_) || (other.y_min_ != y_min_) || (other.r_min_ != r_min_)
+	    || (other.x_size_ != x_size_) || (other.y_size_ != y_size_) || (other.r_size_ != r_size_)) {
+		throw fawkes::Exception("Cannot merge accumulators with different bounds");
+	}
+
+	num_votes_ += other.num_votes_;
+
+	const unsigned int num = other.touched_overflow_ ? size_ : other.touched_.size();
+	for (unsigned int i = 0; i < num; ++i) {
+		unsigned int index = other.touched_overflow_ ? i : other.touched_[i];
+		unsigned int votes = other.counts_[index];
+		if (votes == 0)
+			continue;
+
+		unsigned int count = (counts_[index] += votes);
+		if (count == votes) {
+			touch(index);
+		}
+		if (count > max_) {
+			max_ = count;
+			get_coords(index, x_max_, y_max_, r_max_);
+		}
+	}
+}
+
+/** Get maximum.
+ * @param x x return value
+ * @param y y return value
+ * @param r r return value
+ * @return max
+ */
+int
+HtFlatAccumulator::getMax(int &x, int &y, int &r) const
+{
+	x = x_max_;
+	y = y_max_;
+	r = r_max_;
+	return max_;
+}
+
+/** Get number of votes.
+ * @return number of votes, including votes out of bounds
+ */
+unsigned int
+HtFlatAccumulator::getNumVotes() const
+{
+	return num_votes_;
+}
+
+/** Get nodes.
+ * @param min_votes min votes
+ * @return nodes, each consisting of x, y, r and number of votes, ordered
+ * by y, x, and r. The caller takes ownership of the returned vector.
+ */
+vector<vector<int>> *
+HtFlatAccumulator::getNodes(int min_votes)
+{
+	vector<vector<int>> *rv = new vector<vector<int>>();
+
+	if ((min_votes > 0) && ((unsigned int)min_votes > num_votes_)) {
+		return rv;
+	}
+	const unsigned int min_count = std::max(min_votes, 1);
+
+	if (!touched_overflow_) {
+		std::sort(touched_.begin(), touched_.end());
+	}
+	const unsigned int num = touched_overflow_ ? size_ : touched_.size();
+	for (unsigned int i = 0; i < num; ++i) {
+		unsigned int index = touched_overflow_ ? i : touched_[i];
+		if (counts_[index] >= min_count) {
+			vector<int> node(4);
+			get_coords(index, node[0], node[1], node[2]);
+			node[3] = counts_[index];
+			rv->push_back(node);
+		}
+	}
+
+	return rv;
+}
+
+/** Dump.
+ * @param s stream
+ */
+void
+HtFlatAccumulator::dump(std::ostream &s)
+{
+	vector<vector<int>> *nodes = getNodes(1);
+	for (const vector<int> &n : *nodes) {
+		s << "(" << n[0] << "," << n[1] << "," << n[2] << ") with vote " << n[3] << endl;
+	}
+	delete nodes;
+}
+
+} // end namespace firevision
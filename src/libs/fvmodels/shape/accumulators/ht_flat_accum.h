@@ -0,0 +1,76 @@
+
+/***************************************************************************
+ *  ht_flat_accum.h - Flat array accumulator for Hough transforms
+ *
+ *  Created: Sun Oct 18 18:03:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_MODELS_SHAPE_ACCUMULATORS_HT_FLAT_ACCUM_H_
+#define _FIREVISION_MODELS_SHAPE_ACCUMULATORS_HT_FLAT_ACCUM_H_
+
+#include <ostream>
+#include <vector>
+
+namespace firevision {
+
+class HtFlatAccumulator
+{
+public:
+	HtFlatAccumulator();
+	~HtFlatAccumulator();
+
+	void set_bounds(int x_min, int x_max, int y_min, int y_max, int r_min = 0, int r_max = 0);
+	void reset();
+	void merge(const HtFlatAccumulator &other);
+
+	int  accumulate(int x, int y, int r);
+	void accumulate_row(const int *x, unsigned int num_x, int y, int r = 0);
+
+	int                            getMax(int &x, int &y, int &r) const;
+	unsigned int                   getNumVotes() const;
+	std::vector<std::vector<int>> *getNodes(int min_votes);
+	void                           dump(std::ostream &s);
+
+private:
+	void touch(unsigned int index);
+	void get_coords(unsigned int index, int &x, int &y, int &r) const;
+
+private:
+	int          x_min_;
+	int          y_min_;
+	int          r_min_;
+	unsigned int x_size_;
+	unsigned int y_size_;
+	unsigned int r_size_;
+	unsigned int size_;
+
+	std::vector<unsigned int> counts_;
+	std::vector<unsigned int> touched_;
+	bool                      touched_overflow_;
+
+	unsigned int max_;
+	int          x_max_;
+	int          y_max_;
+	int          r_max_;
+	unsigned int num_votes_;
+};
+
+} // end namespace firevision
+
+#endif
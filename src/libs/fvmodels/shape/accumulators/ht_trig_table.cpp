@@ -0,0 +1,135 @@
+
+/***************************************************************************
+ *  ht_trig_table.cpp - Sine and cosine table for Hough transforms
+ *
+ *  Created: Sun Oct 18 18:03:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvmodels/shape/accumulators/ht_trig_table.h>
+#include <utils/math/angle.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace firevision {
+
+/** @class HtTrigTable <fvmodels/shape/accumulators/ht_trig_table.h>
+ * Sine and cosine table for Hough transforms.
+ * Line Hough transforms evaluate r = x cos(phi) + y sin(phi) for the same
+ * set of candidate angles for every edge pixel. This table computes sine,
+ * cosine, and the angle rounded to full degrees once for all candidates.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * The table is empty until set_angles() is called.
+ */
+HtTrigTable::HtTrigTable()
+{
+	min_degrees_ = 0;
+	max_degrees_ = 0;
+}
+
+/** Destructor. */
+HtTrigTable::~HtTrigTable()
+{
+}
+
+/** Compute table for candidate angles.
+ * @param angle_from first candidate angle in rad
+ * @param angle_increment increment between candidate angles in rad
+ * @param num_angles number of candidate angles
+ */
+void
+HtTrigTable::set_angles(float angle_from, float angle_increment, unsigned int num_angles)
+{
+	cos_.resize(num_angles);
+	sin_.resize(num_angles);
+	degrees_.resize(num_angles);
+
+	for (unsigned int i = 0; i < num_angles; ++i) {
+		float phi   = angle_from + i * angle_increment;
+		cos_[i]     = cos(phi);
+		sin_[i]     = sin(phi);
+		degrees_[i] = (int)round(fawkes::rad2deg(phi));
+	}
+
+	if (num_angles > 0) {
+		min_degrees_ = *std::min_element(degrees_.begin(), degrees_.end());
+		max_degrees_ = *std::max_element(degrees_.begin(), degrees_.end());
+	} else {
+		min_degrees_ = max_degrees_ = 0;
+	}
+}
+
+/** Get number of candidate angles.
+ * @return number of candidate angles
+ */
+unsigned int
+HtTrigTable::size() const
+{
+	return cos_.size();
+}
+
+/** Get cosine values.
+ * @return array of size() cosine values of candidate angles
+ */
+const float *
+HtTrigTable::cos_values() const
+{
+	return cos_.data();
+}
+
+/** Get sine values.
+ * @return array of size() sine values of candidate angles
+ */
+const float *
+HtTrigTable::sin_values() const
+{
+	return sin_.data();
+}
+
+/** Get angles in degrees.
+ * @return array of size() candidate angles rounded to full degrees
+ */
+const int *
+HtTrigTable::degrees() const
+{
+	return degrees_.data();
+}
+
+/** Get minimum angle in degrees.
+ * @return minimum of degrees()
+ */
+int
+HtTrigTable::min_degrees() const
+{
+	return min_degrees_;
+}
+
+/** Get maximum angle in degrees.
+ * @return maximum of degrees()
+ */
+int
+HtTrigTable::max_degrees() const
+{
+	return max_degrees_;
+}
+
+} // end namespace firevision
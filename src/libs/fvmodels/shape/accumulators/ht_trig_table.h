@@ -0,0 +1,56 @@
+
+/***************************************************************************
+ *  ht_trig_table.h - Sine and cosine table for Hough transforms
+ *
+ *  Created: Sun Oct 18 18:03:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_MODELS_SHAPE_ACCUMULATORS_HT_TRIG_TABLE_H_
+#define _FIREVISION_MODELS_SHAPE_ACCUMULATORS_HT_TRIG_TABLE_H_
+
+#include <vector>
+
+namespace firevision {
+
+class HtTrigTable
+{
+public:
+	HtTrigTable();
+	~HtTrigTable();
+
+	void set_angles(float angle_from, float angle_increment, unsigned int num_angles);
+
+	unsigned int size() const;
+	const float *cos_values() const;
+	const float *sin_values() const;
+	const int   *degrees() const;
+	int          min_degrees() const;
+	int          max_degrees() const;
+
+private:
+	std::vector<float> cos_;
+	std::vector<float> sin_;
+	std::vector<int>   degrees_;
+	int                min_degrees_;
+	int                max_degrees_;
+};
+
+} // end namespace firevision
+
+#endif
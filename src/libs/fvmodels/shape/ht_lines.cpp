@@ -27,7 +27,11 @@
 #include <sys/time.h>
 #include <utils/math/angle.h>
 
+#include <algorithm>
 #include <cmath>
+#ifdef _OPENMP
+#	include <omp.h>
+#endif
 
 using namespace std;
 using namespace fawkes;
@@ -74,6 +78,9 @@ HtLinesModel::HtLinesModel(unsigned int nr_candidates,
 	RHT_ANGLE_FROM      = angle_from - (floor(angle_from / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_RANGE     = angle_range - (floor(angle_range / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_INCREMENT = RHT_ANGLE_RANGE / RHT_NR_CANDIDATES;
+
+	angles.set_angles(RHT_ANGLE_FROM, RHT_ANGLE_INCREMENT, RHT_NR_CANDIDATES);
+	num_threads = 1;
 }
 
 /** Destructor. */
@@ -82,6 +89,51 @@ HtLinesModel::~HtLinesModel(void)
 	m_Lines.clear();
 }
 
+/** Set number of threads used for voting.
+ * The candidate angles are split among the threads, each of which votes
+ * into its own accumulator. These are merged once all votes have been
+ * cast. Only has an effect if compiled with OpenMP support.
+ * @param num_threads number of threads, 0 to use the OpenMP default
+ */
+void
+HtLinesModel::set_num_threads(unsigned int num_threads)
+{
+#ifdef _OPENMP
+	this->num_threads = (num_threads == 0) ? omp_get_max_threads() : num_threads;
+#else
+	this->num_threads = 1;
+#endif
+}
+
+/** Vote for candidate lines of all pixels.
+ * Votes are cast angle by angle, such that all votes for one angle end up
+ * in the same row of the accumulator.
+ * @param pixels edge pixels
+ * @param first_angle index of first candidate angle to vote for
+ * @param end_angle index after the last candidate angle to vote for
+ * @param acc accumulator to vote into
+ */
+void
+HtLinesModel::vote(const vector<upoint_t> &pixels,
+                   unsigned int            first_angle,
+                   unsigned int            end_angle,
+                   HtFlatAccumulator      &acc)
+{
+	const float *cos_phi = angles.cos_values();
+	const float *sin_phi = angles.sin_values();
+	const int   *degrees = angles.degrees();
+	const float  r_scale = RHT_R_SCALE;
+
+	vector<int> r_bins(pixels.size());
+	for (unsigned int a = first_angle; a < end_angle; ++a) {
+		for (unsigned int i = 0; i < pixels.size(); ++i) {
+			float r   = pixels[i].x * cos_phi[a] + pixels[i].y * sin_phi[a];
+			r_bins[i] = (int)round(r / r_scale);
+		}
+		acc.accumulate_row(r_bins.data(), r_bins.size(), degrees[a], 0);
+	}
+}
+
 int
 HtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 {
@@ -112,27 +164,40 @@ HtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 		buffer = line_start;
 	}
 
-	// Then perform the RHT algorithm
-	upoint_t                   p;
-	float                      r, phi; // used for line representation
-	vector<upoint_t>::iterator pos;
 	if (pixels.size() == 0) {
 		// No edge pixels found => no lines
 		return 0;
 	}
 
-	while (pixels.size() > 0) {
-		p = pixels.back();
-		pixels.pop_back();
+	// Then perform the HT algorithm
+	const int r_bound =
+	  (int)ceil(sqrt((float)roi->width * roi->width + (float)roi->height * roi->height) / RHT_R_SCALE)
+	  + 1;
+	accumulator.set_bounds(-r_bound, r_bound, angles.min_degrees(), angles.max_degrees());
 
-		for (unsigned int i = 0; i < RHT_NR_CANDIDATES; ++i) {
-			phi = RHT_ANGLE_FROM + i * RHT_ANGLE_INCREMENT;
-			r   = p.x * cos(phi) + p.y * sin(phi);
+	const unsigned int threads = std::max(1u, std::min(num_threads, RHT_NR_CANDIDATES));
+	if (thread_accumulators.size() < threads - 1) {
+		thread_accumulators.resize(threads - 1);
+	}
+	for (unsigned int t = 1; t < threads; ++t) {
+		thread_accumulators[t - 1].set_bounds(-r_bound,
+		                                      r_bound,
+		                                      angles.min_degrees(),
+		                                      angles.max_degrees());
+	}
 
-			int angle = (int)round(fawkes::rad2deg(phi));
+#ifdef _OPENMP
+#	pragma omp parallel for num_threads(threads) schedule(static, 1)
+#endif
+	for (unsigned int t = 0; t < threads; ++t) {
+		vote(pixels,
+		     RHT_NR_CANDIDATES * t / threads,
+		     RHT_NR_CANDIDATES * (t + 1) / threads,
+		     (t == 0) ? accumulator : thread_accumulators[t - 1]);
+	}
 
-			accumulator.accumulate((int)round(r / RHT_R_SCALE), angle, 0);
-		}
+	for (unsigned int t = 1; t < threads; ++t) {
+		accumulator.merge(thread_accumulators[t - 1]);
 	}
 
 	// Find the most dense region, and decide on the lines
@@ -212,6 +277,7 @@ HtLinesModel::getShapes()
 		l.calcPoints();
 		rv->push_back(l);
 	}
+	delete rht_nodes;
 
 	return rv;
 }
@@ -25,7 +25,8 @@
 #ifndef _FIREVISION_MODELS_SHAPE_HT_LINE_H_
 #define _FIREVISION_MODELS_SHAPE_HT_LINE_H_
 
-#include <fvmodels/shape/accumulators/ht_accum.h>
+#include <fvmodels/shape/accumulators/ht_flat_accum.h>
+#include <fvmodels/shape/accumulators/ht_trig_table.h>
 #include <fvmodels/shape/line.h>
 #include <fvutils/base/types.h>
 
@@ -41,7 +42,7 @@ class HtLinesModel : public ShapeModel
 {
 private:
 	std::vector<LineShape> m_Lines;
-	RhtAccumulator         accumulator;
+	HtFlatAccumulator      accumulator;
 
 public:
 	HtLinesModel(unsigned int nr_candidates   = 40,
@@ -63,6 +64,14 @@ public:
 	LineShape              *getMostLikelyShape(void) const;
 	std::vector<LineShape> *getShapes();
 
+	void set_num_threads(unsigned int num_threads);
+
+private:
+	void vote(const std::vector<fawkes::upoint_t> &pixels,
+	          unsigned int                         first_angle,
+	          unsigned int                         end_angle,
+	          HtFlatAccumulator                   &acc);
+
 private:
 	unsigned int RHT_NR_CANDIDATES;
 	float        RHT_ANGLE_INCREMENT;
@@ -78,6 +87,10 @@ private:
 
 	unsigned int roi_width;
 	unsigned int roi_height;
+
+	HtTrigTable                    angles;
+	unsigned int                   num_threads;
+	std::vector<HtFlatAccumulator> thread_accumulators;
 };
 
 } // end namespace firevision
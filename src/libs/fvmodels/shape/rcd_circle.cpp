@@ -85,6 +85,18 @@ RcdCircleModel::~RcdCircleModel(void)
 	m_Circles.clear();
 }
 
+/** Set seed for random pixel selection.
+ * The random number generator is seeded with a fixed default seed on
+ * construction, such that results are reproducible unless limited by the
+ * maximum runtime.
+ * @param seed new seed
+ */
+void
+RcdCircleModel::set_random_seed(unsigned int seed)
+{
+	random_engine.seed(seed);
+}
+
 int
 RcdCircleModel::parseImage(unsigned char *buf, ROI *roi)
 {
@@ -180,10 +192,9 @@ RcdCircleModel::parseImage(unsigned char *buf, ROI *roi)
 	}
 
 	// Then perform the RCD algorithm
-	upoint_t                   p[4];
-	center_in_roi_t            center;
-	float                      radius;
-	vector<upoint_t>::iterator pos;
+	upoint_t        p[4];
+	center_in_roi_t center;
+	float           radius;
 
 	if (pixels.size() < RCD_MIN_PIXELS) {
 		return 0;
@@ -191,11 +202,12 @@ RcdCircleModel::parseImage(unsigned char *buf, ROI *roi)
 
 	do {
 		// Pick four points, and move them to the remove_list.
+		// The order of pixels is irrelevant, remove by swapping with last.
 		for (int i = 0; i < 4; ++i) {
-			int ri = rand() % ((int)pixels.size());
-			pos    = pixels.begin() + ri;
-			p[i]   = *pos; // use * operator of iterator
-			pixels.erase(pos);
+			unsigned int ri = random_engine() % pixels.size();
+			p[i]            = pixels[ri];
+			pixels[ri]      = pixels.back();
+			pixels.pop_back();
 			remove_list.push_back(p[i]);
 		}
 
@@ -223,7 +235,7 @@ RcdCircleModel::parseImage(unsigned char *buf, ROI *roi)
 		calcCircle(p[0], p[1], p[2], center, radius);
 
 		// Test if the fourth point on this circle
-		int r    = (int)sqrt(TBY_SQUARED_DIST(center.x, center.y, pixels[3].x, pixels[3].y));
+		int r    = (int)sqrt(TBY_SQUARED_DIST(center.x, center.y, p[3].x, p[3].y));
 		int dist = (int)(r - radius);
 		dist     = (dist >= 0) ? dist : -dist;
 		if (radius <= 0 || (unsigned int)dist > RCD_MAX_DIST_P4) {
@@ -242,19 +254,21 @@ RcdCircleModel::parseImage(unsigned char *buf, ROI *roi)
 		}
 
 		// count how many pixels are on the circle
-		count = 0;
-		for (unsigned int i = 0; i < pixels.size(); ++i) {
+		count                = 0;
+		size_t num_remaining = 0;
+		for (size_t i = 0; i < pixels.size(); ++i) {
 			int r    = (int)sqrt(TBY_SQUARED_DIST(center.x, center.y, pixels[i].x, pixels[i].y));
 			int dist = (int)(r - radius);
 			dist     = (dist >= 0) ? dist : -dist;
 			if ((unsigned int)dist <= RCD_MAX_DIST_A) {
-				pos = pixels.begin() + i;
 				++count;
 				// move this pixel to the remove_list
 				remove_list.push_back(pixels[i]);
-				pixels.erase(pos--); // need "--"? not sure yet!
+			} else {
+				pixels[num_remaining++] = pixels[i];
 			}
 		}
+		pixels.resize(num_remaining);
 
 		// test if there are enough points on the circle
 		// to convince us that this is indeed a circle
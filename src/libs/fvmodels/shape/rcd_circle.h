@@ -31,6 +31,7 @@
 #include <utils/math/types.h>
 
 #include <iostream>
+#include <random>
 #include <vector>
 
 namespace firevision {
@@ -63,6 +64,8 @@ public:
 	Circle *getShape(int id) const;
 	Circle *getMostLikelyShape(void) const;
 
+	void set_random_seed(unsigned int seed);
+
 private:
 	/** Calculate circle from three points
    */
@@ -84,6 +87,8 @@ private:
 	float        RCD_HW_RATIO;
 	float        RCD_MAX_TIME;
 	float        RCD_ROI_HOLLOW_RATE;
+
+	std::mt19937 random_engine;
 };
 
 } // end namespace firevision
@@ -58,6 +58,18 @@ RhtCircleModel::~RhtCircleModel(void)
 	m_Circles.clear();
 }
 
+/** Set seed for random pixel selection.
+ * The random number generator is seeded with a fixed default seed on
+ * construction, such that results are reproducible unless limited by the
+ * maximum runtime.
+ * @param seed new seed
+ */
+void
+RhtCircleModel::set_random_seed(unsigned int seed)
+{
+	random_engine.seed(seed);
+}
+
 /**************************************************************
  * In this function I implement the circle detection algorithm
  * from the following literature
@@ -159,17 +171,25 @@ RhtCircleModel::parseImage(unsigned char *buf, ROI *roi)
 	}
 
 	// Then perform the RHT algorithm
-	upoint_t                   p[3];
-	center_in_roi_t            center;
-	float                      radius;
-	vector<upoint_t>::iterator pos;
-	int                        num_iter   = 0;
-	int                        num_points = (int)pixels.size();
+	upoint_t        p[3];
+	center_in_roi_t center;
+	float           radius;
+	int             num_iter   = 0;
+	int             num_points = (int)pixels.size();
 	if (num_points == 0) {
 		// No pixels found => no edge => no circle
 		return 0;
 	}
 
+	// Circle centers are considered within the ROI extended by half its
+	// size in each direction, radii in the range of valid radii
+	accumulator.set_bounds(-(int)(roi->width / 2) / RHT_XY_SCALE - 1,
+	                       (int)(roi->width + roi->width / 2) / RHT_XY_SCALE,
+	                       -(int)(roi->height / 2) / RHT_XY_SCALE - 1,
+	                       (int)(roi->height + roi->height / 2) / RHT_XY_SCALE,
+	                       (int)(RHT_MIN_RADIUS / RHT_RADIUS_SCALE),
+	                       (int)(RHT_MAX_RADIUS / RHT_RADIUS_SCALE));
+
 	while ((num_iter++ < RHT_MAX_ITER)
 	       && (((end.tv_usec - start.tv_usec) < RHT_MAX_TIME)
 	           || ((end.tv_usec + 1000000 - start.tv_usec) < RHT_MAX_TIME))
@@ -177,9 +197,7 @@ RhtCircleModel::parseImage(unsigned char *buf, ROI *roi)
 	) {
 		// Pick three points, and move them to the remove_list.
 		for (int i = 0; i < 3; ++i) {
-			int ri = rand() % num_points;
-			pos    = pixels.begin() + ri;
-			p[i]   = *pos; // use * operator of iterator
+			p[i] = pixels[random_engine() % num_points];
 		}
 
 		// Now calculate the center and radius
@@ -209,14 +227,15 @@ RhtCircleModel::parseImage(unsigned char *buf, ROI *roi)
 		center.y  = (float)(y_max * RHT_XY_SCALE + RHT_XY_SCALE / 2);
 		float c_r = (float)(r_max * RHT_RADIUS_SCALE + RHT_RADIUS_SCALE / 2);
 
-		// With circle fitting
-		for (vector<upoint_t>::iterator pos = pixels.begin(); pos != pixels.end();) {
-			if (TBY_RADIUS_DIFF(pos->x, pos->y, center.x, center.y, c_r) > RHT_FITTING_DIST_DIFF) {
-				pixels.erase(pos);
-			} else {
-				pos++;
+		// With circle fitting, only keep pixels close to the circle
+		size_t num_fitting = 0;
+		for (size_t i = 0; i < pixels.size(); ++i) {
+			if (!(TBY_RADIUS_DIFF(pixels[i].x, pixels[i].y, center.x, center.y, c_r)
+			      > RHT_FITTING_DIST_DIFF)) {
+				pixels[num_fitting++] = pixels[i];
 			}
 		}
+		pixels.resize(num_fitting);
 
 		Circle c;
 		c.fitCircle(pixels);
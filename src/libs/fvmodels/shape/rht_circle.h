@@ -25,12 +25,13 @@
 #ifndef _FIREVISION_RHT_CIRCLE_H_
 #define _FIREVISION_RHT_CIRCLE_H_
 
-#include <fvmodels/shape/accumulators/ht_accum.h>
+#include <fvmodels/shape/accumulators/ht_flat_accum.h>
 #include <fvmodels/shape/circle.h>
 #include <fvutils/base/types.h>
 #include <utils/math/types.h>
 
 #include <iostream>
+#include <random>
 #include <vector>
 
 namespace firevision {
@@ -41,7 +42,8 @@ class RhtCircleModel : public ShapeModel
 {
 private:
 	std::vector<Circle> m_Circles;
-	RhtAccumulator      accumulator;
+	HtFlatAccumulator   accumulator;
+	std::mt19937        random_engine;
 	static const float  RHT_MIN_RADIUS;
 	static const float  RHT_MAX_RADIUS;
 
@@ -59,6 +61,8 @@ public:
 	Circle *getShape(int id) const;
 	Circle *getMostLikelyShape(void) const;
 
+	void set_random_seed(unsigned int seed);
+
 private:
 	void calcCircle( // for calculating circles from 3 points
 	  const fawkes::upoint_t &p1,
@@ -61,6 +61,8 @@ RhtLinesModel::RhtLinesModel(float        max_time,
 	RHT_ANGLE_FROM      = angle_from - (floor(angle_from / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_RANGE     = angle_range - (floor(angle_range / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_INCREMENT = RHT_ANGLE_RANGE / RHT_NR_CANDIDATES;
+
+	angles.set_angles(RHT_ANGLE_FROM, RHT_ANGLE_INCREMENT, RHT_NR_CANDIDATES);
 }
 
 /** Destructor. */
@@ -69,6 +71,18 @@ RhtLinesModel::~RhtLinesModel(void)
 	m_Lines.clear();
 }
 
+/** Set seed for random pixel selection.
+ * The random number generator is seeded with a fixed default seed on
+ * construction, such that results are reproducible unless limited by the
+ * maximum runtime.
+ * @param seed new seed
+ */
+void
+RhtLinesModel::set_random_seed(unsigned int seed)
+{
+	random_engine.seed(seed);
+}
+
 /**************************************************************
  * In this function we implement a lines detection algorithm
  **************************************************************/
@@ -107,30 +121,34 @@ RhtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 	}
 
 	// Then perform the RHT algorithm
-	upoint_t                   p;
-	float                      r, phi; // used for line representation
-	vector<upoint_t>::iterator pos;
-	int                        num_iter = 0;
+	upoint_t p;
+	int      num_iter = 0;
 	if (pixels.size() == 0) {
 		// No edge pixels found => no lines
 		return 0;
 	}
 
+	const int r_bound =
+	  (int)ceil(sqrt((float)roi->width * roi->width + (float)roi->height * roi->height) / RHT_R_SCALE)
+	  + 1;
+	accumulator.set_bounds(-r_bound, r_bound, angles.min_degrees(), angles.max_degrees());
+
+	const float *cos_phi = angles.cos_values();
+	const float *sin_phi = angles.sin_values();
+	const int   *degrees = angles.degrees();
+
 	do {
 		// in order to prevent float exception, pixels.size() must be non-zero
 		if (pixels.size() > 0) {
-			int ri = rand() % pixels.size();
-			pos    = pixels.begin() + ri;
-			p      = *pos;
-			pixels.erase(pos);
+			// order of pixels is irrelevant, remove by swapping with last
+			unsigned int ri = random_engine() % pixels.size();
+			p               = pixels[ri];
+			pixels[ri]      = pixels.back();
+			pixels.pop_back();
 
 			for (unsigned int i = 0; i < RHT_NR_CANDIDATES; ++i) {
-				phi = RHT_ANGLE_FROM + i * RHT_ANGLE_INCREMENT;
-				r   = p.x * cos(phi) + p.y * sin(phi);
-
-				int angle = (int)round(fawkes::rad2deg(phi));
-
-				accumulator.accumulate((int)round(r / RHT_R_SCALE), angle, 0);
+				float r = p.x * cos_phi[i] + p.y * sin_phi[i];
+				accumulator.accumulate((int)round(r / RHT_R_SCALE), degrees[i], 0);
 			}
 
 			gettimeofday(&now, NULL);
@@ -224,6 +242,7 @@ RhtLinesModel::getShapes()
 		l.calcPoints();
 		rv->push_back(l);
 	}
+	delete rht_nodes;
 
 	return rv;
 }
@@ -25,12 +25,14 @@
 #ifndef _FIREVISION_MODELS_SHAPE_RHT_LINE_H_
 #define _FIREVISION_MODELS_SHAPE_RHT_LINE_H_
 
-#include <fvmodels/shape/accumulators/ht_accum.h>
+#include <fvmodels/shape/accumulators/ht_flat_accum.h>
+#include <fvmodels/shape/accumulators/ht_trig_table.h>
 #include <fvmodels/shape/line.h>
 #include <fvutils/base/types.h>
 
 #include <cmath>
 #include <iostream>
+#include <random>
 #include <vector>
 
 namespace firevision {
@@ -41,7 +43,7 @@ class RhtLinesModel : public ShapeModel
 {
 private:
 	std::vector<LineShape> m_Lines;
-	RhtAccumulator         accumulator;
+	HtFlatAccumulator      accumulator;
 
 public:
 	/** Creates a new RhtLinesModel instance
@@ -86,6 +88,8 @@ public:
 	LineShape              *getMostLikelyShape(void) const;
 	std::vector<LineShape> *getShapes();
 
+	void set_random_seed(unsigned int seed);
+
 private:
 	// The following constants are used as stopping criteria
 	float RHT_MAX_TIME;
@@ -110,6 +114,9 @@ private:
 	int diff_usec;
 
 	float f_diff_sec;
+
+	HtTrigTable  angles;
+	std::mt19937 random_engine;
 };
 
 } // end namespace firevision
@@ -30,6 +30,7 @@
 #include <fvutils/statistical/histogram.h>
 #include <fvutils/statistical/histogram_block.h>
 #include <fvutils/statistical/histogram_file.h>
+#include <fvutils/statistical/yuv_histogram_accumulator.h>
 
 #include <cmath>
 
@@ -204,29 +205,13 @@ BayesColormapGenerator::consider()
 		(*histo_it).second->reset_undo();
 	}
 
-	unsigned int y;
-	unsigned int u;
-	unsigned int v;
-
-	for (unsigned int w = 0; w < image_width; ++w) {
-		for (unsigned int h = 0; h < image_height; ++h) {
-			y = YUV422_PLANAR_Y_AT(buffer, image_width, w, h);
-			u = YUV422_PLANAR_U_AT(buffer, image_width, image_height, w, h);
-			v = YUV422_PLANAR_V_AT(buffer, image_width, image_height, w, h);
-
-			unsigned int y_index = (unsigned int)(y / 256.0f * float(lut_depth));
-			unsigned int u_index = (unsigned int)(u / 256.0f * float(lut_width));
-			unsigned int v_index = (unsigned int)(v / 256.0f * float(lut_height));
-
-			if (is_in_region(w, h)) {
-				fg_histos[fg_object]->inc_value(u_index, v_index, y_index);
-			} else {
-				bg_histos[fg_object]->inc_value(u_index, v_index, y_index);
-			}
-		}
-		cout << "." << flush;
-	}
-	cout << endl;
+	YuvHistogramAccumulator accumulator(lut_width, lut_height, lut_depth);
+	accumulator.accumulate(buffer,
+	                       image_width,
+	                       image_height,
+	                       selection_mask,
+	                       fg_histos[fg_object],
+	                       bg_histos[fg_object]);
 }
 
 /** Calculate. */
@@ -62,6 +62,8 @@ typedef enum {
 	FUSE_MT_SET_LUT_FAILED    = 1007, /**< Setting a LUT failed */
 	FUSE_MT_IMAGE_INFO        = 1008, /**< image info */
 	FUSE_MT_IMAGE_INFO_FAILED = 1009, /**< Retrieval of image info failed */
+	FUSE_MT_SUBSCRIBED        = 1010, /**< image subscription granted */
+	FUSE_MT_SUBSCRIBE_FAILED  = 1011, /**< image subscription failed */
 
 	/* client to server, 2000-2999 */
 	FUSE_MT_GET_IMAGE      = 2000, /**< request image */
@@ -70,15 +72,23 @@ typedef enum {
 	FUSE_MT_GET_IMAGE_LIST = 2003, /**< get image list */
 	FUSE_MT_GET_LUT_LIST   = 2004, /**< get LUT list */
 	FUSE_MT_GET_IMAGE_INFO = 2005, /**< get image info */
+	FUSE_MT_SUBSCRIBE      = 2006, /**< subscribe to pushed images */
+	FUSE_MT_UNSUBSCRIBE    = 2007, /**< cancel image subscription */
 
 } FUSE_message_type_t;
 
 /** Image format. */
 typedef enum {
-	FUSE_IF_RAW  = 1, /**< Raw image */
-	FUSE_IF_JPEG = 2  /**< JPEG image */
+	FUSE_IF_RAW   = 1, /**< Raw image */
+	FUSE_IF_JPEG  = 2, /**< JPEG image */
+	FUSE_IF_DELTA = 3  /**< Raw difference frame, see FuseImageDelta */
 } FUSE_image_format_t;
 
+/** Image subscription flags. */
+typedef enum {
+	FUSE_ISF_DELTA = 1 /**< difference frames may be sent for raw images */
+} FUSE_image_subscription_flags_t;
+
 /** general packet header */
 typedef struct
 {
@@ -151,6 +161,21 @@ typedef struct
 	uint32_t reserved : 24;                 /**< reserved for future use */
 } FUSE_imagereq_message_t;
 
+/** Image subscription message.
+ * client to server: FUSE_MT_SUBSCRIBE, requested parameters
+ * server to client: FUSE_MT_SUBSCRIBED, granted parameters
+ * Images are then pushed as FUSE_MT_IMAGE messages without further requests.
+ */
+typedef struct
+{
+	char     image_id[IMAGE_ID_MAX_LENGTH]; /**< image ID */
+	uint32_t format : 8;                    /**< image format, see FUSE_image_format_t */
+	uint32_t flags : 8;                     /**< flags, see FUSE_image_subscription_flags_t */
+	uint32_t reserved : 16;                 /**< reserved for future use */
+	uint32_t period_ms;                     /**< minimum time between two images in ms */
+	uint32_t keyframe_interval;             /**< send full frame at least every N frames */
+} FUSE_imagesubscribe_message_t;
+
 /** Image description message. */
 typedef struct
 {
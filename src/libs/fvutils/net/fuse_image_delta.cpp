@@ -0,0 +1,150 @@
+
+/***************************************************************************
+ *  fuse_image_delta.cpp - FUSE difference frame encoding
+ *
+ *  Created: Sun Oct 18 11:02:17 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <fvutils/net/fuse_image_delta.h>
+#include <netinet/in.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace firevision {
+
+/** @class FuseImageDelta <fvutils/net/fuse_image_delta.h>
+ * FUSE difference frame codec.
+ * A difference frame (FUSE_IF_DELTA) encodes a raw image relative to the
+ * previous raw image sent on the same image subscription. The encoded
+ * buffer is a sequence of records, each consisting of a 32 bit skip count
+ * of unchanged bytes, a 32 bit length of changed bytes, and the changed
+ * bytes themselves. Both counts are in network byte order. Buffers are
+ * compared in blocks of BLOCK_SIZE bytes, which keeps the encoder fast and
+ * the per-record overhead small for mostly static scenes.
+ * @ingroup FUSE
+ * @ingroup FireVision
+ * @author Tim Niemueller
+ */
+
+const size_t FuseImageDelta::BLOCK_SIZE;
+
+/** Encode difference frame.
+ * @param prev_buffer previous image buffer, must be of size buffer_size
+ * @param buffer current image buffer
+ * @param buffer_size size of prev_buffer and buffer in bytes
+ * @param delta buffer to write the encoded difference to
+ * @param delta_size size of delta in bytes
+ * @return number of bytes written to delta, or 0 if the encoded difference
+ * would not fit into delta. In the latter case a full frame should be sent.
+ */
+size_t
+FuseImageDelta::encode(const unsigned char *prev_buffer,
+                       const unsigned char *buffer,
+                       size_t               buffer_size,
+                       unsigned char       *delta,
+                       size_t               delta_size)
+{
+	size_t written = 0;
+	size_t skip    = 0;
+	size_t pos     = 0;
+
+	while (pos < buffer_size) {
+		size_t block = std::min(BLOCK_SIZE, buffer_size - pos);
+		if (memcmp(prev_buffer + pos, buffer + pos, block) == 0) {
+			skip += block;
+			pos += block;
+			continue;
+		}
+
+		// collect consecutive changed blocks into a single record
+		size_t start = pos;
+		pos += block;
+		while (pos < buffer_size) {
+			block = std::min(BLOCK_SIZE, buffer_size - pos);
+			if (memcmp(prev_buffer + pos, buffer + pos, block) == 0)
+				break;
+			pos += block;
+		}
+
+		size_t length = pos - start;
+		if (written + 2 * sizeof(uint32_t) + length > delta_size) {
+			return 0;
+		}
+		uint32_t nskip   = htonl(skip);
+		uint32_t nlength = htonl(length);
+		memcpy(delta + written, &nskip, sizeof(uint32_t));
+		memcpy(delta + written + sizeof(uint32_t), &nlength, sizeof(uint32_t));
+		memcpy(delta + written + 2 * sizeof(uint32_t), buffer + start, length);
+		written += 2 * sizeof(uint32_t) + length;
+		skip = 0;
+	}
+
+	if (written == 0) {
+		// unchanged image, send a single empty record so that the
+		// difference frame is not confused with an encoding failure
+		if (delta_size < 2 * sizeof(uint32_t)) {
+			return 0;
+		}
+		memset(delta, 0, 2 * sizeof(uint32_t));
+		written = 2 * sizeof(uint32_t);
+	}
+
+	return written;
+}
+
+/** Apply difference frame.
+ * @param buffer image buffer holding the previous image, will be modified
+ * in place to contain the current image
+ * @param buffer_size size of buffer in bytes
+ * @param delta encoded difference as produced by encode()
+ * @param delta_size size of delta in bytes
+ * @exception OutOfBoundsException thrown if the difference does not match
+ * the given buffer
+ */
+void
+FuseImageDelta::apply(unsigned char       *buffer,
+                      size_t               buffer_size,
+                      const unsigned char *delta,
+                      size_t               delta_size)
+{
+	size_t pos  = 0;
+	size_t dpos = 0;
+
+	while (dpos + 2 * sizeof(uint32_t) <= delta_size) {
+		uint32_t nskip, nlength;
+		memcpy(&nskip, delta + dpos, sizeof(uint32_t));
+		memcpy(&nlength, delta + dpos + sizeof(uint32_t), sizeof(uint32_t));
+		dpos += 2 * sizeof(uint32_t);
+
+		size_t skip   = ntohl(nskip);
+		size_t length = ntohl(nlength);
+		if ((pos + skip + length > buffer_size) || (dpos + length > delta_size)) {
+			throw fawkes::OutOfBoundsException("Difference frame exceeds image buffer");
+		}
+		pos += skip;
+		memcpy(buffer + pos, delta + dpos, length);
+		pos += length;
+		dpos += length;
+	}
+}
+
+} // end namespace firevision
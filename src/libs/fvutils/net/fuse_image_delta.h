@@ -0,0 +1,51 @@
+
+/***************************************************************************
+ *  fuse_image_delta.h - FUSE difference frame encoding
+ *
+ *  Created: Sun Oct 18 11:02:17 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FVUTILS_NET_FUSE_IMAGE_DELTA_H_
+#define _FIREVISION_FVUTILS_NET_FUSE_IMAGE_DELTA_H_
+
+#include <sys/types.h>
+
+namespace firevision {
+
+class FuseImageDelta
+{
+public:
+	static size_t encode(const unsigned char *prev_buffer,
+	                     const unsigned char *buffer,
+	                     size_t               buffer_size,
+	                     unsigned char       *delta,
+	                     size_t               delta_size);
+
+	static void apply(unsigned char       *buffer,
+	                  size_t               buffer_size,
+	                  const unsigned char *delta,
+	                  size_t               delta_size);
+
+	/** Block size in bytes at which buffers are compared. */
+	static const size_t BLOCK_SIZE = 16;
+};
+
+} // end namespace firevision
+
+#endif
@@ -26,6 +26,7 @@
 #include <fvutils/ipc/shm_image.h>
 #include <fvutils/ipc/shm_lut.h>
 #include <fvutils/net/fuse_image_content.h>
+#include <fvutils/net/fuse_image_delta.h>
 #include <fvutils/net/fuse_imagelist_content.h>
 #include <fvutils/net/fuse_lut_content.h>
 #include <fvutils/net/fuse_lutlist_content.h>
@@ -38,6 +39,7 @@
 #include <netcomm/utils/exceptions.h>
 #include <netinet/in.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <unistd.h>
@@ -197,33 +199,7 @@ FuseServerClientThread::process_getimage_message(FuseNetworkMessage *m)
 		FuseImageContent *im = new FuseImageContent(b);
 		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
 	} else if (irm->format == FUSE_IF_JPEG) {
-		if (!jpeg_compressor_) {
-			jpeg_compressor_ = new JpegImageCompressor();
-			jpeg_compressor_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
-		}
-		b->lock_for_read();
-		jpeg_compressor_->set_image_dimensions(b->width(), b->height());
-		jpeg_compressor_->set_image_buffer(b->colorspace(), b->buffer());
-		unsigned char *compressed_buffer =
-		  (unsigned char *)malloc(jpeg_compressor_->recommended_compressed_buffer_size());
-		jpeg_compressor_->set_destination_buffer(
-		  compressed_buffer, jpeg_compressor_->recommended_compressed_buffer_size());
-		jpeg_compressor_->compress();
-		b->unlock();
-		size_t   compressed_buffer_size = jpeg_compressor_->compressed_size();
-		long int sec = 0, usec = 0;
-		b->capture_time(&sec, &usec);
-		FuseImageContent *im = new FuseImageContent(FUSE_IF_JPEG,
-		                                            b->image_id(),
-		                                            compressed_buffer,
-		                                            compressed_buffer_size,
-		                                            CS_UNKNOWN,
-		                                            b->width(),
-		                                            b->height(),
-		                                            sec,
-		                                            usec);
-		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
-		free(compressed_buffer);
+		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, compress_jpeg(b)));
 	} else {
 		FuseNetworkMessage *nm = new FuseNetworkMessage(FUSE_MT_GET_IMAGE_FAILED,
 		                                                m->payload(),
@@ -233,6 +209,216 @@ FuseServerClientThread::process_getimage_message(FuseNetworkMessage *m)
 	}
 }
 
+/** Compress image to JPEG.
+ * @param b shared memory image buffer to compress
+ * @return image content with the JPEG compressed image
+ */
+FuseImageContent *
+FuseServerClientThread::compress_jpeg(SharedMemoryImageBuffer *b)
+{
+	if (!jpeg_compressor_) {
+		jpeg_compressor_ = new JpegImageCompressor();
+		jpeg_compressor_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
+	}
+	b->lock_for_read();
+	jpeg_compressor_->set_image_dimensions(b->width(), b->height());
+	jpeg_compressor_->set_image_buffer(b->colorspace(), b->buffer());
+	unsigned char *compressed_buffer =
+	  (unsigned char *)malloc(jpeg_compressor_->recommended_compressed_buffer_size());
+	jpeg_compressor_->set_destination_buffer(compressed_buffer,
+	                                         jpeg_compressor_->recommended_compressed_buffer_size());
+	jpeg_compressor_->compress();
+	b->unlock();
+	size_t   compressed_buffer_size = jpeg_compressor_->compressed_size();
+	long int sec = 0, usec = 0;
+	b->capture_time(&sec, &usec);
+	FuseImageContent *im = new FuseImageContent(FUSE_IF_JPEG,
+	                                            b->image_id(),
+	                                            compressed_buffer,
+	                                            compressed_buffer_size,
+	                                            CS_UNKNOWN,
+	                                            b->width(),
+	                                            b->height(),
+	                                            sec,
+	                                            usec);
+	free(compressed_buffer);
+	return im;
+}
+
+/** Process image subscription message.
+ * The requested parameters are negotiated, i.e. the period is clamped to a
+ * sensible minimum and difference frames are only granted for raw images.
+ * The granted parameters are sent back to the client, images are then
+ * pushed from the thread loop without further requests.
+ * @param m received message
+ */
+void
+FuseServerClientThread::process_subscribe_message(FuseNetworkMessage *m)
+{
+	FUSE_imagesubscribe_message_t *sm = m->msg<FUSE_imagesubscribe_message_t>();
+
+	SharedMemoryImageBuffer *b;
+	try {
+		b = get_shmimgbuf(sm->image_id);
+	} catch (Exception &e) {
+		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_SUBSCRIBE_FAILED,
+		                                             m->payload(),
+		                                             m->payload_size(),
+		                                             /* copy payload */ true));
+		return;
+	}
+
+	if ((sm->format != FUSE_IF_RAW) && (sm->format != FUSE_IF_JPEG)) {
+		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_SUBSCRIBE_FAILED,
+		                                             m->payload(),
+		                                             m->payload_size(),
+		                                             /* copy payload */ true));
+		return;
+	}
+
+	ImageSubscription s;
+	s.buffer                = b;
+	s.format                = (FUSE_image_format_t)sm->format;
+	s.delta                 = (s.format == FUSE_IF_RAW) && (sm->flags & FUSE_ISF_DELTA);
+	s.period_ms             = std::max(ntohl(sm->period_ms), (uint32_t)10);
+	s.keyframe_interval     = ntohl(sm->keyframe_interval);
+	s.frames_since_keyframe = 0;
+	s.last_capture_sec      = 0;
+	s.last_capture_usec     = 0;
+	s.last_sent.set_time(0, 0);
+	if (s.delta && (s.keyframe_interval == 0)) {
+		s.keyframe_interval = 100;
+	}
+	subscriptions_[b->image_id()] = s;
+
+	FUSE_imagesubscribe_message_t *reply =
+	  (FUSE_imagesubscribe_message_t *)calloc(1, sizeof(FUSE_imagesubscribe_message_t));
+	strncpy(reply->image_id, b->image_id(), IMAGE_ID_MAX_LENGTH - 1);
+	reply->format            = s.format;
+	reply->flags             = s.delta ? FUSE_ISF_DELTA : 0;
+	reply->period_ms         = htonl(s.period_ms);
+	reply->keyframe_interval = htonl(s.keyframe_interval);
+	outbound_queue_->push(
+	  new FuseNetworkMessage(FUSE_MT_SUBSCRIBED, reply, sizeof(FUSE_imagesubscribe_message_t)));
+}
+
+/** Process image unsubscription message.
+ * @param m received message
+ */
+void
+FuseServerClientThread::process_unsubscribe_message(FuseNetworkMessage *m)
+{
+	FUSE_imagedesc_message_t *idm = m->msg<FUSE_imagedesc_message_t>();
+
+	char tmp_image_id[IMAGE_ID_MAX_LENGTH + 1];
+	tmp_image_id[IMAGE_ID_MAX_LENGTH] = 0;
+	strncpy(tmp_image_id, idm->image_id, IMAGE_ID_MAX_LENGTH);
+
+	subscriptions_.erase(tmp_image_id);
+}
+
+/** Send image for subscription.
+ * Raw images are sent as difference frame if granted for the subscription,
+ * a full frame is sent if no previous frame is known, the image dimensions
+ * changed, the keyframe interval has been reached, or the difference frame
+ * would not be significantly smaller than the full frame.
+ * @param s subscription to send image for
+ */
+void
+FuseServerClientThread::send_subscribed_image(ImageSubscription &s)
+{
+	SharedMemoryImageBuffer *b = s.buffer;
+
+	if (s.format == FUSE_IF_JPEG) {
+		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, compress_jpeg(b)));
+		return;
+	}
+
+	long int sec = 0, usec = 0;
+	b->capture_time(&sec, &usec);
+	size_t buffer_size = colorspace_buffer_size(b->colorspace(), b->width(), b->height());
+
+	FuseImageContent *im = NULL;
+	b->lock_for_read();
+	if (s.delta && (s.last_frame.size() == buffer_size)
+	    && (s.frames_since_keyframe < s.keyframe_interval)) {
+		// only worth it if we save at least half of the bandwidth
+		s.delta_buffer.resize(buffer_size / 2);
+		size_t delta_size = FuseImageDelta::encode(
+		  &s.last_frame[0], b->buffer(), buffer_size, &s.delta_buffer[0], s.delta_buffer.size());
+		if (delta_size > 0) {
+			im = new FuseImageContent(FUSE_IF_DELTA,
+			                          b->image_id(),
+			                          &s.delta_buffer[0],
+			                          delta_size,
+			                          b->colorspace(),
+			                          b->width(),
+			                          b->height(),
+			                          sec,
+			                          usec);
+			s.frames_since_keyframe += 1;
+		}
+	}
+	if (!im) {
+		im = new FuseImageContent(FUSE_IF_RAW,
+		                          b->image_id(),
+		                          b->buffer(),
+		                          buffer_size,
+		                          b->colorspace(),
+		                          b->width(),
+		                          b->height(),
+		                          sec,
+		                          usec);
+		s.frames_since_keyframe = 0;
+	}
+	if (s.delta) {
+		s.last_frame.assign(b->buffer(), b->buffer() + buffer_size);
+	}
+	b->unlock();
+
+	outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
+}
+
+/** Push images to subscribed clients.
+ * An image is pushed if the subscription period has elapsed and the image
+ * has a new capture time. If the capture time is not set by the producer
+ * images are pushed at the subscription rate. Images are enqueued along
+ * with replies to requests received in the same iteration, the blocking
+ * send() throttles to the rate the client receives at.
+ */
+void
+FuseServerClientThread::process_subscriptions()
+{
+	if (subscriptions_.empty())
+		return;
+
+	fawkes::Time now;
+	for (auto &si : subscriptions_) {
+		ImageSubscription &s = si.second;
+		if ((now - &s.last_sent) * 1000. < s.period_ms)
+			continue;
+
+		long int sec = 0, usec = 0;
+		s.buffer->capture_time(&sec, &usec);
+		if (((sec != 0) || (usec != 0)) && (sec == s.last_capture_sec)
+		    && (usec == s.last_capture_usec)) {
+			continue;
+		}
+
+		try {
+			send_subscribed_image(s);
+		} catch (Exception &e) {
+			LibLogger::log_warn("FuseServerClientThread",
+			                    "Failed to send image %s, exception follows",
+			                    si.first.c_str());
+			LibLogger::log_warn("FuseServerClientThread", e);
+		}
+		s.last_sent         = now;
+		s.last_capture_sec  = sec;
+		s.last_capture_usec = usec;
+	}
+}
+
 /** Process image info request message.
  * @param m received message
  */
@@ -422,6 +608,8 @@ FuseServerClientThread::process_inbound()
 			case FUSE_MT_GET_LUT_LIST: process_getlutlist_message(m); break;
 			case FUSE_MT_GET_LUT: process_getlut_message(m); break;
 			case FUSE_MT_SET_LUT: process_setlut_message(m); break;
+			case FUSE_MT_SUBSCRIBE: process_subscribe_message(m); break;
+			case FUSE_MT_UNSUBSCRIBE: process_unsubscribe_message(m); break;
 			default: throw Exception("Unknown message type received\n");
 			}
 		} catch (Exception &e) {
@@ -468,6 +656,7 @@ FuseServerClientThread::loop()
 	}
 
 	if (alive_) {
+		process_subscriptions();
 		send();
 	}
 }
@@ -25,9 +25,12 @@
 #define _FIREVISION_FVUTILS_NET_FUSE_SERVER_CLIENT_THREAD_H_
 
 #include <core/threading/thread.h>
+#include <fvutils/net/fuse.h>
+#include <utils/time/time.h>
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace fawkes {
 class StreamSocket;
@@ -40,6 +43,7 @@ class FuseNetworkMessage;
 class SharedMemoryImageBuffer;
 class SharedMemoryLookupTable;
 class JpegImageCompressor;
+class FuseImageContent;
 
 class FuseServerClientThread : public fawkes::Thread
 {
@@ -58,9 +62,31 @@ public:
 	void process_getlut_message(FuseNetworkMessage *m);
 	void process_setlut_message(FuseNetworkMessage *m);
 	void process_getlutlist_message(FuseNetworkMessage *m);
+	void process_subscribe_message(FuseNetworkMessage *m);
+	void process_unsubscribe_message(FuseNetworkMessage *m);
 
 private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		SharedMemoryImageBuffer   *buffer;
+		FUSE_image_format_t        format;
+		bool                       delta;
+		unsigned int               period_ms;
+		unsigned int               keyframe_interval;
+		unsigned int               frames_since_keyframe;
+		fawkes::Time               last_sent;
+		long int                   last_capture_sec;
+		long int                   last_capture_usec;
+		std::vector<unsigned char> last_frame;
+		std::vector<unsigned char> delta_buffer;
+	} ImageSubscription;
+	/// @endcond
+
 	void                     process_inbound();
+	void                     process_subscriptions();
+	void                     send_subscribed_image(ImageSubscription &s);
+	FuseImageContent        *compress_jpeg(SharedMemoryImageBuffer *b);
 	SharedMemoryImageBuffer *get_shmimgbuf(const char *id);
 
 	FuseServer           *fuse_server_;
@@ -77,6 +103,8 @@ private:
 	std::map<std::string, SharedMemoryLookupTable *>           luts_;
 	std::map<std::string, SharedMemoryLookupTable *>::iterator lit_;
 
+	std::map<std::string, ImageSubscription> subscriptions_;
+
 	bool alive_;
 };
 
@@ -0,0 +1,122 @@
+
+/***************************************************************************
+ *  qa_seqwriter.cpp - QA for background image sequence writing
+ *
+ *  Created: Sun Oct 18 20:03:27 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/readers/fvraw.h>
+#include <fvutils/writers/async_seq_writer.h>
+#include <utils/time/time.h>
+#include <utils/time/tracker.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace fawkes;
+using namespace firevision;
+
+static void
+fill_image(std::vector<unsigned char> &image,
+           unsigned int                width,
+           unsigned int                height,
+           unsigned int                i)
+{
+	std::fill(image.begin(), image.begin() + width * height, i % 256);
+	std::fill(image.begin() + width * height, image.end(), (i * 7) % 256);
+}
+
+int
+main(int argc, char **argv)
+{
+	const char  *filename   = (argc > 1) ? argv[1] : "qa_seqwriter.raw";
+	unsigned int num_images = (argc > 2) ? atoi(argv[2]) : 100;
+	unsigned int width = 640, height = 480;
+
+	std::vector<unsigned char> image(colorspace_buffer_size(YUV422_PLANAR, width, height));
+	std::vector<unsigned char> expected(colorspace_buffer_size(RGB, width, height));
+
+	TimeTracker  tt;
+	unsigned int ttc_write = tt.add_class("Write");
+	unsigned int ttc_close = tt.add_class("Close");
+
+	try {
+		AsyncSeqWriter writer(filename, RGB, 4, 16);
+		writer.set_dimensions(width, height);
+		writer.set_colorspace(YUV422_PLANAR);
+		writer.set_blocking(true);
+
+		for (unsigned int i = 0; i < num_images; ++i) {
+			fill_image(image, width, height, i);
+			Time t(1000 + i, 0);
+			tt.ping_start(ttc_write);
+			writer.write(&image[0], &t);
+			tt.ping_end(ttc_write);
+		}
+		tt.ping_start(ttc_close);
+		writer.close();
+		tt.ping_end(ttc_close);
+		printf("Wrote %lu images, dropped %lu\n", writer.num_written(), writer.num_dropped());
+		tt.print_to_stdout();
+
+		FvRawReader reader(filename);
+		printf("Sequence has %u images of %ux%u in %s, index: %s\n",
+		       reader.num_frames(),
+		       reader.pixel_width(),
+		       reader.pixel_height(),
+		       colorspace_to_string(reader.colorspace()),
+		       reader.has_index() ? "yes" : "no");
+
+		std::vector<unsigned char> rgb(
+		  colorspace_buffer_size(reader.colorspace(), reader.pixel_width(), reader.pixel_height()));
+		reader.set_buffer(&rgb[0]);
+
+		unsigned int num_errors = 0;
+		for (unsigned int i = num_images; i > 0; --i) {
+			FvRawWriter::FvRawFrameInfo info;
+			reader.seek(i - 1);
+			reader.read();
+			if (!reader.frame_info(i - 1, info) || (info.seqnum != i)
+			    || (info.capture_sec != 1000 + i - 1)) {
+				printf("Index entry of image %u is wrong\n", i - 1);
+				++num_errors;
+			}
+			fill_image(image, width, height, i - 1);
+			convert(YUV422_PLANAR, RGB, &image[0], &expected[0], width, height);
+			if (rgb != expected) {
+				printf("Image %u differs\n", i - 1);
+				++num_errors;
+			}
+		}
+		printf("Read all images in reverse order, %u errors\n", num_errors);
+		return (num_errors == 0) ? 0 : 1;
+	} catch (Exception &e) {
+		e.print_trace();
+		return 1;
+	}
+}
+
+/// @endcond
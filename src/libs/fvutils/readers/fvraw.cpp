@@ -22,6 +22,7 @@
  */
 
 #include <core/exception.h>
+#include <core/exceptions/software.h>
 #include <fvutils/color/colorspaces.h>
 #include <fvutils/readers/fvraw.h>
 #include <fvutils/writers/fvraw.h>
@@ -35,6 +36,13 @@ namespace firevision {
 
 /** @class FvRawReader <fvutils/readers/fvraw.h>
  * FvRaw image reader implementation.
+ * Besides single images this reader can play back FvRaw image sequences.
+ * Every call to read() reads the next image of the sequence, seek() allows
+ * to jump to any image. If the sequence has an index, the sequence number
+ * and capture time of each image are available via frame_info(). A
+ * sequence that lacks the index, e.g. because recording was interrupted,
+ * can still be read, the number of images is then derived from the file
+ * size.
  * @author Tim Niemueller
  */
 
@@ -43,8 +51,10 @@ namespace firevision {
  */
 FvRawReader::FvRawReader(const char *filename)
 {
-	opened = false;
-	buffer = NULL;
+	opened      = false;
+	buffer      = NULL;
+	frame_count = 0;
+	cur_frame   = 0;
 
 	infile = fopen(filename, "r");
 
@@ -53,13 +63,16 @@ FvRawReader::FvRawReader(const char *filename)
 	}
 
 	if (fread((char *)&header, sizeof(header), 1, infile) != 1) {
+		fclose(infile);
 		throw Exception("Could not read header");
 	} else {
 		if (header.file_id != FvRawWriter::FILE_IDENTIFIER) {
-			throw("Invalid file identifier");
+			fclose(infile);
+			throw Exception("Invalid file identifier");
 		} else {
 			buffer_size = colorspace_buffer_size(header.colorspace, header.width, header.height);
-			opened      = true;
+			read_index();
+			opened = true;
 		}
 	}
 }
@@ -71,6 +84,46 @@ FvRawReader::~FvRawReader()
 	opened = false;
 }
 
+/** Determine number of frames and read sequence index, if any. */
+void
+FvRawReader::read_index()
+{
+	if ((buffer_size == 0) || (fseeko(infile, 0, SEEK_END) != 0)) {
+		frame_count = (buffer_size == 0) ? 0 : 1;
+		return;
+	}
+	const uint64_t file_size = ftello(infile);
+	const uint64_t data_size = file_size - sizeof(header);
+
+	FvRawWriter::FvRawSequenceTrailer trailer;
+	trailer.sequence_id = 0;
+	if ((data_size >= sizeof(trailer))
+	    && (fseeko(infile, file_size - sizeof(trailer), SEEK_SET) == 0)
+	    && (fread(&trailer, sizeof(trailer), 1, infile) == 1)
+	    && (trailer.sequence_id == FvRawWriter::SEQUENCE_IDENTIFIER)
+	    && (trailer.index_offset == sizeof(header) + (uint64_t)trailer.num_frames * buffer_size)
+	    && (trailer.index_offset + trailer.num_frames * sizeof(FvRawWriter::FvRawFrameInfo)
+	          + sizeof(trailer)
+	        == file_size)) {
+		index.resize(trailer.num_frames);
+		if ((trailer.num_frames > 0)
+		    && ((fseeko(infile, trailer.index_offset, SEEK_SET) != 0)
+		        || (fread(&index[0], sizeof(FvRawWriter::FvRawFrameInfo), trailer.num_frames, infile)
+		            != trailer.num_frames))) {
+			index.clear();
+		}
+	}
+
+	if (!index.empty()) {
+		frame_count = index.size();
+	} else {
+		// single image or sequence without index
+		frame_count = data_size / buffer_size;
+	}
+
+	fseeko(infile, sizeof(header), SEEK_SET);
+}
+
 void
 FvRawReader::set_buffer(unsigned char *yuv422planar_buffer)
 {
@@ -116,10 +169,72 @@ FvRawReader::read()
 	if (buffer_size == 0) {
 		throw Exception("Read failed: buffer_size == 0");
 	}
+	if (cur_frame >= frame_count) {
+		throw Exception("Read failed: no more images (%u images in file)", frame_count);
+	}
 
 	if (fread(buffer, buffer_size, 1, infile) != 1) {
 		throw Exception("Failed to read data", errno);
 	}
+	++cur_frame;
+}
+
+/** Get number of images.
+ * @return number of images in file, 1 for a file with a single image
+ */
+unsigned int
+FvRawReader::num_frames() const
+{
+	return frame_count;
+}
+
+/** Get current image number.
+ * @return number of the image read by the next call to read(), starting at 0
+ */
+unsigned int
+FvRawReader::current_frame() const
+{
+	return cur_frame;
+}
+
+/** Seek to image.
+ * @param frame number of image to read next, starting at 0
+ */
+void
+FvRawReader::seek(unsigned int frame)
+{
+	if (frame >= frame_count) {
+		throw OutOfBoundsException("FvRaw image number", frame, 0, frame_count - 1);
+	}
+	if (fseeko(infile, sizeof(header) + (uint64_t)frame * buffer_size, SEEK_SET) != 0) {
+		throw Exception(errno, "Failed to seek to image %u", frame);
+	}
+	cur_frame = frame;
+}
+
+/** Check if the file has a sequence index.
+ * @return true if the file is an image sequence with an index, false otherwise
+ */
+bool
+FvRawReader::has_index() const
+{
+	return !index.empty();
+}
+
+/** Get index information about an image.
+ * @param frame number of image, starting at 0
+ * @param info upon return contains sequence number and capture time of image
+ * @return true if the information is available, false if the file has no
+ * index or the image number is out of range
+ */
+bool
+FvRawReader::frame_info(unsigned int frame, FvRawWriter::FvRawFrameInfo &info) const
+{
+	if (frame >= index.size()) {
+		return false;
+	}
+	info = index[frame];
+	return true;
 }
 
 /** Check if given file contains FvRaw image.
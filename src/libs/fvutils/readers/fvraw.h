@@ -28,6 +28,7 @@
 #include <fvutils/writers/fvraw.h>
 
 #include <cstdio>
+#include <vector>
 
 namespace firevision {
 
@@ -43,8 +44,17 @@ public:
 	virtual unsigned int pixel_height();
 	virtual void         read();
 
+	unsigned int num_frames() const;
+	unsigned int current_frame() const;
+	void         seek(unsigned int frame);
+	bool         has_index() const;
+	bool         frame_info(unsigned int frame, FvRawWriter::FvRawFrameInfo &info) const;
+
 	static bool is_FvRaw(const char *filename);
 
+private:
+	void read_index();
+
 private:
 	bool           opened;
 	unsigned char *buffer;
@@ -53,6 +63,10 @@ private:
 	unsigned int buffer_size;
 
 	FvRawWriter::FvRawHeader header;
+
+	unsigned int                             frame_count;
+	unsigned int                             cur_frame;
+	std::vector<FvRawWriter::FvRawFrameInfo> index;
 };
 
 } // end namespace firevision
@@ -314,6 +314,30 @@ Histogram::add(unsigned int x, unsigned int y, unsigned int z, unsigned int valu
 	undo_overlay[undo_current][index] = value;
 }
 
+/** Add values to all cells of the histogram.
+ * This adds the values of a whole histogram at once, e.g. as accumulated
+ * by YuvHistogramAccumulator. The added values are recorded in the current
+ * undo buffer.
+ * @param values array of width * height * depth values in the same memory
+ * layout as the histogram data
+ */
+void
+Histogram::add(const unsigned int *values)
+{
+	const unsigned int num     = width * height * depth;
+	unsigned int      *overlay = undo_overlay[undo_current];
+	unsigned int       sum     = 0;
+
+	for (unsigned int i = 0; i < num; ++i) {
+		histogram[i] += values[i];
+		overlay[i] += values[i];
+		sum += values[i];
+	}
+
+	number_of_values += sum;
+	undo_num_vals[undo_current] += sum;
+}
+
 /** Substract value from value in histogram at given location.
  * @param x x coordinate in histogram
  * @param y y coordinate in histogram
@@ -502,17 +526,12 @@ Histogram::get_median()
 unsigned int
 Histogram::get_average()
 {
-	unsigned int sum = 0;
-	unsigned int num = 0;
-	for (unsigned int z = 0; z < depth; ++z) {
-		for (unsigned int y = 0; y < height; ++y) {
-			for (unsigned int x = 0; x < width; ++x) {
-				if (histogram[z * width * height + y * width + x]) {
-					sum += histogram_block->get_value(x, y, z);
-					num++;
-				}
-			}
-		}
+	const unsigned int num_cells = width * height * depth;
+	unsigned int       sum       = 0;
+	unsigned int       num       = 0;
+	for (unsigned int i = 0; i < num_cells; ++i) {
+		sum += histogram[i];
+		num += (histogram[i] != 0);
 	}
 
 	return (sum / num);
@@ -524,15 +543,10 @@ Histogram::get_average()
 unsigned int
 Histogram::get_sum() const
 {
-	unsigned int sum = 0;
-	for (unsigned int z = 0; z < depth; ++z) {
-		for (unsigned int y = 0; y < height; ++y) {
-			for (unsigned int x = 0; x < width; ++x) {
-				if (histogram[z * width * height + y * width + x]) {
-					sum += histogram_block->get_value(x, y, z);
-				}
-			}
-		}
+	const unsigned int num_cells = width * height * depth;
+	unsigned int       sum       = 0;
+	for (unsigned int i = 0; i < num_cells; ++i) {
+		sum += histogram[i];
 	}
 
 	return sum;
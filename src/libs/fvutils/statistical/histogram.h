@@ -54,6 +54,7 @@ public:
 	void            set_value(unsigned int x, unsigned int y, unsigned int z, unsigned int value);
 	void            inc_value(unsigned int x, unsigned int y, unsigned int z = 0);
 	void            add(unsigned int x, unsigned int y, unsigned int z, unsigned int value);
+	void            add(const unsigned int *values);
 	void            sub(unsigned int x, unsigned int y, unsigned int z, unsigned int value);
 	void            reset();
 	unsigned int    get_median();
@@ -21,15 +21,68 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <fvutils/base/roi.h>
+#include <fvutils/color/colorspaces.h>
 #include <fvutils/color/yuv.h>
 #include <fvutils/statistical/imagediff.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
 
 namespace firevision {
 
+/// @cond INTERNALS
+/** Count differing pixels in consecutive pixel pairs.
+ * Each pair of pixels shares the U and V values. With SSE2 32 pixels are
+ * compared per iteration.
+ */
+static unsigned int
+count_differing_pixel_pairs(const unsigned char *y_a,
+                            const unsigned char *y_b,
+                            const unsigned char *u_a,
+                            const unsigned char *u_b,
+                            const unsigned char *v_a,
+                            const unsigned char *v_b,
+                            unsigned int         num_pairs)
+{
+	unsigned int num = 0;
+	unsigned int i   = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= num_pairs; i += 16) {
+		__m128i uv_eq = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(u_a + i)),
+		                                             _mm_loadu_si128((const __m128i *)(u_b + i))),
+		                              _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(v_a + i)),
+		                                             _mm_loadu_si128((const __m128i *)(v_b + i))));
+		__m128i y_eq_lo = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(y_a + 2 * i)),
+		                                 _mm_loadu_si128((const __m128i *)(y_b + 2 * i)));
+		__m128i y_eq_hi = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(y_a + 2 * i + 16)),
+		                                 _mm_loadu_si128((const __m128i *)(y_b + 2 * i + 16)));
+		// duplicate U/V comparison results for both pixels of a pair
+		__m128i eq_lo = _mm_and_si128(y_eq_lo, _mm_unpacklo_epi8(uv_eq, uv_eq));
+		__m128i eq_hi = _mm_and_si128(y_eq_hi, _mm_unpackhi_epi8(uv_eq, uv_eq));
+		num += 32 - __builtin_popcount(_mm_movemask_epi8(eq_lo))
+		       - __builtin_popcount(_mm_movemask_epi8(eq_hi));
+	}
+#endif
+	for (; i < num_pairs; ++i) {
+		bool uv_differ = (u_a[i] != u_b[i]) || (v_a[i] != v_b[i]);
+		num += (uv_differ || (y_a[2 * i] != y_b[2 * i])) ? 1 : 0;
+		num += (uv_differ || (y_a[2 * i + 1] != y_b[2 * i + 1])) ? 1 : 0;
+	}
+	return num;
+}
+/// @endcond
+
 /** @class ImageDiff <fvutils/statistical/imagediff.h>
  * Image difference checker.
+ * Without a scanline model the images are compared line by line on the raw
+ * Y, U and V planes, optionally restricted to a region of interest. Checking
+ * for any difference stops at the first differing block, counting differing
+ * pixels compares many pixels at once using SSE2 if available.
  * @author Tim Niemueller
  */
 
@@ -40,6 +93,9 @@ namespace firevision {
 ImageDiff::ImageDiff(ScanlineModel *scanline_model)
 {
 	this->scanline_model = scanline_model;
+	roi                  = NULL;
+	buffer_a = buffer_b = NULL;
+	width_a = height_a = width_b = height_b = 0;
 }
 
 /** Constructor.
@@ -48,6 +104,9 @@ ImageDiff::ImageDiff(ScanlineModel *scanline_model)
 ImageDiff::ImageDiff()
 {
 	scanline_model = NULL;
+	roi            = NULL;
+	buffer_a = buffer_b = NULL;
+	width_a = height_a = width_b = height_b = 0;
 }
 
 /** Destructor. */
@@ -81,6 +140,41 @@ ImageDiff::setBufferB(unsigned char *yuv422planar_buffer, unsigned int width, un
 	height_b = height;
 }
 
+/** Set region of interest.
+ * If set and no scanline model is used only pixels within the region of
+ * interest are compared.
+ * @param roi region of interest, NULL to compare the full image
+ */
+void
+ImageDiff::setROI(const ROI *roi)
+{
+	this->roi = roi;
+}
+
+/** Get area to compare.
+ * @param start_x upon return contains first column to compare
+ * @param end_x upon return contains column after the last column to compare
+ * @param start_y upon return contains first line to compare
+ * @param end_y upon return contains line after the last line to compare
+ */
+void
+ImageDiff::get_area(unsigned int &start_x,
+                    unsigned int &end_x,
+                    unsigned int &start_y,
+                    unsigned int &end_y)
+{
+	if (roi) {
+		start_x = std::min(roi->start.x, width_a);
+		start_y = std::min(roi->start.y, height_a);
+		end_x   = std::min(roi->start.x + roi->width, width_a);
+		end_y   = std::min(roi->start.y + roi->height, height_a);
+	} else {
+		start_x = start_y = 0;
+		end_x             = width_a;
+		end_y             = height_a;
+	}
+}
+
 /** Check if images are different.
  * This method will compare the two images. If any pixel marked by
  * the scanline or any pixel at all if no scanline model is given
@@ -117,19 +211,37 @@ ImageDiff::different()
 			if ((y_a != y_b) || (u_a != u_b) || (v_a != v_b)) {
 				return true;
 			}
+			++(*scanline_model);
 		}
 	} else {
 		// no scanline model, check every single pixel
+		unsigned int start_x, end_x, start_y, end_y;
+		get_area(start_x, end_x, start_y, end_y);
+		if ((start_x >= end_x) || (start_y >= end_y))
+			return false;
+
+		if (!roi || ((end_x - start_x == width_a) && (end_y - start_y == height_a))) {
+			return (memcmp(buffer_a,
+			               buffer_b,
+			               colorspace_buffer_size(YUV422_PLANAR, width_a, height_a))
+			        != 0);
+		}
 
-		unsigned char *ypa = buffer_a;
-		unsigned char *ypb = buffer_b;
+		const unsigned char *u_a = YUV422_PLANAR_U_PLANE(buffer_a, width_a, height_a);
+		const unsigned char *u_b = YUV422_PLANAR_U_PLANE(buffer_b, width_b, height_b);
+		const unsigned char *v_a = YUV422_PLANAR_V_PLANE(buffer_a, width_a, height_a);
+		const unsigned char *v_b = YUV422_PLANAR_V_PLANE(buffer_b, width_b, height_b);
 
-		for (unsigned int i = 0; i < (width_a * height_a); ++i) {
-			if (*ypa != *ypb) {
+		for (unsigned int y = start_y; y < end_y; ++y) {
+			const unsigned int line     = y * width_a;
+			const unsigned int uv_start = (line + start_x) / 2;
+			const unsigned int uv_len   = (line + end_x - 1) / 2 - uv_start + 1;
+
+			if ((memcmp(buffer_a + line + start_x, buffer_b + line + start_x, end_x - start_x) != 0)
+			    || (memcmp(u_a + uv_start, u_b + uv_start, uv_len) != 0)
+			    || (memcmp(v_a + uv_start, v_b + uv_start, uv_len) != 0)) {
 				return true;
 			}
-			++ypa;
-			++ypb;
 		}
 	}
 
@@ -172,16 +284,47 @@ ImageDiff::numDifferingPixels()
 			if ((y_a != y_b) || (u_a != u_b) || (v_a != v_b)) {
 				++num;
 			}
+			++(*scanline_model);
 		}
 	} else {
 		// no scanline model, check every single pixel
+		unsigned int start_x, end_x, start_y, end_y;
+		get_area(start_x, end_x, start_y, end_y);
 
-		unsigned char *ypa = buffer_a;
-		unsigned char *ypb = buffer_b;
+		const unsigned char *u_a = YUV422_PLANAR_U_PLANE(buffer_a, width_a, height_a);
+		const unsigned char *u_b = YUV422_PLANAR_U_PLANE(buffer_b, width_b, height_b);
+		const unsigned char *v_a = YUV422_PLANAR_V_PLANE(buffer_a, width_a, height_a);
+		const unsigned char *v_b = YUV422_PLANAR_V_PLANE(buffer_b, width_b, height_b);
 
-		for (unsigned int i = 0; i < (width_a * height_a); ++i) {
-			if (*ypa++ != *ypb++)
-				++num;
+		for (unsigned int y = start_y; y < end_y; ++y) {
+			unsigned int i   = y * width_a + start_x;
+			unsigned int end = y * width_a + end_x;
+
+			// leading pixel which does not share U/V with its right neighbour in the ROI
+			if ((i < end) && (i % 2 == 1)) {
+				if ((buffer_a[i] != buffer_b[i]) || (u_a[i / 2] != u_b[i / 2])
+				    || (v_a[i / 2] != v_b[i / 2])) {
+					++num;
+				}
+				++i;
+			}
+
+			unsigned int num_pairs = (end - i) / 2;
+			num += count_differing_pixel_pairs(buffer_a + i,
+			                                   buffer_b + i,
+			                                   u_a + i / 2,
+			                                   u_b + i / 2,
+			                                   v_a + i / 2,
+			                                   v_b + i / 2,
+			                                   num_pairs);
+			i += 2 * num_pairs;
+
+			if (i < end) {
+				if ((buffer_a[i] != buffer_b[i]) || (u_a[i / 2] != u_b[i / 2])
+				    || (v_a[i / 2] != v_b[i / 2])) {
+					++num;
+				}
+			}
 		}
 	}
 	return num;
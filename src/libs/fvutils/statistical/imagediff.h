@@ -29,6 +29,8 @@
 
 namespace firevision {
 
+class ROI;
+
 class ImageDiff
 {
 public:
@@ -40,11 +42,20 @@ public:
 
 	void setBufferB(unsigned char *yuv422planar_buffer, unsigned int width, unsigned int height);
 
+	void setROI(const ROI *roi);
+
 	bool         different();
 	unsigned int numDifferingPixels();
 
+private:
+	void get_area(unsigned int &start_x,
+	              unsigned int &end_x,
+	              unsigned int &start_y,
+	              unsigned int &end_y);
+
 private:
 	ScanlineModel *scanline_model;
+	const ROI     *roi;
 
 	unsigned char *buffer_a;
 	unsigned char *buffer_b;
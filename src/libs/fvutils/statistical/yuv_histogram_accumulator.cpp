@@ -0,0 +1,265 @@
+
+/***************************************************************************
+ *  yuv_histogram_accumulator.cpp - Fast YUV histogram accumulation
+ *
+ *  Created: Sun Oct 18 16:12:40 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <fvutils/base/roi.h>
+#include <fvutils/color/yuv.h>
+#include <fvutils/statistical/histogram.h>
+#include <fvutils/statistical/yuv_histogram_accumulator.h>
+
+#include <algorithm>
+#ifdef _OPENMP
+#	include <omp.h>
+#endif
+
+namespace firevision {
+
+/** @class YuvHistogramAccumulator <fvutils/statistical/yuv_histogram_accumulator.h>
+ * Fast YUV histogram accumulation.
+ * Accumulates the colors of a YUV422_PLANAR image into a 3D histogram with
+ * the U value on the x axis, the V value on the y axis and the Y value on the
+ * z axis, as used for colormap generation. The bin of each channel value is
+ * precomputed into lookup tables, so the per-pixel work is reduced to three
+ * table lookups and an increment on a plain array. Images are traversed
+ * line by line and accumulation may be restricted to a region of interest.
+ *
+ * If compiled with OpenMP support the image lines are split among several
+ * threads. Each thread counts into its own private bins, which are merged
+ * once all lines have been processed, and only then added to the histogram.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param u_bins number of bins for the U channel, i.e. width of histogram
+ * @param v_bins number of bins for the V channel, i.e. height of histogram
+ * @param y_bins number of bins for the Y channel, i.e. depth of histogram
+ */
+YuvHistogramAccumulator::YuvHistogramAccumulator(unsigned int u_bins,
+                                                 unsigned int v_bins,
+                                                 unsigned int y_bins)
+{
+	if ((u_bins == 0) || (v_bins == 0) || (y_bins == 0) || (u_bins > 256) || (v_bins > 256)
+	    || (y_bins > 256)) {
+		throw fawkes::Exception("Number of bins must be in range [1, 256], got %ux%ux%u",
+		                        u_bins,
+		                        v_bins,
+		                        y_bins);
+	}
+
+	u_bins_   = u_bins;
+	v_bins_   = v_bins;
+	y_bins_   = y_bins;
+	num_bins_ = u_bins * v_bins * y_bins;
+
+	// same binning as previously done per pixel in the colormap generators
+	for (unsigned int i = 0; i < 256; ++i) {
+		u_index_[i] = (unsigned int)(i / 256.0f * float(u_bins));
+		v_index_[i] = (unsigned int)(i / 256.0f * float(v_bins)) * u_bins;
+		y_index_[i] = (unsigned int)(i / 256.0f * float(y_bins)) * u_bins * v_bins;
+	}
+
+#ifdef _OPENMP
+	num_threads_ = omp_get_max_threads();
+#else
+	num_threads_ = 1;
+#endif
+}
+
+/** Destructor. */
+YuvHistogramAccumulator::~YuvHistogramAccumulator()
+{
+}
+
+/** Set number of threads.
+ * Without OpenMP support accumulation always runs in the calling thread.
+ * @param num_threads maximum number of threads to use for accumulation,
+ * 0 to use the OpenMP default
+ */
+void
+YuvHistogramAccumulator::set_num_threads(unsigned int num_threads)
+{
+#ifdef _OPENMP
+	num_threads_ = (num_threads == 0) ? omp_get_max_threads() : num_threads;
+#else
+	num_threads_ = 1;
+#endif
+}
+
+/** Accumulate image.
+ * @param yuv422_planar_buffer image buffer in YUV422_PLANAR colorspace
+ * @param width width of image in pixels
+ * @param height height of image in pixels
+ * @param histogram histogram to add pixel colors to, the dimensions must
+ * match the number of bins of this accumulator
+ * @param roi if not NULL only pixels in this region of interest are considered
+ */
+void
+YuvHistogramAccumulator::accumulate(const unsigned char *yuv422_planar_buffer,
+                                    unsigned int         width,
+                                    unsigned int         height,
+                                    Histogram           *histogram,
+                                    const ROI           *roi)
+{
+	check_histogram(histogram);
+	accumulate_bins(yuv422_planar_buffer, width, height, NULL, roi, histogram, NULL);
+}
+
+/** Accumulate image split by mask.
+ * Pixels for which the mask is set are added to the first histogram, all
+ * other pixels to the second.
+ * @param yuv422_planar_buffer image buffer in YUV422_PLANAR colorspace
+ * @param width width of image in pixels
+ * @param height height of image in pixels
+ * @param mask selection mask with one entry per pixel
+ * @param in_histogram histogram for pixels in the mask
+ * @param out_histogram histogram for pixels not in the mask
+ * @param roi if not NULL only pixels in this region of interest are considered
+ */
+void
+YuvHistogramAccumulator::accumulate(const unsigned char *yuv422_planar_buffer,
+                                    unsigned int         width,
+                                    unsigned int         height,
+                                    const bool          *mask,
+                                    Histogram           *in_histogram,
+                                    Histogram           *out_histogram,
+                                    const ROI           *roi)
+{
+	check_histogram(in_histogram);
+	check_histogram(out_histogram);
+	accumulate_bins(yuv422_planar_buffer, width, height, mask, roi, in_histogram, out_histogram);
+}
+
+void
+YuvHistogramAccumulator::check_histogram(Histogram *histogram)
+{
+	unsigned int width, height, depth;
+	histogram->get_dimensions(width, height, depth);
+	if ((width != u_bins_) || (height != v_bins_) || (depth != y_bins_)) {
+		throw fawkes::Exception("Histogram dimensions %ux%ux%u do not match bins %ux%ux%u",
+		                        width,
+		                        height,
+		                        depth,
+		                        u_bins_,
+		                        v_bins_,
+		                        y_bins_);
+	}
+}
+
+void
+YuvHistogramAccumulator::accumulate_bins(const unsigned char *yuv422_planar_buffer,
+                                         unsigned int         width,
+                                         unsigned int         height,
+                                         const bool          *mask,
+                                         const ROI           *roi,
+                                         Histogram           *in_histogram,
+                                         Histogram           *out_histogram)
+{
+	unsigned int start_x = 0, end_x = width;
+	unsigned int start_y = 0, end_y = height;
+	if (roi) {
+		start_x = std::min(roi->start.x, width);
+		start_y = std::min(roi->start.y, height);
+		end_x   = std::min(roi->start.x + roi->width, width);
+		end_y   = std::min(roi->start.y + roi->height, height);
+	}
+	if ((start_x >= end_x) || (start_y >= end_y))
+		return;
+
+	const unsigned int num_rows    = end_y - start_y;
+	const unsigned int num_sets    = mask ? 2 : 1;
+	const unsigned int set_size    = num_sets * num_bins_;
+	const unsigned int num_threads = std::min(num_threads_, num_rows);
+
+	bins_.assign((size_t)num_threads * set_size, 0);
+
+#ifdef _OPENMP
+#	pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+#endif
+	for (unsigned int t = 0; t < num_threads; ++t) {
+		unsigned int *bins = &bins_[(size_t)t * set_size];
+		accumulate_rows(yuv422_planar_buffer,
+		                width,
+		                height,
+		                mask,
+		                start_x,
+		                end_x,
+		                start_y + (unsigned int)((size_t)num_rows * t / num_threads),
+		                start_y + (unsigned int)((size_t)num_rows * (t + 1) / num_threads),
+		                bins,
+		                mask ? bins + num_bins_ : NULL);
+	}
+
+	// merge private bins of all threads into the first set
+	unsigned int *merged = &bins_[0];
+	for (unsigned int t = 1; t < num_threads; ++t) {
+		const unsigned int *bins = &bins_[(size_t)t * set_size];
+		for (unsigned int i = 0; i < set_size; ++i) {
+			merged[i] += bins[i];
+		}
+	}
+
+	in_histogram->add(merged);
+	if (mask) {
+		out_histogram->add(merged + num_bins_);
+	}
+}
+
+void
+YuvHistogramAccumulator::accumulate_rows(const unsigned char *yuv422_planar_buffer,
+                                         unsigned int         width,
+                                         unsigned int         height,
+                                         const bool          *mask,
+                                         unsigned int         start_x,
+                                         unsigned int         end_x,
+                                         unsigned int         start_y,
+                                         unsigned int         end_y,
+                                         unsigned int        *in_bins,
+                                         unsigned int        *out_bins)
+{
+	const unsigned char *u_plane = YUV422_PLANAR_U_PLANE(yuv422_planar_buffer, width, height);
+	const unsigned char *v_plane = YUV422_PLANAR_V_PLANE(yuv422_planar_buffer, width, height);
+
+	unsigned int *bins[2] = {out_bins, in_bins};
+
+	for (unsigned int y = start_y; y < end_y; ++y) {
+		const unsigned int   line = y * width;
+		const unsigned char *yp   = yuv422_planar_buffer + line;
+
+		if (mask) {
+			const bool *mp = mask + line;
+			for (unsigned int x = start_x; x < end_x; ++x) {
+				const unsigned int uv    = (line + x) / 2;
+				const unsigned int index = u_index_[u_plane[uv]] + v_index_[v_plane[uv]] + y_index_[yp[x]];
+				bins[mp[x] ? 1 : 0][index] += 1;
+			}
+		} else {
+			for (unsigned int x = start_x; x < end_x; ++x) {
+				const unsigned int uv    = (line + x) / 2;
+				const unsigned int index = u_index_[u_plane[uv]] + v_index_[v_plane[uv]] + y_index_[yp[x]];
+				in_bins[index] += 1;
+			}
+		}
+	}
+}
+
+} // end namespace firevision
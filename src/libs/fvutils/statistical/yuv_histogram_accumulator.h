@@ -0,0 +1,92 @@
+
+/***************************************************************************
+ *  yuv_histogram_accumulator.h - Fast YUV histogram accumulation
+ *
+ *  Created: Sun Oct 18 16:12:40 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FVUTILS_STATISTICAL_YUV_HISTOGRAM_ACCUMULATOR_H_
+#define _FIREVISION_FVUTILS_STATISTICAL_YUV_HISTOGRAM_ACCUMULATOR_H_
+
+#include <vector>
+
+namespace firevision {
+
+class Histogram;
+class ROI;
+
+class YuvHistogramAccumulator
+{
+public:
+	YuvHistogramAccumulator(unsigned int u_bins, unsigned int v_bins, unsigned int y_bins = 1);
+	~YuvHistogramAccumulator();
+
+	void set_num_threads(unsigned int num_threads);
+
+	void accumulate(const unsigned char *yuv422_planar_buffer,
+	                unsigned int         width,
+	                unsigned int         height,
+	                Histogram           *histogram,
+	                const ROI           *roi = 0);
+
+	void accumulate(const unsigned char *yuv422_planar_buffer,
+	                unsigned int         width,
+	                unsigned int         height,
+	                const bool          *mask,
+	                Histogram           *in_histogram,
+	                Histogram           *out_histogram,
+	                const ROI           *roi = 0);
+
+private:
+	void check_histogram(Histogram *histogram);
+	void accumulate_rows(const unsigned char *yuv422_planar_buffer,
+	                     unsigned int         width,
+	                     unsigned int         height,
+	                     const bool          *mask,
+	                     unsigned int         start_x,
+	                     unsigned int         end_x,
+	                     unsigned int         start_y,
+	                     unsigned int         end_y,
+	                     unsigned int        *in_bins,
+	                     unsigned int        *out_bins);
+	void accumulate_bins(const unsigned char *yuv422_planar_buffer,
+	                     unsigned int         width,
+	                     unsigned int         height,
+	                     const bool          *mask,
+	                     const ROI           *roi,
+	                     Histogram           *in_histogram,
+	                     Histogram           *out_histogram);
+
+private:
+	unsigned int u_bins_;
+	unsigned int v_bins_;
+	unsigned int y_bins_;
+	unsigned int num_bins_;
+	unsigned int num_threads_;
+
+	unsigned int u_index_[256];
+	unsigned int v_index_[256];
+	unsigned int y_index_[256];
+
+	std::vector<unsigned int> bins_;
+};
+
+} // end namespace firevision
+
+#endif
@@ -0,0 +1,630 @@
+
+/***************************************************************************
+ *  async_seq_writer.cpp - Write image sequences in the background
+ *
+ *  Created: Sun Oct 18 19:12:31 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/exceptions/software.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/writers/async_seq_writer.h>
+#include <fvutils/writers/seq_writer.h>
+#include <fvutils/writers/writer.h>
+
+#include <cerrno>
+#include <cstdlib>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/// @cond INTERNALS
+class AsyncSeqWriter::Frame
+{
+public:
+	unsigned long int          order;
+	unsigned long int          seqnum;
+	fawkes::Time               capture_time;
+	unsigned int               width;
+	unsigned int               height;
+	colorspace_t               cspace;
+	std::vector<unsigned char> buffer;
+	std::vector<unsigned char> converted;
+	bool                       failed;
+};
+
+class AsyncSeqWriter::EncoderThread : public fawkes::Thread
+{
+public:
+	EncoderThread(AsyncSeqWriter *seq_writer, Writer *writer, unsigned int id)
+	: Thread("AsyncSeqWriterEncoder", Thread::OPMODE_CONTINUOUS)
+	{
+		set_name("AsyncSeqWriterEncoder-%u", id);
+		seq_writer_ = seq_writer;
+		writer_     = writer;
+	}
+
+	virtual ~EncoderThread()
+	{
+		delete writer_;
+	}
+
+	virtual void
+	loop()
+	{
+		seq_writer_->encode_next(writer_);
+	}
+
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	AsyncSeqWriter *seq_writer_;
+	Writer         *writer_;
+};
+/// @endcond
+
+/** @class AsyncSeqWriter <fvutils/writers/async_seq_writer.h>
+ * Write image sequences in the background.
+ * In contrast to SeqWriter, which encodes and writes each image in the
+ * calling thread, this writer only copies the image into a bounded queue
+ * and returns immediately. A pool of encoder threads takes images from the
+ * queue and writes them.
+ *
+ * The writer operates in one of two modes, chosen by the constructor. It
+ * either writes every image to an individual file, named just like those
+ * written by SeqWriter, using a writer per encoder thread created by the
+ * given factory, or it appends all images to a single FvRaw image sequence.
+ * For sequences the encoder threads only convert images to the colorspace
+ * of the sequence, if necessary, and images are appended in the order in
+ * which they were passed to write(). The sequence contains an index with
+ * the sequence number and capture time of each image and can be played
+ * back with FvRawReader or FileLoader, including seeking.
+ *
+ * Every image passed to write() gets a new sequence number, starting at 1.
+ * If the queue is full, write() either drops the image or, if blocking has
+ * been enabled, waits for a free slot. Dropped images leave a gap in the
+ * sequence numbers. Errors that occur in encoder threads are reported by
+ * the next call to flush() or close().
+ *
+ * Images must be passed from a single thread and the path, file name,
+ * dimensions and colorspace must not be changed while images are pending.
+ * @author Tim Niemueller
+ */
+
+/** Constructor for writing individual files.
+ * @param writer_factory function creating a new writer, called once per
+ * encoder thread, the writers are deleted on destruction
+ * @param num_encoders number of encoder threads
+ * @param queue_length maximum number of images waiting to be written
+ */
+AsyncSeqWriter::AsyncSeqWriter(const WriterFactory &writer_factory,
+                               unsigned int         num_encoders,
+                               unsigned int         queue_length)
+: writer_factory_(writer_factory)
+{
+	sequence_cspace_ = CS_UNKNOWN;
+	start_encoders(num_encoders, queue_length);
+}
+
+/** Constructor for writing an image sequence.
+ * @param sequence_filename name of FvRaw sequence file to write, an existing
+ * file is overwritten once the first image is written
+ * @param sequence_colorspace colorspace to store images in, CS_UNKNOWN to
+ * store them in the colorspace they are passed in
+ * @param num_encoders number of encoder threads converting images
+ * @param queue_length maximum number of images waiting to be written
+ */
+AsyncSeqWriter::AsyncSeqWriter(const char  *sequence_filename,
+                               colorspace_t sequence_colorspace,
+                               unsigned int num_encoders,
+                               unsigned int queue_length)
+: sequence_filename_(sequence_filename)
+{
+	sequence_cspace_ = sequence_colorspace;
+	start_encoders(num_encoders, queue_length);
+}
+
+/** Destructor.
+ * Waits for all pending images to be written and closes the writer.
+ */
+AsyncSeqWriter::~AsyncSeqWriter()
+{
+	try {
+		close();
+	} catch (Exception &e) {
+	} // ignored, cannot report errors anymore
+
+	// the wait condition does not release the queue mutex if an encoder
+	// thread is cancelled while waiting, therefore let them return first
+	queue_mutex_->lock();
+	stopping_ = true;
+	queue_waitcond_->wake_all();
+	queue_mutex_->unlock();
+
+	for (EncoderThread *t : encoders_) {
+		t->cancel();
+		t->join();
+		delete t;
+	}
+	for (Frame *f : frames_) {
+		delete f;
+	}
+	delete error_;
+	delete queue_waitcond_;
+	delete queue_mutex_;
+}
+
+/** Initialize queue and start encoder threads.
+ * @param num_encoders number of encoder threads
+ * @param queue_length number of images in the queue
+ */
+void
+AsyncSeqWriter::start_encoders(unsigned int num_encoders, unsigned int queue_length)
+{
+	if (num_encoders == 0) {
+		throw OutOfBoundsException("Number of encoder threads", num_encoders, 1, 0xFFFFFFFF);
+	}
+	if (queue_length == 0) {
+		throw OutOfBoundsException("Queue length", queue_length, 1, 0xFFFFFFFF);
+	}
+
+	width_             = 0;
+	height_            = 0;
+	cspace_            = CS_UNKNOWN;
+	blocking_          = false;
+	num_encoding_      = 0;
+	outputting_        = false;
+	closed_            = false;
+	stopping_          = false;
+	next_order_        = 0;
+	next_output_order_ = 0;
+	seqnum_            = 0;
+	num_written_       = 0;
+	num_dropped_       = 0;
+	error_             = NULL;
+	sequence_file_     = NULL;
+
+	queue_mutex_    = new Mutex();
+	queue_waitcond_ = new WaitCondition(queue_mutex_);
+
+	for (unsigned int i = 0; i < queue_length; ++i) {
+		frames_.push_back(new Frame());
+	}
+	free_frames_ = frames_;
+
+	for (unsigned int i = 0; i < num_encoders; ++i) {
+		Writer *writer = sequence_filename_.empty() ? writer_factory_() : NULL;
+		encoders_.push_back(new EncoderThread(this, writer, i));
+	}
+	for (EncoderThread *t : encoders_) {
+		t->start();
+	}
+}
+
+/** Set the path to where the images are stored.
+ * Only used when writing individual files.
+ * @param img_path the image path
+ */
+void
+AsyncSeqWriter::set_path(const char *img_path)
+{
+	img_path_ = img_path;
+}
+
+/** Set a (base-) filename.
+ * Only used when writing individual files.
+ * @param filename the (base-) filename
+ * @see SeqWriter::set_filename()
+ */
+void
+AsyncSeqWriter::set_filename(const char *filename)
+{
+	filename_ = filename;
+}
+
+/** Set the image dimensions.
+ * The dimensions of a sequence cannot change once the first image has been
+ * written.
+ * @param width the width of the image
+ * @param height the height of the image
+ */
+void
+AsyncSeqWriter::set_dimensions(unsigned int width, unsigned int height)
+{
+	if (sequence_file_ && ((width != width_) || (height != height_))) {
+		throw Exception("Cannot change image dimensions of sequence %s", sequence_filename_.c_str());
+	}
+	width_  = width;
+	height_ = height;
+}
+
+/** Set the colorspace of the images passed to write().
+ * @param cspace the colorspace
+ */
+void
+AsyncSeqWriter::set_colorspace(colorspace_t cspace)
+{
+	cspace_ = cspace;
+}
+
+/** Set whether write() blocks if the queue is full.
+ * @param blocking true to wait for a free queue slot, false to drop images
+ * if the queue is full, this is the default
+ */
+void
+AsyncSeqWriter::set_blocking(bool blocking)
+{
+	MutexLocker lock(queue_mutex_);
+	blocking_ = blocking;
+	queue_waitcond_->wake_all();
+}
+
+/** Get free frame from queue.
+ * Must be called with the queue mutex locked.
+ * @return free frame, NULL if the queue is full and writing is non-blocking
+ */
+AsyncSeqWriter::Frame *
+AsyncSeqWriter::next_free_frame()
+{
+	while (free_frames_.empty()) {
+		if (!blocking_) {
+			return NULL;
+		}
+		queue_waitcond_->wait();
+	}
+	Frame *frame = free_frames_.back();
+	free_frames_.pop_back();
+	return frame;
+}
+
+/** Write image.
+ * Copies the image into the queue, it is written in the background.
+ * @param buffer image buffer with the dimensions and colorspace set before
+ * @param capture_time time the image was captured, if NULL the current time
+ * is used
+ * @return true if the image has been queued, false if it has been dropped
+ * because the queue was full
+ */
+bool
+AsyncSeqWriter::write(const unsigned char *buffer, const Time *capture_time)
+{
+	if ((width_ == 0) || (height_ == 0) || (cspace_ == CS_UNKNOWN)) {
+		throw Exception("Dimensions and colorspace must be set before writing");
+	}
+	if (closed_) {
+		throw Exception("Cannot write to closed sequence %s", sequence_filename_.c_str());
+	}
+	if (!sequence_filename_.empty() && !sequence_file_) {
+		open_sequence();
+	}
+
+	queue_mutex_->lock();
+	unsigned long int seqnum = ++seqnum_;
+	Frame            *frame  = next_free_frame();
+	if (!frame) {
+		++num_dropped_;
+		queue_mutex_->unlock();
+		return false;
+	}
+	queue_mutex_->unlock();
+
+	frame->seqnum = seqnum;
+	frame->width  = width_;
+	frame->height = height_;
+	frame->cspace = cspace_;
+	frame->failed = false;
+	if (capture_time) {
+		frame->capture_time = *capture_time;
+	} else {
+		frame->capture_time.stamp();
+	}
+	frame->buffer.assign(buffer, buffer + colorspace_buffer_size(cspace_, width_, height_));
+
+	queue_mutex_->lock();
+	frame->order = next_order_++;
+	pending_frames_.push_back(frame);
+	queue_waitcond_->wake_all();
+	queue_mutex_->unlock();
+
+	return true;
+}
+
+/** Encode next pending image.
+ * Called by encoder threads, blocks until an image is pending or the
+ * writer is being destroyed.
+ * @param writer writer of encoder thread, NULL when writing a sequence
+ */
+void
+AsyncSeqWriter::encode_next(Writer *writer)
+{
+	queue_mutex_->lock();
+	while (pending_frames_.empty() && !stopping_) {
+		queue_waitcond_->wait();
+	}
+	if (stopping_) {
+		queue_mutex_->unlock();
+		return;
+	}
+	Frame *frame = pending_frames_.front();
+	pending_frames_.pop_front();
+	++num_encoding_;
+	queue_mutex_->unlock();
+
+	encode(frame, writer);
+
+	queue_mutex_->lock();
+	--num_encoding_;
+	if (sequence_filename_.empty()) {
+		if (!frame->failed) {
+			++num_written_;
+		}
+		free_frames_.push_back(frame);
+	} else {
+		encoded_frames_[frame->order] = frame;
+		if (!outputting_) {
+			output_ordered();
+		}
+	}
+	queue_waitcond_->wake_all();
+	queue_mutex_->unlock();
+}
+
+/** Encode image.
+ * @param frame frame with image to encode
+ * @param writer writer to write individual file, NULL when writing a sequence
+ */
+void
+AsyncSeqWriter::encode(Frame *frame, Writer *writer)
+{
+	try {
+		if (writer) {
+			char *fn = SeqWriter::sequence_filename(img_path_.empty() ? NULL : img_path_.c_str(),
+			                                        filename_.empty() ? NULL : filename_.c_str(),
+			                                        frame->capture_time,
+			                                        frame->seqnum);
+			std::string filename(fn);
+			free(fn);
+
+			writer->set_filename(filename.c_str());
+			writer->set_dimensions(frame->width, frame->height);
+			writer->set_buffer(frame->cspace, &frame->buffer[0]);
+			writer->write();
+		} else if (frame->cspace != sequence_cspace_) {
+			frame->converted.resize(
+			  colorspace_buffer_size(sequence_cspace_, frame->width, frame->height));
+			convert(frame->cspace,
+			        sequence_cspace_,
+			        &frame->buffer[0],
+			        &frame->converted[0],
+			        frame->width,
+			        frame->height);
+		}
+	} catch (Exception &e) {
+		frame->failed = true;
+		e.append("Failed to write image %lu", frame->seqnum);
+		set_error(e);
+	}
+}
+
+/** Append encoded images to the sequence in order.
+ * Must be called with the queue mutex locked. Only one thread at a time
+ * appends images, while doing so the queue mutex is released.
+ */
+void
+AsyncSeqWriter::output_ordered()
+{
+	outputting_ = true;
+	while (!encoded_frames_.empty() && (encoded_frames_.begin()->first == next_output_order_)) {
+		Frame *frame = encoded_frames_.begin()->second;
+		encoded_frames_.erase(encoded_frames_.begin());
+
+		queue_mutex_->unlock();
+		append_to_sequence(frame);
+		queue_mutex_->lock();
+
+		++next_output_order_;
+		if (!frame->failed) {
+			++num_written_;
+		}
+		free_frames_.push_back(frame);
+		queue_waitcond_->wake_all();
+	}
+	outputting_ = false;
+}
+
+/** Open sequence file and write header. */
+void
+AsyncSeqWriter::open_sequence()
+{
+	if (sequence_cspace_ == CS_UNKNOWN) {
+		sequence_cspace_ = cspace_;
+	}
+
+	FILE *f = fopen(sequence_filename_.c_str(), "w");
+	if (f == NULL) {
+		throw Exception(errno, "Cannot open sequence %s for writing", sequence_filename_.c_str());
+	}
+
+	FvRawWriter::FvRawHeader header;
+	header.file_id    = FvRawWriter::FILE_IDENTIFIER;
+	header.colorspace = sequence_cspace_;
+	header.width      = width_;
+	header.height     = height_;
+	if (fwrite(&header, sizeof(header), 1, f) != 1) {
+		Exception e(errno, "Cannot write header of sequence %s", sequence_filename_.c_str());
+		fclose(f);
+		throw e;
+	}
+
+	sequence_file_ = f;
+}
+
+/** Append image to sequence.
+ * @param frame frame with encoded image
+ */
+void
+AsyncSeqWriter::append_to_sequence(Frame *frame)
+{
+	if (frame->failed)
+		return;
+
+	const unsigned char *data =
+	  (frame->cspace != sequence_cspace_) ? &frame->converted[0] : &frame->buffer[0];
+	size_t size = colorspace_buffer_size(sequence_cspace_, frame->width, frame->height);
+
+	if (fwrite(data, size, 1, sequence_file_) != 1) {
+		frame->failed = true;
+		set_error(Exception(errno,
+		                    "Failed to append image %lu to sequence %s",
+		                    frame->seqnum,
+		                    sequence_filename_.c_str()));
+		return;
+	}
+
+	FvRawWriter::FvRawFrameInfo info;
+	info.seqnum       = frame->seqnum;
+	info.capture_sec  = frame->capture_time.get_sec();
+	info.capture_usec = frame->capture_time.get_usec();
+	sequence_index_.push_back(info);
+}
+
+/** Remember error of encoder thread.
+ * Only the first error is kept until it is reported.
+ * @param e exception to report
+ */
+void
+AsyncSeqWriter::set_error(const Exception &e)
+{
+	MutexLocker lock(queue_mutex_);
+	if (!error_) {
+		error_ = new Exception(e);
+	}
+}
+
+/** Wait until all queued images have been written.
+ * @exception Exception thrown if writing any image failed since the last
+ * call to flush(), the first error is reported
+ */
+void
+AsyncSeqWriter::flush()
+{
+	queue_mutex_->lock();
+	while (!pending_frames_.empty() || (num_encoding_ > 0) || !encoded_frames_.empty()
+	       || outputting_) {
+		queue_waitcond_->wait();
+	}
+	Exception *error = error_;
+	error_           = NULL;
+	queue_mutex_->unlock();
+
+	if (sequence_file_) {
+		fflush(sequence_file_);
+	}
+
+	if (error) {
+		Exception e(*error);
+		delete error;
+		throw e;
+	}
+}
+
+/** Close writer.
+ * Waits for all queued images to be written. For a sequence the index is
+ * written and the file is closed. No images can be written afterwards.
+ * @exception Exception thrown if writing any image or the index failed
+ */
+void
+AsyncSeqWriter::close()
+{
+	if (closed_)
+		return;
+	closed_ = true;
+
+	try {
+		flush();
+	} catch (Exception &e) {
+		if (sequence_file_) {
+			fclose(sequence_file_);
+			sequence_file_ = NULL;
+		}
+		throw;
+	}
+
+	if (sequence_file_) {
+		FvRawWriter::FvRawSequenceTrailer trailer;
+		trailer.sequence_id  = FvRawWriter::SEQUENCE_IDENTIFIER;
+		trailer.num_frames   = sequence_index_.size();
+		trailer.index_offset = sizeof(FvRawWriter::FvRawHeader)
+		                       + (uint64_t)trailer.num_frames
+		                           * colorspace_buffer_size(sequence_cspace_, width_, height_);
+
+		bool ok = ((sequence_index_.empty()
+		            || (fwrite(&sequence_index_[0],
+		                       sizeof(FvRawWriter::FvRawFrameInfo),
+		                       sequence_index_.size(),
+		                       sequence_file_)
+		                == sequence_index_.size()))
+		           && (fwrite(&trailer, sizeof(trailer), 1, sequence_file_) == 1));
+		int errnoval = errno;
+
+		if ((fclose(sequence_file_) != 0) && ok) {
+			ok       = false;
+			errnoval = errno;
+		}
+		sequence_file_ = NULL;
+
+		if (!ok) {
+			throw Exception(errnoval,
+			                "Failed to write index of sequence %s",
+			                sequence_filename_.c_str());
+		}
+	}
+}
+
+/** Get number of images written.
+ * @return number of images written successfully so far
+ */
+unsigned long int
+AsyncSeqWriter::num_written()
+{
+	MutexLocker lock(queue_mutex_);
+	return num_written_;
+}
+
+/** Get number of dropped images.
+ * @return number of images dropped because the queue was full
+ */
+unsigned long int
+AsyncSeqWriter::num_dropped()
+{
+	MutexLocker lock(queue_mutex_);
+	return num_dropped_;
+}
+
+} // end namespace firevision
@@ -0,0 +1,124 @@
+
+/***************************************************************************
+ *  async_seq_writer.h - Write image sequences in the background
+ *
+ *  Created: Sun Oct 18 19:12:31 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FVUTILS_WRITERS_ASYNC_SEQ_WRITER_H_
+#define _FIREVISION_FVUTILS_WRITERS_ASYNC_SEQ_WRITER_H_
+
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/writers/fvraw.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Exception;
+class Mutex;
+class WaitCondition;
+} // namespace fawkes
+
+namespace firevision {
+
+class Writer;
+
+class AsyncSeqWriter
+{
+public:
+	/** Function creating a writer for an encoder thread. */
+	typedef std::function<Writer *()> WriterFactory;
+
+	AsyncSeqWriter(const WriterFactory &writer_factory,
+	               unsigned int         num_encoders = 2,
+	               unsigned int         queue_length = 8);
+	AsyncSeqWriter(const char  *sequence_filename,
+	               colorspace_t sequence_colorspace = CS_UNKNOWN,
+	               unsigned int num_encoders        = 1,
+	               unsigned int queue_length        = 8);
+	~AsyncSeqWriter();
+
+	void set_path(const char *img_path);
+	void set_filename(const char *filename);
+	void set_dimensions(unsigned int width, unsigned int height);
+	void set_colorspace(colorspace_t cspace);
+	void set_blocking(bool blocking);
+
+	bool write(const unsigned char *buffer, const fawkes::Time *capture_time = NULL);
+	void flush();
+	void close();
+
+	unsigned long int num_written();
+	unsigned long int num_dropped();
+
+private:
+	class Frame;
+	class EncoderThread;
+
+	void   start_encoders(unsigned int num_encoders, unsigned int queue_length);
+	void   encode_next(Writer *writer);
+	void   encode(Frame *frame, Writer *writer);
+	void   output_ordered();
+	void   open_sequence();
+	void   append_to_sequence(Frame *frame);
+	void   set_error(const fawkes::Exception &e);
+	Frame *next_free_frame();
+
+private:
+	WriterFactory writer_factory_;
+	std::string   img_path_;
+	std::string   filename_;
+	unsigned int  width_;
+	unsigned int  height_;
+	colorspace_t  cspace_;
+	bool          blocking_;
+
+	fawkes::Mutex                   *queue_mutex_;
+	fawkes::WaitCondition           *queue_waitcond_;
+	std::vector<Frame *>             frames_;
+	std::vector<Frame *>             free_frames_;
+	std::deque<Frame *>              pending_frames_;
+	std::map<unsigned long, Frame *> encoded_frames_;
+	std::vector<EncoderThread *>     encoders_;
+	unsigned int                     num_encoding_;
+	bool                             outputting_;
+	bool                             closed_;
+	bool                             stopping_;
+	unsigned long int                next_order_;
+	unsigned long int                next_output_order_;
+	unsigned long int                seqnum_;
+	unsigned long int                num_written_;
+	unsigned long int                num_dropped_;
+	fawkes::Exception               *error_;
+
+	std::string                              sequence_filename_;
+	colorspace_t                             sequence_cspace_;
+	FILE                                    *sequence_file_;
+	std::vector<FvRawWriter::FvRawFrameInfo> sequence_index_;
+};
+
+} // end namespace firevision
+
+#endif
@@ -35,10 +35,19 @@ namespace firevision {
 
 /** File identifier for FvRaw images. */
 const unsigned int FvRawWriter::FILE_IDENTIFIER = 0x17559358; // 16
+/** Sequence identifier for FvRaw image sequences. */
+const unsigned int FvRawWriter::SEQUENCE_IDENTIFIER = 0x17559359;
 
 /** @class FvRawWriter <fvutils/writers/fvraw.h>
  * FvRaw Writer implementation.
  * This class allows for writing FvRaw images to a file.
+ *
+ * An FvRaw file starts with an FvRawHeader followed by the image data. An
+ * FvRaw image sequence is a regular FvRaw file with any number of images of
+ * the same size appended, followed by an index of FvRawFrameInfo entries,
+ * one per image, and an FvRawSequenceTrailer at the very end of the file.
+ * Readers unaware of sequences simply see the first image. Sequences are
+ * written by AsyncSeqWriter.
  * @author Tim Niemueller
  */
 
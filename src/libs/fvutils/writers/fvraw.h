@@ -26,6 +26,8 @@
 
 #include <fvutils/writers/writer.h>
 
+#include <stdint.h>
+
 namespace firevision {
 
 class FvRawWriter : public Writer
@@ -46,6 +48,7 @@ public:
 	virtual unsigned char *get_write_buffer();
 
 	static const unsigned int FILE_IDENTIFIER;
+	static const unsigned int SEQUENCE_IDENTIFIER;
 
 	/** FvRaw image file header. */
 	typedef struct
@@ -56,6 +59,22 @@ public:
 		unsigned int height;     /**< height of image in pixels */
 	} FvRawHeader;
 
+	/** Index entry of a frame in an FvRaw image sequence. */
+	typedef struct
+	{
+		uint64_t seqnum;       /**< sequence number of frame */
+		int64_t  capture_sec;  /**< capture time, seconds part */
+		int64_t  capture_usec; /**< capture time, microseconds part */
+	} FvRawFrameInfo;
+
+	/** Trailer at the very end of an FvRaw image sequence. */
+	typedef struct
+	{
+		uint32_t sequence_id;  /**< sequence identifier */
+		uint32_t num_frames;   /**< number of frames in sequence and index */
+		uint64_t index_offset; /**< offset of the index from the start of the file */
+	} FvRawSequenceTrailer;
+
 private:
 	FvRawHeader    header;
 	unsigned char *buffer;
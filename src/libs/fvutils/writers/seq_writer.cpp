@@ -23,7 +23,7 @@
 
 #include <core/exceptions/system.h>
 #include <fvutils/writers/seq_writer.h>
-#include <sys/time.h>
+#include <utils/time/time.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -116,62 +116,78 @@ void
 SeqWriter::write(unsigned char *buffer)
 {
 	++frame_number;
-	char *fn;
 
-	time_t         now = time(NULL);
-	struct tm      now_tm;
-	struct timeval now_tv;
+	Time  now;
+	char *fn = sequence_filename(img_path, filename, now, frame_number);
+	writer->set_filename(fn);
+	free(fn);
+
+	try {
+		writer->set_buffer(cspace, buffer);
+		writer->write();
+	} catch (Exception &e) {
+		throw;
+	}
+}
+
+/** Generate file name for an image of a sequence.
+ * The file name has the form [PATH/]YYYYMMDD_hhmmss_uuuuuu[_NAME]-INDEX,
+ * the extension is added by the writer.
+ * @param img_path directory to store the image in, may be NULL
+ * @param filename base file name, may be NULL
+ * @param time time the image was taken, printed in local time
+ * @param frame_number running number of image
+ * @return file name, free it with free() after use
+ */
+char *
+SeqWriter::sequence_filename(const char  *img_path,
+                             const char  *filename,
+                             const Time  &time,
+                             unsigned int frame_number)
+{
+	char *fn;
 
-	gettimeofday(&now_tv, NULL);
-	localtime_r(&now, &now_tm);
+	time_t    sec = time.get_sec();
+	struct tm time_tm;
+	localtime_r(&sec, &time_tm);
 
 	char *timestring;
 	if (asprintf(&timestring,
 	             "%04d%02d%02d_%02d%02d%02d_%06ld",
-	             now_tm.tm_year + 1900,
-	             now_tm.tm_mon + 1,
-	             now_tm.tm_mday,
-	             now_tm.tm_hour,
-	             now_tm.tm_min,
-	             now_tm.tm_sec,
-	             now_tv.tv_usec)
+	             time_tm.tm_year + 1900,
+	             time_tm.tm_mon + 1,
+	             time_tm.tm_mday,
+	             time_tm.tm_hour,
+	             time_tm.tm_min,
+	             time_tm.tm_sec,
+	             time.get_usec())
 	    == -1) {
-		throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (1)");
+		throw OutOfMemoryException("SeqWriter::sequence_filename(): asprintf() failed (1)");
 	}
 
+	int rv;
 	if (filename) {
 		// filename: YYYYMMDD-hhmmss_uuuuuu_name_index.ext
 		if (img_path) {
-			if (asprintf(&fn, "%s/%s_%s-%04u", img_path, timestring, filename, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (2)");
-			}
+			rv = asprintf(&fn, "%s/%s_%s-%04u", img_path, timestring, filename, frame_number);
 		} else {
-			if (asprintf(&fn, "%s_%s-%04u", timestring, filename, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (2)");
-			}
+			rv = asprintf(&fn, "%s_%s-%04u", timestring, filename, frame_number);
 		}
 	} else {
 		// filename: YYYYMMDD-hhmmss_uuuuuu_index.ext
 		if (img_path) {
-			if (asprintf(&fn, "%s/%s-%04u", img_path, timestring, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (3)");
-			}
+			rv = asprintf(&fn, "%s/%s-%04u", img_path, timestring, frame_number);
 		} else {
-			if (asprintf(&fn, "%s-%04u", timestring, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (4)");
-			}
+			rv = asprintf(&fn, "%s-%04u", timestring, frame_number);
 		}
 	}
+	free(timestring);
 
-	writer->set_filename(fn);
-	free(fn);
-
-	try {
-		writer->set_buffer(cspace, buffer);
-		writer->write();
-	} catch (Exception &e) {
-		throw;
+	if (rv == -1) {
+		throw OutOfMemoryException("SeqWriter::sequence_filename(): asprintf() failed (2)");
 	}
+
+	return fn;
 }
 
 } // end namespace firevision
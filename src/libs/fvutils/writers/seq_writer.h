@@ -28,6 +28,10 @@
 #include <fvutils/color/colorspaces.h>
 #include <fvutils/writers/writer.h>
 
+namespace fawkes {
+class Time;
+}
+
 namespace firevision {
 
 class SeqWriter
@@ -44,6 +48,11 @@ public:
 
 	void write(unsigned char *buffer);
 
+	static char *sequence_filename(const char         *img_path,
+	                               const char         *filename,
+	                               const fawkes::Time &time,
+	                               unsigned int        frame_number);
+
 private:
 	Writer      *writer;
 	char        *filename;
@@ -49,19 +49,24 @@ InterfaceFieldIterator::InterfaceFieldIterator()
 	interface_    = NULL;
 	infol_        = NULL;
 	value_string_ = NULL;
+	data_         = NULL;
 }
 
 /** Constructor.
  * This creates an iterator pointing to the given entry of the info list.
  * @param interface interface this field iterator is assigned to
  * @param info_list pointer to info list entry to start from
+ * @param data data the offsets of entries without value pointer refer to,
+ * used for field info lists shared among instances
  */
 InterfaceFieldIterator::InterfaceFieldIterator(Interface                   *interface,
-                                               const interface_fieldinfo_t *info_list)
+                                               const interface_fieldinfo_t *info_list,
+                                               void                        *data)
 {
 	interface_    = interface;
 	infol_        = info_list;
 	value_string_ = NULL;
+	data_         = (char *)data;
 }
 
 /** Copy constructor.
@@ -71,6 +76,7 @@ InterfaceFieldIterator::InterfaceFieldIterator(const InterfaceFieldIterator &fit
 {
 	interface_ = fit.interface_;
 	infol_     = fit.infol_;
+	data_      = fit.data_;
 	if (fit.value_string_) {
 		value_string_ = strdup(fit.value_string_);
 	} else {
@@ -168,7 +174,7 @@ InterfaceFieldIterator::operator*() const
 	if (infol_ == NULL) {
 		throw NullPointerException("Cannot get value of end element");
 	} else {
-		return infol_->value;
+		return value_ptr();
 	}
 }
 
@@ -181,10 +187,21 @@ InterfaceFieldIterator::operator=(const InterfaceFieldIterator &fi)
 {
 	interface_ = fi.interface_;
 	infol_     = fi.infol_;
+	data_      = fi.data_;
 
 	return *this;
 }
 
+/** Get pointer to value of current field.
+ * @return value pointer of the field info entry, or the pointer into the
+ * data at the entry's offset if the entry has no value pointer
+ */
+void *
+InterfaceFieldIterator::value_ptr() const
+{
+	return infol_->value ? infol_->value : (data_ + infol_->offset);
+}
+
 /** Get type of current field.
  * @return field type
  */
@@ -254,6 +271,19 @@ InterfaceFieldIterator::get_enum_valuenames() const
 	return enums;
 }
 
+/** Get enum map of current field.
+ * @return map from enum values to their names, NULL if the field is not
+ * an enum field
+ */
+const interface_enum_map_t *
+InterfaceFieldIterator::get_enum_map() const
+{
+	if (infol_ == NULL) {
+		throw NullPointerException("Cannot get enum map of end element");
+	}
+	return infol_->enum_map;
+}
+
 /** Get name of current field.
  * @return field name
  */
@@ -276,7 +306,7 @@ InterfaceFieldIterator::get_value() const
 	if (infol_ == NULL) {
 		throw NullPointerException("Cannot get value of end element");
 	} else {
-		return infol_->value;
+		return value_ptr();
 	}
 }
 
@@ -319,37 +349,37 @@ InterfaceFieldIterator::get_value_string(const char *array_sep)
 					int rv = 0;
 					switch (infol_->type) {
 					case IFT_BOOL:
-						rv = asprintf(&tmp2, "%s%s", tmp1, (((bool *)infol_->value)[i]) ? "true" : "false");
+						rv = asprintf(&tmp2, "%s%s", tmp1, (((bool *)value_ptr())[i]) ? "true" : "false");
 						break;
-					case IFT_INT8: rv = asprintf(&tmp2, "%s%i", tmp1, ((int8_t *)infol_->value)[i]); break;
-					case IFT_INT16: rv = asprintf(&tmp2, "%s%i", tmp1, ((int16_t *)infol_->value)[i]); break;
-					case IFT_INT32: rv = asprintf(&tmp2, "%s%i", tmp1, ((int32_t *)infol_->value)[i]); break;
+					case IFT_INT8: rv = asprintf(&tmp2, "%s%i", tmp1, ((int8_t *)value_ptr())[i]); break;
+					case IFT_INT16: rv = asprintf(&tmp2, "%s%i", tmp1, ((int16_t *)value_ptr())[i]); break;
+					case IFT_INT32: rv = asprintf(&tmp2, "%s%i", tmp1, ((int32_t *)value_ptr())[i]); break;
 					case IFT_INT64:
 #if (defined(__WORDSIZE) && __WORDSIZE == 64) || (defined(LONG_BIT) && LONG_BIT == 64) \
   || defined(__x86_64__)
-						rv = asprintf(&tmp2, "%s%li", tmp1, ((int64_t *)infol_->value)[i]);
+						rv = asprintf(&tmp2, "%s%li", tmp1, ((int64_t *)value_ptr())[i]);
 #else
-						rv = asprintf(&tmp2, "%s%lli", tmp1, ((int64_t *)infol_->value)[i]);
+						rv = asprintf(&tmp2, "%s%lli", tmp1, ((int64_t *)value_ptr())[i]);
 #endif
 						break;
-					case IFT_UINT8: rv = asprintf(&tmp2, "%s%u", tmp1, ((uint8_t *)infol_->value)[i]); break;
+					case IFT_UINT8: rv = asprintf(&tmp2, "%s%u", tmp1, ((uint8_t *)value_ptr())[i]); break;
 					case IFT_UINT16:
-						rv = asprintf(&tmp2, "%s%u", tmp1, ((uint16_t *)infol_->value)[i]);
+						rv = asprintf(&tmp2, "%s%u", tmp1, ((uint16_t *)value_ptr())[i]);
 						break;
 					case IFT_UINT32:
-						rv = asprintf(&tmp2, "%s%u", tmp1, ((uint32_t *)infol_->value)[i]);
+						rv = asprintf(&tmp2, "%s%u", tmp1, ((uint32_t *)value_ptr())[i]);
 						break;
 					case IFT_UINT64:
 #if (defined(__WORDSIZE) && __WORDSIZE == 64) || (defined(LONG_BIT) && LONG_BIT == 64) \
   || defined(__x86_64__)
-						rv = asprintf(&tmp2, "%s%lu", tmp1, ((uint64_t *)infol_->value)[i]);
+						rv = asprintf(&tmp2, "%s%lu", tmp1, ((uint64_t *)value_ptr())[i]);
 #else
-						rv = asprintf(&tmp2, "%s%llu", tmp1, ((uint64_t *)infol_->value)[i]);
+						rv = asprintf(&tmp2, "%s%llu", tmp1, ((uint64_t *)value_ptr())[i]);
 #endif
 						break;
-					case IFT_FLOAT: rv = asprintf(&tmp2, "%s%f", tmp1, ((float *)infol_->value)[i]); break;
-					case IFT_DOUBLE: rv = asprintf(&tmp2, "%s%f", tmp1, ((double *)infol_->value)[i]); break;
-					case IFT_BYTE: rv = asprintf(&tmp2, "%s%u", tmp1, ((uint8_t *)infol_->value)[i]); break;
+					case IFT_FLOAT: rv = asprintf(&tmp2, "%s%f", tmp1, ((float *)value_ptr())[i]); break;
+					case IFT_DOUBLE: rv = asprintf(&tmp2, "%s%f", tmp1, ((double *)value_ptr())[i]); break;
+					case IFT_BYTE: rv = asprintf(&tmp2, "%s%u", tmp1, ((uint8_t *)value_ptr())[i]); break;
 					case IFT_STRING:
 						// cannot happen, caught with surrounding if statement
 
@@ -357,7 +387,7 @@ InterfaceFieldIterator::get_value_string(const char *array_sep)
 						rv = asprintf(&tmp2,
 						              "%s%s",
 						              tmp1,
-						              interface_->enum_tostring(infol_->enumtype, ((int *)infol_->value)[i]));
+						              interface_->enum_tostring(infol_->enumtype, ((int *)value_ptr())[i]));
 						break;
 					}
 
@@ -382,12 +412,12 @@ InterfaceFieldIterator::get_value_string(const char *array_sep)
 			} else {
 				// it's a string, or a small number
 				if (infol_->length > 1) {
-					if (asprintf(&value_string_, "%s", (const char *)infol_->value) == -1) {
+					if (asprintf(&value_string_, "%s", (const char *)value_ptr()) == -1) {
 						throw OutOfMemoryException(
 						  "InterfaceFieldIterator::get_value_string(): asprintf() failed (3)");
 					}
 				} else {
-					if (asprintf(&value_string_, "%c", *((const char *)infol_->value)) == -1) {
+					if (asprintf(&value_string_, "%c", *((const char *)value_ptr())) == -1) {
 						throw OutOfMemoryException(
 						  "InterfaceFieldIterator::get_value_string(): asprintf() failed (4)");
 					}
@@ -415,7 +445,7 @@ InterfaceFieldIterator::get_bool(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((bool *)infol_->value)[index];
+		return ((bool *)value_ptr())[index];
 	}
 }
 
@@ -436,7 +466,7 @@ InterfaceFieldIterator::get_int8(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((int8_t *)infol_->value)[index];
+		return ((int8_t *)value_ptr())[index];
 	}
 }
 
@@ -457,7 +487,7 @@ InterfaceFieldIterator::get_uint8(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((uint8_t *)infol_->value)[index];
+		return ((uint8_t *)value_ptr())[index];
 	}
 }
 
@@ -478,7 +508,7 @@ InterfaceFieldIterator::get_int16(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((int16_t *)infol_->value)[index];
+		return ((int16_t *)value_ptr())[index];
 	}
 }
 
@@ -499,7 +529,7 @@ InterfaceFieldIterator::get_uint16(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((uint16_t *)infol_->value)[index];
+		return ((uint16_t *)value_ptr())[index];
 	}
 }
 
@@ -520,7 +550,7 @@ InterfaceFieldIterator::get_int32(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((int32_t *)infol_->value)[index];
+		return ((int32_t *)value_ptr())[index];
 	}
 }
 
@@ -541,7 +571,7 @@ InterfaceFieldIterator::get_uint32(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((uint32_t *)infol_->value)[index];
+		return ((uint32_t *)value_ptr())[index];
 	}
 }
 
@@ -562,7 +592,7 @@ InterfaceFieldIterator::get_int64(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((int64_t *)infol_->value)[index];
+		return ((int64_t *)value_ptr())[index];
 	}
 }
 
@@ -583,7 +613,7 @@ InterfaceFieldIterator::get_uint64(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((uint64_t *)infol_->value)[index];
+		return ((uint64_t *)value_ptr())[index];
 	}
 }
 
@@ -604,7 +634,7 @@ InterfaceFieldIterator::get_float(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((float *)infol_->value)[index];
+		return ((float *)value_ptr())[index];
 	}
 }
 
@@ -625,7 +655,7 @@ InterfaceFieldIterator::get_double(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((double *)infol_->value)[index];
+		return ((double *)value_ptr())[index];
 	}
 }
 
@@ -646,7 +676,7 @@ InterfaceFieldIterator::get_byte(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((uint8_t *)infol_->value)[index];
+		return ((uint8_t *)value_ptr())[index];
 	}
 }
 
@@ -667,7 +697,7 @@ InterfaceFieldIterator::get_enum(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		return ((int32_t *)infol_->value)[index];
+		return ((int32_t *)value_ptr())[index];
 	}
 }
 
@@ -690,7 +720,7 @@ InterfaceFieldIterator::get_enum_string(unsigned int index) const
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		int32_t                              int_val = ((int32_t *)infol_->value)[index];
+		int32_t                              int_val = ((int32_t *)value_ptr())[index];
 		interface_enum_map_t::const_iterator ev      = infol_->enum_map->find(int_val);
 		if (ev == infol_->enum_map->end()) {
 			throw IllegalArgumentException("Integer value is not a canonical enum value");
@@ -715,7 +745,7 @@ InterfaceFieldIterator::get_bools() const
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		return (bool *)infol_->value;
+		return (bool *)value_ptr();
 	}
 }
 
@@ -733,7 +763,7 @@ InterfaceFieldIterator::get_int8s() const
 	} else if (infol_->type != IFT_INT8) {
 		throw TypeMismatchException("Requested value is not of type int");
 	} else {
-		return (int8_t *)infol_->value;
+		return (int8_t *)value_ptr();
 	}
 }
 
@@ -751,7 +781,7 @@ InterfaceFieldIterator::get_uint8s() const
 	} else if (infol_->type != IFT_UINT8) {
 		throw TypeMismatchException("Requested value is not of type unsigned int");
 	} else {
-		return (uint8_t *)infol_->value;
+		return (uint8_t *)value_ptr();
 	}
 }
 
@@ -769,7 +799,7 @@ InterfaceFieldIterator::get_int16s() const
 	} else if (infol_->type != IFT_INT16) {
 		throw TypeMismatchException("Requested value is not of type int");
 	} else {
-		return (int16_t *)infol_->value;
+		return (int16_t *)value_ptr();
 	}
 }
 
@@ -787,7 +817,7 @@ InterfaceFieldIterator::get_uint16s() const
 	} else if (infol_->type != IFT_UINT16) {
 		throw TypeMismatchException("Requested value is not of type unsigned int");
 	} else {
-		return (uint16_t *)infol_->value;
+		return (uint16_t *)value_ptr();
 	}
 }
 
@@ -805,7 +835,7 @@ InterfaceFieldIterator::get_int32s() const
 	} else if (infol_->type != IFT_INT32) {
 		throw TypeMismatchException("Requested value is not of type int");
 	} else {
-		return (int32_t *)infol_->value;
+		return (int32_t *)value_ptr();
 	}
 }
 
@@ -823,7 +853,7 @@ InterfaceFieldIterator::get_uint32s() const
 	} else if (infol_->type != IFT_UINT32) {
 		throw TypeMismatchException("Requested value is not of type unsigned int");
 	} else {
-		return (uint32_t *)infol_->value;
+		return (uint32_t *)value_ptr();
 	}
 }
 
@@ -841,7 +871,7 @@ InterfaceFieldIterator::get_int64s() const
 	} else if (infol_->type != IFT_INT64) {
 		throw TypeMismatchException("Requested value is not of type int");
 	} else {
-		return (int64_t *)infol_->value;
+		return (int64_t *)value_ptr();
 	}
 }
 
@@ -859,7 +889,7 @@ InterfaceFieldIterator::get_uint64s() const
 	} else if (infol_->type != IFT_UINT64) {
 		throw TypeMismatchException("Requested value is not of type unsigned int");
 	} else {
-		return (uint64_t *)infol_->value;
+		return (uint64_t *)value_ptr();
 	}
 }
 
@@ -877,7 +907,7 @@ InterfaceFieldIterator::get_floats() const
 	} else if (infol_->type != IFT_FLOAT) {
 		throw TypeMismatchException("Requested value is not of type float");
 	} else {
-		return (float *)infol_->value;
+		return (float *)value_ptr();
 	}
 }
 
@@ -895,7 +925,7 @@ InterfaceFieldIterator::get_doubles() const
 	} else if (infol_->type != IFT_DOUBLE) {
 		throw TypeMismatchException("Requested value is not of type double");
 	} else {
-		return (double *)infol_->value;
+		return (double *)value_ptr();
 	}
 }
 
@@ -913,7 +943,7 @@ InterfaceFieldIterator::get_bytes() const
 	} else if (infol_->type != IFT_BYTE) {
 		throw TypeMismatchException("Requested value is not of type byte");
 	} else {
-		return (uint8_t *)infol_->value;
+		return (uint8_t *)value_ptr();
 	}
 }
 
@@ -931,7 +961,7 @@ InterfaceFieldIterator::get_enums() const
 	} else if (infol_->type != IFT_ENUM) {
 		throw TypeMismatchException("Requested value is not of type enum");
 	} else {
-		return (int32_t *)infol_->value;
+		return (int32_t *)value_ptr();
 	}
 }
 
@@ -948,7 +978,7 @@ InterfaceFieldIterator::get_string() const
 	} else if (infol_->type != IFT_STRING) {
 		throw TypeMismatchException("Requested value is not of type string");
 	} else {
-		return (const char *)infol_->value;
+		return (const char *)value_ptr();
 	}
 }
 
@@ -969,7 +999,7 @@ InterfaceFieldIterator::set_bool(bool v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(bool);
+		char *dst = (char *)value_ptr() + index * sizeof(bool);
 		memcpy((void *)dst, &v, sizeof(bool));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -993,7 +1023,7 @@ InterfaceFieldIterator::set_int8(int8_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(int8_t);
+		char *dst = (char *)value_ptr() + index * sizeof(int8_t);
 		memcpy((void *)dst, &v, sizeof(int8_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1017,7 +1047,7 @@ InterfaceFieldIterator::set_uint8(uint8_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(uint8_t);
+		char *dst = (char *)value_ptr() + index * sizeof(uint8_t);
 		memcpy((void *)dst, &v, sizeof(uint8_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1041,7 +1071,7 @@ InterfaceFieldIterator::set_int16(int16_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(int16_t);
+		char *dst = (char *)value_ptr() + index * sizeof(int16_t);
 		memcpy((void *)dst, &v, sizeof(int16_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1065,7 +1095,7 @@ InterfaceFieldIterator::set_uint16(uint16_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(uint16_t);
+		char *dst = (char *)value_ptr() + index * sizeof(uint16_t);
 		memcpy((void *)dst, &v, sizeof(uint16_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1089,7 +1119,7 @@ InterfaceFieldIterator::set_int32(int32_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(int32_t);
+		char *dst = (char *)value_ptr() + index * sizeof(int32_t);
 		memcpy((void *)dst, &v, sizeof(int32_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1113,7 +1143,7 @@ InterfaceFieldIterator::set_uint32(uint32_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(uint32_t);
+		char *dst = (char *)value_ptr() + index * sizeof(uint32_t);
 		memcpy((void *)dst, &v, sizeof(uint32_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1137,7 +1167,7 @@ InterfaceFieldIterator::set_int64(int64_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(int64_t);
+		char *dst = (char *)value_ptr() + index * sizeof(int64_t);
 		memcpy((void *)dst, &v, sizeof(int64_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1161,7 +1191,7 @@ InterfaceFieldIterator::set_uint64(uint64_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(uint64_t);
+		char *dst = (char *)value_ptr() + index * sizeof(uint64_t);
 		memcpy((void *)dst, &v, sizeof(uint64_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1185,7 +1215,7 @@ InterfaceFieldIterator::set_float(float v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(float);
+		char *dst = (char *)value_ptr() + index * sizeof(float);
 		memcpy((void *)dst, &v, sizeof(float));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1209,7 +1239,7 @@ InterfaceFieldIterator::set_double(double v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(double);
+		char *dst = (char *)value_ptr() + index * sizeof(double);
 		memcpy((void *)dst, &v, sizeof(double));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1233,7 +1263,7 @@ InterfaceFieldIterator::set_byte(uint8_t v, unsigned int index)
 	} else if (index >= infol_->length) {
 		throw OutOfBoundsException("Field index out of bounds", index, 0, infol_->length);
 	} else {
-		char *dst = (char *)infol_->value + index * sizeof(uint8_t);
+		char *dst = (char *)value_ptr() + index * sizeof(uint8_t);
 		memcpy((void *)dst, &v, sizeof(uint8_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1261,7 +1291,7 @@ InterfaceFieldIterator::set_enum(int32_t e, unsigned int index)
 		if (ev == infol_->enum_map->end()) {
 			throw IllegalArgumentException("Integer value is not a canonical enum value");
 		}
-		char *dst = (char *)infol_->value + index * sizeof(int32_t);
+		char *dst = (char *)value_ptr() + index * sizeof(int32_t);
 		memcpy((void *)dst, &e, sizeof(int32_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
@@ -1288,7 +1318,7 @@ InterfaceFieldIterator::set_enum_string(const char *e, unsigned int index)
 		interface_enum_map_t::const_iterator ev;
 		for (ev = infol_->enum_map->begin(); ev != infol_->enum_map->end(); ++ev) {
 			if (ev->second == e) {
-				char *dst = (char *)infol_->value + index * sizeof(int32_t);
+				char *dst = (char *)value_ptr() + index * sizeof(int32_t);
 				memcpy((void *)dst, &ev->first, sizeof(int32_t));
 				if (interface_)
 					interface_->mark_data_refreshed();
@@ -1316,7 +1346,7 @@ InterfaceFieldIterator::set_bools(bool *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(bool));
+		memcpy(value_ptr(), v, infol_->length * sizeof(bool));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1338,7 +1368,7 @@ InterfaceFieldIterator::set_int8s(int8_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(int8_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(int8_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1360,7 +1390,7 @@ InterfaceFieldIterator::set_uint8s(uint8_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(uint8_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(uint8_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1382,7 +1412,7 @@ InterfaceFieldIterator::set_int16s(int16_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(int16_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(int16_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1404,7 +1434,7 @@ InterfaceFieldIterator::set_uint16s(uint16_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(uint16_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(uint16_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1426,7 +1456,7 @@ InterfaceFieldIterator::set_int32s(int32_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(int32_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(int32_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1448,7 +1478,7 @@ InterfaceFieldIterator::set_uint32s(uint32_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(uint32_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(uint32_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1470,7 +1500,7 @@ InterfaceFieldIterator::set_int64s(int64_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(int64_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(int64_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1492,7 +1522,7 @@ InterfaceFieldIterator::set_uint64s(uint64_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(uint64_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(uint64_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1514,7 +1544,7 @@ InterfaceFieldIterator::set_floats(float *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(float));
+		memcpy(value_ptr(), v, infol_->length * sizeof(float));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1536,7 +1566,7 @@ InterfaceFieldIterator::set_doubles(double *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(double));
+		memcpy(value_ptr(), v, infol_->length * sizeof(double));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1558,7 +1588,7 @@ InterfaceFieldIterator::set_bytes(uint8_t *v)
 	} else if (infol_->length == 1) {
 		throw TypeMismatchException("Field %s is not an array", infol_->name);
 	} else {
-		memcpy(infol_->value, v, infol_->length * sizeof(uint8_t));
+		memcpy(value_ptr(), v, infol_->length * sizeof(uint8_t));
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
@@ -1577,7 +1607,7 @@ InterfaceFieldIterator::set_string(const char *v)
 	} else if (infol_->type != IFT_STRING) {
 		throw TypeMismatchException("Field to be written is not of type string");
 	} else {
-		strncpy((char *)infol_->value, v, infol_->length);
+		strncpy((char *)value_ptr(), v, infol_->length);
 		if (interface_)
 			interface_->mark_data_refreshed();
 	}
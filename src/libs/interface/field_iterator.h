@@ -53,42 +53,43 @@ public:
 	const void             *operator*() const;
 	InterfaceFieldIterator &operator=(const InterfaceFieldIterator &fit);
 
-	interface_fieldtype_t   get_type() const;
-	const char             *get_typename() const;
-	bool                    is_enum() const;
-	std::list<const char *> get_enum_valuenames() const;
-	const char             *get_name() const;
-	const void             *get_value() const;
-	const char             *get_value_string(const char *array_sep = ", ");
-	size_t                  get_length() const;
-	bool                    get_bool(unsigned int index = 0) const;
-	int8_t                  get_int8(unsigned int index = 0) const;
-	uint8_t                 get_uint8(unsigned int index = 0) const;
-	int16_t                 get_int16(unsigned int index = 0) const;
-	uint16_t                get_uint16(unsigned int index = 0) const;
-	int32_t                 get_int32(unsigned int index = 0) const;
-	uint32_t                get_uint32(unsigned int index = 0) const;
-	int64_t                 get_int64(unsigned int index = 0) const;
-	uint64_t                get_uint64(unsigned int index = 0) const;
-	float                   get_float(unsigned int index = 0) const;
-	double                  get_double(unsigned int index = 0) const;
-	uint8_t                 get_byte(unsigned int index = 0) const;
-	int32_t                 get_enum(unsigned int index = 0) const;
-	const char             *get_enum_string(unsigned int index = 0) const;
-	bool                   *get_bools() const;
-	int8_t                 *get_int8s() const;
-	uint8_t                *get_uint8s() const;
-	int16_t                *get_int16s() const;
-	uint16_t               *get_uint16s() const;
-	int32_t                *get_int32s() const;
-	uint32_t               *get_uint32s() const;
-	int64_t                *get_int64s() const;
-	uint64_t               *get_uint64s() const;
-	float                  *get_floats() const;
-	double                 *get_doubles() const;
-	uint8_t                *get_bytes() const;
-	int32_t                *get_enums() const;
-	const char             *get_string() const;
+	interface_fieldtype_t       get_type() const;
+	const char                 *get_typename() const;
+	bool                        is_enum() const;
+	std::list<const char *>     get_enum_valuenames() const;
+	const interface_enum_map_t *get_enum_map() const;
+	const char                 *get_name() const;
+	const void                 *get_value() const;
+	const char                 *get_value_string(const char *array_sep = ", ");
+	size_t                      get_length() const;
+	bool                        get_bool(unsigned int index = 0) const;
+	int8_t                      get_int8(unsigned int index = 0) const;
+	uint8_t                     get_uint8(unsigned int index = 0) const;
+	int16_t                     get_int16(unsigned int index = 0) const;
+	uint16_t                    get_uint16(unsigned int index = 0) const;
+	int32_t                     get_int32(unsigned int index = 0) const;
+	uint32_t                    get_uint32(unsigned int index = 0) const;
+	int64_t                     get_int64(unsigned int index = 0) const;
+	uint64_t                    get_uint64(unsigned int index = 0) const;
+	float                       get_float(unsigned int index = 0) const;
+	double                      get_double(unsigned int index = 0) const;
+	uint8_t                     get_byte(unsigned int index = 0) const;
+	int32_t                     get_enum(unsigned int index = 0) const;
+	const char                 *get_enum_string(unsigned int index = 0) const;
+	bool                       *get_bools() const;
+	int8_t                     *get_int8s() const;
+	uint8_t                    *get_uint8s() const;
+	int16_t                    *get_int16s() const;
+	uint16_t                   *get_uint16s() const;
+	int32_t                    *get_int32s() const;
+	uint32_t                   *get_uint32s() const;
+	int64_t                    *get_int64s() const;
+	uint64_t                   *get_uint64s() const;
+	float                      *get_floats() const;
+	double                     *get_doubles() const;
+	uint8_t                    *get_bytes() const;
+	int32_t                    *get_enums() const;
+	const char                 *get_string() const;
 
 	void set_bool(bool b, unsigned int index = 0);
 	void set_int8(int8_t i, unsigned int index = 0);
@@ -119,12 +120,18 @@ public:
 	void set_string(const char *s);
 
 protected:
-	InterfaceFieldIterator(Interface *interface, const interface_fieldinfo_t *info_list);
+	InterfaceFieldIterator(Interface                   *interface,
+	                       const interface_fieldinfo_t *info_list,
+	                       void                        *data = NULL);
+
+private:
+	void *value_ptr() const;
 
 private:
 	const interface_fieldinfo_t *infol_;
 	char                        *value_string_;
 	Interface                   *interface_;
+	char                        *data_;
 };
 
 } // namespace fawkes
@@ -0,0 +1,77 @@
+
+/***************************************************************************
+ *  field_visitor.h - Typed visitation of interface fields
+ *
+ *  Created: Sun Oct 18 15:32:07 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _INTERFACE_FIELD_VISITOR_H_
+#define _INTERFACE_FIELD_VISITOR_H_
+
+#include <interface/types.h>
+
+#include <utility>
+
+namespace fawkes {
+
+/** Visit all fields of an interface or message.
+ * Generated interfaces and messages have a visit_fields() member template
+ * which calls the visitor once per field in declaration order as
+ * @code
+ * visitor(const interface_field_descriptor_t &desc, const T *values)
+ * @endcode
+ * where T is the storage type of the field (char for strings, int32_t
+ * for enums) and @p values points to desc.length values. The calls are
+ * generated per type, hence a visitor with overloads or a templated call
+ * operator compiles to straight-line code without any lookup, string
+ * conversion or allocation. A serializer (e.g. to JSON, BSON or CLIPS
+ * facts) can thus be written once for all interface types.
+ *
+ * The field descriptors are also available at compile time as the
+ * static constexpr field_descriptors array of each interface and message
+ * type, with num_fields entries.
+ * @param obj interface or message to visit
+ * @param visitor visitor to call for each field
+ */
+template <class InterfaceOrMessageT, class Visitor>
+void
+visit_fields(const InterfaceOrMessageT &obj, Visitor &&visitor)
+{
+	obj.visit_fields(std::forward<Visitor>(visitor));
+}
+
+/** Get name of an enum constant.
+ * @param desc descriptor of an enum field
+ * @param value value of the field
+ * @return name of the constant, or "UNKNOWN" if the value does not
+ * match any constant of the enum type
+ */
+inline const char *
+enum_constant_name(const interface_field_descriptor_t &desc, int value)
+{
+	for (unsigned int i = 0; i < desc.num_enum_constants; ++i) {
+		if (desc.enum_constants[i].value == value)
+			return desc.enum_constants[i].name;
+	}
+	return "UNKNOWN";
+}
+
+} // end namespace fawkes
+
+#endif
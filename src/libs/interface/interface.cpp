@@ -24,6 +24,7 @@
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <core/threading/refc_rwlock.h>
+#include <core/utils/trace.h>
 #include <interface/interface.h>
 #include <interface/mediators/interface_mediator.h>
 #include <interface/mediators/message_mediator.h>
@@ -357,6 +358,7 @@ Interface::add_fieldinfo(interface_fieldtype_t       type,
 	newinfo->value    = value;
 	newinfo->enum_map = enum_map;
 	newinfo->next     = NULL;
+	newinfo->offset   = (char *)value - (char *)data_ptr;
 
 	if (infol == NULL) {
 		// first entry
@@ -478,6 +480,7 @@ Interface::is_valid() const
 void
 Interface::read()
 {
+	FAWKES_TRACE_SCOPE("blackboard.read", uid_);
 	rwlock_->lock_for_read();
 	data_mutex_->lock();
 	if (valid_) {
@@ -500,6 +503,7 @@ Interface::read()
 void
 Interface::write()
 {
+	FAWKES_TRACE_SCOPE("blackboard.write", uid_);
 	if (!write_access_) {
 		throw InterfaceWriteDeniedException(type_, id_, "Cannot write.");
 	}
@@ -23,6 +23,7 @@
 
 #include <core/exceptions/software.h>
 #include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <core/threading/thread.h>
 #include <interface/interface.h>
 #include <interface/message.h>
@@ -30,6 +31,9 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <pthread.h>
+#include <set>
+#include <string>
 #include <unistd.h>
 
 namespace fawkes {
@@ -47,8 +51,9 @@ namespace fawkes {
  */
 
 /** @var Message::data_ptr
- * Pointer to memory that contains local data. This memory has to be allocated
- * by deriving classes with the approppriate size!
+ * Pointer to memory that contains local data. This memory has to be provided
+ * by deriving classes with the approppriate size! Generated messages point
+ * it to a data struct which is part of the message object.
  */
 
 /** @var Message::data_size
@@ -56,122 +61,187 @@ namespace fawkes {
  * to the appropriate value.
  */
 
+/// @cond INTERNALS
+// Sender thread names are interned, so that messages only store a
+// pointer and neither creating nor copying a message copies the name.
+// The set is never freed, messages may outlive their sending thread and
+// may still be deleted during program exit.
+static const char *
+intern_thread_name(const char *name)
+{
+	static Mutex                              *mutex = new Mutex();
+	static std::set<std::string, std::less<>> *names = new std::set<std::string, std::less<>>();
+
+	MutexLocker lock(mutex);
+	auto        n = names->find(name);
+	if (n == names->end()) {
+		n = names->insert(name).first;
+	}
+	return n->c_str();
+}
+
+static const char *
+current_sender_name()
+{
+	thread_local const char *cached_interned = NULL;
+
+	const char *name = NULL;
+	Thread     *t    = Thread::current_thread_noexc();
+	if (t) {
+		name = t->name();
+	}
+#if defined(_GNU_SOURCE) && defined(__GLIBC__) \
+  && ((__GLIBC__ == 2 && __GLIBC_MINOR__ >= 12) || __GLIBC__ > 2)
+	char sys_name[16];
+	if (!name && pthread_getname_np(pthread_self(), sys_name, sizeof(sys_name)) == 0) {
+		name = sys_name;
+	}
+#endif
+	if (!name || name[0] == 0) {
+		return "Unknown";
+	}
+
+	if (!cached_interned || strcmp(cached_interned, name) != 0) {
+		cached_interned = intern_thread_name(name);
+	}
+	return cached_interned;
+}
+/// @endcond
+
 /** Constructor.
  * @param type string representation of the message type
  */
 Message::Message(const char *type)
 {
-	fieldinfo_list_ = NULL;
-
-	message_id_    = 0;
-	hops_          = 0;
-	enqueued_      = false;
-	num_fields_    = 0;
-	data_ptr       = NULL;
-	data_ts        = NULL;
-	_type          = strdup(type);
-	time_enqueued_ = new Time();
+	fieldinfo_list_  = NULL;
+	fieldinfo_owned_ = false;
+
+	message_id_ = 0;
+	hops_       = 0;
+	enqueued_   = false;
+	num_fields_ = 0;
+	data_ptr    = NULL;
+	data_size   = 0;
+	data_ts     = NULL;
+	data_owned_ = false;
+	strncpy(_type, type, INTERFACE_MESSAGE_TYPE_SIZE_ - 1);
+	_type[INTERFACE_MESSAGE_TYPE_SIZE_ - 1] = 0;
 
 	_transmit_via_iface              = NULL;
 	sender_interface_instance_serial = 0;
 	recipient_interface_mem_serial   = 0;
 
-	std::string sender_name = Thread::current_thread_name();
-	if (sender_name != "") {
-		_sender_thread_name = strdup(sender_name.c_str());
-	} else {
-		_sender_thread_name = strdup("Unknown");
-	}
+	_sender_thread_name = current_sender_name();
 }
 
 /** Copy constructor.
  * @param mesg Message to copy.
  */
-Message::Message(const Message &mesg)
+Message::Message(const Message &mesg) : RefCount(), time_enqueued_(mesg.time_enqueued_)
 {
-	message_id_         = 0;
-	hops_               = mesg.hops_;
-	enqueued_           = false;
-	num_fields_         = mesg.num_fields_;
-	data_size           = mesg.data_size;
-	data_ptr            = malloc(data_size);
-	data_ts             = (message_data_ts_t *)data_ptr;
-	_sender_id          = mesg.sender_id();
-	_source_id          = mesg.source_id();
-	_sender_thread_name = strdup(mesg.sender_thread_name());
-	_type               = strdup(mesg._type);
-	time_enqueued_      = new Time(mesg.time_enqueued_);
-	fieldinfo_list_     = NULL;
-
-	_transmit_via_iface              = NULL;
-	sender_interface_instance_serial = 0;
-	recipient_interface_mem_serial   = 0;
-
-	memcpy(data_ptr, mesg.data_ptr, data_size);
+	copy_from(&mesg, true);
+}
 
-	interface_fieldinfo_t  *info_src  = mesg.fieldinfo_list_;
-	interface_fieldinfo_t **info_dest = &fieldinfo_list_;
-	while (info_src) {
-		interface_fieldinfo_t *new_info =
-		  (interface_fieldinfo_t *)malloc(sizeof(interface_fieldinfo_t));
-		memcpy(new_info, info_src, sizeof(interface_fieldinfo_t));
-		*info_dest = new_info;
+/** Copy constructor.
+ * @param mesg Message to copy.
+ */
+Message::Message(const Message *mesg) : time_enqueued_(mesg->time_enqueued_)
+{
+	copy_from(mesg, true);
+}
 
-		info_dest = &((*info_dest)->next);
-		info_src  = info_src->next;
-	}
+/** Copy constructor for derived classes.
+ * Generated messages keep their data as part of the message object. They
+ * pass false for @p copy_data and set data_ptr to their own storage and
+ * copy the data themselves.
+ * @param mesg Message to copy.
+ * @param copy_data true to allocate memory for the data and copy it from
+ * @p mesg, false to leave data_ptr unset
+ */
+Message::Message(const Message *mesg, bool copy_data) : time_enqueued_(mesg->time_enqueued_)
+{
+	copy_from(mesg, copy_data);
 }
 
-/** Copy constructor.
+/** Copy everything but the data from the given message.
  * @param mesg Message to copy.
+ * @param copy_data true to also allocate memory for and copy the data
  */
-Message::Message(const Message *mesg)
-{
-	message_id_                      = 0;
-	hops_                            = mesg->hops_;
-	enqueued_                        = false;
-	num_fields_                      = mesg->num_fields_;
-	data_size                        = mesg->data_size;
-	data_ptr                         = malloc(data_size);
-	data_ts                          = (message_data_ts_t *)data_ptr;
-	_sender_id                       = mesg->sender_id();
-	_source_id                       = mesg->source_id();
-	_sender_thread_name              = strdup(mesg->sender_thread_name());
-	_type                            = strdup(mesg->_type);
+void
+Message::copy_from(const Message *mesg, bool copy_data)
+{
+	message_id_         = 0;
+	hops_               = mesg->hops_;
+	enqueued_           = false;
+	num_fields_         = mesg->num_fields_;
+	data_size           = mesg->data_size;
+	_sender_id          = mesg->sender_id();
+	_source_id          = mesg->source_id();
+	_sender_thread_name = mesg->_sender_thread_name;
+	strcpy(_type, mesg->_type);
+
 	_transmit_via_iface              = NULL;
 	sender_interface_instance_serial = 0;
 	recipient_interface_mem_serial   = 0;
-	time_enqueued_                   = new Time(mesg->time_enqueued_);
-	fieldinfo_list_                  = NULL;
-
-	memcpy(data_ptr, mesg->data_ptr, data_size);
 
-	interface_fieldinfo_t  *info_src  = mesg->fieldinfo_list_;
-	interface_fieldinfo_t **info_dest = &fieldinfo_list_;
-	while (info_src) {
-		interface_fieldinfo_t *new_info =
-		  (interface_fieldinfo_t *)malloc(sizeof(interface_fieldinfo_t));
-		memcpy(new_info, info_src, sizeof(interface_fieldinfo_t));
-		*info_dest = new_info;
+	if (copy_data) {
+		data_ptr    = malloc(data_size);
+		data_ts     = (message_data_ts_t *)data_ptr;
+		data_owned_ = true;
+		memcpy(data_ptr, mesg->data_ptr, data_size);
+	} else {
+		data_ptr    = NULL;
+		data_ts     = NULL;
+		data_owned_ = false;
+	}
 
-		info_dest = &((*info_dest)->next);
-		info_src  = info_src->next;
+	if (!mesg->fieldinfo_owned_) {
+		// shared among all instances of the message type
+		fieldinfo_list_  = mesg->fieldinfo_list_;
+		fieldinfo_owned_ = false;
+	} else {
+		fieldinfo_list_  = NULL;
+		fieldinfo_owned_ = true;
+
+		interface_fieldinfo_t  *info_src  = mesg->fieldinfo_list_;
+		interface_fieldinfo_t **info_dest = &fieldinfo_list_;
+		while (info_src) {
+			interface_fieldinfo_t *new_info =
+			  (interface_fieldinfo_t *)malloc(sizeof(interface_fieldinfo_t));
+			memcpy(new_info, info_src, sizeof(interface_fieldinfo_t));
+			// refer to the data of this message by offset
+			new_info->value = NULL;
+			new_info->next  = NULL;
+			*info_dest      = new_info;
+
+			info_dest = &((*info_dest)->next);
+			info_src  = info_src->next;
+		}
 	}
 }
 
 /** Destructor. */
 Message::~Message()
 {
-	free(_sender_thread_name);
-	free(_type);
-	delete time_enqueued_;
+	free_fieldinfo();
+	if (data_owned_) {
+		free(data_ptr);
+	}
+}
 
-	interface_fieldinfo_t *infol = fieldinfo_list_;
-	while (infol) {
-		fieldinfo_list_ = fieldinfo_list_->next;
-		free(infol);
-		infol = fieldinfo_list_;
+/** Free field info list if owned by this message. */
+void
+Message::free_fieldinfo()
+{
+	if (fieldinfo_owned_) {
+		interface_fieldinfo_t *infol = fieldinfo_list_;
+		while (infol) {
+			fieldinfo_list_ = fieldinfo_list_->next;
+			free(infol);
+			infol = fieldinfo_list_;
+		}
 	}
+	fieldinfo_list_ = NULL;
 }
 
 /** Get message ID.
@@ -233,9 +303,9 @@ Message::set_hops(unsigned int hops)
 void
 Message::mark_enqueued()
 {
-	time_enqueued_->stamp();
+	time_enqueued_.stamp();
 	long sec = 0, usec = 0;
-	time_enqueued_->get_timestamp(sec, usec);
+	time_enqueued_.get_timestamp(sec, usec);
 	data_ts->timestamp_sec  = sec;
 	data_ts->timestamp_usec = usec;
 
@@ -261,7 +331,7 @@ Message::enqueued() const
 const Time *
 Message::time_enqueued() const
 {
-	return time_enqueued_;
+	return &time_enqueued_;
 }
 
 /** Get recipient memory serial.
@@ -301,7 +371,7 @@ void
 Message::set_from_chunk(const void *chunk)
 {
 	memcpy(data_ptr, chunk, data_size);
-	time_enqueued_->set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
+	time_enqueued_.set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
 }
 
 /** Assign this message to given message.
@@ -314,7 +384,7 @@ Message::operator=(const Message &m)
 {
 	if (data_size == m.data_size) {
 		memcpy(data_ptr, m.data_ptr, data_size);
-		time_enqueued_->set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
+		time_enqueued_.set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
 	}
 
 	return *this;
@@ -389,7 +459,7 @@ Message::type() const
 InterfaceFieldIterator
 Message::fields()
 {
-	return InterfaceFieldIterator(_transmit_via_iface, fieldinfo_list_);
+	return InterfaceFieldIterator(_transmit_via_iface, fieldinfo_list_, data_ptr);
 }
 
 /** Invalid iterator.
@@ -420,6 +490,23 @@ Message::clone() const
 	return new Message(this);
 }
 
+/** Set field info list shared among all instances of a message type.
+ * Never use directly, use the interface generator instead. The generated
+ * messages build the list once per type, with values given as offsets
+ * into the data, rather than adding field info for each instance.
+ * @param fieldinfo_list first entry of the field info list, entries must
+ * have a NULL value and must outlive all messages of the type
+ * @param num_fields number of entries in the list
+ */
+void
+Message::set_fieldinfo(interface_fieldinfo_t *fieldinfo_list, unsigned int num_fields)
+{
+	free_fieldinfo();
+	fieldinfo_list_  = fieldinfo_list;
+	fieldinfo_owned_ = false;
+	num_fields_      = num_fields;
+}
+
 /** Add an entry to the info list.
  * Never use directly, use the interface generator instead. The info list
  * is used for introspection purposes to allow for iterating over all fields
@@ -449,6 +536,8 @@ Message::add_fieldinfo(interface_fieldtype_t       type,
 	newinfo->value    = value;
 	newinfo->enum_map = enum_map;
 	newinfo->next     = NULL;
+	newinfo->offset   = (char *)value - (char *)data_ptr;
+	fieldinfo_owned_  = true;
 
 	if (infol == NULL) {
 		// first entry
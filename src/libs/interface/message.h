@@ -29,6 +29,7 @@
 #include <interface/change_field.h>
 #include <interface/field_iterator.h>
 #include <interface/types.h>
+#include <utils/time/time.h>
 #include <utils/uuid.h>
 
 #define INTERFACE_MESSAGE_TYPE_SIZE_ 64
@@ -38,7 +39,6 @@ namespace fawkes {
 class Mutex;
 class Interface;
 class InterfaceFieldIterator;
-class Time;
 
 class Message : public RefCount
 {
@@ -101,26 +101,33 @@ private: // fields
 	unsigned int message_id_;
 	unsigned int hops_;
 	bool         enqueued_;
-	Time        *time_enqueued_;
+	Time         time_enqueued_;
 
 	unsigned int recipient_interface_mem_serial;
 	unsigned int sender_interface_instance_serial;
 
-	char *_type;
-	char *_sender_thread_name;
-	Uuid  _sender_id;
-	Uuid  _source_id;
+	char        _type[INTERFACE_MESSAGE_TYPE_SIZE_];
+	const char *_sender_thread_name;
+	Uuid        _sender_id;
+	Uuid        _source_id;
 
 	Interface *_transmit_via_iface;
 
 	interface_fieldinfo_t *fieldinfo_list_;
+	bool                   fieldinfo_owned_;
+	bool                   data_owned_;
 
 	unsigned int num_fields_;
 
 private: // methods
 	void set_interface(Interface *iface, bool proxy = false);
+	void copy_from(const Message *mesg, bool copy_data);
+	void free_fieldinfo();
 
 protected:
+	Message(const Message *mesg, bool copy_data);
+
+	void set_fieldinfo(interface_fieldinfo_t *fieldinfo_list, unsigned int num_fields);
 	void add_fieldinfo(interface_fieldtype_t       type,
 	                   const char                 *name,
 	                   size_t                      length,
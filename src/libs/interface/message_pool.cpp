@@ -0,0 +1,129 @@
+
+/***************************************************************************
+ *  message_pool.cpp - Free-list memory pool for messages
+ *
+ *  Created: Mon Oct 19 10:12:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <interface/message_pool.h>
+
+#include <new>
+
+namespace fawkes {
+
+/** @class MessagePool <interface/message_pool.h>
+ * Free-list memory pool for messages.
+ * Generated message classes allocate their instances from a pool per
+ * message type. The memory of deleted messages is kept in a free list
+ * and re-used for new messages of the same type. Together with the
+ * message data being part of the message object, creating and copying
+ * messages does not allocate memory once the pool has been warmed up.
+ *
+ * Requests for a different size than the pool's object size, e.g. for
+ * classes derived from a generated message, are passed on to the global
+ * operator new.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param object_size size of objects managed by this pool
+ * @param max_free maximum number of free blocks kept, memory of messages
+ * released while this many blocks are free is returned to the system
+ */
+MessagePool::MessagePool(size_t object_size, unsigned int max_free)
+: object_size_(object_size < sizeof(FreeBlock) ? sizeof(FreeBlock) : object_size),
+  max_free_(max_free),
+  num_free_(0),
+  free_(NULL)
+{
+	mutex_ = new Mutex();
+}
+
+/** Destructor.
+ * Releases all free blocks. Blocks still in use are not touched.
+ */
+MessagePool::~MessagePool()
+{
+	while (free_) {
+		FreeBlock *b = free_;
+		free_        = b->next;
+		::operator delete(b);
+	}
+	delete mutex_;
+}
+
+/** Allocate memory for a message.
+ * @param size size of the requested memory
+ * @return memory block of at least @p size bytes
+ */
+void *
+MessagePool::allocate(size_t size)
+{
+	if (size > object_size_) {
+		return ::operator new(size);
+	}
+
+	{
+		MutexLocker lock(mutex_);
+		if (free_) {
+			FreeBlock *b = free_;
+			free_        = b->next;
+			--num_free_;
+			return b;
+		}
+	}
+	return ::operator new(object_size_);
+}
+
+/** Release memory of a message.
+ * @param ptr memory block previously returned by allocate()
+ * @param size size that has been passed to allocate()
+ */
+void
+MessagePool::release(void *ptr, size_t size)
+{
+	if (!ptr)
+		return;
+
+	if (size <= object_size_) {
+		MutexLocker lock(mutex_);
+		if (num_free_ < max_free_) {
+			FreeBlock *b = (FreeBlock *)ptr;
+			b->next      = free_;
+			free_        = b;
+			++num_free_;
+			return;
+		}
+	}
+	::operator delete(ptr);
+}
+
+/** Get number of free blocks.
+ * @return number of blocks currently available for re-use
+ */
+unsigned int
+MessagePool::num_free() const
+{
+	MutexLocker lock(mutex_);
+	return num_free_;
+}
+
+} // end namespace fawkes
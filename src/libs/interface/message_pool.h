@@ -0,0 +1,72 @@
+
+/***************************************************************************
+ *  message_pool.h - Free-list memory pool for messages
+ *
+ *  Created: Mon Oct 19 10:12:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _INTERFACE_MESSAGE_POOL_H_
+#define _INTERFACE_MESSAGE_POOL_H_
+
+#include <cstddef>
+
+namespace fawkes {
+
+class Mutex;
+
+class MessagePool
+{
+public:
+	MessagePool(size_t object_size, unsigned int max_free = 64);
+	~MessagePool();
+
+	void *allocate(size_t size);
+	void  release(void *ptr, size_t size);
+
+	unsigned int num_free() const;
+
+	/** Get pool for a message type.
+	 * The pool is created on first use and never destroyed, so that
+	 * messages may still be released during program exit.
+	 * @return pool for messages of type @p MessageT
+	 */
+	template <class MessageT>
+	static MessagePool &
+	of()
+	{
+		static MessagePool *pool = new MessagePool(sizeof(MessageT));
+		return *pool;
+	}
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+
+	size_t       object_size_;
+	unsigned int max_free_;
+	unsigned int num_free_;
+	FreeBlock   *free_;
+	Mutex       *mutex_;
+};
+
+} // end namespace fawkes
+
+#endif
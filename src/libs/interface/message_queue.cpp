@@ -49,24 +49,55 @@ MessageAlreadyQueuedException::MessageAlreadyQueuedException()
  * This message queue handles the basic messaging operations. The methods the
  * Interface provides for handling message queues are forwarded to a
  * MessageQueue instance.
+ *
+ * Messages are kept in a ring buffer. It starts with a small capacity
+ * and is doubled if it runs full, but is never shrunk. Therefore
+ * enqueueing and removing messages does not allocate memory once the
+ * queue has grown to the usual number of queued messages.
+ *
+ * The number of messages is limited to a maximum size. If a message is
+ * added to a full queue, the oldest message is dropped. This keeps the
+ * queue of a writer which does not process its messages from growing
+ * without bound.
  * @see Interface
  */
 
-/** Constructor. */
-MessageQueue::MessageQueue()
+/// @cond INTERNALS
+static const unsigned int MESSAGE_QUEUE_INITIAL_CAPACITY = 8;
+/// @endcond
+
+/** Constructor.
+ * @param max_size maximum number of messages in the queue, 0 to not
+ * limit the queue size
+ */
+MessageQueue::MessageQueue(unsigned int max_size)
 {
-	list_   = NULL;
-	end_el_ = NULL;
-	mutex_  = new Mutex();
+	max_size_ = max_size;
+	capacity_ = MESSAGE_QUEUE_INITIAL_CAPACITY;
+	ring_     = (msg_entry_t *)malloc(capacity_ * sizeof(msg_entry_t));
+	head_     = 0;
+	size_     = 0;
+	mutex_    = new Mutex();
 }
 
 /** Destructor */
 MessageQueue::~MessageQueue()
 {
 	flush();
+	free(ring_);
 	delete mutex_;
 }
 
+/** Get entry at position.
+ * @param pos position relative to the first message
+ * @return entry in ring buffer
+ */
+MessageQueue::msg_entry_t &
+MessageQueue::entry(unsigned int pos) const
+{
+	return ring_[(head_ + pos) & (capacity_ - 1)];
+}
+
 /** Delete all messages from queue.
  * This method deletes all messages from the queue.
  */
@@ -74,19 +105,49 @@ void
 MessageQueue::flush()
 {
 	mutex_->lock();
-	// free list elements
-	msg_list_t *l = list_;
-	msg_list_t *next;
-	while (l) {
-		next = l->next;
-		l->msg->unref();
-		free(l);
-		l = next;
+	for (unsigned int i = 0; i < size_; ++i) {
+		entry(i).msg->unref();
 	}
-	list_ = NULL;
+	head_ = 0;
+	size_ = 0;
 	mutex_->unlock();
 }
 
+/** Insert message at position.
+ * Drops the oldest message if the queue has reached its maximum size,
+ * and grows the ring buffer if it is full. The queue must be locked.
+ * @param pos position to insert at, must be greater than zero if the
+ * queue is full, messages from this position on are moved back by one
+ * @param msg message to insert
+ */
+void
+MessageQueue::insert_at(unsigned int pos, Message *msg)
+{
+	if ((max_size_ > 0) && (size_ >= max_size_)) {
+		remove_at(0);
+		--pos;
+	}
+
+	if (size_ == capacity_) {
+		unsigned int new_capacity = capacity_ * 2;
+		msg_entry_t *new_ring     = (msg_entry_t *)malloc(new_capacity * sizeof(msg_entry_t));
+		for (unsigned int i = 0; i < size_; ++i) {
+			new_ring[i] = entry(i);
+		}
+		free(ring_);
+		ring_     = new_ring;
+		capacity_ = new_capacity;
+		head_     = 0;
+	}
+
+	for (unsigned int i = size_; i > pos; --i) {
+		entry(i) = entry(i - 1);
+	}
+	entry(pos).msg    = msg;
+	entry(pos).msg_id = msg->id();
+	++size_;
+}
+
 /** Append message to queue.
  * @param msg Message to append
  * @exception MessageAlreadyQueuedException thrown if the message has already been
@@ -100,21 +161,7 @@ MessageQueue::append(Message *msg)
 	}
 	mutex_->lock();
 	msg->mark_enqueued();
-	if (list_ == NULL) {
-		list_         = (msg_list_t *)malloc(sizeof(msg_list_t));
-		list_->next   = NULL;
-		list_->msg    = msg;
-		list_->msg_id = msg->id();
-		end_el_       = list_;
-	} else {
-		msg_list_t *l = (msg_list_t *)malloc(sizeof(msg_list_t));
-		l->next       = NULL;
-		l->msg        = msg;
-		l->msg_id     = msg->id();
-		end_el_->next = l;
-		end_el_       = l;
-	}
-
+	insert_at(size_, msg);
 	mutex_->unlock();
 }
 
@@ -133,21 +180,14 @@ MessageQueue::insert_after(const MessageIterator &it, Message *msg)
 		mutex_->unlock();
 		throw NotLockedException("Message queue must be locked to insert messages after iterator.");
 	}
-	if (it.cur == NULL) {
+	if (it.at_end()) {
 		throw NullPointerException("Cannot append message at end element.");
 	}
 	if (msg->enqueued() != 0) {
 		throw MessageAlreadyQueuedException();
 	}
 	msg->mark_enqueued();
-	msg_list_t *l = (msg_list_t *)malloc(sizeof(msg_list_t));
-	l->next       = it.cur->next;
-	l->msg        = msg;
-	l->msg_id     = msg->id();
-	it.cur->next  = l;
-	if (l->next == NULL) {
-		end_el_ = l;
-	}
+	insert_at(it.pos_ + 1, msg);
 }
 
 /** Remove message from queue.
@@ -157,15 +197,10 @@ void
 MessageQueue::remove(const Message *msg)
 {
 	mutex_->lock();
-	msg_list_t *l = list_;
-	msg_list_t *p = NULL;
-	while (l) {
-		if (l->msg == msg) {
-			remove(l, p);
+	for (unsigned int i = 0; i < size_; ++i) {
+		if (entry(i).msg == msg) {
+			remove_at(i);
 			break;
-		} else {
-			p = l;
-			l = l->next;
 		}
 	}
 	mutex_->unlock();
@@ -178,39 +213,35 @@ void
 MessageQueue::remove(const unsigned int msg_id)
 {
 	mutex_->lock();
-	msg_list_t *l = list_;
-	msg_list_t *p = NULL;
-	while (l) {
-		if (l->msg_id == msg_id) {
-			remove(l, p);
+	for (unsigned int i = 0; i < size_; ++i) {
+		if (entry(i).msg_id == msg_id) {
+			remove_at(i);
 			break;
-		} else {
-			p = l;
-			l = l->next;
 		}
 	}
 	mutex_->unlock();
 }
 
-/** Remove message from list.
- * @param l list item to remove
- * @param p predecessor of element, may be NULL if there is none
+/** Remove message at position.
+ * @param pos position of the message relative to the first message
  */
 void
-MessageQueue::remove(msg_list_t *l, msg_list_t *p)
+MessageQueue::remove_at(unsigned int pos)
 {
 	if (mutex_->try_lock()) {
 		mutex_->unlock();
 		throw NotLockedException("Protected remove must be made safe by locking.");
 	}
-	if (p) {
-		p->next = l->next;
+	Message *msg = entry(pos).msg;
+	if (pos == 0) {
+		head_ = (head_ + 1) & (capacity_ - 1);
 	} else {
-		// was first element
-		list_ = l->next;
+		for (unsigned int i = pos; i < size_ - 1; ++i) {
+			entry(i) = entry(i + 1);
+		}
 	}
-	l->msg->unref();
-	free(l);
+	--size_;
+	msg->unref();
 }
 
 /** Get number of messages in queue.
@@ -220,17 +251,40 @@ unsigned int
 MessageQueue::size() const
 {
 	mutex_->lock();
-	unsigned int rv = 0;
-	msg_list_t  *l  = list_;
-	while (l) {
-		++rv;
-		l = l->next;
-	}
+	unsigned int rv = size_;
+	mutex_->unlock();
+	return rv;
+}
 
+/** Get maximum number of messages in queue.
+ * @return maximum number of messages in queue, 0 if not limited
+ */
+unsigned int
+MessageQueue::max_size() const
+{
+	mutex_->lock();
+	unsigned int rv = max_size_;
 	mutex_->unlock();
 	return rv;
 }
 
+/** Set maximum number of messages in queue.
+ * If the queue holds more messages than the new maximum, the oldest
+ * messages are dropped.
+ * @param max_size maximum number of messages in queue, 0 to not limit
+ * the queue size
+ */
+void
+MessageQueue::set_max_size(unsigned int max_size)
+{
+	mutex_->lock();
+	max_size_ = max_size;
+	while ((max_size_ > 0) && (size_ > max_size_)) {
+		remove_at(0);
+	}
+	mutex_->unlock();
+}
+
 /** Check if message queue is empty.
  * @return true if message queue is empty, false otherwise
  */
@@ -238,7 +292,7 @@ bool
 MessageQueue::empty() const
 {
 	mutex_->lock();
-	bool rv = (list_ == NULL);
+	bool rv = (size_ == 0);
 	mutex_->unlock();
 	return rv;
 }
@@ -282,8 +336,8 @@ MessageQueue::unlock()
 Message *
 MessageQueue::first()
 {
-	if (list_) {
-		return list_->msg;
+	if (size_ > 0) {
+		return entry(0).msg;
 	} else {
 		return NULL;
 	}
@@ -295,8 +349,8 @@ void
 MessageQueue::pop()
 {
 	mutex_->lock();
-	if (list_) {
-		remove(list_, NULL);
+	if (size_ > 0) {
+		remove_at(0);
 	}
 	mutex_->unlock();
 }
@@ -312,7 +366,7 @@ MessageQueue::begin()
 		mutex_->unlock();
 		throw NotLockedException("Message queue must be locked to get begin iterator.");
 	}
-	return MessageIterator(list_);
+	return MessageIterator(this, 0);
 }
 
 /** Get iterator to element beyond end of message queue list.
@@ -333,21 +387,32 @@ MessageQueue::end()
  * Message iterator.
  * Use this iterator to iterate over messages in a message queue.
  * Use MessageQueue::begin() to get the iterator.
+ *
+ * The iterator refers to a message, not to a position in the queue.
+ * If messages are added to or removed from the queue, it still points
+ * to the same message and advances to the message following it. If the
+ * message it points to is removed from the queue (or dropped because
+ * the queue is full), the iterator becomes the end iterator.
  * @author Tim Niemueller
  */
 
 /** Constructor
- * @param cur Current element for message list
+ * @param queue queue to iterate
+ * @param pos position of current message relative to the first message
  */
-MessageQueue::MessageIterator::MessageIterator(msg_list_t *cur)
+MessageQueue::MessageIterator::MessageIterator(MessageQueue *queue, unsigned int pos)
 {
-	this->cur = cur;
+	queue_ = queue;
+	set_pos(pos);
 }
 
 /** Constructor */
 MessageQueue::MessageIterator::MessageIterator()
 {
-	cur = NULL;
+	queue_  = NULL;
+	pos_    = 0;
+	msg_    = NULL;
+	msg_id_ = 0;
 }
 
 /** Copy constructor.
@@ -355,7 +420,52 @@ MessageQueue::MessageIterator::MessageIterator()
  */
 MessageQueue::MessageIterator::MessageIterator(const MessageIterator &it)
 {
-	cur = it.cur;
+	queue_  = it.queue_;
+	pos_    = it.pos_;
+	msg_    = it.msg_;
+	msg_id_ = it.msg_id_;
+}
+
+/** Point iterator to message at position.
+ * @param pos position of message relative to the first message, the
+ * iterator becomes the end iterator if it is beyond the last message
+ */
+void
+MessageQueue::MessageIterator::set_pos(unsigned int pos)
+{
+	if (pos < queue_->size_) {
+		pos_    = pos;
+		msg_    = queue_->entry(pos).msg;
+		msg_id_ = queue_->entry(pos).msg_id;
+	} else {
+		pos_    = 0;
+		msg_    = NULL;
+		msg_id_ = 0;
+	}
+}
+
+/** Check if iterator is beyond the last message.
+ * If the message has moved in the queue, the position is updated.
+ * @return true if the iterator is the end iterator or the message it
+ * pointed to is no longer in the queue
+ */
+bool
+MessageQueue::MessageIterator::at_end() const
+{
+	if ((queue_ == NULL) || (msg_ == NULL)) {
+		return true;
+	}
+	if ((pos_ < queue_->size_) && (queue_->entry(pos_).msg == msg_)
+	    && (queue_->entry(pos_).msg_id == msg_id_)) {
+		return false;
+	}
+	for (unsigned int i = 0; i < queue_->size_; ++i) {
+		if ((queue_->entry(i).msg == msg_) && (queue_->entry(i).msg_id == msg_id_)) {
+			pos_ = i;
+			return false;
+		}
+	}
+	return true;
 }
 
 /** Increment iterator.
@@ -371,8 +481,8 @@ MessageQueue::MessageIterator::MessageIterator(const MessageIterator &it)
 MessageQueue::MessageIterator &
 MessageQueue::MessageIterator::operator++()
 {
-	if (cur != NULL)
-		cur = cur->next;
+	if (!at_end())
+		set_pos(pos_ + 1);
 
 	return *this;
 }
@@ -395,16 +505,15 @@ MessageQueue::MessageIterator::operator++()
 MessageQueue::MessageIterator
 MessageQueue::MessageIterator::operator++(int inc)
 {
-	MessageIterator rv(cur);
-	if (cur != NULL)
-		cur = cur->next;
+	MessageIterator rv(*this);
+	if (!at_end())
+		set_pos(pos_ + 1);
 
 	return rv;
 }
 
 /** Advance by a certain amount.
  * Can be used to add an integer to the iterator to advance many steps in one go.
- * This operation takes linear time depending on i.
  * @param i steps to advance in list. If i is bigger than the number of remaining
  * elements in the list will stop beyond list.
  * @return reference to current instance after advancing i steps or after reaching
@@ -413,8 +522,8 @@ MessageQueue::MessageIterator::operator++(int inc)
 MessageQueue::MessageIterator &
 MessageQueue::MessageIterator::operator+(unsigned int i)
 {
-	for (unsigned int j = 0; (cur != NULL) && (j < i); ++j) {
-		cur = cur->next;
+	if (!at_end()) {
+		set_pos((i < queue_->size_ - pos_) ? pos_ + i : queue_->size_);
 	}
 	return *this;
 }
@@ -428,32 +537,32 @@ MessageQueue::MessageIterator::operator+(unsigned int i)
 MessageQueue::MessageIterator &
 MessageQueue::MessageIterator::operator+=(unsigned int i)
 {
-	for (unsigned int j = 0; (cur != NULL) && (j < i); ++j) {
-		cur = cur->next;
-	}
-	return *this;
+	return *this + i;
 }
 
 /** Check equality of two iterators.
- * Can be used to determine if two iterators point to the same chunk.
+ * Can be used to determine if two iterators point to the same message.
  * @param c iterator to compare current instance to
- * @return true, if iterators point to the same chunk, false otherwise
+ * @return true, if iterators point to the same message, false otherwise
  */
 bool
 MessageQueue::MessageIterator::operator==(const MessageIterator &c) const
 {
-	return (cur == c.cur);
+	bool end = at_end(), c_end = c.at_end();
+	if (end || c_end)
+		return end && c_end;
+	return (queue_ == c.queue_) && (msg_ == c.msg_) && (msg_id_ == c.msg_id_);
 }
 
 /** Check inequality of two iterators.
- * Can be used to determine if two iterators point to different chunks.
+ * Can be used to determine if two iterators point to different messages.
  * @param c iterator to compare current instance to
- * @return true, if iterators point to different chunks of memory, false otherwise
+ * @return true, if iterators point to different messages, false otherwise
  */
 bool
 MessageQueue::MessageIterator::operator!=(const MessageIterator &c) const
 {
-	return (cur != c.cur);
+	return !(*this == c);
 }
 
 /** Get memory pointer of chunk.
@@ -464,7 +573,7 @@ MessageQueue::MessageIterator::operator!=(const MessageIterator &c) const
 Message *
 MessageQueue::MessageIterator::operator*() const
 {
-	return (cur != NULL) ? cur->msg : NULL;
+	return at_end() ? NULL : msg_;
 }
 
 /** Act on current message.
@@ -474,7 +583,7 @@ MessageQueue::MessageIterator::operator*() const
 Message *
 MessageQueue::MessageIterator::operator->() const
 {
-	return cur->msg;
+	return msg_;
 }
 
 /** Assign iterator.
@@ -485,7 +594,10 @@ MessageQueue::MessageIterator::operator->() const
 MessageQueue::MessageIterator &
 MessageQueue::MessageIterator::operator=(const MessageIterator &c)
 {
-	this->cur = c.cur;
+	queue_  = c.queue_;
+	pos_    = c.pos_;
+	msg_    = c.msg_;
+	msg_id_ = c.msg_id_;
 	return *this;
 }
 
@@ -495,9 +607,9 @@ MessageQueue::MessageIterator::operator=(const MessageIterator &c)
 unsigned int
 MessageQueue::MessageIterator::id() const
 {
-	if (cur == NULL)
+	if (at_end())
 		return 0;
-	return cur->msg_id;
+	return msg_id_;
 }
 
 } // end namespace fawkes
@@ -41,18 +41,19 @@ public:
 class MessageQueue
 {
 private:
-	// define our own list type since std::list is way too fat
-	/** Message list, internal only
+	/** Message queue entry, internal only
    */
-	struct msg_list_t
+	struct msg_entry_t
 	{
-		msg_list_t  *next;   /**< pointer to next element in list */
 		unsigned int msg_id; /**< message id */
 		Message     *msg;    /**< pointer to message */
 	};
 
 public:
-	MessageQueue();
+	/** Default maximum number of messages in a queue. */
+	static const unsigned int DEFAULT_MAX_SIZE = 1024;
+
+	MessageQueue(unsigned int max_size = DEFAULT_MAX_SIZE);
 	virtual ~MessageQueue();
 
 	class MessageIterator
@@ -60,7 +61,9 @@ public:
 		friend MessageQueue;
 
 	private:
-		MessageIterator(msg_list_t *cur);
+		MessageIterator(MessageQueue *queue, unsigned int pos);
+		void set_pos(unsigned int pos);
+		bool at_end() const;
 
 	public:
 		MessageIterator();
@@ -84,7 +87,10 @@ public:
 		MessageType *get() const;
 
 	private:
-		msg_list_t *cur;
+		MessageQueue        *queue_;
+		mutable unsigned int pos_;
+		Message             *msg_;
+		unsigned int         msg_id_;
 	};
 
 	void append(Message *msg);
@@ -93,6 +99,8 @@ public:
 	void insert_after(const MessageIterator &it, Message *msg);
 
 	unsigned int size() const;
+	unsigned int max_size() const;
+	void         set_max_size(unsigned int max_size);
 
 	void flush();
 	bool empty() const;
@@ -108,11 +116,16 @@ public:
 	MessageIterator end();
 
 private:
-	void remove(msg_list_t *l, msg_list_t *p);
-
-	msg_list_t *list_;
-	msg_list_t *end_el_;
-	Mutex      *mutex_;
+	void         remove_at(unsigned int pos);
+	void         insert_at(unsigned int pos, Message *msg);
+	msg_entry_t &entry(unsigned int pos) const;
+
+	msg_entry_t *ring_;
+	unsigned int capacity_;
+	unsigned int max_size_;
+	unsigned int head_;
+	unsigned int size_;
+	Mutex       *mutex_;
 };
 
 /** Check if message is of given type.
@@ -124,7 +137,7 @@ template <class MessageType>
 bool
 MessageQueue::MessageIterator::is() const
 {
-	MessageType *msg = dynamic_cast<MessageType *>(cur->msg);
+	MessageType *msg = dynamic_cast<MessageType *>(msg_);
 	return (msg != 0);
 }
 
@@ -138,7 +151,7 @@ template <class MessageType>
 MessageType *
 MessageQueue::MessageIterator::get() const
 {
-	MessageType *msg = dynamic_cast<MessageType *>(cur->msg);
+	MessageType *msg = dynamic_cast<MessageType *>(msg_);
 	if (msg == 0) {
 		throw TypeMismatchException("Message types do not match (get)");
 	}
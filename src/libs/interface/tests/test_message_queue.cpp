@@ -0,0 +1,157 @@
+/***************************************************************************
+ *  test_message_queue.cpp - MessageQueue Unit Test
+ *
+ *  Created: Sun Oct 18 17:04:26 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <interface/message.h>
+#include <interface/message_queue.h>
+
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+class TestMessage : public Message
+{
+public:
+	TestMessage(unsigned int id) : Message("TestMessage")
+	{
+		data_size = sizeof(data_);
+		data_ptr  = &data_;
+		memset(data_ptr, 0, data_size);
+		data_ts = &data_;
+		set_id(id);
+	}
+
+private:
+	message_data_ts_t data_;
+};
+
+std::vector<unsigned int>
+ids(MessageQueue &q)
+{
+	std::vector<unsigned int> rv;
+	q.lock();
+	for (MessageQueue::MessageIterator i = q.begin(); i != q.end(); ++i) {
+		rv.push_back(i.id());
+	}
+	q.unlock();
+	return rv;
+}
+} // namespace
+
+TEST_CASE("Queue keeps message order while growing", "[message_queue]")
+{
+	MessageQueue q;
+	for (unsigned int i = 1; i <= 20; ++i) {
+		q.append(new TestMessage(i));
+		if (i % 3 == 0) {
+			q.pop();
+		}
+	}
+	std::vector<unsigned int> expected;
+	for (unsigned int i = 7; i <= 20; ++i) {
+		expected.push_back(i);
+	}
+	REQUIRE(q.size() == 14);
+	REQUIRE(ids(q) == expected);
+}
+
+TEST_CASE("Full queue drops oldest messages", "[message_queue]")
+{
+	MessageQueue q(4);
+	REQUIRE(q.max_size() == 4);
+	for (unsigned int i = 1; i <= 6; ++i) {
+		q.append(new TestMessage(i));
+	}
+	REQUIRE(ids(q) == std::vector<unsigned int>{3, 4, 5, 6});
+
+	q.lock();
+	q.insert_after(q.begin() + 1, new TestMessage(7));
+	q.unlock();
+	REQUIRE(ids(q) == std::vector<unsigned int>{4, 7, 5, 6});
+
+	q.set_max_size(2);
+	REQUIRE(ids(q) == std::vector<unsigned int>{5, 6});
+
+	q.set_max_size(0);
+	for (unsigned int i = 8; i <= 2000; ++i) {
+		q.append(new TestMessage(i));
+	}
+	REQUIRE(q.size() == 1995);
+}
+
+TEST_CASE("Iterator stays on its message when queue changes", "[message_queue]")
+{
+	MessageQueue q;
+	for (unsigned int i = 1; i <= 5; ++i) {
+		q.append(new TestMessage(i));
+	}
+
+	q.lock();
+	MessageQueue::MessageIterator it = q.begin() + 2;
+	q.unlock();
+	REQUIRE(it.id() == 3);
+
+	// removing messages before the iterator must not skip a message
+	q.pop();
+	q.remove(2);
+	REQUIRE(it.id() == 3);
+	REQUIRE(it->id() == 3);
+
+	// appending messages must not repeat a message
+	q.append(new TestMessage(6));
+	q.lock();
+	q.insert_after(it, new TestMessage(7));
+	q.unlock();
+
+	std::vector<unsigned int> rest;
+	q.lock();
+	for (++it; it != q.end(); ++it) {
+		rest.push_back(it.id());
+	}
+	q.unlock();
+	REQUIRE(rest == std::vector<unsigned int>{7, 4, 5, 6});
+}
+
+TEST_CASE("Iterator becomes end iterator if its message is removed", "[message_queue]")
+{
+	MessageQueue q(3);
+	for (unsigned int i = 1; i <= 3; ++i) {
+		q.append(new TestMessage(i));
+	}
+
+	q.lock();
+	MessageQueue::MessageIterator first  = q.begin();
+	MessageQueue::MessageIterator second = q.begin() + 1;
+	q.unlock();
+
+	q.remove(2);
+	REQUIRE(second == MessageQueue::MessageIterator());
+	REQUIRE(*second == NULL);
+	REQUIRE(second.id() == 0);
+
+	// dropped because the queue is full
+	q.append(new TestMessage(4));
+	q.append(new TestMessage(5));
+	REQUIRE(first == MessageQueue::MessageIterator());
+	REQUIRE(ids(q) == std::vector<unsigned int>{3, 4, 5});
+}
@@ -27,6 +27,7 @@
 
 #include <sys/types.h>
 
+#include <cstddef>
 #include <map>
 #include <string>
 
@@ -60,9 +61,32 @@ struct interface_fieldinfo_t
 	const char                 *enumtype; /**< text representation of enum type */
 	const char                 *name;     /**< Name of this field */
 	size_t                      length;   /**< Length of field (array, string) */
-	void                       *value;    /**< Current value of this field */
+	void                       *value;    /**< Current value of this field, NULL if given by offset */
 	const interface_enum_map_t *enum_map; /**< Map of possible enum values */
 	interface_fieldinfo_t      *next;     /**< next field, NULL if last */
+	size_t                      offset;   /**< Offset of value from start of data */
+};
+
+/** Constant of an interface enum type. */
+struct interface_enum_constant_t
+{
+	int         value; /**< numeric value of the constant */
+	const char *name;  /**< name of the constant */
+};
+
+/** Compile-time description of an interface or message field.
+ * Generated interfaces and messages provide a constexpr table of these
+ * descriptors and pass them to visitors, see visit_fields().
+ */
+struct interface_field_descriptor_t
+{
+	const char                      *name;               /**< Name of this field */
+	interface_fieldtype_t            type;               /**< type of this field */
+	const char                      *enumtype;           /**< enum type name, NULL if no enum */
+	size_t                           length;             /**< Length of field (array, string) */
+	size_t                           offset;             /**< Offset of value from start of data */
+	const interface_enum_constant_t *enum_constants;     /**< constants of enum type */
+	unsigned int                     num_enum_constants; /**< number of enum constants */
 };
 
 } // namespace fawkes
@@ -27,6 +27,7 @@
 #include <utils/misc/string_conversions.h>
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <time.h>
@@ -221,9 +222,11 @@ CppInterfaceGenerator::write_cpp(FILE *f)
 	write_header(f, filename_cpp);
 	fprintf(f,
 	        "#include <interfaces/%s>\n\n"
-	        "#include <core/exceptions/software.h>\n\n"
+	        "#include <core/exceptions/software.h>\n"
+	        "#include <interface/message_pool.h>\n\n"
 	        "#include <map>\n"
 	        "#include <string>\n"
+	        "#include <cstddef>\n"
 	        "#include <cstring>\n"
 	        "#include <cstdlib>\n\n"
 	        "namespace fawkes {\n\n"
@@ -242,6 +245,7 @@ CppInterfaceGenerator::write_cpp(FILE *f)
 	write_enum_constants_tostring_cpp(f);
 	write_methods_cpp(f, class_name, class_name, data_fields, pseudo_maps, "");
 	write_basemethods_cpp(f);
+	write_field_descriptors_cpp(f, class_name, data_fields);
 	write_messages_cpp(f);
 
 	write_management_funcs_cpp(f);
@@ -356,9 +360,22 @@ CppInterfaceGenerator::write_constants_h(FILE *f)
 		}
 		fprintf(f, "  } %s;\n", (*i).get_name().c_str());
 		fprintf(f,
-		        "  const char * tostring_%s(%s value) const;\n\n",
+		        "  const char * tostring_%s(%s value) const;\n",
 		        i->get_name().c_str(),
 		        i->get_name().c_str());
+		fprintf(f,
+		        "  /** Constants of %s. */\n"
+		        "  static constexpr interface_enum_constant_t enum_constants_%s[] = {",
+		        i->get_name().c_str(),
+		        i->get_name().c_str());
+		for (j = items.begin(); j != items.end(); ++j) {
+			fprintf(f,
+			        "%s\n    {%s, \"%s\"}",
+			        (j != items.begin()) ? "," : "",
+			        j->name.c_str(),
+			        j->name.c_str());
+		}
+		fprintf(f, "};\n\n");
 	}
 }
 
@@ -377,14 +394,21 @@ CppInterfaceGenerator::write_messages_h(FILE *f)
 
 		fprintf(f, "   private:\n");
 		write_struct(f, (*i).getName() + "_data_t", "    ", (*i).getFields());
-		fprintf(f, "    %s_data_t *data;\n\n", (*i).getName().c_str());
-
-		write_enum_maps_h(f);
+		fprintf(f,
+		        "    %s_data_t *data;\n"
+		        "    %s_data_t  data_buffer_;\n\n"
+		        "    static interface_fieldinfo_t *shared_fieldinfo();\n\n",
+		        (*i).getName().c_str(),
+		        (*i).getName().c_str());
 
 		fprintf(f, "   public:\n");
 		write_message_ctor_dtor_h(f, "    ", (*i).getName(), (*i).getFields());
 		write_methods_h(f, "    ", (*i).getFields());
 		write_message_clone_method_h(f, "    ");
+		write_field_descriptors_h(f, "    ", (*i).getName(), (*i).getFields());
+		fprintf(f,
+		        "    static void *operator new(size_t size);\n"
+		        "    static void  operator delete(void *ptr, size_t size);\n");
 		fprintf(f, "  };\n\n");
 	}
 	fprintf(f, "  virtual bool message_valid(const Message *message) const;\n");
@@ -409,9 +433,12 @@ CppInterfaceGenerator::write_messages_cpp(FILE *f)
 		        (*i).getName().c_str(),
 		        (*i).getComment().c_str());
 
+		write_message_fieldinfo_cpp(f, (*i).getName(), class_name + "::", (*i).getFields());
 		write_message_ctor_dtor_cpp(f, (*i).getName(), "Message", class_name + "::", (*i).getFields());
 		write_methods_cpp(f, class_name, (*i).getName(), (*i).getFields(), class_name + "::");
 		write_message_clone_method_cpp(f, (class_name + "::" + (*i).getName()).c_str());
+		write_message_pool_cpp(f, (*i).getName(), class_name + "::");
+		write_field_descriptors_cpp(f, class_name + "::" + (*i).getName(), (*i).getFields());
 	}
 	fprintf(f,
 	        "/** Check if message is valid and can be enqueued.\n"
@@ -627,6 +654,251 @@ CppInterfaceGenerator::write_message_clone_method_cpp(FILE *f, std::string class
 	        classname.c_str());
 }
 
+/** Write shared field info of a message to cpp file.
+ * The field info list and the enum maps are built once per message type
+ * and shared by all instances. Values are given as offsets into the data
+ * struct.
+ * @param f file to write to
+ * @param classname name of message class
+ * @param inclusion_prefix prefix of the enclosing interface class
+ * @param fields fields of the message
+ */
+void
+CppInterfaceGenerator::write_message_fieldinfo_cpp(FILE                       *f,
+                                                   std::string                 classname,
+                                                   std::string                 inclusion_prefix,
+                                                   std::vector<InterfaceField> fields)
+{
+	fprintf(f,
+	        "/** Get field info shared by all instances of this message type.\n"
+	        " * @return first entry of the field info list, values are given as\n"
+	        " * offsets into the message data\n"
+	        " */\n"
+	        "interface_fieldinfo_t *\n"
+	        "%s%s::shared_fieldinfo()\n"
+	        "{\n",
+	        inclusion_prefix.c_str(),
+	        classname.c_str());
+
+	if (fields.empty()) {
+		fprintf(f,
+		        "  return NULL;\n"
+		        "}\n\n");
+		return;
+	}
+
+	std::vector<std::string> enum_types;
+	for (const InterfaceField &field : fields) {
+		if (strcmp(fieldinfo_type(field), "ENUM") == 0
+		    && std::find(enum_types.begin(), enum_types.end(), field.getType()) == enum_types.end()) {
+			enum_types.push_back(field.getType());
+		}
+	}
+	for (const std::string &enum_type : enum_types) {
+		for (const InterfaceEnumConstant &e : enum_constants) {
+			if (e.get_name() != enum_type)
+				continue;
+			fprintf(f, "  static const interface_enum_map_t enum_map_%s = {", enum_type.c_str());
+			const std::vector<InterfaceEnumConstant::EnumItem> &items = e.get_items();
+			for (size_t j = 0; j < items.size(); ++j) {
+				fprintf(f,
+				        "%s\n    {(int)%s, \"%s\"}",
+				        j > 0 ? "," : "",
+				        items[j].name.c_str(),
+				        items[j].name.c_str());
+			}
+			fprintf(f, "};\n");
+		}
+	}
+
+	fprintf(f, "  static interface_fieldinfo_t fieldinfo[] = {\n");
+	for (size_t j = 0; j < fields.size(); ++j) {
+		const InterfaceField &field   = fields[j];
+		const char           *type    = fieldinfo_type(field);
+		bool                  is_enum = (strcmp(type, "ENUM") == 0);
+		std::string           next    = "NULL";
+		if (j + 1 < fields.size()) {
+			next = "&fieldinfo[" + std::to_string(j + 1) + "]";
+		}
+		fprintf(f,
+		        "    {IFT_%s, %s%s%s, \"%s\", %u, NULL, %s%s, %s, offsetof(%s_data_t, %s)}%s\n",
+		        type,
+		        is_enum ? "\"" : "",
+		        is_enum ? field.getType().c_str() : "NULL",
+		        is_enum ? "\"" : "",
+		        field.getName().c_str(),
+		        (field.getLengthValue() > 0) ? field.getLengthValue() : 1,
+		        is_enum ? "&enum_map_" : "NULL",
+		        is_enum ? field.getType().c_str() : "",
+		        next.c_str(),
+		        classname.c_str(),
+		        field.getName().c_str(),
+		        (j + 1 < fields.size()) ? "," : "");
+	}
+	fprintf(f,
+	        "  };\n"
+	        "  return fieldinfo;\n"
+	        "}\n\n");
+}
+
+/** Write pooled allocation operators of a message to cpp file.
+ * @param f file to write to
+ * @param classname name of message class
+ * @param inclusion_prefix prefix of the enclosing interface class
+ */
+void
+CppInterfaceGenerator::write_message_pool_cpp(FILE       *f,
+                                              std::string classname,
+                                              std::string inclusion_prefix)
+{
+	fprintf(f,
+	        "/** Allocate memory for message.\n"
+	        " * Messages are allocated from a free-list pool per message type.\n"
+	        " * @param size size of the message\n"
+	        " * @return memory for the message\n"
+	        " */\n"
+	        "void *\n"
+	        "%s%s::operator new(size_t size)\n"
+	        "{\n"
+	        "  return MessagePool::of<%s>().allocate(size);\n"
+	        "}\n\n"
+	        "/** Release memory of message.\n"
+	        " * @param ptr memory of the message\n"
+	        " * @param size size of the message\n"
+	        " */\n"
+	        "void\n"
+	        "%s%s::operator delete(void *ptr, size_t size)\n"
+	        "{\n"
+	        "  MessagePool::of<%s>().release(ptr, size);\n"
+	        "}\n\n",
+	        inclusion_prefix.c_str(),
+	        classname.c_str(),
+	        classname.c_str(),
+	        inclusion_prefix.c_str(),
+	        classname.c_str(),
+	        classname.c_str());
+}
+
+/** Write compile-time field descriptors and field visitor to h file.
+ * @param f file to write to
+ * @param is indentation space
+ * @param classname name of class, the data struct is named classname_data_t
+ * @param fields fields to describe
+ */
+void
+CppInterfaceGenerator::write_field_descriptors_h(FILE                          *f,
+                                                 std::string /* indent space */ is,
+                                                 std::string                    classname,
+                                                 std::vector<InterfaceField>    fields)
+{
+	fprintf(f,
+	        "\n%s/** Number of fields. */\n"
+	        "%sstatic constexpr unsigned int num_fields = %zu;\n"
+	        "%s/** Compile-time descriptors of the fields. */\n",
+	        is.c_str(),
+	        is.c_str(),
+	        fields.size(),
+	        is.c_str());
+	if (fields.empty()) {
+		fprintf(f,
+		        "%sstatic constexpr const interface_field_descriptor_t *field_descriptors = NULL;\n\n"
+		        "%s/** Visit all fields, see fawkes::visit_fields(). */\n"
+		        "%stemplate <class Visitor>\n"
+		        "%svoid visit_fields(Visitor &&) const\n"
+		        "%s{\n"
+		        "%s}\n\n",
+		        is.c_str(),
+		        is.c_str(),
+		        is.c_str(),
+		        is.c_str(),
+		        is.c_str(),
+		        is.c_str());
+		return;
+	}
+
+	fprintf(f, "%sstatic constexpr interface_field_descriptor_t field_descriptors[] = {", is.c_str());
+	for (size_t j = 0; j < fields.size(); ++j) {
+		const InterfaceField &field   = fields[j];
+		bool                  is_enum = (strcmp(fieldinfo_type(field), "ENUM") == 0);
+		std::string           num_enum_constants = "0";
+		if (is_enum) {
+			for (const InterfaceEnumConstant &e : enum_constants) {
+				if (e.get_name() == field.getType()) {
+					num_enum_constants = std::to_string(e.get_items().size());
+				}
+			}
+		}
+		fprintf(f,
+		        "%s\n%s  {\"%s\", IFT_%s, %s%s%s, %u, offsetof(%s_data_t, %s), %s%s, %s}",
+		        (j > 0) ? "," : "",
+		        is.c_str(),
+		        field.getName().c_str(),
+		        fieldinfo_type(field),
+		        is_enum ? "\"" : "",
+		        is_enum ? field.getType().c_str() : "NULL",
+		        is_enum ? "\"" : "",
+		        (field.getLengthValue() > 0) ? field.getLengthValue() : 1,
+		        classname.c_str(),
+		        field.getName().c_str(),
+		        is_enum ? "enum_constants_" : "NULL",
+		        is_enum ? field.getType().c_str() : "",
+		        num_enum_constants.c_str());
+	}
+	fprintf(f,
+	        "};\n\n"
+	        "%s/** Visit all fields, see fawkes::visit_fields().\n"
+	        "%s * @param visitor visitor to call for each field */\n"
+	        "%stemplate <class Visitor>\n"
+	        "%svoid visit_fields(Visitor &&visitor) const\n"
+	        "%s{\n",
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str());
+	for (size_t j = 0; j < fields.size(); ++j) {
+		fprintf(f,
+		        "%s  visitor(field_descriptors[%zu], %sdata->%s);\n",
+		        is.c_str(),
+		        j,
+		        (fields[j].getLengthValue() > 0) ? "" : "&",
+		        fields[j].getName().c_str());
+	}
+	fprintf(f, "%s}\n\n", is.c_str());
+}
+
+/** Write definitions of compile-time field descriptors to cpp file.
+ * The tables are defined in the header, but still need a definition
+ * in case they are odr-used.
+ * @param f file to write to
+ * @param classname fully qualified name of class
+ * @param fields fields of class
+ */
+void
+CppInterfaceGenerator::write_field_descriptors_cpp(FILE                       *f,
+                                                   std::string                 classname,
+                                                   std::vector<InterfaceField> fields)
+{
+	if (classname == class_name) {
+		for (const InterfaceEnumConstant &e : enum_constants) {
+			fprintf(f,
+			        "constexpr interface_enum_constant_t %s::enum_constants_%s[];\n",
+			        class_name.c_str(),
+			        e.get_name().c_str());
+		}
+	}
+	fprintf(f, "constexpr unsigned int %s::num_fields;\n", classname.c_str());
+	if (fields.empty()) {
+		fprintf(f,
+		        "constexpr const interface_field_descriptor_t *%s::field_descriptors;\n\n",
+		        classname.c_str());
+	} else {
+		fprintf(f,
+		        "constexpr interface_field_descriptor_t %s::field_descriptors[];\n\n",
+		        classname.c_str());
+	}
+}
+
 /** Write enum maps.
  * @param f file to write to
  */
@@ -649,6 +921,45 @@ CppInterfaceGenerator::write_enum_map_population(FILE *f)
 	}
 }
 
+/** Get field type constant suffix for field info.
+ * @param field field to get the type for
+ * @return suffix of the IFT_* constant for the field type
+ */
+const char *
+CppInterfaceGenerator::fieldinfo_type(const InterfaceField &field)
+{
+	const std::string &t = field.getType();
+	if (t == "bool") {
+		return "BOOL";
+	} else if (t == "int8") {
+		return "INT8";
+	} else if (t == "uint8") {
+		return "UINT8";
+	} else if (t == "int16") {
+		return "INT16";
+	} else if (t == "uint16") {
+		return "UINT16";
+	} else if (t == "int32") {
+		return "INT32";
+	} else if (t == "uint32") {
+		return "UINT32";
+	} else if (t == "int64") {
+		return "INT64";
+	} else if (t == "uint64") {
+		return "UINT64";
+	} else if (t == "byte") {
+		return "BYTE";
+	} else if (t == "float") {
+		return "FLOAT";
+	} else if (t == "double") {
+		return "DOUBLE";
+	} else if (t == "string") {
+		return "STRING";
+	} else {
+		return "ENUM";
+	}
+}
+
 /** Write the add_fieldinfo() calls.
  * @param f file to write to
  * @param fields fields to write field info for
@@ -658,39 +969,11 @@ CppInterfaceGenerator::write_add_fieldinfo_calls(FILE *f, std::vector<InterfaceF
 {
 	std::vector<InterfaceField>::iterator i;
 	for (i = fields.begin(); i != fields.end(); ++i) {
-		const char *type    = "";
-		const char *dataptr = "&";
+		const char *type    = fieldinfo_type(*i);
+		const char *dataptr = (i->getType() == "string") ? "" : "&";
 		std::string enumtype;
 
-		if (i->getType() == "bool") {
-			type = "BOOL";
-		} else if (i->getType() == "int8") {
-			type = "INT8";
-		} else if (i->getType() == "uint8") {
-			type = "UINT8";
-		} else if (i->getType() == "int16") {
-			type = "INT16";
-		} else if (i->getType() == "uint16") {
-			type = "UINT16";
-		} else if (i->getType() == "int32") {
-			type = "INT32";
-		} else if (i->getType() == "uint32") {
-			type = "UINT32";
-		} else if (i->getType() == "int64") {
-			type = "INT64";
-		} else if (i->getType() == "uint64") {
-			type = "UINT64";
-		} else if (i->getType() == "byte") {
-			type = "BYTE";
-		} else if (i->getType() == "float") {
-			type = "FLOAT";
-		} else if (i->getType() == "double") {
-			type = "DOUBLE";
-		} else if (i->getType() == "string") {
-			type    = "STRING";
-			dataptr = "";
-		} else {
-			type     = "ENUM";
+		if (strcmp(type, "ENUM") == 0) {
 			enumtype = i->getType();
 		}
 
@@ -816,7 +1099,7 @@ CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE                       *f
 		        ") : %s(\"%s\")\n"
 		        "{\n"
 		        "  data_size = sizeof(%s_data_t);\n"
-		        "  data_ptr  = malloc(data_size);\n"
+		        "  data_ptr  = &data_buffer_;\n"
 		        "  memset(data_ptr, 0, data_size);\n"
 		        "  data      = (%s_data_t *)data_ptr;\n"
 		        "  data_ts   = (message_data_ts_t *)data_ptr;\n",
@@ -848,9 +1131,7 @@ CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE                       *f
 			}
 		}
 
-		write_enum_map_population(f);
-		write_add_fieldinfo_calls(f, fields);
-
+		fprintf(f, "  set_fieldinfo(shared_fieldinfo(), %zu);\n", fields.size());
 		fprintf(f, "}\n");
 	}
 
@@ -866,22 +1147,20 @@ CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE                       *f
 
 	fprintf(f,
 	        "  data_size = sizeof(%s_data_t);\n"
-	        "  data_ptr  = malloc(data_size);\n"
+	        "  data_ptr  = &data_buffer_;\n"
 	        "  memset(data_ptr, 0, data_size);\n"
 	        "  data      = (%s_data_t *)data_ptr;\n"
 	        "  data_ts   = (message_data_ts_t *)data_ptr;\n",
 	        classname.c_str(),
 	        classname.c_str());
 
-	write_enum_map_population(f);
-	write_add_fieldinfo_calls(f, fields);
+	fprintf(f, "  set_fieldinfo(shared_fieldinfo(), %zu);\n", fields.size());
 
 	fprintf(f,
 	        "}\n\n"
 	        "/** Destructor */\n"
 	        "%s%s::~%s()\n"
 	        "{\n"
-	        "  free(data_ptr);\n"
 	        "}\n\n",
 	        inclusion_prefix.c_str(),
 	        classname.c_str(),
@@ -891,7 +1170,7 @@ CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE                       *f
 	        "/** Copy constructor.\n"
 	        " * @param m message to copy from\n"
 	        " */\n"
-	        "%s%s::%s(const %s *m) : %s(m)\n"
+	        "%s%s::%s(const %s *m) : %s(m, false)\n"
 	        "{\n",
 	        inclusion_prefix.c_str(),
 	        classname.c_str(),
@@ -901,7 +1180,7 @@ CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE                       *f
 
 	fprintf(f,
 	        "  data_size = m->data_size;\n"
-	        "  data_ptr  = malloc(data_size);\n"
+	        "  data_ptr  = &data_buffer_;\n"
 	        "  memcpy(data_ptr, m->data_ptr, data_size);\n"
 	        "  data      = (%s_data_t *)data_ptr;\n"
 	        "  data_ts   = (message_data_ts_t *)data_ptr;\n",
@@ -1243,7 +1522,9 @@ CppInterfaceGenerator::write_h(FILE *f)
 	fprintf(f,
 	        "#include <interface/interface.h>\n"
 	        "#include <interface/message.h>\n"
-	        "#include <interface/field_iterator.h>\n\n"
+	        "#include <interface/field_iterator.h>\n"
+	        "#include <interface/field_visitor.h>\n\n"
+	        "#include <cstddef>\n\n"
 	        "namespace fawkes {\n\n"
 	        "class %s : public Interface\n"
 	        "{\n"
@@ -1272,6 +1553,7 @@ CppInterfaceGenerator::write_h(FILE *f)
 	fprintf(f, " public:\n");
 	write_methods_h(f, "  ", data_fields, pseudo_maps);
 	write_basemethods_h(f, "  ");
+	write_field_descriptors_h(f, "  ", class_name, data_fields);
 	fprintf(f, "\n};\n\n} // end namespace fawkes\n\n#endif\n");
 }
 
@@ -80,6 +80,18 @@ public:
 	                                 std::vector<InterfaceField> fields);
 	void write_message_clone_method_h(FILE *f, std::string is);
 	void write_message_clone_method_cpp(FILE *f, std::string classname);
+	void write_message_fieldinfo_cpp(FILE                       *f,
+	                                 std::string                 classname,
+	                                 std::string                 inclusion_prefix,
+	                                 std::vector<InterfaceField> fields);
+	void write_message_pool_cpp(FILE *f, std::string classname, std::string inclusion_prefix);
+	void write_field_descriptors_h(FILE                          *f,
+	                               std::string /* indent space */ is,
+	                               std::string                    classname,
+	                               std::vector<InterfaceField>    fields);
+	void write_field_descriptors_cpp(FILE                       *f,
+	                                 std::string                 classname,
+	                                 std::vector<InterfaceField> fields);
 
 	void
 	write_methods_h(FILE *f, std::string /* indent space */ is, std::vector<InterfaceField> fields);
@@ -108,8 +120,9 @@ public:
 
 	void write_management_funcs_cpp(FILE *f);
 
-	void write_enum_map_population(FILE *f);
-	void write_add_fieldinfo_calls(FILE *f, std::vector<InterfaceField> &fields);
+	void        write_enum_map_population(FILE *f);
+	void        write_add_fieldinfo_calls(FILE *f, std::vector<InterfaceField> &fields);
+	const char *fieldinfo_type(const InterfaceField &field);
 
 	void write_struct(FILE                          *f,
 	                  std::string                    name,
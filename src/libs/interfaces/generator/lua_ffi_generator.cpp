@@ -0,0 +1,252 @@
+/***************************************************************************
+ *  lua_ffi_generator.cpp - LuaJIT FFI Interface generator
+ *
+ *  Created: Mon Oct 19 02:44:52 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "lua_ffi_generator.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/** @class LuaFFIInterfaceGenerator <interfaces/generator/lua_ffi_generator.h>
+ * Generator that creates a Lua module with LuaJIT FFI definitions.
+ * The module declares the interface's data struct with ffi.cdef in the
+ * same layout as the struct of the generated C++ class. It allows to read
+ * fields directly from the data chunk of an interface instance instead of
+ * calling a tolua++ generated getter per field. The module is only usable
+ * if Fawkes is built with LuaJIT.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param directory Directory where to create the files
+ * @param interface_name name of the interface, should end with Interface
+ * @param config_basename basename of the config without suffix
+ * @param author author of interface
+ * @param year year of copyright
+ * @param creation_date user-supplied creation date of interface
+ * @param hash MD5 hash of the config file that was used to generate the interface
+ * @param hash_size size in bytes of hash
+ * @param constants constants
+ * @param enum_constants constants defined as an enum
+ * @param data_fields data fields of the interface
+ */
+LuaFFIInterfaceGenerator::LuaFFIInterfaceGenerator(
+  std::string                               directory,
+  std::string                               interface_name,
+  std::string                               config_basename,
+  std::string                               author,
+  std::string                               year,
+  std::string                               creation_date,
+  const unsigned char                      *hash,
+  size_t                                    hash_size,
+  const std::vector<InterfaceConstant>     &constants,
+  const std::vector<InterfaceEnumConstant> &enum_constants,
+  const std::vector<InterfaceField>        &data_fields)
+{
+	this->dir = directory;
+	if (dir.find_last_of("/") != (dir.length() - 1)) {
+		dir += "/";
+	}
+	this->author         = author;
+	this->year           = year;
+	this->creation_date  = creation_date;
+	this->hash           = hash;
+	this->hash_size      = hash_size;
+	this->constants      = constants;
+	this->enum_constants = enum_constants;
+	this->data_fields    = data_fields;
+
+	filename_lua = config_basename + "_ffi.lua";
+
+	if (interface_name.find("Interface", 0) == string::npos) {
+		// append Interface
+		class_name = interface_name + "Interface";
+	} else {
+		class_name = interface_name;
+	}
+	struct_name = "fawkes_" + class_name + "_data_t";
+}
+
+/** Destructor */
+LuaFFIInterfaceGenerator::~LuaFFIInterfaceGenerator()
+{
+}
+
+/** Write header to file.
+ * @param f file to write to
+ * @param filename name of file
+ */
+void
+LuaFFIInterfaceGenerator::write_header(FILE *f, std::string filename)
+{
+	fprintf(f,
+	        "\n------------------------------------------------------------------------\n"
+	        "--  %s - Fawkes BlackBoard Interface - %s - LuaJIT FFI\n"
+	        "--\n",
+	        filename.c_str(),
+	        class_name.c_str());
+	if (creation_date.length() > 0) {
+		fprintf(f, "--  Interface created: %s\n", creation_date.c_str());
+	}
+	fprintf(f,
+	        "--  Copyright  %s  %s\n"
+	        "------------------------------------------------------------------------\n\n",
+	        year.c_str(),
+	        ((author.length() > 0) ? author.c_str() : "AllemaniACs RoboCup Team"));
+	fprintf(f,
+	        "--  This program is free software; you can redistribute it and/or modify\n"
+	        "--  it under the terms of the GNU General Public License as published by\n"
+	        "--  the Free Software Foundation; either version 2 of the License, or\n"
+	        "--  (at your option) any later version.\n"
+	        "--\n"
+	        "--  This program is distributed in the hope that it will be useful,\n"
+	        "--  but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+	        "--  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"
+	        "--  GNU Library General Public License for more details.\n"
+	        "--\n"
+	        "--  Read the full text in the LICENSE.GPL file in the doc directory.\n\n");
+}
+
+/** Write data struct definition.
+ * The struct must match the one written by
+ * CppInterfaceGenerator::write_struct() field by field.
+ * @param f file to write to
+ */
+void
+LuaFFIInterfaceGenerator::write_cdef(FILE *f)
+{
+	fprintf(f,
+	        "ffi.cdef[[\n"
+	        "typedef struct {\n"
+	        "  int64_t timestamp_sec;\n"
+	        "  int64_t timestamp_usec;\n");
+
+	for (vector<InterfaceField>::iterator i = data_fields.begin(); i != data_fields.end(); ++i) {
+		fprintf(f, "  %s %s", (*i).getStructType().c_str(), (*i).getName().c_str());
+		if ((*i).getLength().length() > 0) {
+			fprintf(f, "[%s]", (*i).getLength().c_str());
+		}
+		fprintf(f, ";\n");
+	}
+
+	fprintf(f, "} %s;\n]]\n\n", struct_name.c_str());
+}
+
+/** Write constants and enum values as module fields.
+ * @param f file to write to
+ */
+void
+LuaFFIInterfaceGenerator::write_constants(FILE *f)
+{
+	for (vector<InterfaceConstant>::iterator i = constants.begin(); i != constants.end(); ++i) {
+		if (i->getType() == "string") {
+			fprintf(f, "M.%s = \"%s\"\n", i->getName().c_str(), i->getValue().c_str());
+		} else {
+			fprintf(f, "M.%s = %s\n", i->getName().c_str(), i->getValue().c_str());
+		}
+	}
+
+	for (vector<InterfaceEnumConstant>::iterator i = enum_constants.begin();
+	     i != enum_constants.end();
+	     ++i) {
+		fprintf(f, "M.%s = {\n", i->get_name().c_str());
+		const vector<InterfaceEnumConstant::EnumItem> &items = i->get_items();
+		int                                            value = 0;
+		for (vector<InterfaceEnumConstant::EnumItem>::const_iterator j = items.begin();
+		     j != items.end();
+		     ++j) {
+			if (j->has_custom_value) {
+				value = j->custom_value;
+			}
+			fprintf(f, "  %s = %i,\n", j->name.c_str(), value++);
+		}
+		fprintf(f, "}\n");
+	}
+	if (!constants.empty() || !enum_constants.empty()) {
+		fprintf(f, "\n");
+	}
+}
+
+/** Write Lua module.
+ * @param f file to write to
+ */
+void
+LuaFFIInterfaceGenerator::write_luaf(FILE *f)
+{
+	write_header(f, filename_lua);
+
+	fprintf(f, "local ffi = require(\"ffi\")\n\n");
+	write_cdef(f);
+
+	string hash_printable;
+	for (size_t i = 0; i < hash_size; ++i) {
+		char tmp[3];
+		snprintf(tmp, sizeof(tmp), "%02X", hash[i]);
+		hash_printable += tmp;
+	}
+
+	fprintf(f,
+	        "local M = {}\n\n"
+	        "M.type = \"%s\"\n"
+	        "M.hash = \"%s\"\n"
+	        "M.ctype = ffi.typeof(\"const %s *\")\n\n",
+	        class_name.c_str(),
+	        hash_printable.c_str(),
+	        struct_name.c_str());
+
+	write_constants(f);
+
+	fprintf(f,
+	        "--- Get view on data of an interface instance.\n"
+	        "-- The view reads directly from the interface's local data, i.e. it\n"
+	        "-- reflects the data of the last read() and remains valid as long as\n"
+	        "-- the interface is open. String fields are char arrays, convert them\n"
+	        "-- with ffi.string().\n"
+	        "-- @param iface %s instance\n"
+	        "-- @return read-only pointer to the interface data\n"
+	        "function M.view(iface)\n"
+	        "  assert(iface:hash_printable() == M.hash,\n"
+	        "         \"Interface \" .. iface:uid() .. \" does not match FFI definition\")\n"
+	        "  assert(iface:datasize() == ffi.sizeof(\"%s\"),\n"
+	        "         \"Data size of \" .. iface:uid() .. \" does not match FFI definition\")\n"
+	        "  return ffi.cast(M.ctype, iface:datachunk())\n"
+	        "end\n\n"
+	        "return M\n",
+	        class_name.c_str(),
+	        struct_name.c_str());
+}
+
+/** Generate Lua file. */
+void
+LuaFFIInterfaceGenerator::generate()
+{
+	FILE *luaf = fopen(string(dir + filename_lua).c_str(), "w");
+
+	if (luaf == NULL) {
+		printf("Cannot open Lua file %s%s\n", dir.c_str(), filename_lua.c_str());
+		return;
+	}
+
+	write_luaf(luaf);
+
+	fclose(luaf);
+}
@@ -0,0 +1,74 @@
+
+/***************************************************************************
+ *  lua_ffi_generator.h - LuaJIT FFI Interface generator
+ *
+ *  Created: Mon Oct 19 02:41:18 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _INTERFACES_GENERATOR_LUA_FFI_GENERATOR_H_
+#define _INTERFACES_GENERATOR_LUA_FFI_GENERATOR_H_
+
+#include "constant.h"
+#include "enum_constant.h"
+#include "field.h"
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+class LuaFFIInterfaceGenerator
+{
+public:
+	LuaFFIInterfaceGenerator(std::string                               directory,
+	                         std::string                               interface_name,
+	                         std::string                               config_basename,
+	                         std::string                               author,
+	                         std::string                               year,
+	                         std::string                               creation_date,
+	                         const unsigned char                      *hash,
+	                         size_t                                    hash_size,
+	                         const std::vector<InterfaceConstant>     &constants,
+	                         const std::vector<InterfaceEnumConstant> &enum_constants,
+	                         const std::vector<InterfaceField>        &data_fields);
+	~LuaFFIInterfaceGenerator();
+
+	void write_luaf(FILE *f);
+	void write_header(FILE *f, std::string filename);
+	void write_cdef(FILE *f);
+	void write_constants(FILE *f);
+
+	void generate();
+
+private:
+	std::vector<InterfaceConstant>     constants;
+	std::vector<InterfaceEnumConstant> enum_constants;
+	std::vector<InterfaceField>        data_fields;
+
+	std::string dir;
+	std::string filename_lua;
+	std::string class_name;
+	std::string struct_name;
+	std::string author;
+	std::string year;
+	std::string creation_date;
+
+	const unsigned char *hash;
+	size_t               hash_size;
+};
+
+#endif
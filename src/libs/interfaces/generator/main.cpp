@@ -23,6 +23,7 @@
 #include <interfaces/generator/cpp_generator.h>
 #include <interfaces/generator/digest.h>
 #include <interfaces/generator/exceptions.h>
+#include <interfaces/generator/lua_ffi_generator.h>
 #include <interfaces/generator/parser.h>
 #include <interfaces/generator/tolua_generator.h>
 #include <utils/system/argparser.h>
@@ -39,17 +40,19 @@ int
 main(int argc, char **argv)
 {
 	int             rv   = 0;
-	ArgumentParser *argp = new ArgumentParser(argc, argv, "hd:v");
+	ArgumentParser *argp = new ArgumentParser(argc, argv, "hd:l:v");
 
 	const vector<const char *> &items = argp->items();
 	if (items.size() == 0 || argp->has_arg("h")) {
 		cout << "Fawkes Interface generator - Usage Instructions" << endl
 		     << "==============================================================================="
 		     << endl
-		     << "Usage: " << argv[0] << " [-h] [-d dir] [-v] config.xml [config2.xml...]" << endl
+		     << "Usage: " << argv[0] << " [-h] [-d dir] [-l dir] [-v] config.xml [config2.xml...]"
+		     << endl
 		     << "where [options] is one or more of:" << endl
 		     << " -h        These help instructions" << endl
 		     << " -d dir    Directory where to write generated files" << endl
+		     << " -l dir    Directory where to write LuaJIT FFI modules, none if omitted" << endl
 		     << " -v        Verbose console output." << endl
 		     << endl;
 	} else {
@@ -124,11 +127,30 @@ main(int argc, char **argv)
 				                              iparse->getPseudoMaps(),
 				                              iparse->getMessages());
 
+				LuaFFIInterfaceGenerator *ffiigen = NULL;
+				if (argp->has_arg("l")) {
+					ffiigen = new LuaFFIInterfaceGenerator(argp->arg("l"),
+					                                       iparse->getInterfaceName(),
+					                                       prefix,
+					                                       iparse->getInterfaceAuthor(),
+					                                       iparse->getInterfaceYear(),
+					                                       iparse->getInterfaceCreationDate(),
+					                                       idigest->get_hash(),
+					                                       idigest->get_hash_size(),
+					                                       iparse->getConstants(),
+					                                       iparse->getEnumConstants(),
+					                                       iparse->getDataFields());
+				}
+
 				cppigen->generate();
 				toluaigen->generate();
+				if (ffiigen) {
+					ffiigen->generate();
+				}
 
 				delete cppigen;
 				delete toluaigen;
+				delete ffiigen;
 
 				delete iparse;
 				delete idigest;
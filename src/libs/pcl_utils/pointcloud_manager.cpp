@@ -37,15 +37,62 @@ namespace fawkes {
  *
  * @fn const RefPtr<const pcl::PointCloud<PointT> > PointCloudManager::get_pointcloud(const char *id)
  * Get point cloud.
+ * This is the cloud registered with add_pointcloud(). If the cloud is
+ * published as snapshots, it is only updated if it is referenced outside
+ * of the manager, which requires a copy per snapshot. Prefer
+ * get_snapshot() or wait_snapshot() in that case.
  * @param id ID of point cloud to retrieve
  * @return point cloud
  * @exception Exception thrown if point cloud for given ID does not exist
  *
+ * @fn RefPtr<pcl::PointCloud<PointT>> PointCloudManager::acquire_pointcloud_buffer(const char *id)
+ * Acquire buffer to publish a snapshot in.
+ * Up to MAX_SNAPSHOT_BUFFERS buffers are kept per point cloud and
+ * re-used once they are no longer referenced by any consumer, i.e.,
+ * producers do not allocate memory once consumers keep up. The buffer
+ * contains the data of an earlier snapshot, or of the registered cloud
+ * for new buffers, which the producer must overwrite.
+ * @param id ID of point cloud to acquire a buffer for
+ * @return buffer to fill and pass to publish_pointcloud()
+ * @exception Exception thrown if point cloud for given ID does not exist
+ *
+ * @fn void PointCloudManager::publish_pointcloud(const char *id, RefPtr<pcl::PointCloud<PointT>> cloud)
+ * Publish a snapshot of a point cloud.
+ * The cloud becomes the latest snapshot with the next sequence number
+ * and waiting consumers are woken up. The producer must not modify the
+ * cloud after publishing it.
+ * @param id ID of point cloud to publish, must have been added with
+ * add_pointcloud()
+ * @param cloud cloud to publish, usually acquired with
+ * acquire_pointcloud_buffer()
+ * @exception Exception thrown if point cloud for given ID does not exist
+ *
+ * @fn PointCloudSnapshot<PointT> PointCloudManager::get_snapshot(const char *id)
+ * Get latest snapshot of a point cloud.
+ * For clouds which are updated in place, the registered cloud is
+ * returned with a sequence number of zero.
+ * @param id ID of point cloud to retrieve
+ * @return latest snapshot
+ * @exception Exception thrown if point cloud for given ID does not exist
+ *
+ * @fn PointCloudSnapshot<PointT> PointCloudManager::wait_snapshot(const char *id, unsigned long after_seq, double timeout_sec)
+ * Wait for the next snapshot of a point cloud.
+ * @param id ID of point cloud to wait for
+ * @param after_seq sequence number of the last snapshot the caller has
+ * seen, the method returns once a snapshot with a higher sequence number
+ * is available
+ * @param timeout_sec timeout in seconds, negative to wait indefinitely.
+ * On timeout, the latest snapshot is returned, check its sequence number.
+ * @return latest snapshot
+ * @exception Exception thrown if point cloud for given ID does not exist
+ * or has been removed while waiting
+ *
  */
 
 /** Constructor. */
 PointCloudManager::PointCloudManager()
 {
+	snapshot_cond_ = new WaitCondition(*clouds_.mutex());
 }
 
 /** Destructor. */
@@ -57,6 +104,7 @@ PointCloudManager::~PointCloudManager()
 	}
 
 	clouds_.clear();
+	delete snapshot_cond_;
 }
 
 /** Remove the point cloud.
@@ -70,6 +118,8 @@ PointCloudManager::remove_pointcloud(const char *id)
 	if (clouds_.find(id) != clouds_.end()) {
 		delete clouds_[id];
 		clouds_.erase(id);
+		// waiters notice the removal
+		snapshot_cond_->wake_all();
 	}
 }
 
@@ -25,6 +25,7 @@
 
 #include <core/exception.h>
 #include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
 #include <core/utils/lock_map.h>
 #include <core/utils/refptr.h>
 #include <pcl_utils/storage_adapter.h>
@@ -43,6 +44,22 @@ class PointCloud;
 
 namespace fawkes {
 
+/** Snapshot of a point cloud.
+ * The cloud of a snapshot is never modified and can be used by any
+ * number of threads without further locking.
+ */
+template <typename PointT>
+struct PointCloudSnapshot
+{
+	/** Point cloud, empty if the snapshot is invalid. */
+	RefPtr<const pcl::PointCloud<PointT>> cloud;
+	/** Sequence number, increased with each published snapshot. Zero if
+	 * the cloud is updated in place and not published as snapshots. */
+	unsigned long seq = 0;
+	/** Capture time of the point cloud. */
+	fawkes::Time time;
+};
+
 class PointCloudManager
 {
 public:
@@ -58,6 +75,16 @@ public:
 	const RefPtr<const pcl::PointCloud<PointT>> get_pointcloud(const char *id);
 	bool                                        exists_pointcloud(const char *id);
 
+	template <typename PointT>
+	RefPtr<pcl::PointCloud<PointT>> acquire_pointcloud_buffer(const char *id);
+	template <typename PointT>
+	void publish_pointcloud(const char *id, RefPtr<pcl::PointCloud<PointT>> cloud);
+	template <typename PointT>
+	PointCloudSnapshot<PointT> get_snapshot(const char *id);
+	template <typename PointT>
+	PointCloudSnapshot<PointT>
+	wait_snapshot(const char *id, unsigned long after_seq, double timeout_sec = -1.);
+
 	/**  Check if point cloud of specified type exists.
    * @param id ID of point cloud to check
    * @return true if the point cloud exists, false otherwise
@@ -69,8 +96,18 @@ public:
 	const fawkes::LockMap<std::string, pcl_utils::StorageAdapter *> &get_pointclouds() const;
 	const pcl_utils::StorageAdapter *get_storage_adapter(const char *id);
 
+	/** Maximum number of buffers kept per point cloud for snapshots. */
+	static const unsigned int MAX_SNAPSHOT_BUFFERS = 3;
+
+private:
+	template <typename PointT>
+	pcl_utils::PointCloudStorageAdapter<PointT> *storage_adapter(const char *id);
+	template <typename PointT>
+	PointCloudSnapshot<PointT> snapshot(pcl_utils::PointCloudStorageAdapter<PointT> *pa);
+
 private:
 	fawkes::LockMap<std::string, pcl_utils::StorageAdapter *> clouds_;
+	fawkes::WaitCondition                                    *snapshot_cond_;
 };
 
 template <typename PointT>
@@ -87,11 +124,9 @@ PointCloudManager::add_pointcloud(const char *id, RefPtr<pcl::PointCloud<PointT>
 }
 
 template <typename PointT>
-const RefPtr<const pcl::PointCloud<PointT>>
-PointCloudManager::get_pointcloud(const char *id)
+pcl_utils::PointCloudStorageAdapter<PointT> *
+PointCloudManager::storage_adapter(const char *id)
 {
-	fawkes::MutexLocker lock(clouds_.mutex());
-
 	if (clouds_.find(id) != clouds_.end()) {
 		pcl_utils::PointCloudStorageAdapter<PointT> *pa =
 		  dynamic_cast<pcl_utils::PointCloudStorageAdapter<PointT> *>(clouds_[id]);
@@ -101,17 +136,116 @@ PointCloudManager::get_pointcloud(const char *id)
 			if (strcmp(clouds_[id]->get_typename(),
 			           typeid(pcl_utils::PointCloudStorageAdapter<PointT> *).name())
 			    == 0) {
-				return static_cast<pcl_utils::PointCloudStorageAdapter<PointT> *>(clouds_[id])->cloud;
+				return static_cast<pcl_utils::PointCloudStorageAdapter<PointT> *>(clouds_[id]);
 			}
 
 			throw Exception("The desired point cloud is of a different type");
 		}
-		return pa->cloud;
+		return pa;
 	} else {
 		throw Exception("No point cloud with ID '%s' registered", id);
 	}
 }
 
+template <typename PointT>
+const RefPtr<const pcl::PointCloud<PointT>>
+PointCloudManager::get_pointcloud(const char *id)
+{
+	fawkes::MutexLocker lock(clouds_.mutex());
+	return storage_adapter<PointT>(id)->cloud;
+}
+
+template <typename PointT>
+RefPtr<pcl::PointCloud<PointT>>
+PointCloudManager::acquire_pointcloud_buffer(const char *id)
+{
+	fawkes::MutexLocker lock(clouds_.mutex());
+
+	pcl_utils::PointCloudStorageAdapter<PointT> *pa = storage_adapter<PointT>(id);
+	for (const RefPtr<pcl::PointCloud<PointT>> &b : pa->snapshot_buffers) {
+		// only referenced by us, i.e., neither the latest snapshot nor in use
+		if (b.use_count() == 1) {
+			return b;
+		}
+	}
+
+	RefPtr<pcl::PointCloud<PointT>> b(new pcl::PointCloud<PointT>());
+	b->header.frame_id = pa->cloud->header.frame_id;
+	b->width           = pa->cloud->width;
+	b->height          = pa->cloud->height;
+	b->points.resize(pa->cloud->points.size());
+	if (pa->snapshot_buffers.size() < MAX_SNAPSHOT_BUFFERS) {
+		pa->snapshot_buffers.push_back(b);
+	}
+	return b;
+}
+
+template <typename PointT>
+void
+PointCloudManager::publish_pointcloud(const char *id, RefPtr<pcl::PointCloud<PointT>> cloud)
+{
+	RefPtr<pcl::PointCloud<PointT>> legacy_cloud;
+	{
+		fawkes::MutexLocker lock(clouds_.mutex());
+
+		pcl_utils::PointCloudStorageAdapter<PointT> *pa = storage_adapter<PointT>(id);
+
+		pa->snapshot = cloud;
+		++pa->snapshot_seq;
+		// someone holds the registered cloud and expects in-place updates,
+		// copy unless the published cloud is the registered cloud object
+		if (pa->cloud.use_count() > 1 && pa->cloud != cloud) {
+			legacy_cloud = pa->cloud;
+		}
+		snapshot_cond_->wake_all();
+	}
+	if (legacy_cloud) {
+		**legacy_cloud = **cloud;
+	}
+}
+
+template <typename PointT>
+PointCloudSnapshot<PointT>
+PointCloudManager::snapshot(pcl_utils::PointCloudStorageAdapter<PointT> *pa)
+{
+	PointCloudSnapshot<PointT> s;
+	s.seq   = pa->snapshot_seq;
+	s.cloud = pa->snapshot ? pa->snapshot : RefPtr<const pcl::PointCloud<PointT>>(pa->cloud);
+	pcl_utils::get_time(s.cloud, s.time);
+	return s;
+}
+
+template <typename PointT>
+PointCloudSnapshot<PointT>
+PointCloudManager::get_snapshot(const char *id)
+{
+	fawkes::MutexLocker lock(clouds_.mutex());
+	return snapshot(storage_adapter<PointT>(id));
+}
+
+template <typename PointT>
+PointCloudSnapshot<PointT>
+PointCloudManager::wait_snapshot(const char *id, unsigned long after_seq, double timeout_sec)
+{
+	fawkes::MutexLocker lock(clouds_.mutex());
+
+	fawkes::Time deadline;
+	deadline.stamp_systime();
+	deadline += timeout_sec;
+	while (true) {
+		// re-resolved after each wait, the cloud might have been removed
+		pcl_utils::PointCloudStorageAdapter<PointT> *pa = storage_adapter<PointT>(id);
+		if (pa->snapshot_seq > after_seq) {
+			return snapshot(pa);
+		}
+		if (timeout_sec < 0.) {
+			snapshot_cond_->wait();
+		} else if (!snapshot_cond_->abstimed_wait(deadline.get_sec(), deadline.get_nsec())) {
+			return snapshot(pa);
+		}
+	}
+}
+
 template <typename PointT>
 bool
 PointCloudManager::exists_pointcloud(const char *id)
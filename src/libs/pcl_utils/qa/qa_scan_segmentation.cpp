@@ -0,0 +1,238 @@
+
+/***************************************************************************
+ *  qa_scan_segmentation.cpp - Benchmark scan-order segmentation against PCL
+ *
+ *  Created: Sun Oct 18 16:02:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <pcl/filters/filter.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/sample_consensus/method_types.h>
+#include <pcl/sample_consensus/model_types.h>
+#include <pcl/search/kdtree.h>
+#include <pcl/segmentation/extract_clusters.h>
+#include <pcl/segmentation/sac_segmentation.h>
+#include <pcl_utils/scan_segmentation.h>
+#include <utils/time/time.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+using namespace fawkes;
+
+typedef pcl::PointXYZ              PointType;
+typedef pcl::PointCloud<PointType> Cloud;
+
+static const float        LINE_DISTANCE_THRESHOLD = 0.05;
+static const float        LINE_SAMPLE_MAX_DIST    = 0.1;
+static const unsigned int LINE_MIN_INLIERS        = 20;
+static const float        LINE_MIN_LENGTH         = 0.8;
+static const float        CLUSTER_TOLERANCE       = 0.1;
+static const unsigned int CLUSTER_MIN_SIZE        = 5;
+static const unsigned int CLUSTER_MAX_SIZE        = 1000;
+
+// full circle scan of a 6m x 4m room with two round objects
+static void
+synthetic_scan(Cloud &cloud, unsigned int num_beams, unsigned int seed)
+{
+	const float objects[2][3] = {{1.0, 0.5, 0.1}, {-1.5, -1.0, 0.2}};
+
+	srand(seed);
+	cloud.points.resize(num_beams);
+	cloud.height = 1;
+	cloud.width  = num_beams;
+	for (unsigned int i = 0; i < num_beams; ++i) {
+		float a  = 2 * M_PI * i / num_beams;
+		float dx = cosf(a), dy = sinf(a);
+		float d  = std::min(3.f / std::max(1e-6f, fabsf(dx)), 2.f / std::max(1e-6f, fabsf(dy)));
+		for (const auto &o : objects) {
+			float b = dx * o[0] + dy * o[1];
+			float c = o[0] * o[0] + o[1] * o[1] - o[2] * o[2];
+			if (b * b - c > 0 && b - sqrtf(b * b - c) > 0) {
+				d = std::min(d, b - sqrtf(b * b - c));
+			}
+		}
+		if (rand() % 50 == 0) {
+			cloud.points[i].x = cloud.points[i].y = std::numeric_limits<float>::quiet_NaN();
+		} else {
+			d += 0.01 * ((float)rand() / RAND_MAX - 0.5);
+			cloud.points[i].x = d * dx;
+			cloud.points[i].y = d * dy;
+		}
+		cloud.points[i].z = 0.;
+	}
+}
+
+static void
+run_scan_order(pcl_utils::ScanSegmentation<PointType> &segm,
+               const Cloud                            &cloud,
+               size_t                                 &num_lines,
+               size_t                                 &num_clusters)
+{
+	segm.set_input(cloud);
+	const auto &lines =
+	  segm.extract_lines(LINE_DISTANCE_THRESHOLD, LINE_SAMPLE_MAX_DIST, LINE_MIN_INLIERS);
+	num_lines = 0;
+	for (const auto &line : lines) {
+		if (line.length() >= LINE_MIN_LENGTH) {
+			segm.exclude(line);
+			++num_lines;
+		}
+	}
+	num_clusters = segm.cluster(CLUSTER_TOLERANCE, CLUSTER_MIN_SIZE, CLUSTER_MAX_SIZE).size();
+}
+
+static void
+run_pcl(const Cloud::ConstPtr &input, size_t &num_lines, size_t &num_clusters)
+{
+	Cloud::Ptr       cloud(new Cloud());
+	std::vector<int> finite;
+	pcl::removeNaNFromPointCloud(*input, *cloud, finite);
+
+	pcl::SACSegmentation<PointType> seg;
+	seg.setOptimizeCoefficients(true);
+	seg.setModelType(pcl::SACMODEL_LINE);
+	seg.setMethodType(pcl::SAC_RANSAC);
+	seg.setMaxIterations(250);
+	seg.setDistanceThreshold(LINE_DISTANCE_THRESHOLD);
+
+	num_lines = 0;
+	Cloud::Ptr restore(new Cloud());
+	while (cloud->points.size() > CLUSTER_MIN_SIZE) {
+		pcl::ModelCoefficients              coeff;
+		pcl::PointIndices::Ptr              inliers(new pcl::PointIndices());
+		pcl::search::KdTree<PointType>::Ptr search(new pcl::search::KdTree<PointType>());
+		search->setInputCloud(cloud);
+		seg.setSamplesMaxDist(LINE_SAMPLE_MAX_DIST, search);
+		seg.setInputCloud(cloud);
+		seg.segment(*inliers, coeff);
+		if (inliers->indices.size() < LINE_MIN_INLIERS)
+			break;
+
+		Eigen::Vector3f dir(coeff.values[3], coeff.values[4], coeff.values[5]);
+		dir.normalize();
+		float tmin = std::numeric_limits<float>::max(), tmax = -tmin;
+		for (int i : inliers->indices) {
+			float t = dir.dot(cloud->points[i].getVector3fMap());
+			tmin    = std::min(tmin, t);
+			tmax    = std::max(tmax, t);
+		}
+
+		Cloud::Ptr        rest(new Cloud());
+		std::vector<bool> is_inlier(cloud->points.size(), false);
+		for (int i : inliers->indices)
+			is_inlier[i] = true;
+		for (size_t i = 0; i < cloud->points.size(); ++i) {
+			if (!is_inlier[i]) {
+				rest->points.push_back(cloud->points[i]);
+			} else if (tmax - tmin < LINE_MIN_LENGTH) {
+				restore->points.push_back(cloud->points[i]);
+			}
+		}
+		if (tmax - tmin >= LINE_MIN_LENGTH)
+			++num_lines;
+		cloud = rest;
+	}
+	*cloud += *restore;
+
+	std::vector<pcl::PointIndices>      cluster_indices;
+	pcl::search::KdTree<PointType>::Ptr kdtree(new pcl::search::KdTree<PointType>());
+	kdtree->setInputCloud(cloud);
+	pcl::EuclideanClusterExtraction<PointType> ec;
+	ec.setClusterTolerance(CLUSTER_TOLERANCE);
+	ec.setMinClusterSize(CLUSTER_MIN_SIZE);
+	ec.setMaxClusterSize(CLUSTER_MAX_SIZE);
+	ec.setSearchMethod(kdtree);
+	ec.setInputCloud(cloud);
+	ec.extract(cluster_indices);
+	num_clusters = cluster_indices.size();
+}
+
+int
+main(int argc, char **argv)
+{
+	std::vector<Cloud::Ptr> scans;
+	if (argc > 1) {
+		for (int i = 1; i < argc; ++i) {
+			Cloud::Ptr cloud(new Cloud());
+			if (pcl::io::loadPCDFile(argv[i], *cloud) != 0) {
+				printf("Failed to load %s\n", argv[i]);
+				return 1;
+			}
+			scans.push_back(cloud);
+		}
+	} else {
+		printf("No recorded scans given, using synthetic scans\n");
+		for (unsigned int i = 0; i < 20; ++i) {
+			Cloud::Ptr cloud(new Cloud());
+			synthetic_scan(*cloud, 1080, i);
+			scans.push_back(cloud);
+		}
+	}
+
+	const unsigned int                     num_runs = 10;
+	pcl_utils::ScanSegmentation<PointType> segm;
+	size_t                                 lines[2] = {0, 0}, clusters[2] = {0, 0};
+	double                                 time[2]  = {0., 0.};
+
+	for (unsigned int r = 0; r < num_runs; ++r) {
+		for (const Cloud::Ptr &scan : scans) {
+			size_t l, c;
+			Time   start;
+			run_scan_order(segm, *scan, l, c);
+			Time mid;
+			time[0] += mid - &start;
+			if (r == 0) {
+				lines[0] += l;
+				clusters[0] += c;
+			}
+
+			mid.stamp();
+			run_pcl(scan, l, c);
+			Time end;
+			time[1] += end - &mid;
+			if (r == 0) {
+				lines[1] += l;
+				clusters[1] += c;
+			}
+		}
+	}
+
+	const char *names[2] = {"scan-order", "pcl"};
+	size_t      num      = num_runs * scans.size();
+	for (unsigned int i = 0; i < 2; ++i) {
+		printf("%-10s  %8.3f ms/scan  %5.2f lines/scan  %5.2f clusters/scan\n",
+		       names[i],
+		       time[i] / num * 1000.,
+		       (double)lines[i] / scans.size(),
+		       (double)clusters[i] / scans.size());
+	}
+	printf("speedup     %8.1fx\n", time[1] / time[0]);
+
+	return 0;
+}
+
+/// @endcond
@@ -0,0 +1,390 @@
+
+/***************************************************************************
+ *  scan_segmentation.h - Segment 2D laser scans in scan order
+ *
+ *  Created: Sun Oct 18 15:12:48 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_PCL_UTILS_SCAN_SEGMENTATION_H_
+#define _LIBS_PCL_UTILS_SCAN_SEGMENTATION_H_
+
+#include <pcl/point_cloud.h>
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace fawkes {
+namespace pcl_utils {
+
+/** @class ScanSegmentation <pcl_utils/scan_segmentation.h>
+ * Clustering and line extraction for 2D laser scans.
+ * Points of a laser scan are ordered by their beam angle, therefore
+ * neighboring points of an object are almost always neighbors in the
+ * cloud. This allows to cluster a scan in a single pass by breaking it
+ * wherever two consecutive points are too far apart, and to extract
+ * lines by split-and-merge on the resulting runs, without building a
+ * search tree or running RANSAC. The first and last point of the scan
+ * are considered neighbors, so that an object behind a full circle
+ * scanner is not split into two clusters.
+ *
+ * Only x and y coordinates are considered, non-finite points are
+ * ignored. All buffers are kept between calls, so that after the first
+ * few scans processing does not allocate memory.
+ *
+ * Clusters and lines refer to ranges in indices(), which are valid until
+ * the next call to cluster() or extract_lines().
+ * @author Tim Niemueller
+ */
+template <typename PointT>
+class ScanSegmentation
+{
+public:
+	/** Range of points in indices(). */
+	struct Segment
+	{
+		unsigned int begin; ///< position of first point in indices()
+		unsigned int end;   ///< position after the last point in indices()
+
+		/** Get number of points.
+		 * @return number of points in the segment */
+		unsigned int
+		size() const
+		{
+			return end - begin;
+		}
+	};
+
+	/** Line fitted to a range of points. */
+	struct Line : public Segment
+	{
+		Eigen::Vector2f point;       ///< centroid of the points, a point on the line
+		Eigen::Vector2f direction;   ///< unit direction, pointing from end_point_1 to end_point_2
+		Eigen::Vector2f end_point_1; ///< line segment end point
+		Eigen::Vector2f end_point_2; ///< line segment end point
+		float           max_error;   ///< maximum distance of a point to the line
+
+		/** Get length of the line segment.
+		 * @return distance between the end points */
+		float
+		length() const
+		{
+			return (end_point_2 - end_point_1).norm();
+		}
+	};
+
+	void set_input(const pcl::PointCloud<PointT> &cloud);
+	void exclude(const Segment &segment);
+	template <typename Predicate>
+	void exclude_if(Predicate pred);
+
+	const std::vector<Segment> &
+	cluster(float tolerance, unsigned int min_size, unsigned int max_size);
+	const std::vector<Line> &
+	extract_lines(float distance_threshold, float max_point_distance, unsigned int min_points);
+
+	/** Get indices of points.
+	 * @return indices into the input cloud of the points considered in the
+	 * last call to cluster() or extract_lines() in scan order */
+	const std::vector<int> &
+	indices() const
+	{
+		return order_;
+	}
+
+private:
+	Eigen::Vector2f
+	point(int index) const
+	{
+		const PointT &p = cloud_->points[index];
+		return Eigen::Vector2f(p.x, p.y);
+	}
+
+	void scan_order(float tolerance);
+	bool fit_line(unsigned int begin, unsigned int end, Line &line) const;
+
+private:
+	const pcl::PointCloud<PointT>                     *cloud_ = nullptr;
+	std::vector<int>                                   valid_;
+	std::vector<char>                                  excluded_;
+	std::vector<int>                                   order_;
+	std::vector<Segment>                               clusters_;
+	std::vector<Line>                                  lines_;
+	std::vector<std::pair<unsigned int, unsigned int>> stack_;
+	std::vector<std::pair<unsigned int, unsigned int>> pieces_;
+};
+
+/** Set input cloud.
+ * The cloud must be kept unmodified while the segmentation is in use.
+ * Resets all exclusions.
+ * @param cloud cloud with points in scan order
+ */
+template <typename PointT>
+void
+ScanSegmentation<PointT>::set_input(const pcl::PointCloud<PointT> &cloud)
+{
+	cloud_ = &cloud;
+	valid_.clear();
+	excluded_.assign(cloud.points.size(), 0);
+	for (size_t i = 0; i < cloud.points.size(); ++i) {
+		if (std::isfinite(cloud.points[i].x) && std::isfinite(cloud.points[i].y)) {
+			valid_.push_back(i);
+		}
+	}
+}
+
+/** Exclude points from subsequent calls.
+ * Used for example to remove points of detected lines before
+ * clustering the remaining points.
+ * @param segment segment of points to exclude, e.g. a line returned by
+ * extract_lines()
+ */
+template <typename PointT>
+void
+ScanSegmentation<PointT>::exclude(const Segment &segment)
+{
+	for (unsigned int i = segment.begin; i < segment.end; ++i) {
+		excluded_[order_[i]] = 1;
+	}
+}
+
+/** Exclude points matching a predicate from subsequent calls.
+ * @param pred predicate called with a point of the input cloud,
+ * returning true to exclude the point
+ */
+template <typename PointT>
+template <typename Predicate>
+void
+ScanSegmentation<PointT>::exclude_if(Predicate pred)
+{
+	for (int i : valid_) {
+		if (pred(cloud_->points[i])) {
+			excluded_[i] = 1;
+		}
+	}
+}
+
+/** Cluster points.
+ * A new cluster is started whenever the distance between two
+ * consecutive points exceeds the tolerance.
+ * @param tolerance maximum distance between two neighboring points of a
+ * cluster
+ * @param min_size minimum number of points of a cluster
+ * @param max_size maximum number of points of a cluster
+ * @return clusters, referring to ranges of indices()
+ */
+template <typename PointT>
+const std::vector<typename ScanSegmentation<PointT>::Segment> &
+ScanSegmentation<PointT>::cluster(float tolerance, unsigned int min_size, unsigned int max_size)
+{
+	scan_order(tolerance);
+	clusters_.clear();
+
+	const float  tolerance_sq = tolerance * tolerance;
+	unsigned int begin        = 0;
+	for (unsigned int i = 1; i <= order_.size(); ++i) {
+		if (i == order_.size()
+		    || (point(order_[i]) - point(order_[i - 1])).squaredNorm() > tolerance_sq) {
+			if (i - begin >= min_size && i - begin <= max_size) {
+				clusters_.push_back(Segment{begin, i});
+			}
+			begin = i;
+		}
+	}
+	return clusters_;
+}
+
+/** Extract lines.
+ * Points are first split into runs of neighboring points. Each run is
+ * recursively split at the point farthest from the line connecting the
+ * run's end points, until all points are close to that line. Then
+ * consecutive pieces are merged as long as the points of the merged
+ * piece are close to their least squares line fit.
+ * @param distance_threshold maximum distance of a point to its line
+ * @param max_point_distance maximum distance between two neighboring
+ * points of a line
+ * @param min_points minimum number of points of a line
+ * @return lines in scan order, referring to ranges of indices()
+ */
+template <typename PointT>
+const std::vector<typename ScanSegmentation<PointT>::Line> &
+ScanSegmentation<PointT>::extract_lines(float        distance_threshold,
+                                        float        max_point_distance,
+                                        unsigned int min_points)
+{
+	scan_order(max_point_distance);
+	lines_.clear();
+	pieces_.clear();
+
+	// split
+	const float  max_dist_sq = max_point_distance * max_point_distance;
+	unsigned int run_begin   = 0;
+	for (unsigned int i = 1; i <= order_.size(); ++i) {
+		if (i < order_.size()
+		    && (point(order_[i]) - point(order_[i - 1])).squaredNorm() <= max_dist_sq) {
+			continue;
+		}
+		if (i - run_begin >= 2) {
+			stack_.clear();
+			stack_.push_back(std::make_pair(run_begin, i));
+			while (!stack_.empty()) {
+				unsigned int b = stack_.back().first;
+				unsigned int e = stack_.back().second;
+				stack_.pop_back();
+
+				Eigen::Vector2f p0   = point(order_[b]);
+				Eigen::Vector2f d    = point(order_[e - 1]) - p0;
+				float           dlen = d.norm();
+				float           max  = 0.f;
+				unsigned int    k    = b;
+				for (unsigned int j = b + 1; j + 1 < e; ++j) {
+					Eigen::Vector2f v    = point(order_[j]) - p0;
+					float           dist = v.norm();
+					if (dlen > 0.f) {
+						// distance to line through end points
+						dist = std::fabs(d.x() * v.y() - d.y() * v.x()) / dlen;
+					}
+					if (dist > max) {
+						max = dist;
+						k   = j;
+					}
+				}
+				if (max > distance_threshold) {
+					// process left part first to keep pieces in scan order
+					stack_.push_back(std::make_pair(k + 1, e));
+					stack_.push_back(std::make_pair(b, k + 1));
+				} else {
+					pieces_.push_back(std::make_pair(b, e));
+				}
+			}
+		}
+		run_begin = i;
+	}
+
+	// merge
+	Line current, merged;
+	bool have_current = false;
+	for (size_t i = 0; i < pieces_.size(); ++i) {
+		if (have_current && current.end == pieces_[i].first
+		    && fit_line(current.begin, pieces_[i].second, merged)
+		    && merged.max_error <= distance_threshold) {
+			current = merged;
+			continue;
+		}
+		if (have_current && current.size() >= min_points) {
+			lines_.push_back(current);
+		}
+		have_current = fit_line(pieces_[i].first, pieces_[i].second, current);
+	}
+	if (have_current && current.size() >= min_points) {
+		lines_.push_back(current);
+	}
+
+	return lines_;
+}
+
+/** Determine points to consider in scan order.
+ * If the first and last points are neighbors, the order is rotated to
+ * start at the first gap, so that no cluster wraps around the end.
+ * @param tolerance maximum distance of neighboring points
+ */
+template <typename PointT>
+void
+ScanSegmentation<PointT>::scan_order(float tolerance)
+{
+	order_.clear();
+	for (int i : valid_) {
+		if (!excluded_[i])
+			order_.push_back(i);
+	}
+	const size_t n = order_.size();
+	if (n < 2)
+		return;
+
+	const float tolerance_sq = tolerance * tolerance;
+	if ((point(order_[n - 1]) - point(order_[0])).squaredNorm() <= tolerance_sq) {
+		for (size_t i = 1; i < n; ++i) {
+			if ((point(order_[i]) - point(order_[i - 1])).squaredNorm() > tolerance_sq) {
+				std::rotate(order_.begin(), order_.begin() + i, order_.end());
+				break;
+			}
+		}
+	}
+}
+
+/** Fit line to points by total least squares.
+ * @param begin position of first point in indices()
+ * @param end position after last point in indices()
+ * @param line upon return contains the fitted line
+ * @return true if a line could be fitted, false if there are less than
+ * two distinct points
+ */
+template <typename PointT>
+bool
+ScanSegmentation<PointT>::fit_line(unsigned int begin, unsigned int end, Line &line) const
+{
+	const unsigned int n = end - begin;
+	if (n < 2)
+		return false;
+
+	Eigen::Vector2f c(0.f, 0.f);
+	for (unsigned int i = begin; i < end; ++i) {
+		c += point(order_[i]);
+	}
+	c /= n;
+
+	float sxx = 0.f, sxy = 0.f, syy = 0.f;
+	for (unsigned int i = begin; i < end; ++i) {
+		Eigen::Vector2f v = point(order_[i]) - c;
+		sxx += v.x() * v.x();
+		sxy += v.x() * v.y();
+		syy += v.y() * v.y();
+	}
+	if (sxx + syy == 0.f)
+		return false;
+
+	// direction of largest variance, i.e., major eigenvector of covariance
+	const float     angle = 0.5f * std::atan2(2.f * sxy, sxx - syy);
+	Eigen::Vector2f dir(std::cos(angle), std::sin(angle));
+
+	float tmin = 0.f, tmax = 0.f, max_error = 0.f;
+	for (unsigned int i = begin; i < end; ++i) {
+		Eigen::Vector2f v = point(order_[i]) - c;
+		float           t = dir.dot(v);
+		tmin              = std::min(tmin, t);
+		tmax              = std::max(tmax, t);
+		max_error         = std::max(max_error, std::fabs(dir.x() * v.y() - dir.y() * v.x()));
+	}
+
+	line.begin       = begin;
+	line.end         = end;
+	line.point       = c;
+	line.direction   = dir;
+	line.end_point_1 = c + tmin * dir;
+	line.end_point_2 = c + tmax * dir;
+	line.max_error   = max_error;
+	return true;
+}
+
+} // end namespace pcl_utils
+} // end namespace fawkes
+
+#endif
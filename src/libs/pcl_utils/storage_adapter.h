@@ -27,6 +27,8 @@
 #include <pcl_utils/transforms.h>
 #include <pcl_utils/utils.h>
 
+#include <vector>
+
 namespace fawkes {
 namespace pcl_utils {
 
@@ -61,6 +63,11 @@ public:
 	virtual void           *data_ptr() const                   = 0;
 	virtual std::string     frame_id() const                   = 0;
 	virtual void            get_time(fawkes::Time &time) const = 0;
+
+	/** Sequence number of the latest published snapshot.
+	 * Zero if no snapshot has been published, i.e., the cloud is updated in
+	 * place. Protected by the mutex of the PointCloudManager. */
+	unsigned long snapshot_seq = 0;
 };
 
 template <typename PointT>
@@ -84,6 +91,14 @@ public:
 	/** The point cloud. */
 	const RefPtr<pcl::PointCloud<PointT>> cloud;
 
+	/** Latest published snapshot, empty if no snapshot has been published.
+	 * Protected by the mutex of the PointCloudManager. */
+	RefPtr<const pcl::PointCloud<PointT>> snapshot;
+
+	/** Buffers to publish snapshots in, re-used once unreferenced.
+	 * Protected by the mutex of the PointCloudManager. */
+	std::vector<RefPtr<pcl::PointCloud<PointT>>> snapshot_buffers;
+
 	/** Get PCL shared pointer to cloud.
    * @return PCL shared pointer to cloud
    */
@@ -0,0 +1,287 @@
+
+/***************************************************************************
+ *  init_scheduler.cpp - Dependency-aware parallel plugin initialization
+ *
+ *  Created: Sun Oct 18 22:04:51 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <plugin/init_scheduler.h>
+#include <utils/misc/string_split.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+class PluginInitScheduler::WorkerThread : public Thread
+{
+public:
+	WorkerThread(PluginInitScheduler *scheduler, unsigned int id)
+	: Thread("PluginInitWorker", Thread::OPMODE_CONTINUOUS)
+	{
+		set_name("PluginInitWorker-%u", id);
+		scheduler_ = scheduler;
+	}
+
+protected:
+	virtual void
+	run()
+	{
+		scheduler_->work();
+	}
+
+private:
+	PluginInitScheduler *scheduler_;
+};
+/// @endcond
+
+/** @class PluginInitScheduler <plugin/init_scheduler.h>
+ * Run jobs in parallel respecting dependencies among them.
+ * The scheduler is used by the PluginManager to load and initialize
+ * multiple plugins concurrently. Each job is identified by a name and
+ * may depend on other jobs by name. A job is started once all of its
+ * dependencies have finished successfully. If a job fails, all jobs
+ * depending on it directly or indirectly are not run and marked as
+ * failed. Independent jobs are still run to completion.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param num_threads number of threads to run jobs with, if 0 or 1 all
+ * jobs are run sequentially in the thread calling run()
+ */
+PluginInitScheduler::PluginInitScheduler(unsigned int num_threads)
+{
+	num_threads_    = num_threads;
+	mutex_          = new Mutex();
+	waitcond_       = new WaitCondition(mutex_);
+	num_unfinished_ = 0;
+	func_           = NULL;
+}
+
+/** Destructor. */
+PluginInitScheduler::~PluginInitScheduler()
+{
+	for (Job &j : jobs_) {
+		delete j.error;
+	}
+	delete waitcond_;
+	delete mutex_;
+}
+
+/** Add a job.
+ * Jobs are started in the order in which they have been added unless
+ * dependencies require otherwise.
+ * @param name name of the job, must be unique
+ * @param depends names of jobs this job depends on. Names of jobs that
+ * are not added to this scheduler are ignored.
+ */
+void
+PluginInitScheduler::add(const std::string &name, const std::list<std::string> &depends)
+{
+	if (job_index_.find(name) != job_index_.end()) {
+		throw Exception("PluginInitScheduler: job %s added twice", name.c_str());
+	}
+	Job job;
+	job.name             = name;
+	job.num_pending_deps = 0;
+	job.done             = false;
+	job.failed           = false;
+	job.error            = NULL;
+	job_index_[name]     = jobs_.size();
+	jobs_.push_back(job);
+	job_depends_.push_back(depends);
+}
+
+/** Run all jobs.
+ * Blocks until all jobs have been run or have failed.
+ * @param func function called for each job, failure is indicated by
+ * throwing an exception
+ * @exception Exception thrown if the dependencies contain a cycle, in
+ * which case no job is run at all
+ */
+void
+PluginInitScheduler::run(const JobFunc &func)
+{
+	for (unsigned int i = 0; i < jobs_.size(); ++i) {
+		for (const std::string &d : job_depends_[i]) {
+			auto di = job_index_.find(d);
+			if (di != job_index_.end() && di->second != i) {
+				jobs_[i].depends.push_back(di->second);
+				jobs_[di->second].dependants.push_back(i);
+			}
+		}
+		jobs_[i].num_pending_deps = jobs_[i].depends.size();
+	}
+
+	// detect cycles before starting anything
+	std::vector<unsigned int> pending(jobs_.size());
+	std::list<unsigned int>   queue;
+	for (unsigned int i = 0; i < jobs_.size(); ++i) {
+		pending[i] = jobs_[i].num_pending_deps;
+		if (pending[i] == 0)
+			queue.push_back(i);
+	}
+	unsigned int num_sorted = 0;
+	while (!queue.empty()) {
+		unsigned int j = queue.front();
+		queue.pop_front();
+		++num_sorted;
+		for (unsigned int d : jobs_[j].dependants) {
+			if (--pending[d] == 0)
+				queue.push_back(d);
+		}
+	}
+	if (num_sorted < jobs_.size()) {
+		std::list<std::string> cyclic;
+		for (unsigned int i = 0; i < jobs_.size(); ++i) {
+			if (pending[i] > 0)
+				cyclic.push_back(jobs_[i].name);
+		}
+		throw Exception("Cyclic dependency among %s",
+		                str_join(cyclic.begin(), cyclic.end(), ",").c_str());
+	}
+
+	func_           = &func;
+	num_unfinished_ = jobs_.size();
+	for (unsigned int i = 0; i < jobs_.size(); ++i) {
+		if (jobs_[i].num_pending_deps == 0)
+			ready_.push_back(i);
+	}
+
+	if (num_threads_ <= 1 || jobs_.size() <= 1) {
+		work();
+	} else {
+		std::vector<WorkerThread *> workers;
+		unsigned int                num_workers = std::min<unsigned int>(num_threads_, jobs_.size());
+		for (unsigned int i = 0; i < num_workers; ++i) {
+			workers.push_back(new WorkerThread(this, i));
+			workers.back()->start();
+		}
+		for (WorkerThread *w : workers) {
+			w->join();
+			delete w;
+		}
+	}
+	func_ = NULL;
+}
+
+void
+PluginInitScheduler::work()
+{
+	mutex_->lock();
+	while (true) {
+		while (ready_.empty() && num_unfinished_ > 0) {
+			waitcond_->wait();
+		}
+		if (ready_.empty())
+			break;
+
+		unsigned int j = ready_.front();
+		ready_.pop_front();
+		mutex_->unlock();
+
+		Exception *error = NULL;
+		try {
+			(*func_)(jobs_[j].name);
+		} catch (Exception &e) {
+			error = new Exception(e);
+		} catch (std::exception &e) {
+			error = new Exception("Caught std::exception: %s", e.what());
+		} catch (...) {
+			error = new Exception("Unknown exception caught");
+		}
+
+		mutex_->lock();
+		finish(j, error == NULL, error);
+		delete error;
+	}
+	mutex_->unlock();
+}
+
+void
+PluginInitScheduler::finish(unsigned int job, bool success, const Exception *error)
+{
+	Job &j = jobs_[job];
+	j.done = true;
+	--num_unfinished_;
+	if (success) {
+		for (unsigned int d : j.dependants) {
+			if ((--jobs_[d].num_pending_deps == 0) && !jobs_[d].done) {
+				ready_.push_back(d);
+			}
+		}
+	} else {
+		j.failed = true;
+		j.error  = new Exception(*error);
+		for (unsigned int d : j.dependants) {
+			if (!jobs_[d].done) {
+				Exception e("Dependency %s failed", j.name.c_str());
+				finish(d, false, &e);
+			}
+		}
+	}
+	waitcond_->wake_all();
+}
+
+/** Check if a job failed.
+ * @param name name of job
+ * @return true if the job failed or was not run because a dependency failed
+ */
+bool
+PluginInitScheduler::failed(const std::string &name) const
+{
+	auto i = job_index_.find(name);
+	return (i != job_index_.end()) && jobs_[i->second].failed;
+}
+
+/** Get error of failed job.
+ * @param name name of failed job
+ * @return exception thrown by the job
+ * @exception Exception thrown if the job did not fail
+ */
+const Exception &
+PluginInitScheduler::error(const std::string &name) const
+{
+	auto i = job_index_.find(name);
+	if (i == job_index_.end() || !jobs_[i->second].failed) {
+		throw Exception("PluginInitScheduler: job %s did not fail", name.c_str());
+	}
+	return *jobs_[i->second].error;
+}
+
+/** Get failed jobs.
+ * @return names of failed jobs in the order in which they were added
+ */
+std::list<std::string>
+PluginInitScheduler::failed_jobs() const
+{
+	std::list<std::string> rv;
+	for (const Job &j : jobs_) {
+		if (j.failed)
+			rv.push_back(j.name);
+	}
+	return rv;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,90 @@
+
+/***************************************************************************
+ *  init_scheduler.h - Dependency-aware parallel plugin initialization
+ *
+ *  Created: Sun Oct 18 22:04:51 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _PLUGIN_INIT_SCHEDULER_H_
+#define _PLUGIN_INIT_SCHEDULER_H_
+
+#include <core/exception.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class WaitCondition;
+
+class PluginInitScheduler
+{
+public:
+	/** Function to run for a job, gets the name of the job as argument. */
+	typedef std::function<void(const std::string &)> JobFunc;
+
+	PluginInitScheduler(unsigned int num_threads);
+	~PluginInitScheduler();
+
+	void add(const std::string &name, const std::list<std::string> &depends);
+	void run(const JobFunc &func);
+
+	bool                   failed(const std::string &name) const;
+	const Exception       &error(const std::string &name) const;
+	std::list<std::string> failed_jobs() const;
+
+private:
+	class WorkerThread;
+
+	/// @cond INTERNALS
+	typedef struct
+	{
+		std::string               name;
+		std::vector<unsigned int> depends;
+		std::vector<unsigned int> dependants;
+		unsigned int              num_pending_deps;
+		bool                      done;
+		bool                      failed;
+		Exception                *error;
+	} Job;
+	/// @endcond
+
+	void work();
+	void finish(unsigned int job, bool success, const Exception *error);
+
+private:
+	unsigned int                        num_threads_;
+	std::vector<Job>                    jobs_;
+	std::map<std::string, unsigned int> job_index_;
+	std::vector<std::list<std::string>> job_depends_;
+
+	Mutex                  *mutex_;
+	WaitCondition          *waitcond_;
+	std::list<unsigned int> ready_;
+	unsigned int            num_unfinished_;
+	const JobFunc          *func_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -21,7 +21,12 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/utils/trace.h>
 #include <plugin/loader.h>
+#include <utils/misc/string_conversions.h>
+#include <utils/misc/string_split.h>
 #include <utils/system/dynamic_module/module.h>
 #include <utils/system/dynamic_module/module_manager.h>
 
@@ -43,6 +48,7 @@ class PluginLoader::Data
 {
 public:
 	ModuleManager                  *mm;
+	Mutex                           mutex;
 	std::map<Plugin *, Module *>    plugin_module_map;
 	std::map<std::string, Plugin *> name_plugin_map;
 	std::map<Plugin *, std::string> plugin_name_map;
@@ -199,16 +205,24 @@ PluginLoader::create_instance(const char *plugin_name, Module *module)
 Plugin *
 PluginLoader::load(const char *plugin_name)
 {
+	FAWKES_TRACE_SCOPE("plugin.load", plugin_name);
 	std::string pn = plugin_name;
 
+	d_->mutex.lock();
 	if (d_->name_plugin_map.find(pn) != d_->name_plugin_map.end()) {
-		return d_->name_plugin_map[pn];
+		Plugin *p = d_->name_plugin_map[pn];
+		d_->mutex.unlock();
+		return p;
 	}
+	d_->mutex.unlock();
 
 	try {
+		// opening the module and creating the instance is done unlocked
+		// so that multiple plugins can be loaded concurrently
 		Module *module = open_module(plugin_name);
 		Plugin *p      = create_instance(plugin_name, module);
 
+		MutexLocker lock(&d_->mutex);
 		d_->plugin_module_map[p] = module;
 		d_->name_plugin_map[pn]  = p;
 		d_->plugin_name_map[p]   = pn;
@@ -340,6 +354,36 @@ PluginLoader::get_description(const char *plugin_name)
 #endif
 }
 
+/** Get plugin dependencies.
+ * Dependencies are declared in the plugin with the PLUGIN_DEPENDS macro.
+ * @param plugin loaded plugin to get dependencies for
+ * @return names of plugins the given plugin depends on, empty list if
+ * the plugin does not declare any dependencies
+ * @throw Exception thrown if the plugin has not been loaded by this loader
+ */
+std::list<std::string>
+PluginLoader::get_dependencies(Plugin *plugin)
+{
+	MutexLocker lock(&d_->mutex);
+	if (d_->plugin_module_map.find(plugin) == d_->plugin_module_map.end()) {
+		throw Exception("Plugin %s has not been loaded", plugin->name());
+	}
+	Module *module = d_->plugin_module_map[plugin];
+
+	std::list<std::string> rv;
+	if (module->has_symbol("plugin_depends")) {
+		PluginDependenciesFunc   pdf  = (PluginDependenciesFunc)module->get_symbol("plugin_depends");
+		std::vector<std::string> deps = str_split(pdf(), ',');
+		for (const std::string &dep : deps) {
+			std::string d = StringConversions::trim(dep);
+			if (!d.empty()) {
+				rv.push_back(d);
+			}
+		}
+	}
+	return rv;
+}
+
 /** Check if a plugin is loaded.
  * @param plugin_name name of the plugin to chekc
  * @return true if the plugin is loaded, false otherwise
@@ -347,6 +391,7 @@ PluginLoader::get_description(const char *plugin_name)
 bool
 PluginLoader::is_loaded(const char *plugin_name)
 {
+	MutexLocker lock(&d_->mutex);
 	return (d_->name_plugin_map.find(plugin_name) != d_->name_plugin_map.end());
 }
 
@@ -364,6 +409,7 @@ PluginLoader::is_loaded(const char *plugin_name)
 void
 PluginLoader::unload(Plugin *plugin)
 {
+	MutexLocker lock(&d_->mutex);
 	if (d_->plugin_module_map.find(plugin) != d_->plugin_module_map.end()) {
 		PluginDestroyFunc pdf =
 		  (PluginDestroyFunc)d_->plugin_module_map[plugin]->get_symbol("plugin_destroy");
@@ -27,6 +27,7 @@
 #include <core/exception.h>
 #include <core/plugin.h>
 
+#include <list>
 #include <string>
 
 namespace fawkes {
@@ -63,7 +64,8 @@ public:
 	Plugin *load(const char *plugin_name);
 	void    unload(Plugin *plugin);
 
-	std::string get_description(const char *plugin_name);
+	std::string            get_description(const char *plugin_name);
+	std::list<std::string> get_dependencies(Plugin *plugin);
 
 	bool is_loaded(const char *plugin_name);
 
@@ -25,9 +25,12 @@
 #include <core/exception.h>
 #include <core/plugin.h>
 #include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
 #include <core/threading/thread_collector.h>
 #include <core/threading/thread_initializer.h>
+#include <core/utils/trace.h>
 #include <logging/liblogger.h>
+#include <plugin/init_scheduler.h>
 #include <plugin/listener.h>
 #include <plugin/loader.h>
 #include <plugin/manager.h>
@@ -44,6 +47,8 @@
 
 namespace fawkes {
 
+#define CFG_PLUGIN_INIT_PREFIX "/fawkes/mainapp/plugin_init/"
+
 /// @cond INTERNALS
 class plname_eq
 {
@@ -68,6 +73,18 @@ private:
  * This class provides a manager for the plugins used in fawkes. It can
  * load and unload modules.
  *
+ * If the configuration value /fawkes/mainapp/plugin_init/threads is set
+ * to a value larger than one, a list of plugins is loaded and initialized
+ * in parallel with the given number of threads. Plugins are initialized
+ * after all plugins they depend on. Dependencies are declared with
+ * PLUGIN_DEPENDS in the plugin or as string list in the configuration at
+ * /fawkes/mainapp/plugin_init/dependencies/PLUGIN. Additionally, a plugin
+ * using an aspect provided by another plugin of the same list depends on
+ * that plugin if a thread initializer has been set.
+ *
+ * The time it took to load and initialize each plugin is logged after
+ * each load and can be retrieved with get_startup_timeline().
+ *
  * @author Tim Niemueller
  */
 
@@ -90,7 +107,9 @@ PluginManager::PluginManager(ThreadCollector    *thread_collector,
 : ConfigurationChangeHandler(meta_plugin_prefix)
 {
 	mutex_                 = new Mutex();
+	timeline_mutex_        = new Mutex();
 	this->thread_collector = thread_collector;
+	thread_initializer_    = NULL;
 	plugin_loader          = new PluginLoader(PLUGINDIR, config);
 	plugin_loader->get_module_manager()->set_open_flags(module_flags);
 	next_plugin_id      = 1;
@@ -144,6 +163,7 @@ PluginManager::~PluginManager()
 	plugins.clear();
 	plugin_ids.clear();
 	delete plugin_loader;
+	delete timeline_mutex_;
 	delete mutex_;
 }
 
@@ -156,6 +176,19 @@ PluginManager::set_module_flags(Module::ModuleFlags flags)
 	plugin_loader->get_module_manager()->set_open_flags(flags);
 }
 
+/** Set thread initializer.
+ * The initializer is used to determine dependencies among plugins which
+ * are initialized in parallel, e.g. a plugin using an aspect which is
+ * provided by another plugin. It must be the initializer of the thread
+ * collector. If not set, only declared dependencies are considered.
+ * @param initializer thread initializer
+ */
+void
+PluginManager::set_thread_initializer(ThreadInitializer *initializer)
+{
+	thread_initializer_ = initializer;
+}
+
 /** Initialize plugin info cache. */
 void
 PluginManager::init_pinfo_cache()
@@ -227,6 +260,17 @@ PluginManager::get_available_plugins()
 	return rv;
 }
 
+/** Get startup timeline.
+ * @return load and initialization timing of all loaded plugins, in the
+ * order in which they have been loaded
+ */
+std::list<PluginManager::StartupTiming>
+PluginManager::get_startup_timeline()
+{
+	MutexLocker lock(timeline_mutex_);
+	return timeline_;
+}
+
 /** Get list of loaded plugins.
  * @return list of names of real and meta plugins currently loaded
  */
@@ -329,12 +373,36 @@ PluginManager::load(const std::string &plugin_list)
 
 /** Load plugin.
  * The loading is interrupted if any of the plugins does not load properly.
- * The already loaded plugins are *not* unloaded, but kept.
+ * The already loaded plugins are *not* unloaded, but kept. When loading
+ * in parallel, all plugins which do not depend on a failed plugin are
+ * still loaded.
  * @param plugin_list string containing a comma-separated list of plugins
  * to load. The plugin list can contain meta plugins.
  */
 void
 PluginManager::load(const std::list<std::string> &plugin_list)
+{
+	unsigned int num_threads = config_->get_uint_or_default(CFG_PLUGIN_INIT_PREFIX "threads", 1);
+
+	Time start;
+	try {
+		if (num_threads > 1) {
+			load_parallel(plugin_list, num_threads);
+		} else {
+			load_sequential(plugin_list);
+		}
+	} catch (Exception &e) {
+		log_startup_timeline(start);
+		throw;
+	}
+	log_startup_timeline(start);
+}
+
+/** Load plugins one after another.
+ * @param plugin_list list of plugins to load, can contain meta plugins
+ */
+void
+PluginManager::load_sequential(const std::list<std::string> &plugin_list)
 {
 	for (std::list<std::string>::const_iterator i = plugin_list.begin(); i != plugin_list.end();
 	     ++i) {
@@ -374,7 +442,7 @@ PluginManager::load(const std::list<std::string> &plugin_list)
 					                    "Loading plugins %s for meta plugin %s",
 					                    str_join(pset.begin(), pset.end(), ",").c_str(),
 					                    i->c_str());
-					load(pset);
+					load_sequential(pset);
 					LibLogger::log_debug("PluginManager", "Loaded meta plugin %s", i->c_str());
 					notify_loaded(i->c_str());
 				} catch (Exception &e) {
@@ -391,10 +459,20 @@ PluginManager::load(const std::list<std::string> &plugin_list)
 		    && (find_if(plugins.begin(), plugins.end(), plname_eq(*i)) == plugins.end())) {
 			try {
 				//printf("Going to load real plugin %s\n", i->c_str());
+				Time    load_start;
 				Plugin *plugin = plugin_loader->load(i->c_str());
+				Time    init_start;
 				plugins.lock();
 				try {
-					thread_collector->add(plugin->threads());
+					{
+						FAWKES_TRACE_SCOPE("plugin.init", i->c_str());
+						thread_collector->add(plugin->threads());
+					}
+					Time init_end;
+					record_startup_timing(*i,
+					                      load_start,
+					                      init_start - &load_start,
+					                      init_end - &init_start);
 					plugins.push_back(plugin);
 					plugin_ids[*i] = next_plugin_id++;
 					LibLogger::log_debug("PluginManager", "Loaded plugin %s", i->c_str());
@@ -418,6 +496,307 @@ PluginManager::load(const std::list<std::string> &plugin_list)
 	}
 }
 
+/** Load plugins in parallel.
+ * Plugin modules are opened and plugin instances created concurrently.
+ * Afterwards the plugins are initialized concurrently, each plugin only
+ * after all the plugins it depends on. If a plugin fails to load or
+ * initialize, plugins depending on it are not initialized, all others are
+ * kept. Meta plugins are only kept if all of their plugins were loaded.
+ * @param plugin_list list of plugins to load, can contain meta plugins
+ * @param num_threads number of threads to load and initialize plugins with
+ * @exception Exception thrown if any plugin failed, describes all failures
+ */
+void
+PluginManager::load_parallel(const std::list<std::string> &plugin_list, unsigned int num_threads)
+{
+	std::list<std::string>           real_plugins, meta_plugins;
+	std::map<std::string, Plugin *>  batch;
+	std::map<std::string, Exception> dep_errors;
+	std::map<std::string, Time>      load_starts;
+	std::map<std::string, float>     load_durations;
+	std::map<std::string, float>     init_durations;
+	Mutex                            batch_mutex;
+	std::list<std::string>           failed;
+
+	try {
+		expand_plugin_list(plugin_list, real_plugins, meta_plugins);
+
+		PluginInitScheduler load_scheduler(num_threads);
+		for (const std::string &p : real_plugins) {
+			load_scheduler.add(p, std::list<std::string>());
+			batch[p] = NULL;
+		}
+		load_scheduler.run([&](const std::string &name) {
+			Time    start;
+			Plugin *plugin = plugin_loader->load(name.c_str());
+			Time    end;
+
+			MutexLocker lock(&batch_mutex);
+			batch[name]          = plugin;
+			load_starts[name]    = start;
+			load_durations[name] = end - &start;
+		});
+
+		// plugins which could not be loaded stay in the batch without an
+		// instance, such that plugins depending on them fail to initialize
+		PluginInitScheduler init_scheduler(num_threads);
+		for (const std::string &p : real_plugins) {
+			if (!batch[p]) {
+				init_scheduler.add(p, std::list<std::string>());
+				continue;
+			}
+			try {
+				init_scheduler.add(p, init_dependencies(p, batch[p], batch));
+			} catch (Exception &e) {
+				dep_errors.insert(std::make_pair(p, e));
+				init_scheduler.add(p, std::list<std::string>());
+			}
+		}
+		init_scheduler.run([&](const std::string &name) {
+			if (!batch.at(name)) {
+				Exception e(load_scheduler.error(name));
+				e.append("Plugin >>> %s <<< could not be loaded", name.c_str());
+				throw e;
+			}
+			auto dep_error = dep_errors.find(name);
+			if (dep_error != dep_errors.end()) {
+				throw dep_error->second;
+			}
+
+			Time start;
+			{
+				FAWKES_TRACE_SCOPE("plugin.init", name.c_str());
+				thread_collector->add(batch.at(name)->threads());
+			}
+			Time end;
+
+			MutexLocker lock(&batch_mutex);
+			init_durations[name] = end - &start;
+		});
+
+		plugins.lock();
+		for (const std::string &p : real_plugins) {
+			if (!init_scheduler.failed(p)) {
+				plugins.push_back(batch[p]);
+				plugin_ids[p] = next_plugin_id++;
+				batch.erase(p);
+				record_startup_timing(p, load_starts[p], load_durations[p], init_durations[p]);
+				LibLogger::log_debug("PluginManager", "Loaded plugin %s", p.c_str());
+				notify_loaded(p.c_str());
+			}
+		}
+		plugins.unlock();
+
+		failed = init_scheduler.failed_jobs();
+		if (!failed.empty()) {
+			Exception e(init_scheduler.error(failed.front()));
+			e.append("Plugin >>> %s <<< could not be initialized, unloading", failed.front().c_str());
+			for (const std::string &f : failed) {
+				if (f != failed.front()) {
+					e.append("Plugin >>> %s <<< could not be initialized, unloading (%s)",
+					         f.c_str(),
+					         init_scheduler.error(f).what_no_backtrace());
+				}
+			}
+			throw e;
+		}
+	} catch (Exception &e) {
+		for (const auto &b : batch) {
+			if (b.second)
+				plugin_loader->unload(b.second);
+		}
+
+		// keep meta plugins all plugins of which have been initialized, none
+		// if the batch failed as a whole. Inner meta plugins are checked first.
+		std::list<std::string> kept_meta_plugins;
+		meta_plugins_.lock();
+		for (std::list<std::string>::reverse_iterator m = meta_plugins.rbegin();
+		     m != meta_plugins.rend();
+		     ++m) {
+			const std::list<std::string> &members = meta_plugins_[*m];
+			bool                          ok      = !failed.empty();
+			for (const std::string &p : members) {
+				if (std::find(failed.begin(), failed.end(), p) != failed.end()) {
+					ok = false;
+					break;
+				}
+			}
+			if (ok) {
+				kept_meta_plugins.push_back(*m);
+			} else {
+				failed.push_back(*m);
+				meta_plugins_.erase(*m);
+			}
+		}
+		meta_plugins_.unlock();
+
+		for (const std::string &m : kept_meta_plugins) {
+			LibLogger::log_debug("PluginManager", "Loaded meta plugin %s", m.c_str());
+			notify_loaded(m.c_str());
+		}
+		throw;
+	}
+
+	for (std::list<std::string>::reverse_iterator m = meta_plugins.rbegin(); m != meta_plugins.rend();
+	     ++m) {
+		LibLogger::log_debug("PluginManager", "Loaded meta plugin %s", m->c_str());
+		notify_loaded(m->c_str());
+	}
+}
+
+/** Expand list of plugins.
+ * Meta plugins are resolved recursively and registered as loaded meta
+ * plugins. Plugins which are already loaded are skipped.
+ * @param plugin_list list of plugins to expand
+ * @param real_plugins upon return contains the real plugins to load in
+ * the order in which they were requested
+ * @param meta_plugins upon return contains the meta plugins which have
+ * been expanded, outer meta plugins before the ones they contain
+ */
+void
+PluginManager::expand_plugin_list(const std::list<std::string> &plugin_list,
+                                  std::list<std::string>       &real_plugins,
+                                  std::list<std::string>       &meta_plugins)
+{
+	for (const std::string &p : plugin_list) {
+		if (p.empty() || (meta_plugins_.find(p) != meta_plugins_.end()))
+			continue;
+
+		std::string            meta_plugin = meta_plugin_prefix_ + p;
+		bool                   found_meta  = false;
+		std::list<std::string> pset;
+		try {
+			if (config_->is_list(meta_plugin.c_str())) {
+				std::vector<std::string> tmp = config_->get_strings(meta_plugin.c_str());
+				pset.insert(pset.end(), tmp.begin(), tmp.end());
+			} else
+				pset = parse_plugin_list(config_->get_string(meta_plugin.c_str()).c_str());
+			found_meta = true;
+		} catch (ConfigEntryNotFoundException &e) {
+			// no meta plugin defined by that name
+		}
+
+		if (found_meta) {
+			if (pset.size() == 0) {
+				throw Exception("Refusing to load an empty meta plugin");
+			}
+			meta_plugins_.lock();
+			meta_plugins_[p] = pset;
+			meta_plugins_.unlock();
+			meta_plugins.push_back(p);
+			LibLogger::log_info("PluginManager",
+			                    "Loading plugins %s for meta plugin %s",
+			                    str_join(pset.begin(), pset.end(), ",").c_str(),
+			                    p.c_str());
+			expand_plugin_list(pset, real_plugins, meta_plugins);
+		} else if ((find_if(plugins.begin(), plugins.end(), plname_eq(p)) == plugins.end())
+		           && (std::find(real_plugins.begin(), real_plugins.end(), p) == real_plugins.end())) {
+			real_plugins.push_back(p);
+		}
+	}
+}
+
+/** Determine plugins a plugin depends on.
+ * @param plugin_name name of plugin
+ * @param plugin plugin instance
+ * @param batch plugins which are loaded together with the plugin
+ * @return names of plugins which must be initialized before the plugin
+ * @exception Exception thrown if a dependency is neither loaded nor part
+ * of the batch
+ */
+std::list<std::string>
+PluginManager::init_dependencies(const std::string                     &plugin_name,
+                                 Plugin                                *plugin,
+                                 const std::map<std::string, Plugin *> &batch)
+{
+	std::list<std::string>   depends = plugin_loader->get_dependencies(plugin);
+	std::vector<std::string> cfg_depends =
+	  config_->get_strings_or_defaults((CFG_PLUGIN_INIT_PREFIX "dependencies/" + plugin_name).c_str(),
+	                                   std::vector<std::string>());
+	depends.insert(depends.end(), cfg_depends.begin(), cfg_depends.end());
+
+	for (const std::string &d : depends) {
+		if ((batch.find(d) == batch.end())
+		    && (find_if(plugins.begin(), plugins.end(), plname_eq(d)) == plugins.end())) {
+			throw Exception("Plugin %s depends on plugin %s, which is not loaded",
+			                plugin_name.c_str(),
+			                d.c_str());
+		}
+	}
+
+	if (thread_initializer_) {
+		std::list<std::string> required, provided;
+		for (Thread *t : plugin->threads()) {
+			thread_initializer_->init_dependencies(t, required, provided);
+		}
+		for (const auto &b : batch) {
+			if (b.first == plugin_name || !b.second)
+				continue;
+			std::list<std::string> b_required, b_provided;
+			for (Thread *t : b.second->threads()) {
+				thread_initializer_->init_dependencies(t, b_required, b_provided);
+			}
+			for (const std::string &a : b_provided) {
+				if (std::find(required.begin(), required.end(), a) != required.end()) {
+					depends.push_back(b.first);
+					break;
+				}
+			}
+		}
+	}
+
+	return depends;
+}
+
+void
+PluginManager::record_startup_timing(const std::string &plugin_name,
+                                     const Time        &start,
+                                     float              load_duration,
+                                     float              init_duration)
+{
+	MutexLocker lock(timeline_mutex_);
+	for (std::list<StartupTiming>::iterator t = timeline_.begin(); t != timeline_.end(); ++t) {
+		if (t->name == plugin_name) {
+			timeline_.erase(t);
+			break;
+		}
+	}
+	StartupTiming timing;
+	timing.name          = plugin_name;
+	timing.start         = start;
+	timing.load_duration = load_duration;
+	timing.init_duration = init_duration;
+	timeline_.push_back(timing);
+}
+
+void
+PluginManager::log_startup_timeline(const Time &since)
+{
+	MutexLocker lock(timeline_mutex_);
+
+	std::list<const StartupTiming *> timings;
+	for (const StartupTiming &t : timeline_) {
+		if (t.start >= since)
+			timings.push_back(&t);
+	}
+	if (timings.empty())
+		return;
+
+	Time now;
+	LibLogger::log_info("PluginManager",
+	                    "Loaded %zu plugins in %.3f sec",
+	                    timings.size(),
+	                    now - &since);
+	for (const StartupTiming *t : timings) {
+		LibLogger::log_info("PluginManager",
+		                    "  %-24s  start %+8.3f  load %8.3f  init %8.3f sec",
+		                    t->name.c_str(),
+		                    t->start - &since,
+		                    t->load_duration,
+		                    t->init_duration);
+	}
+}
+
 /** Unload plugin.
  * Note that this method does not allow to pass a list of plugins, but it will
  * only accept a single plugin at a time.
@@ -426,6 +805,7 @@ PluginManager::load(const std::list<std::string> &plugin_list)
 void
 PluginManager::unload(const std::string &plugin_name)
 {
+	FAWKES_TRACE_SCOPE("plugin.unload", plugin_name.c_str());
 	MutexLocker lock(plugins.mutex());
 	if ((pit = find_if(plugins.begin(), plugins.end(), plname_eq(plugin_name))) != plugins.end()) {
 		try {
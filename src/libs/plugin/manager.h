@@ -29,13 +29,16 @@
 #include <core/utils/lock_map.h>
 #include <utils/system/dynamic_module/module.h>
 #include <utils/system/fam.h>
+#include <utils/time/time.h>
 
+#include <list>
 #include <string>
 #include <utility>
 
 namespace fawkes {
 
 class ThreadCollector;
+class ThreadInitializer;
 class Plugin;
 class PluginLoader;
 class Mutex;
@@ -54,7 +57,17 @@ public:
 	              bool                init_cache   = true);
 	~PluginManager();
 
+	/** Startup timing of a plugin. */
+	typedef struct
+	{
+		std::string name;          /**< name of the plugin */
+		Time        start;         /**< time when loading the plugin started */
+		float       load_duration; /**< time to open module and create plugin; sec */
+		float       init_duration; /**< time to initialize and start plugin threads; sec */
+	} StartupTiming;
+
 	void set_module_flags(Module::ModuleFlags flags);
+	void set_thread_initializer(ThreadInitializer *initializer);
 	void init_pinfo_cache();
 
 	// for ConfigurationChangeHandler
@@ -77,6 +90,7 @@ public:
 
 	std::list<std::string>                         get_loaded_plugins();
 	std::list<std::pair<std::string, std::string>> get_available_plugins();
+	std::list<StartupTiming>                       get_startup_timeline();
 
 	void add_listener(PluginManagerListener *listener);
 	void remove_listener(PluginManagerListener *listener);
@@ -91,10 +105,25 @@ private:
 
 	std::list<std::string> parse_plugin_list(const char *plugin_type_list);
 
+	void load_sequential(const std::list<std::string> &plugin_list);
+	void load_parallel(const std::list<std::string> &plugin_list, unsigned int num_threads);
+	void expand_plugin_list(const std::list<std::string> &plugin_list,
+	                        std::list<std::string>       &real_plugins,
+	                        std::list<std::string>       &meta_plugins);
+	std::list<std::string> init_dependencies(const std::string                     &plugin_name,
+	                                         Plugin                                *plugin,
+	                                         const std::map<std::string, Plugin *> &batch);
+	void record_startup_timing(const std::string &plugin_name,
+	                           const Time        &start,
+	                           float              load_duration,
+	                           float              init_duration);
+	void log_startup_timeline(const Time &since);
+
 private:
-	ThreadCollector *thread_collector;
-	PluginLoader    *plugin_loader;
-	Mutex           *mutex_;
+	ThreadCollector   *thread_collector;
+	ThreadInitializer *thread_initializer_;
+	PluginLoader      *plugin_loader;
+	Mutex             *mutex_;
 
 	LockList<Plugin *>                   plugins;
 	LockList<Plugin *>::iterator         pit;
@@ -115,6 +144,9 @@ private:
 	std::string    meta_plugin_prefix_;
 
 	FamThread *fam_thread_;
+
+	Mutex                   *timeline_mutex_;
+	std::list<StartupTiming> timeline_;
 };
 
 } // end namespace fawkes
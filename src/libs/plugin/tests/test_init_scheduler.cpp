@@ -0,0 +1,120 @@
+/***************************************************************************
+ *  test_init_scheduler.cpp - PluginInitScheduler Unit Test
+ *
+ *  Created: Mon Oct 19 10:14:02 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <plugin/init_scheduler.h>
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+size_t
+position(const std::vector<std::string> &order, const std::string &name)
+{
+	return std::find(order.begin(), order.end(), name) - order.begin();
+}
+} // namespace
+
+TEST_CASE("Jobs run after their dependencies", "[init_scheduler]")
+{
+	unsigned int        num_threads = GENERATE(1, 4);
+	PluginInitScheduler scheduler(num_threads);
+	scheduler.add("a", {});
+	scheduler.add("b", {"a"});
+	scheduler.add("c", {"a"});
+	scheduler.add("d", {"b", "c"});
+	scheduler.add("e", {"unknown"});
+
+	Mutex                    mutex;
+	std::vector<std::string> order;
+	scheduler.run([&](const std::string &name) {
+		MutexLocker lock(&mutex);
+		order.push_back(name);
+	});
+
+	REQUIRE(order.size() == 5);
+	REQUIRE(position(order, "a") < position(order, "b"));
+	REQUIRE(position(order, "a") < position(order, "c"));
+	REQUIRE(position(order, "b") < position(order, "d"));
+	REQUIRE(position(order, "c") < position(order, "d"));
+	REQUIRE(position(order, "e") < order.size());
+	REQUIRE(scheduler.failed_jobs().empty());
+}
+
+TEST_CASE("Failures propagate to dependants only", "[init_scheduler]")
+{
+	unsigned int        num_threads = GENERATE(1, 4);
+	PluginInitScheduler scheduler(num_threads);
+	scheduler.add("a", {});
+	scheduler.add("b", {"a"});
+	scheduler.add("c", {"b"});
+	scheduler.add("d", {});
+	scheduler.add("e", {"d"});
+
+	Mutex                    mutex;
+	std::vector<std::string> run;
+	scheduler.run([&](const std::string &name) {
+		{
+			MutexLocker lock(&mutex);
+			run.push_back(name);
+		}
+		if (name == "a") {
+			throw Exception("a failed");
+		}
+	});
+
+	REQUIRE(position(run, "a") < run.size());
+	REQUIRE(position(run, "b") == run.size());
+	REQUIRE(position(run, "c") == run.size());
+	REQUIRE(position(run, "d") < run.size());
+	REQUIRE(position(run, "e") < run.size());
+
+	REQUIRE(scheduler.failed("a"));
+	REQUIRE(scheduler.failed("b"));
+	REQUIRE(scheduler.failed("c"));
+	REQUIRE_FALSE(scheduler.failed("d"));
+	REQUIRE_FALSE(scheduler.failed("e"));
+	REQUIRE(scheduler.failed_jobs() == std::list<std::string>{"a", "b", "c"});
+	REQUIRE(std::string(scheduler.error("a").what_no_backtrace()).find("a failed")
+	        != std::string::npos);
+	REQUIRE_THROWS_AS(scheduler.error("d"), Exception);
+}
+
+TEST_CASE("Cyclic dependencies are rejected", "[init_scheduler]")
+{
+	PluginInitScheduler scheduler(4);
+	scheduler.add("a", {"c"});
+	scheduler.add("b", {"a"});
+	scheduler.add("c", {"b"});
+	scheduler.add("d", {});
+
+	bool ran = false;
+	REQUIRE_THROWS_AS(scheduler.run([&](const std::string &) { ran = true; }), Exception);
+	REQUIRE_FALSE(ran);
+	REQUIRE_THROWS_AS(scheduler.add("a", {}), Exception);
+}
@@ -26,6 +26,8 @@
 
 #include "protobuf_to_bb.h"
 
+#include <google/protobuf/descriptor.h>
+
 namespace protoboard {
 
 using namespace fawkes;
@@ -70,6 +72,7 @@ void
 BlackboardManager::finalize()
 {
 	delete on_message_waker_;
+	converter_cache_.clear();
 	bb_receiving_interfaces_.clear();
 	pb_sender_->finalize();
 	blackboard->close(peer_iface_);
@@ -89,19 +92,17 @@ BlackboardManager::loop()
 	pb_sender_->process_sending_interfaces();
 
 	// Handle receiving blackboard interfaces
-	while (message_handler_->pb_queue_incoming()) {
-		ProtobufThead::incoming_message inc = message_handler_->pb_queue_pop();
-		pb_conversion_map::iterator     it;
-
-		if ((it = bb_receiving_interfaces_.find(inc.msg->GetTypeName()))
-		    == bb_receiving_interfaces_.end()) {
+	ProtobufThead::incoming_message inc;
+	while (message_handler_->pb_queue_pop(inc)) {
+		pb_convert *converter = find_converter(*inc.msg);
+		if (!converter) {
 			logger->log_error(name(),
 			                  "Received message of unregistered type `%s'",
 			                  inc.msg->GetTypeName().c_str());
 			continue;
 		}
 		try {
-			it->second->handle(inc.msg);
+			converter->handle(*inc.msg);
 		} catch (std::exception &e) {
 			logger->log_error(name(),
 			                  "Exception while handling %s: %s",
@@ -109,6 +110,29 @@ BlackboardManager::loop()
 			                  e.what());
 		}
 	}
+	inc.msg.reset();
+}
+
+/** Find converter for a received message.
+ * Converters are cached by message descriptor, which avoids constructing
+ * the type name string for each incoming message.
+ * @param msg received message
+ * @return converter, nullptr if none is registered for the message type
+ */
+pb_convert *
+BlackboardManager::find_converter(const google::protobuf::Message &msg)
+{
+	const google::protobuf::Descriptor *desc = msg.GetDescriptor();
+	auto                                c    = converter_cache_.find(desc);
+	if (c != converter_cache_.end())
+		return c->second;
+
+	pb_convert *converter = nullptr;
+	auto        it        = bb_receiving_interfaces_.find(desc->full_name());
+	if (it != bb_receiving_interfaces_.end())
+		converter = it->second.get();
+	converter_cache_[desc] = converter;
+	return converter;
 }
 
 BlackBoard *
@@ -235,7 +235,10 @@ private:
 	unsigned int                            next_peer_idx_;
 	std::unique_ptr<AbstractProtobufSender> pb_sender_;
 
-	void add_peer(fawkes::ProtobufPeerInterface *iface, long peer_id);
+	std::unordered_map<const google::protobuf::Descriptor *, pb_convert *> converter_cache_;
+
+	void        add_peer(fawkes::ProtobufPeerInterface *iface, long peer_id);
+	pb_convert *find_converter(const google::protobuf::Message &msg);
 
 	template <class MessageT, class InterfaceT>
 	void handle_message_type(InterfaceT *iface);
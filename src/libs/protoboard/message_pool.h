@@ -0,0 +1,92 @@
+/***************************************************************************
+ * Protoboard plugin template
+ * - Pool of recycled outgoing ProtoBuf messages
+ *
+ * Copyright 2026 Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef PROTOBOARD_MESSAGE_POOL_H_
+#define PROTOBOARD_MESSAGE_POOL_H_
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace protoboard {
+
+/**
+ * Pool of ProtoBuf messages of one type for sending.
+ * A message is handed out again once the last reference outside of the
+ * pool has been dropped, i.e. when the peer has sent it. It is cleared
+ * before re-use. Clearing keeps the memory allocated for strings and
+ * repeated fields, therefore filling a recycled message of similar
+ * content does not allocate memory. Neither does acquiring a message,
+ * once the pool has been filled.
+ * @tparam MessageT concrete ProtoBuf message type
+ */
+template <class MessageT>
+class pb_message_pool
+{
+public:
+	/** Constructor.
+	 * @param max_size maximum number of pooled messages. If all of them are
+	 * still in use, a new message is returned that is not recycled. */
+	explicit pb_message_pool(size_t max_size = 16) : max_size_(max_size)
+	{
+		messages_.reserve(max_size);
+	}
+
+	/** Get a cleared message.
+	 * @return message ready to be filled, keep it only as long as needed */
+	std::shared_ptr<MessageT>
+	acquire()
+	{
+		fawkes::MutexLocker lock(&mutex_);
+		for (std::shared_ptr<MessageT> &m : messages_) {
+			if (m.use_count() == 1) {
+				// synchronize with the release of the last outside reference
+				std::atomic_thread_fence(std::memory_order_acquire);
+				m->Clear();
+				return m;
+			}
+		}
+		std::shared_ptr<MessageT> m = std::make_shared<MessageT>();
+		if (messages_.size() < max_size_)
+			messages_.push_back(m);
+		return m;
+	}
+
+	/** Get pool for the given message type.
+	 * @return pool shared by all users of the message type in this process */
+	static pb_message_pool<MessageT> &
+	instance()
+	{
+		static pb_message_pool<MessageT> pool;
+		return pool;
+	}
+
+private:
+	fawkes::Mutex                          mutex_;
+	size_t                                 max_size_;
+	std::vector<std::shared_ptr<MessageT>> messages_;
+};
+
+} // namespace protoboard
+
+#endif // PROTOBOARD_MESSAGE_POOL_H_
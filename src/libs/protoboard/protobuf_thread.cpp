@@ -39,6 +39,7 @@ ProtobufThead::ProtobufThead()
 : Thread("ProtoboardMessageHandler", Thread::OPMODE_CONTINUOUS),
   message_register_(nullptr),
   next_client_id_(0),
+  next_queue_(peer_queues_.end()),
   bb_manager_(nullptr)
 {
 }
@@ -61,17 +62,31 @@ ProtobufThead::init()
 bool
 ProtobufThead::pb_queue_incoming()
 {
-	fawkes::MutexLocker lock(&msgq_mutex_);
-	return !pb_queue_.empty();
+	fawkes::MutexLocker lock(&map_mutex_);
+	for (auto &q : peer_queues_) {
+		if (!q.second->queue.empty())
+			return true;
+	}
+	return false;
 }
 
-ProtobufThead::incoming_message
-ProtobufThead::pb_queue_pop()
+bool
+ProtobufThead::pb_queue_pop(incoming_message &msg)
 {
-	fawkes::MutexLocker lock(&msgq_mutex_);
-	incoming_message    msg = pb_queue_.front();
-	pb_queue_.pop();
-	return msg;
+	fawkes::MutexLocker lock(&map_mutex_);
+	for (size_t i = 0; i < peer_queues_.size(); ++i) {
+		if (next_queue_ == peer_queues_.end())
+			next_queue_ = peer_queues_.begin();
+		peer_queue *q = (next_queue_++)->second;
+
+		unsigned int dropped = q->dropped.exchange(0, std::memory_order_relaxed);
+		if (dropped > 0 && logger) {
+			logger->log_warn(name(), "Dropped %u incoming messages, queue full", dropped);
+		}
+		if (q->queue.pop(msg))
+			return true;
+	}
+	return false;
 }
 
 /** Enable protobuf peer.
@@ -96,15 +111,17 @@ ProtobufThead::peer_create_local_crypto(const std::string &address,
 		protobuf_comm::ProtobufBroadcastPeer *peer = new protobuf_comm::ProtobufBroadcastPeer(
 		  address, send_to_port, recv_on_port, message_register_, crypto_key, cipher);
 
-		long int peer_id;
+		long int    peer_id;
+		peer_queue *queue = new peer_queue();
 		{
 			fawkes::MutexLocker lock(&map_mutex_);
-			peer_id         = ++next_client_id_;
-			peers_[peer_id] = peer;
+			peer_id               = ++next_client_id_;
+			peers_[peer_id]       = peer;
+			peer_queues_[peer_id] = queue;
 		}
 
 		peer->signal_received().connect(
-		  boost::bind(&ProtobufThead::handle_peer_msg, this, peer_id, _1, _2, _3, _4));
+		  boost::bind(&ProtobufThead::handle_peer_msg, this, peer_id, queue, _1, _2, _3, _4));
 		peer->signal_recv_error().connect(
 		  boost::bind(&ProtobufThead::handle_peer_recv_error, this, peer_id, _1, _2));
 		peer->signal_send_error().connect(
@@ -161,9 +178,14 @@ ProtobufThead::peer_create_local(const std::string &address, int send_to_port, i
 void
 ProtobufThead::peer_destroy(long int peer_id)
 {
+	fawkes::MutexLocker lock(&map_mutex_);
 	if (peers_.find(peer_id) != peers_.end()) {
+		// deleting the peer stops its receiving thread, only then drop the queue
 		delete peers_[peer_id];
 		peers_.erase(peer_id);
+		delete peer_queues_[peer_id];
+		peer_queues_.erase(peer_id);
+		next_queue_ = peer_queues_.end();
 	}
 }
 
@@ -224,6 +246,10 @@ ProtobufThead::send(long int peer_id, std::shared_ptr<google::protobuf::Message>
 }
 
 /** Handle message that came from a peer/robot
+ * Called from the receiving thread of the peer, which is the only producer
+ * of the peer's queue. If the queue is full the message is dropped.
+ * @param peer_id ID of the receiving peer
+ * @param queue incoming message queue of the peer
  * @param endpoint the endpoint from which the message was received
  * @param component_id component the message was addressed to
  * @param msg_type type of the message
@@ -231,13 +257,16 @@ ProtobufThead::send(long int peer_id, std::shared_ptr<google::protobuf::Message>
  */
 void
 ProtobufThead::handle_peer_msg(long int                        peer_id,
+                               peer_queue                     *queue,
                                boost::asio::ip::udp::endpoint &endpoint,
                                uint16_t                        component_id,
                                uint16_t                        msg_type,
                                std::shared_ptr<Message>        msg)
 {
-	fawkes::MutexLocker lock(&msgq_mutex_);
-	pb_queue_.push({peer_id, endpoint, component_id, msg_type, std::move(msg)});
+	incoming_message inc{peer_id, endpoint, component_id, msg_type, std::move(msg)};
+	if (!queue->queue.push(std::move(inc))) {
+		queue->dropped.fetch_add(1, std::memory_order_relaxed);
+	}
 	bb_manager_->wakeup();
 }
 
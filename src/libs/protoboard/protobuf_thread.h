@@ -22,6 +22,9 @@
 #ifndef MESSAGE_HANDLER_H
 #define MESSAGE_HANDLER_H
 
+#include "message_pool.h"
+#include "spsc_queue.h"
+
 #include <aspect/blackboard.h>
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
@@ -29,9 +32,9 @@
 #include <core/threading/thread.h>
 #include <protobuf_comm/server.h>
 
+#include <atomic>
 #include <list>
 #include <map>
-#include <queue>
 
 #define CFG_PREFIX "/plugins/protoboard"
 
@@ -59,6 +62,9 @@ public:
 	/// Destructor
 	virtual ~ProtobufThead() override;
 
+	/// Number of incoming messages that can be queued per peer
+	static const size_t PEER_QUEUE_SIZE = 256;
+
 	/// @return whether incoming ProtoBuf messages are in the queue
 	bool pb_queue_incoming();
 
@@ -77,8 +83,10 @@ public:
 		std::shared_ptr<google::protobuf::Message> msg;
 	};
 
-	/// @return The head of the incoming ProtoBuf message queue (popped)
-	incoming_message pb_queue_pop();
+	/** Pop the next incoming message. Peers are served round-robin.
+	 * @param msg upon return set to the popped message
+	 * @return false if no message is queued */
+	bool pb_queue_pop(incoming_message &msg);
 
 	long int peer_create(const std::string &host, int port);
 	long int peer_create_local(const std::string &host, int send_to_port, int recv_on_port);
@@ -100,6 +108,20 @@ public:
 	 */
 	void send(long int peer_id, std::shared_ptr<google::protobuf::Message> msg);
 
+	/**
+	 * Get a message to send. Messages are recycled once they have been sent, so
+	 * filling and sending them repeatedly does not allocate memory. Use this
+	 * instead of creating or cloning a new message for each @a send.
+	 * @tparam MessageT concrete ProtoBuf message type
+	 * @return a cleared message
+	 */
+	template <class MessageT>
+	static std::shared_ptr<MessageT>
+	new_message()
+	{
+		return pb_message_pool<MessageT>::instance().acquire();
+	}
+
 	/**
 	 * Deferred initialization of the pointer to the BlackboardManager
 	 * @param bb_manager the BlackboardManager to use
@@ -144,7 +166,21 @@ private:
 	void
 	peer_setup_crypto(long int peer_id, const std::string &crypto_key, const std::string &cipher);
 
+	/// Queue of incoming messages of one peer and the number of dropped messages
+	struct peer_queue
+	{
+		/// Constructor
+		peer_queue() : queue(PEER_QUEUE_SIZE), dropped(0)
+		{
+		}
+		/// The queue, filled by the receiving thread of the peer
+		spsc_queue<incoming_message> queue;
+		/// Number of messages dropped since last reported because the queue was full
+		std::atomic<unsigned int> dropped;
+	};
+
 	void handle_peer_msg(long int                                   peer_id,
+	                     peer_queue                                *queue,
 	                     boost::asio::ip::udp::endpoint            &endpoint,
 	                     uint16_t                                   component_id,
 	                     uint16_t                                   msg_type,
@@ -160,13 +196,13 @@ private:
 	  sig_peer_sent_;
 
 	fawkes::Mutex map_mutex_;
-	fawkes::Mutex msgq_mutex_;
 	long int      next_client_id_;
 
 	std::map<long int, protobuf_comm::ProtobufBroadcastPeer *> peers_;
+	std::map<long int, peer_queue *>                           peer_queues_;
+	std::map<long int, peer_queue *>::iterator                 next_queue_;
 
-	BlackboardManager           *bb_manager_;
-	std::queue<incoming_message> pb_queue_;
+	BlackboardManager *bb_manager_;
 };
 
 } // namespace protoboard
@@ -0,0 +1,110 @@
+/***************************************************************************
+ * Protoboard plugin template
+ * - Bounded lock-free single-producer single-consumer queue
+ *
+ * Copyright 2026 Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef PROTOBOARD_SPSC_QUEUE_H_
+#define PROTOBOARD_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace protoboard {
+
+/**
+ * Bounded queue for exactly one producer and one consumer thread.
+ * All slots are allocated on construction, pushing and popping neither
+ * allocates memory nor takes a lock. Elements are moved in and out of
+ * their slots.
+ * @tparam T element type, must be default-constructible and move-assignable
+ */
+template <class T>
+class spsc_queue
+{
+public:
+	/** Constructor.
+	 * @param capacity maximum number of queued elements, rounded up to a power of two */
+	explicit spsc_queue(size_t capacity) : head_(0), tail_(0)
+	{
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+		slots_.resize(size);
+		mask_ = size - 1;
+	}
+
+	spsc_queue(const spsc_queue &) = delete;
+	spsc_queue &operator=(const spsc_queue &) = delete;
+
+	/** Append an element. May only be called by the producer thread.
+	 * @param v element to move into the queue
+	 * @return false if the queue is full, @p v is left untouched in that case */
+	bool
+	push(T &&v)
+	{
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_.load(std::memory_order_acquire) > mask_)
+			return false;
+		slots_[tail & mask_] = std::move(v);
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Remove the oldest element. May only be called by the consumer thread.
+	 * @param v upon return set to the removed element
+	 * @return false if the queue is empty */
+	bool
+	pop(T &v)
+	{
+		size_t head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire))
+			return false;
+		v = std::move(slots_[head & mask_]);
+		// release slot resources now rather than on overwrite
+		slots_[head & mask_] = T();
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Check if the queue is empty.
+	 * @return true if no element is queued */
+	bool
+	empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+	/// @return maximum number of queued elements
+	size_t
+	capacity() const
+	{
+		return mask_ + 1;
+	}
+
+private:
+	std::vector<T> slots_;
+	size_t         mask_;
+
+	alignas(64) std::atomic<size_t> head_;
+	alignas(64) std::atomic<size_t> tail_;
+};
+
+} // namespace protoboard
+
+#endif // PROTOBOARD_SPSC_QUEUE_H_
@@ -56,6 +56,12 @@ namespace protobuf_clips {
  * environment. It supports the creation of communication channels
  * through protobuf_comm. An instance maintains its own message register
  * shared among server, peer, and clients.
+ *
+ * Field descriptors are looked up once per message type and field name
+ * and then cached. To avoid one function call per field in rules, a
+ * deftemplate can be defined for a message type with
+ * pb-define-fact-template and a message asserted as a single fact of
+ * that template with pb-assert-fact.
  * @author Tim Niemueller
  */
 
@@ -198,6 +204,12 @@ ClipsProtobufCommunicator::setup_clips()
 	ADD_FUNCTION("pb-disconnect",
 	             (sigc::slot<void, long int>(
 	               sigc::mem_fun(*this, &ClipsProtobufCommunicator::clips_pb_disconnect))));
+	ADD_FUNCTION("pb-define-fact-template",
+	             (sigc::slot<CLIPS::Value, std::string>(sigc::mem_fun(
+	               *this, &ClipsProtobufCommunicator::clips_pb_define_fact_template))));
+	ADD_FUNCTION("pb-assert-fact",
+	             (sigc::slot<CLIPS::Value, void *>(
+	               sigc::mem_fun(*this, &ClipsProtobufCommunicator::clips_pb_assert_fact))));
 }
 
 /** Enable protobuf stream server.
@@ -423,8 +435,7 @@ ClipsProtobufCommunicator::clips_pb_field_type(void *msgptr, std::string field_n
 	if (!*m)
 		return CLIPS::Value("INVALID-MESSAGE", CLIPS::TYPE_SYMBOL);
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field) {
 		return CLIPS::Value("DOES-NOT-EXIST", CLIPS::TYPE_SYMBOL);
 	}
@@ -458,8 +469,7 @@ ClipsProtobufCommunicator::clips_pb_has_field(void *msgptr, std::string field_na
 	if (!*m)
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field)
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
 
@@ -480,8 +490,7 @@ ClipsProtobufCommunicator::clips_pb_field_label(void *msgptr, std::string field_
 	if (!*m)
 		return CLIPS::Value("INVALID-MESSAGE", CLIPS::TYPE_SYMBOL);
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field) {
 		return CLIPS::Value("DOES-NOT-EXIST", CLIPS::TYPE_SYMBOL);
 	}
@@ -505,8 +514,7 @@ ClipsProtobufCommunicator::clips_pb_field_value(void *msgptr, std::string field_
 		return CLIPS::Value("INVALID-MESSAGE", CLIPS::TYPE_SYMBOL);
 	}
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field) {
 		if (logger_) {
 			logger_->log_warn("CLIPS-Protobuf",
@@ -526,39 +534,7 @@ ClipsProtobufCommunicator::clips_pb_field_value(void *msgptr, std::string field_
 		}
 		return CLIPS::Value("NOT-SET", CLIPS::TYPE_SYMBOL);
 	}
-	switch (field->type()) {
-	case FieldDescriptor::TYPE_DOUBLE: return CLIPS::Value(refl->GetDouble(**m, field));
-	case FieldDescriptor::TYPE_FLOAT: return CLIPS::Value(refl->GetFloat(**m, field));
-	case FieldDescriptor::TYPE_INT64: return CLIPS::Value(refl->GetInt64(**m, field));
-	case FieldDescriptor::TYPE_UINT64: return CLIPS::Value((long int)refl->GetUInt64(**m, field));
-	case FieldDescriptor::TYPE_INT32: return CLIPS::Value(refl->GetInt32(**m, field));
-	case FieldDescriptor::TYPE_FIXED64: return CLIPS::Value((long int)refl->GetUInt64(**m, field));
-	case FieldDescriptor::TYPE_FIXED32: return CLIPS::Value(refl->GetUInt32(**m, field));
-	case FieldDescriptor::TYPE_BOOL:
-		//Booleans are represented as Symbols in CLIPS
-		if (refl->GetBool(**m, field)) {
-			return CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
-		} else {
-			return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
-		}
-	case FieldDescriptor::TYPE_STRING: return CLIPS::Value(refl->GetString(**m, field));
-	case FieldDescriptor::TYPE_MESSAGE: {
-		const google::protobuf::Message &mfield = refl->GetMessage(**m, field);
-		google::protobuf::Message       *mcopy  = mfield.New();
-		mcopy->CopyFrom(mfield);
-		void *ptr = new std::shared_ptr<google::protobuf::Message>(mcopy);
-		return CLIPS::Value(ptr);
-	}
-	case FieldDescriptor::TYPE_BYTES: return CLIPS::Value((char *)"bytes");
-	case FieldDescriptor::TYPE_UINT32: return CLIPS::Value(refl->GetUInt32(**m, field));
-	case FieldDescriptor::TYPE_ENUM:
-		return CLIPS::Value(refl->GetEnum(**m, field)->name(), CLIPS::TYPE_SYMBOL);
-	case FieldDescriptor::TYPE_SFIXED32: return CLIPS::Value(refl->GetInt32(**m, field));
-	case FieldDescriptor::TYPE_SFIXED64: return CLIPS::Value(refl->GetInt64(**m, field));
-	case FieldDescriptor::TYPE_SINT32: return CLIPS::Value(refl->GetInt32(**m, field));
-	case FieldDescriptor::TYPE_SINT64: return CLIPS::Value(refl->GetInt64(**m, field));
-	default: throw std::logic_error("Unknown protobuf field type encountered");
-	}
+	return field_value(**m, field);
 }
 
 void
@@ -571,8 +547,7 @@ ClipsProtobufCommunicator::clips_pb_set_field(void        *msgptr,
 	if (!(m && *m))
 		return;
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field) {
 		if (logger_) {
 			logger_->log_warn("CLIPS-Protobuf", "Could not find field %s", field_name.c_str());
@@ -647,8 +622,7 @@ ClipsProtobufCommunicator::clips_pb_add_list(void        *msgptr,
 	if (!(m && *m))
 		return;
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field) {
 		if (logger_) {
 			logger_->log_warn("CLIPS-Protobuf", "Could not find field %s", field_name.c_str());
@@ -882,8 +856,7 @@ ClipsProtobufCommunicator::clips_pb_field_list(void *msgptr, std::string field_n
 	if (!(m && *m))
 		return CLIPS::Values(1, CLIPS::Value("INVALID-MESSAGE", CLIPS::TYPE_SYMBOL));
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field) {
 		return CLIPS::Values(1, CLIPS::Value("DOES-NOT-EXIST", CLIPS::TYPE_SYMBOL));
 	}
@@ -893,65 +866,7 @@ ClipsProtobufCommunicator::clips_pb_field_list(void *msgptr, std::string field_n
 		return rv;
 	}
 
-	const Reflection *refl       = (*m)->GetReflection();
-	int               field_size = refl->FieldSize(**m, field);
-	CLIPS::Values     rv(field_size);
-	for (int i = 0; i < field_size; ++i) {
-		switch (field->type()) {
-		case FieldDescriptor::TYPE_DOUBLE:
-			rv[i] = CLIPS::Value(refl->GetRepeatedDouble(**m, field, i));
-			break;
-		case FieldDescriptor::TYPE_FLOAT:
-			rv[i] = CLIPS::Value(refl->GetRepeatedFloat(**m, field, i));
-			break;
-			break;
-		case FieldDescriptor::TYPE_UINT64:
-		case FieldDescriptor::TYPE_FIXED64:
-			rv[i] = CLIPS::Value((long int)refl->GetRepeatedUInt64(**m, field, i));
-			break;
-		case FieldDescriptor::TYPE_UINT32:
-		case FieldDescriptor::TYPE_FIXED32:
-			rv[i] = CLIPS::Value(refl->GetRepeatedUInt32(**m, field, i));
-			break;
-		case FieldDescriptor::TYPE_BOOL:
-			//Booleans are represented as Symbols in CLIPS
-			if (refl->GetRepeatedBool(**m, field, i)) {
-				rv[i] = CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
-			} else {
-				rv[i] = CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
-			}
-			break;
-		case FieldDescriptor::TYPE_STRING:
-			rv[i] = CLIPS::Value(refl->GetRepeatedString(**m, field, i));
-			break;
-		case FieldDescriptor::TYPE_MESSAGE: {
-			const google::protobuf::Message &msg   = refl->GetRepeatedMessage(**m, field, i);
-			google::protobuf::Message       *mcopy = msg.New();
-			mcopy->CopyFrom(msg);
-			void *ptr = new std::shared_ptr<google::protobuf::Message>(mcopy);
-			rv[i]     = CLIPS::Value(ptr);
-		} break;
-		case FieldDescriptor::TYPE_BYTES:
-			rv[i] = CLIPS::Value((char *)"BYTES", CLIPS::TYPE_SYMBOL);
-			break;
-		case FieldDescriptor::TYPE_ENUM:
-			rv[i] = CLIPS::Value(refl->GetRepeatedEnum(**m, field, i)->name(), CLIPS::TYPE_SYMBOL);
-			break;
-		case FieldDescriptor::TYPE_SFIXED32:
-		case FieldDescriptor::TYPE_INT32:
-		case FieldDescriptor::TYPE_SINT32:
-			rv[i] = CLIPS::Value(refl->GetRepeatedInt32(**m, field, i));
-			break;
-		case FieldDescriptor::TYPE_SFIXED64:
-		case FieldDescriptor::TYPE_SINT64:
-		case FieldDescriptor::TYPE_INT64:
-			rv[i] = CLIPS::Value(refl->GetRepeatedInt64(**m, field, i));
-			break;
-		default: throw std::logic_error("Unknown protobuf field type encountered");
-		}
-	}
-
-	return rv;
+	return field_values(**m, field);
 }
 
 CLIPS::Value
@@ -962,8 +877,7 @@ ClipsProtobufCommunicator::clips_pb_field_is_list(void *msgptr, std::string fiel
 	if (!(m && *m))
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
 
-	const Descriptor      *desc  = (*m)->GetDescriptor();
-	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	const FieldDescriptor *field = find_field(**m, field_name);
 	if (!field)
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
 	return CLIPS::Value(field->is_repeated() ? "TRUE" : "FALSE", CLIPS::TYPE_SYMBOL);
@@ -1195,6 +1109,261 @@ ClipsProtobufCommunicator::handle_client_receive_fail(long int    client_id,
 	                      msg.c_str());
 }
 
+/** Find field of a message.
+ * Field descriptors are cached per message type.
+ * @param msg message to find the field of
+ * @param field_name name of the field
+ * @return field descriptor, NULL if the message has no such field
+ */
+const FieldDescriptor *
+ClipsProtobufCommunicator::find_field(const google::protobuf::Message &msg,
+                                      const std::string               &field_name)
+{
+	const Descriptor  *desc   = msg.GetDescriptor();
+	FieldMap          &fields = accessors_[desc].fields;
+	FieldMap::iterator f      = fields.find(field_name);
+	if (f != fields.end())
+		return f->second;
+
+	const FieldDescriptor *field = desc->FindFieldByName(field_name);
+	fields[field_name]           = field;
+	return field;
+}
+
+/** Get fields which are converted to fact slots.
+ * These are all fields except message and bytes fields.
+ * @param desc descriptor of message type
+ * @return list of fields in declaration order
+ */
+const ClipsProtobufCommunicator::FieldList &
+ClipsProtobufCommunicator::fact_fields(const Descriptor *desc)
+{
+	TypeAccessors &acc = accessors_[desc];
+	if (!acc.fact_fields_valid) {
+		for (int i = 0; i < desc->field_count(); ++i) {
+			const FieldDescriptor *field = desc->field(i);
+			if (field->type() != FieldDescriptor::TYPE_MESSAGE
+			    && field->type() != FieldDescriptor::TYPE_BYTES) {
+				acc.fact_fields.push_back(field);
+			}
+		}
+		acc.fact_fields_valid = true;
+	}
+	return acc.fact_fields;
+}
+
+/** Convert value of a non-repeated field.
+ * @param msg message to read from
+ * @param field field to read
+ * @return CLIPS value of the field
+ */
+CLIPS::Value
+ClipsProtobufCommunicator::field_value(const google::protobuf::Message &msg,
+                                       const FieldDescriptor           *field)
+{
+	const Reflection *refl = msg.GetReflection();
+	switch (field->type()) {
+	case FieldDescriptor::TYPE_DOUBLE: return CLIPS::Value(refl->GetDouble(msg, field));
+	case FieldDescriptor::TYPE_FLOAT: return CLIPS::Value(refl->GetFloat(msg, field));
+	case FieldDescriptor::TYPE_INT64: return CLIPS::Value(refl->GetInt64(msg, field));
+	case FieldDescriptor::TYPE_UINT64: return CLIPS::Value((long int)refl->GetUInt64(msg, field));
+	case FieldDescriptor::TYPE_INT32: return CLIPS::Value(refl->GetInt32(msg, field));
+	case FieldDescriptor::TYPE_FIXED64: return CLIPS::Value((long int)refl->GetUInt64(msg, field));
+	case FieldDescriptor::TYPE_FIXED32: return CLIPS::Value(refl->GetUInt32(msg, field));
+	case FieldDescriptor::TYPE_BOOL:
+		//Booleans are represented as Symbols in CLIPS
+		if (refl->GetBool(msg, field)) {
+			return CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
+		} else {
+			return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+		}
+	case FieldDescriptor::TYPE_STRING: return CLIPS::Value(refl->GetString(msg, field));
+	case FieldDescriptor::TYPE_MESSAGE: {
+		const google::protobuf::Message &mfield = refl->GetMessage(msg, field);
+		google::protobuf::Message       *mcopy  = mfield.New();
+		mcopy->CopyFrom(mfield);
+		void *ptr = new std::shared_ptr<google::protobuf::Message>(mcopy);
+		return CLIPS::Value(ptr);
+	}
+	case FieldDescriptor::TYPE_BYTES: return CLIPS::Value((char *)"bytes");
+	case FieldDescriptor::TYPE_UINT32: return CLIPS::Value(refl->GetUInt32(msg, field));
+	case FieldDescriptor::TYPE_ENUM:
+		return CLIPS::Value(refl->GetEnum(msg, field)->name(), CLIPS::TYPE_SYMBOL);
+	case FieldDescriptor::TYPE_SFIXED32: return CLIPS::Value(refl->GetInt32(msg, field));
+	case FieldDescriptor::TYPE_SFIXED64: return CLIPS::Value(refl->GetInt64(msg, field));
+	case FieldDescriptor::TYPE_SINT32: return CLIPS::Value(refl->GetInt32(msg, field));
+	case FieldDescriptor::TYPE_SINT64: return CLIPS::Value(refl->GetInt64(msg, field));
+	default: throw std::logic_error("Unknown protobuf field type encountered");
+	}
+}
+
+/** Convert values of a field.
+ * @param msg message to read from
+ * @param field field to read, if it is not repeated the result contains
+ * the single value of the field
+ * @return CLIPS values of the field
+ */
+CLIPS::Values
+ClipsProtobufCommunicator::field_values(const google::protobuf::Message &msg,
+                                        const FieldDescriptor           *field)
+{
+	if (!field->is_repeated()) {
+		return CLIPS::Values(1, field_value(msg, field));
+	}
+
+	const Reflection *refl       = msg.GetReflection();
+	int               field_size = refl->FieldSize(msg, field);
+	CLIPS::Values     rv(field_size);
+	for (int i = 0; i < field_size; ++i) {
+		switch (field->type()) {
+		case FieldDescriptor::TYPE_DOUBLE:
+			rv[i] = CLIPS::Value(refl->GetRepeatedDouble(msg, field, i));
+			break;
+		case FieldDescriptor::TYPE_FLOAT:
+			rv[i] = CLIPS::Value(refl->GetRepeatedFloat(msg, field, i));
+			break;
+		case FieldDescriptor::TYPE_UINT64:
+		case FieldDescriptor::TYPE_FIXED64:
+			rv[i] = CLIPS::Value((long int)refl->GetRepeatedUInt64(msg, field, i));
+			break;
+		case FieldDescriptor::TYPE_UINT32:
+		case FieldDescriptor::TYPE_FIXED32:
+			rv[i] = CLIPS::Value(refl->GetRepeatedUInt32(msg, field, i));
+			break;
+		case FieldDescriptor::TYPE_BOOL:
+			//Booleans are represented as Symbols in CLIPS
+			if (refl->GetRepeatedBool(msg, field, i)) {
+				rv[i] = CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
+			} else {
+				rv[i] = CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+			}
+			break;
+		case FieldDescriptor::TYPE_STRING:
+			rv[i] = CLIPS::Value(refl->GetRepeatedString(msg, field, i));
+			break;
+		case FieldDescriptor::TYPE_MESSAGE: {
+			const google::protobuf::Message &rmsg  = refl->GetRepeatedMessage(msg, field, i);
+			google::protobuf::Message       *mcopy = rmsg.New();
+			mcopy->CopyFrom(rmsg);
+			void *ptr = new std::shared_ptr<google::protobuf::Message>(mcopy);
+			rv[i]     = CLIPS::Value(ptr);
+		} break;
+		case FieldDescriptor::TYPE_BYTES:
+			rv[i] = CLIPS::Value((char *)"BYTES", CLIPS::TYPE_SYMBOL);
+			break;
+		case FieldDescriptor::TYPE_ENUM:
+			rv[i] = CLIPS::Value(refl->GetRepeatedEnum(msg, field, i)->name(), CLIPS::TYPE_SYMBOL);
+			break;
+		case FieldDescriptor::TYPE_SFIXED32:
+		case FieldDescriptor::TYPE_INT32:
+		case FieldDescriptor::TYPE_SINT32:
+			rv[i] = CLIPS::Value(refl->GetRepeatedInt32(msg, field, i));
+			break;
+		case FieldDescriptor::TYPE_SFIXED64:
+		case FieldDescriptor::TYPE_SINT64:
+		case FieldDescriptor::TYPE_INT64:
+			rv[i] = CLIPS::Value(refl->GetRepeatedInt64(msg, field, i));
+			break;
+		default: throw std::logic_error("Unknown protobuf field type encountered");
+		}
+	}
+
+	return rv;
+}
+
+/** Define a deftemplate for a message type.
+ * The template is named after the full name of the message type and has
+ * a slot for each field, or a multislot for each repeated field. Message
+ * and bytes fields are omitted, use pb-field-value on the message for
+ * these.
+ * @param full_name full name of the message type
+ * @return TRUE if the template has been defined, FALSE otherwise
+ */
+CLIPS::Value
+ClipsProtobufCommunicator::clips_pb_define_fact_template(std::string full_name)
+{
+	std::shared_ptr<google::protobuf::Message> m;
+	try {
+		m = message_register_->new_message_for(full_name);
+	} catch (std::runtime_error &e) {
+		if (logger_) {
+			logger_->log_warn("CLIPS-Protobuf",
+			                  "Cannot define template for %s: %s",
+			                  full_name.c_str(),
+			                  e.what());
+		}
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+
+	std::string      deftemplate = "(deftemplate " + full_name;
+	const FieldList &fields      = fact_fields(m->GetDescriptor());
+	for (const FieldDescriptor *field : fields) {
+		deftemplate += field->is_repeated() ? " (multislot " : " (slot ";
+		deftemplate += field->name() + " (type ";
+		switch (field->type()) {
+		case FieldDescriptor::TYPE_DOUBLE:
+		case FieldDescriptor::TYPE_FLOAT: deftemplate += "FLOAT"; break;
+		case FieldDescriptor::TYPE_STRING: deftemplate += "STRING"; break;
+		case FieldDescriptor::TYPE_BOOL:
+		case FieldDescriptor::TYPE_ENUM: deftemplate += "SYMBOL"; break;
+		default: deftemplate += "INTEGER"; break;
+		}
+		deftemplate += "))";
+	}
+	deftemplate += ")";
+
+	if (!clips_->build(deftemplate)) {
+		if (logger_) {
+			logger_->log_warn("CLIPS-Protobuf", "Failed to define template %s", deftemplate.c_str());
+		}
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+	return CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
+}
+
+/** Assert message as a fact.
+ * Converts all fields of the message at once and asserts a fact of the
+ * template defined with pb-define-fact-template for the message type.
+ * @param msgptr message to assert
+ * @return TRUE if the fact has been asserted, FALSE otherwise
+ */
+CLIPS::Value
+ClipsProtobufCommunicator::clips_pb_assert_fact(void *msgptr)
+{
+	std::shared_ptr<google::protobuf::Message> *m =
+	  static_cast<std::shared_ptr<google::protobuf::Message> *>(msgptr);
+	if (!(m && *m)) {
+		if (logger_) {
+			logger_->log_warn("CLIPS-Protobuf", "Cannot assert fact: invalid message");
+		}
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+
+	CLIPS::Template::pointer temp = clips_->get_template((*m)->GetTypeName());
+	if (!temp) {
+		if (logger_) {
+			logger_->log_warn("CLIPS-Protobuf",
+			                  "Cannot assert fact: no template for %s",
+			                  (*m)->GetTypeName().c_str());
+		}
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+
+	CLIPS::Fact::pointer fact   = CLIPS::Fact::create(*clips_, temp);
+	const FieldList     &fields = fact_fields((*m)->GetDescriptor());
+	for (const FieldDescriptor *field : fields) {
+		if (field->is_repeated()) {
+			fact->set_slot(field->name(), field_values(**m, field));
+		} else {
+			fact->set_slot(field->name(), field_value(**m, field));
+		}
+	}
+	if (!clips_->assert_fact(fact)) {
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+	return CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
+}
+
 std::string
 ClipsProtobufCommunicator::to_string(const CLIPS::Value &v)
 {
@@ -43,6 +43,8 @@
 #include <clipsmm.h>
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace protobuf_comm {
 class ProtobufStreamClient;
@@ -145,6 +147,8 @@ private:
 	void          clips_pb_disconnect(long int client_id);
 	void          clips_pb_broadcast(long int peer_id, void *msgptr);
 	void          clips_pb_enable_server(int port);
+	CLIPS::Value  clips_pb_define_fact_template(std::string full_name);
+	CLIPS::Value  clips_pb_assert_fact(void *msgptr);
 
 	long int clips_pb_peer_create(std::string host, int port);
 	long int clips_pb_peer_create_local(std::string host, int send_port, int recv_port);
@@ -203,7 +207,29 @@ private:
 	                                uint16_t    msg_type,
 	                                std::string msg);
 
-	static std::string to_string(const CLIPS::Value &v);
+	/** Map from field name to field descriptor. */
+	typedef std::unordered_map<std::string, const google::protobuf::FieldDescriptor *> FieldMap;
+	/** List of field descriptors. */
+	typedef std::vector<const google::protobuf::FieldDescriptor *> FieldList;
+
+	const google::protobuf::FieldDescriptor *find_field(const google::protobuf::Message &msg,
+	                                                    const std::string               &field_name);
+	const FieldList                         &fact_fields(const google::protobuf::Descriptor *desc);
+
+	static CLIPS::Value  field_value(const google::protobuf::Message         &msg,
+	                                 const google::protobuf::FieldDescriptor *field);
+	static CLIPS::Values field_values(const google::protobuf::Message         &msg,
+	                                  const google::protobuf::FieldDescriptor *field);
+	static std::string   to_string(const CLIPS::Value &v);
+
+	/// @cond INTERNALS
+	struct TypeAccessors
+	{
+		FieldMap  fields;
+		FieldList fact_fields;
+		bool      fact_fields_valid = false;
+	};
+	/// @endcond
 
 private:
 	CLIPS::Environment *clips_;
@@ -236,6 +262,8 @@ private:
 
 	std::list<std::string> functions_;
 	CLIPS::Fact::pointer   avail_fact_;
+
+	std::unordered_map<const google::protobuf::Descriptor *, TypeAccessors> accessors_;
 };
 
 } // end namespace protobuf_clips
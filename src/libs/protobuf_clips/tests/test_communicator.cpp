@@ -0,0 +1,156 @@
+/***************************************************************************
+ *  test_communicator.cpp - Protobuf CLIPS communicator unit test
+ *
+ *  Created: Sun Oct 18 18:05:31 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "ProtobufClipsTest.pb.h"
+
+#include <core/threading/mutex.h>
+#include <protobuf_clips/communicator.h>
+
+#include <catch2/catch.hpp>
+#include <clipsmm.h>
+#include <string>
+
+using namespace fawkes;
+using namespace protobuf_clips;
+
+namespace {
+class CommunicatorFixture
+{
+public:
+	CommunicatorFixture() : comm_(&env_, env_mutex_)
+	{
+		// referencing a type makes sure the message library is linked
+		REQUIRE(protobuf_clips_test::Robot::descriptor() != NULL);
+		REQUIRE(eval("(pb-register-type \"protobuf_clips_test.Robot\")") == "TRUE");
+		REQUIRE(eval("(pb-register-type \"protobuf_clips_test.Team\")") == "TRUE");
+		env_.build("(defglobal ?*robot* = nil ?*team* = nil)");
+		eval("(bind ?*robot* (pb-create \"protobuf_clips_test.Robot\"))");
+		eval("(bind ?*team* (pb-create \"protobuf_clips_test.Team\"))");
+	}
+
+	~CommunicatorFixture()
+	{
+		eval("(pb-destroy ?*robot*)");
+		eval("(pb-destroy ?*team*)");
+	}
+
+protected:
+	std::string
+	eval(const std::string &expr)
+	{
+		CLIPS::Values rv = env_.evaluate(expr);
+		if (rv.empty()) {
+			return "";
+		}
+		switch (rv[0].type()) {
+		case CLIPS::TYPE_INTEGER: return std::to_string(rv[0].as_integer());
+		case CLIPS::TYPE_FLOAT: return std::to_string(rv[0].as_float());
+		case CLIPS::TYPE_SYMBOL:
+		case CLIPS::TYPE_STRING: return rv[0].as_string();
+		default: return "";
+		}
+	}
+
+	bool
+	has_fact(const std::string &query)
+	{
+		return eval("(any-factp ((?f protobuf_clips_test.Robot)) " + query + ")") == "TRUE";
+	}
+
+protected:
+	CLIPS::Environment        env_;
+	Mutex                     env_mutex_;
+	ClipsProtobufCommunicator comm_;
+};
+} // namespace
+
+TEST_CASE_METHOD(CommunicatorFixture, "Field accessors are cached per type", "[protobuf_clips]")
+{
+	eval("(pb-set-field ?*robot* \"name\" \"robotino\")");
+	eval("(pb-set-field ?*robot* \"number\" 7)");
+	eval("(pb-set-field ?*team* \"name\" \"carologistics\")");
+	eval("(pb-set-field ?*team* \"number\" 3)");
+
+	// both types have fields of the same name, lookups must not mix them up
+	for (unsigned int i = 0; i < 2; ++i) {
+		REQUIRE(eval("(pb-field-value ?*robot* \"name\")") == "robotino");
+		REQUIRE(eval("(pb-field-value ?*team* \"name\")") == "carologistics");
+		REQUIRE(eval("(pb-field-value ?*robot* \"number\")") == "7");
+		REQUIRE(eval("(pb-field-value ?*team* \"number\")") == "3");
+	}
+
+	// missing fields are cached as well
+	for (unsigned int i = 0; i < 2; ++i) {
+		REQUIRE(eval("(pb-field-value ?*robot* \"foo\")") == "DOES-NOT-EXIST");
+		REQUIRE(eval("(pb-has-field ?*robot* \"foo\")") == "FALSE");
+	}
+
+	REQUIRE(eval("(pb-field-value ?*robot* \"active\")") == "NOT-SET");
+	eval("(pb-set-field ?*robot* \"active\" TRUE)");
+	REQUIRE(eval("(pb-field-value ?*robot* \"active\")") == "TRUE");
+
+	eval("(pb-set-field ?*robot* \"state\" MOVING)");
+	REQUIRE(eval("(pb-field-value ?*robot* \"state\")") == "MOVING");
+
+	REQUIRE(eval("(pb-field-is-list ?*robot* \"tags\")") == "TRUE");
+	REQUIRE(eval("(pb-has-field ?*robot* \"tags\")") == "FALSE");
+	eval("(pb-add-list ?*robot* \"tags\" \"fast\")");
+	eval("(pb-add-list ?*robot* \"tags\" \"red\")");
+	REQUIRE(eval("(pb-has-field ?*robot* \"tags\")") == "TRUE");
+	REQUIRE(eval("(length$ (pb-field-list ?*robot* \"tags\"))") == "2");
+	REQUIRE(eval("(nth$ 2 (pb-field-list ?*robot* \"tags\"))") == "red");
+}
+
+TEST_CASE_METHOD(CommunicatorFixture, "Messages are asserted as facts", "[protobuf_clips]")
+{
+	REQUIRE(eval("(pb-define-fact-template \"protobuf_clips_test.Robot\")") == "TRUE");
+	REQUIRE(eval("(deftemplate-slot-existp protobuf_clips_test.Robot name)") == "TRUE");
+	REQUIRE(eval("(deftemplate-slot-multip protobuf_clips_test.Robot tags)") == "TRUE");
+	REQUIRE(eval("(deftemplate-slot-existp protobuf_clips_test.Robot pose)") == "FALSE");
+	REQUIRE(eval("(deftemplate-slot-existp protobuf_clips_test.Robot data)") == "FALSE");
+
+	eval("(pb-set-field ?*robot* \"name\" \"robotino\")");
+	eval("(pb-set-field ?*robot* \"speed\" 0.5)");
+	eval("(pb-add-list ?*robot* \"tags\" \"fast\")");
+	eval("(pb-add-list ?*robot* \"tags\" \"red\")");
+	REQUIRE(eval("(pb-assert-fact ?*robot*)") == "TRUE");
+
+	// unset optional fields get their default values
+	REQUIRE(has_fact("(and (eq ?f:name \"robotino\") (= ?f:speed 0.5) (= ?f:number 0)"
+	                 " (eq ?f:state IDLE) (eq ?f:active FALSE)"
+	                 " (eq ?f:tags (create$ \"fast\" \"red\")))"));
+
+	eval("(pb-set-field ?*robot* \"number\" 42)");
+	eval("(pb-set-field ?*robot* \"state\" MOVING)");
+	REQUIRE(eval("(pb-assert-fact ?*robot*)") == "TRUE");
+	REQUIRE(has_fact("(and (= ?f:number 42) (eq ?f:state MOVING))"));
+	REQUIRE(eval("(length$ (find-all-facts ((?f protobuf_clips_test.Robot)) TRUE))") == "2");
+}
+
+TEST_CASE_METHOD(CommunicatorFixture, "Asserting requires a template", "[protobuf_clips]")
+{
+	REQUIRE(eval("(pb-define-fact-template \"protobuf_clips_test.Unknown\")") == "FALSE");
+
+	eval("(pb-set-field ?*team* \"name\" \"carologistics\")");
+	REQUIRE(eval("(pb-assert-fact ?*team*)") == "FALSE");
+	REQUIRE(eval("(pb-define-fact-template \"protobuf_clips_test.Team\")") == "TRUE");
+	REQUIRE(eval("(pb-assert-fact ?*team*)") == "TRUE");
+}
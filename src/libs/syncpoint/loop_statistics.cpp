@@ -0,0 +1,156 @@
+
+/***************************************************************************
+ *  loop_statistics.cpp - Loop timing statistics of synchronized components
+ *
+ *  Created: Sun Oct 18 22:58:36 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <syncpoint/loop_statistics.h>
+
+namespace fawkes {
+
+/** @class SyncPointLoopStatistics <syncpoint/loop_statistics.h>
+ * Loop timing statistics of a component synchronized by SyncPoints.
+ * For every loop of a component, e.g. a thread with the
+ * BlockedTimingAspect, three durations are recorded:
+ * - wait time: time spent waiting for the input SyncPoint
+ * - wakeup latency: time from the emit call of the input SyncPoint which
+ *   released the component until it actually started its loop
+ * - loop duration: time from the start of the loop until it finished
+ * If the loop duration exceeds the deadline, a deadline miss is counted.
+ *
+ * loop_started() and loop_finished() must be called alternately from the
+ * component's thread. All other methods may be called concurrently from
+ * any thread, e.g. to export the statistics.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param component name of the component, e.g. the thread name
+ * @param hook identifier of the input SyncPoint the component waits for
+ * @param deadline_usec maximum duration of a loop in microseconds, 0 to
+ * disable deadline miss detection
+ */
+SyncPointLoopStatistics::SyncPointLoopStatistics(const std::string &component,
+                                                 const std::string &hook,
+                                                 uint64_t           deadline_usec)
+: component_(component), hook_(hook), deadline_usec_(deadline_usec), deadline_misses_(0)
+{
+	loop_start_usec_ = 0;
+}
+
+/** Get component name.
+ * @return name of the component
+ */
+const std::string &
+SyncPointLoopStatistics::component() const
+{
+	return component_;
+}
+
+/** Get hook.
+ * @return identifier of the SyncPoint the component waits for
+ */
+const std::string &
+SyncPointLoopStatistics::hook() const
+{
+	return hook_;
+}
+
+/** Get deadline.
+ * @return maximum loop duration in microseconds, 0 if disabled
+ */
+uint64_t
+SyncPointLoopStatistics::deadline_usec() const
+{
+	return deadline_usec_;
+}
+
+/** Mark start of a loop.
+ * Call this right after waiting for the input SyncPoint has finished.
+ * @param wait_start_usec time when waiting for the input SyncPoint started
+ * @param emit_usec time of the most recent emit of the input SyncPoint, see
+ * SyncPoint::get_last_emit_usec(). The wakeup latency is only recorded if
+ * the emit happened while the component was waiting.
+ */
+void
+SyncPointLoopStatistics::loop_started(uint64_t wait_start_usec, uint64_t emit_usec)
+{
+	loop_start_usec_ = LatencyHistogram::now_usec();
+	wait_time_.record_usec(loop_start_usec_ - wait_start_usec);
+	if (emit_usec >= wait_start_usec && emit_usec <= loop_start_usec_) {
+		wakeup_latency_.record_usec(loop_start_usec_ - emit_usec);
+	}
+}
+
+/** Mark end of a loop.
+ * Records the loop duration and counts a deadline miss if it exceeded the
+ * deadline. Ignored if loop_started() has not been called before.
+ */
+void
+SyncPointLoopStatistics::loop_finished()
+{
+	if (loop_start_usec_ == 0)
+		return;
+
+	uint64_t duration = LatencyHistogram::now_usec() - loop_start_usec_;
+	loop_duration_.record_usec(duration);
+	if (deadline_usec_ > 0 && duration > deadline_usec_) {
+		deadline_misses_.fetch_add(1, std::memory_order_relaxed);
+	}
+	loop_start_usec_ = 0;
+}
+
+/** Get wait time histogram.
+ * @return histogram of times spent waiting for the input SyncPoint
+ */
+const LatencyHistogram &
+SyncPointLoopStatistics::wait_time() const
+{
+	return wait_time_;
+}
+
+/** Get wakeup latency histogram.
+ * @return histogram of latencies from emit to the start of the loop
+ */
+const LatencyHistogram &
+SyncPointLoopStatistics::wakeup_latency() const
+{
+	return wakeup_latency_;
+}
+
+/** Get loop duration histogram.
+ * @return histogram of loop durations
+ */
+const LatencyHistogram &
+SyncPointLoopStatistics::loop_duration() const
+{
+	return loop_duration_;
+}
+
+/** Get number of deadline misses.
+ * @return number of loops which took longer than the deadline
+ */
+uint64_t
+SyncPointLoopStatistics::num_deadline_misses() const
+{
+	return deadline_misses_.load(std::memory_order_relaxed);
+}
+
+} // end namespace fawkes
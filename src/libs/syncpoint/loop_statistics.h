@@ -0,0 +1,68 @@
+
+/***************************************************************************
+ *  loop_statistics.h - Loop timing statistics of synchronized components
+ *
+ *  Created: Sun Oct 18 22:58:36 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _SYNCPOINT_LOOP_STATISTICS_H_
+#define _SYNCPOINT_LOOP_STATISTICS_H_
+
+#include <utils/time/latency_histogram.h>
+
+#include <atomic>
+#include <string>
+
+namespace fawkes {
+
+class SyncPointLoopStatistics
+{
+public:
+	SyncPointLoopStatistics(const std::string &component,
+	                        const std::string &hook,
+	                        uint64_t           deadline_usec);
+
+	const std::string &component() const;
+	const std::string &hook() const;
+	uint64_t           deadline_usec() const;
+
+	void loop_started(uint64_t wait_start_usec, uint64_t emit_usec);
+	void loop_finished();
+
+	const LatencyHistogram &wait_time() const;
+	const LatencyHistogram &wakeup_latency() const;
+	const LatencyHistogram &loop_duration() const;
+	uint64_t                num_deadline_misses() const;
+
+private:
+	const std::string component_;
+	const std::string hook_;
+	const uint64_t    deadline_usec_;
+
+	LatencyHistogram      wait_time_;
+	LatencyHistogram      wakeup_latency_;
+	LatencyHistogram      loop_duration_;
+	std::atomic<uint64_t> deadline_misses_;
+
+	uint64_t loop_start_usec_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -19,7 +19,9 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include <core/threading/futex.h>
 #include <core/threading/mutex_locker.h>
+#include <core/utils/trace.h>
 #include <syncpoint/exceptions.h>
 #include <syncpoint/syncpoint.h>
 #include <utils/time/time.h>
@@ -28,11 +30,61 @@
 #include <pthread.h>
 #include <sstream>
 #include <string.h>
+#include <time.h>
 
 using namespace std;
 
 namespace fawkes {
 
+/// @cond INTERNALS
+// Number of checks of the generation before a waiter goes to sleep
+static const unsigned int WAIT_SPIN_COUNT = 100;
+
+// Wait until generation differs from seen, without timeout if sec and
+// nsec are zero. Returns false if the timeout expired.
+static bool
+wait_for_generation(std::atomic<uint32_t> &generation, uint32_t seen, uint sec, uint nsec)
+{
+	for (unsigned int i = 0; i < WAIT_SPIN_COUNT; ++i) {
+		if (generation.load() != seen)
+			return true;
+		Futex::cpu_relax();
+	}
+
+	if (!(sec || nsec)) {
+		while (generation.load() == seen) {
+			Futex::wait(generation, seen, NULL, true);
+		}
+		return true;
+	}
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += sec + nsec / 1000000000;
+	deadline.tv_nsec += nsec % 1000000000;
+	if (deadline.tv_nsec >= 1000000000) {
+		deadline.tv_sec += 1;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	while (generation.load() == seen) {
+		struct timespec now, rel;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		rel.tv_sec  = deadline.tv_sec - now.tv_sec;
+		rel.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+		if (rel.tv_nsec < 0) {
+			rel.tv_sec -= 1;
+			rel.tv_nsec += 1000000000;
+		}
+		if (rel.tv_sec < 0) {
+			return generation.load() != seen;
+		}
+		Futex::wait(generation, seen, &rel, true);
+	}
+	return true;
+}
+/// @endcond
+
 /** @class SyncPoint <syncpoint/syncpoint.h>
  * The SyncPoint class.
  * This class is used for dynamic synchronization of threads which depend
@@ -69,13 +121,14 @@ SyncPoint::SyncPoint(string       identifier,
   mutex_next_wait_(new Mutex()),
   cond_next_wait_(new WaitCondition(mutex_next_wait_)),
   mutex_wait_for_one_(new Mutex()),
-  cond_wait_for_one_(new WaitCondition(mutex_wait_for_one_)),
+  wait_for_one_generation_(0),
   mutex_wait_for_all_(new Mutex()),
-  cond_wait_for_all_(new WaitCondition(mutex_wait_for_all_)),
+  wait_for_all_generation_(0),
   wait_for_all_timer_running_(false),
   max_waittime_sec_(max_waittime_sec),
   max_waittime_nsec_(max_waittime_nsec),
   logger_(logger),
+  last_emit_usec_(0),
   last_emitter_reset_(Time(0l))
 {
 	if (identifier.empty()) {
@@ -149,6 +202,7 @@ SyncPoint::operator<(const SyncPoint &other) const
 void
 SyncPoint::emit(const std::string &component)
 {
+	FAWKES_TRACE_SCOPE("syncpoint.emit", identifier_.c_str());
 	emit(component, true);
 }
 
@@ -170,11 +224,14 @@ SyncPoint::emit(const std::string &component, bool remove_from_pending)
 		throw SyncPointNonWatcherCalledEmitException(component.c_str(), get_identifier().c_str());
 	}
 
+	last_emit_usec_.store(LatencyHistogram::now_usec(), std::memory_order_relaxed);
+
 	// unlock all wait_for_one waiters
 	watchers_wait_for_one_.clear();
 	mutex_wait_for_one_->lock();
-	cond_wait_for_one_->wake_all();
+	wait_for_one_generation_.fetch_add(1);
 	mutex_wait_for_one_->unlock();
+	Futex::wake(wait_for_one_generation_);
 
 	if (!emitters_.count(component)) {
 		throw SyncPointNonEmitterCalledEmitException(component.c_str(), get_identifier().c_str());
@@ -200,8 +257,9 @@ SyncPoint::emit(const std::string &component, bool remove_from_pending)
 			if (pending_emitters_.empty()) {
 				watchers_wait_for_all_.clear();
 				mutex_wait_for_all_->lock();
-				cond_wait_for_all_->wake_all();
+				wait_for_all_generation_.fetch_add(1);
 				mutex_wait_for_all_->unlock();
+				Futex::wake(wait_for_all_generation_);
 				reset_emitters();
 			}
 		}
@@ -243,24 +301,25 @@ SyncPoint::wait(const std::string &component,
                 uint               wait_sec /* = 0 */,
                 uint               wait_nsec /* = 0 */)
 {
+	FAWKES_TRACE_SCOPE("syncpoint.wait", identifier_.c_str());
 	MutexLocker ml(mutex_);
 
 	std::set<std::string>         *watchers      = nullptr;
-	WaitCondition                 *cond          = nullptr;
+	std::atomic<uint32_t>         *generation    = nullptr;
 	CircularBuffer<SyncPointCall> *calls         = nullptr;
 	Mutex                         *mutex_cond    = nullptr;
 	bool                          *timer_running = nullptr;
 	string                        *timer_owner   = nullptr;
-	// set watchers, cond and calls depending of the Wakeup type
+	// set watchers, generation and calls depending of the Wakeup type
 	if (type == WAIT_FOR_ONE) {
 		watchers      = &watchers_wait_for_one_;
-		cond          = cond_wait_for_one_;
+		generation    = &wait_for_one_generation_;
 		mutex_cond    = mutex_wait_for_one_;
 		calls         = &wait_for_one_calls_;
 		timer_running = NULL;
 	} else if (type == WAIT_FOR_ALL) {
 		watchers      = &watchers_wait_for_all_;
-		cond          = cond_wait_for_all_;
+		generation    = &wait_for_all_generation_;
 		mutex_cond    = mutex_wait_for_all_;
 		timer_running = &wait_for_all_timer_running_;
 		timer_owner   = &wait_for_all_timer_owner_;
@@ -299,12 +358,13 @@ SyncPoint::wait(const std::string &component,
 	}
 	mutex_next_wait_->unlock();
 	if (need_to_wait) {
+		// any emit after this point changes the generation, the wait must
+		// not hold any lock to remain a cancellation point
+		uint32_t seen_generation = generation->load();
 		if (type == WAIT_FOR_ONE) {
+			mutex_cond->unlock();
 			ml.unlock();
-			bool timeout;
-			pthread_cleanup_push(cleanup_mutex, mutex_cond);
-			timeout = !cond->reltimed_wait(wait_sec, wait_nsec);
-			pthread_cleanup_pop(1);
+			bool timeout = !wait_for_generation(*generation, seen_generation, wait_sec, wait_nsec);
 			if (timeout) {
 				ml.relock();
 				handle_default(component, type);
@@ -312,10 +372,9 @@ SyncPoint::wait(const std::string &component,
 			}
 		} else {
 			if (*timer_running) {
+				mutex_cond->unlock();
 				ml.unlock();
-				pthread_cleanup_push(cleanup_mutex, mutex_cond);
-				cond->wait();
-				pthread_cleanup_pop(1);
+				wait_for_generation(*generation, seen_generation, 0, 0);
 			} else {
 				*timer_running = true;
 				*timer_owner   = component;
@@ -323,19 +382,19 @@ SyncPoint::wait(const std::string &component,
 					max_waittime_sec_  = wait_sec;
 					max_waittime_nsec_ = wait_nsec;
 				}
+				mutex_cond->unlock();
 				ml.unlock();
-				bool timeout;
-				pthread_cleanup_push(cleanup_mutex, mutex_cond);
-				timeout = !cond->reltimed_wait(max_waittime_sec_, max_waittime_nsec_);
-				pthread_cleanup_pop(1);
+				bool timeout =
+				  !wait_for_generation(*generation, seen_generation, max_waittime_sec_, max_waittime_nsec_);
 				ml.relock();
 				*timer_running = false;
 				if (timeout) {
 					// wait failed, handle default
 					handle_default(component, type);
 					mutex_cond->lock();
-					cond->wake_all();
+					generation->fetch_add(1);
 					mutex_cond->unlock();
+					Futex::wake(*generation);
 				}
 				ml.unlock();
 			}
@@ -345,6 +404,7 @@ SyncPoint::wait(const std::string &component,
 		mutex_cond->unlock();
 	}
 	Time wait_time = Time() - start;
+	wait_time_histogram_.record_usec(std::max(0l, wait_time.in_usec()));
 	ml.relock();
 	calls->push_back(SyncPointCall(component, start, wait_time));
 }
@@ -557,6 +617,28 @@ SyncPoint::get_emit_calls() const
 	return emit_calls_;
 }
 
+/** Get histogram of wait times.
+ * The histogram contains the time spent in all calls to wait() on this
+ * SyncPoint by any component. It can be read concurrently without locking.
+ * @return wait time histogram
+ */
+const LatencyHistogram &
+SyncPoint::get_wait_time_histogram() const
+{
+	return wait_time_histogram_;
+}
+
+/** Get time of most recent emit call.
+ * @return monotonic time of the most recent call to emit() in
+ * microseconds as returned by LatencyHistogram::now_usec(), 0 if the
+ * SyncPoint has never been emitted
+ */
+uint64_t
+SyncPoint::get_last_emit_usec() const
+{
+	return last_emit_usec_.load(std::memory_order_relaxed);
+}
+
 /**
  * Check if the given waiter is currently waiting with the given type
  * @param watcher the string identifier of the watcher to check
@@ -628,9 +710,7 @@ SyncPoint::handle_default(string component, WakeupType type)
 void
 SyncPoint::cleanup()
 {
-	delete cond_wait_for_one_;
 	delete mutex_wait_for_one_;
-	delete cond_wait_for_all_;
 	delete mutex_wait_for_all_;
 	delete mutex_next_wait_;
 	delete mutex_;
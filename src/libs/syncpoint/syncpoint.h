@@ -29,8 +29,10 @@
 #include <interface/interface.h>
 #include <logging/multi.h>
 #include <syncpoint/syncpoint_call.h>
+#include <utils/time/latency_histogram.h>
 #include <utils/time/time.h>
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <string>
@@ -98,6 +100,9 @@ public:
 	CircularBuffer<SyncPointCall> get_emit_calls() const;
 	bool                          watcher_is_waiting(std::string watcher, WakeupType type) const;
 
+	const LatencyHistogram &get_wait_time_histogram() const;
+	uint64_t                get_last_emit_usec() const;
+
 	/**
      * allow Syncpoint Manager to edit
      */
@@ -133,14 +138,14 @@ protected:
 	Mutex *mutex_next_wait_;
 	/** WaitCondition used for lock_until_next_wait */
 	WaitCondition *cond_next_wait_;
-	/** Mutex used for cond_wait_for_one_ */
+	/** Mutex used for wait_for_one_generation_ */
 	Mutex *mutex_wait_for_one_;
-	/** WaitCondition which is used for wait_for_one() */
-	WaitCondition *cond_wait_for_one_;
-	/** Mutex used for cond_wait_for_all_ */
+	/** Futex word incremented to wake up wait_for_one() waiters */
+	std::atomic<uint32_t> wait_for_one_generation_;
+	/** Mutex used for wait_for_all_generation_ */
 	Mutex *mutex_wait_for_all_;
-	/** WaitCondition which is used for wait_for_all() */
-	WaitCondition *cond_wait_for_all_;
+	/** Futex word incremented to wake up wait_for_all() waiters */
+	std::atomic<uint32_t> wait_for_all_generation_;
 	/** true if the wait for all timer is running */
 	bool wait_for_all_timer_running_;
 	/** the component that started the wait-for-all timer */
@@ -153,6 +158,11 @@ protected:
 	/** Logger */
 	MultiLogger *logger_;
 
+	/** Histogram of the time spent in wait() by all components */
+	LatencyHistogram wait_time_histogram_;
+	/** Monotonic time of the most recent emit call, see LatencyHistogram::now_usec() */
+	std::atomic<uint64_t> last_emit_usec_;
+
 private:
 	void reset_emitters();
 	bool is_pending(std::string component);
@@ -43,7 +43,8 @@ namespace fawkes {
 /** Constructor.
  *  @param logger the logger to use for logging messages
  */
-SyncPointManager::SyncPointManager(MultiLogger *logger) : mutex_(new Mutex()), logger_(logger)
+SyncPointManager::SyncPointManager(MultiLogger *logger)
+: mutex_(new Mutex()), loop_deadline_usec_(0), logger_(logger)
 {
 }
 
@@ -89,6 +90,62 @@ SyncPointManager::release_syncpoint(const std::string &component, RefPtr<SyncPoi
 	release_syncpoint_no_lock(component, sync_point);
 }
 
+/** Set loop deadline.
+ * The deadline is used by components which record loop statistics to
+ * count deadline misses, e.g. threads with the BlockedTimingAspect. It is
+ * usually set by the main thread to the maximum thread time. Changes only
+ * apply to statistics created afterwards.
+ * @param deadline_usec maximum loop duration in microseconds, 0 to disable
+ */
+void
+SyncPointManager::set_loop_deadline(uint64_t deadline_usec)
+{
+	MutexLocker ml(mutex_);
+	loop_deadline_usec_ = deadline_usec;
+}
+
+/** Get loop deadline.
+ * @return maximum loop duration in microseconds, 0 if disabled
+ */
+uint64_t
+SyncPointManager::get_loop_deadline() const
+{
+	MutexLocker ml(mutex_);
+	return loop_deadline_usec_;
+}
+
+/** Add loop statistics.
+ * Makes the statistics available through get_loop_statistics(), e.g. to
+ * export them as metrics.
+ * @param stats loop statistics to add
+ */
+void
+SyncPointManager::add_loop_statistics(std::shared_ptr<SyncPointLoopStatistics> stats)
+{
+	MutexLocker ml(mutex_);
+	loop_statistics_.push_back(stats);
+}
+
+/** Remove loop statistics.
+ * @param stats loop statistics to remove
+ */
+void
+SyncPointManager::remove_loop_statistics(std::shared_ptr<SyncPointLoopStatistics> stats)
+{
+	MutexLocker ml(mutex_);
+	loop_statistics_.remove(stats);
+}
+
+/** Get loop statistics.
+ * @return loop statistics of all instrumented components
+ */
+std::list<std::shared_ptr<SyncPointLoopStatistics>>
+SyncPointManager::get_loop_statistics()
+{
+	MutexLocker ml(mutex_);
+	return loop_statistics_;
+}
+
 /** @class SyncPointSetLessThan "syncpoint_manager.h"
  * Compare sets of syncpoints
  */
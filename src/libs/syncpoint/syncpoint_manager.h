@@ -25,8 +25,11 @@
 #include <core/threading/mutex.h>
 #include <core/utils/refptr.h>
 #include <logging/multi.h>
+#include <syncpoint/loop_statistics.h>
 #include <syncpoint/syncpoint.h>
 
+#include <list>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -45,11 +48,22 @@ public:
 
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> get_syncpoints();
 
+	void     set_loop_deadline(uint64_t deadline_usec);
+	uint64_t get_loop_deadline() const;
+
+	void add_loop_statistics(std::shared_ptr<SyncPointLoopStatistics> stats);
+	void remove_loop_statistics(std::shared_ptr<SyncPointLoopStatistics> stats);
+	std::list<std::shared_ptr<SyncPointLoopStatistics>> get_loop_statistics();
+
 protected:
 	/** Set of all existing SyncPoints */
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> syncpoints_;
 	/** Mutex used for all SyncPointManager calls */
 	Mutex *mutex_;
+	/** Loop statistics of all instrumented components */
+	std::list<std::shared_ptr<SyncPointLoopStatistics>> loop_statistics_;
+	/** Default deadline for loops of instrumented components in usec */
+	uint64_t loop_deadline_usec_;
 
 private:
 	std::string       find_prefix(const std::string &identifier) const;
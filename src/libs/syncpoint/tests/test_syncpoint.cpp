@@ -31,11 +31,13 @@
 #include <core/threading/wait_condition.h>
 #include <core/utils/refptr.h>
 #include <libs/syncpoint/exceptions.h>
+#include <libs/syncpoint/loop_statistics.h>
 #include <libs/syncpoint/syncpoint.h>
 #include <libs/syncpoint/syncpoint_manager.h>
 #include <logging/cache.h>
 #include <logging/multi.h>
 #include <sys/time.h>
+#include <utils/time/latency_histogram.h>
 
 #include <atomic>
 #include <cmath>
@@ -1371,3 +1373,60 @@ TEST_F(SyncPointManagerTest, ReleaseBarrierWaiter)
 	sp = manager->get_syncpoint("component 1", "/test");
 	EXPECT_NO_THROW(sp->reltime_wait_for_all("component 1", 0, pow(10, 6)));
 }
+
+TEST_F(SyncPointManagerTest, WaitTimeHistogram)
+{
+	RefPtr<SyncPoint> sp = manager->get_syncpoint("component", "/test");
+	EXPECT_EQ(0u, sp->get_wait_time_histogram().count());
+	EXPECT_EQ(0u, sp->get_last_emit_usec());
+	sp->reltime_wait_for_one("component", 0, 1000000);
+	EXPECT_EQ(1u, sp->get_wait_time_histogram().count());
+	EXPECT_GE(sp->get_wait_time_histogram().max_usec(), 900u);
+	sp->register_emitter("component");
+	sp->emit("component");
+	EXPECT_LE(sp->get_last_emit_usec(), LatencyHistogram::now_usec());
+	EXPECT_GT(sp->get_last_emit_usec(), 0u);
+}
+
+TEST_F(SyncPointManagerTest, LoopStatistics)
+{
+	std::shared_ptr<SyncPointLoopStatistics> stats =
+	  std::make_shared<SyncPointLoopStatistics>("component", "/test", 1000);
+	manager->add_loop_statistics(stats);
+	ASSERT_EQ(1u, manager->get_loop_statistics().size());
+
+	uint64_t wait_start = LatencyHistogram::now_usec();
+	stats->loop_started(wait_start, wait_start);
+	stats->loop_finished();
+	stats->loop_started(LatencyHistogram::now_usec(), wait_start);
+	usleep(2000);
+	stats->loop_finished();
+	EXPECT_EQ(2u, stats->wait_time().count());
+	EXPECT_EQ(1u, stats->wakeup_latency().count());
+	EXPECT_EQ(2u, stats->loop_duration().count());
+	EXPECT_EQ(1u, stats->num_deadline_misses());
+	EXPECT_GE(stats->loop_duration().percentile(1.0), 0.002);
+
+	manager->remove_loop_statistics(stats);
+	EXPECT_TRUE(manager->get_loop_statistics().empty());
+}
+
+TEST(LatencyHistogramTest, Buckets)
+{
+	LatencyHistogram h;
+	for (unsigned int i = 0; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+		h.record_usec(LatencyHistogram::bucket_upper_bound_usec(i));
+		ASSERT_EQ(1u, h.bucket_count(i));
+	}
+	h.reset();
+	for (uint64_t v = 1; v <= 1000; ++v) {
+		h.record_usec(v * 10);
+	}
+	EXPECT_EQ(1000u, h.count());
+	EXPECT_EQ(10000u, h.max_usec());
+	EXPECT_DOUBLE_EQ(5.005, h.sum());
+	EXPECT_EQ(1000u, h.cumulative_count(INFINITY));
+	EXPECT_EQ(0u, h.cumulative_count(0.000001));
+	// relative error of the percentile is bounded by the sub-bucket width
+	EXPECT_NEAR(0.005, h.percentile(0.5), 0.005 / LatencyHistogram::SUB_BUCKETS);
+}
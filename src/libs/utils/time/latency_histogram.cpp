@@ -0,0 +1,220 @@
+
+/***************************************************************************
+ *  latency_histogram.cpp - Lock-free log-bucketed latency histogram
+ *
+ *  Created: Sun Oct 18 22:41:07 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <utils/time/latency_histogram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+namespace fawkes {
+
+/** @class LatencyHistogram <utils/time/latency_histogram.h>
+ * Lock-free histogram of latencies with logarithmic buckets.
+ * The histogram records durations with microsecond resolution. Buckets are
+ * arranged in the style of a HDR histogram: each power of two is split
+ * into SUB_BUCKETS linear buckets, which gives a relative error of at most
+ * 1/SUB_BUCKETS over the whole range from 1 usec to about 71 minutes. Larger
+ * values are counted in the last bucket.
+ *
+ * Recording a value is a handful of relaxed atomic operations and never
+ * blocks or allocates, so it is suitable to be called in every loop of
+ * every thread. Readers may see a slightly inconsistent view while values
+ * are recorded concurrently, e.g. a count which is one off from the sum of
+ * all buckets, which is acceptable for monitoring.
+ * @author Tim Niemueller
+ */
+
+/** Constructor. */
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+/** Reset histogram.
+ * Note that concurrent calls to record_usec() may be lost.
+ */
+void
+LatencyHistogram::reset()
+{
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		buckets_[i].store(0, std::memory_order_relaxed);
+	}
+	count_.store(0, std::memory_order_relaxed);
+	sum_usec_.store(0, std::memory_order_relaxed);
+	max_usec_.store(0, std::memory_order_relaxed);
+}
+
+unsigned int
+LatencyHistogram::bucket_index(uint64_t usec)
+{
+	if (usec < SUB_BUCKETS)
+		return usec;
+	if (usec >= (1ull << MAX_EXPONENT))
+		return NUM_BUCKETS - 1;
+
+	unsigned int msb   = 63 - __builtin_clzll(usec);
+	unsigned int shift = msb - SUB_BUCKET_BITS;
+	unsigned int sub   = (usec >> shift) - SUB_BUCKETS;
+	return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+/** Get upper bound of a bucket.
+ * @param bucket bucket index, must be smaller than NUM_BUCKETS
+ * @return largest value in microseconds counted in the given bucket
+ */
+uint64_t
+LatencyHistogram::bucket_upper_bound_usec(unsigned int bucket)
+{
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+	unsigned int shift = bucket / SUB_BUCKETS - 1;
+	unsigned int sub   = bucket % SUB_BUCKETS;
+	return ((uint64_t)(SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+/** Record a value.
+ * @param usec duration in microseconds
+ */
+void
+LatencyHistogram::record_usec(uint64_t usec)
+{
+	buckets_[bucket_index(usec)].fetch_add(1, std::memory_order_relaxed);
+	count_.fetch_add(1, std::memory_order_relaxed);
+	sum_usec_.fetch_add(usec, std::memory_order_relaxed);
+
+	uint64_t max = max_usec_.load(std::memory_order_relaxed);
+	while (usec > max
+	       && !max_usec_.compare_exchange_weak(max, usec, std::memory_order_relaxed)) {
+	}
+}
+
+/** Record a value.
+ * @param sec duration in seconds, negative values are recorded as zero
+ */
+void
+LatencyHistogram::record(double sec)
+{
+	record_usec(sec > 0. ? (uint64_t)std::llround(sec * 1000000.) : 0);
+}
+
+/** Get number of recorded values.
+ * @return number of recorded values
+ */
+uint64_t
+LatencyHistogram::count() const
+{
+	return count_.load(std::memory_order_relaxed);
+}
+
+/** Get largest recorded value.
+ * @return largest recorded value in microseconds
+ */
+uint64_t
+LatencyHistogram::max_usec() const
+{
+	return max_usec_.load(std::memory_order_relaxed);
+}
+
+/** Get sum of all recorded values.
+ * @return sum of all recorded values in seconds
+ */
+double
+LatencyHistogram::sum() const
+{
+	return sum_usec_.load(std::memory_order_relaxed) / 1000000.;
+}
+
+/** Get number of values in a bucket.
+ * @param bucket bucket index, must be smaller than NUM_BUCKETS
+ * @return number of values recorded in the bucket
+ */
+uint64_t
+LatencyHistogram::bucket_count(unsigned int bucket) const
+{
+	return buckets_[bucket].load(std::memory_order_relaxed);
+}
+
+/** Get number of values smaller or equal to a bound.
+ * This is meant to export the histogram with coarser, e.g. configured,
+ * buckets. The count is exact if the bound coincides with the upper bound
+ * of one of the histogram's buckets, otherwise values in the bucket which
+ * contains the bound are not counted.
+ * @param upper_bound_sec upper bound in seconds
+ * @return number of recorded values smaller or equal to the bound
+ */
+uint64_t
+LatencyHistogram::cumulative_count(double upper_bound_sec) const
+{
+	if (upper_bound_sec < 0.)
+		return 0;
+	if (!std::isfinite(upper_bound_sec))
+		return count();
+
+	uint64_t bound = (uint64_t)std::floor(upper_bound_sec * 1000000.);
+	uint64_t rv    = 0;
+	for (unsigned int i = 0; i < NUM_BUCKETS && bucket_upper_bound_usec(i) <= bound; ++i) {
+		rv += buckets_[i].load(std::memory_order_relaxed);
+	}
+	return rv;
+}
+
+/** Get percentile.
+ * @param p percentile in the range [0, 1], e.g. 0.99
+ * @return upper bound in seconds of the bucket the given percentile falls
+ * into, but at most the largest recorded value, 0 if no values have been
+ * recorded
+ */
+double
+LatencyHistogram::percentile(double p) const
+{
+	uint64_t total = count();
+	if (total == 0)
+		return 0.;
+
+	uint64_t rank = (uint64_t)std::ceil(std::min(std::max(p, 0.), 1.) * total);
+	uint64_t seen = 0;
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		seen += buckets_[i].load(std::memory_order_relaxed);
+		if (seen >= rank && seen > 0) {
+			return std::min(bucket_upper_bound_usec(i), max_usec()) / 1000000.;
+		}
+	}
+	return max_usec() / 1000000.;
+}
+
+/** Get current monotonic time.
+ * Use this to take the timestamps to compute durations which are recorded.
+ * It is neither affected by changes of the system time nor by simulated
+ * time sources.
+ * @return current monotonic time in microseconds
+ */
+uint64_t
+LatencyHistogram::now_usec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+} // end namespace fawkes
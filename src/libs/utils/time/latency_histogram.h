@@ -0,0 +1,73 @@
+
+/***************************************************************************
+ *  latency_histogram.h - Lock-free log-bucketed latency histogram
+ *
+ *  Created: Sun Oct 18 22:41:07 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TIME_LATENCY_HISTOGRAM_H_
+#define _UTILS_TIME_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace fawkes {
+
+class LatencyHistogram
+{
+public:
+	/** Number of linear sub-buckets per power of two, as number of bits. */
+	static const unsigned int SUB_BUCKET_BITS = 3;
+	/** Number of linear sub-buckets per power of two. */
+	static const unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	/** Largest power of two which is resolved, larger values are clamped. */
+	static const unsigned int MAX_EXPONENT = 32;
+	/** Total number of buckets. */
+	static const unsigned int NUM_BUCKETS = SUB_BUCKETS * (MAX_EXPONENT - SUB_BUCKET_BITS + 1);
+
+	LatencyHistogram();
+
+	void record_usec(uint64_t usec);
+	void record(double sec);
+	void reset();
+
+	uint64_t count() const;
+	uint64_t max_usec() const;
+	double   sum() const;
+	uint64_t cumulative_count(double upper_bound_sec) const;
+	double   percentile(double p) const;
+
+	uint64_t bucket_count(unsigned int bucket) const;
+
+	static uint64_t bucket_upper_bound_usec(unsigned int bucket);
+	static uint64_t now_usec();
+
+private:
+	static unsigned int bucket_index(uint64_t usec);
+
+private:
+	std::atomic<uint64_t> buckets_[NUM_BUCKETS];
+	std::atomic<uint64_t> count_;
+	std::atomic<uint64_t> sum_usec_;
+	std::atomic<uint64_t> max_usec_;
+};
+
+} // end namespace fawkes
+
+#endif
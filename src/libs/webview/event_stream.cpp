@@ -0,0 +1,549 @@
+
+/***************************************************************************
+ *  event_stream.cpp - Server-sent event stream
+ *
+ *  Created: Sun Oct 18 19:12:05 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "microhttpd_compat.h"
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <webview/event_stream.h>
+#include <webview/request.h>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+namespace {
+
+// Interval after which a comment is sent on idle streams. This keeps
+// proxies from closing the connection and detects disconnected clients.
+const double KEEPALIVE_INTERVAL_SEC = 15.;
+
+double
+now_sec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.;
+}
+
+void
+append_event(std::string &out, const std::string &event, const std::string &data)
+{
+	out += "event: ";
+	out += event;
+	out += '\n';
+	std::string::size_type start = 0;
+	while (start <= data.size()) {
+		std::string::size_type end = data.find('\n', start);
+		if (end == std::string::npos)
+			end = data.size();
+		out += "data: ";
+		out.append(data, start, end - start);
+		out += '\n';
+		start = end + 1;
+	}
+	out += '\n';
+}
+
+} // namespace
+/// @endcond
+
+/// @cond INTERNALS
+// Resumes suspended streams once their rate limit allows sending pending
+// events or a keep-alive is due. A single timer serves all streams,
+// therefore no thread is blocked per connected client.
+class WebviewEventStreamTimer : public Thread
+{
+public:
+	WebviewEventStreamTimer()
+	: Thread("WebviewEventStreamTimer", Thread::OPMODE_CONTINUOUS),
+	  wakeup_cond_(&wakeup_mutex_),
+	  wakeup_(false)
+	{
+	}
+
+	static WebviewEventStreamTimer &
+	instance()
+	{
+		// intentionally leaked, streams may be closed late during shutdown
+		static WebviewEventStreamTimer *timer = []() {
+			WebviewEventStreamTimer *t = new WebviewEventStreamTimer();
+			t->start();
+			return t;
+		}();
+		return *timer;
+	}
+
+	void
+	add(std::shared_ptr<WebviewEventStream> stream)
+	{
+		MutexLocker lock(&streams_mutex_);
+		streams_.push_back(stream);
+	}
+
+	std::list<std::shared_ptr<WebviewEventStream>>
+	streams()
+	{
+		std::list<std::shared_ptr<WebviewEventStream>> rv;
+		MutexLocker                                    lock(&streams_mutex_);
+		for (auto s = streams_.begin(); s != streams_.end();) {
+			if (std::shared_ptr<WebviewEventStream> stream = s->lock()) {
+				rv.push_back(stream);
+				++s;
+			} else {
+				s = streams_.erase(s);
+			}
+		}
+		return rv;
+	}
+
+	void
+	wakeup()
+	{
+		MutexLocker lock(&wakeup_mutex_);
+		wakeup_ = true;
+		wakeup_cond_.wake_all();
+	}
+
+	virtual void
+	loop()
+	{
+		double now  = now_sec();
+		double next = now + KEEPALIVE_INTERVAL_SEC;
+		for (auto &s : streams()) {
+			next = std::min(next, s->timer_tick(now));
+		}
+
+		MutexLocker lock(&wakeup_mutex_);
+		if (!wakeup_) {
+			double wait = next - now_sec();
+			if (wait > 0.) {
+				long sec  = (long)wait;
+				long nsec = (long)((wait - sec) * 1000000000.);
+				wakeup_cond_.reltimed_wait(sec, nsec);
+			}
+		}
+		wakeup_ = false;
+	}
+
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	Mutex                                        streams_mutex_;
+	std::list<std::weak_ptr<WebviewEventStream>> streams_;
+
+	Mutex         wakeup_mutex_;
+	WaitCondition wakeup_cond_;
+	bool          wakeup_;
+};
+/// @endcond
+
+/** @class WebviewEventStream <webview/event_stream.h>
+ * Server-sent event stream.
+ * Producers publish named events to the stream, which are sent to the
+ * client as server-sent events (text/event-stream) by a
+ * WebviewEventStreamReply. Events are coalesced per name and key, i.e.,
+ * if an event is published again before it was sent, only the latest
+ * data is sent. The rate at which events are sent is limited to the maximum
+ * rate given on creation.
+ *
+ * Event data can be passed as a generator, which is only called when the
+ * event is actually sent. This way, producers can signal changes cheaply
+ * and defer the conversion of data, which is done at most once per send
+ * interval.
+ *
+ * While there is nothing to send, the connection is suspended, so that
+ * no web server thread is busy for the idle stream. It is resumed on
+ * publishing or by a shared timer if sending is delayed by the rate limit
+ * or a keep-alive comment is due. The server must have been started
+ * with support for suspending connections, which WebServer does.
+ *
+ * Producers register a close callback to release their resources once
+ * the client disconnected. Streams can only be created as shared pointer
+ * with create().
+ * @author Tim Niemueller
+ */
+
+/** Create a new stream.
+ * @param max_rate maximum rate in Hz at which events are sent, zero or
+ * less to send events as soon as they are published
+ * @return new stream
+ */
+std::shared_ptr<WebviewEventStream>
+WebviewEventStream::create(float max_rate)
+{
+	std::shared_ptr<WebviewEventStream> stream(new WebviewEventStream(max_rate));
+	WebviewEventStreamTimer::instance().add(stream);
+	return stream;
+}
+
+/** Constructor.
+ * @param max_rate maximum rate in Hz at which events are sent
+ */
+WebviewEventStream::WebviewEventStream(float max_rate)
+: mutex_(new Mutex()),
+  min_interval_(max_rate > 0.f ? 1. / max_rate : 0.),
+  next_send_(0.),
+  last_write_(now_sec()),
+  connection_(NULL),
+  daemon_(NULL),
+  suspended_(false),
+  keepalive_(false),
+  closed_(false),
+  out_pos_(0)
+{
+}
+
+/** Destructor. */
+WebviewEventStream::~WebviewEventStream()
+{
+	delete mutex_;
+}
+
+/** Publish event.
+ * @param event name of the event
+ * @param data data of the event, may span multiple lines
+ * @param key coalescing key, events of the same name and key which have
+ * not been sent, yet, are replaced
+ */
+void
+WebviewEventStream::publish(const std::string &event,
+                            const std::string &data,
+                            const std::string &key)
+{
+	publish(
+	  event, [data]() { return data; }, key);
+}
+
+/** Publish event with lazily generated data.
+ * This replaces any event of the same name and key which has not been
+ * sent, yet.
+ * @param event name of the event
+ * @param generator generator called to get the data of the event when
+ * it is sent
+ * @param key coalescing key, e.g., to keep the latest event per
+ * interface if events of the same name are sent for several interfaces
+ */
+void
+WebviewEventStream::publish(const std::string &event,
+                            DataGenerator      generator,
+                            const std::string &key)
+{
+	std::string pending_key = event + '\n' + key;
+	bool        wake_timer  = false;
+	{
+		MutexLocker lock(mutex_);
+		if (closed_)
+			return;
+
+		auto p = pending_.find(pending_key);
+		if (p == pending_.end()) {
+			pending_order_.push_back(pending_key);
+			pending_[pending_key] = std::make_pair(event, std::move(generator));
+		} else {
+			p->second.second = std::move(generator);
+		}
+
+		if (suspended_) {
+			if (now_sec() >= next_send_) {
+				resume();
+			} else {
+				wake_timer = true;
+			}
+		}
+	}
+	if (wake_timer) {
+		WebviewEventStreamTimer::instance().wakeup();
+	}
+}
+
+/** Add close callback.
+ * The callback is called once the stream is closed, either explicitly or
+ * because the client disconnected. It is called immediately if the
+ * stream has already been closed.
+ * @param callback callback to add
+ */
+void
+WebviewEventStream::add_close_callback(CloseCallback callback)
+{
+	{
+		MutexLocker lock(mutex_);
+		if (!closed_) {
+			close_callbacks_.push_back(std::move(callback));
+			return;
+		}
+	}
+	callback();
+}
+
+/** Close stream.
+ * Pending events are dropped and the transfer is ended. Close callbacks
+ * have been called when the method returns.
+ */
+void
+WebviewEventStream::close()
+{
+	std::list<CloseCallback> callbacks;
+	{
+		MutexLocker lock(mutex_);
+		closed_locked(callbacks);
+		if (suspended_) {
+			resume();
+		}
+	}
+	for (auto &c : callbacks) {
+		c();
+	}
+}
+
+/** Check if stream is closed.
+ * @return true if the stream has been closed or the client disconnected
+ */
+bool
+WebviewEventStream::closed() const
+{
+	MutexLocker lock(mutex_);
+	return closed_;
+}
+
+/** Close all streams sent by a server.
+ * Must be called before stopping a web server, as suspended connections
+ * must be resumed before the server can be stopped. Streams of other
+ * servers are not affected. Streams which have not started sending, yet,
+ * cannot be suspended and are closed once their reply is deleted.
+ * @param daemon daemon of the server whose streams to close
+ */
+void
+WebviewEventStream::close_all(MHD_Daemon *daemon)
+{
+	for (auto &s : WebviewEventStreamTimer::instance().streams()) {
+		bool served;
+		{
+			MutexLocker lock(s->mutex_);
+			served = (daemon != NULL) && (s->daemon_ == daemon);
+		}
+		if (served) {
+			s->close();
+		}
+	}
+}
+
+void
+WebviewEventStream::closed_locked(std::list<CloseCallback> &callbacks)
+{
+	if (closed_)
+		return;
+	closed_ = true;
+	pending_order_.clear();
+	pending_.clear();
+	callbacks.swap(close_callbacks_);
+}
+
+void
+WebviewEventStream::resume()
+{
+	suspended_ = false;
+	if (connection_) {
+		MHD_resume_connection(connection_);
+	}
+}
+
+void
+WebviewEventStream::detach()
+{
+	std::list<CloseCallback> callbacks;
+	{
+		MutexLocker lock(mutex_);
+		connection_ = NULL;
+		daemon_     = NULL;
+		suspended_  = false;
+		closed_locked(callbacks);
+	}
+	for (auto &c : callbacks) {
+		c();
+	}
+}
+
+double
+WebviewEventStream::timer_tick(double now)
+{
+	MutexLocker lock(mutex_);
+	if (closed_ || !suspended_) {
+		return now + KEEPALIVE_INTERVAL_SEC;
+	}
+
+	if (!pending_order_.empty() && now >= next_send_) {
+		resume();
+		return now + KEEPALIVE_INTERVAL_SEC;
+	}
+	if (now - last_write_ >= KEEPALIVE_INTERVAL_SEC) {
+		keepalive_ = true;
+		resume();
+		return now + KEEPALIVE_INTERVAL_SEC;
+	}
+
+	double next = last_write_ + KEEPALIVE_INTERVAL_SEC;
+	if (!pending_order_.empty()) {
+		next = std::min(next, next_send_);
+	}
+	return next;
+}
+
+size_t
+WebviewEventStream::next_chunk(MHD_Connection *connection, char *buffer, size_t buf_max_size)
+{
+	MutexLocker lock(mutex_);
+	if (connection_ != connection) {
+		connection_ = connection;
+		const MHD_ConnectionInfo *info =
+		  MHD_get_connection_info(connection, MHD_CONNECTION_INFO_DAEMON);
+		daemon_ = info ? info->daemon : NULL;
+	}
+
+	if (out_pos_ >= out_.size()) {
+		out_.clear();
+		out_pos_ = 0;
+		if (closed_) {
+			return (size_t)-1;
+		}
+
+		double now = now_sec();
+		if (!pending_order_.empty() && now >= next_send_) {
+			std::list<std::pair<std::string, DataGenerator>> events;
+			for (const std::string &k : pending_order_) {
+				events.push_back(std::move(pending_[k]));
+			}
+			pending_order_.clear();
+			pending_.clear();
+			next_send_ = now + min_interval_;
+
+			// generators may take a while, e.g., to read and convert data
+			lock.unlock();
+			std::string data;
+			for (auto &e : events) {
+				try {
+					std::string d = e.second();
+					if (!d.empty()) {
+						append_event(data, e.first, d);
+					}
+				} catch (...) {
+					// skip event, the stream must not be broken by a producer
+				}
+			}
+			lock.relock();
+			out_ = std::move(data);
+		}
+
+		if (out_.empty() && keepalive_) {
+			out_ = ":\n\n";
+		}
+		keepalive_ = false;
+
+		if (out_.empty()) {
+			if (closed_) {
+				return (size_t)-1;
+			}
+			// Suspending from the content reader callback is explicitly allowed
+			// by libmicrohttpd. Returning zero is then required, with internal
+			// polling threads zero without suspending would be an error or busy
+			// waiting. A concurrent resume() is safe, the connection is resumed
+			// after this callback returns.
+			suspended_ = true;
+			MHD_suspend_connection(connection);
+			bool wake_timer = !pending_order_.empty();
+			lock.unlock();
+			if (wake_timer) {
+				WebviewEventStreamTimer::instance().wakeup();
+			}
+			return 0;
+		}
+	}
+
+	size_t bytes = std::min(buf_max_size, out_.size() - out_pos_);
+	memcpy(buffer, out_.data() + out_pos_, bytes);
+	out_pos_ += bytes;
+	last_write_ = now_sec();
+	return bytes;
+}
+
+/** @class WebviewEventStreamReply <webview/event_stream.h>
+ * Reply sending a server-sent event stream.
+ * The reply is sent until the stream is closed or the client
+ * disconnects, in which case the stream is closed.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param stream stream to send
+ */
+WebviewEventStreamReply::WebviewEventStreamReply(std::shared_ptr<WebviewEventStream> stream)
+: DynamicWebReply(WebReply::HTTP_OK), stream_(stream)
+{
+	add_header("Content-Type", "text/event-stream");
+	// disable response buffering in nginx when used as reverse proxy
+	add_header("X-Accel-Buffering", "no");
+	set_caching(false);
+}
+
+/** Destructor.
+ * The reply is deleted when the connection has been closed, therefore
+ * the stream is closed.
+ */
+WebviewEventStreamReply::~WebviewEventStreamReply()
+{
+	stream_->detach();
+}
+
+size_t
+WebviewEventStreamReply::size()
+{
+	return (size_t)-1;
+}
+
+size_t
+WebviewEventStreamReply::chunk_size()
+{
+	return 4 * 1024;
+}
+
+size_t
+WebviewEventStreamReply::next_chunk(size_t pos, char *buffer, size_t buf_max_size)
+{
+	WebRequest *request = get_request();
+	if (!request || !request->connection()) {
+		return (size_t)-1;
+	}
+	return stream_->next_chunk(request->connection(), buffer, buf_max_size);
+}
+
+} // end namespace fawkes
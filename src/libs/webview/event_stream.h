@@ -0,0 +1,121 @@
+
+/***************************************************************************
+ *  event_stream.h - Server-sent event stream
+ *
+ *  Created: Sun Oct 18 19:12:05 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _LIBS_WEBVIEW_EVENT_STREAM_H_
+#define _LIBS_WEBVIEW_EVENT_STREAM_H_
+
+#include <webview/reply.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+struct MHD_Connection;
+struct MHD_Daemon;
+
+namespace fawkes {
+
+class Mutex;
+
+class WebviewEventStream : public std::enable_shared_from_this<WebviewEventStream>
+{
+public:
+	/** Generator of event data.
+	 * Called when the event is actually sent, outside of any lock of the
+	 * stream. Return an empty string to skip the event. */
+	typedef std::function<std::string()> DataGenerator;
+
+	/** Callback called once when the stream is closed. */
+	typedef std::function<void()> CloseCallback;
+
+	static std::shared_ptr<WebviewEventStream> create(float max_rate = 0.f);
+	~WebviewEventStream();
+
+	void publish(const std::string &event, const std::string &data, const std::string &key = "");
+	void publish(const std::string &event, DataGenerator generator, const std::string &key = "");
+
+	void add_close_callback(CloseCallback callback);
+	void close();
+	bool closed() const;
+
+	static void close_all(MHD_Daemon *daemon);
+
+private:
+	friend class WebviewEventStreamReply;
+	friend class WebviewEventStreamTimer;
+
+	WebviewEventStream(float max_rate);
+
+	size_t next_chunk(MHD_Connection *connection, char *buffer, size_t buf_max_size);
+	void   detach();
+	double timer_tick(double now);
+	void   resume();
+	void   closed_locked(std::list<CloseCallback> &callbacks);
+
+private:
+	Mutex *mutex_;
+
+	double min_interval_;
+	double next_send_;
+	double last_write_;
+
+	MHD_Connection *connection_;
+	MHD_Daemon     *daemon_;
+	bool            suspended_;
+	bool            keepalive_;
+	bool            closed_;
+
+	std::list<std::string>                                         pending_order_;
+	std::map<std::string, std::pair<std::string, DataGenerator>> pending_;
+	std::list<CloseCallback>                                       close_callbacks_;
+
+	std::string out_;
+	size_t      out_pos_;
+};
+
+class WebviewEventStreamReply : public DynamicWebReply
+{
+public:
+	WebviewEventStreamReply(std::shared_ptr<WebviewEventStream> stream);
+	virtual ~WebviewEventStreamReply();
+
+	virtual size_t size();
+	virtual size_t chunk_size();
+	virtual size_t next_chunk(size_t pos, char *buffer, size_t buf_max_size);
+
+	/** Get event stream.
+	 * @return event stream sent with this reply */
+	std::shared_ptr<WebviewEventStream>
+	stream() const
+	{
+		return stream_;
+	}
+
+private:
+	std::shared_ptr<WebviewEventStream> stream_;
+};
+
+} // end namespace fawkes
+
+#endif
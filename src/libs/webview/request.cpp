@@ -76,7 +76,8 @@ header_iterator(void *cls, enum MHD_ValueKind kind, const char *key, const char
 /** Constructor.
  * @param uri URI of the request
  */
-WebRequest::WebRequest(const char *uri) : pp_(NULL), is_setup_(false), uri_(uri)
+WebRequest::WebRequest(const char *uri)
+: pp_(NULL), connection_(NULL), is_setup_(false), uri_(uri)
 {
 	reply_size_ = 0;
 }
@@ -93,7 +94,8 @@ WebRequest::setup(const char     *url,
                   const char     *version,
                   MHD_Connection *connection)
 {
-	url_ = url;
+	url_        = url;
+	connection_ = connection;
 
 	if (0 == strcmp(method, MHD_HTTP_METHOD_GET)) {
 		method_ = METHOD_GET;
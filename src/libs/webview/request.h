@@ -332,6 +332,16 @@ public:
 	WebReply::Code reply_code() const;
 	void           set_reply_code(WebReply::Code code);
 
+	/** Get libmicrohttpd connection.
+	 * The connection is only valid while the request is being processed,
+	 * in particular during calls to DynamicWebReply::next_chunk().
+	 * @return connection the request was received on */
+	MHD_Connection *
+	connection() const
+	{
+		return connection_;
+	}
+
 protected:
 	/** Set cookie map.
    * @param cookies cookies map
@@ -355,6 +365,7 @@ private:
 
 private:
 	MHD_PostProcessor *pp_;
+	MHD_Connection    *connection_;
 	bool               is_setup_;
 
 	std::string                        uri_;
@@ -69,6 +69,7 @@ WebviewRestApi::process_request(const WebRequest *request, const std::string &re
 		WebviewRestParams params;
 		params.set_path_args(std::move(path_args));
 		params.set_query_args(request->get_values());
+		params.set_headers(request->headers());
 		std::unique_ptr<WebReply> reply = handler(request->body(), params);
 		return reply.release();
 	} catch (NullPointerException &e) {
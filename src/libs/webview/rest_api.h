@@ -28,6 +28,8 @@
 #include <webview/reply.h>
 #include <webview/request.h>
 
+#include <strings.h>
+
 #include <algorithm>
 #include <functional>
 #include <map>
@@ -176,6 +178,22 @@ public:
 		return (query_args_.find(what) != query_args_.end());
 	}
 
+	/** Get a request header.
+	 * Header names are compared case-insensitively.
+	 * @param what name of the header to retrieve, e.g., "If-None-Match"
+	 * @return value of the header or empty string if not set
+	 */
+	std::string
+	header(const std::string &what) const
+	{
+		for (const auto &h : headers_) {
+			if (strcasecmp(h.first.c_str(), what.c_str()) == 0) {
+				return h.second;
+			}
+		}
+		return "";
+	}
+
 	/** Is pretty-printed JSON enabled?
 	 * @return true true to request enabling pretty mode
 	 */
@@ -209,10 +227,17 @@ private:
 		query_args_ = args;
 	}
 
+	void
+	set_headers(const std::map<std::string, std::string> &headers)
+	{
+		headers_ = headers;
+	}
+
 private:
 	bool                               pretty_json_;
 	std::map<std::string, std::string> path_args_;
 	std::map<std::string, std::string> query_args_;
+	std::map<std::string, std::string> headers_;
 };
 
 class Logger;
@@ -27,6 +27,7 @@
 #include <logging/logger.h>
 #include <sys/socket.h>
 #include <webview/access_log.h>
+#include <webview/event_stream.h>
 #include <webview/request.h>
 #include <webview/request_dispatcher.h>
 #include <webview/request_manager.h>
@@ -154,6 +155,13 @@ WebServer::start()
 		flags |= MHD_USE_SSL;
 	}
 
+	// required to suspend idle event streams, cf. WebviewEventStream
+#if MHD_VERSION >= 0x00095500
+	flags |= MHD_ALLOW_SUSPEND_RESUME;
+#elif MHD_VERSION >= 0x00093500
+	flags |= MHD_USE_SUSPEND_RESUME;
+#endif
+
 	dispatcher_->setup_cors(cors_allow_all_, std::move(cors_origins_), cors_max_age_);
 
 	if (num_threads_ > 1) {
@@ -210,6 +218,8 @@ WebServer::~WebServer()
 		request_manager_->set_server(NULL);
 	}
 
+	// suspended connections must be resumed before stopping the daemon
+	WebviewEventStream::close_all(daemon_);
 	MHD_stop_daemon(daemon_);
 	daemon_     = NULL;
 	dispatcher_ = NULL;
@@ -0,0 +1,260 @@
+/***************************************************************************
+ *  test_event_stream.cpp - Server-sent event stream unit test
+ *
+ *  Created: Sun Oct 18 18:44:09 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <webview/event_stream.h>
+#include <webview/request.h>
+#include <webview/request_dispatcher.h>
+#include <webview/server.h>
+#include <webview/url_manager.h>
+
+#include <arpa/inet.h>
+#include <catch2/catch.hpp>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <poll.h>
+#include <string>
+#include <unistd.h>
+
+using namespace fawkes;
+
+namespace {
+const unsigned short PORT_A = 18731;
+const unsigned short PORT_B = 18732;
+
+/** Web server with a single event stream endpoint. */
+class EventStreamServer
+{
+public:
+	EventStreamServer(unsigned short port, float max_rate = 0.f) : dispatcher_(&url_manager_)
+	{
+		url_manager_.add_handler(WebRequest::METHOD_GET,
+		                         "/events",
+		                         [this, max_rate](const WebRequest *) -> WebReply * {
+			                         std::shared_ptr<WebviewEventStream> stream =
+			                           WebviewEventStream::create(max_rate);
+			                         MutexLocker lock(&mutex_);
+			                         stream_ = stream;
+			                         return new WebviewEventStreamReply(stream);
+		                         });
+		server_ = new WebServer(port, &dispatcher_);
+		server_->setup_ipv(true, false).setup_thread_pool(2);
+		server_->start();
+	}
+
+	~EventStreamServer()
+	{
+		stop();
+	}
+
+	void
+	stop()
+	{
+		delete server_;
+		server_ = NULL;
+	}
+
+	std::shared_ptr<WebviewEventStream>
+	wait_for_stream()
+	{
+		for (unsigned int i = 0; i < 2000; ++i) {
+			{
+				MutexLocker lock(&mutex_);
+				if (stream_) {
+					return stream_;
+				}
+			}
+			usleep(1000);
+		}
+		return std::shared_ptr<WebviewEventStream>();
+	}
+
+private:
+	WebUrlManager        url_manager_;
+	WebRequestDispatcher dispatcher_;
+	WebServer           *server_;
+
+	Mutex                               mutex_;
+	std::shared_ptr<WebviewEventStream> stream_;
+};
+
+/** HTTP client reading an event stream. */
+class EventClient
+{
+public:
+	EventClient(unsigned short port) : closed_(false)
+	{
+		fd_ = socket(AF_INET, SOCK_STREAM, 0);
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family      = AF_INET;
+		addr.sin_port        = htons(port);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		REQUIRE(connect(fd_, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+		std::string request = "GET /events HTTP/1.1\r\nHost: localhost\r\n\r\n";
+		REQUIRE(send(fd_, request.c_str(), request.size(), 0) == (ssize_t)request.size());
+	}
+
+	~EventClient()
+	{
+		::close(fd_);
+	}
+
+	/** Read until the given text has been received.
+	 * @param text text to wait for
+	 * @param timeout_ms maximum time to wait
+	 * @return true if the text has been received */
+	bool
+	wait_for(const std::string &text, int timeout_ms = 2000)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+		while (received_.find(text) == std::string::npos) {
+			int remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+			                  deadline - std::chrono::steady_clock::now())
+			                  .count();
+			if (closed_ || remaining <= 0) {
+				return false;
+			}
+			struct pollfd pfd = {fd_, POLLIN, 0};
+			if (poll(&pfd, 1, remaining) > 0) {
+				char    buffer[1024];
+				ssize_t bytes = recv(fd_, buffer, sizeof(buffer), 0);
+				if (bytes <= 0) {
+					closed_ = true;
+				} else {
+					received_.append(buffer, bytes);
+				}
+			}
+		}
+		return true;
+	}
+
+	/** Check if text has been received.
+	 * @param text text to look for
+	 * @return true if the text has been received so far */
+	bool
+	received(const std::string &text) const
+	{
+		return received_.find(text) != std::string::npos;
+	}
+
+private:
+	int         fd_;
+	bool        closed_;
+	std::string received_;
+};
+} // namespace
+
+TEST_CASE("Events resume a suspended stream", "[event_stream]")
+{
+	EventStreamServer                   server(PORT_A);
+	EventClient                         client(PORT_A);
+	std::shared_ptr<WebviewEventStream> stream = server.wait_for_stream();
+	REQUIRE(stream);
+
+	// nothing to send, the connection is suspended until an event is published
+	usleep(100000);
+	REQUIRE_FALSE(client.received("event:"));
+
+	stream->publish("update", "first");
+	REQUIRE(client.wait_for("event: update\ndata: first\n\n"));
+
+	usleep(100000);
+	stream->publish("update", "multi\nline", "other");
+	REQUIRE(client.wait_for("event: update\ndata: multi\ndata: line\n\n"));
+}
+
+TEST_CASE("Events are coalesced and rate limited", "[event_stream]")
+{
+	EventStreamServer                   server(PORT_A, 4.f);
+	EventClient                         client(PORT_A);
+	std::shared_ptr<WebviewEventStream> stream = server.wait_for_stream();
+	REQUIRE(stream);
+
+	stream->publish("tick", "a");
+	REQUIRE(client.wait_for("data: a\n"));
+	auto sent_a = std::chrono::steady_clock::now();
+
+	std::atomic<unsigned int> generated(0);
+	for (const char *d : {"b", "c", "d"}) {
+		std::string data = d;
+		stream->publish("tick", [&generated, data]() {
+			++generated;
+			return data;
+		});
+	}
+
+	// held back by the rate limit, then resumed by the timer
+	REQUIRE(client.wait_for("data: d\n"));
+	auto elapsed = std::chrono::steady_clock::now() - sent_a;
+	REQUIRE(elapsed >= std::chrono::milliseconds(200));
+	REQUIRE_FALSE(client.received("data: b\n"));
+	REQUIRE_FALSE(client.received("data: c\n"));
+	REQUIRE(generated == 1);
+}
+
+TEST_CASE("Closing a stream ends the transfer", "[event_stream]")
+{
+	EventStreamServer                   server(PORT_A);
+	EventClient                         client(PORT_A);
+	std::shared_ptr<WebviewEventStream> stream = server.wait_for_stream();
+	REQUIRE(stream);
+
+	std::atomic<unsigned int> closed(0);
+	stream->add_close_callback([&closed]() { ++closed; });
+
+	usleep(100000);
+	stream->close();
+	REQUIRE(stream->closed());
+	REQUIRE(closed == 1);
+	// terminating chunk of the chunked transfer encoding
+	REQUIRE(client.wait_for("\r\n0\r\n\r\n"));
+
+	stream->publish("update", "late");
+	stream->add_close_callback([&closed]() { ++closed; });
+	REQUIRE(closed == 2);
+}
+
+TEST_CASE("Stopping a server only closes its own streams", "[event_stream]")
+{
+	EventStreamServer server_a(PORT_A);
+	EventStreamServer server_b(PORT_B);
+	EventClient       client_a(PORT_A);
+	EventClient       client_b(PORT_B);
+
+	std::shared_ptr<WebviewEventStream> stream_a = server_a.wait_for_stream();
+	std::shared_ptr<WebviewEventStream> stream_b = server_b.wait_for_stream();
+	REQUIRE(stream_a);
+	REQUIRE(stream_b);
+
+	// both streams are suspended, stopping must resume the one of server A
+	usleep(100000);
+	server_a.stop();
+	REQUIRE(stream_a->closed());
+	REQUIRE_FALSE(stream_b->closed());
+
+	stream_b->publish("update", "still there");
+	REQUIRE(client_b.wait_for("data: still there\n"));
+}
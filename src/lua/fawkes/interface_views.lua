@@ -0,0 +1,94 @@
+
+------------------------------------------------------------------------
+--  interface_views.lua - Direct read access to interface data
+--
+--  Created: Mon Oct 19 03:02:17 2026
+--  Copyright  2026  Tim Niemueller [www.niemueller.de]
+------------------------------------------------------------------------
+
+--  This program is free software; you can redistribute it and/or modify
+--  it under the terms of the GNU General Public License as published by
+--  the Free Software Foundation; either version 2 of the License, or
+--  (at your option) any later version.
+--
+--  This program is distributed in the hope that it will be useful,
+--  but WITHOUT ANY WARRANTY; without even the implied warranty of
+--  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--  GNU Library General Public License for more details.
+--
+--  Read the full text in the LICENSE.GPL file in the doc directory.
+
+require("fawkes.modinit")
+
+--- Views on interface data.
+-- A view allows to read the fields of an interface like table entries,
+-- e.g. navigator_view.x instead of navigator:x(). If Fawkes is built with
+-- LuaJIT, the view is a pointer to the interface's local data using the
+-- FFI definitions generated by ffifacegen. Reading a field then does not
+-- call into C at all. Without LuaJIT, the view is a proxy that calls the
+-- getter of the field, so code using views works in either case. In both
+-- cases the view reflects the data of the last read() of the interface.
+-- Note that with the FFI, string fields are char arrays, use str() to
+-- convert them, and array fields are indexed starting at zero.
+-- @author Tim Niemueller
+module(..., fawkes.modinit.module_init)
+
+local ffi = nil
+if _G.jit then
+	 local ok, m = pcall(require, "ffi")
+	 if ok then ffi = m end
+end
+
+local views = setmetatable({}, {__mode = "k"})
+
+--- Check if views read directly from interface data.
+-- @return true if LuaJIT FFI views are used, false if views are proxies
+function direct()
+	 return ffi ~= nil
+end
+
+local function proxy(iface)
+	 return setmetatable({}, {
+			__index = function (t, field)
+				 local getter = iface[field] or iface["is_" .. field]
+				 assert(getter, "Interface " .. iface:uid() .. " has no field " .. tostring(field))
+				 return getter(iface)
+			end,
+			__newindex = function ()
+				 error("Interface views are read-only")
+			end
+	 })
+end
+
+--- Get view for an interface.
+-- Views are created once per interface instance and cached.
+-- @param iface interface to get the view for
+-- @return view on the interface data
+function view(iface)
+	 local v = views[iface]
+	 if v then return v end
+
+	 if ffi then
+			local ok, m = pcall(require, "interfaces.ffi." .. iface:type())
+			if ok then
+				 v = m.view(iface)
+			else
+				 print_warn("No FFI definition for %s, using proxy view", iface:type())
+			end
+	 end
+	 if not v then
+			v = proxy(iface)
+	 end
+	 views[iface] = v
+	 return v
+end
+
+--- Convert string field value to Lua string.
+-- @param value value of a string field read from a view
+-- @return value as Lua string
+function str(value)
+	 if ffi and type(value) == "cdata" then
+			return ffi.string(value)
+	 end
+	 return value
+end
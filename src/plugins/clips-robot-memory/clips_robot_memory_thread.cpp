@@ -562,11 +562,10 @@ ClipsRobotMemoryThread::clips_robotmemory_query_sort(std::string collection,
 			find_opts.sort(bs->view());
 		}
 
-		auto cursor = robot_memory->query(b->view(), collection, find_opts);
-		//std::unique_ptr<mongocxx::cursor> c = new mongocxx::cursor(std::move(cursor));
-		return CLIPS::Value(new std::unique_ptr<mongocxx::cursor>(
-		                      new mongocxx::cursor(std::move(cursor))),
-		                    CLIPS::TYPE_EXTERNAL_ADDRESS);
+		// rules commonly issue the same queries on every cycle, the cached
+		// result is shared until the collection is modified
+		QueryCache::Result result = robot_memory->query_cached(b->view(), collection, find_opts);
+		return CLIPS::Value(new ResultCursor{result, 0}, CLIPS::TYPE_EXTERNAL_ADDRESS);
 	} catch (std::system_error &e) {
 		logger->log_warn("MongoDB", "Query failed: %s", e.what());
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
@@ -636,8 +635,8 @@ ClipsRobotMemoryThread::clips_robotmemory_query(const std::string &collection, v
 void
 ClipsRobotMemoryThread::clips_robotmemory_cursor_destroy(void *cursor)
 {
-	auto c = static_cast<std::unique_ptr<mongocxx::cursor> *>(cursor);
-	if (!c || !c->get()) {
+	auto c = static_cast<ResultCursor *>(cursor);
+	if (!c || !c->result) {
 		logger->log_error("MongoDB", "mongodb-cursor-destroy: got invalid cursor");
 		return;
 	}
@@ -655,26 +654,19 @@ ClipsRobotMemoryThread::clips_robotmemory_cursor_more(void *cursor)
 CLIPS::Value
 ClipsRobotMemoryThread::clips_robotmemory_cursor_next(void *cursor)
 {
-	auto c = static_cast<std::unique_ptr<mongocxx::cursor> *>(cursor);
+	auto c = static_cast<ResultCursor *>(cursor);
 
-	if (!c || !c->get()) {
+	if (!c || !c->result) {
 		logger->log_error("MongoDB", "mongodb-cursor-next: got invalid cursor");
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
 	}
 
-	try {
-		auto it = (*c)->begin();
-		if (it == (*c)->end()) {
-			return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
-		} else {
-			auto b = new bsoncxx::builder::basic::document();
-			b->append(bsoncxx::builder::concatenate(*it));
-			it++;
-			return CLIPS::Value(b);
-		}
-	} catch (std::system_error &e) {
-		logger->log_error("MongoDB", "mongodb-cursor-next: got invalid query: %s", e.what());
+	if (c->next >= c->result->size()) {
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	} else {
+		auto b = new bsoncxx::builder::basic::document();
+		b->append(bsoncxx::builder::concatenate((*c->result)[c->next++].view()));
+		return CLIPS::Value(b);
 	}
 }
 
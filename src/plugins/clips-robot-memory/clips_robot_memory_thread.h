@@ -69,6 +69,15 @@ protected:
 	}
 
 private:
+	/// @cond INTERNALS
+	/** Iteration state of a query result passed to CLIPS as cursor. */
+	struct ResultCursor
+	{
+		QueryCache::Result result;
+		size_t             next;
+	};
+	/// @endcond
+
 	std::map<std::string, fawkes::LockPtr<CLIPS::Environment>> envs_;
 
 	CLIPS::Value clips_bson_create();
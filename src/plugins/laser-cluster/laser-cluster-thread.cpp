@@ -53,6 +53,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <numeric>
 
 using namespace std;
 
@@ -119,6 +120,17 @@ LaserClusterThread::init()
 	cfg_offset_z_         = config->get_float(cfg_prefix_ + "offsets/z");
 	cfg_max_num_clusters_ = config->get_uint(cfg_prefix_ + "max_num_clusters");
 
+	std::string algorithm =
+	  config->get_string_or_default((cfg_prefix_ + "algorithm").c_str(), "scan-order");
+	if (algorithm == "scan-order") {
+		cfg_scan_order_ = true;
+	} else if (algorithm == "pcl") {
+		cfg_scan_order_ = false;
+	} else {
+		logger->log_warn(name(), "Unknown algorithm '%s', using scan-order", algorithm.c_str());
+		cfg_scan_order_ = true;
+	}
+
 	cfg_selection_mode_ = SELECT_MIN_ANGLE;
 	try {
 		std::string selmode = config->get_string(cfg_prefix_ + "cluster_selection_mode");
@@ -302,6 +314,14 @@ LaserClusterThread::loop()
 
 	TIMETRACK_INTER(ttc_msgproc_, ttc_extract_lines_);
 
+	try {
+		// the snapshot is never modified, no need to copy or lock
+		finput_ = pcl_manager->get_snapshot<PointType>(cfg_input_pcl_.c_str()).cloud;
+		input_  = pcl_utils::cloudptr_from_refptr(finput_);
+	} catch (Exception &e) {
+		// input cloud has been removed, keep using the last one
+	}
+
 	if (input_->points.size() <= 10) {
 		// this can happen if run at startup. Since tabletop threads runs continuous
 		// and not synchronized with main loop, but point cloud acquisition thread is
@@ -311,96 +331,16 @@ LaserClusterThread::loop()
 		return;
 	}
 
-	CloudPtr noline_cloud(new Cloud());
-
-	// Erase non-finite points
-	pcl::PassThrough<PointType> passthrough;
-	if (current_max_x_ > 0.) {
-		passthrough.setFilterFieldName("x");
-		passthrough.setFilterLimits(cfg_bbox_min_x_, current_max_x_);
-	}
-	passthrough.setInputCloud(input_);
-	passthrough.filter(*noline_cloud);
-
-	//logger->log_info(name(), "[L %u] total: %zu   finite: %zu",
-	//		     loop_count_, input_->points.size(), noline_cloud->points.size());
-
-	pcl::ModelCoefficients::Ptr coeff(new pcl::ModelCoefficients());
-	pcl::PointIndices::Ptr      inliers(new pcl::PointIndices());
-
-	if (cfg_line_removal_) {
-		std::list<CloudPtr> restore_pcls;
-
-		while (noline_cloud->points.size() > cfg_cluster_min_size_) {
-			// Segment the largest planar component from the remaining cloud
-			//logger->log_info(name(), "[L %u] %zu points left",
-			//	               loop_count_, noline_cloud->points.size());
-
-			pcl::search::KdTree<PointType>::Ptr search(new pcl::search::KdTree<PointType>);
-			search->setInputCloud(noline_cloud);
-			seg_.setSamplesMaxDist(cfg_segm_sample_max_dist_, search);
-			seg_.setInputCloud(noline_cloud);
-			seg_.segment(*inliers, *coeff);
-			if (inliers->indices.size() == 0) {
-				// no line found
-				break;
-			}
-
-			// check for a minimum number of expected inliers
-			if ((double)inliers->indices.size() < cfg_segm_min_inliers_) {
-				//logger->log_warn(name(), "[L %u] no more lines (%zu inliers, required %u)",
-				//		   loop_count_, inliers->indices.size(), cfg_segm_min_inliers_);
-				break;
-			}
-
-			float length = calc_line_length(noline_cloud, inliers, coeff);
-
-			if (length < cfg_line_min_length_) {
-				// we must remove the points for now to continue filtering,
-				// but must restore them later
-				// Remove the linear inliers, extract the rest
-				CloudPtr                       cloud_line(new Cloud());
-				pcl::ExtractIndices<PointType> extract;
-				extract.setInputCloud(noline_cloud);
-				extract.setIndices(inliers);
-				extract.setNegative(false);
-				extract.filter(*cloud_line);
-				restore_pcls.push_back(cloud_line);
-			}
-
-			// Remove the linear inliers, extract the rest
-			CloudPtr                       cloud_f(new Cloud());
-			pcl::ExtractIndices<PointType> extract;
-			extract.setInputCloud(noline_cloud);
-			extract.setIndices(inliers);
-			extract.setNegative(true);
-			extract.filter(*cloud_f);
-			*noline_cloud = *cloud_f;
-		}
-
-		for (CloudPtr cloud : restore_pcls) {
-			*noline_cloud += *cloud;
-		}
-	}
-
-	{
-		CloudPtr tmp_cloud(new Cloud());
-		// Erase non-finite points
-		pcl::PassThrough<PointType> passthrough;
-		passthrough.setInputCloud(noline_cloud);
-		passthrough.filter(*tmp_cloud);
-
-		if (noline_cloud->points.size() != tmp_cloud->points.size()) {
-			//logger->log_error(name(), "[L %u] new non-finite points total: %zu   finite: %zu",
-			//	          loop_count_, noline_cloud->points.size(), tmp_cloud->points.size());
-			*noline_cloud = *tmp_cloud;
-		}
+	CloudPtr                       noline_cloud(new Cloud());
+	std::vector<pcl::PointIndices> cluster_indices;
+	if (cfg_scan_order_) {
+		segment_scan_order(*noline_cloud, cluster_indices);
+	} else {
+		segment_pcl(noline_cloud, cluster_indices);
 	}
 
 	// What remains in the cloud are now potential clusters
 
-	TIMETRACK_INTER(ttc_extract_lines_, ttc_clustering_);
-
 	clusters_->points.resize(noline_cloud->points.size());
 	clusters_->height = 1;
 	clusters_->width  = noline_cloud->points.size();
@@ -424,44 +364,14 @@ LaserClusterThread::loop()
 	//logger->log_info(name(), "[L %u] remaining: %zu",
 	//		   loop_count_, noline_cloud->points.size());
 
-	std::vector<pcl::PointIndices> cluster_indices;
-	if (noline_cloud->points.size() > 0) {
-		// Creating the KdTree object for the search method of the extraction
-		pcl::search::KdTree<PointType>::Ptr kdtree_cl(new pcl::search::KdTree<PointType>());
-		kdtree_cl->setInputCloud(noline_cloud);
-
-		pcl::EuclideanClusterExtraction<PointType> ec;
-		ec.setClusterTolerance(cfg_cluster_tolerance_);
-		ec.setMinClusterSize(cfg_cluster_min_size_);
-		ec.setMaxClusterSize(cfg_cluster_max_size_);
-		ec.setSearchMethod(kdtree_cl);
-		ec.setInputCloud(noline_cloud);
-		ec.extract(cluster_indices);
-
-		//logger->log_info(name(), "Found %zu clusters", cluster_indices.size());
-
-		//unsigned int i = 0;
-		for (auto cluster : cluster_indices) {
-			//Eigen::Vector4f centroid;
-			//pcl::compute3DCentroid(*noline_cloud, cluster.indices, centroid);
-
-			//logger->log_info(name(), "  Cluster %u with %zu points at (%f, %f, %f)",
-			//	         i, cluster.indices.size(), centroid.x(), centroid.y(), centroid.z());
-			//++i;
-
-			// color points of cluster
-			for (auto ci : cluster.indices) {
-				ColorPointType &out_point = clusters_->points[ci];
-				out_point.r               = ignored_cluster_color[0];
-				out_point.g               = ignored_cluster_color[1];
-				;
-				out_point.b = ignored_cluster_color[2];
-				;
-			}
+	// color points of clusters
+	for (const auto &cluster : cluster_indices) {
+		for (auto ci : cluster.indices) {
+			ColorPointType &out_point = clusters_->points[ci];
+			out_point.r               = ignored_cluster_color[0];
+			out_point.g               = ignored_cluster_color[1];
+			out_point.b               = ignored_cluster_color[2];
 		}
-
-	} else {
-		//logger->log_info(name(), "Filter left no points for clustering");
 	}
 
 	if (!cluster_indices.empty()) {
@@ -561,6 +471,171 @@ LaserClusterThread::loop()
 #endif
 }
 
+/** Remove lines and cluster remaining points using PCL.
+ * @param noline_cloud upon return contains the points remaining after
+ * filtering and line removal
+ * @param cluster_indices upon return contains the indices of the points
+ * of the clusters in @p noline_cloud
+ */
+void
+LaserClusterThread::segment_pcl(CloudPtr                       &noline_cloud,
+                                std::vector<pcl::PointIndices> &cluster_indices)
+{
+	// Erase non-finite points
+	pcl::PassThrough<PointType> passthrough;
+	if (current_max_x_ > 0.) {
+		passthrough.setFilterFieldName("x");
+		passthrough.setFilterLimits(cfg_bbox_min_x_, current_max_x_);
+	}
+	passthrough.setInputCloud(input_);
+	passthrough.filter(*noline_cloud);
+
+	//logger->log_info(name(), "[L %u] total: %zu   finite: %zu",
+	//		     loop_count_, input_->points.size(), noline_cloud->points.size());
+
+	pcl::ModelCoefficients::Ptr coeff(new pcl::ModelCoefficients());
+	pcl::PointIndices::Ptr      inliers(new pcl::PointIndices());
+
+	if (cfg_line_removal_) {
+		std::list<CloudPtr> restore_pcls;
+
+		while (noline_cloud->points.size() > cfg_cluster_min_size_) {
+			// Segment the largest planar component from the remaining cloud
+			//logger->log_info(name(), "[L %u] %zu points left",
+			//	               loop_count_, noline_cloud->points.size());
+
+			pcl::search::KdTree<PointType>::Ptr search(new pcl::search::KdTree<PointType>);
+			search->setInputCloud(noline_cloud);
+			seg_.setSamplesMaxDist(cfg_segm_sample_max_dist_, search);
+			seg_.setInputCloud(noline_cloud);
+			seg_.segment(*inliers, *coeff);
+			if (inliers->indices.size() == 0) {
+				// no line found
+				break;
+			}
+
+			// check for a minimum number of expected inliers
+			if ((double)inliers->indices.size() < cfg_segm_min_inliers_) {
+				//logger->log_warn(name(), "[L %u] no more lines (%zu inliers, required %u)",
+				//		   loop_count_, inliers->indices.size(), cfg_segm_min_inliers_);
+				break;
+			}
+
+			float length = calc_line_length(noline_cloud, inliers, coeff);
+
+			if (length < cfg_line_min_length_) {
+				// we must remove the points for now to continue filtering,
+				// but must restore them later
+				// Remove the linear inliers, extract the rest
+				CloudPtr                       cloud_line(new Cloud());
+				pcl::ExtractIndices<PointType> extract;
+				extract.setInputCloud(noline_cloud);
+				extract.setIndices(inliers);
+				extract.setNegative(false);
+				extract.filter(*cloud_line);
+				restore_pcls.push_back(cloud_line);
+			}
+
+			// Remove the linear inliers, extract the rest
+			CloudPtr                       cloud_f(new Cloud());
+			pcl::ExtractIndices<PointType> extract;
+			extract.setInputCloud(noline_cloud);
+			extract.setIndices(inliers);
+			extract.setNegative(true);
+			extract.filter(*cloud_f);
+			*noline_cloud = *cloud_f;
+		}
+
+		for (CloudPtr cloud : restore_pcls) {
+			*noline_cloud += *cloud;
+		}
+	}
+
+	{
+		CloudPtr tmp_cloud(new Cloud());
+		// Erase non-finite points
+		pcl::PassThrough<PointType> passthrough;
+		passthrough.setInputCloud(noline_cloud);
+		passthrough.filter(*tmp_cloud);
+
+		if (noline_cloud->points.size() != tmp_cloud->points.size()) {
+			//logger->log_error(name(), "[L %u] new non-finite points total: %zu   finite: %zu",
+			//	          loop_count_, noline_cloud->points.size(), tmp_cloud->points.size());
+			*noline_cloud = *tmp_cloud;
+		}
+	}
+
+	TIMETRACK_INTER(ttc_extract_lines_, ttc_clustering_);
+
+	if (noline_cloud->points.size() > 0) {
+		// Creating the KdTree object for the search method of the extraction
+		pcl::search::KdTree<PointType>::Ptr kdtree_cl(new pcl::search::KdTree<PointType>());
+		kdtree_cl->setInputCloud(noline_cloud);
+
+		pcl::EuclideanClusterExtraction<PointType> ec;
+		ec.setClusterTolerance(cfg_cluster_tolerance_);
+		ec.setMinClusterSize(cfg_cluster_min_size_);
+		ec.setMaxClusterSize(cfg_cluster_max_size_);
+		ec.setSearchMethod(kdtree_cl);
+		ec.setInputCloud(noline_cloud);
+		ec.extract(cluster_indices);
+	}
+}
+
+/** Remove lines and cluster remaining points in scan order.
+ * Lightweight alternative to segment_pcl() for input clouds in scan
+ * order, lines are extracted by split-and-merge and clusters by breaking
+ * the scan at gaps.
+ * @param noline_cloud upon return contains the points remaining after
+ * filtering and line removal in scan order
+ * @param cluster_indices upon return contains the indices of the points
+ * of the clusters in @p noline_cloud
+ */
+void
+LaserClusterThread::segment_scan_order(Cloud                          &noline_cloud,
+                                       std::vector<pcl::PointIndices> &cluster_indices)
+{
+	segm_.set_input(*input_);
+	if (current_max_x_ > 0.) {
+		const float min_x = cfg_bbox_min_x_;
+		const float max_x = current_max_x_;
+		segm_.exclude_if([min_x, max_x](const PointType &p) { return p.x < min_x || p.x > max_x; });
+	}
+
+	if (cfg_line_removal_) {
+		const auto &lines = segm_.extract_lines(cfg_segm_distance_threshold_,
+		                                        cfg_segm_sample_max_dist_,
+		                                        cfg_segm_min_inliers_);
+		for (const auto &line : lines) {
+			if (line.length() >= cfg_line_min_length_) {
+				segm_.exclude(line);
+			}
+		}
+	}
+
+	TIMETRACK_INTER(ttc_extract_lines_, ttc_clustering_);
+
+	const auto &clusters =
+	  segm_.cluster(cfg_cluster_tolerance_, cfg_cluster_min_size_, cfg_cluster_max_size_);
+
+	// clusters refer to ranges of the remaining points
+	const std::vector<int> &indices = segm_.indices();
+	noline_cloud.points.resize(indices.size());
+	noline_cloud.height = 1;
+	noline_cloud.width  = indices.size();
+	for (size_t i = 0; i < indices.size(); ++i) {
+		noline_cloud.points[i] = input_->points[indices[i]];
+	}
+
+	cluster_indices.resize(clusters.size());
+	for (size_t i = 0; i < clusters.size(); ++i) {
+		cluster_indices[i].indices.resize(clusters[i].size());
+		std::iota(cluster_indices[i].indices.begin(),
+		          cluster_indices[i].indices.end(),
+		          (int)clusters[i].begin);
+	}
+}
+
 void
 LaserClusterThread::set_position(fawkes::Position3DInterface *iface,
                                  bool                         is_visible,
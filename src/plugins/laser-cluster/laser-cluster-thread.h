@@ -34,6 +34,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <pcl/segmentation/sac_segmentation.h>
+#include <pcl_utils/scan_segmentation.h>
 
 #include <Eigen/StdVector>
 
@@ -89,6 +90,9 @@ private:
 	                       pcl::PointIndices::Ptr      inliers,
 	                       pcl::ModelCoefficients::Ptr coeff);
 
+	void segment_pcl(CloudPtr &noline_cloud, std::vector<pcl::PointIndices> &cluster_indices);
+	void segment_scan_order(Cloud &noline_cloud, std::vector<pcl::PointIndices> &cluster_indices);
+
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
 	virtual void
@@ -105,7 +109,8 @@ private:
 	pcl::PointCloud<ColorPointType>::Ptr             clusters_;
 	pcl::PointCloud<LabelPointType>::Ptr             clusters_labeled_;
 
-	pcl::SACSegmentation<PointType> seg_;
+	pcl::SACSegmentation<PointType>                seg_;
+	fawkes::pcl_utils::ScanSegmentation<PointType> segm_;
 
 	std::vector<fawkes::Position3DInterface *> cluster_pos_ifs_;
 
@@ -139,6 +144,7 @@ private:
 	float            cfg_offset_z_;
 	selection_mode_t cfg_selection_mode_;
 	unsigned int     cfg_max_num_clusters_;
+	bool             cfg_scan_order_;
 
 	std::string output_cluster_name_;
 	std::string output_cluster_labeled_name_;
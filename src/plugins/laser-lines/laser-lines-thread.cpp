@@ -211,6 +211,14 @@ LaserLinesThread::loop()
 
 	TIMETRACK_INTER(ttc_msgproc_, ttc_extract_lines_);
 
+	try {
+		// the snapshot is never modified, no need to copy or lock
+		finput_ = pcl_manager->get_snapshot<PointType>(cfg_input_pcl_.c_str()).cloud;
+		input_  = pcl_utils::cloudptr_from_refptr(finput_);
+	} catch (Exception &e) {
+		// input cloud has been removed, keep using the last one
+	}
+
 	if (input_->points.size() <= 10) {
 		// this can happen if run at startup. Since thread runs continuous
 		// and not synchronized with main loop, but point cloud acquisition thread is
@@ -224,17 +232,30 @@ LaserLinesThread::loop()
 	} else {
 		//logger->log_info(name(), "[L %u] total: %zu   finite: %zu",
 		//		     loop_count_, input_->points.size(), in_cloud->points.size());
-		std::vector<LineInfo> linfos = calc_lines<PointType>(input_,
-		                                                     cfg_segm_min_inliers_,
-		                                                     cfg_segm_max_iterations_,
-		                                                     cfg_segm_distance_threshold_,
-		                                                     cfg_segm_sample_max_dist_,
-		                                                     cfg_cluster_tolerance_,
-		                                                     cfg_cluster_quota_,
-		                                                     cfg_min_length_,
-		                                                     cfg_max_length_,
-		                                                     cfg_min_dist_,
-		                                                     cfg_max_dist_);
+		std::vector<LineInfo> linfos;
+		if (cfg_scan_order_) {
+			linfos = calc_lines_scan_order<PointType>(segm_,
+			                                          *input_,
+			                                          cfg_segm_min_inliers_,
+			                                          cfg_segm_distance_threshold_,
+			                                          cfg_cluster_tolerance_,
+			                                          cfg_min_length_,
+			                                          cfg_max_length_,
+			                                          cfg_min_dist_,
+			                                          cfg_max_dist_);
+		} else {
+			linfos = calc_lines<PointType>(input_,
+			                               cfg_segm_min_inliers_,
+			                               cfg_segm_max_iterations_,
+			                               cfg_segm_distance_threshold_,
+			                               cfg_segm_sample_max_dist_,
+			                               cfg_cluster_tolerance_,
+			                               cfg_cluster_quota_,
+			                               cfg_min_length_,
+			                               cfg_max_length_,
+			                               cfg_min_dist_,
+			                               cfg_max_dist_);
+		}
 
 		TIMETRACK_INTER(ttc_extract_lines_, ttc_clustering_);
 		update_lines(linfos);
@@ -268,6 +289,16 @@ LaserLinesThread::read_config()
 	cfg_max_num_lines_ = config->get_uint(CFG_PREFIX "max_num_lines");
 
 	cfg_tracking_frame_id_ = config->get_string("/frames/odom");
+
+	std::string algorithm = config->get_string_or_default(CFG_PREFIX "algorithm", "scan-order");
+	if (algorithm == "scan-order") {
+		cfg_scan_order_ = true;
+	} else if (algorithm == "pcl") {
+		cfg_scan_order_ = false;
+	} else {
+		logger->log_warn(name(), "Unknown algorithm '%s', using scan-order", algorithm.c_str());
+		cfg_scan_order_ = true;
+	}
 }
 
 void
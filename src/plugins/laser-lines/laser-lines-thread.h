@@ -37,6 +37,7 @@
 #include <pcl/ModelCoefficients.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
+#include <pcl_utils/scan_segmentation.h>
 
 #include <Eigen/StdVector>
 
@@ -154,6 +155,8 @@ private:
 	std::vector<fawkes::LaserLineInterface *> line_avg_ifs_;
 	std::vector<TrackedLineInfo>              known_lines_;
 
+	fawkes::pcl_utils::ScanSegmentation<PointType> segm_;
+
 	fawkes::SwitchInterface *switch_if_;
 
 	typedef enum { SELECT_MIN_ANGLE, SELECT_MIN_DIST } selection_mode_t;
@@ -174,6 +177,7 @@ private:
 	bool         cfg_moving_avg_enabled_;
 	unsigned int cfg_moving_avg_window_size_;
 	std::string  cfg_tracking_frame_id_;
+	bool         cfg_scan_order_;
 
 	unsigned int loop_count_;
 
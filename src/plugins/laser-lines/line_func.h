@@ -39,6 +39,7 @@
 #include <pcl/segmentation/extract_clusters.h>
 #include <pcl/segmentation/sac_segmentation.h>
 #include <pcl/surface/convex_hull.h>
+#include <pcl_utils/scan_segmentation.h>
 
 /** Calculate length of line from associated points.
  * The unit depends on the units of the input data.
@@ -323,4 +324,84 @@ calc_lines(typename pcl::PointCloud<PointType>::ConstPtr input,
 	return linfos;
 }
 
+
+/** Calculate lines from a 2D laser scan in scan order.
+ * Lightweight alternative to calc_lines() which exploits that points of
+ * a laser scan are ordered by angle. It uses split-and-merge instead of
+ * RANSAC and does not need a search tree, all buffers are kept in the
+ * given segmentation between calls.
+ * @param segm scan segmentation used to extract lines
+ * @param input input point cloud in scan order from which to extract lines
+ * @param segm_min_inliers minimum number of points of a line
+ * @param segm_distance_threshold maximum distance of point to line to account it to a line
+ * @param cluster_tolerance maximum distance of two neighboring points on a line
+ * @param min_length minimum length of line to consider it
+ * @param max_length maximum length of a line to consider it
+ * @param min_dist minimum distance from frame origin to closest point on line to consider it
+ * @param max_dist maximum distance from frame origin to closest point on line to consider it
+ * @return vector of info about detected lines
+ */
+template <class PointType>
+std::vector<LineInfo>
+calc_lines_scan_order(fawkes::pcl_utils::ScanSegmentation<PointType> &segm,
+                      const pcl::PointCloud<PointType>               &input,
+                      unsigned int                                    segm_min_inliers,
+                      float                                           segm_distance_threshold,
+                      float                                           cluster_tolerance,
+                      float                                           min_length,
+                      float                                           max_length,
+                      float                                           min_dist,
+                      float                                           max_dist)
+{
+	std::vector<LineInfo> linfos;
+
+	segm.set_input(input);
+	const auto &lines =
+	  segm.extract_lines(segm_distance_threshold, cluster_tolerance, segm_min_inliers);
+
+	for (const auto &line : lines) {
+		float length = line.length();
+		if (length == 0 || (min_length >= 0 && length < min_length)
+		    || (max_length >= 0 && length > max_length)) {
+			continue;
+		}
+
+		LineInfo info;
+		info.point_on_line  = Eigen::Vector3f(line.point[0], line.point[1], 0.f);
+		info.line_direction = Eigen::Vector3f(line.direction[0], line.direction[1], 0.f);
+		info.length         = length;
+
+		// closest point on line to the frame origin
+		Eigen::Vector3f P =
+		  info.point_on_line - info.point_on_line.dot(info.line_direction) * info.line_direction;
+		info.bearing    = atan2f(P[1], P[0]);
+		info.base_point = P;
+		float dist      = P.norm();
+		if ((min_dist >= 0. && dist < min_dist) || (max_dist >= 0. && dist > max_dist)) {
+			continue;
+		}
+
+		info.end_point_1 = Eigen::Vector3f(line.end_point_1[0], line.end_point_1[1], 0.f);
+		info.end_point_2 = Eigen::Vector3f(line.end_point_2[0], line.end_point_2[1], 0.f);
+
+		// Project the line points
+		info.cloud.reset(new pcl::PointCloud<pcl::PointXYZ>());
+		info.cloud->points.resize(line.size());
+		info.cloud->height = 1;
+		info.cloud->width  = line.size();
+		for (unsigned int i = line.begin; i < line.end; ++i) {
+			const PointType &p = input.points[segm.indices()[i]];
+			float            t = info.line_direction.dot(Eigen::Vector3f(p.x, p.y, 0.f) - P);
+			pcl::PointXYZ   &o = info.cloud->points[i - line.begin];
+			o.x                = P[0] + t * info.line_direction[0];
+			o.y                = P[1] + t * info.line_direction[1];
+			o.z                = 0.f;
+		}
+
+		linfos.push_back(info);
+	}
+
+	return linfos;
+}
+
 #endif
@@ -21,6 +21,8 @@
 
 #include "laser_pointcloud_thread.h"
 
+#include "laser_projector.h"
+
 #include <core/threading/mutex_locker.h>
 #include <interfaces/Laser1080Interface.h>
 #include <interfaces/Laser360Interface.h>
@@ -42,6 +44,7 @@ using namespace fawkes;
 LaserPointCloudThread::LaserPointCloudThread()
 : Thread("LaserPointCloudThread", Thread::OPMODE_WAITFORWAKEUP),
   BlockedTimingAspect(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PREPARE),
+  TransformAspect(TransformAspect::ONLY_LISTENER),
   BlackBoardInterfaceListener("LaserPointCloudThread")
 {
 }
@@ -54,6 +57,16 @@ LaserPointCloudThread::~LaserPointCloudThread()
 void
 LaserPointCloudThread::init()
 {
+	cfg_angle_offset_ =
+	  deg2rad(config->get_float_or_default("/laser-pointclouds/angle_offset", 0.f));
+	cfg_deskew_ = config->get_bool_or_default("/laser-pointclouds/deskew/enable", false);
+	cfg_deskew_scan_duration_ =
+	  config->get_float_or_default("/laser-pointclouds/deskew/scan_duration", 0.1f);
+	cfg_deskew_stamp_at_end_ =
+	  config->get_bool_or_default("/laser-pointclouds/deskew/stamp_at_end", true);
+	cfg_deskew_fixed_frame_ =
+	  config->get_string_or_default("/laser-pointclouds/deskew/fixed_frame", "/odom");
+
 	std::list<Laser360Interface *> l360ifs =
 	  blackboard->open_multiple_for_reading<Laser360Interface>("*");
 
@@ -71,12 +84,12 @@ LaserPointCloudThread::init()
 		mapping.interface_typed.as360 = *i;
 		mapping.interface             = *i;
 		mapping.interface->read();
-		mapping.cloud = new pcl::PointCloud<pcl::PointXYZ>();
-		mapping.cloud->points.resize(360);
-		mapping.cloud->header.frame_id = (*i)->frame();
-		mapping.cloud->height          = 1;
-		mapping.cloud->width           = 360;
-		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+		RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud(new pcl::PointCloud<pcl::PointXYZ>());
+		cloud->points.resize(360);
+		cloud->header.frame_id = (*i)->frame();
+		cloud->height          = 1;
+		cloud->width           = 360;
+		pcl_manager->add_pointcloud(mapping.id.c_str(), cloud);
 		bbil_add_reader_interface(*i);
 		bbil_add_writer_interface(*i);
 		mappings_.push_back(mapping);
@@ -89,12 +102,12 @@ LaserPointCloudThread::init()
 		mapping.interface_typed.as720 = *j;
 		mapping.interface             = *j;
 		mapping.interface->read();
-		mapping.cloud = new pcl::PointCloud<pcl::PointXYZ>();
-		mapping.cloud->points.resize(720);
-		mapping.cloud->header.frame_id = (*j)->frame();
-		mapping.cloud->height          = 1;
-		mapping.cloud->width           = 720;
-		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+		RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud(new pcl::PointCloud<pcl::PointXYZ>());
+		cloud->points.resize(720);
+		cloud->header.frame_id = (*j)->frame();
+		cloud->height          = 1;
+		cloud->width           = 720;
+		pcl_manager->add_pointcloud(mapping.id.c_str(), cloud);
 		bbil_add_reader_interface(*j);
 		bbil_add_writer_interface(*j);
 		mappings_.push_back(mapping);
@@ -108,12 +121,12 @@ LaserPointCloudThread::init()
 		mapping.interface_typed.as1080 = *k;
 		mapping.interface              = *k;
 		mapping.interface->read();
-		mapping.cloud = new pcl::PointCloud<pcl::PointXYZ>();
-		mapping.cloud->points.resize(1080);
-		mapping.cloud->header.frame_id = (*k)->frame();
-		mapping.cloud->height          = 1;
-		mapping.cloud->width           = 1080;
-		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+		RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud(new pcl::PointCloud<pcl::PointXYZ>());
+		cloud->points.resize(1080);
+		cloud->header.frame_id = (*k)->frame();
+		cloud->height          = 1;
+		cloud->width           = 1080;
+		pcl_manager->add_pointcloud(mapping.id.c_str(), cloud);
 		bbil_add_reader_interface(*k);
 		bbil_add_writer_interface(*k);
 		mappings_.push_back(mapping);
@@ -125,20 +138,6 @@ LaserPointCloudThread::init()
 	bbio_add_observed_create("Laser720Interface", "*");
 	bbio_add_observed_create("Laser1080Interface", "*");
 	blackboard->register_observer(this);
-
-	// Generate lookup tables for sin and cos
-	for (unsigned int i = 0; i < 360; ++i) {
-		sin_angles360[i] = sinf(deg2rad(i));
-		cos_angles360[i] = cosf(deg2rad(i));
-	}
-	for (unsigned int i = 0; i < 720; ++i) {
-		sin_angles720[i] = sinf(deg2rad((float)i / 2.));
-		cos_angles720[i] = cosf(deg2rad((float)i / 2.));
-	}
-	for (unsigned int i = 0; i < 1080; ++i) {
-		sin_angles1080[i] = sinf(deg2rad((float)i / 3.));
-		cos_angles1080[i] = cosf(deg2rad((float)i / 3.));
-	}
 }
 
 void
@@ -166,32 +165,47 @@ LaserPointCloudThread::loop()
 		if (!m->interface->refreshed()) {
 			continue;
 		}
-		if (m->size == 360) {
-			m->cloud->header.frame_id = m->interface_typed.as360->frame();
-			float *distances          = m->interface_typed.as360->distances();
-			for (unsigned int i = 0; i < 360; ++i) {
-				m->cloud->points[i].x = distances[i] * cos_angles360[i];
-				m->cloud->points[i].y = distances[i] * sin_angles360[i];
-			}
 
-		} else if (m->size == 720) {
-			m->cloud->header.frame_id = m->interface_typed.as720->frame();
-			float *distances          = m->interface_typed.as720->distances();
-			for (unsigned int i = 0; i < 720; ++i) {
-				m->cloud->points[i].x = distances[i] * cos_angles720[i];
-				m->cloud->points[i].y = distances[i] * sin_angles720[i];
-			}
+		// consumers may still use earlier snapshots, never modify in place
+		RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud =
+		  pcl_manager->acquire_pointcloud_buffer<pcl::PointXYZ>(m->id.c_str());
 
+		const char *frame     = nullptr;
+		float      *distances = nullptr;
+		if (m->size == 360) {
+			frame     = m->interface_typed.as360->frame();
+			distances = m->interface_typed.as360->distances();
+		} else if (m->size == 720) {
+			frame     = m->interface_typed.as720->frame();
+			distances = m->interface_typed.as720->distances();
 		} else if (m->size == 1080) {
-			m->cloud->header.frame_id = m->interface_typed.as1080->frame();
-			float *distances          = m->interface_typed.as1080->distances();
-			for (unsigned int i = 0; i < 1080; ++i) {
-				m->cloud->points[i].x = distances[i] * cos_angles1080[i];
-				m->cloud->points[i].y = distances[i] * sin_angles1080[i];
-			}
+			frame     = m->interface_typed.as1080->frame();
+			distances = m->interface_typed.as1080->distances();
+		} else {
+			continue;
 		}
 
-		pcl_utils::set_time(m->cloud, *(m->interface->timestamp()));
+		if (!m->projector) {
+			// full circle scans, first beam in forward direction plus offset
+			m->projector =
+			  std::make_shared<LaserProjector>(m->size, cfg_angle_offset_, 2 * M_PI / m->size);
+		}
+
+		cloud->header.frame_id = frame;
+		tf::Transform first, last;
+		if (cfg_deskew_ && scan_motion(frame, *(m->interface->timestamp()), first, last)) {
+			x_.resize(m->size);
+			y_.resize(m->size);
+			z_.assign(m->size, 0.f);
+			m->projector->project(distances, &x_[0], &y_[0]);
+			m->projector->deskew(first, last, &x_[0], &y_[0], &z_[0]);
+			LaserProjector::to_cloud(&x_[0], &y_[0], &z_[0], m->size, **cloud);
+		} else {
+			m->projector->project(distances, **cloud);
+		}
+
+		pcl_utils::set_time(cloud, *(m->interface->timestamp()));
+		pcl_manager->publish_pointcloud(m->id.c_str(), cloud);
 	}
 }
 
@@ -199,9 +213,10 @@ void
 LaserPointCloudThread::bb_interface_created(const char *type, const char *id) noexcept
 {
 	InterfaceCloudMapping mapping;
-	mapping.id    = interface_to_pcl_name(id);
-	mapping.cloud = RefPtr<pcl::PointCloud<pcl::PointXYZ>>(new pcl::PointCloud<pcl::PointXYZ>);
-	mapping.cloud->height = 1;
+	mapping.id = interface_to_pcl_name(id);
+
+	RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud(new pcl::PointCloud<pcl::PointXYZ>());
+	cloud->height = 1;
 
 	if (strncmp(type, "Laser360Interface", INTERFACE_TYPE_SIZE_) == 0) {
 		Laser360Interface *lif;
@@ -216,10 +231,10 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) no
 			mapping.size                  = 360;
 			mapping.interface_typed.as360 = lif;
 			mapping.interface             = lif;
-			mapping.cloud->points.resize(360);
-			mapping.cloud->header.frame_id = lif->frame();
-			mapping.cloud->width           = 360;
-			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+			cloud->points.resize(360);
+			cloud->header.frame_id = lif->frame();
+			cloud->width           = 360;
+			pcl_manager->add_pointcloud(mapping.id.c_str(), cloud);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
 			blackboard->close(lif);
@@ -239,10 +254,10 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) no
 			mapping.size                  = 720;
 			mapping.interface_typed.as720 = lif;
 			mapping.interface             = lif;
-			mapping.cloud->points.resize(720);
-			mapping.cloud->header.frame_id = lif->frame();
-			mapping.cloud->width           = 720;
-			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+			cloud->points.resize(720);
+			cloud->header.frame_id = lif->frame();
+			cloud->width           = 720;
+			pcl_manager->add_pointcloud(mapping.id.c_str(), cloud);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
 			blackboard->close(lif);
@@ -262,10 +277,10 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) no
 			mapping.size                   = 1080;
 			mapping.interface_typed.as1080 = lif;
 			mapping.interface              = lif;
-			mapping.cloud->points.resize(1080);
-			mapping.cloud->header.frame_id = lif->frame();
-			mapping.cloud->width           = 1080;
-			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+			cloud->points.resize(1080);
+			cloud->header.frame_id = lif->frame();
+			cloud->width           = 1080;
+			pcl_manager->add_pointcloud(mapping.id.c_str(), cloud);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
 			blackboard->close(lif);
@@ -352,6 +367,41 @@ LaserPointCloudThread::conditional_close(Interface *interface) noexcept
 	}
 }
 
+/** Determine sensor motion during a scan.
+ * @param frame sensor frame of the scan
+ * @param stamp time stamp of the scan
+ * @param first upon return contains the transform from the sensor frame
+ * at the time of the first beam to the frame the scan is stamped in
+ * @param last upon return contains the transform for the last beam
+ * @return true if the transforms could be determined, false otherwise
+ */
+bool
+LaserPointCloudThread::scan_motion(const char    *frame,
+                                   const Time    &stamp,
+                                   tf::Transform &first,
+                                   tf::Transform &last)
+{
+	tf::StampedTransform motion;
+	try {
+		if (cfg_deskew_stamp_at_end_) {
+			Time start = stamp - (double)cfg_deskew_scan_duration_;
+			tf_listener->lookup_transform(frame, stamp, frame, start, cfg_deskew_fixed_frame_, motion);
+			first = motion;
+			last  = tf::Transform::getIdentity();
+		} else {
+			Time end = stamp + (double)cfg_deskew_scan_duration_;
+			tf_listener->lookup_transform(frame, stamp, frame, end, cfg_deskew_fixed_frame_, motion);
+			first = tf::Transform::getIdentity();
+			last  = motion;
+		}
+	} catch (Exception &e) {
+		// no transforms for the scan's time (yet), use scan as is
+		logger->log_debug(name(), "Cannot de-skew scan in %s: %s", frame, e.what_no_backtrace());
+		return false;
+	}
+	return true;
+}
+
 std::string
 LaserPointCloudThread::interface_to_pcl_name(const char *interface_id)
 {
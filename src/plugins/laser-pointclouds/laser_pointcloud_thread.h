@@ -25,8 +25,10 @@
 // must be first for reliable ROS detection
 #include <aspect/blackboard.h>
 #include <aspect/blocked_timing.h>
+#include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <aspect/pointcloud.h>
+#include <aspect/tf.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
 #include <core/threading/thread.h>
@@ -34,6 +36,11 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
+#include <memory>
+#include <vector>
+
+class LaserProjector;
+
 namespace fawkes {
 class Interface;
 class Laser360Interface;
@@ -43,9 +50,11 @@ class Laser1080Interface;
 
 class LaserPointCloudThread : public fawkes::Thread,
                               public fawkes::LoggingAspect,
+                              public fawkes::ConfigurableAspect,
                               public fawkes::BlackBoardAspect,
                               public fawkes::BlockedTimingAspect,
                               public fawkes::PointCloudAspect,
+                              public fawkes::TransformAspect,
                               public fawkes::BlackBoardInterfaceObserver,
                               public fawkes::BlackBoardInterfaceListener
 {
@@ -69,6 +78,10 @@ public:
 private:
 	void        conditional_close(fawkes::Interface *interface) noexcept;
 	std::string interface_to_pcl_name(const char *interface_id);
+	bool        scan_motion(const char            *frame,
+	                        const fawkes::Time    &stamp,
+	                        fawkes::tf::Transform &first,
+	                        fawkes::tf::Transform &last);
 
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
@@ -89,20 +102,22 @@ private:
 			fawkes::Laser720Interface  *as720;
 			fawkes::Laser1080Interface *as1080;
 		} interface_typed;
-		fawkes::Interface *interface;
-
-		fawkes::RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud;
+		fawkes::Interface              *interface;
+		std::shared_ptr<LaserProjector> projector;
 	} InterfaceCloudMapping;
 	/// @endcond
 
 	fawkes::LockList<InterfaceCloudMapping> mappings_;
 
-	float sin_angles360[360];
-	float cos_angles360[360];
-	float sin_angles720[720];
-	float cos_angles720[720];
-	float sin_angles1080[1080];
-	float cos_angles1080[1080];
+	float       cfg_angle_offset_;
+	bool        cfg_deskew_;
+	float       cfg_deskew_scan_duration_;
+	bool        cfg_deskew_stamp_at_end_;
+	std::string cfg_deskew_fixed_frame_;
+
+	std::vector<float> x_;
+	std::vector<float> y_;
+	std::vector<float> z_;
 };
 
 #endif
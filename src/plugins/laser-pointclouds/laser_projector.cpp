@@ -0,0 +1,218 @@
+
+/***************************************************************************
+ *  laser_projector.cpp - Project laser scans to points
+ *
+ *  Created: Sun Oct 18 14:07:31 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "laser_projector.h"
+
+#include <cmath>
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
+
+using namespace fawkes;
+
+/// @cond INTERNALS
+#ifdef __SSE2__
+static_assert(sizeof(pcl::PointXYZ) == 4 * sizeof(float),
+              "SSE path requires PCL's padded 16 byte point layout");
+
+// Store four points given as columns of x, y, and z, w is set to 1
+static inline void
+store_points(pcl::PointXYZ *p, __m128 x, __m128 y, __m128 z)
+{
+	__m128 w = _mm_set1_ps(1.f);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(p[0].data, x);
+	_mm_storeu_ps(p[1].data, y);
+	_mm_storeu_ps(p[2].data, z);
+	_mm_storeu_ps(p[3].data, w);
+}
+#endif
+/// @endcond
+
+/** @class LaserProjector "laser_projector.h"
+ * Project laser scans to Cartesian coordinates.
+ * The projector is created for a scan layout, i.e., the number of beams,
+ * the angle of the first beam and the angle between two beams, for which
+ * sine and cosine are computed once. Points can be written as separate
+ * arrays of x, y, and z coordinates (structure of arrays), which is the
+ * representation that de-skewing operates on, or directly into a PCL
+ * point cloud. Both paths use SSE2 if available.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param num_beams number of beams per scan
+ * @param angle_offset angle of the first beam in rad
+ * @param angle_increment angle between two consecutive beams in rad,
+ * positive for counter-clockwise scans
+ */
+LaserProjector::LaserProjector(unsigned int num_beams, float angle_offset, float angle_increment)
+: num_beams_(num_beams), cos_(num_beams), sin_(num_beams)
+{
+	for (unsigned int i = 0; i < num_beams_; ++i) {
+		double a = angle_offset + (double)i * angle_increment;
+		cos_[i]  = cos(a);
+		sin_[i]  = sin(a);
+	}
+}
+
+/** Get number of beams.
+ * @return number of beams of a scan
+ */
+unsigned int
+LaserProjector::num_beams() const
+{
+	return num_beams_;
+}
+
+/** Project scan to coordinate arrays.
+ * @param distances distances of all beams
+ * @param x array of num_beams() elements to write x coordinates to
+ * @param y array of num_beams() elements to write y coordinates to
+ */
+void
+LaserProjector::project(const float *distances, float *x, float *y) const
+{
+	const float *c = cos_.data();
+	const float *s = sin_.data();
+	unsigned int i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= num_beams_; i += 4) {
+		__m128 d = _mm_loadu_ps(distances + i);
+		_mm_storeu_ps(x + i, _mm_mul_ps(d, _mm_loadu_ps(c + i)));
+		_mm_storeu_ps(y + i, _mm_mul_ps(d, _mm_loadu_ps(s + i)));
+	}
+#endif
+	for (; i < num_beams_; ++i) {
+		x[i] = distances[i] * c[i];
+		y[i] = distances[i] * s[i];
+	}
+}
+
+/** Project scan to point cloud.
+ * The cloud is resized to num_beams() points if necessary, all points
+ * are in the scan plane.
+ * @param distances distances of all beams
+ * @param cloud cloud to write points to
+ */
+void
+LaserProjector::project(const float *distances, pcl::PointCloud<pcl::PointXYZ> &cloud) const
+{
+	if (cloud.points.size() != num_beams_) {
+		cloud.points.resize(num_beams_);
+	}
+	cloud.width  = num_beams_;
+	cloud.height = 1;
+
+	pcl::PointXYZ *p = cloud.points.data();
+	const float   *c = cos_.data();
+	const float   *s = sin_.data();
+	unsigned int   i = 0;
+#ifdef __SSE2__
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= num_beams_; i += 4) {
+		__m128 d = _mm_loadu_ps(distances + i);
+		store_points(p + i,
+		             _mm_mul_ps(d, _mm_loadu_ps(c + i)),
+		             _mm_mul_ps(d, _mm_loadu_ps(s + i)),
+		             zero);
+	}
+#endif
+	for (; i < num_beams_; ++i) {
+		p[i].x = distances[i] * c[i];
+		p[i].y = distances[i] * s[i];
+		p[i].z = 0.f;
+	}
+}
+
+/** Compensate sensor motion during a scan.
+ * Beams of a scan are measured at different times. If the sensor moves
+ * while scanning, the resulting points are distorted. Given the
+ * transforms from the sensor frame at the time of the first and the last
+ * beam to the reference frame of the scan, each beam is transformed with
+ * the transform interpolated for its time, assuming a constant rotation
+ * speed of the scanner. Typically one of the two transforms is the
+ * identity, depending on whether the scan is stamped with the time of
+ * the first or the last beam.
+ * @param first transform for the first beam
+ * @param last transform for the last beam
+ * @param x x coordinates of num_beams() points, modified in place
+ * @param y y coordinates of num_beams() points, modified in place
+ * @param z z coordinates of num_beams() points, modified in place
+ */
+void
+LaserProjector::deskew(const tf::Transform &first,
+                       const tf::Transform &last,
+                       float               *x,
+                       float               *y,
+                       float               *z) const
+{
+	const tf::Quaternion q0 = first.getRotation();
+	const tf::Quaternion q1 = last.getRotation();
+	const tf::Vector3    t0 = first.getOrigin();
+	const tf::Vector3    t1 = last.getOrigin();
+	const double         n  = num_beams_ > 1 ? num_beams_ - 1 : 1;
+
+	for (unsigned int i = 0; i < num_beams_; ++i) {
+		const double  s = i / n;
+		tf::Transform t(q0.slerp(q1, s), t0.lerp(t1, s));
+		tf::Vector3   p = t * tf::Vector3(x[i], y[i], z[i]);
+		x[i]            = p.x();
+		y[i]            = p.y();
+		z[i]            = p.z();
+	}
+}
+
+/** Write coordinate arrays to point cloud.
+ * The cloud is resized to the given number of points if necessary.
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param z z coordinates
+ * @param num_points number of elements in each of the arrays
+ * @param cloud cloud to write points to
+ */
+void
+LaserProjector::to_cloud(const float                    *x,
+                         const float                    *y,
+                         const float                    *z,
+                         unsigned int                    num_points,
+                         pcl::PointCloud<pcl::PointXYZ> &cloud)
+{
+	if (cloud.points.size() != num_points) {
+		cloud.points.resize(num_points);
+	}
+	cloud.width  = num_points;
+	cloud.height = 1;
+
+	pcl::PointXYZ *p = cloud.points.data();
+	unsigned int   i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= num_points; i += 4) {
+		store_points(p + i, _mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(z + i));
+	}
+#endif
+	for (; i < num_points; ++i) {
+		p[i].x = x[i];
+		p[i].y = y[i];
+		p[i].z = z[i];
+	}
+}
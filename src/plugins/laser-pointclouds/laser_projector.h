@@ -0,0 +1,60 @@
+
+/***************************************************************************
+ *  laser_projector.h - Project laser scans to points
+ *
+ *  Created: Sun Oct 18 14:07:31 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_LASER_POINTCLOUDS_LASER_PROJECTOR_H_
+#define _PLUGINS_LASER_POINTCLOUDS_LASER_PROJECTOR_H_
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <tf/types.h>
+
+#include <vector>
+
+class LaserProjector
+{
+public:
+	LaserProjector(unsigned int num_beams, float angle_offset, float angle_increment);
+
+	unsigned int num_beams() const;
+
+	void project(const float *distances, float *x, float *y) const;
+	void project(const float *distances, pcl::PointCloud<pcl::PointXYZ> &cloud) const;
+
+	void deskew(const fawkes::tf::Transform &first,
+	            const fawkes::tf::Transform &last,
+	            float                       *x,
+	            float                       *y,
+	            float                       *z) const;
+
+	static void to_cloud(const float                    *x,
+	                     const float                    *y,
+	                     const float                    *z,
+	                     unsigned int                    num_points,
+	                     pcl::PointCloud<pcl::PointXYZ> &cloud);
+
+private:
+	unsigned int       num_beams_;
+	std::vector<float> cos_;
+	std::vector<float> sin_;
+};
+
+#endif
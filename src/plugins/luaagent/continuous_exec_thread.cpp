@@ -153,6 +153,10 @@ LuaAgentContinuousExecutionThread::init()
 
 		lua_->add_package_dir(LUADIR);
 		lua_->add_cpackage_dir(LUALIBDIR);
+#ifdef HAVE_LUAJIT
+		// FFI definitions of interfaces
+		lua_->add_package_dir(LUALIBDIR);
+#endif
 
 		lua_->add_package("fawkesutils");
 		lua_->add_package("fawkesconfig");
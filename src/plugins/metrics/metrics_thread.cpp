@@ -28,6 +28,7 @@
 #include <interfaces/MetricHistogramInterface.h>
 #include <interfaces/MetricUntypedInterface.h>
 #include <utils/misc/string_split.h>
+#include <utils/time/latency_histogram.h>
 #include <webview/url_manager.h>
 
 #include <algorithm>
@@ -122,6 +123,18 @@ MetricsThread::init()
 		                 "Internal metric metrics_proctime bucket bounds not configured, disabling");
 	}
 
+	loop_timing_enabled_ = config->get_bool_or_default(CFG_PREFIX "internal/loop_timing/enable", true);
+	if (loop_timing_enabled_) {
+		std::vector<float> buckets_le;
+		try {
+			buckets_le = config->get_floats(CFG_PREFIX "internal/loop_timing/buckets");
+		} catch (Exception &e) {
+			buckets_le = {0.0001, 0.0005, 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 1.0};
+		}
+		std::sort(buckets_le.begin(), buckets_le.end());
+		loop_timing_buckets_.assign(buckets_le.begin(), buckets_le.end());
+	}
+
 	metrics_suppliers_.push_back(this);
 
 	req_proc_ = new MetricsRequestProcessor(this, logger, URL_PREFIX);
@@ -278,9 +291,97 @@ MetricsThread::metrics()
 		rv.push_back(std::move(*im));
 	}
 
+	if (loop_timing_enabled_) {
+		add_loop_timing_metrics(rv);
+	}
+
 	return rv;
 }
 
+void
+MetricsThread::set_histogram(io::prometheus::client::Metric *m, const LatencyHistogram &lh)
+{
+	io::prometheus::client::Histogram *h = m->mutable_histogram();
+	for (double le : loop_timing_buckets_) {
+		io::prometheus::client::Bucket *b = h->add_bucket();
+		b->set_upper_bound(le);
+		b->set_cumulative_count(lh.cumulative_count(le));
+	}
+	h->set_sample_count(lh.count());
+	h->set_sample_sum(lh.sum());
+}
+
+void
+MetricsThread::add_loop_timing_metrics(std::list<io::prometheus::client::MetricFamily> &metrics)
+{
+	io::prometheus::client::MetricFamily loop_duration;
+	loop_duration.set_name("fawkes_thread_loop_duration_seconds");
+	loop_duration.set_help("Duration of loops of synchronized threads");
+	loop_duration.set_type(io::prometheus::client::HISTOGRAM);
+
+	io::prometheus::client::MetricFamily wakeup_latency;
+	wakeup_latency.set_name("fawkes_thread_wakeup_latency_seconds");
+	wakeup_latency.set_help("Latency from emitting a hook until a thread starts its loop");
+	wakeup_latency.set_type(io::prometheus::client::HISTOGRAM);
+
+	io::prometheus::client::MetricFamily wait_time;
+	wait_time.set_name("fawkes_thread_wait_seconds");
+	wait_time.set_help("Time threads spend waiting for their hook");
+	wait_time.set_type(io::prometheus::client::HISTOGRAM);
+
+	io::prometheus::client::MetricFamily deadline_misses;
+	deadline_misses.set_name("fawkes_thread_deadline_misses_total");
+	deadline_misses.set_help("Number of loops which exceeded the maximum thread time");
+	deadline_misses.set_type(io::prometheus::client::COUNTER);
+
+	for (const auto &ls : syncpoint_manager->get_loop_statistics()) {
+		std::list<io::prometheus::client::Metric *> ms;
+		ms.push_back(loop_duration.add_metric());
+		ms.push_back(wakeup_latency.add_metric());
+		ms.push_back(wait_time.add_metric());
+		ms.push_back(deadline_misses.add_metric());
+		for (io::prometheus::client::Metric *m : ms) {
+			io::prometheus::client::LabelPair *lp = m->add_label();
+			lp->set_name("thread");
+			lp->set_value(ls->component());
+			lp = m->add_label();
+			lp->set_name("hook");
+			lp->set_value(ls->hook());
+		}
+
+		set_histogram(loop_duration.mutable_metric(loop_duration.metric_size() - 1),
+		              ls->loop_duration());
+		set_histogram(wakeup_latency.mutable_metric(wakeup_latency.metric_size() - 1),
+		              ls->wakeup_latency());
+		set_histogram(wait_time.mutable_metric(wait_time.metric_size() - 1), ls->wait_time());
+		deadline_misses.mutable_metric(deadline_misses.metric_size() - 1)
+		  ->mutable_counter()
+		  ->set_value(ls->num_deadline_misses());
+	}
+
+	io::prometheus::client::MetricFamily syncpoint_wait;
+	syncpoint_wait.set_name("fawkes_syncpoint_wait_seconds");
+	syncpoint_wait.set_help("Time spent waiting for SyncPoints");
+	syncpoint_wait.set_type(io::prometheus::client::HISTOGRAM);
+
+	for (const RefPtr<SyncPoint> &sp : syncpoint_manager->get_syncpoints()) {
+		const LatencyHistogram &lh = sp->get_wait_time_histogram();
+		if (lh.count() == 0)
+			continue;
+		io::prometheus::client::Metric    *m  = syncpoint_wait.add_metric();
+		io::prometheus::client::LabelPair *lp = m->add_label();
+		lp->set_name("syncpoint");
+		lp->set_value(sp->get_identifier());
+		set_histogram(m, lh);
+	}
+
+	metrics.push_back(std::move(loop_duration));
+	metrics.push_back(std::move(wakeup_latency));
+	metrics.push_back(std::move(wait_time));
+	metrics.push_back(std::move(deadline_misses));
+	metrics.push_back(std::move(syncpoint_wait));
+}
+
 std::list<io::prometheus::client::MetricFamily>
 MetricsThread::all_metrics()
 {
@@ -29,6 +29,7 @@
 #include <aspect/blocked_timing.h>
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
+#include <aspect/syncpoint_manager.h>
 #include <aspect/webview.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
@@ -46,12 +47,14 @@ class MetricGaugeInterface;
 class MetricUntypedInterface;
 class MetricHistogramInterface;
 //MetricSummaryInterface;
+class LatencyHistogram;
 } // namespace fawkes
 
 namespace io {
 namespace prometheus {
 namespace client {
 class MetricFamily;
+class Metric;
 }
 } // namespace prometheus
 } // namespace io
@@ -62,6 +65,7 @@ class MetricsThread : public fawkes::Thread,
                       public fawkes::BlackBoardAspect,
                       public fawkes::WebviewAspect,
                       public fawkes::BlockedTimingAspect,
+                      public fawkes::SyncPointManagerAspect,
                       public fawkes::AspectProviderAspect,
                       public fawkes::BlackBoardInterfaceObserver,
                       public fawkes::BlackBoardInterfaceListener,
@@ -125,6 +129,8 @@ private:
 	bool conditional_open(const std::string &id, MetricFamilyBB &mfbb);
 	void conditional_close(fawkes::Interface *interface) noexcept;
 	void parse_labels(const std::string &labels, io::prometheus::client::Metric *m);
+	void add_loop_timing_metrics(std::list<io::prometheus::client::MetricFamily> &metrics);
+	void set_histogram(io::prometheus::client::Metric *m, const fawkes::LatencyHistogram &h);
 
 private:
 	MetricsRequestProcessor                     *req_proc_;
@@ -137,6 +143,9 @@ private:
 	std::shared_ptr<io::prometheus::client::MetricFamily> imf_metrics_requests_;
 	std::shared_ptr<io::prometheus::client::MetricFamily> imf_metrics_proctime_;
 
+	bool                loop_timing_enabled_;
+	std::vector<double> loop_timing_buckets_;
+
 	std::vector<std::shared_ptr<io::prometheus::client::MetricFamily>> internal_metrics_;
 
 	fawkes::LockList<MetricsSupplier *> metrics_suppliers_;
@@ -22,13 +22,14 @@
 
 #include "mongodb_log_bb_thread.h"
 
+#include "mongodb_log_writer.h"
+
 #include <core/threading/mutex_locker.h>
 #include <plugins/mongodb/aspect/mongodb_conncreator.h>
 
 #include <cstdlib>
 #include <fnmatch.h>
 #include <mongocxx/client.hpp>
-#include <mongocxx/exception/operation_exception.hpp>
 
 using namespace mongocxx;
 using namespace fawkes;
@@ -36,7 +37,9 @@ using namespace fawkes;
 /** @class MongoLogBlackboardThread "mongodb_thread.h"
  * MongoDB Logging Thread.
  * This thread registers to interfaces specified with patterns in the
- * configurationa and logs any changes to MongoDB.
+ * configurationa and logs any changes to MongoDB. Documents are written
+ * asynchronously in batches by a MongoLogWriter, such that the writers
+ * of logged interfaces never wait for the database.
  *
  * @author Tim Niemueller
  */
@@ -63,6 +66,9 @@ MongoLogBlackboardThread::init()
 		logger->log_info(name(), "No database configured, writing to %s", database_.c_str());
 	}
 
+	writer_ =
+	  MongoLogWriter::create("blackboard", database_, config, blackboard, mongodb_connmgr, logger);
+
 	std::vector<std::string> includes;
 	try {
 		includes = config->get_strings("/plugins/mongodb-log/blackboard/includes");
@@ -100,10 +106,9 @@ MongoLogBlackboardThread::init()
 				continue;
 
 			logger->log_debug(name(), "Adding %s", (*i)->uid());
-			client     *mc          = mongodb_connmgr->create_client();
 			std::string agent_name  = config->get_string_or_default("/fawkes/agent/name", "");
 			listeners_[(*i)->uid()] = new InterfaceListener(
-			  blackboard, *i, mc, database_, collections_, agent_name, logger, now_);
+			  blackboard, *i, writer_, collections_, agent_name, logger, now_);
 		}
 	}
 
@@ -117,11 +122,11 @@ MongoLogBlackboardThread::finalize()
 
 	std::map<std::string, InterfaceListener *>::iterator i;
 	for (i = listeners_.begin(); i != listeners_.end(); ++i) {
-		client *mc = i->second->mongodb_client();
 		delete i->second;
-		mongodb_connmgr->delete_client(mc);
 	}
 	listeners_.clear();
+
+	MongoLogWriter::destroy(writer_, mongodb_connmgr);
 }
 
 void
@@ -147,10 +152,9 @@ MongoLogBlackboardThread::bb_interface_created(const char *type, const char *id)
 		Interface *interface = blackboard->open_for_reading(type, id);
 		if (listeners_.find(interface->uid()) == listeners_.end()) {
 			logger->log_debug(name(), "Opening new %s", interface->uid());
-			client     *mc               = mongodb_connmgr->create_client();
 			std::string agent_name       = config->get_string_or_default("/fawkes/agent/name", "");
 			listeners_[interface->uid()] = new InterfaceListener(
-			  blackboard, interface, mc, database_, collections_, agent_name, logger, now_);
+			  blackboard, interface, writer_, collections_, agent_name, logger, now_);
 		} else {
 			logger->log_warn(name(), "Interface %s already opened", interface->uid());
 			blackboard->close(interface);
@@ -164,8 +168,7 @@ MongoLogBlackboardThread::bb_interface_created(const char *type, const char *id)
 /** Constructor.
  * @param blackboard blackboard
  * @param interface interface to listen for
- * @param mongodb MongoDB client to write to
- * @param database name of database to write to
+ * @param writer writer to queue documents with
  * @param colls collections
  * @param agent_name agent belonging to the fawkes instance.
  * @param logger logger
@@ -173,20 +176,18 @@ MongoLogBlackboardThread::bb_interface_created(const char *type, const char *id)
  */
 MongoLogBlackboardThread::InterfaceListener::InterfaceListener(BlackBoard           *blackboard,
                                                                Interface            *interface,
-                                                               client               *mongodb,
-                                                               std::string          &database,
+                                                               MongoLogWriter       *writer,
                                                                LockSet<std::string> &colls,
                                                                const std::string    &agent_name,
                                                                Logger               *logger,
                                                                Time                 *now)
 : BlackBoardInterfaceListener("MongoLogListener-%s", interface->uid()),
-  database_(database),
   collections_(colls),
   agent_name_(agent_name)
 {
 	blackboard_ = blackboard;
 	interface_  = interface;
-	mongodb_    = mongodb;
+	writer_     = writer;
 	logger_     = logger;
 	now_        = now;
 
@@ -407,15 +408,8 @@ MongoLogBlackboardThread::InterfaceListener::bb_interface_data_refreshed(
 		}
 
 		document.append(basic::kvp("agent-name", agent_name_));
-		mongodb_->database(database_)[collection_].insert_one(document.view());
-	} catch (operation_exception &e) {
-		logger_->log_warn(
-		  bbil_name(), "Failed to log to %s.%s: %s", database_.c_str(), collection_.c_str(), e.what());
+		writer_->enqueue(collection_, document.extract());
 	} catch (std::exception &e) {
-		logger_->log_warn(bbil_name(),
-		                  "Failed to log to %s.%s: %s (*)",
-		                  database_.c_str(),
-		                  collection_.c_str(),
-		                  e.what());
+		logger_->log_warn(bbil_name(), "Failed to log to %s: %s (*)", collection_.c_str(), e.what());
 	}
 }
@@ -36,6 +36,8 @@
 
 #include <string>
 
+class MongoLogWriter;
+
 class MongoLogBlackboardThread : public fawkes::Thread,
                                  public fawkes::LoggingAspect,
                                  public fawkes::ConfigurableAspect,
@@ -70,32 +72,22 @@ private:
 	public:
 		InterfaceListener(fawkes::BlackBoard           *blackboard,
 		                  fawkes::Interface            *interface,
-		                  mongocxx::client             *mongodb,
-		                  std::string                  &database,
+		                  MongoLogWriter               *writer,
 		                  fawkes::LockSet<std::string> &colls,
 		                  const std::string            &agent_name,
 		                  fawkes::Logger               *logger,
 		                  fawkes::Time                 *now);
 		~InterfaceListener();
 
-		/** Get MongoDB Client.
-     * @return MongoDB client */
-		mongocxx::client *
-		mongodb_client() const
-		{
-			return mongodb_;
-		}
-
 		// for BlackBoardInterfaceListener
 		virtual void bb_interface_data_refreshed(fawkes::Interface *interface) noexcept;
 
 	private:
 		fawkes::BlackBoard           *blackboard_;
 		fawkes::Interface            *interface_;
-		mongocxx::client             *mongodb_;
+		MongoLogWriter               *writer_;
 		fawkes::Logger               *logger_;
 		std::string                   collection_;
-		std::string                  &database_;
 		fawkes::LockSet<std::string> &collections_;
 		const std::string             agent_name_;
 		fawkes::Time                 *now_;
@@ -106,6 +98,8 @@ private:
 	std::string                                       database_;
 	fawkes::Time                                     *now_;
 
+	MongoLogWriter   *writer_;
+
 	std::vector<std::string> excludes_;
 };
 
@@ -22,14 +22,16 @@
 
 #include "mongodb_log_pcl_thread.h"
 
+#include "mongodb_log_writer.h"
+
 // Fawkes
 #include <core/threading/mutex_locker.h>
+#include <plugins/mongodb/aspect/mongodb_conncreator.h>
 #include <utils/time/wait.h>
 
 // from MongoDB
 #include <fnmatch.h>
 #include <mongocxx/client.hpp>
-#include <mongocxx/exception/operation_exception.hpp>
 #include <mongocxx/gridfs/uploader.hpp>
 #include <unistd.h>
 
@@ -38,6 +40,8 @@ using namespace mongocxx;
 
 /** @class MongoLogPointCloudThread "mongodb_log_pcl_thread.h"
  * Thread to store point clouds to MongoDB.
+ * Point cloud data is uploaded to GridFS, the referencing documents are
+ * written asynchronously in batches by a MongoLogWriter.
  * @author Tim Niemueller
  * @author Bastian Klingen
  */
@@ -95,6 +99,9 @@ MongoLogPointCloudThread::init()
 	gridfs_  = mongodb_->database(database_).gridfs_bucket();
 	//gridfs_->setChunkSize(cfg_chunk_size_);
 
+	writer_ =
+	  MongoLogWriter::create("pointclouds", database_, config, blackboard, mongodb_connmgr, logger);
+
 	adapter_ = new PointCloudAdapter(pcl_manager, logger);
 
 	std::vector<std::string> pcls = pcl_manager->get_pointcloud_list();
@@ -174,6 +181,8 @@ MongoLogPointCloudThread::prepare_finalize_user()
 void
 MongoLogPointCloudThread::finalize()
 {
+	MongoLogWriter::destroy(writer_, mongodb_connmgr);
+
 	delete adapter_;
 	delete wait_;
 	delete mutex_;
@@ -235,14 +244,8 @@ MongoLogPointCloudThread::loop()
 				}));
 			}));
 
-			try {
-				mongodb_->database(database_)[pi.topic_name].insert_one(document.view());
+			if (writer_->enqueue(pi.topic_name, document.extract())) {
 				++num_stored;
-			} catch (operation_exception &e) {
-				logger->log_warn(this->name(),
-				                 "Failed to insert into %s: %s",
-				                 collection_.c_str(),
-				                 e.what());
 			}
 
 			fawkes::Time end(clock);
@@ -268,7 +271,8 @@ MongoLogPointCloudThread::loop()
 	                  (loop_end - &loop_start) * 1000.);
 
 	if (cfg_flush_after_write_) {
-		// flush database
+		// write queued documents, then flush database
+		writer_->flush();
 		using namespace bsoncxx::builder;
 		basic::document flush_cmd;
 		flush_cmd.append(basic::kvp("fsync", 1));
@@ -23,6 +23,7 @@
 #ifndef _PLUGINS_MONGODB_LOG_MONGODB_LOG_PCL_THREAD_H_
 #define _PLUGINS_MONGODB_LOG_MONGODB_LOG_PCL_THREAD_H_
 
+#include <aspect/blackboard.h>
 #include <aspect/clock.h>
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
@@ -50,10 +51,13 @@ class Mutex;
 class TimeWait;
 } // namespace fawkes
 
+class MongoLogWriter;
+
 class MongoLogPointCloudThread : public fawkes::Thread,
                                  public fawkes::ClockAspect,
                                  public fawkes::LoggingAspect,
                                  public fawkes::ConfigurableAspect,
+                                 public fawkes::BlackBoardAspect,
                                  public fawkes::PointCloudAspect,
                                  public fawkes::MongoDBAspect
 {
@@ -99,6 +103,8 @@ private:
 	fawkes::Mutex    *mutex_;
 	fawkes::TimeWait *wait_;
 
+	MongoLogWriter   *writer_;
+
 	bool         cfg_flush_after_write_;
 	unsigned int cfg_chunk_size_;
 	float        cfg_storage_interval_;
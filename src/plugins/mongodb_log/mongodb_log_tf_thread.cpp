@@ -21,6 +21,8 @@
 
 #include "mongodb_log_tf_thread.h"
 
+#include "mongodb_log_writer.h"
+
 #include <core/threading/mutex_locker.h>
 #include <plugins/mongodb/aspect/mongodb_conncreator.h>
 #include <tf/time_cache.h>
@@ -29,7 +31,6 @@
 #include <bsoncxx/builder/basic/document.hpp>
 #include <cstdlib>
 #include <mongocxx/client.hpp>
-#include <mongocxx/exception/operation_exception.hpp>
 
 using namespace mongocxx;
 using namespace fawkes;
@@ -37,7 +38,8 @@ using namespace fawkes;
 /** @class MongoLogTransformsThread "mongodb_log_tf_thread.h"
  * MongoDB transforms logging thread.
  * This thread periodically queries the transformer for recent transforms
- * and stores them to the database.
+ * and stores them to the database. Documents are written asynchronously
+ * in batches by a MongoLogWriter.
  *
  * @author Tim Niemueller
  */
@@ -81,6 +83,9 @@ MongoLogTransformsThread::init()
 		cfg_storage_interval_ = tf_listener->get_cache_time() * 0.5;
 	}
 
+	writer_ =
+	  MongoLogWriter::create("transforms", database_, config, blackboard, mongodb_connmgr, logger);
+
 	wait_  = new TimeWait(clock, cfg_storage_interval_ * 1000000.);
 	mutex_ = new Mutex();
 }
@@ -95,6 +100,8 @@ MongoLogTransformsThread::prepare_finalize_user()
 void
 MongoLogTransformsThread::finalize()
 {
+	MongoLogWriter::destroy(writer_, mongodb_connmgr);
+
 	delete wait_;
 	delete mutex_;
 }
@@ -230,14 +237,6 @@ MongoLogTransformsThread::store(std::vector<tf::TimeCacheInterfacePtr> &caches,
 			}
 		}));
 
-		try {
-			mongodb_client->database(database_)[collection_].insert_one(document.view());
-		} catch (operation_exception &e) {
-			logger->log_warn(name(), "Inserting TF failed: %s", e.what());
-
-		} catch (std::exception &e) {
-			// for old and broken compilers
-			logger->log_warn(name(), "Inserting TF failed: %s (*)", e.what());
-		}
+		writer_->enqueue(collection_, document.extract());
 	}
 }
@@ -38,6 +38,8 @@ namespace fawkes {
 class TimeWait;
 }
 
+class MongoLogWriter;
+
 class MongoLogTransformsThread : public fawkes::Thread,
                                  public fawkes::LoggingAspect,
                                  public fawkes::ConfigurableAspect,
@@ -75,6 +77,8 @@ private:
 	std::string               collection_;
 	float                     cfg_storage_interval_;
 	std::vector<fawkes::Time> last_tf_range_end_;
+
+	MongoLogWriter   *writer_;
 };
 
 #endif
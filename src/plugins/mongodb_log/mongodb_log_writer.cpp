@@ -0,0 +1,615 @@
+/***************************************************************************
+ *  mongodb_log_writer.cpp - MongoDB batched asynchronous writer
+ *
+ *  Created: Sun Oct 18 14:12:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "mongodb_log_writer.h"
+
+#include <blackboard/blackboard.h>
+#include <config/config.h>
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+#include <interfaces/MetricCounterInterface.h>
+#include <interfaces/MetricFamilyInterface.h>
+#include <interfaces/MetricGaugeInterface.h>
+#include <logging/logger.h>
+#include <plugins/mongodb/aspect/mongodb_conncreator.h>
+
+#include <algorithm>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/bulk_write_exception.hpp>
+#include <mongocxx/exception/operation_exception.hpp>
+#include <mongocxx/options/insert.hpp>
+
+using namespace fawkes;
+
+/** Minimum time between two log messages about dropped documents; sec. */
+#define DROP_REPORT_INTERVAL 5.0
+/** Time between two updates of metrics and drop reports; sec. */
+#define REPORT_INTERVAL 1.0
+
+/** Wait on a condition for a limited time.
+ * @param cond wait condition, its mutex must be locked
+ * @param timeout maximum time to wait
+ * @return false if the wait timed out, true otherwise
+ */
+static bool
+timed_wait(WaitCondition *cond, std::chrono::steady_clock::duration timeout)
+{
+	if (timeout <= std::chrono::steady_clock::duration::zero())
+		return false;
+	long long int nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+	return cond->reltimed_wait(nsec / 1000000000, nsec % 1000000000);
+}
+
+/** Get path of a writer setting.
+ * @param config configuration to query
+ * @param logger_name name of the logger
+ * @param key setting key
+ * @return path of the logger-specific setting if it exists, path of the
+ * plugin-wide default otherwise
+ */
+static std::string
+setting_path(Configuration *config, const std::string &logger_name, const char *key)
+{
+	std::string path = "/plugins/mongodb-log/" + logger_name + "/writer/" + key;
+	if (config->exists(path)) {
+		return path;
+	}
+	return std::string("/plugins/mongodb-log/writer/") + key;
+}
+
+/** @class MongoLogWriter "mongodb_log_writer.h"
+ * Batched asynchronous MongoDB writer.
+ * Logging threads hand documents to the writer instead of inserting
+ * them directly. Each collection has a bounded queue, which the writer
+ * thread empties with batched inserts once the batch size is reached or
+ * the oldest queued document exceeds the flush interval. If a queue is
+ * full, the drop policy decides whether the oldest or the new document
+ * is discarded, or whether the producer blocks for a limited time.
+ *
+ * The writer exclusively uses the given client from its own thread. It
+ * must be started with start() and terminated with stop(), which writes
+ * all documents still queued.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param logger_name name of the logger, used for the thread name, log
+ * messages, and metrics
+ * @param client MongoDB client to write with, only used by the writer thread
+ * @param database name of database to write to
+ * @param settings queueing and batching settings
+ * @param logger logger for errors and drop reports
+ */
+MongoLogWriter::MongoLogWriter(const std::string &logger_name,
+                               mongocxx::client  *client,
+                               const std::string &database,
+                               const Settings    &settings,
+                               Logger            *logger)
+: Thread("MongoLogWriter", Thread::OPMODE_CONTINUOUS),
+  logger_name_(logger_name),
+  client_(client),
+  database_(database),
+  settings_(settings),
+  logger_(logger)
+{
+	set_name("MongoLogWriter-%s", logger_name.c_str());
+
+	if (settings_.queue_size == 0)
+		settings_.queue_size = 1;
+	if (settings_.batch_size == 0)
+		settings_.batch_size = 1;
+
+	mutex_        = new Mutex();
+	queue_cond_   = new WaitCondition(mutex_);
+	space_cond_   = new WaitCondition(mutex_);
+	flushed_cond_ = new WaitCondition(mutex_);
+
+	stats_           = Statistics{0, 0, 0, 0, 0, 0, 0};
+	in_flight_       = 0;
+	flush_requested_ = false;
+	quit_            = false;
+
+	last_reported_dropped_ = 0;
+	last_drop_report_      = std::chrono::steady_clock::now();
+	next_report_           = last_drop_report_;
+
+	blackboard_          = NULL;
+	documents_family_if_ = NULL;
+	queue_family_if_     = NULL;
+	written_if_          = NULL;
+	dropped_if_          = NULL;
+	failed_if_           = NULL;
+	queued_if_           = NULL;
+	high_water_if_       = NULL;
+}
+
+/** Destructor. */
+MongoLogWriter::~MongoLogWriter()
+{
+	close_metrics();
+	delete queue_cond_;
+	delete space_cond_;
+	delete flushed_cond_;
+	delete mutex_;
+}
+
+/** Create and start a writer for a logger thread.
+ * Reads the settings of the logger, creates a dedicated client for the
+ * writer thread, opens the metric interfaces if enabled, and starts the
+ * writer. Release the writer with destroy().
+ * @param logger_name name of the logger, i.e., its configuration section
+ * @param database name of database to write to
+ * @param config configuration to read settings from
+ * @param blackboard blackboard to open metric interfaces on
+ * @param connmgr connection creator to create the writer client with
+ * @param logger logger for errors and drop reports
+ * @return running writer
+ */
+MongoLogWriter *
+MongoLogWriter::create(const std::string  &logger_name,
+                       const std::string  &database,
+                       Configuration      *config,
+                       BlackBoard         *blackboard,
+                       MongoDBConnCreator *connmgr,
+                       Logger             *logger)
+{
+	Settings          settings = read_settings(config, logger_name);
+	mongocxx::client *client   = connmgr->create_client();
+	MongoLogWriter   *writer   = new MongoLogWriter(logger_name, client, database, settings, logger);
+	if (settings.metrics) {
+		try {
+			writer->open_metrics(blackboard);
+		} catch (Exception &e) {
+			logger->log_warn(writer->name(), "Failed to open writer metrics, exception follows");
+			logger->log_warn(writer->name(), e);
+		}
+	}
+	writer->start();
+	return writer;
+}
+
+/** Stop and delete a writer created with create().
+ * All queued documents are written before the writer is deleted.
+ * @param writer writer to destroy
+ * @param connmgr connection creator the writer was created with
+ */
+void
+MongoLogWriter::destroy(MongoLogWriter *writer, MongoDBConnCreator *connmgr)
+{
+	mongocxx::client *client = writer->client_;
+	writer->stop();
+	writer->close_metrics();
+	delete writer;
+	connmgr->delete_client(client);
+}
+
+/** Read writer settings from the configuration.
+ * Settings are read from /plugins/mongodb-log/LOGGER/writer/ and fall
+ * back to the plugin-wide defaults in /plugins/mongodb-log/writer/.
+ * @param config configuration to read from
+ * @param logger_name name of the logger, i.e., its configuration section
+ * @return settings
+ * @exception Exception thrown if an invalid drop policy is configured
+ */
+MongoLogWriter::Settings
+MongoLogWriter::read_settings(Configuration *config, const std::string &logger_name)
+{
+	Settings s;
+	s.queue_size =
+	  config->get_uint_or_default(setting_path(config, logger_name, "queue-size").c_str(), 1000);
+	s.batch_size =
+	  config->get_uint_or_default(setting_path(config, logger_name, "batch-size").c_str(), 100);
+	s.flush_interval =
+	  config->get_float_or_default(setting_path(config, logger_name, "flush-interval").c_str(), 0.5);
+	s.block_timeout =
+	  config->get_float_or_default(setting_path(config, logger_name, "block-timeout").c_str(), 0.1);
+	s.metrics =
+	  config->get_bool_or_default(setting_path(config, logger_name, "metrics").c_str(), true);
+
+	std::string policy =
+	  config->get_string_or_default(setting_path(config, logger_name, "drop-policy").c_str(),
+	                                "drop-oldest");
+	if (policy == "drop-oldest") {
+		s.drop_policy = DROP_OLDEST;
+	} else if (policy == "drop-newest") {
+		s.drop_policy = DROP_NEWEST;
+	} else if (policy == "block") {
+		s.drop_policy = BLOCK;
+	} else {
+		throw Exception("Invalid drop policy '%s' for %s, must be drop-oldest, drop-newest, or block",
+		                policy.c_str(),
+		                logger_name.c_str());
+	}
+	return s;
+}
+
+/** Enqueue a document for writing.
+ * This only blocks if the queue of the collection is full and the drop
+ * policy is BLOCK, and then at most for the configured block timeout.
+ * @param collection name of collection to write to
+ * @param document document to write
+ * @return true if the document has been queued, false if it was dropped
+ */
+bool
+MongoLogWriter::enqueue(const std::string &collection, bsoncxx::document::value document)
+{
+	MutexLocker lock(mutex_);
+	if (quit_) {
+		stats_.dropped += 1;
+		return false;
+	}
+
+	CollectionQueue &q = queues_[collection];
+	if (q.documents.size() >= settings_.queue_size) {
+		switch (settings_.drop_policy) {
+		case DROP_OLDEST:
+			q.documents.pop_front();
+			stats_.queued -= 1;
+			stats_.dropped += 1;
+			break;
+
+		case DROP_NEWEST: stats_.dropped += 1; return false;
+
+		case BLOCK: {
+			auto deadline = std::chrono::steady_clock::now()
+			                + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			                  std::chrono::duration<float>(settings_.block_timeout));
+			while (q.documents.size() >= settings_.queue_size && !quit_) {
+				queue_cond_->wake_all();
+				if (!timed_wait(space_cond_, deadline - std::chrono::steady_clock::now())) {
+					break;
+				}
+			}
+			if (q.documents.size() >= settings_.queue_size || quit_) {
+				stats_.dropped += 1;
+				return false;
+			}
+		} break;
+		}
+	}
+
+	q.documents.push_back({std::move(document), std::chrono::steady_clock::now()});
+	stats_.enqueued += 1;
+	stats_.queued += 1;
+	stats_.high_water =
+	  std::max(stats_.high_water, static_cast<unsigned int>(q.documents.size()));
+
+	// wake up to schedule the flush of a previously empty queue, or to
+	// write a complete batch right away
+	if (q.documents.size() == 1 || q.documents.size() >= settings_.batch_size) {
+		queue_cond_->wake_all();
+	}
+	return true;
+}
+
+/** Write all queued documents.
+ * Blocks until all documents queued at the time of the call (and any
+ * enqueued meanwhile) have been written or failed.
+ */
+void
+MongoLogWriter::flush()
+{
+	MutexLocker lock(mutex_);
+	while ((stats_.queued > 0 || in_flight_ > 0) && !quit_) {
+		flush_requested_ = true;
+		queue_cond_->wake_all();
+		flushed_cond_->wait();
+	}
+}
+
+/** Write remaining documents and stop the writer thread.
+ * Producers blocked on a full queue are released and their documents
+ * dropped. Returns after the writer thread has terminated.
+ */
+void
+MongoLogWriter::stop()
+{
+	mutex_->lock();
+	quit_ = true;
+	queue_cond_->wake_all();
+	space_cond_->wake_all();
+	flushed_cond_->wake_all();
+	mutex_->unlock();
+	if (started()) {
+		join();
+	}
+}
+
+/** Get current statistics.
+ * @return statistics accumulated since construction
+ */
+MongoLogWriter::Statistics
+MongoLogWriter::statistics() const
+{
+	MutexLocker lock(mutex_);
+	return stats_;
+}
+
+/** Open metric interfaces.
+ * The writer publishes the number of written, dropped, and failed
+ * documents as counter, and the number of queued documents and the
+ * queue high-water mark as gauge. Call before start().
+ * @param blackboard blackboard to open interfaces on
+ */
+void
+MongoLogWriter::open_metrics(BlackBoard *blackboard)
+{
+	close_metrics();
+
+	std::string prefix      = "mongodb-log/" + logger_name_;
+	std::string metric_name = "fawkes_mongodb_log_" + logger_name_;
+
+	blackboard_ = blackboard;
+	try {
+		// the data interfaces must exist before the families are announced
+		std::string documents_id = prefix + "/documents";
+		written_if_ =
+		  blackboard_->open_for_writing<MetricCounterInterface>((documents_id + "/written").c_str());
+		dropped_if_ =
+		  blackboard_->open_for_writing<MetricCounterInterface>((documents_id + "/dropped").c_str());
+		failed_if_ =
+		  blackboard_->open_for_writing<MetricCounterInterface>((documents_id + "/failed").c_str());
+		written_if_->set_labels("result=written");
+		dropped_if_->set_labels("result=dropped");
+		failed_if_->set_labels("result=failed");
+		written_if_->write();
+		dropped_if_->write();
+		failed_if_->write();
+
+		queued_if_ =
+		  blackboard_->open_for_writing<MetricGaugeInterface>((prefix + "/queue/length").c_str());
+		high_water_if_ =
+		  blackboard_->open_for_writing<MetricGaugeInterface>((prefix + "/queue/high_water").c_str());
+		queued_if_->set_labels("stat=length");
+		high_water_if_->set_labels("stat=high_water");
+		queued_if_->write();
+		high_water_if_->write();
+
+		documents_family_if_ =
+		  blackboard_->open_for_writing<MetricFamilyInterface>(documents_id.c_str());
+		documents_family_if_->set_name((metric_name + "_documents").c_str());
+		documents_family_if_->set_help(
+		  ("Documents handled by the " + logger_name_ + " logger by result").c_str());
+		documents_family_if_->set_metric_type(MetricFamilyInterface::COUNTER);
+		documents_family_if_->write();
+
+		queue_family_if_ =
+		  blackboard_->open_for_writing<MetricFamilyInterface>((prefix + "/queue").c_str());
+		queue_family_if_->set_name((metric_name + "_queue").c_str());
+		queue_family_if_->set_help(
+		  ("Queued documents of the " + logger_name_ + " logger and queue high-water mark").c_str());
+		queue_family_if_->set_metric_type(MetricFamilyInterface::GAUGE);
+		queue_family_if_->write();
+	} catch (Exception &e) {
+		close_metrics();
+		throw;
+	}
+}
+
+/** Close metric interfaces. */
+void
+MongoLogWriter::close_metrics()
+{
+	if (!blackboard_)
+		return;
+
+	blackboard_->close(documents_family_if_);
+	blackboard_->close(queue_family_if_);
+	blackboard_->close(written_if_);
+	blackboard_->close(dropped_if_);
+	blackboard_->close(failed_if_);
+	blackboard_->close(queued_if_);
+	blackboard_->close(high_water_if_);
+	documents_family_if_ = NULL;
+	queue_family_if_     = NULL;
+	written_if_          = NULL;
+	dropped_if_          = NULL;
+	failed_if_           = NULL;
+	queued_if_           = NULL;
+	high_water_if_       = NULL;
+	blackboard_          = NULL;
+}
+
+void
+MongoLogWriter::publish_metrics(const Statistics &stats)
+{
+	if (!written_if_)
+		return;
+
+	written_if_->set_value(stats.written);
+	dropped_if_->set_value(stats.dropped);
+	failed_if_->set_value(stats.failed);
+	queued_if_->set_value(stats.queued);
+	high_water_if_->set_value(stats.high_water);
+	written_if_->write();
+	dropped_if_->write();
+	failed_if_->write();
+	queued_if_->write();
+	high_water_if_->write();
+}
+
+void
+MongoLogWriter::write_batch(const std::string                     &collection,
+                            std::vector<bsoncxx::document::value> &batch,
+                            unsigned long int                     &written)
+{
+	written = 0;
+	try {
+		mongocxx::options::insert opts;
+		opts.ordered(false);
+		auto result = client_->database(database_)[collection].insert_many(batch, opts);
+		written     = result ? result->inserted_count() : batch.size();
+	} catch (mongocxx::bulk_write_exception &e) {
+		// unordered inserts continue after errors, count what made it
+		if (e.raw_server_error()) {
+			auto n = e.raw_server_error()->view()["nInserted"];
+			if (n && n.type() == bsoncxx::type::k_int32) {
+				written = n.get_int32();
+			}
+		}
+		logger_->log_warn(name(),
+		                  "Failed to write %zu of %zu documents to %s.%s: %s",
+		                  batch.size() - written,
+		                  batch.size(),
+		                  database_.c_str(),
+		                  collection.c_str(),
+		                  e.what());
+	} catch (mongocxx::operation_exception &e) {
+		logger_->log_warn(name(),
+		                  "Failed to write %zu documents to %s.%s: %s",
+		                  batch.size(),
+		                  database_.c_str(),
+		                  collection.c_str(),
+		                  e.what());
+	} catch (std::exception &e) {
+		logger_->log_warn(name(),
+		                  "Failed to write %zu documents to %s.%s: %s (*)",
+		                  batch.size(),
+		                  database_.c_str(),
+		                  collection.c_str(),
+		                  e.what());
+	}
+}
+
+void
+MongoLogWriter::report(const Statistics &stats, std::chrono::steady_clock::time_point now)
+{
+	publish_metrics(stats);
+	if (stats.dropped > last_reported_dropped_
+	    && now - last_drop_report_ >= std::chrono::duration<float>(DROP_REPORT_INTERVAL)) {
+		logger_->log_warn(name(),
+		                  "Dropped %lu documents on full queues (%lu total)",
+		                  stats.dropped - last_reported_dropped_,
+		                  stats.dropped);
+		last_reported_dropped_ = stats.dropped;
+		last_drop_report_      = now;
+	}
+}
+
+void
+MongoLogWriter::run()
+{
+	const auto flush_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+	  std::chrono::duration<float>(settings_.flush_interval));
+	const auto report_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+	  std::chrono::duration<float>(REPORT_INTERVAL));
+
+	std::vector<bsoncxx::document::value> batch;
+	batch.reserve(settings_.batch_size);
+
+	mutex_->lock();
+	while (true) {
+		auto now = std::chrono::steady_clock::now();
+
+		// report periodically, also while queues are continuously due
+		if (now >= next_report_) {
+			next_report_     = now + report_interval;
+			Statistics stats = stats_;
+			mutex_->unlock();
+			report(stats, now);
+			mutex_->lock();
+			continue;
+		}
+
+		// of the queues which have a full batch, exceeded the flush
+		// interval, or must be emptied for a flush or stop, write the one
+		// with the oldest document first such that no collection starves
+		auto due = queues_.end();
+		for (auto q = queues_.begin(); q != queues_.end(); ++q) {
+			const CollectionQueue &cq = q->second;
+			if (cq.documents.empty())
+				continue;
+			if (quit_ || flush_requested_ || cq.documents.size() >= settings_.batch_size
+			    || now - cq.documents.front().enqueued >= flush_interval) {
+				if (due == queues_.end()
+				    || cq.documents.front().enqueued < due->second.documents.front().enqueued) {
+					due = q;
+				}
+			}
+		}
+
+		if (due != queues_.end()) {
+			CollectionQueue &cq = due->second;
+			size_t           n  = std::min<size_t>(cq.documents.size(), settings_.batch_size);
+			for (size_t i = 0; i < n; ++i) {
+				batch.push_back(std::move(cq.documents.front().document));
+				cq.documents.pop_front();
+			}
+			stats_.queued -= n;
+			in_flight_ = n;
+			space_cond_->wake_all();
+			mutex_->unlock();
+
+			unsigned long int written = 0;
+			write_batch(due->first, batch, written);
+			batch.clear();
+
+			mutex_->lock();
+			stats_.written += written;
+			stats_.failed += n - written;
+			stats_.batches += 1;
+			in_flight_ = 0;
+			if (quit_ && written == 0 && stats_.queued > 0) {
+				// do not hold up stopping with a database that cannot be reached
+				logger_->log_warn(name(), "Discarding %u queued documents", stats_.queued);
+				for (auto &q : queues_) {
+					q.second.documents.clear();
+				}
+				stats_.failed += stats_.queued;
+				stats_.queued = 0;
+			}
+			flushed_cond_->wake_all();
+			continue;
+		}
+
+		if (quit_)
+			break;
+
+		flush_requested_ = false;
+		flushed_cond_->wake_all();
+
+		// sleep until the oldest queued document is due or the next report,
+		// a producer signals a new queue or a full batch, or flush() or stop()
+		auto timeout = next_report_ - now;
+		for (const auto &q : queues_) {
+			if (!q.second.documents.empty()) {
+				timeout = std::min(timeout, q.second.documents.front().enqueued + flush_interval - now);
+			}
+		}
+		timed_wait(queue_cond_, timeout);
+	}
+
+	Statistics stats = stats_;
+	flushed_cond_->wake_all();
+	mutex_->unlock();
+	publish_metrics(stats);
+
+	logger_->log_info(name(),
+	                  "Wrote %lu documents in %lu batches, %lu dropped, %lu failed, "
+	                  "queue high-water mark %u",
+	                  stats.written,
+	                  stats.batches,
+	                  stats.dropped,
+	                  stats.failed,
+	                  stats.high_water);
+}
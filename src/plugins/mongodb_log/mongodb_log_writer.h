@@ -0,0 +1,164 @@
+
+/***************************************************************************
+ *  mongodb_log_writer.h - MongoDB batched asynchronous writer
+ *
+ *  Created: Sun Oct 18 14:12:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_MONGODB_LOG_MONGODB_LOG_WRITER_H_
+#define _PLUGINS_MONGODB_LOG_MONGODB_LOG_WRITER_H_
+
+#include <core/threading/thread.h>
+
+#include <bsoncxx/document/value.hpp>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mongocxx {
+class client;
+}
+
+namespace fawkes {
+class BlackBoard;
+class Configuration;
+class Logger;
+class Mutex;
+class WaitCondition;
+class MetricFamilyInterface;
+class MetricCounterInterface;
+class MetricGaugeInterface;
+class MongoDBConnCreator;
+} // namespace fawkes
+
+class MongoLogWriter : public fawkes::Thread
+{
+public:
+	/** Policy applied when a collection queue is full. */
+	typedef enum {
+		DROP_OLDEST, ///< discard the oldest queued document
+		DROP_NEWEST, ///< discard the document to be enqueued
+		BLOCK        ///< block the producer until space is available
+	} DropPolicy;
+
+	/** Queueing and batching settings. */
+	typedef struct
+	{
+		unsigned int queue_size;     ///< maximum number of queued documents per collection
+		unsigned int batch_size;     ///< maximum number of documents per insert
+		float        flush_interval; ///< maximum time a document is queued; sec
+		DropPolicy   drop_policy;    ///< policy applied when a queue is full
+		float        block_timeout;  ///< maximum time to block with BLOCK policy; sec
+		bool         metrics;        ///< publish statistics as metrics
+	} Settings;
+
+	/** Write statistics, accumulated over all collections. */
+	typedef struct
+	{
+		unsigned long int enqueued;   ///< number of documents accepted for writing
+		unsigned long int written;    ///< number of documents written
+		unsigned long int dropped;    ///< number of documents dropped on full queue
+		unsigned long int failed;     ///< number of documents failed to write
+		unsigned long int batches;    ///< number of insert operations
+		unsigned int      queued;     ///< number of documents currently queued
+		unsigned int      high_water; ///< maximum number of documents in a single queue
+	} Statistics;
+
+	MongoLogWriter(const std::string &logger_name,
+	               mongocxx::client  *client,
+	               const std::string &database,
+	               const Settings    &settings,
+	               fawkes::Logger    *logger);
+	virtual ~MongoLogWriter();
+
+	static Settings read_settings(fawkes::Configuration *config, const std::string &logger_name);
+
+	static MongoLogWriter *create(const std::string          &logger_name,
+	                              const std::string          &database,
+	                              fawkes::Configuration      *config,
+	                              fawkes::BlackBoard         *blackboard,
+	                              fawkes::MongoDBConnCreator *connmgr,
+	                              fawkes::Logger             *logger);
+	static void            destroy(MongoLogWriter *writer, fawkes::MongoDBConnCreator *connmgr);
+
+	bool enqueue(const std::string &collection, bsoncxx::document::value document);
+	void flush();
+	void stop();
+
+	Statistics statistics() const;
+
+	void open_metrics(fawkes::BlackBoard *blackboard);
+	void close_metrics();
+
+protected:
+	virtual void run();
+
+private:
+	/// @cond INTERNALS
+	struct QueuedDocument
+	{
+		bsoncxx::document::value              document;
+		std::chrono::steady_clock::time_point enqueued;
+	};
+	struct CollectionQueue
+	{
+		std::deque<QueuedDocument> documents;
+	};
+	/// @endcond
+
+	void write_batch(const std::string                     &collection,
+	                 std::vector<bsoncxx::document::value> &batch,
+	                 unsigned long int                     &written);
+	void publish_metrics(const Statistics &stats);
+	void report(const Statistics &stats, std::chrono::steady_clock::time_point now);
+
+private:
+	std::string       logger_name_;
+	mongocxx::client *client_;
+	std::string       database_;
+	Settings          settings_;
+	fawkes::Logger   *logger_;
+
+	fawkes::Mutex         *mutex_;
+	fawkes::WaitCondition *queue_cond_;
+	fawkes::WaitCondition *space_cond_;
+	fawkes::WaitCondition *flushed_cond_;
+
+	std::map<std::string, CollectionQueue> queues_;
+	Statistics                             stats_;
+	unsigned int                           in_flight_;
+	bool                                   flush_requested_;
+	bool                                   quit_;
+
+	unsigned long int                     last_reported_dropped_;
+	std::chrono::steady_clock::time_point last_drop_report_;
+	std::chrono::steady_clock::time_point next_report_;
+
+	fawkes::BlackBoard             *blackboard_;
+	fawkes::MetricFamilyInterface  *documents_family_if_;
+	fawkes::MetricFamilyInterface  *queue_family_if_;
+	fawkes::MetricCounterInterface *written_if_;
+	fawkes::MetricCounterInterface *dropped_if_;
+	fawkes::MetricCounterInterface *failed_if_;
+	fawkes::MetricGaugeInterface   *queued_if_;
+	fawkes::MetricGaugeInterface   *high_water_if_;
+};
+
+#endif
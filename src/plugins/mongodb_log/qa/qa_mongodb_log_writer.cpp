@@ -0,0 +1,123 @@
+/***************************************************************************
+ *  qa_mongodb_log_writer.cpp - QA for batched MongoDB writer
+ *
+ *  Created: Sun Oct 18 15:02:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include "../mongodb_log_writer.h"
+
+#include <core/threading/thread.h>
+#include <logging/console.h>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <cstdio>
+#include <mongocxx/client.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/uri.hpp>
+
+using namespace fawkes;
+
+static const char *DATABASE = "fflog_qa";
+
+static bool
+test_policy(mongocxx::client          &client,
+            Logger                    *logger,
+            const char                *policy_name,
+            MongoLogWriter::DropPolicy policy,
+            unsigned int               num_docs)
+{
+	std::string collection = std::string("writer_") + policy_name;
+	client[DATABASE][collection].drop();
+
+	MongoLogWriter::Settings settings;
+	settings.queue_size     = 100;
+	settings.batch_size     = 25;
+	settings.flush_interval = 0.1;
+	settings.drop_policy    = policy;
+	settings.block_timeout  = 1.0;
+	settings.metrics        = false;
+
+	MongoLogWriter writer(policy_name, &client, DATABASE, settings, logger);
+	writer.start();
+	for (unsigned int i = 0; i < num_docs; ++i) {
+		using namespace bsoncxx::builder;
+		basic::document document;
+		document.append(basic::kvp("seq", static_cast<int32_t>(i)));
+		writer.enqueue(collection, document.extract());
+	}
+	writer.flush();
+	writer.stop();
+
+	MongoLogWriter::Statistics stats = writer.statistics();
+
+	bsoncxx::builder::basic::document filter;
+	int64_t stored = client[DATABASE][collection].count_documents(filter.view());
+
+	printf("%-12s  enqueued %6lu  written %6lu  dropped %6lu  failed %6lu  "
+	       "batches %5lu  high-water %4u  stored %6li\n",
+	       policy_name,
+	       stats.enqueued,
+	       stats.written,
+	       stats.dropped,
+	       stats.failed,
+	       stats.batches,
+	       stats.high_water,
+	       static_cast<long int>(stored));
+
+	bool ok = (stats.failed == 0) && (stats.queued == 0)
+	          && (stats.written == static_cast<unsigned long int>(stored))
+	          && (stats.high_water <= settings.queue_size);
+	if (policy == MongoLogWriter::DROP_OLDEST) {
+		// dropping the oldest accepts every document first
+		ok = ok && (stats.enqueued == num_docs) && (stats.written + stats.dropped == num_docs);
+	} else {
+		ok = ok && (stats.enqueued + stats.dropped == num_docs) && (stats.written == stats.enqueued);
+	}
+	if (policy == MongoLogWriter::BLOCK) {
+		// a local mongod keeps up within the block timeout
+		ok = ok && (stats.dropped == 0);
+	}
+	return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+	Thread::init_main();
+
+	mongocxx::instance instance{};
+	mongocxx::client   client(mongocxx::uri(argc > 1 ? argv[1] : "mongodb://localhost:27017"));
+	ConsoleLogger      logger(Logger::LL_INFO);
+
+	unsigned int num_docs = 10000;
+
+	bool ok = true;
+	ok &= test_policy(client, &logger, "drop_oldest", MongoLogWriter::DROP_OLDEST, num_docs);
+	ok &= test_policy(client, &logger, "drop_newest", MongoLogWriter::DROP_NEWEST, num_docs);
+	ok &= test_policy(client, &logger, "block", MongoLogWriter::BLOCK, num_docs);
+
+	client[DATABASE].drop();
+	printf("%s\n", ok ? "PASSED" : "FAILED");
+
+	Thread::destroy_main();
+	return ok ? 0 : 1;
+}
+
+/// @endcond
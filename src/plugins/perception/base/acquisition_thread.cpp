@@ -23,6 +23,7 @@
 #include "acquisition_thread.h"
 
 #include "aqt_vision_threads.h"
+#include "capture_thread.h"
 
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
@@ -90,6 +91,9 @@ FvAcquisitionThread::FvAcquisitionThread(const char *id,
 	mode_    = AqtContinuous;
 	enabled_ = false;
 
+	async_queue_length_ = 0;
+	capture_thread_     = NULL;
+
 #ifdef FVBASE_TIMETRACKER
 	tt_          = new TimeTracker();
 	loop_count_  = 0;
@@ -98,6 +102,7 @@ FvAcquisitionThread::FvAcquisitionThread(const char *id,
 	ttc_convert_ = tt_->add_class("Convert");
 	ttc_unlock_  = tt_->add_class("Unlock");
 	ttc_dispose_ = tt_->add_class("Dispose");
+	ttc_publish_ = tt_->add_class("Publish");
 #endif
 }
 
@@ -131,15 +136,51 @@ FvAcquisitionThread::init()
 
 	bbil_add_message_interface(enabled_if_);
 	blackboard->register_listener(this, BlackBoard::BBIL_FLAG_MESSAGES);
+
+	if (async_queue_length_ > 0) {
+		logger->log_debug(name(),
+		                  "Asynchronous acquisition with %u frames in queue",
+		                  async_queue_length_);
+		capture_thread_ = new FvCaptureThread(image_id_, camera_, logger, async_queue_length_);
+		for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
+			capture_thread_->add_colorspace(shmit_->first);
+		}
+		capture_thread_->set_enabled(enabled_);
+		capture_thread_->start();
+	}
 }
 
 void
 FvAcquisitionThread::finalize()
 {
+	if (capture_thread_) {
+		capture_thread_->cancel();
+		capture_thread_->join();
+		delete capture_thread_;
+		capture_thread_ = NULL;
+	}
 	blackboard->unregister_listener(this);
 	blackboard->close(enabled_if_);
 }
 
+/** Enable asynchronous acquisition.
+ * In asynchronous mode images are captured and converted by a separate
+ * capture thread into a queue of frames. The acquisition thread then only
+ * publishes the newest complete frame to the shared memory buffers. Raw
+ * camera access is not possible in this mode. Must be called before the
+ * thread is initialized.
+ * @param queue_length number of frames in the capture queue, at least 2,
+ * 0 to disable asynchronous acquisition
+ */
+void
+FvAcquisitionThread::set_async(unsigned int queue_length)
+{
+	if ((queue_length > 0) && (queue_length < 2)) {
+		throw OutOfBoundsException("Capture queue length", queue_length, 2, 0xFFFFFFFF);
+	}
+	async_queue_length_ = queue_length;
+}
+
 /** Get a camera instance.
  * This will return a camera instance suitable for accessing the image
  * buffer. Note, that this is not the camera provided to the constructor,
@@ -179,7 +220,9 @@ FvAcquisitionThread::camera_instance(colorspace_t cspace, bool deep_copy)
 	const char *img_id = NULL;
 
 	if (cspace == CS_UNKNOWN) {
-		if (raw_subscriber_thread) {
+		if (async_queue_length_ > 0) {
+			throw Exception("Raw camera access is not possible with asynchronous acquisition.");
+		} else if (raw_subscriber_thread) {
 			// There may be only one
 			throw Exception("Only one vision thread may access the raw camera.");
 		} else {
@@ -193,6 +236,9 @@ FvAcquisitionThread::camera_instance(colorspace_t cspace, bool deep_copy)
 			}
 			img_id       = tmp;
 			shm_[cspace] = new SharedMemoryImageBuffer(img_id, cspace, width_, height_);
+			if (capture_thread_) {
+				capture_thread_->add_colorspace(cspace);
+			}
 		} else {
 			img_id = shm_[cspace]->image_id();
 		}
@@ -247,6 +293,9 @@ FvAcquisitionThread::set_enabled(bool enabled)
 
 	if (enabled_ && !enabled) {
 		// disabling thread
+		if (capture_thread_) {
+			capture_thread_->set_enabled(false);
+		}
 		camera_->stop();
 		enabled_if_->set_enabled(false);
 		enabled_if_->write();
@@ -254,6 +303,9 @@ FvAcquisitionThread::set_enabled(bool enabled)
 	} else if (!enabled_ && enabled) {
 		// enabling thread
 		camera_->start();
+		if (capture_thread_) {
+			capture_thread_->set_enabled(true);
+		}
 		enabled_if_->set_enabled(true);
 		enabled_if_->write();
 
@@ -313,84 +365,135 @@ FvAcquisitionThread::loop()
 	Thread::CancelState old_cancel_state;
 	set_cancel_state(Thread::CANCEL_DISABLED, &old_cancel_state);
 
+	bool new_frame = false;
+	if (enabled_) {
+		if (capture_thread_) {
+			new_frame = publish_captured_frame();
+		} else {
+			capture_and_convert();
+			new_frame = true;
+		}
+	}
+
+#ifdef FVBASE_TIMETRACKER
+	if ((++loop_count_ % FVBASE_TT_PRINT_INT) == 0) {
+		tt_->print_to_stdout();
+	}
+#endif
+
+	if (mode_ == AqtCyclic && enabled_ && new_frame) {
+		vision_threads->wakeup_and_wait_cyclic_threads();
+	}
+
+	// reset to the original cancel state, cancelling is now safe
+	set_cancel_state(old_cancel_state);
+
+	// in continuous mode wait for signal if disabled
+	while (mode_ == AqtContinuous && !enabled_) {
+		enabled_waitcond_->wait();
+	}
+}
+
+/** Capture image and convert it to all shared memory buffers. */
+void
+FvAcquisitionThread::capture_and_convert()
+{
 #ifdef FVBASE_TIMETRACKER
 	try {
-		if (enabled_) {
-			tt_->ping_start(ttc_capture_);
-			camera_->capture();
-			tt_->ping_end(ttc_capture_);
-
-			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
-					continue;
-				tt_->ping_start(ttc_lock_);
-				shmit_->second->lock_for_write();
-				tt_->ping_end(ttc_lock_);
-				tt_->ping_start(ttc_convert_);
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
-				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
-				} catch (NotImplementedException &e) {
-					// ignored
-				}
-				tt_->ping_end(ttc_convert_);
-				tt_->ping_start(ttc_unlock_);
-				shmit_->second->unlock();
-				tt_->ping_end(ttc_unlock_);
+		tt_->ping_start(ttc_capture_);
+		camera_->capture();
+		tt_->ping_end(ttc_capture_);
+
+		for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
+			if (shmit_->first == CS_UNKNOWN)
+				continue;
+			tt_->ping_start(ttc_lock_);
+			shmit_->second->lock_for_write();
+			tt_->ping_end(ttc_lock_);
+			tt_->ping_start(ttc_convert_);
+			convert(
+			  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
+			try {
+				shmit_->second->set_capture_time(camera_->capture_time());
+			} catch (NotImplementedException &e) {
+				// ignored
 			}
+			tt_->ping_end(ttc_convert_);
+			tt_->ping_start(ttc_unlock_);
+			shmit_->second->unlock();
+			tt_->ping_end(ttc_unlock_);
 		}
 	} catch (Exception &e) {
 		logger->log_error(name(), "Cannot convert image data");
 		logger->log_error(name(), e);
 	}
-	if (enabled_) {
-		tt_->ping_start(ttc_dispose_);
-		camera_->dispose_buffer();
-		tt_->ping_end(ttc_dispose_);
-	}
-
-	if ((++loop_count_ % FVBASE_TT_PRINT_INT) == 0) {
-		tt_->print_to_stdout();
-	}
+	tt_->ping_start(ttc_dispose_);
+	camera_->dispose_buffer();
+	tt_->ping_end(ttc_dispose_);
 
 #else // no time tracking
 	try {
-		if (enabled_) {
-			camera_->capture();
-			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
-					continue;
-				shmit_->second->lock_for_write();
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
-				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
-				} catch (NotImplementedException &e) {
-					// ignored
-				}
-				shmit_->second->unlock();
+		camera_->capture();
+		for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
+			if (shmit_->first == CS_UNKNOWN)
+				continue;
+			shmit_->second->lock_for_write();
+			convert(
+			  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
+			try {
+				shmit_->second->set_capture_time(camera_->capture_time());
+			} catch (NotImplementedException &e) {
+				// ignored
 			}
+			shmit_->second->unlock();
 		}
 	} catch (Exception &e) {
 		logger->log_error(name(), e);
 	}
-	if (enabled_) {
-		camera_->dispose_buffer();
-	}
+	camera_->dispose_buffer();
 #endif
+}
 
-	if (mode_ == AqtCyclic && enabled_) {
-		vision_threads->wakeup_and_wait_cyclic_threads();
-	}
-
-	// reset to the original cancel state, cancelling is now safe
-	set_cancel_state(old_cancel_state);
+/** Publish newest frame of the capture thread.
+ * Copies the converted images of the newest complete frame to the shared
+ * memory buffers. In continuous mode this waits a short time for a new frame
+ * if none is available, in cyclic mode it returns immediately so that the
+ * main loop is not delayed.
+ * @return true if a new frame has been published, false otherwise
+ */
+bool
+FvAcquisitionThread::publish_captured_frame()
+{
+	FvCaptureThread::Frame *frame =
+	  capture_thread_->acquire_newest_frame(mode_ == AqtContinuous ? 100 : 0);
+	if (!frame)
+		return false;
 
-	// in continuous mode wait for signal if disabled
-	while (mode_ == AqtContinuous && !enabled_) {
-		enabled_waitcond_->wait();
+#ifdef FVBASE_TIMETRACKER
+	tt_->ping_start(ttc_publish_);
+#endif
+	for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
+		if (shmit_->first == CS_UNKNOWN)
+			continue;
+		std::map<colorspace_t, std::vector<unsigned char>>::iterator b =
+		  frame->buffers.find(shmit_->first);
+		if (b == frame->buffers.end()) {
+			// colorspace added after the frame has been captured
+			continue;
+		}
+		shmit_->second->lock_for_write();
+		memcpy(shmit_->second->buffer(), &b->second[0], b->second.size());
+		if (frame->has_capture_time) {
+			shmit_->second->set_capture_time(&frame->capture_time);
+		}
+		shmit_->second->unlock();
 	}
+#ifdef FVBASE_TIMETRACKER
+	tt_->ping_end(ttc_publish_);
+#endif
+
+	capture_thread_->release_frame(frame);
+	return true;
 }
 
 bool
@@ -47,6 +47,7 @@ class SharedMemoryImageBuffer;
 }
 class FvBaseThread;
 class FvAqtVisionThreads;
+class FvCaptureThread;
 
 class FvAcquisitionThread : public fawkes::Thread,
                             public fawkes::LoggingAspect,
@@ -80,6 +81,7 @@ public:
 
 	void set_vt_prepfin_hold(bool hold);
 	void set_enabled(bool enabled);
+	void set_async(unsigned int queue_length);
 
 public:
 	/** Vision threads assigned to this acquisition thread. To be used only by the
@@ -98,6 +100,9 @@ protected:
 	}
 
 private:
+	void capture_and_convert();
+	bool publish_captured_frame();
+
 	virtual bool bb_interface_message_received(fawkes::Interface *interface,
 	                                           fawkes::Message   *message) noexcept;
 
@@ -120,6 +125,9 @@ private:
 
 	fawkes::SwitchInterface *enabled_if_;
 
+	unsigned int     async_queue_length_;
+	FvCaptureThread *capture_thread_;
+
 #ifdef FVBASE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
 	unsigned int         loop_count_;
@@ -128,6 +136,7 @@ private:
 	unsigned int         ttc_convert_;
 	unsigned int         ttc_unlock_;
 	unsigned int         ttc_dispose_;
+	unsigned int         ttc_publish_;
 #endif
 };
 
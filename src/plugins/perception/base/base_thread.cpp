@@ -58,8 +58,9 @@ FvBaseThread::FvBaseThread()
   VisionMasterAspect(this)
 {
 	// default to 30 seconds
-	aqt_timeout_ = 30;
-	aqt_barrier_ = new Barrier(1);
+	aqt_timeout_            = 30;
+	aqt_async_queue_length_ = 0;
+	aqt_barrier_            = new Barrier(1);
 }
 
 /** Destructor. */
@@ -75,6 +76,11 @@ FvBaseThread::init()
 	// that are orphaned
 	SharedMemoryImageBuffer::cleanup(/* use lister */ false);
 	SharedMemoryLookupTable::cleanup(/* use lister */ false);
+
+	try {
+		aqt_async_queue_length_ = config->get_uint("/firevision/base/async_queue_length");
+	} catch (Exception &e) {
+	} // ignored, use default
 }
 
 void
@@ -256,6 +262,10 @@ FvBaseThread::register_for_camera(const char *camera_string, Thread *thread, col
 			}
 
 			FvAcquisitionThread *aqt = new FvAcquisitionThread(id.c_str(), cam, logger, clock);
+			if (cspace != CS_UNKNOWN) {
+				// raw camera access requires synchronous acquisition
+				aqt->set_async(aqt_async_queue_length_);
+			}
 
 			c = aqt->camera_instance(cspace,
 			                         (vision_thread->vision_thread_mode() == VisionAspect::CONTINUOUS));
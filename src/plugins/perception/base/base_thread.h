@@ -96,6 +96,7 @@ private:
 	fawkes::LockMap<std::string, FvAcquisitionThread *>           aqts_;
 	fawkes::LockMap<std::string, FvAcquisitionThread *>::iterator ait_;
 	unsigned int                                                  aqt_timeout_;
+	unsigned int                                                  aqt_async_queue_length_;
 
 	fawkes::LockList<firevision::CameraControl *>    owned_controls_;
 	fawkes::LockMap<Thread *, FvAcquisitionThread *> started_threads_;
@@ -0,0 +1,274 @@
+
+/***************************************************************************
+ *  capture_thread.cpp - FireVision asynchronous capture thread
+ *
+ *  Created: Sun Oct 18 14:21:36 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "capture_thread.h"
+
+#include <core/exceptions/software.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+#ifdef FVBASE_TIMETRACKER
+#	include <utils/time/tracker.h>
+#endif
+#include <fvcams/camera.h>
+#include <fvutils/color/conversions.h>
+#include <logging/logger.h>
+
+using namespace fawkes;
+using namespace firevision;
+
+/** @class FvCaptureThread "capture_thread.h"
+ * FireVision asynchronous capture thread.
+ * This thread continuously captures images from a camera and converts them
+ * into all colorspaces requested by the vision threads. The results are
+ * stored in a small queue of frames. The acquisition thread then only has
+ * to publish the newest complete frame to the shared memory buffers, so
+ * that capturing and converting the next image runs in parallel to the
+ * processing of the current one.
+ *
+ * The queue needs at least two frames. With two frames the capture thread
+ * may have to wait for the acquisition thread to release a frame, with
+ * three or more frames capturing never blocks.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param id camera ID, used to name the thread
+ * @param camera opened camera to capture from
+ * @param logger logger for error messages
+ * @param queue_length number of frames in the queue, at least 2
+ */
+FvCaptureThread::FvCaptureThread(const char  *id,
+                                 Camera      *camera,
+                                 Logger      *logger,
+                                 unsigned int queue_length)
+: Thread("FvCaptureThread", Thread::OPMODE_CONTINUOUS)
+{
+	set_name("FvCaptureThread::%s", id);
+
+	if (queue_length < 2) {
+		throw OutOfBoundsException("Capture queue length", queue_length, 2, 0xFFFFFFFF);
+	}
+
+	camera_     = camera;
+	logger_     = logger;
+	width_      = camera_->pixel_width();
+	height_     = camera_->pixel_height();
+	colorspace_ = camera_->colorspace();
+
+	capture_mutex_    = new Mutex();
+	enabled_waitcond_ = new WaitCondition(capture_mutex_);
+	enabled_          = false;
+
+	frame_mutex_    = new Mutex();
+	frame_waitcond_ = new WaitCondition(frame_mutex_);
+	for (unsigned int i = 0; i < queue_length; ++i) {
+		frames_.push_back(new Frame());
+		frames_.back()->seqnum = 0;
+	}
+	newest_frame_         = NULL;
+	reading_frame_        = NULL;
+	last_acquired_seqnum_ = 0;
+	seqnum_               = 0;
+
+#ifdef FVBASE_TIMETRACKER
+	tt_          = new TimeTracker();
+	loop_count_  = 0;
+	ttc_capture_ = tt_->add_class("Async Capture");
+	ttc_convert_ = tt_->add_class("Async Convert");
+	ttc_dispose_ = tt_->add_class("Async Dispose");
+#endif
+}
+
+/** Destructor. */
+FvCaptureThread::~FvCaptureThread()
+{
+	for (Frame *f : frames_) {
+		delete f;
+	}
+	delete enabled_waitcond_;
+	delete capture_mutex_;
+	delete frame_waitcond_;
+	delete frame_mutex_;
+#ifdef FVBASE_TIMETRACKER
+	delete tt_;
+#endif
+}
+
+/** Enable or disable capturing.
+ * When disabling, this method blocks until a capture that is currently in
+ * progress has been completed. Afterwards the camera may safely be stopped.
+ * @param enabled true to enable capturing, false to disable
+ */
+void
+FvCaptureThread::set_enabled(bool enabled)
+{
+	MutexLocker lock(capture_mutex_);
+	enabled_ = enabled;
+	if (enabled_) {
+		enabled_waitcond_->wake_all();
+	}
+}
+
+/** Add colorspace to convert captured images to.
+ * Frames captured after this call will contain a buffer for the given
+ * colorspace.
+ * @param cspace colorspace to add
+ */
+void
+FvCaptureThread::add_colorspace(colorspace_t cspace)
+{
+	MutexLocker lock(frame_mutex_);
+	colorspaces_.insert(cspace);
+}
+
+/** Get frame to capture the next image into.
+ * Must be called with the frame mutex locked. Any frame but the newest and
+ * the one currently being read by the acquisition thread can be used.
+ * @return frame to write to, NULL if no frame is available
+ */
+FvCaptureThread::Frame *
+FvCaptureThread::next_write_frame()
+{
+	Frame *oldest = NULL;
+	for (Frame *f : frames_) {
+		if ((f != newest_frame_) && (f != reading_frame_)) {
+			if (!oldest || (f->seqnum < oldest->seqnum)) {
+				oldest = f;
+			}
+		}
+	}
+	return oldest;
+}
+
+void
+FvCaptureThread::loop()
+{
+	MutexLocker lock(capture_mutex_);
+	while (!enabled_) {
+		enabled_waitcond_->wait();
+	}
+
+	frame_mutex_->lock();
+	Frame *frame;
+	while ((frame = next_write_frame()) == NULL) {
+		frame_waitcond_->wait();
+	}
+	std::set<colorspace_t> colorspaces = colorspaces_;
+	frame_mutex_->unlock();
+
+	// We disable cancelling here to avoid leaving the camera in an inconsistent state
+	Thread::CancelState old_cancel_state;
+	set_cancel_state(Thread::CANCEL_DISABLED, &old_cancel_state);
+
+	bool captured = false;
+	try {
+#ifdef FVBASE_TIMETRACKER
+		tt_->ping_start(ttc_capture_);
+#endif
+		camera_->capture();
+		captured = true;
+#ifdef FVBASE_TIMETRACKER
+		tt_->ping_end(ttc_capture_);
+		tt_->ping_start(ttc_convert_);
+#endif
+
+		for (colorspace_t cspace : colorspaces) {
+			std::vector<unsigned char> &buffer = frame->buffers[cspace];
+			buffer.resize(colorspace_buffer_size(cspace, width_, height_));
+			convert(colorspace_, cspace, camera_->buffer(), &buffer[0], width_, height_);
+		}
+		try {
+			frame->capture_time     = *camera_->capture_time();
+			frame->has_capture_time = true;
+		} catch (NotImplementedException &e) {
+			frame->has_capture_time = false;
+		}
+#ifdef FVBASE_TIMETRACKER
+		tt_->ping_end(ttc_convert_);
+#endif
+	} catch (Exception &e) {
+		logger_->log_error(name(), "Cannot capture or convert image data");
+		logger_->log_error(name(), e);
+		if (captured) {
+			camera_->dispose_buffer();
+		}
+		set_cancel_state(old_cancel_state);
+		return;
+	}
+
+#ifdef FVBASE_TIMETRACKER
+	tt_->ping_start(ttc_dispose_);
+#endif
+	camera_->dispose_buffer();
+#ifdef FVBASE_TIMETRACKER
+	tt_->ping_end(ttc_dispose_);
+	if ((++loop_count_ % FVBASE_TT_PRINT_INT) == 0) {
+		tt_->print_to_stdout();
+	}
+#endif
+
+	frame_mutex_->lock();
+	frame->seqnum = ++seqnum_;
+	newest_frame_ = frame;
+	frame_waitcond_->wake_all();
+	frame_mutex_->unlock();
+
+	set_cancel_state(old_cancel_state);
+}
+
+/** Acquire newest frame.
+ * Returns the newest completely captured and converted frame that has not
+ * been acquired before. The frame is not modified until it is released.
+ * Only one frame may be acquired at a time.
+ * @param timeout_ms maximum time to wait for a new frame in milliseconds,
+ * 0 to return immediately if no new frame is available
+ * @return newest frame, NULL if no new frame was available in time
+ */
+FvCaptureThread::Frame *
+FvCaptureThread::acquire_newest_frame(unsigned int timeout_ms)
+{
+	MutexLocker lock(frame_mutex_);
+	if ((!newest_frame_ || (newest_frame_->seqnum == last_acquired_seqnum_)) && (timeout_ms > 0)) {
+		frame_waitcond_->reltimed_wait(timeout_ms / 1000, (timeout_ms % 1000) * 1000000);
+	}
+	if (!newest_frame_ || (newest_frame_->seqnum == last_acquired_seqnum_)) {
+		return NULL;
+	}
+
+	reading_frame_        = newest_frame_;
+	last_acquired_seqnum_ = reading_frame_->seqnum;
+	return reading_frame_;
+}
+
+/** Release previously acquired frame.
+ * @param frame frame returned by acquire_newest_frame()
+ */
+void
+FvCaptureThread::release_frame(Frame *frame)
+{
+	MutexLocker lock(frame_mutex_);
+	if (frame == reading_frame_) {
+		reading_frame_ = NULL;
+		frame_waitcond_->wake_all();
+	}
+}
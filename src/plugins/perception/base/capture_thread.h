@@ -0,0 +1,117 @@
+
+/***************************************************************************
+ *  capture_thread.h - FireVision asynchronous capture thread
+ *
+ *  Created: Sun Oct 18 14:21:36 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _FIREVISION_APPS_BASE_CAPTURE_THREAD_H_
+#define _FIREVISION_APPS_BASE_CAPTURE_THREAD_H_
+
+#include <core/threading/thread.h>
+#include <fvutils/color/colorspaces.h>
+#include <utils/time/time.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace fawkes {
+class Logger;
+class Mutex;
+class WaitCondition;
+#ifdef FVBASE_TIMETRACKER
+class TimeTracker;
+#endif
+} // namespace fawkes
+namespace firevision {
+class Camera;
+}
+
+class FvCaptureThread : public fawkes::Thread
+{
+public:
+	/** Captured and converted frame. */
+	class Frame
+	{
+	public:
+		/** Sequence number, increases with every captured frame. */
+		unsigned long int seqnum;
+		/** Time the image was captured, only valid if has_capture_time is true. */
+		fawkes::Time capture_time;
+		/** True if the camera provided a capture time. */
+		bool has_capture_time;
+		/** Converted image buffers by colorspace. */
+		std::map<firevision::colorspace_t, std::vector<unsigned char>> buffers;
+	};
+
+	FvCaptureThread(const char         *id,
+	                firevision::Camera *camera,
+	                fawkes::Logger     *logger,
+	                unsigned int        queue_length);
+	virtual ~FvCaptureThread();
+
+	virtual void loop();
+
+	void set_enabled(bool enabled);
+	void add_colorspace(firevision::colorspace_t cspace);
+
+	Frame *acquire_newest_frame(unsigned int timeout_ms);
+	void   release_frame(Frame *frame);
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	Frame *next_write_frame();
+
+private:
+	firevision::Camera      *camera_;
+	fawkes::Logger          *logger_;
+	firevision::colorspace_t colorspace_;
+	unsigned int             width_;
+	unsigned int             height_;
+
+	fawkes::Mutex         *capture_mutex_;
+	fawkes::WaitCondition *enabled_waitcond_;
+	bool                   enabled_;
+
+	fawkes::Mutex                     *frame_mutex_;
+	fawkes::WaitCondition             *frame_waitcond_;
+	std::vector<Frame *>               frames_;
+	Frame                             *newest_frame_;
+	Frame                             *reading_frame_;
+	unsigned long int                  last_acquired_seqnum_;
+	unsigned long int                  seqnum_;
+	std::set<firevision::colorspace_t> colorspaces_;
+
+#ifdef FVBASE_TIMETRACKER
+	fawkes::TimeTracker *tt_;
+	unsigned int         loop_count_;
+	unsigned int         ttc_capture_;
+	unsigned int         ttc_convert_;
+	unsigned int         ttc_dispose_;
+#endif
+};
+
+#endif
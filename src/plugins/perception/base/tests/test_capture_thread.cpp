@@ -0,0 +1,221 @@
+/***************************************************************************
+ *  test_capture_thread.cpp - FireVision asynchronous capture thread test
+ *
+ *  Created: Sun Oct 18 17:31:48 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "../capture_thread.h"
+
+#include <core/exception.h>
+#include <core/exceptions/software.h>
+#include <fvcams/camera.h>
+#include <logging/multi.h>
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace firevision;
+
+namespace {
+/** Camera which fills every image with the number of the capture. */
+class CountingCamera : public Camera
+{
+public:
+	CountingCamera(unsigned int fail_first = 0)
+	: buffer_(WIDTH * HEIGHT), captures_(0), disposed_(0), fail_first_(fail_first)
+	{
+	}
+
+	virtual void open() {}
+	virtual void start() {}
+	virtual void stop() {}
+	virtual void close() {}
+	virtual void flush() {}
+	virtual bool ready() { return true; }
+	virtual void print_info() {}
+
+	virtual void
+	capture()
+	{
+		usleep(1000);
+		unsigned int n = ++captures_;
+		if (n <= fail_first_) {
+			throw Exception("Capture %u failed", n);
+		}
+		std::fill(buffer_.begin(), buffer_.end(), (unsigned char)(n - fail_first_));
+	}
+
+	virtual unsigned char *buffer() { return &buffer_[0]; }
+	virtual unsigned int   buffer_size() { return buffer_.size(); }
+	virtual void           dispose_buffer() { ++disposed_; }
+
+	virtual unsigned int pixel_width() { return WIDTH; }
+	virtual unsigned int pixel_height() { return HEIGHT; }
+	virtual colorspace_t colorspace() { return GRAY8; }
+	virtual void         set_image_number(unsigned int n) {}
+
+	static const unsigned int WIDTH  = 8;
+	static const unsigned int HEIGHT = 4;
+
+	std::vector<unsigned char> buffer_;
+	std::atomic<unsigned int>  captures_;
+	std::atomic<unsigned int>  disposed_;
+	unsigned int               fail_first_;
+};
+
+bool
+wait_for_captures(CountingCamera &camera, unsigned int captures)
+{
+	for (unsigned int i = 0; i < 5000 && camera.captures_ < captures; ++i) {
+		usleep(1000);
+	}
+	return camera.captures_ >= captures;
+}
+
+bool
+frame_matches_seqnum(FvCaptureThread::Frame *frame)
+{
+	const std::vector<unsigned char> &buffer = frame->buffers[GRAY8];
+	if (buffer.size() != CountingCamera::WIDTH * CountingCamera::HEIGHT) {
+		return false;
+	}
+	for (unsigned char c : buffer) {
+		if (c != (unsigned char)frame->seqnum) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+stop(FvCaptureThread &thread)
+{
+	thread.set_enabled(false);
+	thread.cancel();
+	thread.join();
+}
+} // namespace
+
+TEST_CASE("Capture queue needs at least two frames", "[capture_thread]")
+{
+	CountingCamera camera;
+	MultiLogger    logger;
+	REQUIRE_THROWS_AS(FvCaptureThread("test", &camera, &logger, 1), OutOfBoundsException);
+}
+
+TEST_CASE("Disabled capture thread does not capture", "[capture_thread]")
+{
+	CountingCamera  camera;
+	MultiLogger     logger;
+	FvCaptureThread thread("test", &camera, &logger, 3);
+	thread.add_colorspace(GRAY8);
+	thread.start();
+
+	usleep(20000);
+	REQUIRE(camera.captures_ == 0);
+	REQUIRE(thread.acquire_newest_frame(0) == NULL);
+
+	thread.set_enabled(true);
+	FvCaptureThread::Frame *frame = thread.acquire_newest_frame(5000);
+	REQUIRE(frame != NULL);
+	REQUIRE(frame_matches_seqnum(frame));
+	thread.release_frame(frame);
+
+	stop(thread);
+	REQUIRE(camera.disposed_ == camera.captures_);
+}
+
+TEST_CASE("Acquired frames are newest and not overwritten", "[capture_thread]")
+{
+	CountingCamera  camera;
+	MultiLogger     logger;
+	FvCaptureThread thread("test", &camera, &logger, 3);
+	thread.add_colorspace(GRAY8);
+	thread.set_enabled(true);
+	thread.start();
+
+	unsigned long int last_seqnum = 0;
+	for (unsigned int i = 0; i < 5; ++i) {
+		FvCaptureThread::Frame *frame = thread.acquire_newest_frame(5000);
+		REQUIRE(frame != NULL);
+		REQUIRE(frame->seqnum > last_seqnum);
+		last_seqnum = frame->seqnum;
+		REQUIRE_FALSE(frame->has_capture_time);
+
+		// capturing continues into the other frames while this one is held
+		REQUIRE(wait_for_captures(camera, camera.captures_ + 5));
+		REQUIRE(frame->seqnum == last_seqnum);
+		REQUIRE(frame_matches_seqnum(frame));
+		thread.release_frame(frame);
+	}
+
+	stop(thread);
+}
+
+TEST_CASE("Two frame queue blocks while a frame is held", "[capture_thread]")
+{
+	CountingCamera  camera;
+	MultiLogger     logger;
+	FvCaptureThread thread("test", &camera, &logger, 2);
+	thread.add_colorspace(GRAY8);
+	thread.set_enabled(true);
+	thread.start();
+
+	FvCaptureThread::Frame *frame = thread.acquire_newest_frame(5000);
+	REQUIRE(frame != NULL);
+	unsigned long int seqnum = frame->seqnum;
+
+	// one more frame may be captured, then there is no frame left to write
+	usleep(50000);
+	unsigned int captures = camera.captures_;
+	usleep(50000);
+	REQUIRE(camera.captures_ == captures);
+	REQUIRE(captures <= seqnum + 1);
+	REQUIRE(frame_matches_seqnum(frame));
+
+	thread.release_frame(frame);
+	REQUIRE(wait_for_captures(camera, captures + 2));
+	frame = thread.acquire_newest_frame(5000);
+	REQUIRE(frame != NULL);
+	REQUIRE(frame->seqnum > seqnum);
+	thread.release_frame(frame);
+
+	stop(thread);
+}
+
+TEST_CASE("Failed captures are skipped", "[capture_thread]")
+{
+	CountingCamera  camera(3);
+	MultiLogger     logger;
+	FvCaptureThread thread("test", &camera, &logger, 3);
+	thread.add_colorspace(GRAY8);
+	thread.set_enabled(true);
+	thread.start();
+
+	FvCaptureThread::Frame *frame = thread.acquire_newest_frame(5000);
+	REQUIRE(frame != NULL);
+	REQUIRE(frame_matches_seqnum(frame));
+	thread.release_frame(frame);
+
+	stop(thread);
+	REQUIRE(camera.disposed_ == camera.captures_ - 3);
+}
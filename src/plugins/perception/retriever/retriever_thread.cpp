@@ -25,12 +25,14 @@
 #include <fvcams/camera.h>
 #include <fvmodels/color/lookuptable.h>
 #include <fvutils/ipc/shm_image.h>
+#include <fvutils/writers/async_seq_writer.h>
+#include <fvutils/writers/fvraw.h>
 #include <fvutils/writers/jpeg.h>
-#include <fvutils/writers/seq_writer.h>
 #include <utils/time/tracker.h>
 
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 
 using namespace fawkes;
 using namespace firevision;
@@ -119,9 +121,6 @@ FvRetrieverThread::init()
 	seq_writer = NULL;
 	try {
 		if (config->get_bool("/firevision/retriever/save_images")) {
-			logger->log_info(name(), "Writing images to disk");
-			Writer *writer = new JpegWriter();
-			seq_writer     = new SeqWriter(writer);
 			std::string save_path;
 			try {
 				save_path = config->get_string("/firevision/retriever/save_path");
@@ -129,6 +128,42 @@ FvRetrieverThread::init()
 				save_path = ("recorded_images");
 				logger->log_info(name(), "No save path specified. Using './%s'", save_path.c_str());
 			}
+			std::string save_format = "jpeg";
+			try {
+				save_format = config->get_string("/firevision/retriever/save_format");
+			} catch (Exception &e) {
+			} // ignored, use default
+			unsigned int num_encoders = 2;
+			try {
+				num_encoders = config->get_uint("/firevision/retriever/save_encoders");
+			} catch (Exception &e) {
+			} // ignored, use default
+			unsigned int queue_length = 8;
+			try {
+				queue_length = config->get_uint("/firevision/retriever/save_queue_length");
+			} catch (Exception &e) {
+			} // ignored, use default
+
+			if (save_format == "sequence") {
+				time_t    now = time(NULL);
+				struct tm now_tm;
+				char      timestr[16];
+				localtime_r(&now, &now_tm);
+				strftime(timestr, sizeof(timestr), "%Y%m%d_%H%M%S", &now_tm);
+				std::string filename = save_path + "/" + timestr + "_retriever_" + cfg_name_ + ".raw";
+				logger->log_info(name(), "Writing images to sequence %s", filename.c_str());
+				seq_writer = new AsyncSeqWriter(filename.c_str(), CS_UNKNOWN, 1, queue_length);
+			} else if (save_format == "fvraw") {
+				logger->log_info(name(), "Writing FvRaw images to disk");
+				seq_writer = new AsyncSeqWriter([]() { return new FvRawWriter(); },
+				                                num_encoders,
+				                                queue_length);
+			} else {
+				logger->log_info(name(), "Writing JPEG images to disk");
+				seq_writer = new AsyncSeqWriter([]() { return new JpegWriter(); },
+				                                num_encoders,
+				                                queue_length);
+			}
 			seq_writer->set_path(save_path.c_str());
 			seq_writer->set_dimensions(cam->pixel_width(), cam->pixel_height());
 			seq_writer->set_colorspace(cam->colorspace());
@@ -176,6 +211,18 @@ FvRetrieverThread::finalize()
 {
 	logger->log_debug(name(), "Unregistering from vision master");
 	vision_master->unregister_thread(this);
+	if (seq_writer) {
+		try {
+			seq_writer->close();
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Failed to write recorded images");
+			logger->log_warn(name(), e);
+		}
+		logger->log_info(name(),
+		                 "Recorded %lu images, dropped %lu",
+		                 seq_writer->num_written(),
+		                 seq_writer->num_dropped());
+	}
 	delete cam;
 	delete shm;
 	delete seq_writer;
@@ -223,6 +270,7 @@ FvRetrieverThread::loop()
 	}
 
 	if (seq_writer) {
-		seq_writer->write(shm->buffer());
+		fawkes::Time capture_time = shm->capture_time();
+		seq_writer->write(shm->buffer(), &capture_time);
 	}
 }
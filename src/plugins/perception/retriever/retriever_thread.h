@@ -37,7 +37,7 @@ class TimeTracker;
 namespace firevision {
 class Camera;
 class SharedMemoryImageBuffer;
-class SeqWriter;
+class AsyncSeqWriter;
 class ColorModelLookupTable;
 } // namespace firevision
 
@@ -73,7 +73,7 @@ private:
 
 	firevision::Camera                  *cam;
 	firevision::SharedMemoryImageBuffer *shm;
-	firevision::SeqWriter               *seq_writer;
+	firevision::AsyncSeqWriter          *seq_writer;
 	fawkes::TimeTracker                 *tt_;
 	unsigned int                         loop_count_;
 	unsigned int                         ttc_capture_;
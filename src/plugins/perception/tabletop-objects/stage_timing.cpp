@@ -0,0 +1,187 @@
+
+/***************************************************************************
+ *  stage_timing.cpp - Per-stage timing of the tabletop pipeline
+ *
+ *  Created: Sun Oct 18 16:02:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "stage_timing.h"
+
+#include <blackboard/blackboard.h>
+#include <core/exception.h>
+#include <interfaces/MetricFamilyInterface.h>
+#include <interfaces/MetricHistogramInterface.h>
+#include <utils/time/latency_histogram.h>
+
+#include <algorithm>
+
+using namespace fawkes;
+
+/** @class StageTiming "stage_timing.h"
+ * Timing of the stages of a processing pipeline.
+ * The durations of each stage are recorded in a histogram. The
+ * histograms can be exported as metrics through the blackboard, a
+ * MetricFamilyInterface announces them to the metrics plugin and one
+ * MetricHistogramInterface per stage carries the data, labeled with
+ * the stage name.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param stages names of the pipeline stages, stages are referred to
+ * by their index in this vector
+ */
+StageTiming::StageTiming(const std::vector<std::string> &stages)
+: stages_(stages), last_usec_(0), blackboard_(NULL), family_if_(NULL)
+{
+	for (size_t i = 0; i < stages_.size(); ++i) {
+		histograms_.emplace_back(new LatencyHistogram());
+	}
+}
+
+/** Destructor. */
+StageTiming::~StageTiming()
+{
+	close_metrics();
+}
+
+/** Start timing a pipeline run.
+ * The next stage_done() call records the time since this call.
+ */
+void
+StageTiming::start()
+{
+	last_usec_ = LatencyHistogram::now_usec();
+}
+
+/** Mark a stage as finished.
+ * Records the time since the last call to start() or stage_done().
+ * @param stage index of the finished stage
+ */
+void
+StageTiming::stage_done(unsigned int stage)
+{
+	uint64_t now = LatencyHistogram::now_usec();
+	record(stage, now - last_usec_);
+	last_usec_ = now;
+}
+
+/** Record a stage duration.
+ * @param stage index of the stage
+ * @param usec duration in microseconds
+ */
+void
+StageTiming::record(unsigned int stage, uint64_t usec)
+{
+	histograms_.at(stage)->record_usec(usec);
+}
+
+/** Get histogram of a stage.
+ * @param stage index of the stage
+ * @return histogram of stage durations
+ */
+const LatencyHistogram &
+StageTiming::histogram(unsigned int stage) const
+{
+	return *histograms_.at(stage);
+}
+
+/** Open metric interfaces.
+ * @param blackboard blackboard to open interfaces on
+ * @param family_id ID of the metric family interface, the stage
+ * interfaces have the ID family_id/stage
+ * @param metric_name name of the exported metric
+ * @param help help text of the exported metric
+ * @param buckets upper bounds of histogram buckets in seconds, at
+ * most 16 are exported
+ */
+void
+StageTiming::open_metrics(BlackBoard               *blackboard,
+                          const std::string        &family_id,
+                          const std::string        &metric_name,
+                          const std::string        &help,
+                          const std::vector<float> &buckets)
+{
+	close_metrics();
+
+	buckets_.assign(buckets.begin(), buckets.end());
+	std::sort(buckets_.begin(), buckets_.end());
+
+	blackboard_ = blackboard;
+	try {
+		// the data interfaces must exist before the family is announced
+		for (const std::string &stage : stages_) {
+			std::string               id = family_id + "/" + stage;
+			MetricHistogramInterface *iface =
+			  blackboard_->open_for_writing<MetricHistogramInterface>(id.c_str());
+			stage_ifs_.push_back(iface);
+			iface->set_labels(("stage=" + stage).c_str());
+			if (buckets_.size() > iface->maxlenof_bucket_upper_bound()) {
+				buckets_.resize(iface->maxlenof_bucket_upper_bound());
+			}
+			iface->set_bucket_count(buckets_.size());
+			for (size_t i = 0; i < buckets_.size(); ++i) {
+				iface->set_bucket_upper_bound(i, buckets_[i]);
+			}
+			iface->write();
+		}
+
+		family_if_ = blackboard_->open_for_writing<MetricFamilyInterface>(family_id.c_str());
+		family_if_->set_name(metric_name.c_str());
+		family_if_->set_help(help.c_str());
+		family_if_->set_metric_type(MetricFamilyInterface::HISTOGRAM);
+		family_if_->write();
+	} catch (Exception &e) {
+		close_metrics();
+		throw;
+	}
+}
+
+/** Close metric interfaces. */
+void
+StageTiming::close_metrics()
+{
+	if (!blackboard_)
+		return;
+
+	blackboard_->close(family_if_);
+	for (MetricHistogramInterface *iface : stage_ifs_) {
+		blackboard_->close(iface);
+	}
+	family_if_ = NULL;
+	stage_ifs_.clear();
+	blackboard_ = NULL;
+}
+
+/** Write the current histograms to the metric interfaces.
+ * Does nothing if open_metrics() has not been called.
+ */
+void
+StageTiming::publish_metrics()
+{
+	for (size_t s = 0; s < stage_ifs_.size(); ++s) {
+		MetricHistogramInterface *iface = stage_ifs_[s];
+		const LatencyHistogram   &lh    = *histograms_[s];
+		iface->set_sample_count(lh.count());
+		iface->set_sample_sum(lh.sum());
+		for (size_t i = 0; i < buckets_.size(); ++i) {
+			iface->set_bucket_cumulative_count(i, lh.cumulative_count(buckets_[i]));
+		}
+		iface->write();
+	}
+}
@@ -0,0 +1,69 @@
+
+/***************************************************************************
+ *  stage_timing.h - Per-stage timing of the tabletop pipeline
+ *
+ *  Created: Sun Oct 18 16:02:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_PERCEPTION_TABLETOP_OBJECTS_STAGE_TIMING_H_
+#define _PLUGINS_PERCEPTION_TABLETOP_OBJECTS_STAGE_TIMING_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class BlackBoard;
+class LatencyHistogram;
+class MetricFamilyInterface;
+class MetricHistogramInterface;
+} // namespace fawkes
+
+class StageTiming
+{
+public:
+	StageTiming(const std::vector<std::string> &stages);
+	~StageTiming();
+
+	void start();
+	void stage_done(unsigned int stage);
+	void record(unsigned int stage, uint64_t usec);
+
+	const fawkes::LatencyHistogram &histogram(unsigned int stage) const;
+
+	void open_metrics(fawkes::BlackBoard       *blackboard,
+	                  const std::string        &family_id,
+	                  const std::string        &metric_name,
+	                  const std::string        &help,
+	                  const std::vector<float> &buckets);
+	void close_metrics();
+	void publish_metrics();
+
+private:
+	std::vector<std::string>                               stages_;
+	std::vector<std::unique_ptr<fawkes::LatencyHistogram>> histograms_;
+	uint64_t                                               last_usec_;
+
+	fawkes::BlackBoard                             *blackboard_;
+	fawkes::MetricFamilyInterface                  *family_if_;
+	std::vector<fawkes::MetricHistogramInterface *> stage_ifs_;
+	std::vector<double>                             buckets_;
+};
+
+#endif
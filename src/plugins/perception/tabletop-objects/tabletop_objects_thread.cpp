@@ -22,6 +22,7 @@
 #include "tabletop_objects_thread.h"
 
 #include "cluster_colors.h"
+#include "stage_timing.h"
 #ifdef HAVE_VISUAL_DEBUGGING
 #	include "visualization_thread_base.h"
 #endif
@@ -124,6 +125,15 @@ TabletopObjectsThread::init()
 	} catch (const Exception &e) {
 		cfg_verbose_cylinder_fitting_ = false;
 	}
+	cfg_table_reuse_ = config->get_bool_or_default(CFG_PREFIX "table_reuse/enable", false);
+	cfg_table_reuse_fixed_frame_ =
+	  config->get_string_or_default(CFG_PREFIX "table_reuse/fixed_frame",
+	                                config->get_string_or_default("/frames/odom", "odom"));
+	cfg_table_reuse_max_translation_ =
+	  config->get_float_or_default(CFG_PREFIX "table_reuse/max_translation", 0.01);
+	cfg_table_reuse_max_rotation_ =
+	  deg2rad(config->get_float_or_default(CFG_PREFIX "table_reuse/max_rotation", 1.0));
+	cfg_table_reuse_max_age_ = config->get_uint_or_default(CFG_PREFIX "table_reuse/max_age", 30);
 
 	if (pcl_manager->exists_pointcloud<PointType>(cfg_input_pointcloud_.c_str())) {
 		finput_ = pcl_manager->get_pointcloud<PointType>(cfg_input_pointcloud_.c_str());
@@ -254,6 +264,66 @@ TabletopObjectsThread::init()
 	seg_.setMaxIterations(cfg_segm_max_iterations_);
 	seg_.setDistanceThreshold(cfg_segm_distance_threshold_);
 
+	cloud_voxelized_.reset(new Cloud());
+	cloud_plane_.reset(new Cloud());
+	cloud_scratch_.reset(new Cloud());
+	cloud_proj_.reset(new Cloud());
+	cloud_table_voxelized_.reset(new Cloud());
+	cloud_hull_.reset(new Cloud());
+	model_cloud_hull_.reset(new Cloud());
+	baserel_polygon_cloud_.reset(new Cloud());
+	cloud_filt_.reset(new Cloud());
+	cloud_above_.reset(new Cloud());
+	cloud_objs_.reset(new Cloud());
+	tmp_clusters_.reset(new ColorCloud());
+	coeff_.reset(new pcl::ModelCoefficients());
+	inliers_.reset(new pcl::PointIndices());
+	table_cluster_inliers_.reset(new pcl::PointIndices());
+
+	proj_.setModelType(pcl::SACMODEL_PLANE);
+	proj_.setModelCoefficients(coeff_);
+
+	table_grid_.setLeafSize(cfg_table_downsample_leaf_size_,
+	                        cfg_table_downsample_leaf_size_,
+	                        cfg_table_downsample_leaf_size_);
+
+	kdtree_table_.reset(new pcl::search::KdTree<PointType>());
+	table_ec_.setClusterTolerance(cfg_table_cluster_tolerance_);
+	table_ec_.setSearchMethod(kdtree_table_);
+
+#ifdef PCL_VERSION_COMPARE
+#	if PCL_VERSION_COMPARE(>=, 1, 5, 0)
+	hull_.setDimension(2);
+#	endif
+#endif
+
+	sor_.setMeanK(5);
+	sor_.setStddevMulThresh(0.2);
+
+	kdtree_objs_.reset(new pcl::search::KdTree<PointType>());
+	objs_ec_.setClusterTolerance(cfg_cluster_tolerance_);
+	objs_ec_.setMinClusterSize(cfg_cluster_min_size_);
+	objs_ec_.setMaxClusterSize(cfg_cluster_max_size_);
+	objs_ec_.setSearchMethod(kdtree_objs_);
+
+	cluster_ws_.resize(MAX_CENTROIDS);
+	for (ClusterWorkspace &ws : cluster_ws_) {
+		ws.cluster.reset(new ColorCloud());
+		ws.baserel_cluster.reset(new ColorCloud());
+		ws.cylinder.reset(new ColorCloud());
+		ws.normals.reset(new pcl::PointCloud<pcl::Normal>());
+		ws.kdtree.reset(new pcl::search::KdTree<ColorPointType>());
+		ws.coefficients.reset(new pcl::ModelCoefficients());
+		ws.inliers.reset(new pcl::PointIndices());
+	}
+
+	// the model only depends on the configuration, create it once
+	table_model_template_ =
+	  generate_table_model(cfg_table_model_length_, cfg_table_model_width_, cfg_table_model_step_);
+
+	table_cached_    = false;
+	table_cache_age_ = 0;
+
 	loop_count_ = 0;
 
 	last_pcl_time_ = new Time(clock);
@@ -264,6 +334,31 @@ TabletopObjectsThread::init()
 	for (unsigned int i = 0; i < MAX_CENTROIDS; i++)
 		free_ids_.push_back(i);
 
+	stage_timing_ = new StageTiming({"convert",
+	                                 "voxelize",
+	                                 "table_plane",
+	                                 "table_hull",
+	                                 "table_model",
+	                                 "object_filter",
+	                                 "object_clustering",
+	                                 "object_fitting",
+	                                 "tracking",
+	                                 "output"});
+	if (config->get_bool_or_default(CFG_PREFIX "metrics/enable", true)) {
+		std::vector<float> buckets = config->get_floats_or_defaults(
+		  CFG_PREFIX "metrics/buckets", {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0});
+		try {
+			stage_timing_->open_metrics(blackboard,
+			                            "tabletop-objects-stages",
+			                            "fawkes_tabletop_objects_stage_duration_seconds",
+			                            "Duration of the stages of the tabletop objects pipeline",
+			                            buckets);
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Failed to open stage timing metrics, exception follows");
+			logger->log_warn(name(), e);
+		}
+	}
+
 #ifdef USE_TIMETRACKER
 	tt_                     = new TimeTracker();
 	tt_loopcount_           = 0;
@@ -315,6 +410,7 @@ TabletopObjectsThread::finalize()
 	fsimplified_polygon_.reset();
 
 	delete last_pcl_time_;
+	delete stage_timing_;
 #ifdef USE_TIMETRACKER
 	delete tt_;
 #endif
@@ -401,29 +497,21 @@ TabletopObjectsThread::loop()
 	}
 	*last_pcl_time_ = pcl_time;
 
+	stage_timing_->start();
+
 	if (colored_input_) {
 		TIMETRACK_START(ttc_convert_);
 		convert_colored_input();
 		TIMETRACK_END(ttc_convert_);
+		stage_timing_->stage_done(STAGE_CONVERT);
 	}
 
 	TIMETRACK_START(ttc_voxelize_);
 
-	CloudPtr                       temp_cloud(new Cloud);
-	CloudPtr                       temp_cloud2(new Cloud);
-	pcl::ExtractIndices<PointType> extract_;
-	CloudPtr                       cloud_hull_;
-	CloudPtr                       model_cloud_hull_;
-	CloudPtr                       cloud_proj_;
-	CloudPtr                       cloud_filt_;
-	CloudPtr                       cloud_above_;
-	CloudPtr                       cloud_objs_;
-	pcl::search::KdTree<PointType> kdtree_;
-
 	grid_.setInputCloud(input_);
-	grid_.filter(*temp_cloud);
+	grid_.filter(*cloud_voxelized_);
 
-	if (temp_cloud->points.size() <= 10) {
+	if (cloud_voxelized_->points.size() <= 10) {
 		// this can happen if run at startup. Since tabletop threads runs continuous
 		// and not synchronized with main loop, but point cloud acquisition thread is
 		// synchronized, we might start before any data has been read
@@ -432,237 +520,48 @@ TabletopObjectsThread::loop()
 		return;
 	}
 
-	TIMETRACK_INTER(ttc_voxelize_, ttc_plane_)
+	TIMETRACK_END(ttc_voxelize_);
+	stage_timing_->stage_done(STAGE_VOXELIZE);
 
-	pcl::ModelCoefficients::Ptr coeff(new pcl::ModelCoefficients());
-	pcl::PointIndices::Ptr      inliers(new pcl::PointIndices());
-	Eigen::Vector4f             baserel_table_centroid(0, 0, 0, 0);
+	Eigen::Vector4f baserel_table_centroid(0, 0, 0, 0);
 
-	// This will search for the first plane which:
-	// 1. has a considerable amount of points (>= some percentage of input points)
-	// 2. is parallel to the floor (transformed normal angle to Z axis in specified epsilon)
-	// 3. is on a typical table height (at a specified height range in robot frame)
-	// Planes found along the way not satisfying any of the criteria are removed,
-	// the first plane either satisfying all criteria, or violating the first
-	// one end the loop
-	bool happy_with_plane = false;
-	while (!happy_with_plane) {
-		happy_with_plane = true;
+	// Segmenting the table is the most expensive part of the pipeline. If
+	// the camera has not moved since the last loop, the table has not moved
+	// either (unless someone moved the table, which is detected by checking
+	// that the plane still explains the data) and we can keep it.
+	tf::Transform camera_pose;
+	bool          have_camera_pose = cfg_table_reuse_ && lookup_camera_pose(camera_pose);
+	if (have_camera_pose && reuse_table(camera_pose, baserel_table_centroid)) {
+		stage_timing_->stage_done(STAGE_TABLE_PLANE);
+	} else {
+		table_cached_ = false;
 
-		if (temp_cloud->points.size() <= 10) {
-			logger->log_warn(name(),
-			                 "[L %u] no more points for plane detection, skipping loop",
-			                 loop_count_);
-			set_position(table_pos_if_, false);
-			TIMETRACK_ABORT(ttc_plane_);
+		if (!find_table_plane(baserel_table_centroid)) {
 			TIMETRACK_ABORT(ttc_full_loop_);
 			TimeWait::wait(50000);
 			return;
 		}
+		stage_timing_->stage_done(STAGE_TABLE_PLANE);
 
-		seg_.setInputCloud(temp_cloud);
-		seg_.segment(*inliers, *coeff);
-
-		// 1. check for a minimum number of expected inliers
-		if ((double)inliers->indices.size()
-		    < (cfg_segm_inlier_quota_ * (double)temp_cloud->points.size())) {
-			logger->log_warn(
-			  name(),
-			  "[L %u] no table in scene, skipping loop (%zu inliers, required %f, voxelized size %zu)",
-			  loop_count_,
-			  inliers->indices.size(),
-			  (cfg_segm_inlier_quota_ * temp_cloud->points.size()),
-			  temp_cloud->points.size());
-			set_position(table_pos_if_, false);
-			TIMETRACK_ABORT(ttc_plane_);
+		if (!extract_table_hull()) {
 			TIMETRACK_ABORT(ttc_full_loop_);
-			TimeWait::wait(50000);
+			set_position(table_pos_if_, false);
 			return;
 		}
-
-		// 2. Check angle between normal vector and Z axis of the
-		// base_link robot frame since tables are usually parallel to the ground...
-		try {
-			tf::Stamped<tf::Vector3> table_normal(tf::Vector3(coeff->values[0],
-			                                                  coeff->values[1],
-			                                                  coeff->values[2]),
-			                                      fawkes::Time(0, 0),
-			                                      input_->header.frame_id);
-
-			tf::Stamped<tf::Vector3> baserel_normal;
-			tf_listener->transform_vector(cfg_base_frame_, table_normal, baserel_normal);
-			tf::Vector3 z_axis(0, 0, copysign(1.0, baserel_normal.z()));
-			table_inclination_ = z_axis.angle(baserel_normal);
-			if (fabs(z_axis.angle(baserel_normal)) > cfg_max_z_angle_deviation_) {
-				happy_with_plane = false;
-				logger->log_warn(name(),
-				                 "[L %u] table normal (%f,%f,%f) Z angle deviation |%f| > %f, excluding",
-				                 loop_count_,
-				                 baserel_normal.x(),
-				                 baserel_normal.y(),
-				                 baserel_normal.z(),
-				                 z_axis.angle(baserel_normal),
-				                 cfg_max_z_angle_deviation_);
-			}
-		} catch (Exception &e) {
-			logger->log_warn(name(), "Transforming normal failed, exception follows");
-			logger->log_warn(name(), e);
-			happy_with_plane = false;
+		stage_timing_->stage_done(STAGE_TABLE_HULL);
+
+		if (have_camera_pose) {
+			table_cached_                 = true;
+			table_cache_age_              = 0;
+			table_cache_camera_pose_      = camera_pose;
+			table_cache_centroid_         = table_centroid;
+			table_cache_baserel_centroid_ = baserel_table_centroid;
 		}
-
-		if (happy_with_plane) {
-			// ok so far
-
-			// 3. Calculate table centroid, then transform it to the base_link system
-			// to make a table height sanity check, they tend to be at a specific height...
-			try {
-				pcl::compute3DCentroid(*temp_cloud, *inliers, table_centroid);
-				tf::Stamped<tf::Point> centroid(tf::Point(table_centroid[0],
-				                                          table_centroid[1],
-				                                          table_centroid[2]),
-				                                fawkes::Time(0, 0),
-				                                input_->header.frame_id);
-				tf::Stamped<tf::Point> baserel_centroid;
-				tf_listener->transform_point(cfg_base_frame_, centroid, baserel_centroid);
-				baserel_table_centroid[0] = baserel_centroid.x();
-				baserel_table_centroid[1] = baserel_centroid.y();
-				baserel_table_centroid[2] = baserel_centroid.z();
-
-				if ((baserel_centroid.z() < cfg_table_min_height_)
-				    || (baserel_centroid.z() > cfg_table_max_height_)) {
-					happy_with_plane = false;
-					logger->log_warn(name(),
-					                 "[L %u] table height %f not in range [%f, %f]",
-					                 loop_count_,
-					                 baserel_centroid.z(),
-					                 cfg_table_min_height_,
-					                 cfg_table_max_height_);
-				}
-			} catch (tf::TransformException &e) {
-				//logger->log_warn(name(), "Transforming centroid failed, exception follows");
-				//logger->log_warn(name(), e);
-			}
-		}
-
-		if (!happy_with_plane) {
-			// throw away
-			Cloud extracted;
-			extract_.setNegative(true);
-			extract_.setInputCloud(temp_cloud);
-			extract_.setIndices(inliers);
-			extract_.filter(extracted);
-			*temp_cloud = extracted;
-		}
-	}
-
-	// If we got here we found the table
-	// Do NOT set it here, we will still try to determine the rotation as well
-	// set_position(table_pos_if_, true, table_centroid);
-
-	TIMETRACK_INTER(ttc_plane_, ttc_extract_plane_)
-
-	extract_.setNegative(false);
-	extract_.setInputCloud(temp_cloud);
-	extract_.setIndices(inliers);
-	extract_.filter(*temp_cloud2);
-
-	// Project the model inliers
-	pcl::ProjectInliers<PointType> proj;
-	proj.setModelType(pcl::SACMODEL_PLANE);
-	proj.setInputCloud(temp_cloud2);
-	proj.setModelCoefficients(coeff);
-	cloud_proj_.reset(new Cloud());
-	proj.filter(*cloud_proj_);
-
-	TIMETRACK_INTER(ttc_extract_plane_, ttc_plane_downsampling_);
-
-	// ***
-	// In the following cluster the projected table plane. This is done to get
-	// the largest continuous part of the plane to remove outliers, for instance
-	// if the intersection of the plane with a wall or object is taken into the
-	// table points.
-	// To achieve this cluster, if an acceptable cluster was found, extract this
-	// cluster as the new table points. Otherwise continue with the existing
-	// point cloud.
-
-	// further downsample table
-	CloudPtr                  cloud_table_voxelized(new Cloud());
-	pcl::VoxelGrid<PointType> table_grid;
-	table_grid.setLeafSize(cfg_table_downsample_leaf_size_,
-	                       cfg_table_downsample_leaf_size_,
-	                       cfg_table_downsample_leaf_size_);
-	table_grid.setInputCloud(cloud_proj_);
-	table_grid.filter(*cloud_table_voxelized);
-
-	TIMETRACK_INTER(ttc_plane_downsampling_, ttc_cluster_plane_);
-
-	// Creating the KdTree object for the search method of the extraction
-	pcl::search::KdTree<PointType>::Ptr kdtree_table(new pcl::search::KdTree<PointType>());
-	kdtree_table->setInputCloud(cloud_table_voxelized);
-
-	std::vector<pcl::PointIndices>             table_cluster_indices;
-	pcl::EuclideanClusterExtraction<PointType> table_ec;
-	table_ec.setClusterTolerance(cfg_table_cluster_tolerance_);
-	table_ec.setMinClusterSize(cfg_table_min_cluster_quota_ * cloud_table_voxelized->points.size());
-	table_ec.setMaxClusterSize(cloud_table_voxelized->points.size());
-	table_ec.setSearchMethod(kdtree_table);
-	table_ec.setInputCloud(cloud_table_voxelized);
-	table_ec.extract(table_cluster_indices);
-
-	if (!table_cluster_indices.empty()) {
-		// take the first, i.e. the largest cluster
-		CloudPtr                    cloud_table_extracted(new Cloud());
-		pcl::PointIndices::ConstPtr table_cluster_indices_ptr(
-		  new pcl::PointIndices(table_cluster_indices[0]));
-		pcl::ExtractIndices<PointType> table_cluster_extract;
-		table_cluster_extract.setNegative(false);
-		table_cluster_extract.setInputCloud(cloud_table_voxelized);
-		table_cluster_extract.setIndices(table_cluster_indices_ptr);
-		table_cluster_extract.filter(*cloud_table_extracted);
-		*cloud_proj_ = *cloud_table_extracted;
-
-		// recompute based on the new chosen table cluster
-		pcl::compute3DCentroid(*cloud_proj_, table_centroid);
-
-	} else {
-		// Don't mess with the table, clustering didn't help to make it any better
-		logger->log_info(name(),
-		                 "[L %u] table plane clustering did not generate any clusters",
-		                 loop_count_);
-	}
-
-	TIMETRACK_INTER(ttc_cluster_plane_, ttc_convex_hull_)
-
-	// Estimate 3D convex hull -> TABLE BOUNDARIES
-	pcl::ConvexHull<PointType> hr;
-#ifdef PCL_VERSION_COMPARE
-#	if PCL_VERSION_COMPARE(>=, 1, 5, 0)
-	hr.setDimension(2);
-#	endif
-#endif
-
-	//hr.setAlpha(0.1);  // only for ConcaveHull
-	hr.setInputCloud(cloud_proj_);
-	cloud_hull_.reset(new Cloud());
-	hr.reconstruct(*cloud_hull_);
-
-	if (cloud_hull_->points.empty()) {
-		logger->log_warn(name(), "[L %u] convex hull of table empty, skipping loop", loop_count_);
-		TIMETRACK_ABORT(ttc_convex_hull_);
-		TIMETRACK_ABORT(ttc_full_loop_);
-		set_position(table_pos_if_, false);
-		return;
 	}
 
-	TIMETRACK_INTER(ttc_convex_hull_, ttc_simplify_polygon_)
-
-	CloudPtr simplified_polygon = simplify_polygon(cloud_hull_, 0.02);
-	*simplified_polygon_        = *simplified_polygon;
-	//logger->log_debug(name(), "Original polygon: %zu  simplified: %zu", cloud_hull_->points.size(),
-	//                  simplified_polygon->points.size());
-	*cloud_hull_ = *simplified_polygon;
+	TIMETRACK_START(ttc_find_edge_);
 
-	TIMETRACK_INTER(ttc_simplify_polygon_, ttc_find_edge_)
+	model_cloud_hull_->clear();
 
 #ifdef HAVE_VISUAL_DEBUGGING
 	TabletopVisualizationThreadBase::V_Vector4f good_hull_edges;
@@ -682,8 +581,7 @@ TabletopObjectsThread::loop()
 		  * Eigen::Quaternionf(q.w(), q.x(), q.y(), q.z());
 
 		// Transform polygon cloud into base_link frame
-		CloudPtr baserel_polygon_cloud(new Cloud());
-		pcl::transformPointCloud(*cloud_hull_, *baserel_polygon_cloud, affine_cloud);
+		pcl::transformPointCloud(*cloud_hull_, *baserel_polygon_cloud_, affine_cloud);
 
 		// Setup plane normals for left, right, and lower frustrum
 		// planes for line segment verification
@@ -730,8 +628,8 @@ TabletopObjectsThread::loop()
 			Eigen::Vector3f p1(p1p.x, p1p.y, p1p.z);
 			Eigen::Vector3f p2(p2p.x, p2p.y, p2p.z);
 
-			PointType &br_p1p = baserel_polygon_cloud->points[i];
-			PointType &br_p2p = baserel_polygon_cloud->points[(i + 1) % psize];
+			PointType &br_p1p = baserel_polygon_cloud_->points[i];
+			PointType &br_p2p = baserel_polygon_cloud_->points[(i + 1) % psize];
 
 			// check if both end points are close to left or right frustrum plane
 			if (!(((left_frustrum_normal.dot(p1) < 0.03) && (left_frustrum_normal.dot(p2) < 0.03))
@@ -746,8 +644,8 @@ TabletopObjectsThread::loop()
 					if ((lf_pidx1 == std::numeric_limits<size_t>::max())
 					    || is_polygon_edge_better(br_p1p,
 					                              br_p2p,
-					                              baserel_polygon_cloud->points[lf_pidx1],
-					                              baserel_polygon_cloud->points[lf_pidx2])) {
+					                              baserel_polygon_cloud_->points[lf_pidx1],
+					                              baserel_polygon_cloud_->points[lf_pidx2])) {
 						// there was no backup candidate, yet, or this one is closer
 						// to the robot, take it.
 						lf_pidx1 = i;
@@ -771,8 +669,8 @@ TabletopObjectsThread::loop()
 
 				if (pidx1 != std::numeric_limits<size_t>::max()) {
 					// current best base-relative points
-					PointType &cb_br_p1p = baserel_polygon_cloud->points[pidx1];
-					PointType &cb_br_p2p = baserel_polygon_cloud->points[pidx2];
+					PointType &cb_br_p1p = baserel_polygon_cloud_->points[pidx1];
+					PointType &cb_br_p2p = baserel_polygon_cloud_->points[pidx2];
 
 					if (!is_polygon_edge_better(cb_br_p1p, cb_br_p2p, br_p1p, br_p2p)) {
 						//logger->log_info(name(), "Skipping: cb(%f,%f)->(%f,%f) c(%f,%f)->(%f,%f)",
@@ -807,8 +705,8 @@ TabletopObjectsThread::loop()
 		// 2. angle(Y_axis, chosen_edge) > threshold
 		// 3.. p1.x or p2.x > centroid.x
 		if (lf_pidx1 != std::numeric_limits<size_t>::max()) {
-			PointType &lp1p = baserel_polygon_cloud->points[lf_pidx1];
-			PointType &lp2p = baserel_polygon_cloud->points[lf_pidx2];
+			PointType &lp1p = baserel_polygon_cloud_->points[lf_pidx1];
+			PointType &lp2p = baserel_polygon_cloud_->points[lf_pidx2];
 
 			Eigen::Vector4f lp1(lp1p.x, lp1p.y, lp1p.z, 0.);
 			Eigen::Vector4f lp2(lp2p.x, lp2p.y, lp2p.z, 0.);
@@ -831,8 +729,8 @@ TabletopObjectsThread::loop()
 #endif
 
 			} else {
-				PointType &p1p = baserel_polygon_cloud->points[pidx1];
-				PointType &p2p = baserel_polygon_cloud->points[pidx2];
+				PointType &p1p = baserel_polygon_cloud_->points[pidx1];
+				PointType &p2p = baserel_polygon_cloud_->points[pidx2];
 
 				Eigen::Vector4f p1(p1p.x, p1p.y, p1p.z, 0.);
 				Eigen::Vector4f p2(p2p.x, p2p.y, p2p.z, 0.);
@@ -872,7 +770,6 @@ TabletopObjectsThread::loop()
 
 		TIMETRACK_END(ttc_find_edge_);
 
-		model_cloud_hull_.reset(new Cloud());
 		if (cfg_table_model_enable_ && (pidx1 != std::numeric_limits<size_t>::max())
 		    && (pidx2 != std::numeric_limits<size_t>::max())) {
 			TIMETRACK_START(ttc_transform_);
@@ -887,7 +784,7 @@ TabletopObjectsThread::loop()
 
 			// Normal vectors for table model and plane
 			Eigen::Vector3f model_normal = Eigen::Vector3f::UnitZ();
-			Eigen::Vector3f normal(coeff->values[0], coeff->values[1], coeff->values[2]);
+			Eigen::Vector3f normal(coeff_->values[0], coeff_->values[1], coeff_->values[2]);
 			normal.normalize(); // just in case
 
 			Eigen::Vector3f table_centroid_3f =
@@ -976,10 +873,7 @@ TabletopObjectsThread::loop()
 			TIMETRACK_INTER(ttc_transform_, ttc_transform_model_)
 
 			// to show fitted table model
-			CloudPtr table_model = generate_table_model(cfg_table_model_length_,
-			                                            cfg_table_model_width_,
-			                                            cfg_table_model_step_);
-			pcl::transformPointCloud(*table_model, *table_model_, affine.matrix());
+			pcl::transformPointCloud(*table_model_template_, *table_model_, affine.matrix());
 			//*table_model_ = *model_cloud_hull_;
 			//*table_model_ = *table_model;
 			table_model_->header.frame_id = input_->header.frame_id;
@@ -994,10 +888,13 @@ TabletopObjectsThread::loop()
 		TIMETRACK_ABORT(ttc_find_edge_);
 	}
 
+	stage_timing_->stage_done(STAGE_TABLE_MODEL);
+
 	TIMETRACK_START(ttc_extract_non_plane_);
 	// Extract all non-plane points
-	cloud_filt_.reset(new Cloud());
 	extract_.setNegative(true);
+	extract_.setInputCloud(cloud_voxelized_);
+	extract_.setIndices(inliers_);
 	extract_.filter(*cloud_filt_);
 
 	TIMETRACK_INTER(ttc_extract_non_plane_, ttc_polygon_filter_);
@@ -1032,16 +929,15 @@ TabletopObjectsThread::loop()
 	// We make use of the fact that we only have a boring RGB-D camera and
 	// not an X-Ray...
 	pcl::ComparisonOps::CompareOp op =
-	  viewpoint_above ? (coeff->values[3] > 0 ? pcl::ComparisonOps::GT : pcl::ComparisonOps::LT)
-	                  : (coeff->values[3] < 0 ? pcl::ComparisonOps::GT : pcl::ComparisonOps::LT);
+	  viewpoint_above ? (coeff_->values[3] > 0 ? pcl::ComparisonOps::GT : pcl::ComparisonOps::LT)
+	                  : (coeff_->values[3] < 0 ? pcl::ComparisonOps::GT : pcl::ComparisonOps::LT);
 	pcl_utils::PlaneDistanceComparison<PointType>::ConstPtr above_comp(
-	  new pcl_utils::PlaneDistanceComparison<PointType>(coeff, op));
+	  new pcl_utils::PlaneDistanceComparison<PointType>(coeff_, op));
 	pcl::ConditionAnd<PointType>::Ptr above_cond(new pcl::ConditionAnd<PointType>());
 	above_cond->addComparison(above_comp);
 	pcl::ConditionalRemoval<PointType> above_condrem;
 	above_condrem.setCondition(above_cond);
 	above_condrem.setInputCloud(cloud_filt_);
-	cloud_above_.reset(new Cloud());
 	above_condrem.filter(*cloud_above_);
 
 	//printf("Before: %zu  After: %zu\n", cloud_filt_->points.size(),
@@ -1060,8 +956,7 @@ TabletopObjectsThread::loop()
 
 	pcl_utils::PolygonComparison<PointType>::ConstPtr inpoly_comp(
 	  new pcl_utils::PolygonComparison<PointType>(
-	    (model_cloud_hull_ && !model_cloud_hull_->points.empty()) ? *model_cloud_hull_
-	                                                              : *cloud_hull_));
+	    !model_cloud_hull_->points.empty() ? *model_cloud_hull_ : *cloud_hull_));
 	polygon_cond->addComparison(inpoly_comp);
 
 	// build the filter
@@ -1069,7 +964,6 @@ TabletopObjectsThread::loop()
 	condrem.setCondition(polygon_cond);
 	condrem.setInputCloud(cloud_above_);
 	//condrem.setKeepOrganized(true);
-	cloud_objs_.reset(new Cloud());
 	condrem.filter(*cloud_objs_);
 
 	//CloudPtr table_points(new Cloud());
@@ -1081,13 +975,13 @@ TabletopObjectsThread::loop()
 
 	TIMETRACK_INTER(ttc_polygon_filter_, ttc_table_to_output_);
 
-	std::vector<int> indices(cloud_proj_->points.size());
-	for (uint i = 0; i < indices.size(); i++)
-		indices[i] = i;
-	ColorCloudPtr tmp_clusters = colorize_cluster(cloud_proj_, indices, table_color);
-	tmp_clusters->height       = 1;
-	tmp_clusters->is_dense     = false;
-	tmp_clusters->width        = cloud_proj_->points.size();
+	table_indices_.resize(cloud_proj_->points.size());
+	for (uint i = 0; i < table_indices_.size(); i++)
+		table_indices_[i] = i;
+	colorize_cluster(cloud_proj_, table_indices_, table_color, *tmp_clusters_);
+	tmp_clusters_->height   = 1;
+	tmp_clusters_->is_dense = false;
+	tmp_clusters_->width    = cloud_proj_->points.size();
 
 	TIMETRACK_INTER(ttc_table_to_output_, ttc_cluster_objects_);
 
@@ -1095,15 +989,13 @@ TabletopObjectsThread::loop()
 	if (cloud_objs_->points.size() > 0) {
 		//TODO: perform statistical outlier removal at this point before clustering.
 		//Outlier removal
-		pcl::StatisticalOutlierRemoval<PointType> sor;
-		sor.setInputCloud(cloud_objs_);
-		sor.setMeanK(5);
-		sor.setStddevMulThresh(0.2);
-		sor.filter(*cloud_objs_);
+		sor_.setInputCloud(cloud_objs_);
+		sor_.filter(*cloud_objs_);
 	}
+	stage_timing_->stage_done(STAGE_OBJECT_FILTER);
 	//OBJECTS
 	std::vector<pcl::PointCloud<ColorPointType>::Ptr> tmp_obj_clusters(MAX_CENTROIDS);
-	object_count = cluster_objects(cloud_objs_, tmp_clusters, tmp_obj_clusters);
+	object_count = cluster_objects(cloud_objs_, tmp_clusters_, tmp_obj_clusters);
 	if (object_count == 0) {
 		logger->log_info(name(), "No clustered points found");
 	}
@@ -1135,7 +1027,7 @@ TabletopObjectsThread::loop()
 
 	TIMETRACK_INTER(ttc_cluster_objects_, ttc_visualization_)
 
-	*clusters_                  = *tmp_clusters;
+	*clusters_                  = *tmp_clusters_;
 	fclusters_->header.frame_id = input_->header.frame_id;
 	pcl_utils::copy_time(input_, fclusters_);
 	pcl_utils::copy_time(input_, ftable_model_);
@@ -1153,12 +1045,14 @@ TabletopObjectsThread::loop()
 		pcl_utils::copy_time(input_, f_obj_clusters_[i]);
 	}
 
+	stage_timing_->stage_done(STAGE_OUTPUT);
+
 #ifdef HAVE_VISUAL_DEBUGGING
 	if (visthread_) {
 		Eigen::Vector4f normal;
-		normal[0] = coeff->values[0];
-		normal[1] = coeff->values[1];
-		normal[2] = coeff->values[2];
+		normal[0] = coeff_->values[0];
+		normal[1] = coeff_->values[1];
+		normal[2] = coeff_->values[2];
 		normal[3] = 0.;
 
 		TabletopVisualizationThreadBase::V_Vector4f hull_vertices;
@@ -1197,6 +1091,8 @@ TabletopObjectsThread::loop()
 	TIMETRACK_END(ttc_visualization_);
 	TIMETRACK_END(ttc_full_loop_);
 
+	stage_timing_->publish_metrics();
+
 #ifdef USE_TIMETRACKER
 	if (++tt_loopcount_ >= 5) {
 		tt_loopcount_ = 0;
@@ -1205,6 +1101,299 @@ TabletopObjectsThread::loop()
 #endif
 }
 
+/** Find the table plane in the voxelized input cloud.
+ * This will search for the first plane which:
+ * 1. has a considerable amount of points (>= some percentage of input points)
+ * 2. is parallel to the floor (transformed normal angle to Z axis in specified epsilon)
+ * 3. is on a typical table height (at a specified height range in robot frame)
+ * Planes found along the way not satisfying any of the criteria are removed,
+ * the first plane either satisfying all criteria, or violating the first
+ * one end the search.
+ * @param baserel_table_centroid upon return the table centroid in the base frame
+ * @return true if a table plane was found, false otherwise
+ */
+bool
+TabletopObjectsThread::find_table_plane(Eigen::Vector4f &baserel_table_centroid)
+{
+	TIMETRACK_START(ttc_plane_);
+
+	bool happy_with_plane = false;
+	while (!happy_with_plane) {
+		happy_with_plane = true;
+
+		if (cloud_voxelized_->points.size() <= 10) {
+			logger->log_warn(name(),
+			                 "[L %u] no more points for plane detection, skipping loop",
+			                 loop_count_);
+			set_position(table_pos_if_, false);
+			TIMETRACK_ABORT(ttc_plane_);
+			return false;
+		}
+
+		seg_.setInputCloud(cloud_voxelized_);
+		seg_.segment(*inliers_, *coeff_);
+
+		// 1. check for a minimum number of expected inliers
+		if ((double)inliers_->indices.size()
+		    < (cfg_segm_inlier_quota_ * (double)cloud_voxelized_->points.size())) {
+			logger->log_warn(
+			  name(),
+			  "[L %u] no table in scene, skipping loop (%zu inliers, required %f, voxelized size %zu)",
+			  loop_count_,
+			  inliers_->indices.size(),
+			  (cfg_segm_inlier_quota_ * cloud_voxelized_->points.size()),
+			  cloud_voxelized_->points.size());
+			set_position(table_pos_if_, false);
+			TIMETRACK_ABORT(ttc_plane_);
+			return false;
+		}
+
+		// 2. Check angle between normal vector and Z axis of the
+		// base_link robot frame since tables are usually parallel to the ground...
+		try {
+			tf::Stamped<tf::Vector3> table_normal(tf::Vector3(coeff_->values[0],
+			                                                  coeff_->values[1],
+			                                                  coeff_->values[2]),
+			                                      fawkes::Time(0, 0),
+			                                      input_->header.frame_id);
+
+			tf::Stamped<tf::Vector3> baserel_normal;
+			tf_listener->transform_vector(cfg_base_frame_, table_normal, baserel_normal);
+			tf::Vector3 z_axis(0, 0, copysign(1.0, baserel_normal.z()));
+			table_inclination_ = z_axis.angle(baserel_normal);
+			if (fabs(z_axis.angle(baserel_normal)) > cfg_max_z_angle_deviation_) {
+				happy_with_plane = false;
+				logger->log_warn(name(),
+				                 "[L %u] table normal (%f,%f,%f) Z angle deviation |%f| > %f, excluding",
+				                 loop_count_,
+				                 baserel_normal.x(),
+				                 baserel_normal.y(),
+				                 baserel_normal.z(),
+				                 z_axis.angle(baserel_normal),
+				                 cfg_max_z_angle_deviation_);
+			}
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Transforming normal failed, exception follows");
+			logger->log_warn(name(), e);
+			happy_with_plane = false;
+		}
+
+		if (happy_with_plane) {
+			// ok so far
+
+			// 3. Calculate table centroid, then transform it to the base_link system
+			// to make a table height sanity check, they tend to be at a specific height...
+			try {
+				pcl::compute3DCentroid(*cloud_voxelized_, *inliers_, table_centroid);
+				tf::Stamped<tf::Point> centroid(tf::Point(table_centroid[0],
+				                                          table_centroid[1],
+				                                          table_centroid[2]),
+				                                fawkes::Time(0, 0),
+				                                input_->header.frame_id);
+				tf::Stamped<tf::Point> baserel_centroid;
+				tf_listener->transform_point(cfg_base_frame_, centroid, baserel_centroid);
+				baserel_table_centroid[0] = baserel_centroid.x();
+				baserel_table_centroid[1] = baserel_centroid.y();
+				baserel_table_centroid[2] = baserel_centroid.z();
+
+				if ((baserel_centroid.z() < cfg_table_min_height_)
+				    || (baserel_centroid.z() > cfg_table_max_height_)) {
+					happy_with_plane = false;
+					logger->log_warn(name(),
+					                 "[L %u] table height %f not in range [%f, %f]",
+					                 loop_count_,
+					                 baserel_centroid.z(),
+					                 cfg_table_min_height_,
+					                 cfg_table_max_height_);
+				}
+			} catch (tf::TransformException &e) {
+				//logger->log_warn(name(), "Transforming centroid failed, exception follows");
+				//logger->log_warn(name(), e);
+			}
+		}
+
+		if (!happy_with_plane) {
+			// throw away
+			extract_.setNegative(true);
+			extract_.setInputCloud(cloud_voxelized_);
+			extract_.setIndices(inliers_);
+			extract_.filter(*cloud_scratch_);
+			cloud_voxelized_.swap(cloud_scratch_);
+		}
+	}
+
+	// If we got here we found the table
+	// Do NOT set it here, we will still try to determine the rotation as well
+	// set_position(table_pos_if_, true, table_centroid);
+
+	TIMETRACK_END(ttc_plane_);
+	return true;
+}
+
+/** Extract the table and determine its convex hull.
+ * Projects the table inliers onto the plane, keeps only the largest
+ * cluster of the downsampled table points and calculates the simplified
+ * convex hull of it.
+ * @return true if a convex hull was determined, false otherwise
+ */
+bool
+TabletopObjectsThread::extract_table_hull()
+{
+	TIMETRACK_START(ttc_extract_plane_);
+
+	extract_.setNegative(false);
+	extract_.setInputCloud(cloud_voxelized_);
+	extract_.setIndices(inliers_);
+	extract_.filter(*cloud_plane_);
+
+	// Project the model inliers
+	proj_.setInputCloud(cloud_plane_);
+	proj_.filter(*cloud_proj_);
+
+	TIMETRACK_INTER(ttc_extract_plane_, ttc_plane_downsampling_);
+
+	// ***
+	// In the following cluster the projected table plane. This is done to get
+	// the largest continuous part of the plane to remove outliers, for instance
+	// if the intersection of the plane with a wall or object is taken into the
+	// table points.
+	// To achieve this cluster, if an acceptable cluster was found, extract this
+	// cluster as the new table points. Otherwise continue with the existing
+	// point cloud.
+
+	// further downsample table
+	table_grid_.setInputCloud(cloud_proj_);
+	table_grid_.filter(*cloud_table_voxelized_);
+
+	TIMETRACK_INTER(ttc_plane_downsampling_, ttc_cluster_plane_);
+
+	table_cluster_indices_.clear();
+	table_ec_.setMinClusterSize(cfg_table_min_cluster_quota_ * cloud_table_voxelized_->points.size());
+	table_ec_.setMaxClusterSize(cloud_table_voxelized_->points.size());
+	table_ec_.setInputCloud(cloud_table_voxelized_);
+	table_ec_.extract(table_cluster_indices_);
+
+	if (!table_cluster_indices_.empty()) {
+		// take the first, i.e. the largest cluster
+		table_cluster_inliers_->indices.swap(table_cluster_indices_[0].indices);
+		pcl::ExtractIndices<PointType> table_cluster_extract;
+		table_cluster_extract.setNegative(false);
+		table_cluster_extract.setInputCloud(cloud_table_voxelized_);
+		table_cluster_extract.setIndices(table_cluster_inliers_);
+		table_cluster_extract.filter(*cloud_scratch_);
+		cloud_proj_.swap(cloud_scratch_);
+
+		// recompute based on the new chosen table cluster
+		pcl::compute3DCentroid(*cloud_proj_, table_centroid);
+
+	} else {
+		// Don't mess with the table, clustering didn't help to make it any better
+		logger->log_info(name(),
+		                 "[L %u] table plane clustering did not generate any clusters",
+		                 loop_count_);
+	}
+
+	TIMETRACK_INTER(ttc_cluster_plane_, ttc_convex_hull_)
+
+	// Estimate 3D convex hull -> TABLE BOUNDARIES
+	//hull_.setAlpha(0.1);  // only for ConcaveHull
+	hull_.setInputCloud(cloud_proj_);
+	hull_.reconstruct(*cloud_hull_);
+
+	if (cloud_hull_->points.empty()) {
+		logger->log_warn(name(), "[L %u] convex hull of table empty, skipping loop", loop_count_);
+		TIMETRACK_ABORT(ttc_convex_hull_);
+		return false;
+	}
+
+	TIMETRACK_INTER(ttc_convex_hull_, ttc_simplify_polygon_)
+
+	CloudPtr simplified_polygon = simplify_polygon(cloud_hull_, 0.02);
+	*simplified_polygon_        = *simplified_polygon;
+	//logger->log_debug(name(), "Original polygon: %zu  simplified: %zu", cloud_hull_->points.size(),
+	//                  simplified_polygon->points.size());
+	*cloud_hull_ = *simplified_polygon;
+
+	TIMETRACK_END(ttc_simplify_polygon_);
+	return true;
+}
+
+/** Get the current pose of the camera in the fixed frame.
+ * @param pose upon success set to the camera pose
+ * @return true if the pose could be determined, false otherwise
+ */
+bool
+TabletopObjectsThread::lookup_camera_pose(tf::Transform &pose)
+{
+	try {
+		tf::StampedTransform t;
+		tf_listener->lookup_transform(cfg_table_reuse_fixed_frame_,
+		                              input_->header.frame_id,
+		                              fawkes::Time(0, 0),
+		                              t);
+		pose = t;
+		return true;
+	} catch (Exception &e) {
+		return false;
+	}
+}
+
+/** Reuse the table of a previous loop if possible.
+ * The table is reused if the camera has not moved (within the configured
+ * bounds) with respect to the fixed frame since the table was segmented,
+ * the table has not been reused too often in a row, and the table plane
+ * still explains enough points of the current voxelized cloud. In that
+ * case the plane inliers are determined for the current cloud and the
+ * table centroid is restored.
+ * @param camera_pose current pose of the camera in the fixed frame
+ * @param baserel_table_centroid upon success set to the table centroid
+ * in the base frame
+ * @return true if the table was reused, false if it must be segmented
+ */
+bool
+TabletopObjectsThread::reuse_table(const tf::Transform &camera_pose,
+                                   Eigen::Vector4f     &baserel_table_centroid)
+{
+	if (!table_cached_ || table_cache_age_ >= cfg_table_reuse_max_age_) {
+		return false;
+	}
+
+	double translation = camera_pose.getOrigin().distance(table_cache_camera_pose_.getOrigin());
+	double cos_half_angle =
+	  fabs(camera_pose.getRotation().dot(table_cache_camera_pose_.getRotation()));
+	double rotation = 2. * acos(std::min(1.0, cos_half_angle));
+	if (translation > cfg_table_reuse_max_translation_ || rotation > cfg_table_reuse_max_rotation_) {
+		return false;
+	}
+
+	const float  a          = coeff_->values[0];
+	const float  b          = coeff_->values[1];
+	const float  c          = coeff_->values[2];
+	const float  d          = coeff_->values[3];
+	const size_t num_points = cloud_voxelized_->points.size();
+	inliers_->indices.clear();
+	for (size_t i = 0; i < num_points; ++i) {
+		const PointType &p = cloud_voxelized_->points[i];
+		if (fabs(a * p.x + b * p.y + c * p.z + d) <= cfg_segm_distance_threshold_) {
+			inliers_->indices.push_back(i);
+		}
+	}
+
+	if ((double)inliers_->indices.size() < (cfg_segm_inlier_quota_ * (double)num_points)) {
+		logger->log_debug(name(),
+		                  "[L %u] table plane does not fit anymore (%zu of %zu inliers)",
+		                  loop_count_,
+		                  inliers_->indices.size(),
+		                  num_points);
+		return false;
+	}
+
+	table_centroid         = table_cache_centroid_;
+	baserel_table_centroid = table_cache_baserel_centroid_;
+	table_cache_age_ += 1;
+	return true;
+}
+
 std::vector<pcl::PointIndices>
 TabletopObjectsThread::extract_object_clusters(CloudConstPtr input)
 {
@@ -1214,18 +1403,9 @@ TabletopObjectsThread::extract_object_clusters(CloudConstPtr input)
 		TIMETRACK_ABORT(ttc_obj_extraction_);
 		return cluster_indices;
 	}
-	// Creating the KdTree object for the search method of the extraction
-
-	pcl::search::KdTree<PointType>::Ptr kdtree_cl(new pcl::search::KdTree<PointType>());
-	kdtree_cl->setInputCloud(input);
-
-	pcl::EuclideanClusterExtraction<PointType> ec;
-	ec.setClusterTolerance(cfg_cluster_tolerance_);
-	ec.setMinClusterSize(cfg_cluster_min_size_);
-	ec.setMaxClusterSize(cfg_cluster_max_size_);
-	ec.setSearchMethod(kdtree_cl);
-	ec.setInputCloud(input);
-	ec.extract(cluster_indices);
+	// the extraction builds the KdTree for the search on the input
+	objs_ec_.setInputCloud(input);
+	objs_ec_.extract(cluster_indices);
 
 	//logger->log_debug(name(), "Found %zu clusters", cluster_indices.size());
 	TIMETRACK_END(ttc_obj_extraction_);
@@ -1251,6 +1431,7 @@ TabletopObjectsThread::cluster_objects(CloudConstPtr               input_cloud,
 {
 	unsigned int                   object_count    = 0;
 	std::vector<pcl::PointIndices> cluster_indices = extract_object_clusters(input_cloud);
+	stage_timing_->stage_done(STAGE_OBJECT_CLUSTERING);
 	std::vector<pcl::PointIndices>::const_iterator it;
 	unsigned int                                   num_points = 0;
 	for (it = cluster_indices.begin(); it != cluster_indices.end(); ++it)
@@ -1262,53 +1443,56 @@ TabletopObjectsThread::cluster_objects(CloudConstPtr               input_cloud,
 		std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f>> new_centroids(
 		  MAX_CENTROIDS);
 
-		unsigned int centroid_i = 0;
-
 		std::vector<double> init_likelihoods;
 		init_likelihoods.resize(NUM_KNOWN_OBJS_ + 1, 0.0);
 		for (uint i = 0; i < MAX_CENTROIDS; i++)
 			obj_likelihoods_[i] = init_likelihoods;
 
-		for (it = cluster_indices.begin(); it != cluster_indices.end() && centroid_i < MAX_CENTROIDS;
-		     ++it, ++centroid_i) {
-			logger->log_debug(name(),
-			                  "********************Processing obj_%u********************",
-			                  centroid_i);
-
-			//Centroids in cam frame:
-			//pcl::compute3DCentroid(*cloud_objs_, it->indices, centroids[centroid_i]);
-
-			// TODO fix this; we only want to copy the cluster, the color is incorrect
-			ColorCloudPtr single_cluster =
-			  colorize_cluster(input_cloud, it->indices, cluster_colors[centroid_i]);
-			single_cluster->header.frame_id = input_cloud->header.frame_id;
-			single_cluster->width           = it->indices.size();
-			single_cluster->height          = 1;
-
-			ColorCloudPtr obj_in_base_frame(new ColorCloud());
-			obj_in_base_frame->header.frame_id = cfg_base_frame_;
-			obj_in_base_frame->width           = it->indices.size();
-			obj_in_base_frame->height          = 1;
-			obj_in_base_frame->points.resize(it->indices.size());
-
-			// don't add cluster here since the id is wrong
-			//*obj_clusters_[obj_i++] = *single_cluster;
-
-			pcl_utils::transform_pointcloud(cfg_base_frame_,
-			                                *single_cluster,
-			                                *obj_in_base_frame,
-			                                *tf_listener);
-
-			pcl::compute3DCentroid(*obj_in_base_frame, new_centroids[centroid_i]);
-
-			if (cfg_cylinder_fitting_) {
-				new_centroids[centroid_i] =
-				  fit_cylinder(obj_in_base_frame, new_centroids[centroid_i], centroid_i);
-			}
+		object_count = std::min<size_t>(cluster_indices.size(), MAX_CENTROIDS);
+
+		// Clusters are processed in parallel, make sure the result maps have
+		// entries for all of them, fit_cylinder() must not modify the maps.
+		for (unsigned int i = 0; i < object_count; ++i) {
+			cylinder_params_[i];
+			obj_shape_confidence_[i];
+			best_obj_guess_[i];
 		}
-		object_count = centroid_i;
+
+		task_pool->parallel_for(
+		  0,
+		  object_count,
+		  [this, &input_cloud, &cluster_indices, &new_centroids](size_t begin, size_t end) {
+			  for (size_t centroid_i = begin; centroid_i < end; ++centroid_i) {
+				  logger->log_debug(name(),
+				                    "********************Processing obj_%zu********************",
+				                    centroid_i);
+
+				  const std::vector<int> &indices = cluster_indices[centroid_i].indices;
+				  ClusterWorkspace       &ws      = cluster_ws_[centroid_i];
+
+				  // TODO fix this; we only want to copy the cluster, the color is incorrect
+				  colorize_cluster(input_cloud, indices, cluster_colors[centroid_i], *ws.cluster);
+				  ws.cluster->width  = indices.size();
+				  ws.cluster->height = 1;
+
+				  pcl_utils::transform_pointcloud(cfg_base_frame_,
+				                                  *ws.cluster,
+				                                  *ws.baserel_cluster,
+				                                  *tf_listener);
+
+				  pcl::compute3DCentroid(*ws.baserel_cluster, new_centroids[centroid_i]);
+
+				  if (cfg_cylinder_fitting_) {
+					  new_centroids[centroid_i] =
+					    fit_cylinder(ws.baserel_cluster, new_centroids[centroid_i], centroid_i, ws);
+				  }
+			  }
+		  },
+		  1);
 		new_centroids.resize(object_count);
 
+		stage_timing_->stage_done(STAGE_OBJECT_FITTING);
+
 		// save cylinder fitting variables
 		// to temporary variables to be able to reassign IDs
 		CentroidMap                         cylinder_params(cylinder_params_);
@@ -1346,10 +1530,11 @@ TabletopObjectsThread::cluster_objects(CloudConstPtr               input_cloud,
 			obj_shape_confidence_[assigned_id] = obj_shape_confidence[i];
 			best_obj_guess_[assigned_id]       = best_obj_guess[i];
 			obj_likelihoods_[assigned_id]      = obj_likelihoods[i];
-			ColorCloudPtr colorized_cluster =
-			  colorize_cluster(input_cloud,
-			                   cluster_indices[i].indices,
-			                   cluster_colors[assigned_id % MAX_CENTROIDS]);
+			ColorCloudPtr colorized_cluster = cluster_ws_[i].cluster;
+			colorize_cluster(input_cloud,
+			                 cluster_indices[i].indices,
+			                 cluster_colors[assigned_id % MAX_CENTROIDS],
+			                 *colorized_cluster);
 			*tmp_clusters += *colorized_cluster;
 			tmp_obj_clusters[assigned_id] = colorized_cluster;
 		}
@@ -1357,6 +1542,8 @@ TabletopObjectsThread::cluster_objects(CloudConstPtr               input_cloud,
 		// remove all centroids too high above the table
 		remove_high_centroids(table_centroid, tmp_centroids);
 
+		stage_timing_->stage_done(STAGE_TRACKING);
+
 		if (object_count > 0)
 			first_run_ = false;
 	} else {
@@ -1376,11 +1563,21 @@ TabletopObjectsThread::colorize_cluster(CloudConstPtr           input_cloud,
                                         const uint8_t           color[])
 {
 	ColorCloudPtr result(new ColorCloud());
-	result->resize(cluster.size());
-	result->header.frame_id = input_cloud->header.frame_id;
-	uint i                  = 0;
+	colorize_cluster(input_cloud, cluster, color, *result);
+	return result;
+}
+
+void
+TabletopObjectsThread::colorize_cluster(CloudConstPtr           input_cloud,
+                                        const std::vector<int> &cluster,
+                                        const uint8_t           color[],
+                                        ColorCloud             &result)
+{
+	result.resize(cluster.size());
+	result.header.frame_id = input_cloud->header.frame_id;
+	uint i                 = 0;
 	for (std::vector<int>::const_iterator it = cluster.begin(); it != cluster.end(); ++it, ++i) {
-		ColorPointType  &p1 = result->points.at(i);
+		ColorPointType  &p1 = result.points.at(i);
 		const PointType &p2 = input_cloud->points.at(*it);
 		p1.x                = p2.x;
 		p1.y                = p2.y;
@@ -1389,7 +1586,6 @@ TabletopObjectsThread::colorize_cluster(CloudConstPtr           input_cloud,
 		p1.g                = color[1];
 		p1.b                = color[2];
 	}
-	return result;
 }
 
 bool
@@ -1713,7 +1909,8 @@ TabletopObjectsThread::remove_high_centroids(Eigen::Vector4f table_centroid, Cen
 Eigen::Vector4f
 TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
                                     Eigen::Vector4f const &centroid,
-                                    uint const            &centroid_i)
+                                    uint const            &centroid_i,
+                                    ClusterWorkspace      &ws)
 {
 	Eigen::Vector4f                                                         new_centroid(centroid);
 	ColorPointType                                                          pnt_min, pnt_max;
@@ -1735,7 +1932,7 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 		                  obj_size_scores[os][0],
 		                  obj_size_scores[os][1],
 		                  obj_size_scores[os][2]);
-		obj_likelihoods_[centroid_i][os] =
+		obj_likelihoods_.at(centroid_i)[os] =
 		  (double)obj_size_scores[os][0] * obj_size_scores[os][1] * obj_size_scores[os][2];
 	}
 
@@ -1744,10 +1941,10 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 	pcl::SACSegmentationFromNormals<ColorPointType, pcl::Normal> seg;
 	pcl::ExtractIndices<ColorPointType>                          extract;
 	pcl::ExtractIndices<pcl::Normal>                             extract_normals;
-	pcl::PointCloud<pcl::Normal>::Ptr        obj_normals(new pcl::PointCloud<pcl::Normal>);
-	pcl::search::KdTree<ColorPointType>::Ptr tree_cyl(new pcl::search::KdTree<ColorPointType>());
-	pcl::ModelCoefficients::Ptr              coefficients_cylinder(new pcl::ModelCoefficients);
-	pcl::PointIndices::Ptr                   inliers_cylinder(new pcl::PointIndices);
+	pcl::PointCloud<pcl::Normal>::Ptr        obj_normals           = ws.normals;
+	pcl::search::KdTree<ColorPointType>::Ptr tree_cyl              = ws.kdtree;
+	pcl::ModelCoefficients::Ptr              coefficients_cylinder = ws.coefficients;
+	pcl::PointIndices::Ptr                   inliers_cylinder      = ws.inliers;
 
 	// Estimate point normals
 	ne.setSearchMethod(tree_cyl);
@@ -1776,27 +1973,26 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 	extract.setInputCloud(obj_in_base_frame);
 	extract.setIndices(inliers_cylinder);
 	extract.setNegative(false);
-	pcl::PointCloud<ColorPointType>::Ptr cloud_cylinder_baserel(
-	  new pcl::PointCloud<ColorPointType>());
+	pcl::PointCloud<ColorPointType>::Ptr cloud_cylinder_baserel = ws.cylinder;
 	extract.filter(*cloud_cylinder_baserel);
 
-	cylinder_params_[centroid_i][0] = 0;
-	cylinder_params_[centroid_i][1] = 0;
+	cylinder_params_.at(centroid_i)[0] = 0;
+	cylinder_params_.at(centroid_i)[1] = 0;
 	if (cloud_cylinder_baserel->points.empty()) {
 		logger->log_debug(name(), "No cylinder inliers!!");
-		obj_shape_confidence_[centroid_i] = 0.0;
+		obj_shape_confidence_.at(centroid_i) = 0.0;
 	} else {
 		if (!tf_listener->frame_exists(cloud_cylinder_baserel->header.frame_id)) {
 			return centroid;
 		}
 
-		obj_shape_confidence_[centroid_i] =
+		obj_shape_confidence_.at(centroid_i) =
 		  (double)(cloud_cylinder_baserel->points.size()) / (obj_in_base_frame->points.size() * 1.0);
 		logger->log_debug(name(),
 		                  "Cylinder fit confidence = %zu/%zu = %f",
 		                  cloud_cylinder_baserel->points.size(),
 		                  obj_in_base_frame->points.size(),
-		                  obj_shape_confidence_[centroid_i]);
+		                  obj_shape_confidence_.at(centroid_i));
 
 		ColorPointType pnt_min;
 		ColorPointType pnt_max;
@@ -1813,10 +2009,10 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 		}
 		//Cylinder radius:
 		//cylinder_params_[centroid_i][0] = (*coefficients_cylinder).values[6];
-		cylinder_params_[centroid_i][0] = obj_dim[1] / 2;
+		cylinder_params_.at(centroid_i)[0] = obj_dim[1] / 2;
 		//Cylinder height:
 		//cylinder_params_[centroid_i][1] = (pnt_max->z - pnt_min->z);
-		cylinder_params_[centroid_i][1] = obj_dim[2];
+		cylinder_params_.at(centroid_i)[1] = obj_dim[2];
 
 		//cylinder_params_[centroid_i][2] = table_inclination_;
 
@@ -1829,18 +2025,18 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 	signed int detected_obj_id = -1;
 	double     best_confidence = 0.0;
 	if (cfg_verbose_cylinder_fitting_) {
-		logger->log_debug(name(), "Shape similarity = %f", obj_shape_confidence_[centroid_i]);
+		logger->log_debug(name(), "Shape similarity = %f", obj_shape_confidence_.at(centroid_i));
 	}
 	for (int os = 0; os < NUM_KNOWN_OBJS_; os++) {
 		if (cfg_verbose_cylinder_fitting_) {
 			logger->log_debug(name(), "** Similarity to known cup %i:", os);
-			logger->log_debug(name(), "Size similarity  = %f", obj_likelihoods_[centroid_i][os]);
-			obj_likelihoods_[centroid_i][os] =
-			  (0.6 * obj_likelihoods_[centroid_i][os]) + (0.4 * obj_shape_confidence_[centroid_i]);
-			logger->log_debug(name(), "Overall similarity = %f", obj_likelihoods_[centroid_i][os]);
+			logger->log_debug(name(), "Size similarity  = %f", obj_likelihoods_.at(centroid_i)[os]);
+			obj_likelihoods_.at(centroid_i)[os] = (0.6 * obj_likelihoods_.at(centroid_i)[os])
+			                                      + (0.4 * obj_shape_confidence_.at(centroid_i));
+			logger->log_debug(name(), "Overall similarity = %f", obj_likelihoods_.at(centroid_i)[os]);
 		}
-		if (obj_likelihoods_[centroid_i][os] > best_confidence) {
-			best_confidence = obj_likelihoods_[centroid_i][os];
+		if (obj_likelihoods_.at(centroid_i)[os] > best_confidence) {
+			best_confidence = obj_likelihoods_.at(centroid_i)[os];
 			detected_obj_id = os;
 		}
 	}
@@ -1848,7 +2044,7 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 		logger->log_debug(name(), "********************Object Result********************");
 	}
 	if (best_confidence > 0.6) {
-		best_obj_guess_[centroid_i] = detected_obj_id;
+		best_obj_guess_.at(centroid_i) = detected_obj_id;
 
 		if (cfg_verbose_cylinder_fitting_) {
 			logger->log_debug(name(),
@@ -1856,7 +2052,7 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 			                  detected_obj_id);
 		}
 	} else {
-		best_obj_guess_[centroid_i] = -1;
+		best_obj_guess_.at(centroid_i) = -1;
 		if (cfg_verbose_cylinder_fitting_) {
 			logger->log_debug(name(), "No match found.");
 		}
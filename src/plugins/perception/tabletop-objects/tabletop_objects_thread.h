@@ -28,6 +28,7 @@
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <aspect/pointcloud.h>
+#include <aspect/task_pool.h>
 #include <aspect/tf.h>
 #include <core/threading/thread.h>
 #include <pcl/ModelCoefficients.h>
@@ -35,13 +36,17 @@
 #include <pcl/features/normal_3d.h>
 #include <pcl/filters/extract_indices.h>
 #include <pcl/filters/passthrough.h>
+#include <pcl/filters/project_inliers.h>
 #include <pcl/filters/statistical_outlier_removal.h>
 #include <pcl/filters/voxel_grid.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <pcl/sample_consensus/method_types.h>
 #include <pcl/sample_consensus/model_types.h>
+#include <pcl/search/kdtree.h>
+#include <pcl/segmentation/extract_clusters.h>
 #include <pcl/segmentation/sac_segmentation.h>
+#include <pcl/surface/convex_hull.h>
 
 #include <Eigen/StdVector>
 #include <list>
@@ -56,6 +61,7 @@ class TimeTracker;
 #endif
 } // namespace fawkes
 
+class StageTiming;
 #ifdef HAVE_VISUAL_DEBUGGING
 class TabletopVisualizationThreadBase;
 #endif
@@ -150,7 +156,8 @@ class TabletopObjectsThread : public fawkes::Thread,
                               public fawkes::ConfigurableAspect,
                               public fawkes::BlackBoardAspect,
                               public fawkes::TransformAspect,
-                              public fawkes::PointCloudAspect
+                              public fawkes::PointCloudAspect,
+                              public fawkes::TaskPoolAspect
 {
 public:
 	TabletopObjectsThread();
@@ -184,6 +191,35 @@ private:
 	typedef std::list<OldCentroid, Eigen::aligned_allocator<OldCentroid>> OldCentroidVector;
 	typedef std::vector<fawkes::Position3DInterface *>                    PosIfsVector;
 
+	/** Stages of the pipeline for timing. */
+	typedef enum {
+		STAGE_CONVERT,           ///< input conversion
+		STAGE_VOXELIZE,          ///< downsampling
+		STAGE_TABLE_PLANE,       ///< table plane segmentation or reuse
+		STAGE_TABLE_HULL,        ///< table extraction, clustering and convex hull
+		STAGE_TABLE_MODEL,       ///< table edge search and model fitting
+		STAGE_OBJECT_FILTER,     ///< extraction of points above the table
+		STAGE_OBJECT_CLUSTERING, ///< object clustering
+		STAGE_OBJECT_FITTING,    ///< per-object transformation and cylinder fitting
+		STAGE_TRACKING,          ///< object tracking and ID assignment
+		STAGE_OUTPUT             ///< output of results
+	} Stage;
+
+	/// @cond INTERNALS
+	// Buffers for processing a single object cluster, one per cluster so
+	// that clusters can be processed in parallel.
+	struct ClusterWorkspace
+	{
+		ColorCloudPtr                            cluster;
+		ColorCloudPtr                            baserel_cluster;
+		ColorCloudPtr                            cylinder;
+		pcl::PointCloud<pcl::Normal>::Ptr        normals;
+		pcl::search::KdTree<ColorPointType>::Ptr kdtree;
+		pcl::ModelCoefficients::Ptr              coefficients;
+		pcl::PointIndices::Ptr                   inliers;
+	};
+	/// @endcond
+
 private:
 	void set_position(fawkes::Position3DInterface *iface,
 	                  bool                         is_visible,
@@ -211,11 +247,21 @@ private:
 
 	void convert_colored_input();
 
+	bool find_table_plane(Eigen::Vector4f &baserel_table_centroid);
+	bool extract_table_hull();
+	bool lookup_camera_pose(fawkes::tf::Transform &pose);
+	bool reuse_table(const fawkes::tf::Transform &camera_pose,
+	                 Eigen::Vector4f             &baserel_table_centroid);
+
 	std::vector<pcl::PointIndices> extract_object_clusters(CloudConstPtr input);
 
 	ColorCloudPtr colorize_cluster(CloudConstPtr           input_cloud,
 	                               const std::vector<int> &cluster,
 	                               const uint8_t           color[]);
+	void          colorize_cluster(CloudConstPtr           input_cloud,
+	                               const std::vector<int> &cluster,
+	                               const uint8_t           color[],
+	                               ColorCloud             &result);
 
 	unsigned int cluster_objects(CloudConstPtr               input,
 	                             ColorCloudPtr               tmp_clusters,
@@ -228,7 +274,8 @@ private:
 	void            remove_high_centroids(Eigen::Vector4f table_centroid, CentroidMap centroids);
 	Eigen::Vector4f fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 	                             Eigen::Vector4f const &centroid,
-	                             uint const            &centroid_i);
+	                             uint const            &centroid_i,
+	                             ClusterWorkspace      &ws);
 	std::map<unsigned int, int> track_objects(
 	  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f>> new_centroids);
 
@@ -306,9 +353,15 @@ private:
 	bool         cfg_cylinder_fitting_;
 	bool         cfg_track_objects_;
 	bool         cfg_verbose_cylinder_fitting_;
+	bool         cfg_table_reuse_;
+	std::string  cfg_table_reuse_fixed_frame_;
+	float        cfg_table_reuse_max_translation_;
+	float        cfg_table_reuse_max_rotation_;
+	unsigned int cfg_table_reuse_max_age_;
 
 	fawkes::RefPtr<Cloud> ftable_model_;
 	CloudPtr              table_model_;
+	CloudPtr              table_model_template_;
 	fawkes::RefPtr<Cloud> fsimplified_polygon_;
 	CloudPtr              simplified_polygon_;
 
@@ -321,6 +374,44 @@ private:
 
 	std::map<uint, std::vector<double>> obj_likelihoods_;
 
+	// Buffers and filters kept across loops to avoid re-allocation
+	CloudPtr                                   cloud_voxelized_;
+	CloudPtr                                   cloud_plane_;
+	CloudPtr                                   cloud_scratch_;
+	CloudPtr                                   cloud_proj_;
+	CloudPtr                                   cloud_table_voxelized_;
+	CloudPtr                                   cloud_hull_;
+	CloudPtr                                   model_cloud_hull_;
+	CloudPtr                                   baserel_polygon_cloud_;
+	CloudPtr                                   cloud_filt_;
+	CloudPtr                                   cloud_above_;
+	CloudPtr                                   cloud_objs_;
+	ColorCloudPtr                              tmp_clusters_;
+	pcl::ModelCoefficients::Ptr                coeff_;
+	pcl::PointIndices::Ptr                     inliers_;
+	pcl::PointIndices::Ptr                     table_cluster_inliers_;
+	std::vector<pcl::PointIndices>             table_cluster_indices_;
+	std::vector<int>                           table_indices_;
+	pcl::ExtractIndices<PointType>             extract_;
+	pcl::ProjectInliers<PointType>             proj_;
+	pcl::VoxelGrid<PointType>                  table_grid_;
+	pcl::search::KdTree<PointType>::Ptr        kdtree_table_;
+	pcl::EuclideanClusterExtraction<PointType> table_ec_;
+	pcl::ConvexHull<PointType>                 hull_;
+	pcl::StatisticalOutlierRemoval<PointType>  sor_;
+	pcl::search::KdTree<PointType>::Ptr        kdtree_objs_;
+	pcl::EuclideanClusterExtraction<PointType> objs_ec_;
+	std::vector<ClusterWorkspace>              cluster_ws_;
+
+	// Table found in a previous loop and camera pose it was found at
+	bool                  table_cached_;
+	unsigned int          table_cache_age_;
+	fawkes::tf::Transform table_cache_camera_pose_;
+	Eigen::Vector4f       table_cache_centroid_;
+	Eigen::Vector4f       table_cache_baserel_centroid_;
+
+	StageTiming *stage_timing_;
+
 #ifdef USE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
 	unsigned int         tt_loopcount_;
@@ -158,6 +158,22 @@ ComputablesManager::check_and_compute(const document::view &query, std::string c
 	return added_computed_docs;
 }
 
+/**
+ * Check if any computable provides documents for a collection.
+ * @param collection The collection to check
+ * @return true if at least one computable is registered for @p collection
+ */
+bool
+ComputablesManager::has_computables(const std::string &collection) const
+{
+	for (Computable *comp : computables) {
+		if (comp->get_collection() == collection) {
+			return true;
+		}
+	}
+	return false;
+}
+
 /**
  * Clean up all collections containing documents computed on demand
  */
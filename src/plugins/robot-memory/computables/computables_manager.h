@@ -52,6 +52,7 @@ public:
 	virtual ~ComputablesManager();
 
 	bool check_and_compute(const bsoncxx::document::view &query, std::string collection);
+	bool has_computables(const std::string &collection) const;
 	void remove_computable(Computable *computable);
 	void cleanup_computed_docs();
 
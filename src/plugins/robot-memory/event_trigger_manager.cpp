@@ -55,7 +55,8 @@ EventTriggerManager::EventTriggerManager(Logger             *logger,
 	config_                   = config;
 	mongo_connection_manager_ = mongo_connection_manager;
 
-	con_local_ = mongo_connection_manager_->create_client("robot-memory-local");
+	con_local_   = mongo_connection_manager_->create_client("robot-memory-local");
+	con_replica_ = NULL;
 	if (config_->exists("/plugins/mongodb/clients/robot-memory-distributed/enabled")
 	    && config_->get_bool("/plugins/mongodb/clients/robot-memory-distributed/enabled")) {
 		con_replica_ = mongo_connection_manager_->create_client("robot-memory-distributed");
@@ -66,7 +67,8 @@ EventTriggerManager::EventTriggerManager(Logger             *logger,
 	dbnames_local_.push_back(local_db);
 	dbnames_distributed_ = config_->get_strings("/plugins/robot-memory/distributed-db-names");
 
-	mutex_ = new Mutex();
+	mutex_         = new Mutex();
+	removal_mutex_ = new Mutex();
 
 	try {
 		cfg_debug_ = config->get_bool("/plugins/robot-memory/more-debug-output");
@@ -89,6 +91,7 @@ EventTriggerManager::~EventTriggerManager()
 	mongo_connection_manager_->delete_client(con_local_);
 	mongo_connection_manager_->delete_client(con_replica_);
 	delete mutex_;
+	delete removal_mutex_;
 #ifdef USE_TIMETRACKER
 	delete tt_;
 #endif
@@ -100,6 +103,15 @@ EventTriggerManager::check_events()
 	//lock to be thread safe (e.g. registration during checking)
 	MutexLocker lock(mutex_);
 
+	std::list<EventTrigger *> removals;
+	removal_mutex_->lock();
+	removals.swap(removed_triggers_);
+	removal_mutex_->unlock();
+	for (EventTrigger *trigger : removals) {
+		triggers.remove(trigger);
+		delete trigger;
+	}
+
 	TIMETRACK_START(ttc_trigger_loop_);
 	for (EventTrigger *trigger : triggers) {
 		bool ok = true;
@@ -167,6 +179,20 @@ EventTriggerManager::remove_trigger(EventTrigger *trigger)
 	delete trigger;
 }
 
+/**
+ * Remove a trigger on the next check for events.
+ * Unlike remove_trigger() this neither modifies the trigger list nor waits
+ * for a running check for events, the trigger may still be called until
+ * then. Use it to remove triggers while other threads register triggers.
+ * @param trigger Pointer to the trigger to remove
+ */
+void
+EventTriggerManager::remove_trigger_deferred(EventTrigger *trigger)
+{
+	MutexLocker lock(removal_mutex_);
+	removed_triggers_.push_back(trigger);
+}
+
 change_stream
 EventTriggerManager::create_change_stream(mongocxx::collection &coll, bsoncxx::document::view query)
 {
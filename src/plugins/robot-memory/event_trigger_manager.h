@@ -48,6 +48,8 @@ class EventTriggerManager
 {
 	/// Access for robot memory to use the check_events function in the loop
 	friend class RobotMemory;
+	/// Access for the query cache QA to run the loop without a robot memory
+	friend class EventTriggerManagerQA;
 
 public:
 	EventTriggerManager(fawkes::Logger             *logger,
@@ -104,6 +106,7 @@ public:
 
 private:
 	void                    check_events();
+	void                    remove_trigger_deferred(EventTrigger *trigger);
 	mongocxx::change_stream create_change_stream(mongocxx::collection   &collection,
 	                                             bsoncxx::document::view query);
 
@@ -122,6 +125,8 @@ private:
 	bool                     cfg_debug_;
 
 	std::list<EventTrigger *> triggers;
+	fawkes::Mutex            *removal_mutex_;
+	std::list<EventTrigger *> removed_triggers_;
 
 #ifdef USE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
@@ -0,0 +1,371 @@
+/***************************************************************************
+ *  qa_robot_memory_query_cache.cpp - QA for robot memory query cache
+ *
+ *  Created: Sun Oct 18 18:02:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include "../event_trigger_manager.h"
+#include "../query_cache.h"
+
+#include <config/memory.h>
+#include <logging/console.h>
+#include <plugins/mongodb/aspect/mongodb_conncreator.h>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/uri.hpp>
+#include <thread>
+
+static const char *DATABASE   = "robmem_qa";
+static const char *COLLECTION = "query_cache";
+static const char *NS         = "robmem_qa.query_cache";
+
+static bool
+check(bool condition, const char *what)
+{
+	printf("%-60s %s\n", what, condition ? "OK" : "FAILED");
+	return condition;
+}
+
+static QueryCache::Result
+run_query(QueryCache                    &cache,
+          mongocxx::collection          &collection,
+          const std::string             &query,
+          const mongocxx::options::find &options = mongocxx::options::find())
+{
+	bsoncxx::document::value filter = bsoncxx::from_json(query);
+	std::string              key    = QueryCache::key(NS, filter.view(), options);
+	QueryCache::Result       result = cache.lookup(key);
+	if (result)
+		return result;
+
+	unsigned long int                     generation = cache.generation(NS);
+	std::vector<bsoncxx::document::value> docs;
+	for (auto doc : collection.find(filter.view(), options)) {
+		docs.emplace_back(doc);
+	}
+	result = std::make_shared<const std::vector<bsoncxx::document::value>>(std::move(docs));
+	cache.insert(NS, key, result, generation);
+	return result;
+}
+
+static bool
+test_keys()
+{
+	mongocxx::options::find none, projection, sort_asc, sort_desc;
+	projection.projection(bsoncxx::from_json(R"({"value": 1})"));
+	sort_asc.sort(bsoncxx::from_json(R"({"a": 1, "b": 1})"));
+	sort_desc.sort(bsoncxx::from_json(R"({"b": 1, "a": 1})"));
+
+	bsoncxx::document::value q1 = bsoncxx::from_json(R"({"a": 1, "b": {"$gt": 2, "$lt": 5}})");
+	bsoncxx::document::value q2 = bsoncxx::from_json(R"({"b": {"$lt": 5, "$gt": 2}, "a": 1})");
+	bsoncxx::document::value q3 = bsoncxx::from_json(R"({"c": {"x": 1, "y": 2}})");
+	bsoncxx::document::value q4 = bsoncxx::from_json(R"({"c": {"y": 2, "x": 1}})");
+
+	bool ok = true;
+	ok &= check(QueryCache::key(NS, q1.view(), none) == QueryCache::key(NS, q2.view(), none),
+	            "reordered fields and operators share a key");
+	ok &= check(QueryCache::key(NS, q3.view(), none) != QueryCache::key(NS, q4.view(), none),
+	            "embedded documents keep their field order");
+	ok &= check(QueryCache::key(NS, q1.view(), none) != QueryCache::key(NS, q1.view(), projection),
+	            "projection is part of the key");
+	ok &= check(QueryCache::key(NS, q1.view(), sort_asc) != QueryCache::key(NS, q1.view(), sort_desc),
+	            "sort order is part of the key");
+	ok &= check(QueryCache::key(NS, q1.view(), none) != QueryCache::key("qa.other", q1.view(), none),
+	            "collection is part of the key");
+	return ok;
+}
+
+static bool
+test_hits(mongocxx::collection &collection)
+{
+	QueryCache cache(16, 100);
+
+	QueryCache::Result r1 = run_query(cache, collection, R"({"type": "a", "value": {"$gte": 0}})");
+	QueryCache::Result r2 = run_query(cache, collection, R"({"value": {"$gte": 0}, "type": "a"})");
+
+	mongocxx::options::find projection;
+	projection.projection(bsoncxx::from_json(R"({"_id": 0, "value": 1})"));
+	QueryCache::Result r3 =
+	  run_query(cache, collection, R"({"type": "a", "value": {"$gte": 0}})", projection);
+
+	QueryCache::Statistics stats = cache.statistics();
+
+	bool ok = true;
+	ok &= check(r1 == r2 && r1->size() == 10, "reordered query served from cache");
+	ok &= check(r3 != r1 && r3->size() == 10 && !(*r3)[0].view()["type"],
+	            "projected query cached separately");
+	ok &= check(stats.hits == 1 && stats.misses == 2 && stats.entries == 2, "hit/miss statistics");
+	return ok;
+}
+
+static bool
+test_change_stream(mongocxx::client &client, mongocxx::client &writer)
+{
+	QueryCache           cache(16, 100);
+	mongocxx::collection collection = client[DATABASE][COLLECTION];
+
+	mongocxx::options::change_stream opts;
+	opts.max_await_time(std::chrono::milliseconds(1));
+	mongocxx::change_stream stream = collection.watch(opts);
+	for (auto it = stream.begin(); it != stream.end(); ++it) {
+	}
+
+	QueryCache::Result r1 = run_query(cache, collection, R"({"type": "a"})");
+
+	// modify through another connection, like a different process would
+	using namespace bsoncxx::builder::basic;
+	writer[DATABASE][COLLECTION].insert_one(make_document(kvp("type", "a"), kvp("value", 42)));
+
+	unsigned int events = 0;
+	for (int i = 0; i < 100 && events == 0; ++i) {
+		for (const bsoncxx::document::view &change : stream) {
+			cache.invalidate(change["ns"]["db"].get_utf8().value.to_string() + "."
+			                 + change["ns"]["coll"].get_utf8().value.to_string());
+			events += 1;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	QueryCache::Result r2 = run_query(cache, collection, R"({"type": "a"})");
+
+	bool ok = true;
+	ok &= check(events > 0, "change event received");
+	ok &= check(r1 != r2 && r2->size() == r1->size() + 1, "external write invalidates result");
+	ok &= check(cache.statistics().invalidations == 1, "invalidation counted");
+	return ok;
+}
+
+class QAConnCreator : public fawkes::MongoDBConnCreator
+{
+public:
+	QAConnCreator(const std::string &uri) : uri_(uri)
+	{
+	}
+
+	virtual mongocxx::client *
+	create_client(const std::string &config_name = "")
+	{
+		return new mongocxx::client(mongocxx::uri{uri_});
+	}
+
+	virtual void
+	delete_client(mongocxx::client *client)
+	{
+		delete client;
+	}
+
+private:
+	std::string uri_;
+};
+
+/** Watches a collection like the robot memory does for its query cache. */
+class EventTriggerManagerQA
+{
+public:
+	EventTriggerManagerQA(EventTriggerManager *manager, QueryCache *cache)
+	: manager_(manager), cache_(cache), trigger_(NULL), stale_(false), events_(0)
+	{
+	}
+
+	void
+	watch()
+	{
+		trigger_ = manager_->register_trigger(bsoncxx::document::view{},
+		                                      NS,
+		                                      &EventTriggerManagerQA::changed,
+		                                      this);
+	}
+
+	void
+	rewatch()
+	{
+		// replace the trigger like RobotMemory::query_cache_rewatch() does
+		manager_->remove_trigger_deferred(trigger_);
+		cache_->invalidate(NS);
+		stale_ = false;
+		watch();
+	}
+
+	unsigned int
+	check_events(bool until_stale)
+	{
+		events_ = 0;
+		for (int i = 0; i < 100 && (until_stale ? !stale_ : events_ == 0); ++i) {
+			manager_->check_events();
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return events_;
+	}
+
+	size_t
+	num_triggers() const
+	{
+		return manager_->triggers.size();
+	}
+
+	bool
+	stale() const
+	{
+		return stale_;
+	}
+
+private:
+	void
+	changed(const bsoncxx::document::view &change)
+	{
+		events_ += 1;
+		cache_->invalidate(NS);
+		std::string op = change["operationType"].get_utf8().value.to_string();
+		if (op == "drop" || op == "rename" || op == "dropDatabase") {
+			stale_ = true;
+		}
+	}
+
+private:
+	EventTriggerManager *manager_;
+	QueryCache          *cache_;
+	EventTrigger        *trigger_;
+	bool                 stale_;
+	unsigned int         events_;
+};
+
+static bool
+test_rewatch(const std::string &uri, mongocxx::client &writer, bool rename)
+{
+	fawkes::MemoryConfiguration config;
+	fawkes::ConsoleLogger       logger(fawkes::Logger::LL_WARN);
+	QAConnCreator               conncreator(uri);
+	std::vector<std::string>    distributed;
+	config.set_string("/plugins/robot-memory/database", DATABASE);
+	config.set_strings("/plugins/robot-memory/distributed-db-names", distributed);
+
+	QueryCache            cache(16, 100);
+	EventTriggerManager   manager(&logger, &config, &conncreator);
+	EventTriggerManagerQA watcher(&manager, &cache);
+	mongocxx::collection  collection = writer[DATABASE][COLLECTION];
+
+	using namespace bsoncxx::builder::basic;
+	collection.insert_one(make_document(kvp("type", "c"), kvp("value", 0)));
+	watcher.watch();
+	watcher.check_events(false);
+
+	QueryCache::Result r1 = run_query(cache, collection, R"({"type": "c"})");
+	if (rename) {
+		collection.rename(std::string(COLLECTION) + "_renamed", true);
+	} else {
+		collection.drop();
+	}
+	watcher.check_events(true);
+
+	bool ok = true;
+	ok &= check(watcher.stale(), rename ? "rename event received" : "drop event received");
+
+	watcher.rewatch();
+	watcher.check_events(false);
+	ok &= check(watcher.num_triggers() == 1, "trigger replaced on next event check");
+
+	collection = writer[DATABASE][COLLECTION];
+	collection.insert_one(make_document(kvp("type", "c"), kvp("value", 1)));
+	QueryCache::Result r2 = run_query(cache, collection, R"({"type": "c"})");
+	unsigned int       events = watcher.check_events(false);
+	QueryCache::Result r3     = run_query(cache, collection, R"({"type": "c"})");
+
+	ok &= check(r1 != r2 && r2->size() == 1 && (*r2)[0].view()["value"].get_int32() == 1,
+	            "stale result invalidated on re-watch");
+	ok &= check(events > 0 && r3 != r2, "re-watched trigger invalidates on write");
+	return ok;
+}
+
+static bool
+test_generation(mongocxx::collection &collection)
+{
+	QueryCache cache(2, 5);
+
+	// a result retrieved while the collection changed must not be cached
+	QueryCache::Result empty = std::make_shared<const std::vector<bsoncxx::document::value>>();
+	bsoncxx::document::value filter     = bsoncxx::from_json(R"({"type": "b"})");
+	std::string              key        = QueryCache::key(NS, filter.view(), {});
+	unsigned long int        generation = cache.generation(NS);
+	cache.invalidate(NS);
+	cache.insert(NS, key, empty, generation);
+	bool ok = check(!cache.lookup(key), "result of concurrently modified collection dropped");
+
+	generation = cache.generation(NS);
+	cache.clear();
+	cache.insert(NS, key, empty, generation);
+	ok &= check(!cache.lookup(key), "result retrieved during clear dropped");
+
+	run_query(cache, collection, R"({"type": "a"})");
+	ok &= check(cache.statistics().entries == 0, "result exceeding maximum size not cached");
+
+	run_query(cache, collection, R"({"type": "b", "value": 0})");
+	run_query(cache, collection, R"({"type": "b", "value": 1})");
+	run_query(cache, collection, R"({"type": "b", "value": 0})");
+	run_query(cache, collection, R"({"type": "b", "value": 2})");
+	QueryCache::Statistics stats = cache.statistics();
+	ok &= check(stats.entries == 2 && stats.evictions == 1, "least recently used result evicted");
+	run_query(cache, collection, R"({"type": "b", "value": 0})");
+	ok &= check(cache.statistics().hits == stats.hits + 1, "recently used result kept");
+	return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+	mongocxx::instance instance{};
+	std::string        uri = argc > 1 ? argv[1] : "mongodb://localhost:27017/?replicaSet=rs0";
+	mongocxx::client   client(mongocxx::uri{uri});
+	mongocxx::client   writer(mongocxx::uri{uri});
+
+	mongocxx::collection collection = client[DATABASE][COLLECTION];
+	collection.drop();
+	std::vector<bsoncxx::document::value> docs;
+	for (int i = 0; i < 10; ++i) {
+		using namespace bsoncxx::builder::basic;
+		docs.push_back(make_document(kvp("type", "a"), kvp("value", i)));
+		docs.push_back(make_document(kvp("type", "b"), kvp("value", i)));
+	}
+	collection.insert_many(docs);
+
+	bool ok = true;
+	ok &= test_keys();
+	ok &= test_hits(collection);
+	ok &= test_generation(collection);
+	try {
+		ok &= test_change_stream(client, writer);
+		ok &= test_rewatch(uri, writer, false);
+		ok &= test_rewatch(uri, writer, true);
+	} catch (mongocxx::exception &e) {
+		printf("Change streams unavailable, is mongod running as replica set? %s\n", e.what());
+		ok = false;
+	}
+
+	client[DATABASE].drop();
+	printf("%s\n", ok ? "PASSED" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+/// @endcond
@@ -0,0 +1,394 @@
+/***************************************************************************
+ *  query_cache.cpp - In-process cache of query results
+ *
+ *  Created: Sun Oct 18 16:21:08 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "query_cache.h"
+
+#include <blackboard/blackboard.h>
+#include <core/exception.h>
+#include <core/threading/mutex_locker.h>
+#include <interfaces/MetricCounterInterface.h>
+#include <interfaces/MetricFamilyInterface.h>
+
+#include <algorithm>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/json.hpp>
+#include <mongocxx/options/find.hpp>
+
+using namespace fawkes;
+using namespace bsoncxx;
+
+/** @class QueryCache "query_cache.h"
+ * In-process cache of query results.
+ * Results are keyed by collection, normalized query, and the find
+ * options which influence the result (projection, sort, limit, and
+ * skip). Results are immutable and shared, such that a result remains
+ * valid for its user after the entry has been invalidated or evicted.
+ *
+ * The cache itself does not observe the database. Its user must call
+ * invalidate() for every change of a collection. A query result may
+ * only be inserted with the generation of the collection that was
+ * current before the query was issued, which prevents storing results
+ * that were outdated by a concurrent invalidation.
+ * @author Tim Niemueller
+ */
+
+/// @cond INTERNALS
+/** Labels of the exported counters, in the order of the metric interfaces. */
+static const char *METRIC_EVENTS[] = {"hit", "miss", "bypass", "invalidation", "eviction"};
+
+static bool
+is_operator_document(const document::view &doc)
+{
+	if (doc.empty())
+		return false;
+	return std::all_of(doc.begin(), doc.end(), [](const document::element &e) {
+		return !e.key().empty() && e.key()[0] == '$';
+	});
+}
+
+template <typename Builder>
+static void
+append_normalized(Builder &builder, const document::view &doc)
+{
+	using namespace bsoncxx::builder;
+
+	std::vector<document::element> elements(doc.begin(), doc.end());
+	std::stable_sort(elements.begin(),
+	                 elements.end(),
+	                 [](const document::element &a, const document::element &b) {
+		                 return a.key() < b.key();
+	                 });
+
+	for (const document::element &e : elements) {
+		std::string key{e.key()};
+		if (e.type() == type::k_document && is_operator_document(e.get_document().value)) {
+			// operator expressions such as {$gt: 1, $lt: 5} are order-insensitive
+			builder.append(basic::kvp(key, [&e](basic::sub_document subdoc) {
+				append_normalized(subdoc, e.get_document().value);
+			}));
+		} else if (e.type() == type::k_array && (key == "$and" || key == "$or" || key == "$nor")) {
+			// every clause of a logical operator is a query of its own
+			builder.append(basic::kvp(key, [&e](basic::sub_array subarray) {
+				for (const auto &c : e.get_array().value) {
+					if (c.type() == type::k_document) {
+						subarray.append([&c](basic::sub_document subdoc) {
+							append_normalized(subdoc, c.get_document().value);
+						});
+					} else {
+						subarray.append(c.get_value());
+					}
+				}
+			}));
+		} else {
+			// embedded documents are matched exactly, order matters
+			builder.append(basic::kvp(key, e.get_value()));
+		}
+	}
+}
+/// @endcond
+
+/** Constructor.
+ * @param max_entries maximum number of cached results, the least
+ * recently used result is evicted if exceeded
+ * @param max_result_size maximum number of documents of a cached result,
+ * larger results are not cached
+ */
+QueryCache::QueryCache(unsigned int max_entries, unsigned int max_result_size)
+: max_entries_(max_entries), max_result_size_(max_result_size), global_generation_(0)
+{
+	stats_      = Statistics{0, 0, 0, 0, 0, 0};
+	blackboard_ = NULL;
+	family_if_  = NULL;
+}
+
+/** Destructor. */
+QueryCache::~QueryCache()
+{
+	close_metrics();
+}
+
+/** Normalize a query.
+ * The fields of a query are combined by conjunction, hence their order
+ * is irrelevant. The normalized query has the fields of the query, of
+ * operator expressions, and of the clauses of logical operators sorted
+ * by name. Embedded documents are kept as they are, because MongoDB
+ * matches them including the field order.
+ * @param query query to normalize
+ * @return normalized query
+ */
+document::value
+QueryCache::normalize(const document::view &query)
+{
+	bsoncxx::builder::basic::document doc;
+	append_normalized(doc, query);
+	return doc.extract();
+}
+
+/** Get cache key for a query.
+ * @param collection database and collection name
+ * @param query query
+ * @param options find options of the query
+ * @return key for the query, the empty string if the find options
+ * influence the result in a way that is not covered by the key
+ */
+std::string
+QueryCache::key(const std::string             &collection,
+                const document::view          &query,
+                const mongocxx::options::find &options)
+{
+	if (options.collation() || options.max() || options.min() || options.return_key()
+	    || options.show_record_id()) {
+		return "";
+	}
+
+	std::string key = collection;
+	key += '\0';
+	key += to_json(normalize(query).view(), ExtendedJsonMode::k_canonical);
+	key += '\0';
+	if (options.projection()) {
+		key += to_json(normalize(options.projection()->view()).view(), ExtendedJsonMode::k_canonical);
+	}
+	key += '\0';
+	if (options.sort()) {
+		// the order of sort keys defines precedence, keep it
+		key += to_json(options.sort()->view(), ExtendedJsonMode::k_canonical);
+	}
+	key += '\0';
+	if (options.limit()) {
+		key += std::to_string(*options.limit());
+	}
+	key += '\0';
+	if (options.skip()) {
+		key += std::to_string(*options.skip());
+	}
+	return key;
+}
+
+/** Lookup a query result.
+ * @param key key of the query as returned by key()
+ * @return cached result, or an empty pointer if the result is not cached
+ */
+QueryCache::Result
+QueryCache::lookup(const std::string &key)
+{
+	MutexLocker lock(mutex_);
+	auto        e = entries_.find(key);
+	if (e == entries_.end()) {
+		stats_.misses += 1;
+		return Result();
+	}
+	stats_.hits += 1;
+	lru_.splice(lru_.begin(), lru_, e->second.lru_pos);
+	return e->second.result;
+}
+
+/** Get current generation of a collection.
+ * The generation changes with every invalidation of the collection.
+ * @param collection database and collection name
+ * @return generation to pass to insert()
+ */
+unsigned long int
+QueryCache::generation(const std::string &collection)
+{
+	MutexLocker lock(mutex_);
+	// both counters only increase, their sum changes if either changes
+	return generations_[collection] + global_generation_;
+}
+
+/** Insert a query result.
+ * The result is not stored if the collection has been invalidated
+ * since @p generation was retrieved, or if it is too large.
+ * @param collection database and collection name
+ * @param key key of the query as returned by key()
+ * @param result query result
+ * @param generation generation of the collection retrieved before the
+ * query was issued
+ */
+void
+QueryCache::insert(const std::string &collection,
+                   const std::string &key,
+                   Result             result,
+                   unsigned long int  generation)
+{
+	MutexLocker lock(mutex_);
+	if (generations_[collection] + global_generation_ != generation
+	    || result->size() > max_result_size_ || max_entries_ == 0) {
+		return;
+	}
+
+	if (entries_.find(key) != entries_.end()) {
+		erase(key);
+	}
+	while (entries_.size() >= max_entries_) {
+		std::string victim = lru_.back();
+		erase(victim);
+		stats_.evictions += 1;
+	}
+
+	lru_.push_front(key);
+	entries_[key] = Entry{collection, result, lru_.begin()};
+	collection_keys_[collection].insert(key);
+	stats_.entries = entries_.size();
+}
+
+/** Count a query that could not be cached. */
+void
+QueryCache::count_bypass()
+{
+	MutexLocker lock(mutex_);
+	stats_.bypasses += 1;
+}
+
+/** Invalidate all results of a collection.
+ * @param collection database and collection name
+ */
+void
+QueryCache::invalidate(const std::string &collection)
+{
+	MutexLocker lock(mutex_);
+	// collections never queried have no generation and need none, e.g.,
+	// the temporary collections of the computables matching test
+	auto g = generations_.find(collection);
+	if (g == generations_.end())
+		return;
+	g->second += 1;
+
+	auto c = collection_keys_.find(collection);
+	if (c == collection_keys_.end())
+		return;
+
+	std::set<std::string> keys;
+	keys.swap(c->second);
+	for (const std::string &key : keys) {
+		erase(key);
+		stats_.invalidations += 1;
+	}
+	stats_.entries = entries_.size();
+}
+
+/** Invalidate all results. */
+void
+QueryCache::clear()
+{
+	MutexLocker lock(mutex_);
+	global_generation_ += 1;
+	stats_.invalidations += entries_.size();
+	entries_.clear();
+	lru_.clear();
+	collection_keys_.clear();
+	stats_.entries = 0;
+}
+
+/** Get statistics.
+ * @return statistics accumulated since construction
+ */
+QueryCache::Statistics
+QueryCache::statistics() const
+{
+	MutexLocker lock(mutex_);
+	return stats_;
+}
+
+void
+QueryCache::erase(const std::string &key)
+{
+	auto e = entries_.find(key);
+	if (e == entries_.end())
+		return;
+
+	lru_.erase(e->second.lru_pos);
+	auto c = collection_keys_.find(e->second.collection);
+	if (c != collection_keys_.end()) {
+		c->second.erase(key);
+	}
+	entries_.erase(e);
+	stats_.entries = entries_.size();
+}
+
+/** Open metric interfaces.
+ * The statistics are exported as a counter with one value per event,
+ * i.e., hit, miss, bypass, invalidation, and eviction.
+ * @param blackboard blackboard to open interfaces on
+ * @param family_id ID of the metric family interface, the counter
+ * interfaces have the ID family_id/event
+ */
+void
+QueryCache::open_metrics(BlackBoard *blackboard, const std::string &family_id)
+{
+	close_metrics();
+
+	blackboard_ = blackboard;
+	try {
+		// the data interfaces must exist before the family is announced
+		for (const char *event : METRIC_EVENTS) {
+			MetricCounterInterface *iface =
+			  blackboard_->open_for_writing<MetricCounterInterface>((family_id + "/" + event).c_str());
+			counter_ifs_.push_back(iface);
+			iface->set_labels((std::string("event=") + event).c_str());
+			iface->write();
+		}
+
+		family_if_ = blackboard_->open_for_writing<MetricFamilyInterface>(family_id.c_str());
+		family_if_->set_name("fawkes_robot_memory_query_cache");
+		family_if_->set_help("Robot memory query cache lookups and removed entries by event");
+		family_if_->set_metric_type(MetricFamilyInterface::COUNTER);
+		family_if_->write();
+	} catch (Exception &e) {
+		close_metrics();
+		throw;
+	}
+}
+
+/** Close metric interfaces. */
+void
+QueryCache::close_metrics()
+{
+	if (!blackboard_)
+		return;
+
+	blackboard_->close(family_if_);
+	for (MetricCounterInterface *iface : counter_ifs_) {
+		blackboard_->close(iface);
+	}
+	family_if_ = NULL;
+	counter_ifs_.clear();
+	blackboard_ = NULL;
+}
+
+/** Write the current statistics to the metric interfaces.
+ * Does nothing if open_metrics() has not been called.
+ */
+void
+QueryCache::publish_metrics()
+{
+	if (counter_ifs_.empty())
+		return;
+
+	Statistics              stats = statistics();
+	const unsigned long int values[] =
+	  {stats.hits, stats.misses, stats.bypasses, stats.invalidations, stats.evictions};
+	for (size_t i = 0; i < counter_ifs_.size(); ++i) {
+		if (counter_ifs_[i]->value() != values[i]) {
+			counter_ifs_[i]->set_value(values[i]);
+			counter_ifs_[i]->write();
+		}
+	}
+}
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *  query_cache.h - In-process cache of query results
+ *
+ *  Created: Sun Oct 18 16:21:08 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_ROBOT_MEMORY_QUERY_CACHE_H_
+#define _PLUGINS_ROBOT_MEMORY_QUERY_CACHE_H_
+
+#include <core/threading/mutex.h>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mongocxx {
+namespace options {
+class find;
+}
+} // namespace mongocxx
+
+namespace fawkes {
+class BlackBoard;
+class MetricFamilyInterface;
+class MetricCounterInterface;
+} // namespace fawkes
+
+class QueryCache
+{
+public:
+	/** Immutable query result, shared between the cache and its users. */
+	typedef std::shared_ptr<const std::vector<bsoncxx::document::value>> Result;
+
+	/** Cache statistics. */
+	typedef struct
+	{
+		unsigned long int hits;          ///< number of lookups served from the cache
+		unsigned long int misses;        ///< number of lookups not in the cache
+		unsigned long int bypasses;      ///< number of queries that cannot be cached
+		unsigned long int invalidations; ///< number of entries removed due to changes
+		unsigned long int evictions;     ///< number of entries removed due to size limit
+		unsigned int      entries;       ///< number of cached results
+	} Statistics;
+
+	QueryCache(unsigned int max_entries, unsigned int max_result_size);
+	~QueryCache();
+
+	static std::string              key(const std::string             &collection,
+	                                    const bsoncxx::document::view &query,
+	                                    const mongocxx::options::find &options);
+	static bsoncxx::document::value normalize(const bsoncxx::document::view &query);
+
+	Result            lookup(const std::string &key);
+	unsigned long int generation(const std::string &collection);
+	void              insert(const std::string &collection,
+	                         const std::string &key,
+	                         Result             result,
+	                         unsigned long int  generation);
+	void              count_bypass();
+
+	void invalidate(const std::string &collection);
+	void clear();
+
+	Statistics statistics() const;
+
+	void open_metrics(fawkes::BlackBoard *blackboard, const std::string &family_id);
+	void close_metrics();
+	void publish_metrics();
+
+private:
+	/// @cond INTERNALS
+	struct Entry
+	{
+		std::string                      collection;
+		Result                           result;
+		std::list<std::string>::iterator lru_pos;
+	};
+	/// @endcond
+
+	void erase(const std::string &key);
+
+private:
+	unsigned int max_entries_;
+	unsigned int max_result_size_;
+
+	mutable fawkes::Mutex                        mutex_;
+	std::unordered_map<std::string, Entry>       entries_;
+	std::list<std::string>                       lru_;
+	std::map<std::string, std::set<std::string>> collection_keys_;
+	std::map<std::string, unsigned long int>     generations_;
+	unsigned long int                            global_generation_;
+	Statistics                                   stats_;
+
+	fawkes::BlackBoard                           *blackboard_;
+	fawkes::MetricFamilyInterface                *family_if_;
+	std::vector<fawkes::MetricCounterInterface *> counter_ifs_;
+};
+
+#endif
@@ -78,6 +78,7 @@ RobotMemory::RobotMemory(fawkes::Configuration      *config,
 	mongodb_client_local_       = nullptr;
 	mongodb_client_distributed_ = nullptr;
 	debug_                      = false;
+	query_cache_                = NULL;
 }
 
 RobotMemory::~RobotMemory()
@@ -85,6 +86,17 @@ RobotMemory::~RobotMemory()
 	mongo_connection_manager_->delete_client(mongodb_client_local_);
 	mongo_connection_manager_->delete_client(mongodb_client_distributed_);
 	delete trigger_manager_;
+	if (query_cache_) {
+		QueryCache::Statistics stats   = query_cache_->statistics();
+		unsigned long int      lookups = stats.hits + stats.misses;
+		logger_->log_info(name_,
+		                  "Query cache: %lu hits, %lu misses (%.1f%% hit rate), %lu bypassed",
+		                  stats.hits,
+		                  stats.misses,
+		                  lookups > 0 ? 100. * stats.hits / lookups : 0.,
+		                  stats.bypasses);
+		delete query_cache_;
+	}
 	blackboard_->close(rm_if_);
 #ifdef USE_TIMETRACKER
 	delete tt_;
@@ -141,6 +153,22 @@ RobotMemory::init()
 	trigger_manager_     = new EventTriggerManager(logger_, config_, mongo_connection_manager_);
 	computables_manager_ = new ComputablesManager(config_, this);
 
+	//Setup query result cache, invalidated by change streams
+	if (config_->get_bool_or_default("/plugins/robot-memory/query-cache/enable", true)) {
+		unsigned int max_entries =
+		  config_->get_uint_or_default("/plugins/robot-memory/query-cache/max-entries", 512);
+		unsigned int max_result_size =
+		  config_->get_uint_or_default("/plugins/robot-memory/query-cache/max-result-size", 1000);
+		query_cache_ = new QueryCache(max_entries, max_result_size);
+		if (config_->get_bool_or_default("/plugins/robot-memory/query-cache/metrics", true)) {
+			try {
+				query_cache_->open_metrics(blackboard_, "robot-memory/query-cache");
+			} catch (Exception &e) {
+				log(std::string("Failed to open query cache metrics: ") + e.what_no_backtrace(), "warn");
+			}
+		}
+	}
+
 	log_deb("Initialized RobotMemory");
 
 #ifdef USE_TIMETRACKER
@@ -157,6 +185,10 @@ RobotMemory::loop()
 	TIMETRACK_START(ttc_events_);
 	trigger_manager_->check_events();
 	TIMETRACK_END(ttc_events_);
+	if (query_cache_) {
+		query_cache_rewatch();
+		query_cache_->publish_metrics();
+	}
 	TIMETRACK_START(ttc_cleanup_);
 	computables_manager_->cleanup_computed_docs();
 	TIMETRACK_END(ttc_cleanup_);
@@ -199,6 +231,80 @@ RobotMemory::query(document::view          query,
 	}
 }
 
+/**
+ * Query information from the robot memory through the query cache.
+ * Unlike query(), the result is fully retrieved and may be served from
+ * memory if the same query has been issued before. Queries are
+ * considered the same after normalizing the order of keys in the filter,
+ * projection, and operators, the sort order is kept. Cached results
+ * are invalidated by writes through the robot memory and by change
+ * stream events for the queried collection, i.e., changes made by other
+ * processes are seen after the next loop of the robot memory.
+ *
+ * Queries on collections with computables, or for which no change stream
+ * can be opened, and queries using options that cannot be cached (e.g.,
+ * collation) are passed through to the database.
+ * @param query The query returned documents have to match
+ * @param collection_name The database and collection to query as string (e.g. robmem.worldmodel)
+ * @param query_options Optional options to use to query the database
+ * @return shared immutable vector of result documents
+ */
+QueryCache::Result
+RobotMemory::query_cached(document::view                 query,
+                          const std::string             &collection_name,
+                          const mongocxx::options::find &query_options)
+{
+	bool cacheable = query_cache_ != NULL
+	                 && collection_name != cfg_coord_database_ + "." + cfg_coord_mutex_collection_
+	                 && !computables_manager_->has_computables(collection_name);
+	std::string key;
+	if (cacheable && query_cache_watch(collection_name)) {
+		key = QueryCache::key(collection_name, query, query_options);
+	}
+
+	unsigned long int generation = 0;
+	if (!key.empty()) {
+		QueryCache::Result result = query_cache_->lookup(key);
+		if (result) {
+			log_deb(query, "Query cache hit on " + collection_name + " for");
+			return result;
+		}
+		// retrieve the generation before querying, the result is dropped if
+		// the collection changes until it has been fully retrieved
+		generation = query_cache_->generation(collection_name);
+	} else if (query_cache_) {
+		query_cache_->count_bypass();
+	}
+
+	cursor                       cursor = this->query(query, collection_name, query_options);
+	std::vector<document::value> docs;
+	{
+		//lock (mongo_client not thread safe)
+		MutexLocker lock(mutex_);
+		for (auto doc : cursor) {
+			docs.emplace_back(doc);
+		}
+	}
+	QueryCache::Result result = std::make_shared<const std::vector<document::value>>(std::move(docs));
+	if (!key.empty()) {
+		query_cache_->insert(collection_name, key, result, generation);
+	}
+	return result;
+}
+
+/** Get query cache statistics.
+ * @return statistics of the query cache, all zero if it is disabled
+ */
+QueryCache::Statistics
+RobotMemory::query_cache_statistics() const
+{
+	if (query_cache_) {
+		return query_cache_->statistics();
+	} else {
+		return QueryCache::Statistics{0, 0, 0, 0, 0, 0};
+	}
+}
+
 /**
  * Inserts a document into the robot memory
  * @param doc A view of the document to insert
@@ -220,6 +326,7 @@ RobotMemory::insert(bsoncxx::document::view doc, const std::string &collection_n
 		log_deb(error, "error");
 		return 0;
 	}
+	query_cache_invalidate(collection_name);
 	//return success
 	return 1;
 }
@@ -283,8 +390,11 @@ RobotMemory::insert(std::vector<bsoncxx::document::view> docs, const std::string
 	} catch (operation_exception &e) {
 		std::string error = "Error for insert " + insert_string + "\n Exception: " + e.what();
 		log_deb(error, "error");
+		// some documents may have been inserted before the failure
+		query_cache_invalidate(collection_name);
 		return 0;
 	}
+	query_cache_invalidate(collection_name);
 	//return success
 	return 1;
 }
@@ -332,8 +442,10 @@ RobotMemory::update(const bsoncxx::document::view &query,
 		log_deb(std::string("Error for update " + to_json(update) + " for query " + to_json(query)
 		                    + "\n Exception: " + e.what()),
 		        "error");
+		query_cache_invalidate(collection_name);
 		return 0;
 	}
+	query_cache_invalidate(collection_name);
 	//return success
 	return 1;
 }
@@ -386,6 +498,7 @@ RobotMemory::find_one_and_update(const document::view &filter,
 		                                   return_new ? options::return_document::k_after
 		                                              : options::return_document::k_before));
 		if (res) {
+			query_cache_invalidate(collection_name);
 			return *res;
 		} else {
 			std::string error = "Error for update " + to_json(update) + " for query " + to_json(filter)
@@ -420,8 +533,10 @@ RobotMemory::remove(const bsoncxx::document::view &query, const std::string &col
 	} catch (operation_exception &e) {
 		log_deb(std::string("Error for query " + to_json(query) + "\n Exception: " + e.what()),
 		        "error");
+		query_cache_invalidate(collection_name);
 		return 0;
 	}
+	query_cache_invalidate(collection_name);
 	//return success
 	return 1;
 }
@@ -487,6 +602,7 @@ RobotMemory::drop_collection(const std::string &collection_name)
 	collection  collection = get_collection(collection_name);
 	log_deb("Dropping collection " + collection_name);
 	collection.drop();
+	query_cache_invalidate(collection_name);
 	return 1;
 }
 
@@ -502,6 +618,8 @@ RobotMemory::clear_memory()
 
 	log_deb("Clearing whole robot memory");
 	mongodb_client_local_->database(database_name_).drop();
+	if (query_cache_)
+		query_cache_->clear();
 	return 1;
 }
 
@@ -556,6 +674,7 @@ RobotMemory::restore_collection(const std::string &dbcollection,
 		output_string += buffer;
 	}
 	pclose(bash_output);
+	query_cache_invalidate(target_dbcollection);
 	if (output_string.find("Failed") != std::string::npos) {
 		log(std::string("Unable to restore collection" + collection), "error");
 		log_deb(output_string, "error");
@@ -724,7 +843,132 @@ RobotMemory::remove_trigger(EventTrigger *trigger)
 void
 RobotMemory::remove_computable(Computable *computable)
 {
+	std::string collection = computable->get_collection();
 	computables_manager_->remove_computable(computable);
+	// results may have been computed while the computable was registered
+	query_cache_invalidate(collection);
+}
+
+/** Invalidate cached query results after a write.
+ * @param collection The database and collection that has been modified
+ */
+void
+RobotMemory::query_cache_invalidate(const std::string &collection)
+{
+	if (query_cache_) {
+		query_cache_->invalidate(collection);
+	}
+}
+
+/** Ensure that a change stream invalidates cached results of a collection.
+ * The trigger is registered on the first query of a collection. If this
+ * fails, e.g., because the database is not a replica set, queries on
+ * the collection are not cached.
+ * @param collection The database and collection to watch
+ * @return true if cached results of @p collection are invalidated on change
+ */
+bool
+RobotMemory::query_cache_watch(const std::string &collection)
+{
+	// must not be held while registering a trigger, it is locked by
+	// query_cache_changed() while the trigger manager mutex is held
+	{
+		MutexLocker lock(query_cache_mutex_);
+		if (query_cache_stale_.find(collection) != query_cache_stale_.end()
+		    || query_cache_unwatched_.find(collection) != query_cache_unwatched_.end()) {
+			return false;
+		}
+		if (query_cache_triggers_.find(collection) != query_cache_triggers_.end()) {
+			return true;
+		}
+	}
+
+	MutexLocker watch_lock(query_cache_watch_mutex_);
+	if (query_cache_triggers_.find(collection) != query_cache_triggers_.end()) {
+		// registered concurrently
+		return true;
+	}
+	EventTrigger *trigger = NULL;
+	try {
+		trigger = trigger_manager_->register_trigger(bsoncxx::builder::basic::make_document(),
+		                                             collection,
+		                                             &RobotMemory::query_cache_changed,
+		                                             this);
+	} catch (std::exception &e) {
+		logger_->log_warn(name_,
+		                  "Cannot watch %s, not caching its queries: %s",
+		                  collection.c_str(),
+		                  e.what());
+	}
+
+	MutexLocker lock(query_cache_mutex_);
+	if (trigger) {
+		query_cache_triggers_[collection] = trigger;
+	} else {
+		query_cache_unwatched_.insert(collection);
+	}
+	return trigger != NULL;
+}
+
+/** Change stream callback of the query cache.
+ * @param change change event
+ */
+void
+RobotMemory::query_cache_changed(const bsoncxx::document::view &change)
+{
+	auto        ns = change["ns"];
+	std::string db, dbcollection;
+	if (ns && ns.type() == bsoncxx::type::k_document && ns["db"]) {
+		db = ns["db"].get_utf8().value.to_string();
+		if (ns["coll"]) {
+			dbcollection = db + "." + ns["coll"].get_utf8().value.to_string();
+		}
+	}
+	if (dbcollection.empty()) {
+		// e.g., the stream has been invalidated or the database was dropped
+		query_cache_->clear();
+	} else {
+		query_cache_->invalidate(dbcollection);
+	}
+
+	std::string op = change["operationType"].get_utf8().value.to_string();
+	if (op == "drop" || op == "rename" || op == "dropDatabase") {
+		// the change stream is invalidated after these, replace it in the loop
+		MutexLocker lock(query_cache_mutex_);
+		for (const auto &t : query_cache_triggers_) {
+			if (t.first == dbcollection
+			    || (op == "dropDatabase" && EventTriggerManager::get_db_name(t.first) == db)) {
+				query_cache_stale_.insert(t.first);
+			}
+		}
+	}
+}
+
+/** Replace triggers whose change stream has ended.
+ * Called from the loop, i.e., not while the trigger manager checks events.
+ */
+void
+RobotMemory::query_cache_rewatch()
+{
+	MutexLocker               watch_lock(query_cache_watch_mutex_);
+	std::set<std::string>     stale;
+	std::list<EventTrigger *> triggers;
+	{
+		MutexLocker lock(query_cache_mutex_);
+		for (const std::string &collection : query_cache_stale_) {
+			triggers.push_back(query_cache_triggers_[collection]);
+			query_cache_triggers_.erase(collection);
+		}
+		stale.swap(query_cache_stale_);
+	}
+	// the trigger manager is concurrently used to register triggers
+	for (EventTrigger *trigger : triggers) {
+		trigger_manager_->remove_trigger_deferred(trigger);
+	}
+	// results may have been cached after the last event of the old stream
+	for (const std::string &collection : stale) {
+		query_cache_->invalidate(collection);
+	}
 }
 
 /** Explicitly create a mutex.
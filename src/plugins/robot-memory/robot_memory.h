@@ -23,6 +23,7 @@
 
 #include "computables/computables_manager.h"
 #include "event_trigger_manager.h"
+#include "query_cache.h"
 
 #include <aspect/blackboard.h>
 #include <aspect/clock.h>
@@ -32,7 +33,9 @@
 #include <plugins/mongodb/aspect/mongodb_conncreator.h>
 
 #include <bsoncxx/json.hpp>
+#include <map>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -60,6 +63,11 @@ public:
 	mongocxx::cursor query(bsoncxx::document::view query,
 	                       const std::string      &collection_name = "",
 	                       mongocxx::options::find query_options   = mongocxx::options::find());
+	QueryCache::Result
+	query_cached(bsoncxx::document::view        query,
+	             const std::string             &collection_name = "",
+	             const mongocxx::options::find &query_options   = mongocxx::options::find());
+	QueryCache::Statistics query_cache_statistics() const;
 	// TODO fix int return codes, should be booleans
 	int insert(bsoncxx::document::view, const std::string &collection = "");
 	int insert(std::vector<bsoncxx::document::view> v_obj, const std::string &collection = "");
@@ -163,8 +171,11 @@ public:
 	                    double caching_time = 0.0,
 	                    int    priority     = 0)
 	{
-		return computables_manager_->register_computable(
+		Computable *computable = computables_manager_->register_computable(
 		  std::move(query_to_compute), collection, compute_func, obj, caching_time, priority);
+		// cached results do not contain the documents the computable provides
+		query_cache_invalidate(collection);
+		return computable;
 	}
 	void remove_computable(Computable *computable);
 
@@ -191,6 +202,13 @@ private:
 	std::string cfg_coord_database_;
 	std::string cfg_coord_mutex_collection_;
 
+	QueryCache                           *query_cache_;
+	fawkes::Mutex                         query_cache_mutex_;
+	fawkes::Mutex                         query_cache_watch_mutex_;
+	std::map<std::string, EventTrigger *> query_cache_triggers_;
+	std::set<std::string>                 query_cache_unwatched_;
+	std::set<std::string>                 query_cache_stale_;
+
 	void init();
 	void loop();
 
@@ -209,6 +227,11 @@ private:
 	mongocxx::client    *get_mongodb_client(const std::string &collection);
 	mongocxx::collection get_collection(const std::string &dbcollection);
 
+	bool query_cache_watch(const std::string &collection);
+	void query_cache_changed(const bsoncxx::document::view &change);
+	void query_cache_invalidate(const std::string &collection);
+	void query_cache_rewatch();
+
 #ifdef USE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
 	unsigned int         tt_loopcount_;
@@ -93,6 +93,10 @@ SkillerExecutionThread::init()
 
 		lua_->add_package_dir(LUADIR, /* prefix */ true);
 		lua_->add_cpackage_dir(LUALIBDIR, /* prefix */ true);
+#ifdef HAVE_LUAJIT
+		// FFI definitions of interfaces
+		lua_->add_package_dir(LUALIBDIR);
+#endif
 
 		lua_->add_package("fawkesutils");
 		lua_->add_package("fawkesconfig");
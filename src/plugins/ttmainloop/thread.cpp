@@ -22,6 +22,8 @@
 
 #include "thread.h"
 
+#include "wakeup_probe_thread.h"
+
 #include <core/exceptions/system.h>
 #include <utils/time/tracker.h>
 
@@ -56,6 +58,15 @@ TimeTrackerMainLoopThread::init()
 		logger->log_info(name(), "Output interval not set, using 5 seconds.");
 	}
 
+	wakeup_probe_ = NULL;
+	try {
+		if (config->get_bool("/ttmainloop/measure_wakeup_latency")) {
+			wakeup_probe_ = new WakeupProbeThread();
+			wakeup_probe_->start();
+		}
+	} catch (Exception &e) {
+	} // ignored, disabled by default
+
 	last_outp_time_ = new Time(clock);
 	now_            = new Time(clock);
 	last_outp_time_->stamp();
@@ -90,6 +101,11 @@ TimeTrackerMainLoopThread::init()
 void
 TimeTrackerMainLoopThread::finalize()
 {
+	if (wakeup_probe_) {
+		wakeup_probe_->cancel();
+		wakeup_probe_->join();
+		delete wakeup_probe_;
+	}
 	delete loop_start_;
 	delete loop_end_;
 	delete last_outp_time_;
@@ -145,6 +161,10 @@ TimeTrackerMainLoopThread::loop()
 	TIMETRACK_END(ttc_netproc_);
 	TIMETRACK_END(ttc_real_loop_);
 
+	if (wakeup_probe_) {
+		wakeup_probe_->probe();
+	}
+
 	set_cancel_state(old_state);
 
 	test_cancel();
@@ -154,6 +174,20 @@ TimeTrackerMainLoopThread::loop()
 		tt_->print_to_stdout();
 		tt_->print_to_file();
 		tt_->reset();
+		if (wakeup_probe_) {
+			const LatencyHistogram &wl = wakeup_probe_->wakeup_latency();
+			const LatencyHistogram &rl = wakeup_probe_->round_trip_latency();
+			logger->log_info(name(),
+			                 "Wake-up latency: p50 %.1f us  p99 %.1f us  max %lu us, "
+			                 "round trip: p50 %.1f us  p99 %.1f us  max %lu us",
+			                 wl.percentile(0.5) * 1e6,
+			                 wl.percentile(0.99) * 1e6,
+			                 (unsigned long)wl.max_usec(),
+			                 rl.percentile(0.5) * 1e6,
+			                 rl.percentile(0.99) * 1e6,
+			                 (unsigned long)rl.max_usec());
+			wakeup_probe_->reset();
+		}
 		*last_outp_time_ = *now_;
 	}
 }
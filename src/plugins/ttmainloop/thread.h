@@ -35,6 +35,8 @@ class Time;
 class TimeTracker;
 } // namespace fawkes
 
+class WakeupProbeThread;
+
 class TimeTrackerMainLoopThread : public fawkes::Thread,
                                   public fawkes::LoggingAspect,
                                   public fawkes::ClockAspect,
@@ -65,6 +67,8 @@ private:
 	fawkes::Time *loop_start_;
 	fawkes::Time *loop_end_;
 
+	WakeupProbeThread *wakeup_probe_;
+
 	fawkes::TimeTracker *tt_;
 	unsigned int         tt_loopcount_;
 	unsigned int         ttc_pre_loop_;
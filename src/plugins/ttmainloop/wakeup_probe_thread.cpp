@@ -0,0 +1,100 @@
+
+/***************************************************************************
+ *  wakeup_probe_thread.cpp - Thread to measure wake-up latency
+ *
+ *  Created: Mon Oct 19 02:12:05 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "wakeup_probe_thread.h"
+
+#include <core/threading/barrier.h>
+
+using namespace fawkes;
+
+/** @class WakeupProbeThread "wakeup_probe_thread.h"
+ * Thread to measure wake-to-run latency.
+ * The thread does no work in its loop but records the time that passed
+ * since it was woken up. The main loop calls probe() once per iteration,
+ * which wakes up the thread and waits for it at a barrier, just like the
+ * BlockedTimingExecutor does for the threads of a hook. This allows to
+ * benchmark the synchronization overhead of a main loop iteration
+ * independent of the work done by the threads.
+ * @author Tim Niemueller
+ */
+
+/** Constructor. */
+WakeupProbeThread::WakeupProbeThread()
+: Thread("WakeupProbeThread", Thread::OPMODE_WAITFORWAKEUP), wakeup_usec_(0)
+{
+	barrier_ = new Barrier(2);
+}
+
+/** Destructor. */
+WakeupProbeThread::~WakeupProbeThread()
+{
+	delete barrier_;
+}
+
+/** Wake up thread and wait for it to finish its loop.
+ * The time until the thread runs is recorded in the wake-up latency
+ * histogram, the time until this method returns in the round trip latency
+ * histogram.
+ */
+void
+WakeupProbeThread::probe()
+{
+	uint64_t start = LatencyHistogram::now_usec();
+	wakeup_usec_.store(start, std::memory_order_relaxed);
+	wakeup(barrier_);
+	barrier_->wait();
+	round_trip_latency_.record_usec(LatencyHistogram::now_usec() - start);
+}
+
+void
+WakeupProbeThread::loop()
+{
+	uint64_t now = LatencyHistogram::now_usec();
+	wakeup_latency_.record_usec(now - wakeup_usec_.load(std::memory_order_relaxed));
+}
+
+/** Get wake-up latency.
+ * @return histogram of time from wake-up until the thread's loop runs
+ */
+const LatencyHistogram &
+WakeupProbeThread::wakeup_latency() const
+{
+	return wakeup_latency_;
+}
+
+/** Get round trip latency.
+ * @return histogram of time from wake-up until the thread passed the
+ * barrier after its loop
+ */
+const LatencyHistogram &
+WakeupProbeThread::round_trip_latency() const
+{
+	return round_trip_latency_;
+}
+
+/** Reset recorded latencies. */
+void
+WakeupProbeThread::reset()
+{
+	wakeup_latency_.reset();
+	round_trip_latency_.reset();
+}
@@ -0,0 +1,65 @@
+
+/***************************************************************************
+ *  wakeup_probe_thread.h - Thread to measure wake-up latency
+ *
+ *  Created: Mon Oct 19 02:10:37 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_TTMAINLOOP_WAKEUP_PROBE_THREAD_H_
+#define _PLUGINS_TTMAINLOOP_WAKEUP_PROBE_THREAD_H_
+
+#include <core/threading/thread.h>
+#include <utils/time/latency_histogram.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace fawkes {
+class Barrier;
+}
+
+class WakeupProbeThread : public fawkes::Thread
+{
+public:
+	WakeupProbeThread();
+	virtual ~WakeupProbeThread();
+
+	void probe();
+
+	const fawkes::LatencyHistogram &wakeup_latency() const;
+	const fawkes::LatencyHistogram &round_trip_latency() const;
+	void                            reset();
+
+	virtual void loop();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	fawkes::Barrier         *barrier_;
+	std::atomic<uint64_t>    wakeup_usec_;
+	fawkes::LatencyHistogram wakeup_latency_;
+	fawkes::LatencyHistogram round_trip_latency_;
+};
+
+#endif
@@ -21,14 +21,24 @@
 
 #include "blackboard-rest-api.h"
 
+#include "model/InterfaceData.h"
+
+#include <blackboard/interface_listener.h>
 #include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
 #include <interface/message.h>
-#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #include <utils/time/wait.h>
+#include <webview/event_stream.h>
 #include <webview/rest_api_manager.h>
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
 #include <set>
+#include <stdexcept>
 
 using namespace fawkes;
 
@@ -47,17 +57,126 @@ BlackboardRestApi::~BlackboardRestApi()
 {
 }
 
+/// @cond INTERNALS
+// Pushes data changes of interfaces to an event stream. Data is only
+// read and converted when the stream is ready to send, changes occurring
+// in the meantime are coalesced.
+class BlackboardRestApi::DataStream : public BlackBoardInterfaceListener,
+                                      public std::enable_shared_from_this<DataStream>
+{
+public:
+	DataStream(BlackboardRestApi *api, std::shared_ptr<WebviewEventStream> stream)
+	: BlackBoardInterfaceListener("BlackboardRestApiDataStream"),
+	  api(api),
+	  stream(stream),
+	  closed(false)
+	{
+	}
+
+	void
+	add_interface(Interface *iface)
+	{
+		ifaces.push_back(iface);
+		bbil_add_data_interface(iface);
+	}
+
+	virtual void
+	bb_interface_data_changed(Interface *iface) noexcept
+	{
+		publish(iface);
+	}
+
+	void
+	publish(Interface *iface)
+	{
+		std::weak_ptr<DataStream> self = shared_from_this();
+		stream->publish(
+		  "data",
+		  [self, iface]() -> std::string {
+			  std::shared_ptr<DataStream> ds = self.lock();
+			  return ds ? ds->generate(iface) : "";
+		  },
+		  iface->uid());
+	}
+
+	// The first event of an interface contains all fields, subsequent
+	// events only the fields changed since the previous event.
+	std::string
+	generate(Interface *iface)
+	{
+		MutexLocker lock(&mutex);
+		if (closed) {
+			return "";
+		}
+
+		iface->read();
+		std::shared_ptr<const DataLayout> layout = api->data_layout(iface);
+
+		std::string &last     = last_data[iface];
+		const char  *data     = (const char *)iface->datachunk();
+		const char  *previous = nullptr;
+		if (last.size() == iface->datasize()) {
+			previous = last.data();
+			bool changed =
+			  std::any_of(layout->fields.begin(), layout->fields.end(), [&](const DataLayout::Field &f) {
+				  return memcmp(previous + f.offset, data + f.offset, f.size) != 0;
+			  });
+			if (!changed) {
+				return "";
+			}
+		}
+
+		rapidjson::StringBuffer                    buffer;
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		api->write_interface_data(writer, iface, *layout, previous);
+		last.assign(data, iface->datasize());
+		return std::string(buffer.GetString(), buffer.GetSize());
+	}
+
+	void
+	close()
+	{
+		api->blackboard->unregister_listener(this);
+		MutexLocker lock(&mutex);
+		closed = true;
+		for (Interface *iface : ifaces) {
+			api->blackboard->close(iface);
+		}
+		ifaces.clear();
+		last_data.clear();
+	}
+
+	BlackboardRestApi                  *api;
+	std::shared_ptr<WebviewEventStream> stream;
+	std::vector<Interface *>            ifaces;
+
+	Mutex                              mutex;
+	bool                               closed;
+	std::map<Interface *, std::string> last_data;
+};
+/// @endcond
+
 void
 BlackboardRestApi::init()
 {
 	rest_api_ = new WebviewRestApi("blackboard", logger);
 	rest_api_->add_handler<WebviewRestArray<::InterfaceInfo>>(
 	  WebRequest::METHOD_GET, "/interfaces", std::bind(&BlackboardRestApi::cb_list_interfaces, this));
-	rest_api_->add_handler<InterfaceData>(WebRequest::METHOD_GET,
-	                                      "/interfaces/{type}/{id+}/data",
-	                                      std::bind(&BlackboardRestApi::cb_get_interface_data,
-	                                                this,
-	                                                std::placeholders::_1));
+	rest_api_->add_handler(WebRequest::METHOD_GET,
+	                       "/interfaces/data",
+	                       std::bind(&BlackboardRestApi::cb_get_interfaces_data,
+	                                 this,
+	                                 std::placeholders::_1));
+	rest_api_->add_handler(WebRequest::METHOD_GET,
+	                       "/interfaces/stream",
+	                       std::bind(&BlackboardRestApi::cb_stream_interfaces_data,
+	                                 this,
+	                                 std::placeholders::_1));
+	rest_api_->add_handler(WebRequest::METHOD_GET,
+	                       "/interfaces/{type}/{id+}/data",
+	                       std::bind(&BlackboardRestApi::cb_get_interface_data,
+	                                 this,
+	                                 std::placeholders::_1));
 	rest_api_->add_handler<::InterfaceInfo>(WebRequest::METHOD_GET,
 	                                        "/interfaces/{type}/{id+}",
 	                                        std::bind(&BlackboardRestApi::cb_get_interface_info,
@@ -74,6 +193,16 @@ BlackboardRestApi::finalize()
 {
 	webview_rest_api_manager->unregister_api(rest_api_);
 	delete rest_api_;
+
+	std::list<std::shared_ptr<DataStream>> data_streams;
+	{
+		MutexLocker lock(&data_streams_mutex_);
+		data_streams = data_streams_;
+	}
+	// runs the close callbacks, which release the interfaces
+	for (auto &ds : data_streams) {
+		ds->stream->close();
+	}
 }
 
 void
@@ -146,104 +275,240 @@ BlackboardRestApi::gen_interface_info(const fawkes::InterfaceInfo &ii)
 	return info;
 }
 
-#define FIELD_ARRAY_CASE(TYPE, type, ctype)                          \
-	case IFT_##TYPE: {                                                 \
-		const ctype *values = i.get_##type##s();                         \
-		for (unsigned int j = 0; j < i.get_length(); ++j) {              \
-			value.PushBack(rapidjson::Value{values[j]}.Move(), allocator); \
-		}                                                                \
-		break;                                                           \
+static size_t
+field_type_size(interface_fieldtype_t type)
+{
+	switch (type) {
+	case IFT_BOOL: return sizeof(bool);
+	case IFT_INT8: return sizeof(int8_t);
+	case IFT_UINT8: return sizeof(uint8_t);
+	case IFT_INT16: return sizeof(int16_t);
+	case IFT_UINT16: return sizeof(uint16_t);
+	case IFT_INT32: return sizeof(int32_t);
+	case IFT_UINT32: return sizeof(uint32_t);
+	case IFT_INT64: return sizeof(int64_t);
+	case IFT_UINT64: return sizeof(uint64_t);
+	case IFT_FLOAT: return sizeof(float);
+	case IFT_DOUBLE: return sizeof(double);
+	case IFT_STRING: return sizeof(char);
+	case IFT_BYTE: return sizeof(uint8_t);
+	case IFT_ENUM: return sizeof(int32_t);
 	}
+	return 0;
+}
 
-static rapidjson::Value
-gen_field_value(fawkes::InterfaceFieldIterator     &i,
-                fawkes::Interface                  *iface,
-                rapidjson::Document::AllocatorType &allocator)
+static uint64_t
+fnv1a(uint64_t hash, const void *data, size_t size)
 {
-	rapidjson::Value value;
-
-	if (i.get_length() > 1) {
-		if (i.get_type() == IFT_STRING) {
-			value.SetString(std::string(i.get_string()), allocator);
-		} else {
-			value.SetArray();
-			value.Reserve(i.get_length(), allocator);
-
-			switch (i.get_type()) {
-				FIELD_ARRAY_CASE(BOOL, bool, bool);
-				FIELD_ARRAY_CASE(INT8, int8, int8_t);
-				FIELD_ARRAY_CASE(UINT8, uint8, uint8_t);
-				FIELD_ARRAY_CASE(INT16, int16, int16_t);
-				FIELD_ARRAY_CASE(UINT16, uint16, uint16_t);
-				FIELD_ARRAY_CASE(INT32, int32, int32_t);
-				FIELD_ARRAY_CASE(UINT32, uint32, uint32_t);
-				FIELD_ARRAY_CASE(INT64, int64, int64_t);
-				FIELD_ARRAY_CASE(UINT64, uint64, uint64_t);
-				FIELD_ARRAY_CASE(FLOAT, float, float);
-				FIELD_ARRAY_CASE(DOUBLE, double, double);
-				FIELD_ARRAY_CASE(BYTE, byte, uint8_t);
+	const unsigned char *bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static uint64_t
+fnv1a(uint64_t hash, const std::string &s)
+{
+	// include terminating zero to separate consecutive strings
+	return fnv1a(hash, s.c_str(), s.size() + 1);
+}
+
+/** Get precompiled data layout for an interface.
+ * The layout is determined once per interface type and hash and then
+ * re-used for all instances of that type.
+ * @param iface interface to get the layout for
+ * @return data layout
+ */
+std::shared_ptr<const BlackboardRestApi::DataLayout>
+BlackboardRestApi::data_layout(Interface *iface)
+{
+	std::string key = std::string(iface->type()) + "::" + iface->hash_printable();
+
+	MutexLocker lock(&data_layouts_mutex_);
+	auto        l = data_layouts_.find(key);
+	if (l != data_layouts_.end()) {
+		return l->second;
+	}
 
+	std::shared_ptr<DataLayout> layout = std::make_shared<DataLayout>();
+	const char                 *data   = (const char *)iface->datachunk();
+	for (auto i = iface->fields(); i != iface->fields_end(); ++i) {
+		DataLayout::Field field;
+		field.name   = i.get_name();
+		field.type   = i.get_type();
+		field.length = i.get_length();
+		field.offset = (const char *)i.get_value() - data;
+		field.size   = field.length * field_type_size(field.type);
+		if (i.is_enum() && i.get_enum_map()) {
+			field.enum_map = *i.get_enum_map();
+		}
+		layout->fields.push_back(std::move(field));
+	}
+	data_layouts_[key] = layout;
+	return layout;
+}
+
+/** Write interface data as JSON.
+ * Values are read directly from the interface's data chunk according to
+ * the precompiled layout, without going through field iterators or an
+ * intermediate JSON document.
+ * @param writer JSON writer to write to
+ * @param iface interface to write, must have been read
+ * @param layout data layout of the interface type
+ * @param previous previous data chunk of the interface, if given only
+ * fields which differ from it are written
+ */
+template <class Writer>
+void
+BlackboardRestApi::write_interface_data(Writer           &writer,
+                                        Interface        *iface,
+                                        const DataLayout &layout,
+                                        const char       *previous)
+{
+	writer.StartObject();
+	writer.Key("kind");
+	writer.String("InterfaceData");
+	writer.Key("apiVersion");
+	writer.String(InterfaceData::api_version().c_str());
+	writer.Key("id");
+	writer.String(iface->id());
+	writer.Key("type");
+	writer.String(iface->type());
+	if (iface->has_writer()) {
+		std::string w = iface->writer();
+		writer.Key("writer");
+		writer.String(w.c_str(), w.size());
+	}
+	writer.Key("readers");
+	writer.StartArray();
+	for (const std::string &r : iface->readers()) {
+		writer.String(r.c_str(), r.size());
+	}
+	writer.EndArray();
+
+	writer.Key("data");
+	writer.StartObject();
+	const char *data = (const char *)iface->datachunk();
+	for (const DataLayout::Field &field : layout.fields) {
+		const char *value = data + field.offset;
+		if (previous && memcmp(previous + field.offset, value, field.size) == 0) {
+			continue;
+		}
+		writer.Key(field.name.c_str(), field.name.size());
+		if (field.type == IFT_STRING) {
+			writer.String(value, strnlen(value, field.length));
+			continue;
+		}
+
+		bool is_array = (field.length > 1);
+		if (is_array) {
+			writer.StartArray();
+		}
+		for (size_t j = 0; j < field.length; ++j) {
+			switch (field.type) {
+			case IFT_BOOL: writer.Bool(((const bool *)value)[j]); break;
+			case IFT_INT8: writer.Int(((const int8_t *)value)[j]); break;
+			case IFT_UINT8: writer.Uint(((const uint8_t *)value)[j]); break;
+			case IFT_INT16: writer.Int(((const int16_t *)value)[j]); break;
+			case IFT_UINT16: writer.Uint(((const uint16_t *)value)[j]); break;
+			case IFT_INT32: writer.Int(((const int32_t *)value)[j]); break;
+			case IFT_UINT32: writer.Uint(((const uint32_t *)value)[j]); break;
+			case IFT_INT64: writer.Int64(((const int64_t *)value)[j]); break;
+			case IFT_UINT64: writer.Uint64(((const uint64_t *)value)[j]); break;
+			case IFT_FLOAT: writer.Double(((const float *)value)[j]); break;
+			case IFT_DOUBLE: writer.Double(((const double *)value)[j]); break;
+			case IFT_BYTE: writer.Uint(((const uint8_t *)value)[j]); break;
 			case IFT_ENUM: {
-				const int32_t *values = i.get_enums();
-				for (unsigned int j = 0; j < i.get_length(); ++j) {
-					value.PushBack(
-					  rapidjson::Value{iface->enum_tostring(i.get_typename(), values[j]), allocator}.Move(),
-					  allocator);
+				auto e = field.enum_map.find(((const int32_t *)value)[j]);
+				if (e != field.enum_map.end()) {
+					writer.String(e->second.c_str(), e->second.size());
+				} else {
+					writer.String("UNKNOWN");
 				}
 				break;
 			}
-
 			case IFT_STRING: break; // handled above
 			}
 		}
-	} else {
-		switch (i.get_type()) {
-		case IFT_BOOL: value.SetBool(i.get_bool()); break;
-		case IFT_INT8: value.SetInt(i.get_int8()); break;
-		case IFT_UINT8: value.SetUint(i.get_uint8()); break;
-		case IFT_INT16: value.SetInt(i.get_int16()); break;
-		case IFT_UINT16: value.SetUint(i.get_uint16()); break;
-		case IFT_INT32: value.SetInt(i.get_int32()); break;
-		case IFT_UINT32: value.SetUint(i.get_uint32()); break;
-		case IFT_INT64: value.SetInt64(i.get_int64()); break;
-		case IFT_UINT64: value.SetUint64(i.get_uint64()); break;
-		case IFT_FLOAT: value.SetFloat(i.get_float()); break;
-		case IFT_DOUBLE: value.SetDouble(i.get_double()); break;
-		case IFT_BYTE: value.SetUint(i.get_byte()); break;
-		case IFT_STRING: [[fallthrough]];
-		case IFT_ENUM: value.SetString(std::string(i.get_value_string()), allocator);
+		if (is_array) {
+			writer.EndArray();
 		}
 	}
-	return value;
+	writer.EndObject();
+
+	writer.Key("timestamp");
+	writer.String(iface->timestamp()->str());
+	writer.EndObject();
 }
 
-InterfaceData
-BlackboardRestApi::gen_interface_data(Interface *iface, bool pretty)
+/** Create reply with data of interfaces.
+ * The reply carries an ETag computed from the data of the interfaces and
+ * their writer and readers. If the client already has the current data,
+ * i.e., it sent a matching If-None-Match header, a 304 reply without
+ * body is returned and the JSON serialization is skipped.
+ * @param ifaces interfaces to serialize, must have been read
+ * @param as_array true to reply with an array of data objects, false to
+ * reply with a single data object of the one given interface
+ * @param params REST parameters
+ * @return reply
+ */
+std::unique_ptr<WebReply>
+BlackboardRestApi::data_reply(const std::vector<Interface *> &ifaces,
+                              bool                            as_array,
+                              WebviewRestParams              &params)
 {
-	InterfaceData data;
-	data.set_kind("InterfaceData");
-	data.set_apiVersion(InterfaceData::api_version());
-	data.set_type(iface->type());
-	data.set_id(iface->id());
-	if (iface->has_writer()) {
-		data.set_writer(iface->writer());
+	std::vector<std::shared_ptr<const DataLayout>> layouts;
+	layouts.reserve(ifaces.size());
+
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (Interface *iface : ifaces) {
+		layouts.push_back(data_layout(iface));
+		hash = fnv1a(hash, iface->uid());
+		hash = fnv1a(hash, iface->datachunk(), iface->datasize());
+		hash = fnv1a(hash, iface->has_writer() ? iface->writer() : "");
+		for (const std::string &r : iface->readers()) {
+			hash = fnv1a(hash, r);
+		}
 	}
-	std::list<std::string> readers = iface->readers();
-	data.set_readers(std::vector<std::string>{std::begin(readers), std::end(readers)});
-	data.set_timestamp(iface->timestamp()->str());
 
-	// Generate data as JSON document
-	std::shared_ptr<rapidjson::Document> d         = std::make_shared<rapidjson::Document>();
-	rapidjson::Document::AllocatorType  &allocator = d->GetAllocator();
-	d->SetObject();
+	char etag[32];
+	snprintf(etag, sizeof(etag), "W/\"%016" PRIx64 "\"", hash);
+	// compare without the weak indicator, clients may or may not send it
+	std::string if_none_match = params.header("If-None-Match");
+	if (if_none_match == "*" || if_none_match.find(etag + 2) != std::string::npos) {
+		auto reply = std::make_unique<WebviewRestReply>(WebReply::HTTP_NOT_MODIFIED);
+		reply->add_header("ETag", etag);
+		return reply;
+	}
 
-	for (auto i = iface->fields(); i != iface->fields_end(); ++i) {
-		rapidjson::Value name(i.get_name(), allocator);
-		d->AddMember(name.Move(), gen_field_value(i, iface, allocator).Move(), allocator);
+	auto write = [&](auto &writer) {
+		if (as_array) {
+			writer.StartArray();
+		}
+		for (size_t i = 0; i < ifaces.size(); ++i) {
+			write_interface_data(writer, ifaces[i], *layouts[i]);
+		}
+		if (as_array) {
+			writer.EndArray();
+		}
+	};
+
+	rapidjson::StringBuffer buffer;
+	if (params.has_query_arg("pretty")) {
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		write(writer);
+	} else {
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		write(writer);
 	}
-	data.set_data(d);
 
-	return data;
+	auto reply = std::make_unique<WebviewRestReply>(WebReply::HTTP_OK,
+	                                                std::string(buffer.GetString(),
+	                                                            buffer.GetSize()));
+	reply->add_header("ETag", etag);
+	reply->add_header("Cache-Control", "no-cache");
+	return reply;
 }
 
 WebviewRestArray<::InterfaceInfo>
@@ -282,12 +547,9 @@ BlackboardRestApi::cb_get_interface_info(WebviewRestParams &params)
 	return gen_interface_info(ifls->front());
 }
 
-InterfaceData
+std::unique_ptr<WebReply>
 BlackboardRestApi::cb_get_interface_data(WebviewRestParams &params)
 {
-	bool pretty = params.has_query_arg("pretty");
-	params.set_pretty_json(pretty);
-
 	if (params.path_arg("type").find_first_of("*?") != std::string::npos) {
 		throw WebviewRestException(WebReply::HTTP_BAD_REQUEST, "Type may not contain any of [*?].");
 	}
@@ -318,9 +580,9 @@ BlackboardRestApi::cb_get_interface_data(WebviewRestParams &params)
 	}
 
 	try {
-		InterfaceData d{gen_interface_data(iface, pretty)};
+		std::unique_ptr<WebReply> reply{data_reply({iface}, false, params)};
 		blackboard->close(iface);
-		return d;
+		return reply;
 	} catch (Exception &e) {
 		blackboard->close(iface);
 		throw WebviewRestException(WebReply::HTTP_NOT_FOUND,
@@ -331,6 +593,128 @@ BlackboardRestApi::cb_get_interface_data(WebviewRestParams &params)
 	}
 }
 
+/** Select interfaces according to query arguments.
+ * Interfaces are selected by a comma-separated list of UIDs in the "ids"
+ * query argument, or by "type" and "id" patterns otherwise.
+ * @param params REST parameters
+ * @return list of selected interfaces currently available
+ */
+std::unique_ptr<InterfaceInfoList>
+BlackboardRestApi::select_interfaces(WebviewRestParams &params)
+{
+	std::unique_ptr<InterfaceInfoList> ifls;
+	if (params.has_query_arg("ids")) {
+		std::unique_ptr<InterfaceInfoList>                   all{blackboard->list_all()};
+		std::map<std::string, const fawkes::InterfaceInfo *> available;
+		for (const auto &ii : *all) {
+			available[std::string(ii.type()) + "::" + ii.id()] = &ii;
+		}
+
+		ifls = std::make_unique<InterfaceInfoList>();
+		for (const std::string &uid : str_split(params.query_arg("ids"), ',')) {
+			if (uid.find("::") == std::string::npos) {
+				throw WebviewRestException(WebReply::HTTP_BAD_REQUEST,
+				                           "Invalid interface UID '%s', expected type::id",
+				                           uid.c_str());
+			}
+			auto a = available.find(uid);
+			if (a != available.end()) {
+				ifls->push_back(*a->second);
+			}
+		}
+	} else {
+		std::string type = params.has_query_arg("type") ? params.query_arg("type") : "*";
+		std::string id   = params.has_query_arg("id") ? params.query_arg("id") : "*";
+		ifls.reset(blackboard->list(type.c_str(), id.c_str()));
+	}
+	return ifls;
+}
+
+std::unique_ptr<WebReply>
+BlackboardRestApi::cb_get_interfaces_data(WebviewRestParams &params)
+{
+	std::unique_ptr<InterfaceInfoList> ifls{select_interfaces(params)};
+
+	std::vector<Interface *> ifaces;
+	ifaces.reserve(ifls->size());
+	for (const auto &ii : *ifls) {
+		try {
+			Interface *iface = blackboard->open_for_reading(ii.type(), ii.id());
+			ifaces.push_back(iface);
+			iface->read();
+		} catch (Exception &e) {
+			// interface may have vanished since listing, skip
+		}
+	}
+
+	try {
+		std::unique_ptr<WebReply> reply{data_reply(ifaces, true, params)};
+		for (Interface *iface : ifaces) {
+			blackboard->close(iface);
+		}
+		return reply;
+	} catch (Exception &e) {
+		for (Interface *iface : ifaces) {
+			blackboard->close(iface);
+		}
+		throw WebviewRestException(WebReply::HTTP_INTERNAL_SERVER_ERROR,
+		                           "Failed to read interfaces: %s",
+		                           e.what_no_backtrace());
+	}
+}
+
+std::unique_ptr<WebReply>
+BlackboardRestApi::cb_stream_interfaces_data(WebviewRestParams &params)
+{
+	float max_rate = 10.f;
+	if (params.has_query_arg("max_rate")) {
+		try {
+			max_rate = std::stof(params.query_arg("max_rate"));
+		} catch (std::logic_error &e) {
+			throw WebviewRestException(WebReply::HTTP_BAD_REQUEST,
+			                           "Invalid max_rate '%s'",
+			                           params.query_arg("max_rate").c_str());
+		}
+	}
+
+	std::unique_ptr<InterfaceInfoList> ifls{select_interfaces(params)};
+
+	std::shared_ptr<WebviewEventStream> stream = WebviewEventStream::create(max_rate);
+	std::shared_ptr<DataStream>         ds     = std::make_shared<DataStream>(this, stream);
+	for (const auto &ii : *ifls) {
+		try {
+			Interface *iface = blackboard->open_for_reading(ii.type(), ii.id());
+			ds->add_interface(iface);
+		} catch (Exception &e) {
+			// interface may have vanished since listing, skip
+		}
+	}
+	if (ds->ifaces.empty()) {
+		throw WebviewRestException(WebReply::HTTP_NOT_FOUND, "No matching interfaces available");
+	}
+
+	blackboard->register_listener(ds.get(), BlackBoard::BBIL_FLAG_DATA);
+	{
+		MutexLocker lock(&data_streams_mutex_);
+		data_streams_.push_back(ds);
+	}
+	std::weak_ptr<DataStream> weak_ds = ds;
+	stream->add_close_callback([this, weak_ds]() {
+		if (std::shared_ptr<DataStream> ds = weak_ds.lock()) {
+			ds->close();
+			MutexLocker lock(&data_streams_mutex_);
+			data_streams_.remove(ds);
+		}
+	});
+
+	// initial event with the full data of each interface
+	for (Interface *iface : ds->ifaces) {
+		ds->publish(iface);
+	}
+
+	return std::make_unique<WebviewEventStreamReply>(stream);
+}
+
 std::string
 BlackboardRestApi::generate_graph(const std::string &for_owner)
 {
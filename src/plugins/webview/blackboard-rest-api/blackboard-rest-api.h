@@ -22,22 +22,25 @@
 #pragma once
 
 #include "model/BlackboardGraph.h"
-#include "model/InterfaceData.h"
 #include "model/InterfaceInfo.h"
 
 #include <aspect/blackboard.h>
 #include <aspect/clock.h>
 #include <aspect/logging.h>
 #include <aspect/webview.h>
+#include <core/threading/mutex.h>
 #include <core/threading/thread.h>
 #include <interface/field_iterator.h>
 #include <interface/interface_info.h>
 #include <webview/rest_api.h>
 #include <webview/rest_array.h>
 
+#include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 class BlackboardRestApi : public fawkes::Thread,
                           public fawkes::ClockAspect,
@@ -58,7 +61,9 @@ private:
 
 	InterfaceInfo cb_get_interface_info(fawkes::WebviewRestParams &params);
 
-	InterfaceData cb_get_interface_data(fawkes::WebviewRestParams &params);
+	std::unique_ptr<fawkes::WebReply> cb_get_interface_data(fawkes::WebviewRestParams &params);
+	std::unique_ptr<fawkes::WebReply> cb_get_interfaces_data(fawkes::WebviewRestParams &params);
+	std::unique_ptr<fawkes::WebReply> cb_stream_interfaces_data(fawkes::WebviewRestParams &params);
 
 	BlackboardGraph cb_get_graph();
 
@@ -66,7 +71,37 @@ private:
 	                                                            fawkes::InterfaceFieldIterator end);
 
 	InterfaceInfo gen_interface_info(const fawkes::InterfaceInfo &ii);
-	InterfaceData gen_interface_data(fawkes::Interface *iface, bool pretty);
+
+	std::unique_ptr<fawkes::InterfaceInfoList> select_interfaces(fawkes::WebviewRestParams &params);
+
+	/// @cond INTERNALS
+	// Precompiled layout of the data of an interface type
+	struct DataLayout
+	{
+		struct Field
+		{
+			std::string                   name;
+			fawkes::interface_fieldtype_t type;
+			size_t                        length;
+			size_t                        offset;
+			size_t                        size;
+			fawkes::interface_enum_map_t  enum_map;
+		};
+		std::vector<Field> fields;
+	};
+
+	class DataStream;
+	/// @endcond
+
+	std::shared_ptr<const DataLayout> data_layout(fawkes::Interface *iface);
+	std::unique_ptr<fawkes::WebReply> data_reply(const std::vector<fawkes::Interface *> &ifaces,
+	                                             bool                                    as_array,
+	                                             fawkes::WebviewRestParams              &params);
+	template <class Writer>
+	void write_interface_data(Writer            &writer,
+	                          fawkes::Interface *iface,
+	                          const DataLayout  &layout,
+	                          const char        *previous = nullptr);
 
 	std::string generate_graph(const std::string &for_owner = "");
 
@@ -77,4 +112,10 @@ private:
 	         std::pair<std::vector<std::shared_ptr<InterfaceFieldType>>,
 	                   std::vector<std::shared_ptr<InterfaceMessageType>>>>
 	  type_info_cache_;
+
+	fawkes::Mutex                                            data_layouts_mutex_;
+	std::map<std::string, std::shared_ptr<const DataLayout>> data_layouts_;
+
+	fawkes::Mutex                          data_streams_mutex_;
+	std::list<std::shared_ptr<DataStream>> data_streams_;
 };
@@ -43,6 +43,31 @@ export class BlackboardApiService {
         observe: 'body', responseType: 'json' });
       }
 
+  public get_interfaces_data(ids?: string, type?: string, id?: string, pretty?: boolean): Observable<InterfaceData[]> {
+    // tslint:disable-next-line:prefer-const
+    let params = new HttpParams();
+    if (ids) {
+      params = params.set('ids', ids);
+    }
+    if (type) {
+      params = params.set('type', type);
+    }
+    if (id) {
+      params = params.set('id', id);
+    }
+    if (pretty) {
+      params = params.set('pretty', pretty.toString());
+    }
+    // tslint:disable-next-line:prefer-const
+    let headers = new HttpHeaders();
+
+    headers = headers.set('Accept', 'application/json');
+    // tslint:disable-next-line:max-line-length
+    return this.http.get<InterfaceData[]>(`${this.backend.url_for('api')}/blackboard/interfaces/data`,
+      { headers: headers, params: params,
+        observe: 'body', responseType: 'json' });
+      }
+
   public get_interface_info(type: string, id: string, pretty?: boolean): Observable<InterfaceInfo> {
     if (type === null || type === undefined) {
       throw new Error('Required parameter type is null or undefined (get_interface_info)');
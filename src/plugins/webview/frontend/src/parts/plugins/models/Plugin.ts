@@ -21,6 +21,9 @@ export interface Plugin {
   is_meta: boolean;
   meta_children?: Array<string>;
   is_loaded: boolean;
+  load_start?: number;
+  load_duration?: number;
+  init_duration?: number;
 }
 
 export namespace Plugin {
@@ -103,6 +103,21 @@ Plugin::to_json_value(rapidjson::Document &d, rapidjson::Value &v) const
 		v_is_loaded.SetBool(*is_loaded_);
 		v.AddMember("is_loaded", v_is_loaded, allocator);
 	}
+	if (load_start_) {
+		rapidjson::Value v_load_start;
+		v_load_start.SetFloat(*load_start_);
+		v.AddMember("load_start", v_load_start, allocator);
+	}
+	if (load_duration_) {
+		rapidjson::Value v_load_duration;
+		v_load_duration.SetFloat(*load_duration_);
+		v.AddMember("load_duration", v_load_duration, allocator);
+	}
+	if (init_duration_) {
+		rapidjson::Value v_init_duration;
+		v_init_duration.SetFloat(*init_duration_);
+		v.AddMember("init_duration", v_init_duration, allocator);
+	}
 }
 
 void
@@ -144,6 +159,15 @@ Plugin::from_json_value(const rapidjson::Value &d)
 	if (d.HasMember("is_loaded") && d["is_loaded"].IsBool()) {
 		is_loaded_ = d["is_loaded"].GetBool();
 	}
+	if (d.HasMember("load_start") && d["load_start"].IsFloat()) {
+		load_start_ = d["load_start"].GetFloat();
+	}
+	if (d.HasMember("load_duration") && d["load_duration"].IsFloat()) {
+		load_duration_ = d["load_duration"].GetFloat();
+	}
+	if (d.HasMember("init_duration") && d["init_duration"].IsFloat()) {
+		init_duration_ = d["init_duration"].GetFloat();
+	}
 }
 
 void
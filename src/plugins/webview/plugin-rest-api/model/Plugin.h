@@ -222,6 +222,57 @@ public:
 	{
 		is_loaded_ = is_loaded;
 	}
+	/** Get load_start value.
+   * @return load_start value
+   */
+	std::optional<float>
+	load_start() const
+	{
+		return load_start_;
+	}
+
+	/** Set load_start value.
+	 * @param load_start new value
+	 */
+	void
+	set_load_start(const float &load_start)
+	{
+		load_start_ = load_start;
+	}
+	/** Get load_duration value.
+   * @return load_duration value
+   */
+	std::optional<float>
+	load_duration() const
+	{
+		return load_duration_;
+	}
+
+	/** Set load_duration value.
+	 * @param load_duration new value
+	 */
+	void
+	set_load_duration(const float &load_duration)
+	{
+		load_duration_ = load_duration;
+	}
+	/** Get init_duration value.
+   * @return init_duration value
+   */
+	std::optional<float>
+	init_duration() const
+	{
+		return init_duration_;
+	}
+
+	/** Set init_duration value.
+	 * @param init_duration new value
+	 */
+	void
+	set_init_duration(const float &init_duration)
+	{
+		init_duration_ = init_duration;
+	}
 
 private:
 	std::optional<std::string> kind_;
@@ -231,4 +282,7 @@ private:
 	std::optional<bool>        is_meta_;
 	std::vector<std::string>   meta_children_;
 	std::optional<bool>        is_loaded_;
+	std::optional<float>       load_start_;
+	std::optional<float>       load_duration_;
+	std::optional<float>       init_duration_;
 };
\ No newline at end of file
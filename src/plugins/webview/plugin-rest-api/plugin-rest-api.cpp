@@ -23,6 +23,8 @@
 
 #include "model/Plugin.h"
 
+#include <plugin/manager.h>
+#include <utils/time/time.h>
 #include <webview/rest_api_manager.h>
 
 using namespace fawkes;
@@ -73,6 +75,15 @@ PluginRestApi::cb_list_plugins()
 {
 	WebviewRestArray<::Plugin> rv;
 
+	std::map<std::string, PluginManager::StartupTiming> timings;
+	Time                                                first_start((long)0, (long)0);
+	for (const auto &t : plugin_manager->get_startup_timeline()) {
+		timings[t.name] = t;
+		if (first_start.is_zero() || t.start < first_start) {
+			first_start = t.start;
+		}
+	}
+
 	auto available_plugins = plugin_manager->get_available_plugins();
 	for (const auto &i : available_plugins) {
 		const std::string &name        = i.first;
@@ -92,6 +103,12 @@ PluginRestApi::cb_list_plugins()
 			p.set_meta_children(std::move(v));
 		}
 		p.set_is_loaded(is_loaded);
+		auto t = timings.find(name);
+		if (is_loaded && t != timings.end()) {
+			p.set_load_start(t->second.start - &first_start);
+			p.set_load_duration(t->second.load_duration);
+			p.set_init_duration(t->second.init_duration);
+		}
 		rv.push_back(std::move(p));
 	}
 
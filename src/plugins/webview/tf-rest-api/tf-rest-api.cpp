@@ -21,8 +21,13 @@
 
 #include "tf-rest-api.h"
 
+#include <blackboard/interface_listener.h>
+#include <core/threading/mutex_locker.h>
+#include <webview/event_stream.h>
 #include <webview/rest_api_manager.h>
 
+#include <stdexcept>
+
 using namespace fawkes;
 
 /** @class TransformsRestApi "skiller-rest-api.h"
@@ -40,6 +45,87 @@ TransformsRestApi::~TransformsRestApi()
 {
 }
 
+/// @cond INTERNALS
+// Pushes the transform graph to an event stream whenever a transform
+// interface changes. The graph is only generated when the stream is
+// ready to send, changes occurring in the meantime are coalesced.
+class TransformsRestApi::GraphStream : public BlackBoardInterfaceListener,
+                                       public std::enable_shared_from_this<GraphStream>
+{
+public:
+	GraphStream(TransformsRestApi *api, std::shared_ptr<WebviewEventStream> stream)
+	: BlackBoardInterfaceListener("TransformsRestApiGraphStream"),
+	  api(api),
+	  stream(stream),
+	  closed(false)
+	{
+	}
+
+	void
+	add_interface(Interface *iface)
+	{
+		ifaces.push_back(iface);
+		bbil_add_data_interface(iface);
+	}
+
+	virtual void
+	bb_interface_data_changed(Interface *iface) noexcept
+	{
+		publish();
+	}
+
+	void
+	publish()
+	{
+		std::weak_ptr<GraphStream> self = shared_from_this();
+		stream->publish("graph", [self]() -> std::string {
+			std::shared_ptr<GraphStream> gs = self.lock();
+			return gs ? gs->generate() : "";
+		});
+	}
+
+	std::string
+	generate()
+	{
+		MutexLocker lock(&mutex);
+		if (closed) {
+			return "";
+		}
+		std::string dotgraph = api->tf_listener->all_frames_as_dot(true);
+		if (dotgraph == last_dotgraph) {
+			return "";
+		}
+		last_dotgraph = dotgraph;
+
+		TransformsGraph graph;
+		graph.set_kind("TransformsGraph");
+		graph.set_apiVersion(TransformsGraph::api_version());
+		graph.set_dotgraph(dotgraph);
+		return graph.to_json();
+	}
+
+	void
+	close()
+	{
+		api->blackboard->unregister_listener(this);
+		MutexLocker lock(&mutex);
+		closed = true;
+		for (Interface *iface : ifaces) {
+			api->blackboard->close(iface);
+		}
+		ifaces.clear();
+	}
+
+	TransformsRestApi                  *api;
+	std::shared_ptr<WebviewEventStream> stream;
+	std::list<Interface *>              ifaces;
+
+	Mutex       mutex;
+	bool        closed;
+	std::string last_dotgraph;
+};
+/// @endcond
+
 void
 TransformsRestApi::init()
 {
@@ -47,6 +133,11 @@ TransformsRestApi::init()
 	rest_api_->add_handler<TransformsGraph>(WebRequest::METHOD_GET,
 	                                        "/graph",
 	                                        std::bind(&TransformsRestApi::cb_get_graph, this));
+	rest_api_->add_handler(WebRequest::METHOD_GET,
+	                       "/graph/stream",
+	                       std::bind(&TransformsRestApi::cb_stream_graph,
+	                                 this,
+	                                 std::placeholders::_1));
 	webview_rest_api_manager->register_api(rest_api_);
 }
 
@@ -55,6 +146,16 @@ TransformsRestApi::finalize()
 {
 	webview_rest_api_manager->unregister_api(rest_api_);
 	delete rest_api_;
+
+	std::list<std::shared_ptr<GraphStream>> graph_streams;
+	{
+		MutexLocker lock(&graph_streams_mutex_);
+		graph_streams = graph_streams_;
+	}
+	// runs the close callbacks, which release the interfaces
+	for (auto &gs : graph_streams) {
+		gs->stream->close();
+	}
 }
 
 void
@@ -77,3 +178,49 @@ TransformsRestApi::cb_get_graph()
 		                           e.what_no_backtrace());
 	}
 }
+
+std::unique_ptr<WebReply>
+TransformsRestApi::cb_stream_graph(WebviewRestParams &params)
+{
+	float max_rate = 1.f;
+	if (params.has_query_arg("max_rate")) {
+		try {
+			max_rate = std::stof(params.query_arg("max_rate"));
+		} catch (std::logic_error &e) {
+			throw WebviewRestException(WebReply::HTTP_BAD_REQUEST,
+			                           "Invalid max_rate '%s'",
+			                           params.query_arg("max_rate").c_str());
+		}
+	}
+
+	std::shared_ptr<WebviewEventStream> stream = WebviewEventStream::create(max_rate);
+	std::shared_ptr<GraphStream>        gs     = std::make_shared<GraphStream>(this, stream);
+	try {
+		for (Interface *iface : blackboard->open_multiple_for_reading("TransformInterface")) {
+			gs->add_interface(iface);
+		}
+	} catch (Exception &e) {
+		throw WebviewRestException(WebReply::HTTP_INTERNAL_SERVER_ERROR,
+		                           "Failed to open transform interfaces: %s",
+		                           e.what_no_backtrace());
+	}
+
+	blackboard->register_listener(gs.get(), BlackBoard::BBIL_FLAG_DATA);
+	{
+		MutexLocker lock(&graph_streams_mutex_);
+		graph_streams_.push_back(gs);
+	}
+	std::weak_ptr<GraphStream> weak_gs = gs;
+	stream->add_close_callback([this, weak_gs]() {
+		if (std::shared_ptr<GraphStream> gs = weak_gs.lock()) {
+			gs->close();
+			MutexLocker lock(&graph_streams_mutex_);
+			graph_streams_.remove(gs);
+		}
+	});
+
+	// initial event with the current graph
+	gs->publish();
+
+	return std::make_unique<WebviewEventStreamReply>(stream);
+}
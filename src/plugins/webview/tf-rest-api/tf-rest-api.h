@@ -23,17 +23,23 @@
 
 #include "model/TransformsGraph.h"
 
+#include <aspect/blackboard.h>
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <aspect/tf.h>
 #include <aspect/webview.h>
+#include <core/threading/mutex.h>
 #include <core/threading/thread.h>
 #include <webview/rest_api.h>
 #include <webview/rest_array.h>
 
+#include <list>
+#include <memory>
+
 class TransformsRestApi : public fawkes::Thread,
                           public fawkes::ConfigurableAspect,
                           public fawkes::LoggingAspect,
+                          public fawkes::BlackBoardAspect,
                           public fawkes::WebviewAspect,
                           public fawkes::TransformAspect
 {
@@ -46,8 +52,16 @@ public:
 	virtual void finalize();
 
 private:
-	TransformsGraph cb_get_graph();
+	TransformsGraph                   cb_get_graph();
+	std::unique_ptr<fawkes::WebReply> cb_stream_graph(fawkes::WebviewRestParams &params);
+
+	/// @cond INTERNALS
+	class GraphStream;
+	/// @endcond
 
 private:
 	fawkes::WebviewRestApi *rest_api_;
+
+	fawkes::Mutex                           graph_streams_mutex_;
+	std::list<std::shared_ptr<GraphStream>> graph_streams_;
 };